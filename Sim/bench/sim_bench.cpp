@@ -0,0 +1,685 @@
+// Sim/bench/sim_bench.cpp
+//
+// Microbenchmarks for the simulator's hot paths. Results are CSV, one row
+// per benchmark, so runs from different commits can be diffed or compared:
+//
+//   sim_bench                                   -> every benchmark, CSV on stdout
+//   sim_bench --list                            -> benchmark names
+//   sim_bench --filter growth                   -> names containing "growth"
+//   sim_bench --out base.csv --label 2be9178    -> tag and save a baseline
+//   sim_bench --compare base.csv [--threshold 0.1]
+//       -> adds the baseline's median and the ratio; exits 2 when a
+//          benchmark is more than threshold slower than the baseline
+//   sim_bench --check-allocs
+//       -> adds allocs_per_op; exits 3 when a benchmark of a steady-state
+//          path allocates in its timed repetitions (needs a build with
+//          -DSIM_COUNT_ALLOCS=ON, otherwise the column reads zero)
+//
+// Each benchmark is calibrated until one repetition takes --min-time / --reps
+// seconds, then timed --reps times; ns_per_op is per call of the measured
+// function and items_per_s counts the items one call processes (rows, hits,
+// cells, ticks). Log files go to SF_LOG_DIR, or to a scratch directory that
+// is removed afterwards.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "AllocCounter.hpp"
+#include "Battery.hpp"
+#include "DepositionMap.hpp"
+#include "GrowthMonitor.hpp"
+#include "CsvTailReader.hpp"
+#include "Logger.hpp"
+#include "MissionProfile.hpp"
+#include "PowerBus.hpp"
+#include "SimulationEngine.hpp"
+#include "SolarArray.hpp"
+#include "SpartaDiag.hpp"
+#include "TelemetryRing.hpp"
+#include "DatasetExport.hpp"
+#include "LogIndex.hpp"
+#include "Subsystem.hpp"
+#include "TickPhaseEngine.hpp"
+#include "helpers.hpp"
+#include "orbit.hpp"
+
+namespace fs = std::filesystem;
+
+// Sunlight scale read by SolarArray; main.cpp owns it in the sim executable.
+double g_orbit_solar_scale = 1.0;
+
+namespace {
+
+// Keeps results alive so the optimizer cannot drop the measured work.
+volatile double g_sink = 0.0;
+
+// One prepared benchmark: body(n) performs n operations.
+struct Case {
+    double items_per_op = 1.0;
+    std::function<void(long)> body;
+    bool steady = false;   // a per-tick path held to zero allocations (--check-allocs)
+};
+
+struct Bench {
+    std::string name;
+    std::string param;
+    std::function<Case()> make;   // setup, not timed
+};
+
+struct Result {
+    std::string name, param;
+    long   iters = 0;
+    int    reps  = 0;
+    double median_ns = 0.0, min_ns = 0.0, max_ns = 0.0;
+    double items_per_s = 0.0;
+    double allocs_per_op = 0.0;
+    bool   steady = false;
+};
+
+// A Loads-phase subsystem with a fixed amount of arithmetic and an optional
+// bus draw, standing in for a cheap real subsystem.
+class BenchLoad : public Subsystem {
+public:
+    BenchLoad(int id, PowerBus* bus) : Subsystem("BenchLoad" + std::to_string(id)), bus_(bus) {}
+    void initialize() override {}
+    void tick(const TickContext& ctx) override {
+        if (bus_) (void)bus_->drawPower(1.0, ctx);
+        state_ = state_ * 0.999 + ctx.dt * 1e-3;
+    }
+    void shutdown() override { g_sink = g_sink + state_; }
+
+private:
+    PowerBus* bus_;
+    double    state_ = 0.0;
+};
+
+// Rows shaped like the active_jobs/ recipes: one recipe every 8 rows, with
+// a legacy 4-column row at the end of each.
+std::string job_line(std::mt19937& rng, int k) {
+    struct Step { const char* phase; int mbe, sub; double heater, target; };
+    static const Step kRecipe[] = {
+        {"SOURCE_DEGAS", 0, 0, 1800, 300.0}, {"OXIDE_DESORB", 0, 1, 0, 893.0},
+        {"SOAK", 0, 1, 0, 873.0},            {"NUCLEATE", 1, 1, 1700, 803.0},
+        {"GROWTH", 1, 1, 1700, 853.0},       {"ANNEAL", 0, 1, 0, 883.0},
+        {"COOLDOWN", 0, 1, 0, 400.0},
+    };
+    std::uniform_real_distribution<double> flux(1e12, 2e13);
+    std::ostringstream os;
+    const int start = 30 * k;
+    const int step  = k % 8;
+    if (step == 7) {
+        os << start << " " << start + 30 << " " << flux(rng) << " 1500";
+    } else {
+        const Step& s = kRecipe[step];
+        os << start << "    " << start + 30 << "   " << std::scientific
+           << (s.mbe ? flux(rng) : 0.0) << std::defaultfloat << "   " << s.heater << "   "
+           << s.mbe << "   " << s.sub << "   " << s.phase << "   " << s.target;
+    }
+    return os.str();
+}
+
+fs::path write_diag_file(const fs::path& dir, int rows) {
+    const fs::path p = dir / ("wake_diag_" + std::to_string(rows) + ".csv");
+    std::ofstream os(p, std::ios::trunc);
+    os << "step,time,temp_K,density_m3\n";
+    for (int i = 0; i < rows; ++i) {
+        os << i * 100 << "," << i * 1e-4 << "," << 280.0 + (i % 97) * 0.5 << ","
+           << 1.0e18 + i * 1e12 << "\n";
+    }
+    return p;
+}
+
+std::vector<Bench> make_benches(const fs::path& scratch) {
+    std::vector<Bench> b;
+
+    // ---------------- Logger ----------------
+    b.push_back({"logger.log_wide.numeric", "cols=8", [] {
+        static const std::vector<std::string> cols = {"a", "b", "c", "d", "e", "f", "g", "h"};
+        auto tick = std::make_shared<int>(0);
+        return Case{1.0, [tick](long n) {
+            std::vector<double> v(8);
+            for (long i = 0; i < n; ++i) {
+                for (int c = 0; c < 8; ++c) v[c] = *tick * 0.5 + c;
+                Logger::instance().log_wide("BenchNumeric", *tick, *tick * 60.0, cols, v);
+                ++*tick;
+            }
+        }};
+    }});
+    b.push_back({"logger.log_wide.string", "cols=4", [] {
+        static const std::vector<std::string> cols = {"state", "mode", "job", "note"};
+        auto tick = std::make_shared<int>(0);
+        return Case{1.0, [tick](long n) {
+            for (long i = 0; i < n; ++i) {
+                Logger::instance().log_wide("BenchText", *tick, *tick * 60.0, cols,
+                    std::vector<std::string>{"warming", "cooldown", std::to_string(*tick % 16), "ok"});
+                ++*tick;
+            }
+        }};
+    }});
+    b.push_back({"logger.handle.write", "cols=8", [] {
+        auto h = std::make_shared<LogHandle>(Logger::instance().registerSchema(
+            "BenchHandle", {"a", "b", "c", "d", "e", "f", "g", "h"}));
+        auto tick = std::make_shared<int>(0);
+        return Case{1.0, [h, tick](long n) {
+            for (long i = 0; i < n; ++i) {
+                const double t = *tick * 0.5;
+                h->write(*tick, *tick * 60.0, {t, t + 1, t + 2, t + 3, t + 4, t + 5, t + 6, t + 7});
+                ++*tick;
+            }
+        }, true};
+    }});
+    b.push_back({"logger.text_handle.write", "cols=3", [] {
+        auto h = std::make_shared<TextLogHandle>(Logger::instance().registerTextSchema(
+            "BenchTextHandle", {"state", "mode", "note"}));
+        auto tick = std::make_shared<int>(0);
+        return Case{1.0, [h, tick](long n) {
+            static const char* const kStates[] = {"queued", "warming", "live_deposition", "done"};
+            for (long i = 0; i < n; ++i) {
+                h->write(*tick, *tick * 60.0, {kStates[*tick % 4], "cooldown", "ok"});
+                ++*tick;
+            }
+        }, true};
+    }});
+
+    // ---------------- SimulationEngine / TickPhaseEngine ----------------
+    for (int loads : {1, 8, 64}) {
+        b.push_back({"engine.tick", "loads=" + std::to_string(loads), [loads] {
+            struct Rig {
+                PowerBus   bus;
+                SolarArray solar;
+                Battery    battery;
+                std::vector<std::unique_ptr<BenchLoad>> loads;
+                SimulationEngine engine;
+            };
+            auto r = std::make_shared<Rig>();
+            r->bus.setBattery(&r->battery);
+            r->solar.setPowerBus(&r->bus);
+            r->battery.setPowerBus(&r->bus);
+            r->engine.addSubsystem(&r->solar);
+            for (int k = 0; k < loads; ++k) {
+                r->loads.push_back(std::make_unique<BenchLoad>(k, &r->bus));
+                r->engine.addSubsystem(r->loads.back().get());
+            }
+            r->engine.addSubsystem(&r->bus);
+            r->engine.addSubsystem(&r->battery);
+            r->engine.setTickStep(60.0);
+            r->engine.initialize();
+            return Case{1.0, [r](long n) {
+                for (long i = 0; i < n; ++i) r->engine.tick();
+            }, true};
+        }});
+    }
+    for (int subs : {4, 64}) {
+        for (int workers : {0, 2}) {
+            b.push_back({"tickphase.runTick",
+                         "subs=" + std::to_string(subs) + " workers=" + std::to_string(workers),
+                         [subs, workers] {
+                struct Rig {
+                    std::vector<std::unique_ptr<BenchLoad>> subs;
+                    TickPhaseEngine engine;
+                    ~Rig() { engine.stop(); }
+                };
+                auto r = std::make_shared<Rig>();
+                for (int k = 0; k < subs; ++k) {
+                    r->subs.push_back(std::make_unique<BenchLoad>(k, nullptr));
+                    r->engine.addSubsystem(r->subs.back().get());
+                }
+                r->engine.setWorkers(workers);
+                r->engine.start();
+                auto tick = std::make_shared<int>(0);
+                return Case{1.0, [r, tick](long n) {
+                    for (long i = 0; i < n; ++i) {
+                        r->engine.runTick(TickContext{*tick, *tick * 60.0, 60.0});
+                        ++*tick;
+                    }
+                }, true};
+            }});
+        }
+    }
+
+    // ---------------- GrowthMonitor dose integration ----------------
+    // integrateDose() is private; tick() with the beam on and a flux profile
+    // set is the call that reaches it every tick.
+    for (int grid : {32, 128, 512}) {
+        b.push_back({"growth.integrateDose", "gridN=" + std::to_string(grid), [grid] {
+            struct Rig {
+                explicit Rig(int n) : growth(n) {}
+                GrowthMonitor growth;
+            };
+            auto r = std::make_shared<Rig>(grid);
+            r->growth.setIsLeader(true);
+            r->growth.setOutputSubdir("bench_growth_" + std::to_string(grid));
+            r->growth.setNumJobs(1);
+            r->growth.initialize();
+            DepositionMap shape(64, 0.15);
+            for (int iy = 0; iy < 64; ++iy) {
+                for (int ix = 0; ix < 64; ++ix) {
+                    shape.bins[static_cast<std::size_t>(iy) * 64 + ix] = 1.0 + 0.01 * ((ix + iy) % 13);
+                }
+            }
+            r->growth.setFluxProfile(shape);
+            r->growth.setBeamState(0, true, 8.0e12);
+            auto tick = std::make_shared<int>(0);
+            return Case{static_cast<double>(grid) * grid, [r, tick](long n) {
+                for (long i = 0; i < n; ++i) {
+                    r->growth.tick(TickContext{*tick, *tick * 60.0, 60.0});
+                    ++*tick;
+                }
+            }, true};
+        }});
+    }
+
+    // ---------------- DepositionMap ----------------
+    b.push_back({"depmap.addHit", "N=64 hits=65536", [] {
+        struct Rig {
+            DepositionMap map{64, 0.15};
+            std::vector<double> x, y, w;
+        };
+        auto r = std::make_shared<Rig>();
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<double> u(-0.16, 0.16);
+        for (int k = 0; k < 65536; ++k) {
+            r->x.push_back(u(rng));
+            r->y.push_back(u(rng));
+            r->w.push_back(1.0 + 0.001 * (k % 7));
+        }
+        return Case{65536.0, [r](long n) {
+            for (long i = 0; i < n; ++i) {
+                for (std::size_t k = 0; k < r->x.size(); ++k) r->map.addHit(r->x[k], r->y[k], r->w[k]);
+            }
+            g_sink = g_sink + r->map.bins[2080];
+        }, true};
+    }});
+
+    // Same hit set as depmap.addHit, batched; 4 workers need 4 x 65536 hits
+    // before addHits splits the batch. Only the serial path is allocation-free.
+    for (int threads : {1, 4}) {
+        b.push_back({"depmap.addHits", "N=64 hits=262144 threads=" + std::to_string(threads), [threads] {
+            struct Rig {
+                DepositionMap map{64, 0.15};
+                std::vector<double> x, y, w;
+            };
+            auto r = std::make_shared<Rig>();
+            std::mt19937 rng(12345);
+            std::uniform_real_distribution<double> u(-0.16, 0.16);
+            for (int k = 0; k < 262144; ++k) {
+                r->x.push_back(u(rng));
+                r->y.push_back(u(rng));
+                r->w.push_back(1.0 + 0.001 * (k % 7));
+            }
+            return Case{262144.0, [r, threads](long n) {
+                for (long i = 0; i < n; ++i) {
+                    r->map.addHits(r->x.data(), r->y.data(), r->w.data(), r->x.size(), threads);
+                }
+                g_sink = g_sink + r->map.bins[2080];
+            }, threads == 1};
+        }});
+    }
+
+    // ---------------- SPARTA diagnostics ----------------
+    for (int rows : {10, 100000}) {
+        b.push_back({"sparta.read_diag_csv", "rows=" + std::to_string(rows), [rows, scratch] {
+            const fs::path file = write_diag_file(scratch, rows);
+            return Case{1.0, [file](long n) {
+                for (long i = 0; i < n; ++i) {
+                    const auto d = read_sparta_diag_csv(file);
+                    if (d) g_sink = g_sink + d->temp_K;
+                }
+            }};
+        }});
+    }
+
+    // ---------------- LogIndex (sfquery) ----------------
+    b.push_back({"logindex.build", "rows=100000", [scratch] {
+        const std::string file = write_diag_file(scratch, 100000).string();
+        return Case{100000.0, [file](long n) {
+            for (long i = 0; i < n; ++i) {
+                const LogIndex idx = LogIndex::load(file, kLogIndexBlockRows, /*rebuild=*/true);
+                g_sink = g_sink + static_cast<double>(idx.rows());
+            }
+        }};
+    }});
+    b.push_back({"logindex.query", "rows=100000 range=100", [scratch] {
+        const std::string file = write_diag_file(scratch, 100000).string();
+        (void)LogIndex::load(file);
+        auto q = std::make_shared<LogQuery>();
+        q->addTerm("step", LogQueryTerm::Ge, "5000000");
+        q->addTerm("step", LogQueryTerm::Le, "5009900");
+        return Case{1.0, [file, q](long n) {
+            std::string block, line;
+            std::vector<std::string> fields;
+            std::vector<int> cols;
+            for (long i = 0; i < n; ++i) {
+                const LogIndex idx = LogIndex::load(file);
+                if (!idx.resolve(*q, cols)) continue;
+                std::FILE* fp = std::fopen(file.c_str(), "rb");
+                long hits = 0;
+                for (std::size_t k = 0; k < idx.blocks().size(); ++k) {
+                    if (!idx.mayMatch(k, *q, cols)) continue;
+                    idx.readBlock(fp, k, block);
+                    std::size_t pos = 0;
+                    while (LogIndex::nextRecord(block, pos, line)) {
+                        LogIndex::splitRecord(line, fields);
+                        hits += LogIndex::rowMatches(fields, *q, cols) ? 1 : 0;
+                    }
+                }
+                std::fclose(fp);
+                g_sink = g_sink + static_cast<double>(hits);
+            }
+        }};
+    }});
+
+    b.push_back({"sparta.parse_diag_row", "cols=4", [] {
+        auto row = std::make_shared<std::string>("12400,0.0124,287.5,1.83e+18");
+        return Case{1.0, [row](long n) {
+            for (long i = 0; i < n; ++i) {
+                const auto d = parse_sparta_diag_row(*row);
+                if (d) g_sink = g_sink + d->density_m3;
+            }
+        }, true};
+    }});
+
+    // ---------------- OrbitModel ----------------
+    for (int samples : {0, 4096}) {
+        b.push_back({"orbit.step", "ephemeris=" + std::to_string(samples), [samples] {
+            auto orbit = std::make_shared<OrbitModel>(300e3, 60.0);
+            if (samples > 0) orbit->enableEphemeris(samples);
+            return Case{1.0, [orbit](long n) {
+                for (long i = 0; i < n; ++i) orbit->step();
+                g_sink = g_sink + orbit->orbit_phase_rad();
+            }, true};
+        }});
+    }
+
+    // ---------------- MissionProfile ----------------
+    for (double dt : {1.0, 60.0}) {
+        for (bool rows : {false, true}) {
+            b.push_back({"mission.run",
+                         "dt=" + std::to_string(static_cast<int>(dt)) +
+                             (rows ? " rows=orbit" : " rows=off"),
+                         [dt, rows] {
+                SolarArray solar(0.25, 30000.0);
+                Battery    battery;
+                MissionConfig cfg;
+                cfg.payload_W = 3000.0;
+                auto m = std::make_shared<MissionProfile>(solar, battery,
+                                                          OrbitModel(300e3, dt), dt, cfg);
+                if (rows) m->enableLog();
+                return Case{1.0, [m](long n) {
+                    m->run(n);
+                    g_sink = g_sink + m->chargeWh();
+                }, true};
+            }});
+        }
+    }
+
+    // ---------------- TelemetryRing ----------------
+    b.push_back({"telemetry.publish", "cols=30 slots=4096", [] {
+        std::vector<std::string> cols;
+        for (int k = 0; k < 30; ++k) cols.push_back("c" + std::to_string(k));
+        auto t = std::make_shared<TelemetryPublisher>();
+        t->open("sf_bench_telemetry_" + std::to_string(getpid()), cols, 4096);
+        auto tick = std::make_shared<long>(0);
+        return Case{1.0, [t, tick](long n) {
+            double v[30];
+            for (long i = 0; i < n; ++i) {
+                ++*tick;
+                for (int k = 0; k < 30; ++k) v[k] = static_cast<double>(*tick + k);
+                t->publish(*tick, *tick * 60.0, v, 30);
+            }
+        }, true};
+    }});
+
+    // ---------------- DatasetExport ----------------
+    b.push_back({"dataset.append", "cols=30", [] {
+        std::vector<std::string> cols;
+        for (int k = 0; k < 30; ++k) cols.push_back("c" + std::to_string(k));
+        const std::string dir = (std::filesystem::temp_directory_path() /
+                                 ("sf_bench_dataset_" + std::to_string(getpid()))).string();
+        auto d = std::shared_ptr<DatasetExport>(new DatasetExport, [dir](DatasetExport* p) {
+            delete p;
+            std::error_code ec;
+            std::filesystem::remove_all(dir, ec);
+        });
+        d->open(dir, cols, 4, 60.0);
+        auto tick = std::make_shared<long>(0);
+        return Case{1.0, [d, tick](long n) {
+            double v[30];
+            for (long i = 0; i < n; ++i) {
+                ++*tick;
+                for (int k = 0; k < 30; ++k) v[k] = static_cast<double>(*tick + k);
+                d->append(*tick, *tick * 60.0, static_cast<int>(*tick % 4), v, 30);
+            }
+        }, true};
+    }});
+
+    // ---------------- Schedule parsing ----------------
+    b.push_back({"schedule.parseJobLine", "rows=20000", [] {
+        auto lines = std::make_shared<std::vector<std::string>>();
+        std::mt19937 rng(777);
+        for (int k = 0; k < 20000; ++k) lines->push_back(job_line(rng, k));
+        return Case{static_cast<double>(lines->size()), [lines](long n) {
+            SimHelpers::Job job;
+            std::string err;
+            for (long i = 0; i < n; ++i) {
+                for (const auto& l : *lines) {
+                    if (!SimHelpers::parseJobLine(l, job, err)) {
+                        throw std::runtime_error("parseJobLine rejected '" + l + "': " + err);
+                    }
+                }
+                g_sink = g_sink + job.heater_W;
+            }
+        }};
+    }});
+
+    return b;
+}
+
+double seconds_for(const Case& c, long n) {
+    const auto t0 = std::chrono::steady_clock::now();
+    c.body(n);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+Result measure(const Bench& b, double min_time_s, int reps) {
+    const Case c = b.make();
+
+    // Grow n until one repetition takes its share of min_time_s.
+    const double target = min_time_s / reps;
+    long n = 1;
+    for (;;) {
+        const double s = seconds_for(c, n);
+        if (s >= target || n >= (1L << 40)) break;
+        const double grow = s > 0.0 ? std::min(10.0, std::max(2.0, 1.2 * target / s)) : 10.0;
+        n = static_cast<long>(n * grow);
+    }
+
+    std::vector<double> ns;
+    ns.reserve(static_cast<std::size_t>(reps));
+    const AllocCounter::Snapshot a0 = AllocCounter::process();
+    for (int k = 0; k < reps; ++k) ns.push_back(seconds_for(c, n) * 1e9 / n);
+    const AllocCounter::Snapshot da = AllocCounter::process() - a0;
+    std::sort(ns.begin(), ns.end());
+
+    Result r;
+    r.name      = b.name;
+    r.param     = b.param;
+    r.iters     = n;
+    r.reps      = reps;
+    r.min_ns    = ns.front();
+    r.max_ns    = ns.back();
+    r.median_ns = (reps % 2) ? ns[reps / 2] : 0.5 * (ns[reps / 2 - 1] + ns[reps / 2]);
+    r.items_per_s = r.median_ns > 0.0 ? c.items_per_op * 1e9 / r.median_ns : 0.0;
+    r.allocs_per_op = static_cast<double>(da.allocs) / (static_cast<double>(n) * reps);
+    r.steady    = c.steady;
+    return r;
+}
+
+// name|param -> median ns of a previous --out file.
+std::map<std::string, double> load_baseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open baseline " + path);
+
+    std::string line;
+    std::getline(in, line);
+    std::vector<std::string> header;
+    {
+        std::stringstream ss(line);
+        for (std::string tok; std::getline(ss, tok, ',');) header.push_back(tok);
+    }
+    const auto col = [&](const std::string& name) {
+        const auto it = std::find(header.begin(), header.end(), name);
+        if (it == header.end()) throw std::runtime_error(path + ": no column '" + name + "'");
+        return static_cast<std::size_t>(it - header.begin());
+    };
+    const std::size_t c_name = col("bench"), c_param = col("param"), c_med = col("ns_per_op");
+
+    std::map<std::string, double> out;
+    while (std::getline(in, line)) {
+        std::vector<std::string> v;
+        std::stringstream ss(line);
+        for (std::string tok; std::getline(ss, tok, ',');) v.push_back(tok);
+        if (v.size() <= std::max({c_name, c_param, c_med})) continue;
+        out[v[c_name] + "|" + v[c_param]] = std::atof(v[c_med].c_str());
+    }
+    return out;
+}
+
+void usage() {
+    std::cout
+        << "Usage: sim_bench [--list] [--filter TEXT] [--min-time S] [--reps N]\n"
+        << "                 [--out results.csv] [--label TEXT]\n"
+        << "                 [--compare baseline.csv] [--threshold FRAC]\n"
+        << "                 [--check-allocs]\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string filter, out_path, label, compare_path;
+    double min_time_s = 0.5;
+    double threshold  = 0.10;
+    int    reps       = 5;
+    bool   list       = false;
+    bool   check_allocs = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--filter" && i + 1 < argc)         filter = argv[++i];
+        else if (a == "--min-time" && i + 1 < argc)  min_time_s = std::atof(argv[++i]);
+        else if (a == "--reps" && i + 1 < argc)      reps = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--out" && i + 1 < argc)       out_path = argv[++i];
+        else if (a == "--label" && i + 1 < argc)     label = argv[++i];
+        else if (a == "--compare" && i + 1 < argc)   compare_path = argv[++i];
+        else if (a == "--threshold" && i + 1 < argc) threshold = std::atof(argv[++i]);
+        else if (a == "--list")                      list = true;
+        else if (a == "--check-allocs")              check_allocs = true;
+        else if (a == "-h" || a == "--help") { usage(); return 0; }
+        else { usage(); return 1; }
+    }
+
+    if (list) {
+        for (const auto& b : make_benches(fs::path())) {
+            std::cout << b.name << "  [" << b.param << "]\n";
+        }
+        return 0;
+    }
+
+    // Logger and GrowthMonitor resolve the output directory on first use.
+    fs::path scratch;
+    bool own_scratch = false;
+    if (const char* env = std::getenv("SF_LOG_DIR"); env && *env) {
+        scratch = env;
+    } else {
+        scratch = fs::temp_directory_path() / ("sim_bench_" + std::to_string(::getpid()));
+        ::setenv("SF_LOG_DIR", scratch.c_str(), 1);
+        own_scratch = true;
+    }
+    ::unsetenv("RUN_ID");
+    fs::create_directories(scratch);
+
+    if (check_allocs && !AllocCounter::compiled()) {
+        std::cerr << "[sim_bench] --check-allocs: this build does not count allocations "
+                     "(-DSIM_COUNT_ALLOCS=ON); allocs_per_op reads zero\n";
+    }
+
+    int status = 0;
+    try {
+        std::map<std::string, double> baseline;
+        if (!compare_path.empty()) baseline = load_baseline(compare_path);
+
+        std::ofstream file;
+        if (!out_path.empty()) {
+            file.open(out_path, std::ios::trunc);
+            if (!file) throw std::runtime_error("cannot open " + out_path);
+        }
+        std::ostream& os = out_path.empty() ? std::cout : file;
+
+        os << "bench,param,label,reps,iters,ns_per_op,ns_min,ns_max,items_per_s";
+        if (!compare_path.empty()) os << ",base_ns_per_op,ratio";
+        if (check_allocs) os << ",allocs_per_op";
+        os << "\n";
+
+        for (const auto& b : make_benches(scratch)) {
+            if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+            const Result r = measure(b, min_time_s, reps);
+
+            os << r.name << "," << r.param << "," << label << "," << r.reps << "," << r.iters
+               << std::setprecision(6) << "," << r.median_ns << "," << r.min_ns << "," << r.max_ns
+               << "," << r.items_per_s;
+            if (!compare_path.empty()) {
+                const auto it = baseline.find(r.name + "|" + r.param);
+                if (it != baseline.end() && it->second > 0.0) {
+                    const double ratio = r.median_ns / it->second;
+                    os << "," << it->second << "," << ratio;
+                    if (ratio > 1.0 + threshold) {
+                        std::cerr << "[sim_bench] regression: " << r.name << " [" << r.param
+                                  << "] " << ratio << "x baseline\n";
+                        status = 2;
+                    }
+                } else {
+                    os << ",,";
+                }
+            }
+            if (check_allocs) {
+                os << "," << r.allocs_per_op;
+                if (r.steady && r.allocs_per_op > 0.0) {
+                    std::cerr << "[sim_bench] allocates: " << r.name << " [" << r.param
+                              << "] " << r.allocs_per_op << " allocs/op\n";
+                    if (status == 0) status = 3;
+                }
+            }
+            os << "\n" << std::flush;
+            if (!out_path.empty()) {
+                std::cerr << "[sim_bench] " << r.name << " [" << r.param << "] "
+                          << r.median_ns << " ns/op\n";
+            }
+        }
+        Logger::instance().flush();
+    } catch (const std::exception& e) {
+        std::cerr << "[sim_bench] error: " << e.what() << "\n";
+        status = 1;
+    }
+
+    if (own_scratch) {
+        std::error_code ec;
+        fs::remove_all(scratch, ec);
+    }
+    return status;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+
+#include "Logger.hpp"
+
+// -----------------------------------------------------------------------------
+// AllocCounter (debug builds: cmake -DSIM_COUNT_ALLOCS=ON)
+//
+// Counts heap allocations so the tick loops can be held to zero of them in
+// steady state. With the option on, AllocCounter.cpp replaces the global
+// operator new / delete (all the usual forms, aligned included) with
+// malloc-backed versions that bump a process-wide pair of counters and one
+// per thread. Every allocation made through the standard library goes
+// through them: strings, containers, streams, std::function, shared_ptr.
+// Plain malloc() calls made by C libraries (MPI, zlib) are not counted.
+//
+// Without the option nothing is replaced, compiled() is false and every
+// snapshot reads zero.
+//
+//   const AllocCounter::Snapshot a = AllocCounter::thread();
+//   ... one tick ...
+//   const AllocCounter::Snapshot d = AllocCounter::thread() - a;   // d.allocs
+//
+// --alloc-report uses it to write Allocs.csv (one row per tick) and report
+// the largest steady-state count; sim_bench --check-allocs fails a benchmark
+// whose measured loop allocates.
+// -----------------------------------------------------------------------------
+
+class AllocCounter {
+public:
+    struct Snapshot {
+        std::uint64_t allocs = 0;
+        std::uint64_t bytes  = 0;
+
+        Snapshot operator-(const Snapshot& o) const { return {allocs - o.allocs, bytes - o.bytes}; }
+    };
+
+    // True when the replacement operators are linked in.
+    static bool compiled();
+
+    // Allocations made by every thread / by the calling thread so far.
+    static Snapshot process();
+    static Snapshot thread();
+};
+
+// Per-tick allocation totals of one tick loop (--alloc-report): process-wide
+// counts between begin() and end(), one Allocs.csv row per tick. Ticks up to
+// warmup_ticks fill caches and buffers and are not steady state.
+class AllocTickMeter {
+public:
+    explicit AllocTickMeter(int warmup_ticks);
+
+    void begin();
+    void end(int tick, double time);
+
+    // begin() / end() around the enclosing loop body, whichever way it is
+    // left (continue, jumps). A null meter does nothing.
+    class Scope {
+    public:
+        Scope(AllocTickMeter* m, int tick, double time) : m_(m), tick_(tick), time_(time) {
+            if (m_) m_->begin();
+        }
+        ~Scope() {
+            if (m_) m_->end(tick_, time_);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        AllocTickMeter* m_;
+        int             tick_;
+        double          time_;
+    };
+
+    long          steadyTicks() const { return steady_ticks_; }
+    long          steadyAllocTicks() const { return steady_alloc_ticks_; }  // ticks with any
+    std::uint64_t steadyMax() const { return steady_max_; }
+    int           steadyMaxTick() const { return steady_max_tick_; }
+
+private:
+    int                    warmup_;
+    LogHandle              log_;
+    AllocCounter::Snapshot start_;
+    long                   steady_ticks_{0};
+    long                   steady_alloc_ticks_{0};
+    std::uint64_t          steady_max_{0};
+    int                    steady_max_tick_{-1};
+};
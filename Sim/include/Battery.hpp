@@ -1,5 +1,6 @@
 #pragma once
 #include "Subsystem.hpp"
+#include "Logger.hpp"
 
 // Forward declaration instead of including PowerBus.hpp
 class PowerBus;
@@ -11,6 +12,12 @@ public:
     void initialize() override;
     void tick(const TickContext& ctx) override;
     void shutdown() override;
+    void saveState(CheckpointWriter& ckpt) const override;
+    void loadState(const CheckpointReader& ckpt) override;
+
+    // Ticks after bus settlement so the logged charge is post-settlement.
+    static constexpr TickPhase kTickPhase = TickPhase::Storage;
+    TickPhase tickPhase() const override { return kTickPhase; }
 
     void setPowerBus(PowerBus* bus);
 
@@ -38,4 +45,6 @@ private:
     double max_charge_rate_W_    = 3500.0;
 
     double max_discharge_rate_W_ = 4000.0;  // battery can output up to 2 kW
+
+    LogHandle log_;
 };
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "LogFile.hpp"
+
+// Binary columnar log format (.sfb)
+//
+// Used by Logger when SF_LOG_FORMAT=bin. One file per subsystem, same
+// location and base name as the CSV it replaces (<subsystem>.sfb).
+//
+// Layout (little-endian, native widths):
+//
+//   header:
+//     char     magic[8]      "SFBLOG\0\0"
+//     uint32   version       (kBinaryLogVersion)
+//     uint32   ncols         including the leading tick and time_s columns
+//     ncols x { uint8 type, uint16 name_len, char name[name_len] }
+//
+//   chunk (repeated until EOF):
+//     uint32   tag           "CHNK"
+//     uint32   nrows
+//     ncols x column block:
+//       uint8  encoding      0 = raw: nrows fixed-width values (int64 or float64)
+//                            1 = constant: one value repeated for all nrows
+//
+// Column 0 is always tick (int64), column 1 is always time_s (float64); the
+// remaining columns are the log_wide() columns as float64. Config-like columns
+// (capacity, limits, efficiencies) that do not change within a chunk collapse
+// to a single value via the constant encoding. A truncated final
+// chunk (crash mid-write) is ignored by the reader. With SF_LOG_COMPRESS the
+// same bytes are gzip-compressed into <subsystem>.sfb.gz; the reader takes
+// either.
+
+enum class BinaryColumnType : std::uint8_t {
+    Int64   = 0,
+    Float64 = 1
+};
+
+constexpr std::uint32_t kBinaryLogVersion   = 1;
+constexpr std::size_t   kBinaryLogChunkRows = 1024;
+
+struct BinaryColumn {
+    std::string      name;
+    BinaryColumnType type = BinaryColumnType::Float64;
+};
+
+// Buffers rows column-wise and writes one chunk every kBinaryLogChunkRows rows
+// (or on flush()/close()). Not thread-safe; Logger serializes access.
+class BinaryLogWriter {
+public:
+    BinaryLogWriter() = default;
+    ~BinaryLogWriter();
+
+    BinaryLogWriter(const BinaryLogWriter&) = delete;
+    BinaryLogWriter& operator=(const BinaryLogWriter&) = delete;
+
+    // Opens (truncates) path and writes the schema header. The value columns
+    // are stored as float64 after the implicit tick/time_s columns.
+    // Throws std::runtime_error if the file cannot be opened.
+    void open(const std::string& path, const std::vector<std::string>& value_columns,
+              LogCodec codec = LogCodec::None);
+
+    // Reopens an existing file after its last chunk (resumed runs); no
+    // header is written, so value_columns must match the existing one.
+    void openAppend(const std::string& path, const std::vector<std::string>& value_columns,
+                    LogCodec codec = LogCodec::None);
+
+    bool is_open() const { return out_.is_open(); }
+    std::size_t valueColumnCount() const { return ncols_; }
+
+    // Appends one row. Missing values are padded with 0.0 and extra values are
+    // dropped, matching the CSV sink's behaviour for short rows.
+    void append(std::int64_t tick, double time, const double* vals, std::size_t nvals);
+
+    // Writes the pending partial chunk (if any) and flushes the file buffer
+    // (a compressed file only at block boundaries). seal() also ends the
+    // compressed member (see LogFileOut::seal()).
+    void flush();
+    void seal();
+    void close();
+
+private:
+    void writeChunk_();
+
+    LogFileOut                 out_;
+    std::size_t                ncols_ = 0;      // value columns only
+    std::size_t                nrows_ = 0;      // rows pending in the buffers
+    std::vector<std::int64_t>  ticks_;
+    std::vector<double>        times_;
+    std::vector<double>        values_;         // column-major, ncols_ x kBinaryLogChunkRows
+};
+
+// Sequential reader for .sfb files.
+class BinaryLogReader {
+public:
+    BinaryLogReader() = default;
+    ~BinaryLogReader();
+
+    BinaryLogReader(const BinaryLogReader&) = delete;
+    BinaryLogReader& operator=(const BinaryLogReader&) = delete;
+
+    // Opens path (plain or compressed) and parses the header. Throws
+    // std::runtime_error on a missing file, bad magic or unsupported version.
+    void open(const std::string& path);
+
+    // All columns, including tick and time_s.
+    const std::vector<BinaryColumn>& columns() const { return columns_; }
+
+    // Reads the next chunk into the reader's buffers. Returns false at EOF or on
+    // a truncated trailing chunk.
+    bool nextChunk();
+
+    std::size_t chunkRows() const { return nrows_; }
+
+    // Accessors into the current chunk. col indexes columns(); for the int64
+    // tick column use tick(row).
+    std::int64_t tick(std::size_t row) const { return ticks_[row]; }
+    double value(std::size_t col, std::size_t row) const;
+
+    // Writes the whole file as CSV in the exact layout the CSV sink produces
+    // (header "tick,time_s,<cols...>", default ostream number formatting).
+    // Returns the number of data rows written.
+    std::size_t writeCsv(std::ostream& out);
+
+private:
+    LogFileIn                  in_;
+    std::vector<BinaryColumn>  columns_;
+    std::size_t                nrows_ = 0;
+    std::vector<std::int64_t>  ticks_;
+    std::vector<double>        values_;         // column-major, (ncols-1) x nrows (time_s first)
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <mpi.h>
+
+#include <string>
+#include <vector>
+
+#include "ParameterSweep.hpp"
+
+// -----------------------------------------------------------------------------
+// BranchRunner (--mode branch)
+//
+// What-if continuations of one shared prefix. The power/thermal harness of
+// --mode sweep runs the prefix once, up to --branch-at ticks, on rank 0 and
+// saves its state (the Subsystem checkpoint hooks, see Checkpoint.hpp).
+// Every branch then starts from that state with its own parameters and
+// remaining schedule; branches are spread over ranks x threads like sweep
+// members.
+//
+// Spec file: one line per branch, "name key=value ...". The line named
+// "prefix" sets the shared prefix's parameters; every branch starts from
+// them and overrides what it lists. Blank lines and '#' comments are skipped.
+//
+//   prefix  job_file=V4_job1.txt
+//   base                                        # the prefix run, continued
+//   late    job_file=V4_job2.txt                # different remaining jobs
+//   dim     solar_efficiency=0.20 battery_capacity_Wh=5000
+//
+// Keys: job_file (a name in the jobs directory, or "none"),
+// solar_efficiency, solar_base_input_W, battery_capacity_Wh,
+// heater_max_draw_W. dt is the run's --dt for every branch. Capacities and
+// efficiencies are construction parameters and take effect at the fork;
+// the state (battery charge, temperatures, job progress) comes from the
+// prefix.
+//
+// Schedules are in minutes as in sweep mode. A branch keeps the prefix's
+// leading rows that start before the fork time (up to the first that does
+// not, so job indices match the prefix's), followed by the rows of its own
+// job_file (default: the prefix's) that start at or after it; its rows
+// that start earlier belong to the shared prefix and are counted as
+// skipped. job_file=none on a branch drops the prefix's remaining rows.
+//
+// Output, under the run's log directory: prefix/ holds the prefix's files
+// and prefix.ckpt. branch_<name>/ holds a branch's full timeline: the
+// prefix's rows, copied at the fork, followed by the branch's own. Branch.csv
+// has one row per branch (the tick column holds the branch index, time_s
+// the simulated span).
+// -----------------------------------------------------------------------------
+
+struct BranchSpec {
+    std::string       name;
+    SweepMemberParams params;
+};
+
+struct BranchOptions {
+    double      span_s    = 0.0;           // simulated time of a full branch
+    int         fork_tick = 0;             // prefix length in ticks
+    std::string jobs_dir  = "active_jobs";
+    int         threads   = 1;             // worker threads per rank
+    ThermalIntegratorConfig thermal;
+};
+
+class BranchRunner {
+public:
+    // Parses a spec. prefix receives the "prefix" line applied to defaults
+    // (dt = dt); branches come back in file order. Throws
+    // std::runtime_error on unknown keys, malformed values, duplicate names
+    // or a spec without branches.
+    static std::vector<BranchSpec> loadSpec(const std::string& path, double dt,
+                                            SweepMemberParams& prefix);
+
+    // Runs the prefix on rank 0, then every branch across the ranks of comm
+    // (collective). Returns the results, ordered by branch, on rank 0 and an
+    // empty vector elsewhere. prefix_wall_s receives the prefix's wall time.
+    static std::vector<SweepMemberResult> run(MPI_Comm comm,
+                                              const SweepMemberParams& prefix,
+                                              const std::vector<BranchSpec>& branches,
+                                              const BranchOptions& opt,
+                                              double& prefix_wall_s);
+
+    // Writes Branch.csv (rank 0).
+    static void writeTable(const std::vector<BranchSpec>& branches,
+                           const std::vector<SweepMemberResult>& results,
+                           const BranchOptions& opt);
+};
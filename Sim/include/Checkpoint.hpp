@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Checkpoint
+//
+// Key/value store for the harness checkpoint (--checkpoint-every, --resume).
+// Every stateful piece writes its fields under its own prefix
+// ("Battery.charge_Wh", "scheduler.state", "wake.cum_steps"); values are
+// stored bit for bit, so a resumed run continues with exactly the doubles the
+// interrupted one had.
+//
+//   header:
+//     char     magic[8]     "SFCKPT\0\0"
+//     uint32   version      (kCheckpointVersion)
+//     uint32   nentries
+//   nentries x entry (sorted by key):
+//     uint8    type         CheckpointValueType
+//     uint16   key_len, char key[key_len]
+//     uint64   count        values (Int64/Float64) or bytes (Text)
+//     payload
+//   trailer:
+//     uint64   FNV-1a of every byte before the trailer
+//
+// The file is written to a temporary name and renamed over the old one, so
+// a crash while checkpointing leaves the previous checkpoint intact.
+// -----------------------------------------------------------------------------
+
+constexpr std::uint32_t kCheckpointVersion = 1;
+
+enum class CheckpointValueType : std::uint8_t {
+    Int64   = 0,
+    Float64 = 1,
+    Text    = 2
+};
+
+class CheckpointWriter {
+public:
+    void setInt(const std::string& key, std::int64_t v) { setInts(key, std::vector<std::int64_t>{v}); }
+    void setBool(const std::string& key, bool v) { setInt(key, v ? 1 : 0); }
+    void setDouble(const std::string& key, double v) { setDoubles(key, {v}); }
+    void setInts(const std::string& key, const std::vector<std::int64_t>& v);
+    void setInts(const std::string& key, const std::vector<int>& v);
+    void setDoubles(const std::string& key, const std::vector<double>& v);
+    void setText(const std::string& key, const std::string& v);
+
+    std::size_t entries() const { return entries_.size(); }
+
+    // Serializes and atomically replaces path. Returns the bytes written.
+    // Throws std::runtime_error on I/O errors.
+    std::uint64_t writeFile(const std::string& path) const;
+
+private:
+    friend class CheckpointReader;
+
+    struct Entry {
+        CheckpointValueType       type = CheckpointValueType::Int64;
+        std::vector<std::int64_t> ints;
+        std::vector<double>       doubles;
+        std::string               text;
+    };
+    std::map<std::string, Entry> entries_;
+};
+
+class CheckpointReader {
+public:
+    // Parses path. Throws std::runtime_error on a missing file, bad magic,
+    // unsupported version, truncation or checksum mismatch.
+    void open(const std::string& path);
+
+    bool has(const std::string& key) const { return entries_.count(key) != 0; }
+
+    // Getters throw std::runtime_error for a missing key or another type.
+    std::int64_t getInt(const std::string& key) const;
+    bool         getBool(const std::string& key) const { return getInt(key) != 0; }
+    double       getDouble(const std::string& key) const;
+    std::vector<std::int64_t> getInts(const std::string& key) const;
+    std::vector<double>       getDoubles(const std::string& key) const;
+    const std::string&        getText(const std::string& key) const;
+
+    // Keys starting with prefix, in sorted order.
+    std::vector<std::string> keys(const std::string& prefix) const;
+
+private:
+    using Entry = CheckpointWriter::Entry;
+    const Entry& entry_(const std::string& key, CheckpointValueType type) const;
+
+    std::string path_;
+    std::map<std::string, Entry> entries_;
+};
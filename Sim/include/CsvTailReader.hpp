@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+/*
+    Incremental "last row" reader for CSV files that another process keeps
+    appending to (SPARTA fix print / ave/time output).
+
+    poll() stats the file and reads only the bytes added since the previous
+    call, so each poll costs O(new rows) instead of O(file size). The first
+    line is treated as the header and skipped; an unterminated trailing line
+    is left for the next poll, since the writer may still be in the middle
+    of it.
+
+    If the file is replaced (different inode), shrinks, or no longer holds
+    the bytes last consumed before offset() (truncated in place and grown
+    past the old end between polls), the reader starts over from the top
+    and drops the cached row. The check runs whenever size or mtime moved.
+    A missing file behaves like an empty one.
+*/
+class CsvTailReader {
+public:
+    CsvTailReader() = default;
+    explicit CsvTailReader(std::filesystem::path file) : path_(std::move(file)) {}
+
+    // Changes the watched file and forgets all state.
+    void reset(std::filesystem::path file);
+
+    const std::filesystem::path& path() const { return path_; }
+
+    // Consumes newly appended rows. Returns true when a data row is cached
+    // (from this or an earlier poll).
+    bool poll();
+
+    // Most recent complete, non-blank data row (whitespace-trimmed); empty
+    // until one has been seen.
+    const std::string& lastRow() const { return last_; }
+
+    // Number of bytes consumed so far (header included).
+    std::uint64_t offset() const { return offset_; }
+
+    // Field col (0-based) of a comma-separated row, read in place. A field
+    // exists as it would for std::getline(ss, tok, ','): an empty field
+    // counts except after a trailing comma. fieldDouble() parses it like
+    // std::stod and returns false where std::stod would throw.
+    static bool hasField(const std::string& row, std::size_t col);
+    static bool fieldDouble(const std::string& row, std::size_t col, double& out);
+
+private:
+    static constexpr std::size_t kTailBytes = 64;
+
+    void restart_();
+
+    std::filesystem::path path_;
+    std::uint64_t offset_ = 0;
+    std::uint64_t dev_    = 0;
+    std::uint64_t ino_    = 0;
+    std::int64_t  mtime_  = 0;            // ns, at the last read
+    char          tail_[kTailBytes] = {}; // bytes just before offset_
+    std::size_t   tail_len_ = 0;
+    bool header_done_     = false;
+    std::string last_;
+    std::string chunk_;   // bytes read by the last poll()
+};
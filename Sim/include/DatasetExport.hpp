@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// DatasetExport
+//
+// Training data straight from the wake loop as memory-mappable arrays, so a
+// pipeline loads a run with np.load(..., mmap_mode="r") instead of parsing
+// and aligning the per-subsystem CSVs. The leader appends one row per
+// executed tick (fast-forwarded ticks have none; tick.npy keys the rows)
+// and, once the run has shut down, the wafer dose maps of every job.
+//
+// Directory layout (every .npy is format 1.0, C order, native endian, with
+// its data 64-byte aligned):
+//
+//   tick.npy          int64   [rows]            tick index
+//   time_s.npy        float64 [rows]            physical time
+//   job.npy           int32   [rows]            controlling job (-1 = none)
+//   features.npy      float64 [rows, columns]   see schema.json "columns"
+//   job_rows.npy      int64   [n_jobs, 2]       first / last row the job
+//                                               controlled (-1 = never)
+//   wafer_maps.npy    float64 [n_jobs, N, N]    dose per grid cell, 0 outside
+//                                               the wafer
+//   wafer_mask.npy    uint8   [N, N]            1 = cell inside the wafer
+//   wafer_status.npy  int8    [n_jobs]          WaferJobStatus, -1 = no record
+//   schema.json       columns, dtype and shape of every array, run id, dt
+//
+// The row files are written as the run goes; their headers are patched
+// with the row count every few thousand rows and at close(), so after a
+// crash the arrays still load up to the last patch. schema.json is
+// complete once close() has run. A resumed run writes a fresh dataset from
+// the resume tick; schema.json records the first tick.
+// -----------------------------------------------------------------------------
+
+// One .npy array written front to back; the leading dimension grows with
+// every append and is patched into the header by sync() and close().
+class NpyFile {
+public:
+    NpyFile() = default;
+    ~NpyFile();
+
+    NpyFile(const NpyFile&) = delete;
+    NpyFile& operator=(const NpyFile&) = delete;
+
+    // descr is the type letter and size without byte order ("f8", "i4",
+    // "u1"); inner is the shape after the leading dimension. Truncates path.
+    // Throws std::runtime_error if the file cannot be opened.
+    void open(const std::string& path, const std::string& descr, std::size_t item_bytes,
+              const std::vector<std::size_t>& inner);
+
+    bool is_open() const { return fp_ != nullptr; }
+
+    // n items in C order; a whole number of leading-dimension entries.
+    void append(const void* data, std::size_t n);
+
+    // Rewrites the header with the current leading dimension.
+    void sync();
+    void close();
+
+    std::uint64_t rows() const { return rows_; }
+    std::string   dtype() const;   // "<f8", as in the header
+    std::vector<std::size_t> shape() const;
+
+private:
+    void writeHeader_();
+
+    std::FILE*    fp_ = nullptr;
+    std::string   descr_;
+    std::size_t   item_bytes_ = 0;
+    std::vector<std::size_t> inner_;
+    std::size_t   row_items_  = 1;   // product of inner_
+    std::uint64_t rows_       = 0;
+    std::vector<char> buffer_;
+};
+
+class DatasetExport {
+public:
+    DatasetExport() = default;
+    ~DatasetExport();
+
+    DatasetExport(const DatasetExport&) = delete;
+    DatasetExport& operator=(const DatasetExport&) = delete;
+
+    // Creates dir (and parents) and the row files. Throws std::runtime_error
+    // if the directory or a file cannot be created.
+    void open(const std::string& dir, const std::vector<std::string>& columns,
+              std::size_t n_jobs, double dt);
+
+    bool isOpen() const { return features_.is_open(); }
+    const std::string& directory() const { return dir_; }
+    std::size_t width() const { return columns_.size(); }
+    std::uint64_t rows() const { return features_.rows(); }
+
+    // One tick; values must match the column count (std::runtime_error).
+    // Does not allocate.
+    void append(long tick, double time, int job, const double* vals, std::size_t n);
+
+    // Wafer tensors from GrowthMonitor's archive (call after it has shut
+    // down, so every job has its record). Jobs without a record stay zero.
+    // Throws std::runtime_error if the archive cannot be read.
+    void writeWaferMaps(const std::string& archive_path);
+
+    // Patches the row counts, writes job_rows.npy and schema.json and closes
+    // every file. Called by the destructor (without wafer maps then).
+    void close();
+
+private:
+    void writeSchema_() const;
+
+    std::string dir_;
+    std::vector<std::string> columns_;
+    std::size_t n_jobs_ = 0;
+    double      dt_     = 0.0;
+    long        first_tick_ = -1;
+    long        last_tick_  = -1;
+
+    NpyFile tick_, time_, job_, features_;
+    std::vector<std::int64_t> job_rows_;   // n_jobs x {first, last}
+
+    // Wafer tensors, filled by writeWaferMaps().
+    int         grid_n_       = 0;
+    std::size_t wafer_cells_  = 0;
+    std::size_t wafer_records_ = 0;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+    DeckBuilder: the wake deck generated from a typed configuration.
+
+    The hand-edited decks (in.wake, in.wake_harness, in.wake_gpu,
+    in.wake_final) fix the grid at a uniform 96 x 56 x 40 and sample and
+    print their probes every 2500 steps, whatever --sparta-block the harness
+    runs. A generated deck instead
+    - builds a coarse far-field grid and refines it with adapt_grid only in
+      the listed regions (orifice-to-wafer beam, cupola), then rebalances
+      (balance_grid rcb cell) so the refined cells are spread over the ranks;
+    - sets the averaging and output cadence from the coupling block, so each
+      ave/time window is exactly the steps one harness block runs;
+    - emits only the output the harness consumes: the in-process probe
+      variables (WakeChamber::Probes) always, the shim's
+      data/tmp/wake_diag.csv only when SPARTA runs as an external process,
+      the per-element wafer flux (WakeChamber::enableWaferFlux) only when it
+      is embedded,
+      and the wake_4probes / residualGasAnalyzer CSVs only when asked for
+      (csv_every_blocks > 0). Probe computes nobody reads are not defined.
+
+    Three files are written into the input directory, all in the same layout
+    as the hand-edited set so WakeChamber needs nothing new:
+        <deck>              header, params.inc, grid, surfaces, groups,
+                            then includes the runtime file
+        <deck>_runtime.inc  everything a restart file does not carry
+        <deck>_resume       params.inc + read_restart + runtime include
+    The beam-derived quantities stay in hot_include (wake_hot.inc), which
+    stays hand-edited.
+
+    Values are printed with enough digits to round-trip, so the same config
+    always produces byte-identical files (the wake-response cache hashes
+    them).
+
+    Errors (invalid config, unwritable files) throw std::runtime_error.
+*/
+
+struct DeckBox {
+    std::array<double, 3> lo{{0.0, 0.0, 0.0}};
+    std::array<double, 3> hi{{0.0, 0.0, 0.0}};
+};
+
+// Coarse cells touching the box are split into cells^3 children
+// (adapt_grid all refine random 1.0 0.0 region <name> one cells N N N: the
+// random style with rfrac 1 refines every candidate, and the region keyword
+// limits the candidates to the box). Regions are applied in order, so cells
+// inside two regions are split twice.
+struct DeckRefineRegion {
+    std::string name;
+    DeckBox     box;
+    int         cells = 2;
+};
+
+struct DeckSurface {
+    std::string           file;            // relative to the input directory
+    std::array<double, 3> trans{{0.0, 0.0, 0.0}};
+};
+
+// Surface group: elements whose centre lies in the box.
+struct DeckSurfGroup {
+    std::string name;                      // group ID, e.g. cupGrp
+    DeckBox     box;
+};
+
+// Grid-cell pressure probe, region probe_<name>.
+struct DeckProbe {
+    std::string name;                      // e.g. Wake
+    DeckBox     box;
+};
+
+struct WakeDeckConfig {
+    // File names (relative to the input directory).
+    std::string deck        = "in.wake_gen";
+    std::string hot_include = "wake_hot.inc";
+
+    int     seed = 12345;
+    DeckBox domain;
+    std::array<int, 3> grid{{48, 28, 20}};   // coarse far field
+    std::vector<DeckRefineRegion> refine;
+    bool    balance = true;                  // rebalance after refinement
+
+    std::vector<DeckSurface>   surfaces;
+    std::vector<DeckSurfGroup> surf_groups;  // cupGrp, mbeNozzleGrp, waferGrp
+    std::vector<DeckProbe>     probes;
+    std::string wake_probe = "Wake";         // RGA and in-process probe variables
+
+    // Physics (the values in wake_runtime.inc).
+    double timestep_s   = 1.0e-5;
+    double fnum         = 1.0e13;
+    double T_gas_K      = 800.0;
+    double vstream_ms   = 7500.0;
+    double x_orifice_m  = 1.6122;
+    double x_wafer_m    = 4.0;
+    double D_orifice_m  = 0.010;
+    double T_beam_K     = 1200.0;
+    double T_surf_K     = 300.0;
+
+    // Cadence. block_steps is the harness --sparta-block; ave/time samples
+    // every sample_every steps of it. tick and phys_time_s in the CSVs
+    // assume ticks_per_block harness ticks of dt_tick_s per block.
+    int    block_steps     = 200;
+    int    sample_every    = 1;
+    int    ticks_per_block = 10;
+    double dt_tick_s       = 60.0;
+
+    // Output. csv_every_blocks = 0 skips wake_4probes.csv and the RGA CSV
+    // (and their probe averaging); diag_csv writes data/tmp/wake_diag.csv
+    // for the external-process shim.
+    int  csv_every_blocks = 0;
+    bool rga_csv          = true;
+    bool diag_csv         = false;
+    int  stats_every_blocks = 1;
+
+    // Per-element beam flux on waferGrp averaged over each block
+    // (fix ave/surf wafer_flux_fix), for WakeChamber::enableWaferFlux.
+    bool        wafer_flux     = false;
+    std::string wafer_flux_fix = "waferFluxAve";
+
+    // The in.wake_harness geometry on a coarse grid with the beam and
+    // cupola regions refined; diag_csv is on in builds without ENABLE_SPARTA,
+    // wafer_flux in builds with it.
+    static WakeDeckConfig harnessDefaults();
+
+    std::string runtimeInclude() const { return deck + "_runtime.inc"; }
+    std::string resumeDeck() const { return deck + "_resume"; }
+};
+
+class DeckBuilder {
+public:
+    // Throws std::runtime_error if the config is invalid.
+    explicit DeckBuilder(WakeDeckConfig cfg);
+
+    const WakeDeckConfig& config() const { return cfg_; }
+
+    std::string deckText() const;
+    std::string runtimeText() const;
+    std::string resumeText() const;
+
+    // Writes the three files into input_dir. A file whose contents are
+    // unchanged is left alone. Returns the paths written.
+    std::vector<std::string> write(const std::string& input_dir) const;
+
+    // Grid cells after refinement (coarse cells touching several regions
+    // count every split), and a uniform grid as fine as the finest cells.
+    std::size_t estimatedCells() const;
+    std::size_t uniformEquivalentCells() const;
+
+private:
+    void validate_() const;
+
+    WakeDeckConfig cfg_;
+};
@@ -0,0 +1,130 @@
+// DepositionArchive.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DepositionMap.hpp"
+
+// Multi-map checkpoint archive (.sda)
+//
+// One file holds many DepositionMaps keyed by (job, wafer, time_s), for
+// pause/resume across jobs and for post-processing. Single-map files written
+// by DepositionMap::save() (BinHeader v1) are unchanged.
+//
+// Layout (little-endian, native widths):
+//
+//   header (32 bytes):
+//     char     magic[8]      "SFDEPAR\0"
+//     uint32   version       (kDepositionArchiveVersion)
+//     uint32   count         number of maps
+//     uint64   toc_offset    file offset of the table of contents
+//     uint64   reserved
+//
+//   payloads, each starting on an 8-byte boundary
+//
+//   table of contents: count x DepositionArchiveEntry (64 bytes), 8-byte aligned
+//
+// The TOC is written by close(); an archive without one (crash mid-write) is
+// rejected. Each entry carries a CRC-32 of its stored payload bytes.
+//
+// Payload encodings:
+//   Float64  raw N*N doubles; readable zero-copy through view()
+//   Float32  N*N floats (half the size, ~7 significant digits)
+//   Deflate  zlib-compressed doubles (only when built with zlib)
+
+enum class DepositionEncoding : std::uint8_t {
+  Float64 = 0,
+  Float32 = 1,
+  Deflate = 2
+};
+
+constexpr std::uint32_t kDepositionArchiveVersion = 1;
+
+// Naturally aligned, so the mmap'd TOC (8-byte aligned) is read in place.
+struct DepositionArchiveEntry {
+  std::int32_t  job;
+  std::int32_t  wafer;
+  double        time_s;
+  std::int32_t  N;
+  std::uint8_t  encoding;       // DepositionEncoding
+  std::uint8_t  pad[3];
+  double        radius;
+  std::uint64_t offset;         // payload start
+  std::uint64_t stored_bytes;   // bytes on disk
+  std::uint32_t crc32;          // of the stored bytes
+  std::uint32_t reserved[3];
+};
+static_assert(sizeof(DepositionArchiveEntry) == 64, "TOC entry must stay 64 bytes");
+
+// True when the build has zlib, i.e. DepositionEncoding::Deflate is usable.
+bool depositionArchiveHasDeflate();
+
+// CRC-32 (IEEE 802.3), used for payload checksums.
+std::uint32_t depositionArchiveCrc32(const void* data, std::size_t n);
+
+class DepositionArchiveWriter {
+public:
+  DepositionArchiveWriter() = default;
+  ~DepositionArchiveWriter();
+
+  DepositionArchiveWriter(const DepositionArchiveWriter&) = delete;
+  DepositionArchiveWriter& operator=(const DepositionArchiveWriter&) = delete;
+
+  // Opens (truncates) path. Throws std::runtime_error on failure.
+  void open(const std::string& path);
+
+  // Appends one map. Throws std::runtime_error on write failure or if
+  // Deflate is requested without zlib.
+  void add(int job, int wafer, double time_s, const DepositionMap& map,
+           DepositionEncoding enc = DepositionEncoding::Float64);
+
+  // Writes the TOC and patches the header. Called by the destructor.
+  void close();
+
+private:
+  std::FILE*                          fp_ = nullptr;
+  std::vector<DepositionArchiveEntry> toc_;
+};
+
+// Memory-maps an archive; opening reads only the header and TOC, and maps
+// are touched (paged in) only when accessed.
+class DepositionArchiveReader {
+public:
+  DepositionArchiveReader() = default;
+  ~DepositionArchiveReader();
+
+  DepositionArchiveReader(const DepositionArchiveReader&) = delete;
+  DepositionArchiveReader& operator=(const DepositionArchiveReader&) = delete;
+
+  // Throws std::runtime_error on a missing file, bad magic/version or a
+  // missing/truncated TOC.
+  void open(const std::string& path);
+  void close();
+
+  std::size_t size() const { return ntoc_; }
+  const DepositionArchiveEntry& entry(std::size_t i) const { return toc_[i]; }
+
+  // Index of the map for (job, wafer) with the largest time_s <= time_s
+  // (default: the latest one), or -1 if there is none.
+  long find(int job, int wafer, double time_s = 1e300) const;
+
+  // Zero-copy pointer to N*N doubles for a Float64 entry, else nullptr.
+  // Does not verify the checksum; call verify() first if that matters.
+  const double* view(std::size_t i) const;
+
+  // Recomputes the payload CRC-32.
+  bool verify(std::size_t i) const;
+
+  // Decodes any encoding into map (N, radius, bins). Verifies the checksum;
+  // throws std::runtime_error on mismatch or decode failure.
+  void load(std::size_t i, DepositionMap& map) const;
+
+private:
+  const unsigned char*          base_ = nullptr;
+  std::size_t                   len_  = 0;
+  const DepositionArchiveEntry* toc_  = nullptr;
+  std::size_t                   ntoc_ = 0;
+};
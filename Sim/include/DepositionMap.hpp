@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <algorithm> // clamp, fill
+#include <cstddef>
 
 struct DepositionMap {
   int N;                     // e.g. 64 (N x N grid)
@@ -31,6 +32,15 @@ struct DepositionMap {
     bins[static_cast<size_t>(iy)*static_cast<size_t>(N) + static_cast<size_t>(ix)] += w;
   }
 
+  // Bulk addHit over SoA arrays x[n], y[n], w[n] (w may be nullptr for unit
+  // weight). Hits are normalized and binned in fixed-size blocks, then
+  // scattered; large batches are split across `threads` workers (0 = all
+  // hardware threads) with per-thread partial histograms merged in worker
+  // order. Binning matches addHit() exactly; with more than one worker the
+  // per-bin sums can differ from the serial order in the last bits.
+  void addHits(const double* x, const double* y, const double* w,
+               std::size_t n, int threads = 0);
+
   void clear() { std::fill(bins.begin(), bins.end(), 0.0); }
 
   // Optional: convert counts to thickness (nm) using: thickness = (#atoms * m)/(rho*cell_area)
@@ -4,6 +4,8 @@
 
 #include "Subsystem.hpp"
 #include "TickContext.hpp"
+#include "Logger.hpp"
+#include "ThermalIntegrator.hpp"
 
 class WakeChamber;
 
@@ -36,6 +38,9 @@ class WakeChamber;
 // - Negative P_loss is allowed when T_cell < T_env_eff so the environment can
 //   passively warm the source.
 // - The scheduler-facing thermal band interface is unchanged.
+// - applyHeat() steps the node with explicit Euler by default; the Stable
+//   integrator (setThermalIntegrator) uses the exact RC exponential instead,
+//   so large ticks stay accurate.
 // -----------------------------------------------------------------------------
 class EffusionCell : public Subsystem {
 public:
@@ -59,11 +64,21 @@ public:
 
     void initialize() override;
     void tick(const TickContext& ctx) override;
+
+    // HeaterBank::tick() applies heat to this cell, so log after it.
+    std::vector<std::string> tickAfter() const override { return {"HeaterBank"}; }
     void shutdown() override;
+    void saveState(CheckpointWriter& ckpt) const override;
+    void loadState(const CheckpointReader& ckpt) override;
 
     // Called by HeaterBank to apply source heater power in watts for dt seconds.
     void applyHeat(double watts, double dt);
 
+    // Time-stepping scheme used by applyHeat() (see ThermalIntegrator.hpp).
+    // Set it before initialize(); only stable adds the "substeps" column.
+    void setThermalIntegrator(const ThermalIntegratorConfig& cfg) { integrator_.configure(cfg); }
+    int  lastThermalSubsteps() const { return integrator_.lastSubsteps(); }
+
     // Optional hookup to push parameters into the wake SPARTA instance.
     void setSpartaCtrl(WakeChamber* wc) { sparta_ctrl_ = wc; }
 
@@ -91,6 +106,10 @@ public:
     // Backward-compatible accessor.
     double getTemperature() const { return getTemperatureK(); }
 
+    // Passive (unheated) equilibrium temperatures in full eclipse (lo) and
+    // full sun (hi). An idle source settles and swings inside this band.
+    void idleBandK(double& lo_K, double& hi_K) const;
+
     // Actual heater power applied during the most recent applyHeat() call.
     double getLastHeatInputW() const { return last_heat_W_; }
 
@@ -207,6 +226,13 @@ private:
 
     WakeChamber* sparta_ctrl_{nullptr};
 
+    // Last tick logged by this cell (tick() may run twice for one tick).
+    int last_logged_tick_{-1};
+
+    ThermalIntegrator integrator_;
+
+    LogHandle log_;
+
     // Optional diagnostic path retained for compatibility.
     std::filesystem::path diag_path_ =
         std::filesystem::path("data") / "tmp" / "effusion_diag.csv";
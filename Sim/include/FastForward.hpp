@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Logger.hpp"
+
+class OrbitModel;
+class SimulationEngine;
+class SolarArray;
+class PowerBus;
+class Battery;
+class EffusionCell;
+class SubstrateHeater;
+
+// -----------------------------------------------------------------------------
+// FastForward
+//
+// Jumps the wake-mode harness over quiescent intervals: no job controls the
+// chamber, none is queued, the next release is still ahead, the beam is off,
+// heater demand is zero and both thermal nodes sit in their passive idle
+// band. main.cpp checks the scheduler side; thermallyIdle() checks the rest.
+//
+// advance() covers the whole gap in one call:
+//
+//   - the orbit moves in closed form (OrbitModel::stateAfter / advance)
+//   - solar input, base load and the battery are integrated tick by tick
+//     through the real PowerBus / Battery arithmetic, so eclipse entry and
+//     exit land on the same ticks as a stepped run
+//   - the effusion cell and substrate relax passively (applyHeat(0))
+//
+// No subsystem log rows, scheduler bookkeeping or SPARTA blocks are issued
+// for the skipped ticks. Each interval writes one FastForward row; with
+// decimate > 0, FastForwardSamples also gets one state row every decimate
+// skipped ticks.
+// -----------------------------------------------------------------------------
+
+struct FastForwardConfig {
+    bool   enabled       = false;
+    double thermal_tol_K = 5.0;   // margin around the passive idle bands
+    int    min_ticks     = 10;    // shorter gaps are stepped normally
+    int    decimate      = 0;     // 0 = summary rows only
+};
+
+struct FastForwardSpan {
+    int    first_tick          = 0;
+    int    last_tick           = -1;
+    int    sun_ticks           = 0;
+    int    eclipse_ticks       = 0;
+    int    eclipse_transitions = 0;
+    double solar_Wh            = 0.0;
+    double base_load_Wh        = 0.0;
+    double battery_start_Wh    = 0.0;
+    double battery_end_Wh      = 0.0;
+
+    int ticks() const { return last_tick - first_tick + 1; }
+};
+
+class FastForward {
+public:
+    FastForward(OrbitModel& orbit, SimulationEngine& engine, SolarArray& solar,
+                PowerBus& bus, Battery& battery, EffusionCell& effusion,
+                SubstrateHeater& substrate);
+
+    // Registers the log schemas when cfg.enabled (call on the leader only).
+    void configure(const FastForwardConfig& cfg);
+    const FastForwardConfig& config() const { return cfg_; }
+
+    // Both thermal nodes within thermal_tol_K of their passive idle bands.
+    bool thermallyIdle() const;
+
+    // Advances ticks first_tick .. first_tick + n - 1 and moves the engine
+    // clock past them. The caller must have established quiescence.
+    FastForwardSpan advance(int first_tick, int n, double dt);
+
+    int  spans() const { return spans_; }
+    long ticksSkipped() const { return ticks_skipped_; }
+
+    // Resumed runs carry the interrupted run's totals forward.
+    void restoreCounters(int spans, long ticks_skipped) {
+        spans_         = spans;
+        ticks_skipped_ = ticks_skipped;
+    }
+
+private:
+    OrbitModel&       orbit_;
+    SimulationEngine& engine_;
+    SolarArray&       solar_;
+    PowerBus&         bus_;
+    Battery&          battery_;
+    EffusionCell&     effusion_;
+    SubstrateHeater&  substrate_;
+
+    FastForwardConfig cfg_;
+    int  spans_         = 0;
+    long ticks_skipped_ = 0;
+
+    LogHandle log_;
+    LogHandle samples_;
+};
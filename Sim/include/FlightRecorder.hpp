@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// -----------------------------------------------------------------------------
+// FlightRecorder (per rank)
+//
+// The last N phase events of this rank, kept in memory: marks from the main
+// loop ("loop-top", "before-couple", ...) and enter/exit pairs around the
+// collectives a rank can hang in (the wake loop's TickControl wait, the
+// WakeChamber barriers and reductions, SPARTA blocks). Recording is one
+// fetch_add and a few relaxed stores into a fixed ring, from any thread;
+// nothing is formatted or written on the hot path.
+//
+// The recorder is dumped to <log dir>/flight_r<rank>.txt (appended; init()
+// creates the directory), with a one-line notice on stderr, when
+//   - a tick has been running longer than the watchdog deadline
+//     (--watchdog S, default 600; 0 turns the watchdog off). Every rank runs
+//     its own watchdog, so a rank stuck in a collective and the ranks waiting
+//     for it in the same collective all dump without talking to each other;
+//   - the process gets SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGTERM or
+//     SIGINT (also what mpirun sends the survivors of an abort).
+// A dump starts with the rank's MPI state: current tick and how long it has
+// run, the last event, and every collective entered but not left (per
+// thread, innermost last). The events follow, oldest first.
+//
+// Phase names must be string literals (or otherwise outlive the process):
+// the ring stores the pointer, and the signal-path dump cannot allocate.
+//
+//   FlightRecorder::instance().mark(tick, "before-couple");
+//   { FlightScope fs("MPI_Allreduce(wake.advance)"); MPI_Allreduce(...); }
+// -----------------------------------------------------------------------------
+
+class FlightRecorder {
+public:
+    enum class Kind : std::uint8_t { Mark = 0, Enter, Exit };
+
+    static FlightRecorder& instance();
+
+    // Sizes the ring (rounded up to a power of two) and fixes the dump file.
+    // Call once, before any thread records; until then record() is a no-op.
+    void init(int rank, std::size_t capacity, const std::string& dumpDir);
+
+    // Dumps on the fatal signals listed above, then re-raises them.
+    void installSignalHandlers();
+
+    // Starts/stops the watchdog thread. deadline_s <= 0 leaves it off. The
+    // deadline is measured from the first event of a tick; ticks < 1 (setup)
+    // are watched as well.
+    void startWatchdog(double deadline_s);
+    void stopWatchdog();
+
+    // Hot path. A mark with a new tick number starts that tick's deadline.
+    void mark(int tick, const char* phase) noexcept { record(Kind::Mark, tick, phase); }
+    void enter(const char* phase) noexcept {
+        record(Kind::Enter, tick_.load(std::memory_order_relaxed), phase);
+    }
+    void exit(const char* phase) noexcept {
+        record(Kind::Exit, tick_.load(std::memory_order_relaxed), phase);
+    }
+
+    // Appends a dump to the dump file and a notice to stderr. Async-signal
+    // safe (no allocation, only open/write/close).
+    void dump(const char* reason) noexcept;
+
+    int dumps() const { return dumps_.load(std::memory_order_relaxed); }
+
+private:
+    // seq is index + 1 once the slot is written; readers re-check it to
+    // skip slots overwritten while they read.
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<std::int64_t>  t_ns{0};
+        std::atomic<const char*>   phase{nullptr};
+        std::atomic<std::int32_t>  tick{0};
+        std::atomic<std::uint8_t>  kind{0};
+        std::atomic<std::uint8_t>  tid{0};
+    };
+
+    FlightRecorder() = default;
+    ~FlightRecorder() { stopWatchdog(); }
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(Kind kind, int tick, const char* phase) noexcept;
+    void watchdogLoop_();
+
+    std::unique_ptr<Slot[]>    ring_;
+    std::uint64_t              mask_ = 0;
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<bool>          ready_{false};
+
+    std::atomic<int>           tick_{-1};
+    std::atomic<std::int64_t>  tickStartNs_{0};
+    std::int64_t               epochNs_ = 0;
+    int                        rank_ = 0;
+    char                       path_[4096] = {0};
+    std::atomic<bool>          dumping_{false};
+    std::atomic<int>           dumps_{0};
+
+    std::int64_t               deadlineNs_ = 0;
+    std::thread                watchdog_;
+    std::mutex                 wdMtx_;
+    std::condition_variable    wdCv_;
+    bool                       wdStop_ = false;
+};
+
+// Enter/exit pair around a collective (or anything else a rank can block in).
+class FlightScope {
+public:
+    explicit FlightScope(const char* phase) : phase_(phase) {
+        FlightRecorder::instance().enter(phase_);
+    }
+    ~FlightScope() { FlightRecorder::instance().exit(phase_); }
+    FlightScope(const FlightScope&) = delete;
+    FlightScope& operator=(const FlightScope&) = delete;
+
+private:
+    const char* phase_;
+};
@@ -2,6 +2,7 @@
 
 #include "SimulationEngine.hpp"   // for TickContext
 #include "Subsystem.hpp"
+#include "WaferArchive.hpp"
 
 #include <cstddef>
 #include <cstdint>
@@ -9,6 +10,7 @@
 #include <vector>
 
 class PowerBus;  // forward declaration
+struct DepositionMap;
 
 class GrowthMonitor : public Subsystem {
 public:
@@ -17,6 +19,10 @@ public:
     // Only rank 0 should actually accumulate and write CSV.
     void setIsLeader(bool v) { isLeader_ = v; }
 
+    // Writes the wafer files into this subdirectory of the run's log
+    // directory (e.g. "member_3" in sweep mode). Call before initialize().
+    void setOutputSubdir(const std::string& subdir) { outputSubdir_ = subdir; }
+
     // Hook into the shared power bus so this instrument can draw power.
     void setPowerBus(PowerBus* bus) { bus_ = bus; }
 
@@ -30,25 +36,74 @@ public:
     // Optional: mark that a job was aborted early (still outputs wafer).
     void markJobAborted(int jobIndex);
 
+    // Call when the scheduler moves a job to Done or Aborted. Appends the
+    // job's wafer map to GrowthMonitor_{RUN_ID}.sfw and frees its storage;
+    // later dose for that job is ignored. Jobs still open at shutdown are
+    // archived then. The CSV is rebuilt from the archive at shutdown unless
+    // SF_WAFER_CSV=0 (or later with sflog2csv).
+    void finishJob(int jobIndex);
+
+    // The .sfw archive path, known after initialize() (empty before).
+    const std::string& archivePath() const { return archiveFilename_; }
+
+    // Non-uniform flux shape across the wafer, e.g. a SPARTA DepositionMap.
+    // The map is resampled onto this grid and normalized to mean 1 over the
+    // wafer, so Fwafer_cm2s stays the wafer-average flux. Until a profile is
+    // set (or after clearFluxProfile()) the flux is uniform and each job keeps
+    // a single scalar dose integral.
+    void setFluxProfile(const DepositionMap& map);
+    void clearFluxProfile();
+
+    // Flux shape given per wafer cell (n == waferCells().size(), e.g. the
+    // SPARTA wafer flux mapped by WakeChamber), normalized to mean 1 like
+    // setFluxProfile(). A sample with no positive flux (beam off, averaging
+    // window not filled yet) keeps the current profile and returns false.
+    // Reuses the profile's storage, so steady updates do not allocate.
+    bool updateFluxProfile(const double* cell_flux, std::size_t n);
+
+    // Dose grid: gridN x gridN cells, of which waferCells() (row-major
+    // indices, ascending) lie inside the wafer. Built at construction.
+    int gridN() const { return gridN_; }
+    const std::vector<std::uint32_t>& waferCells() const { return waferCells_; }
+
     // Subsystem interface
     void initialize() override;
     void tick(const TickContext& ctx) override;
+    void postPowerRequests(const TickContext& ctx) override;
+
+    // Draws instrument power after the heaters have taken theirs.
+    std::vector<std::string> tickAfter() const override { return {"HeaterBank"}; }
     void shutdown() override;
 
+    // Accumulators and the archive length; loadState() rolls the archive
+    // back to the checkpoint and appends from there.
+    void saveState(CheckpointWriter& ckpt) const override;
+    void loadState(const CheckpointReader& ckpt) override;
+
 private:
+    // Dose per wafer cell = uniform_dose + cell_dose[k]. uniform_dose sums
+    // the ticks integrated without a flux profile (the same in every cell);
+    // cell_dose sums the whole per-cell dose of the ticks under a profile,
+    // not its deviation from uniform. cell_dose stays empty until the first
+    // such tick and is indexed like waferCells_.
     struct JobAccum {
         bool aborted        = false;
         bool had_growth     = false;
         double last_t_end_s = 0.0;
-        std::vector<double> dose;  // length = gridN_ * gridN_
+        bool emitted        = false;   // written to the archive, storage freed
+        double uniform_dose = 0.0;
+        std::vector<double> cell_dose;
     };
 
     int    gridN_;
     double waferRadiusCells_;
     bool   isLeader_ = true;
 
-    // Precomputed mask: 1 if cell center lies inside wafer circle, else 0.
-    std::vector<std::uint8_t> waferMask_;
+    // Row-major grid indices of the cells whose centre lies inside the wafer.
+    std::vector<std::uint32_t> waferCells_;
+
+    // Relative flux per wafer cell (mean 1); empty = uniform.
+    std::vector<double> fluxProfile_;
 
     // Per-tick beam state (pushed from main)
     int    activeJobIndex_    = -1;
@@ -57,13 +112,22 @@ private:
 
     std::vector<JobAccum> jobs_;
     std::string csvFilename_;
+    std::string archiveFilename_;
+    std::string outputSubdir_;
+    WaferArchiveWriter archive_;
+    bool warnedLateDose_ = false;
 
     // Power coupling
     PowerBus* bus_           = nullptr;
     double    monitorPowerW_ = 5.0;  // fixed instrument load in watts
+    int       powerTicket_   = -1;   // batched request this tick, if posted
+
+    bool integratesThisTick_() const;
 
+    void openArchive();
     void buildWaferMask();
     void ensureJobStorage();
     void integrateDose(double dt, double t_now);
-    void writeCsv() const;
+    void emitJob(std::size_t j, WaferJobStatus status);
+    void writeCsv();
 };
@@ -22,9 +22,18 @@ public:
 
     void setPrioritySubstrate(bool priority);
 
+    // Last tick's requests (after the maxDraw clip) and bus grants, in W.
+    double lastEffusionRequestW()    const { return lastEffReq_; }
+    double lastEffusionDeliveredW()  const { return lastEffDelivered_; }
+    double lastSubstrateRequestW()   const { return lastSubReq_; }
+    double lastSubstrateDeliveredW() const { return lastSubDelivered_; }
+
     void initialize() override;
+    void postPowerRequests(const TickContext& ctx) override;
     void tick(const TickContext& ctx) override;
     void shutdown() override;
+    void saveState(CheckpointWriter& ckpt) const override;
+    void loadState(const CheckpointReader& ckpt) override;
 
 private:
     PowerBus* bus_ = nullptr;
@@ -38,5 +47,21 @@ private:
 
     bool prioritySubstrate_ = false;
 
+    double lastEffReq_       = 0.0;
+    double lastEffDelivered_ = 0.0;
+    double lastSubReq_       = 0.0;
+    double lastSubDelivered_ = 0.0;
+
+    // Batched allocation: this tick's posted requests and their tickets
+    // (-1 = draw inline in tick()).
+    double postedEffReq_ = 0.0;
+    double postedSubReq_ = 0.0;
+    int    effTicket_    = -1;
+    int    subTicket_    = -1;
+
+    void clippedRequests_(double& effReq, double& subReq);
+
     std::mutex demandMtx_;
+
+    LogHandle log_;
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <mpi.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// JobFarm (--mode farm)
+//
+// Runs many job schedules through the wake harness in one launch. Rank 0 is
+// the master: it holds the job list and hands job files out one at a time.
+// Ranks 1..size-1 are split into groups of group_size ranks (MPI_Comm_split);
+// each group runs one complete harness (WakeChamber, engine, subsystems) per
+// job on its own communicator and asks for the next job as soon as it is
+// done, so short and long schedules balance out. Ranks left over after the
+// last full group stay idle. A single-rank launch runs the jobs back to back
+// on that rank.
+//
+// Per job:
+// - streams go to <run_id>/ under the log directory (run_id = job file stem),
+//   as if the job had been launched alone with that RUN_ID;
+// - the group works in its own input directory, a mirror of the shared one
+//   (<work_dir>/g<k>/input, see mirrorInput()), so params.inc and the SPARTA
+//   files under data/tmp of concurrent groups never collide;
+// - the process working directory is restored afterwards (embedded SPARTA
+//   changes it to the input directory).
+//
+// Job spec: names, '*'/'?' globs and paths separated by commas or spaces.
+// Names and bare globs are resolved in the jobs directory; a path with a
+// '/' is used as given, and a glob in its last component expands in that
+// directory. Globs expand sorted over .txt files ("*" is every job file).
+//
+// Output: rank 0 writes Farm.csv with one row per job (the tick column holds
+// the job index, time_s the job's start relative to the farm's).
+// -----------------------------------------------------------------------------
+
+struct FarmJob {
+    std::string file;      // as listed, e.g. V4_job3.txt
+    std::string path;      // resolved job file
+    std::string run_id;    // log subdirectory
+};
+
+struct FarmJobResult {
+    int    job     = -1;
+    int    group   = 0;
+    int    ranks   = 1;
+    double start_s = 0.0;  // since the farm started
+    double wall_s  = 0.0;
+};
+
+struct FarmOptions {
+    int         group_size = 1;
+    std::string input_dir  = "input";   // the shared input directory
+    std::string work_dir;               // group input mirrors go under here
+};
+
+class JobFarm {
+public:
+    // The job body: runs job on comm (collective over the group). groupInput
+    // is the group's private input directory.
+    using Body = std::function<void(MPI_Comm comm, int group, const FarmJob& job,
+                                    const std::string& groupInput)>;
+
+    // Expands a spec into jobs. Throws std::runtime_error if a glob matches
+    // nothing, a listed job file does not exist or the spec is empty.
+    static std::vector<FarmJob> loadJobs(const std::string& spec, const std::string& jobsDir);
+
+    // Harness groups a launch of size ranks gets (0 if too few ranks).
+    static int groupCount(int size, int groupSize);
+
+    // Runs every job on the rank groups of comm (collective). Returns all
+    // results, ordered by job, on rank 0 and an empty vector elsewhere.
+    // Throws std::runtime_error if comm has too few ranks for one group.
+    static std::vector<FarmJobResult> run(MPI_Comm comm, const std::vector<FarmJob>& jobs,
+                                          const FarmOptions& opt, const Body& body);
+
+    // Rebuilds dest as a mirror of src: every entry is symlinked except
+    // params.inc (left for the harness to write) and data/, which is a real
+    // directory of symlinks with a real, empty data/tmp. Returns the
+    // absolute path of dest. Throws std::runtime_error on I/O failure.
+    static std::string mirrorInput(const std::string& src, const std::string& dest);
+
+    // Writes Farm.csv (rank 0).
+    static void writeTable(const std::vector<FarmJob>& jobs,
+                           const std::vector<FarmJobResult>& results);
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// -----------------------------------------------------------------------------
+// LineBuffer
+//
+// Reusable text for the tick loops' progress messages. Replaces
+//
+//     std::ostringstream oss;  oss << ...;  log_msg(oss.str());
+//
+// which builds a stream and a string per message, with one buffer per loop:
+//
+//     LineBuffer& oss = line.clear();  oss << ...;  log_msg(oss.str());
+//
+// clear() keeps the capacity, so once the longest message has been seen no
+// further allocation happens. Values are formatted like a default-configured
+// std::ostream (doubles as "%g", bools as 0/1), so the messages are byte for
+// byte what the streams wrote. One message at a time: str() is only valid
+// until the next clear().
+// -----------------------------------------------------------------------------
+
+class LineBuffer {
+public:
+    explicit LineBuffer(std::size_t reserve = 512) { s_.reserve(reserve); }
+
+    LineBuffer& clear() {
+        s_.clear();
+        return *this;
+    }
+    const std::string& str() const { return s_; }
+
+    LineBuffer& operator<<(std::string_view v) {
+        s_.append(v.data(), v.size());
+        return *this;
+    }
+    LineBuffer& operator<<(const char* v) { return *this << std::string_view(v); }
+    LineBuffer& operator<<(const std::string& v) { return *this << std::string_view(v); }
+    LineBuffer& operator<<(char v) {
+        s_.push_back(v);
+        return *this;
+    }
+    LineBuffer& operator<<(bool v) { return *this << (v ? '1' : '0'); }
+    LineBuffer& operator<<(int v) { return format_("%d", v); }
+    LineBuffer& operator<<(long v) { return format_("%ld", v); }
+    LineBuffer& operator<<(long long v) { return format_("%lld", v); }
+    LineBuffer& operator<<(unsigned v) { return format_("%u", v); }
+    LineBuffer& operator<<(unsigned long v) { return format_("%lu", v); }
+    LineBuffer& operator<<(unsigned long long v) { return format_("%llu", v); }
+    LineBuffer& operator<<(double v) { return format_("%g", v); }
+
+private:
+    template <typename T>
+    LineBuffer& format_(const char* fmt, T v) {
+        char buf[32];
+        const int n = std::snprintf(buf, sizeof(buf), fmt, v);
+        if (n > 0) s_.append(buf, static_cast<std::size_t>(n));
+        return *this;
+    }
+
+    std::string s_;
+};
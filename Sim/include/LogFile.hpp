@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Logger file I/O with optional stream compression.
+//
+// The codec is picked once per process from env SF_LOG_COMPRESS:
+//   none (default)  plain files
+//   gzip            <file>.gz, gzip framing (zcat, pandas and zlib read it
+//                   directly); needs a zlib build
+// SF_LOG_COMPRESS_LEVEL sets the zlib level (default 1, speed over ratio so
+// the async writer keeps up).
+//
+// Compressed files are written in blocks. Every SF_LOG_BLOCK bytes of input
+// (default 1 MiB) the compressor is sync-flushed to disk, so a crash loses at
+// most one block. Per-row and async batch flushes only hand rows to the
+// compressor: with ~100-byte rows a block is about 10000 rows, some twenty
+// async batches (SF_LOG_BATCH, default 512), so blocks stay full size.
+// seal() ends the gzip member; the file is then a complete .gz up to there,
+// and a file truncated to that length can be appended to with a new member
+// (checkpoint/resume). Concatenated members read back as one stream.
+
+enum class LogCodec : std::uint8_t { None = 0, Gzip };
+
+// SF_LOG_COMPRESS, resolved once. Unknown codecs, zstd/lz4 and gzip without
+// zlib warn and fall back (gzip when built with zlib, otherwise none).
+LogCodec resolveLogCodec();
+
+// File-name suffix for a codec: "" or ".gz".
+const char* logCodecExtension(LogCodec codec);
+
+// Splits CSV text into records, undoing the Logger's field escaping (quoted
+// fields may hold commas, quotes and newlines). Used for the SF_LOG_DICT
+// dictionaries.
+std::vector<std::vector<std::string>> parseCsvRecords(const std::string& text);
+
+// Append-only output file. Not thread-safe; Logger serializes access.
+class LogFileOut {
+public:
+    LogFileOut();
+    ~LogFileOut();
+
+    LogFileOut(const LogFileOut&) = delete;
+    LogFileOut& operator=(const LogFileOut&) = delete;
+
+    // Truncates (or appends to) path. Throws std::runtime_error if the file
+    // cannot be opened or the codec is unavailable.
+    void open(const std::string& path, bool append, LogCodec codec);
+    bool is_open() const { return fp_ != nullptr; }
+    LogCodec codec() const { return codec_; }
+
+    // Throws std::runtime_error on a failed write.
+    void write(const void* data, std::size_t n);
+
+    // Plain files: fflush. Compressed files: nothing until a block is full.
+    void flush();
+    // Everything written so far is complete on disk (ends the gzip member).
+    void seal();
+    void close();
+
+private:
+    struct Deflater;
+
+    void deflate_(int mode);
+
+    std::FILE*                fp_    = nullptr;
+    LogCodec                  codec_ = LogCodec::None;
+    std::unique_ptr<Deflater> z_;
+    std::size_t               block_bytes_ = 0;    // input since the last sync point
+    bool                      member_open_ = false; // input since the last seal
+};
+
+// Sequential reader for files written by LogFileOut; compressed files are
+// detected from their content, not their name.
+class LogFileIn {
+public:
+    LogFileIn() = default;
+    ~LogFileIn();
+
+    LogFileIn(const LogFileIn&) = delete;
+    LogFileIn& operator=(const LogFileIn&) = delete;
+
+    // Throws std::runtime_error on a missing file, or a compressed file in a
+    // build without zlib.
+    void open(const std::string& path);
+    bool is_open() const { return handle_ != nullptr; }
+
+    // Returns the bytes read; short at EOF or on a truncated stream.
+    std::size_t read(void* data, std::size_t n);
+    // -1 at EOF.
+    int getc();
+
+    void close();
+
+private:
+    void* handle_ = nullptr;   // gzFile with zlib, FILE* without
+};
+
+// std::ostream over a LogFileOut, so CSV rows keep the default stream
+// number formatting whatever the codec.
+class LogOStream : public std::ostream {
+public:
+    LogOStream();
+    ~LogOStream() override;
+
+    void open(const std::string& path, bool append, LogCodec codec);
+    bool is_open() const { return file_.is_open(); }
+    // Flushes the stream, then seals the file (see LogFileOut::seal()).
+    void seal();
+    void close();
+
+private:
+    class Buf : public std::streambuf {
+    public:
+        explicit Buf(LogFileOut& f);
+        int drain();
+
+    protected:
+        int_type overflow(int_type ch) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        int sync() override;
+
+    private:
+        LogFileOut& file_;
+        char        buf_[8192];
+    };
+
+    LogFileOut file_;
+    Buf        buf_;
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// LogIndex
+//
+// Sidecar index for one CSV log (<file>.csv -> <file>.csv.sfidx) so queries
+// over many runs read only the rows that can match. The data rows are cut
+// into blocks of block_rows rows; each block keeps its byte range and, per
+// column, the min and max of its values. A column whose block holds any
+// cell that is not a number (text, empty, nan) has NaN bounds there and is
+// never used to skip that block.
+//
+//   header:
+//     char     magic[8]        "SFLIDX\0\0"
+//     uint32   version         (kLogIndexVersion)
+//     uint32   ncols
+//     uint32   block_rows
+//     uint32   nblocks
+//     uint64   indexed_bytes   source bytes covered, up to the last full line
+//     int64    source_mtime    filesystem clock ticks
+//     uint64   tail_hash       FNV-1a of the 64 bytes before indexed_bytes
+//     uint32   header_bytes    CSV header line, then the text itself
+//   nblocks x block:
+//     uint64 offset, uint64 bytes, uint32 rows, uint32 pad,
+//     ncols x { float64 min, float64 max }
+//
+// An index whose size and mtime match the file is used as is. Logger files
+// only grow while a run writes them, so a longer file whose bytes at the old
+// end still hash the same keeps its blocks and indexes the new rows as
+// further blocks; anything else is rebuilt. Failing to write the sidecar
+// (read-only tree) is not an error.
+//
+// LogQuery is a conjunction of column predicates ("tick>=100",
+// "job_failed=1", "scheduler_state_name=aborted"). A term compares as a
+// number when both sides parse as one and as text otherwise; a term on a
+// column the file lacks matches nothing. Blocks whose bounds rule out a
+// numeric term are skipped without being read.
+// -----------------------------------------------------------------------------
+
+constexpr std::uint32_t kLogIndexVersion    = 1;
+constexpr std::size_t   kLogIndexBlockRows  = 4096;
+
+struct LogQueryTerm {
+    enum Op { Eq, Ne, Lt, Le, Gt, Ge };
+
+    std::string column;
+    Op          op = Eq;
+    std::string text;            // right-hand side as written
+    double      value = 0.0;     // ... and as a number, if numeric
+    bool        numeric = false;
+};
+
+class LogQuery {
+public:
+    // "col<op>value[,col<op>value...]" with op one of = == != < <= > >=.
+    // Throws std::runtime_error on a term without an operator or column.
+    void addTerms(const std::string& spec);
+    void addTerm(const std::string& column, LogQueryTerm::Op op, const std::string& text);
+
+    // Keeps rows with tick in [first, last].
+    void addTickRange(long first, long last);
+
+    const std::vector<LogQueryTerm>& terms() const { return terms_; }
+    bool empty() const { return terms_.empty(); }
+
+private:
+    std::vector<LogQueryTerm> terms_;
+};
+
+class LogIndex {
+public:
+    struct Block {
+        std::uint64_t offset = 0;
+        std::uint64_t bytes  = 0;
+        std::uint32_t rows   = 0;
+        std::vector<double> min, max;   // per column; NaN = not all numeric
+    };
+
+    struct LoadInfo {
+        bool built    = false;   // every block indexed from scratch
+        bool extended = false;   // new rows appended to a loaded index
+        bool written  = false;   // sidecar (re)written
+    };
+
+    // Sidecar path for a log file.
+    static std::string indexPath(const std::string& csvPath);
+
+    // Index of csvPath through its sidecar (see above); rebuild ignores an
+    // existing one. Throws std::runtime_error if the file cannot be read.
+    static LogIndex load(const std::string& csvPath, std::size_t block_rows = kLogIndexBlockRows,
+                         bool rebuild = false, LoadInfo* info = nullptr);
+
+    const std::string& path() const { return path_; }
+    const std::vector<std::string>& columns() const { return columns_; }
+    int column(const std::string& name) const;   // -1 if absent
+
+    const std::vector<Block>& blocks() const { return blocks_; }
+    std::uint64_t indexedBytes() const { return indexed_bytes_; }
+    std::uint64_t rows() const;
+
+    // Whether some row of block b could satisfy every term (by its bounds).
+    // cols[k] is the column of term k, from resolve().
+    bool mayMatch(std::size_t b, const LogQuery& q, const std::vector<int>& cols) const;
+
+    // Columns of q's terms in this file; false if one is missing.
+    bool resolve(const LogQuery& q, std::vector<int>& cols) const;
+
+    // Reads block b's bytes from fp (the indexed file). Throws
+    // std::runtime_error on a short read.
+    void readBlock(std::FILE* fp, std::size_t b, std::string& out) const;
+
+    // The record starting at pos in data (a quoted field may span lines),
+    // without its line end; pos moves past it. False at the end of data.
+    static bool nextRecord(const std::string& data, std::size_t& pos, std::string& line);
+
+    // Splits one CSV record into fields, undoing the Logger's quoting.
+    static void splitRecord(const std::string& line, std::vector<std::string>& fields);
+
+    // Whether a row (fields as from splitRecord) satisfies every term.
+    static bool rowMatches(const std::vector<std::string>& fields, const LogQuery& q,
+                           const std::vector<int>& cols);
+
+private:
+    void scan_(const std::string& data, std::uint64_t base, std::size_t block_rows);
+    bool write_() const;
+
+    std::string              path_;
+    std::vector<std::string> columns_;
+    std::string              header_;
+    std::vector<Block>       blocks_;
+    std::size_t              block_rows_    = kLogIndexBlockRows;
+    std::uint64_t            indexed_bytes_ = 0;
+    std::int64_t             mtime_         = 0;
+};
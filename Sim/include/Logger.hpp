@@ -1,11 +1,43 @@
 #pragma once
 
+#include <mpi.h>
+
 #include <mutex>
 #include <map>
+#include <set>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+
+#include "BinaryLog.hpp"
+#include "LogFile.hpp"
+
+template <typename T> class MpscRing;
+class LogHandle;
+class TextLogHandle;
 
+// Output options, read once per process from the environment (alongside
+// SF_LOG_DIR / RUN_ID):
+//   SF_LOG_FORMAT=bin     numeric wide streams as <subsystem>.sfb (BinaryLog.hpp)
+//   SF_LOG_COMPRESS=gzip  .csv.gz / .sfb.gz in SF_LOG_BLOCK blocks (LogFile.hpp)
+//   SF_LOG_DICT=1         string columns as codes, decoded by <subsystem>.dict.csv
+//   SF_LOG_ASYNC=1        numeric rows queued to a writer thread (SF_LOG_RING,
+//                         SF_LOG_BATCH, SF_LOG_FLUSH_MS); text rows stay synchronous
+//   SF_LOG_BACKEND=mpiio  registerSharedSchema() streams: one file for all ranks,
+//                         written per window (SF_LOG_WINDOW, SF_LOG_AGGREGATE=node)
+//
+// Hot paths register a schema once and keep the handle; its rows do not
+// allocate:
+//   LogHandle h = Logger::instance().registerSchema("Battery", {"status","charge_Wh"});
+//   h.write(tick, t, {1.0, charge});
 class Logger {
 public:
     static Logger& instance();
@@ -35,12 +67,246 @@ public:
                   const std::vector<std::string>& columns,
                   const std::vector<std::string>& values);
 
+    // Numeric wide schema for a subsystem; the file opens on the first row.
+    // Re-registering with different columns throws std::runtime_error.
+    LogHandle registerSchema(const std::string& subsystem,
+                             const std::vector<std::string>& columns);
+
+    // Same for string rows; values are written without copies.
+    TextLogHandle registerTextSchema(const std::string& subsystem,
+                                     const std::vector<std::string>& columns);
+
+    // Stream written by every rank of the attached communicator (mpiio
+    // backend). Every rank must register the same shared streams.
+    LogHandle registerSharedSchema(const std::string& subsystem,
+                                   const std::vector<std::string>& columns);
+
+    // Drains queued rows and flushes (and seals) every file but the shared
+    // streams. Call before MPI_Finalize and at checkpoints.
+    void flush();
+
+    // Collective MPI-IO backend calls: attachComm() once after MPI_Init,
+    // flushShared() per window, finishShared() before MPI_Finalize (no-ops
+    // without the backend). Throw std::runtime_error if MPI-IO fails.
+    void attachComm(MPI_Comm comm);
+    void flushShared();
+    void finishShared();
+    bool mpiioEnabled() const { return mpiio_; }
+    int  sharedWindow() const { return shared_window_; }
+
+    // Prefixes the subsystem names used by the calling thread while alive
+    // ("member_3/" -> files in member_3/). Scopes nest.
+    class ScopedPrefix {
+    public:
+        explicit ScopedPrefix(const std::string& prefix);
+        ~ScopedPrefix();
+        ScopedPrefix(const ScopedPrefix&) = delete;
+        ScopedPrefix& operator=(const ScopedPrefix&) = delete;
+    private:
+        std::string saved_;
+    };
+
+    // Drains and closes every sink whose name starts with prefix; a later
+    // row reopens and truncates its file.
+    void closeStreams(const std::string& prefix);
+
+    // Drops the rows the calling thread logs while alive (e.g. start-up rows
+    // of a resumed run).
+    class ScopedDiscard {
+    public:
+        ScopedDiscard();
+        ~ScopedDiscard();
+        ScopedDiscard(const ScopedDiscard&) = delete;
+        ScopedDiscard& operator=(const ScopedDiscard&) = delete;
+    };
+
+    // Checkpoint/restart: fileOffsets() drains and returns the length of each
+    // open file (relative to directory()); resumeAppend() truncates them back
+    // so their next open appends. Call it before the resumed run logs; it
+    // throws std::runtime_error if a file is missing or too short.
+    std::map<std::string, std::uint64_t> fileOffsets();
+    void resumeAppend(const std::map<std::string, std::uint64_t>& offsets);
+
+    // Log directory for this process (SF_LOG_DIR / RUN_ID resolution).
+    static std::string directory();
+
+    // Writer/back-pressure counters (async mode; zeros otherwise).
+    struct Stats {
+        std::uint64_t rows_pushed      = 0;  // rows accepted into the ring
+        std::uint64_t rows_written     = 0;  // rows written by the writer thread
+        std::uint64_t ring_full_stalls = 0;  // producer pushes that found the ring full
+        std::uint64_t stall_spins      = 0;  // total yield() iterations spent waiting
+        std::uint64_t sync_fallbacks   = 0;  // numeric rows too wide for a record
+        std::uint64_t flushes          = 0;  // batch flushes issued by the writer
+        std::uint64_t max_depth        = 0;  // high-water mark of queued records
+        std::size_t   ring_capacity    = 0;
+    };
+    Stats stats() const;
+    bool asyncEnabled() const { return async_; }
+
+    static constexpr std::size_t kAsyncMaxCols = 48;
+
 private:
-    Logger() = default;
+    friend class LogHandle;
+    friend class TextLogHandle;
+
+    Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    std::mutex mtx_;
-    std::ofstream central_;
-    std::map<std::string, std::ofstream> per_node_;
-};
\ No newline at end of file
+    // Per-subsystem output. Text rows (tall and string-wide) always go to csv;
+    // numeric wide rows go to csv or bin depending on SF_LOG_FORMAT.
+    struct Sink {
+        std::string                       name;
+        std::mutex                        io_mtx;
+        LogOStream                        csv;
+        LogOStream                        dict;           // SF_LOG_DICT string codes
+        std::vector<std::map<std::string, long, std::less<>>> codes;  // per column, string_view lookups
+        std::unique_ptr<BinaryLogWriter>  bin;
+        bool                              dirty = false;  // unflushed async rows
+        std::vector<std::string>          columns;        // registered/first wide header
+        std::atomic<bool>                 numeric_open{false};
+
+        // MPI-IO shared stream: rows buffered until the next window.
+        bool                              shared = false;
+        std::string                       pending;
+        std::string                       window;         // flushShared() scratch
+        MPI_File                          fh = MPI_FILE_NULL;
+        MPI_Offset                        offset = 0;
+    };
+
+    // Fixed-size ring record for one numeric wide row.
+    struct Record {
+        Sink*         sink;
+        std::int64_t  tick;
+        double        time;
+        std::uint32_t ncols;
+        double        vals[kAsyncMaxCols];
+    };
+
+    Sink& lookup_(const std::string& subsystem);
+    Sink& registerColumns_(const std::string& subsystem, const std::vector<std::string>& columns);
+    void  writeTextRow_(Sink& s, int tick, double time,
+                        const std::string_view* vals, std::size_t nvals);
+    void  openText_(Sink& s, const std::vector<std::string>* wide_cols, bool is_wide);
+    void  openDict_(Sink& s);
+    long  dictCode_(Sink& s, std::size_t col, std::string_view value);
+    void  openNumeric_(Sink& s, const std::vector<std::string>& cols);
+    void  commitNumeric_(Sink& s, int tick, double time,
+                         const double* vals, std::size_t ncols);
+    void  writeNumericRow_(Sink& s, std::int64_t tick, double time,
+                           const double* vals, std::size_t ncols);
+    void  pushAsync_(Sink& s, int tick, double time,
+                     const double* vals, std::size_t ncols);
+    void  writerLoop_();
+    void  flushAllSinks_(bool seal);
+    void  appendShared_(Sink& s, int tick, double time,
+                        const double* vals, std::size_t ncols);
+    std::vector<Sink*> sharedSinks_();
+
+    std::mutex                                   mtx_;   // guards sinks_ map
+    std::map<std::string, std::unique_ptr<Sink>> sinks_;
+
+    // Files rolled back by resumeAppend() and not reopened yet.
+    bool takeResumed_(const std::string& file);
+    std::mutex                                   resume_mtx_;
+    std::set<std::string>                        resume_files_;
+
+    // Async machinery
+    bool                               async_ = false;
+    std::size_t                        batch_rows_ = 512;
+    int                                flush_ms_   = 250;
+    std::unique_ptr<MpscRing<Record>>  ring_;
+    std::thread                        writer_;
+    std::atomic<bool>                  stop_{false};
+    std::atomic<bool>                  writer_sleeping_{false};
+    std::mutex                         wake_mtx_;
+    std::condition_variable            wake_cv_;
+    std::condition_variable            drained_cv_;
+
+    std::atomic<std::uint64_t> rows_pushed_{0};
+    std::atomic<std::uint64_t> rows_written_{0};
+    std::atomic<std::uint64_t> ring_full_stalls_{0};
+    std::atomic<std::uint64_t> stall_spins_{0};
+    std::atomic<std::uint64_t> sync_fallbacks_{0};
+    std::atomic<std::uint64_t> flushes_{0};
+    std::atomic<std::uint64_t> max_depth_{0};
+
+    // MPI-IO backend
+    bool     mpiio_         = false;
+    int      comm_rank_     = 0;
+    int      comm_size_     = 1;
+    int      shared_window_ = 64;
+    MPI_Comm comm_          = MPI_COMM_NULL;   // attached communicator (dup)
+    MPI_Comm node_comm_     = MPI_COMM_NULL;   // SF_LOG_AGGREGATE=node only
+    MPI_Comm io_comm_       = MPI_COMM_NULL;   // ranks that open the files
+};
+
+// Pre-registered numeric schema bound to one Logger sink; one owner per
+// handle. write() and row().commit() throw unless the row fills the schema.
+class LogHandle {
+public:
+    LogHandle() = default;
+
+    bool valid() const { return sink_ != nullptr; }
+    std::size_t width() const { return width_; }
+
+    class Row {
+    public:
+        Row& set(std::size_t col, double v);
+        void commit();
+
+    private:
+        friend class LogHandle;
+        Row(LogHandle& h, int tick, double time) : h_(h), tick_(tick), time_(time) {}
+
+        LogHandle&  h_;
+        int         tick_;
+        double      time_;
+        std::size_t nset_ = 0;
+    };
+
+    // Starts a row. Values are staged in the handle's scratch buffer.
+    Row row(int tick, double time);
+
+    // Writes a complete row in column order.
+    void write(int tick, double time, std::initializer_list<double> vals);
+    void write(int tick, double time, const double* vals, std::size_t n);
+
+private:
+    friend class Logger;
+    LogHandle(Logger* logger, Logger::Sink* sink, std::size_t width)
+        : logger_(logger), sink_(sink), width_(width),
+          scratch_(width, 0.0), stamp_(width, 0u) {}
+
+    void checkValid_() const;
+
+    Logger*                    logger_ = nullptr;
+    Logger::Sink*              sink_   = nullptr;
+    std::size_t                width_  = 0;
+    std::vector<double>        scratch_;
+    std::vector<std::uint32_t> stamp_;   // row generation that last set each column
+    std::uint32_t              gen_ = 0;
+};
+
+// Pre-registered text schema bound to one Logger sink (see
+// Logger::registerTextSchema()). write() throws std::runtime_error if the
+// value count differs from the registered header.
+class TextLogHandle {
+public:
+    TextLogHandle() = default;
+
+    bool valid() const { return sink_ != nullptr; }
+    std::size_t width() const { return width_; }
+
+    void write(int tick, double time, std::initializer_list<std::string_view> vals);
+
+private:
+    friend class Logger;
+    TextLogHandle(Logger* logger, Logger::Sink* sink, std::size_t width)
+        : logger_(logger), sink_(sink), width_(width) {}
+
+    Logger*       logger_ = nullptr;
+    Logger::Sink* sink_   = nullptr;
+    std::size_t   width_  = 0;
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "Logger.hpp"
+#include "orbit.hpp"
+
+class Battery;
+class SolarArray;
+
+// -----------------------------------------------------------------------------
+// MissionProfile
+//
+// Power and energy trajectories over mission-length spans (months at 1-10 s
+// ticks, 1e7-1e8 ticks) without SimulationEngine. One tight loop per orbit
+// fuses the power-mode tick for a spacecraft with no jobs:
+//
+//   SolarArray generation -> base-load draw -> payload draw (PowerBus:
+//   bus first, then Battery::discharge within the discharge limit) ->
+//   surplus to Battery::chargeFromSurplus
+//
+// with the arithmetic of those classes written out in their operation order,
+// so a tick changes the battery charge bit for bit as SimulationEngine does.
+//
+// Generation comes from an ephemeris: the configured OrbitModel (direct or
+// its own ephemeris table) is stepped once over the shortest whole number
+// of orbits that is also a whole number of ticks, and every later orbit
+// replays that table. The array, battery and orbit parameters are read from
+// the subsystem objects handed to the constructor.
+//
+// Output: no per-tick rows. Each MissionOrbits row sums orbits_per_row orbits
+// (state of charge min/max/mean as a fraction of capacity, energy generated,
+// served, charged, curtailed, and the deficit the loads asked for but did
+// not get) and summary() keeps the run totals.
+//
+// validate() runs the same parameters through the real subsystems under
+// SimulationEngine for a short window and reports the largest difference.
+// -----------------------------------------------------------------------------
+
+// Loads the kernel draws each tick. Defaults match the power harness.
+struct MissionConfig {
+    double base_load_W    = 400.0;   // SimulationEngine::baseLoadW()
+    double payload_W      = 0.0;     // constant Loads-phase draw after the base load
+    int    orbits_per_row = 1;
+};
+
+struct MissionSummary {
+    long   ticks          = 0;
+    long   orbits         = 0;       // completed
+    double soc_min        = 1.0;
+    long   soc_min_tick   = 0;
+    double generated_Wh   = 0.0;
+    double served_Wh      = 0.0;
+    double deficit_Wh     = 0.0;
+    long   deficit_ticks  = 0;
+    long   deficit_orbits = 0;       // orbits with any unserved load
+};
+
+class MissionProfile {
+public:
+    // Throws std::runtime_error if dt is not positive or no table of at most
+    // a few million ticks covers a whole number of orbits.
+    MissionProfile(const SolarArray& solar, const Battery& battery, const OrbitModel& orbit,
+                   double dt, const MissionConfig& cfg);
+
+    // Registers the MissionOrbits schema; without it run() writes no rows.
+    void enableLog();
+
+    // Advances n ticks, continuing from the previous call.
+    void run(long n);
+
+    std::size_t ephemerisTicks() const { return solar_W_.size(); }
+    int         ephemerisOrbits() const { return table_orbits_; }
+
+    double chargeWh() const { return charge_; }
+    // Totals over every tick run so far; rows only cover whole rows.
+    MissionSummary summary() const;
+
+    struct Check {
+        long   requested          = 0;
+        long   ticks              = 0;   // validated (negative requests run none)
+        double max_charge_diff_Wh = 0.0;
+        double max_solar_diff_W   = 0.0;
+    };
+
+    // n ticks of a fresh kernel next to SolarArray / PowerBus / Battery
+    // under SimulationEngine, both from a fresh Battery's charge; the solar
+    // output is compared with the table entry the kernel used, wrapping
+    // past the end of the ephemeris. Logger rows of the window are discarded.
+    Check validate(long n) const;
+
+private:
+    // Ticks [lo, hi) of the table, all inside one orbit.
+    void kernel_(std::size_t lo, std::size_t hi);
+    void finishOrbit_();
+
+    // Parameters (from the subsystems and cfg).
+    double dt_;
+    MissionConfig cfg_;
+    double efficiency_, base_input_W_;
+    double capacity_Wh_, max_charge_W_, max_discharge_W_;
+    OrbitModel orbit0_;              // as handed in, for validate()
+
+    // Ephemeris: solar output per tick over table_orbits_ orbits, and the
+    // table position after the last tick of each of those orbits.
+    std::vector<double>      solar_W_;
+    std::vector<std::size_t> orbit_end_;
+    int                      table_orbits_ = 1;
+
+    // State.
+    double      charge_;
+    std::size_t pos_         = 0;   // next table position
+    int         table_orbit_ = 0;   // orbit within the table
+    long        tick_        = 0;   // last tick run
+
+    // Current row's accumulators (orbits_per_row orbits).
+    struct Row {
+        long   first_tick = 1;
+        int    orbits     = 0;
+        long   ticks      = 0;
+        double soc_min_Wh = 0.0, soc_max_Wh = 0.0, soc_sum_Wh = 0.0;
+        long   soc_min_tick = 0;
+        double gen_W = 0.0, served_W = 0.0, deficit_W = 0.0;
+        double charged_Wh = 0.0, surplus_W = 0.0;
+        long   sun_ticks = 0, deficit_ticks = 0;
+        long   orbit_deficit_ticks = 0;   // current orbit only
+    } row_;
+    void addRow_(MissionSummary& m, const Row& r) const;
+
+    MissionSummary summary_;
+    LogHandle      log_;
+};
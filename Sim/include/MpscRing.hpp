@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+// Bounded lock-free multi-producer / single-consumer ring (Vyukov-style
+// sequence numbers per cell). T must be trivially copyable-ish; records are
+// written in place by the producer via a callback so large fixed-size
+// records are never copied twice.
+//
+// Capacity must be a power of two.
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(std::size_t capacity)
+        : mask_(capacity - 1),
+          cells_(new Cell[capacity]) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("MpscRing: capacity must be a power of two >= 2");
+        }
+        for (std::size_t i = 0; i < capacity; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Producer side. Calls fill(T&) on a reserved slot and publishes it.
+    // Returns false (without calling fill) if the ring is full.
+    template <typename Fill>
+    bool tryPush(Fill&& fill) {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff =
+                static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side (single thread only). Calls consume(const T&) on the
+    // oldest published record and frees the slot. Returns false if empty.
+    template <typename Consume>
+    bool tryPop(Consume&& consume) {
+        Cell& cell = cells_[dequeue_ & mask_];
+        const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(dequeue_ + 1) < 0) {
+            return false; // empty (or producer still filling this slot)
+        }
+        consume(cell.value);
+        cell.seq.store(dequeue_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_;
+        return true;
+    }
+
+    // Approximate number of queued records (for stats only).
+    std::size_t sizeApprox() const {
+        const std::size_t e = enqueue_.load(std::memory_order_relaxed);
+        const std::size_t d = dequeue_snapshot_.load(std::memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+
+    // Consumer publishes its position for sizeApprox().
+    void publishConsumerPos() { dequeue_snapshot_.store(dequeue_, std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq{0};
+        T value;
+    };
+
+    const std::size_t        mask_;
+    std::unique_ptr<Cell[]>  cells_;
+
+    alignas(64) std::atomic<std::size_t> enqueue_{0};
+    alignas(64) std::size_t              dequeue_ = 0;
+    std::atomic<std::size_t>             dequeue_snapshot_{0};
+};
@@ -0,0 +1,172 @@
+#pragma once
+#include <mpi.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Battery.hpp"
+#include "EffusionCell.hpp"
+#include "GrowthMonitor.hpp"
+#include "HeaterBank.hpp"
+#include "PowerBus.hpp"
+#include "SimulationEngine.hpp"
+#include "SolarArray.hpp"
+#include "SubstrateHeater.hpp"
+#include "ThermalIntegrator.hpp"
+#include "helpers.hpp"
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// -----------------------------------------------------------------------------
+// ParameterSweep (--mode sweep)
+//
+// Runs many independent power/thermal harness configurations in one launch.
+// Each member builds its own scalar subsystems (SolarArray, HeaterBank,
+// SubstrateHeater, EffusionCell, GrowthMonitor, PowerBus, Battery) on a
+// private SimulationEngine, so members may use different dt values and run
+// concurrently on worker threads. Members are handed out dynamically: rank 0
+// owns a shared counter, its worker threads take indices directly and other
+// ranks request them over MPI as their threads free up.
+//
+// Spec file: one axis per line, "name = values". Values are separated by
+// spaces or commas; "a:step:b" expands to an inclusive range. Members are
+// the Cartesian product of the axes in file order (the last axis varies
+// fastest); omitted axes keep their defaults. Blank lines and '#' comments
+// are skipped.
+//
+//   job_file            = V4_job1.txt V4_job2.txt   # or "*", or "none"
+//   solar_efficiency    = 0.20 0.25 0.30
+//   solar_base_input_W  = 20000:5000:40000
+//   battery_capacity_Wh = 6000
+//   heater_max_draw_W   = 4000 5000
+//   dt                  = 60 300
+//
+// job_file names are resolved in the jobs directory; "*" expands to every
+// .txt file there (sorted), "none" gives the fixed power-mode demands.
+//
+// Member semantics:
+// - Without a job file a member performs the --mode power tick sequence
+//   exactly (1500 W effusion demand, no substrate demand, beam off), so the
+//   default member reproduces the power-mode CSVs.
+// - With a job file the rows drive demands open-loop in time: job ticks are
+//   minutes (as in active_jobs/), a row is active for start*60 <= t <
+//   end*60, its heater_W is the effusion demand, its substrate target is
+//   held by SubstrateHeater's own control law and mbe_on/Fwafer_cm2s feed
+//   GrowthMonitor. There are no readiness gates, queues or SPARTA.
+// - Every member simulates the same span (--nticks x --dt), i.e.
+//   round(span / dt) ticks of its own dt.
+//
+// Output: member k writes its usual subsystem files into member_k/ under
+// the run's log directory; rank 0 writes Sweep.csv with one row per member
+// (the tick column holds the member index, time_s the simulated span).
+// -----------------------------------------------------------------------------
+
+struct SweepMemberParams {
+    std::string job_file;                 // "" = fixed power-mode demands
+    double solar_efficiency    = 0.25;
+    double solar_base_input_W  = 30000.0;
+    double battery_capacity_Wh = 6000.0;
+    double heater_max_draw_W   = 5000.0;
+    double dt                  = 60.0;
+};
+
+struct SweepMemberResult {
+    int    member       = -1;
+    int    rank         = 0;
+    int    ticks        = 0;
+    int    jobs         = 0;
+    int    skipped_rows = 0;   // malformed job rows ignored
+    double battery_final_Wh  = 0.0;
+    double battery_min_Wh    = 0.0;
+    double solar_Wh          = 0.0;
+    double effusion_heat_Wh  = 0.0;
+    double substrate_heat_Wh = 0.0;
+    double unmet_heat_Wh     = 0.0;   // heater demand the bus could not grant
+    double effusion_max_K    = 0.0;
+    double effusion_final_K  = 0.0;
+    double substrate_max_K   = 0.0;
+    double substrate_final_K = 0.0;
+    double wall_s            = 0.0;
+};
+
+struct SweepOptions {
+    double      span_s   = 0.0;            // simulated time per member
+    std::string jobs_dir = "active_jobs";
+    int         threads  = 1;              // worker threads per rank
+    ThermalIntegratorConfig thermal;
+};
+
+// One member's harness, stepped a tick at a time. runMember() drives it
+// over the whole span; branch mode (BranchRunner) stops it part way, saves
+// it and continues copies built with other parameters. Streams go wherever
+// the caller's Logger::ScopedPrefix points; the wafer files go to subdir.
+class SweepHarness {
+public:
+    SweepHarness(const SweepMemberParams& p, const ThermalIntegratorConfig& thermal,
+                 const std::string& subdir, std::vector<SimHelpers::Job> jobs);
+    SweepHarness(const SweepHarness&) = delete;
+    SweepHarness& operator=(const SweepHarness&) = delete;
+
+    void initialize();
+    void step(int i);      // tick i (t = i * dt) with the member's demands
+    void finish();         // closes the active job, shuts the engine down
+
+    // Engine, subsystems, active job and running totals ("harness." keys).
+    void saveState(CheckpointWriter& ckpt) const;
+    void loadState(const CheckpointReader& ckpt);
+
+    // Energy and temperature fields of the member's result.
+    const SweepMemberResult& totals() const { return r_; }
+
+private:
+    double dt_;
+    std::vector<SimHelpers::Job> jobs_;
+    int current_ = -1;
+    SweepMemberResult r_;
+
+    PowerBus        bus_;
+    SolarArray      solar_;
+    Battery         battery_;
+    HeaterBank      heater_;
+    EffusionCell    effCell_;
+    GrowthMonitor   growth_;
+    SubstrateHeater substrateHeater_;
+    SimulationEngine engine_;
+};
+
+class ParameterSweep {
+public:
+    // Expands a spec into members. dt defaults to defaultDt when the spec
+    // has no dt axis. Throws std::runtime_error on unknown axes, malformed
+    // values or an empty expansion.
+    static std::vector<SweepMemberParams> loadSpec(const std::string& path,
+                                                   const std::string& jobsDir,
+                                                   double defaultDt);
+
+    // Runs one member on the calling thread; its logs go to member_<index>/.
+    static SweepMemberResult runMember(int index, const SweepMemberParams& p,
+                                       const SweepOptions& opt);
+
+    // Runs every member across the ranks of comm and opt.threads threads per
+    // rank (collective). Returns all results, ordered by member, on rank 0
+    // and an empty vector elsewhere. Worker threads on ranks other than 0
+    // request work over MPI, so opt.threads > 1 needs MPI_THREAD_SERIALIZED.
+    static std::vector<SweepMemberResult> run(MPI_Comm comm,
+                                              const std::vector<SweepMemberParams>& members,
+                                              const SweepOptions& opt);
+
+    // The work distribution behind run(): indices 0..total-1 are handed out
+    // to threads threads on every rank of comm and body(k) runs each one;
+    // results come back on rank 0 ordered by member. Same MPI thread
+    // requirements as run().
+    static std::vector<SweepMemberResult> distribute(
+        MPI_Comm comm, int total, int threads,
+        const std::function<SweepMemberResult(int)>& body);
+
+    // Writes Sweep.csv (rank 0).
+    static void writeTable(const std::vector<SweepMemberParams>& members,
+                           const std::vector<SweepMemberResult>& results,
+                           double span_s);
+};
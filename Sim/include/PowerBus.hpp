@@ -3,6 +3,22 @@
 #include "Subsystem.hpp"
 #include "TickContext.hpp"
 #include "Battery.hpp"
+#include "Logger.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Request order for batched allocation: lower values are served first from
+// the bus, then from the battery within its discharge limit. Equal
+// priorities are served in posting order. The order matches the inline
+// drawPower() call order of the serial engine, so both modes grant the same.
+enum class PowerPriority : std::uint8_t {
+    Housekeeping = 0,   // spacecraft base load
+    HeaterPrimary,      // HeaterBank: the prioritized heater
+    HeaterSecondary,    // HeaterBank: the other heater
+    Instrument          // GrowthMonitor and other sensors
+};
 
 class PowerBus : public Subsystem {
 public:
@@ -11,13 +27,37 @@ public:
     void initialize() override;
     void tick(const TickContext& ctx) override;
     void shutdown() override;
+    void saveState(CheckpointWriter& ckpt) const override;
+    void loadState(const CheckpointReader& ckpt) override;
+
+    // Settlement runs once all producers and consumers have touched the bus.
+    static constexpr TickPhase kTickPhase = TickPhase::Settle;
+    TickPhase tickPhase() const override { return kTickPhase; }
 
     // Add generation during this tick
     void addPower(double watts);
 
-    // Consumer power request
+    // Consumer power request, granted immediately (inline allocation).
     double drawPower(double requested, const TickContext& ctx);
 
+    // ---- Batched allocation (request/commit) ----
+    // postRequest() records a request and returns its ticket; it is lock-free
+    // and may be called from several threads. allocate() serves every posted
+    // request once, in priority order; grant() then returns what a ticket
+    // received. Requests <= 0 W get a ticket granted 0 W. Tickets are valid
+    // until settlement (tick() / settleWithoutLog()). Throws
+    // std::runtime_error past kMaxRequests per tick or when posting after
+    // allocate().
+    static constexpr int kMaxRequests = 64;
+    int    postRequest(PowerPriority priority, double watts);
+    void   allocate(const TickContext& ctx);
+    double grant(int ticket) const;
+
+    // Settles the tick without writing a PowerBus row: surplus to the
+    // battery, then the per-tick counters are reset. Used when a span of
+    // ticks is fast-forwarded.
+    void settleWithoutLog(double dt);
+
     // Called by main to link the battery
     void setBattery(Battery* batt);
 
@@ -31,6 +71,8 @@ public:
 
 private:
     void logRow_(int tick, double time);
+    double serve_(double requested, double dt);
+    void resetTickCounters_();
 
     double available_power_{0.0};
 
@@ -42,4 +84,17 @@ private:
     double battery_discharged_this_tick_{0.0};
 
     Battery* battery_ = nullptr;
+
+    // addPower()/drawPower() may be called from concurrent Loads-phase ticks.
+    std::mutex mtx_;
+
+    LogHandle log_;
+
+    // Per-tick request buffer (batched allocation), indexed by ticket.
+    std::vector<double>       req_W_;
+    std::vector<std::uint8_t> req_priority_;
+    std::vector<double>       grant_W_;
+    std::vector<int>          order_;
+    std::atomic<int>          num_requests_{0};
+    bool                      allocated_ = false;
 };
\ No newline at end of file
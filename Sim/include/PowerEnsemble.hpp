@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Logger.hpp"
+
+// -----------------------------------------------------------------------------
+// PowerEnsemble
+//
+// Advances N independent copies of the power/thermal harness (SolarArray,
+// spacecraft base load, HeaterBank, EffusionCell, SubstrateHeater, PowerBus,
+// Battery) in lockstep. Member state is stored structure-of-arrays and each
+// tick is a handful of flat loops over members, one per SimulationEngine
+// phase step, so the per-tick update vectorizes across members (build with
+// -DSIM_NATIVE_ARCH=ON to let the compiler use AVX2/AVX-512).
+//
+// Per member, one tick performs exactly the scalar power-mode sequence:
+//
+//   solar -> base-load draw -> heater draws (effusion, substrate) -> heat
+//   application -> latch bus counters -> surplus to battery -> logs
+//
+// so a member with the default parameters reproduces the scalar --mode power
+// CSVs value for value. The substrate radiative term uses T^2*T^2 instead of
+// std::pow(T, 4); results agree with the scalar model to rounding.
+//
+// Output: one Logger stream per subsystem ("EnsembleBattery", ...) with the
+// scalar model's physical columns prefixed by a "member" column (global
+// member index). Scheduler/job columns are omitted; members run no jobs.
+// Rows are written on tick 0 and every logEvery-th tick.
+// -----------------------------------------------------------------------------
+
+// Per-member parameters. Defaults match the power-mode harness in main.cpp.
+struct EnsembleMemberParams {
+    double battery_capacity_Wh     = 6000.0;
+    double battery_max_charge_W    = 3500.0;
+    double battery_max_discharge_W = 4000.0;
+    double solar_efficiency        = 0.25;
+    double solar_base_input_W      = 30000.0;
+    double heater_max_draw_W       = 5000.0;
+    double effusion_demand_W       = 1500.0;
+    double substrate_demand_W      = 0.0;
+    double base_load_W             = 400.0;
+    bool   priority_substrate      = false;
+};
+
+class PowerEnsemble {
+public:
+    // Parses a member spec: CSV with a header naming any subset of the
+    // EnsembleMemberParams fields, one member per row; omitted columns keep
+    // their defaults. Blank lines and lines starting with '#' are skipped.
+    // Throws std::runtime_error on unknown columns or malformed values.
+    static std::vector<EnsembleMemberParams> loadSpec(const std::string& path);
+
+    // Members are numbered from firstMember in the "member" column so ranks
+    // holding disjoint slices produce globally unique ids.
+    void addMembers(const std::vector<EnsembleMemberParams>& members,
+                    std::size_t firstMember = 0);
+
+    std::size_t size() const { return n_; }
+
+    void setTickStep(double dt);
+    void setLogEvery(int every);
+    void setSolarScale(double s);   // array sunlight, like g_orbit_solar_scale
+
+    // Orbit-aware environment for the effusion cell and substrate; the
+    // power harness never calls this, matching the scalar subsystems.
+    void setOrbitThermalEnvironment(double solar_scale);
+
+    // Logger stream names get this suffix (e.g. "_r1" for per-rank files).
+    void setLogSuffix(const std::string& suffix) { suffix_ = suffix; }
+
+    // Resets member state, registers the log schemas and writes the tick-0 rows.
+    void initialize();
+    void tick();
+
+    int    tickIndex() const { return tick_count_; }
+    double time() const { return sim_time_; }
+
+    // Member state accessors (index is local, 0..size()-1).
+    double batteryChargeWh(std::size_t i) const { return charge_[i]; }
+    double effusionTempK(std::size_t i) const   { return eff_T_[i]; }
+    double substrateTempK(std::size_t i) const  { return sub_T_[i]; }
+
+private:
+    void logRows_(int tick, double time, bool initial);
+
+    std::size_t n_ = 0;
+    std::size_t first_member_ = 0;
+
+    int    tick_count_ = 0;
+    double sim_time_   = 0.0;
+    double tick_step_  = 60.0;
+    int    log_every_  = 1;
+    double solar_scale_ = 1.0;
+    std::string suffix_;
+
+    // ---- parameters (SoA) ----
+    std::vector<double> capacity_, max_charge_, max_discharge_;
+    std::vector<double> efficiency_, base_input_;
+    std::vector<double> heater_max_, eff_demand_, sub_demand_, base_load_;
+    std::vector<double> priority_sub_;  // 1.0 = substrate draws first
+
+    // ---- state ----
+    std::vector<double> charge_;
+
+    // bus per-tick counters
+    std::vector<double> available_, added_, requested_, granted_, batt_drawn_;
+    std::vector<double> base_drawn_;
+    std::vector<double> solar_out_;
+
+    // latched bus totals for the engine snapshot
+    std::vector<double> latch_remaining_, latch_requested_, latch_granted_, latch_added_;
+
+    // heater bank
+    std::vector<double> eff_req_, eff_deliv_, sub_req_, sub_deliv_;
+
+    // effusion cell
+    std::vector<double> eff_T_, eff_ploss_, eff_net_, eff_heat_in_;
+
+    // substrate
+    std::vector<double> sub_T_, sub_ploss_;
+
+    // thermal environment (shared by all members)
+    double eff_env_scale_  = 0.0;
+    double eff_ambient_K_  = 285.0;
+    double eff_solar_abs_W_ = 0.0;
+    double sub_env_scale_  = 1.0;
+    double sub_env_K_      = 300.0;
+    double sub_solar_abs_W_ = 0.0;
+
+    LogHandle battLog_, busLog_, solarLog_, heaterLog_, effLog_, subLog_, engineLog_;
+};
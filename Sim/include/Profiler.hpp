@@ -0,0 +1,107 @@
+#pragma once
+#include <mpi.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// -----------------------------------------------------------------------------
+// Profiler (--profile)
+//
+// Scoped wall-clock timing of the harness: engine phases, subsystem ticks,
+// SPARTA blocks and reloads, params.inc writes, Logger rows and the wake
+// loop's MPI calls. Each thread records complete events into its own buffer
+// (no locks, no formatting, no I/O on the hot path) and keeps running
+// totals per name; write() turns them into
+//
+//   trace_r<rank>.json   Chrome trace / Perfetto "X" events, one process per
+//                        rank, one track per thread (chrome://tracing,
+//                        ui.perfetto.dev)
+//   Profile.csv          rank 0, one row per rank x name: count, total and
+//                        self time (total minus nested scopes), mean and max,
+//                        and self time as a share of the profiled wall time;
+//                        rows named "*" sum self time per category
+//
+// in the run's log directory. While disabled a scope costs one relaxed load.
+// Trace events beyond SF_PROFILE_MAX_EVENTS per thread (default 1000000)
+// are dropped; the totals stay complete.
+//
+//   {
+//       SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::runSteps");
+//       ...
+//   }
+// -----------------------------------------------------------------------------
+
+enum class ProfileCat : std::uint8_t {
+    Engine = 0,   // SimulationEngine phases
+    Subsystem,    // Subsystem::tick
+    Sparta,       // SPARTA blocks, reloads, snapshots
+    Params,       // params.inc and hot parameter updates
+    Log,          // Logger rows
+    Mpi,          // collectives and waits
+    Loop,         // the mode's own tick loop
+    Count
+};
+
+class Profiler {
+public:
+    static Profiler& instance();
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Starts recording; the profiled wall time is measured from here.
+    void enable();
+
+    // Stable id for a scope name; the same name always gets the same id.
+    std::uint32_t intern(const std::string& name);
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Collective over comm: stops recording, writes this rank's trace and
+    // gathers every rank's totals into Profile.csv on rank 0. Call once the
+    // worker threads are idle. No-op while disabled.
+    void write(MPI_Comm comm);
+
+    // Used by ProfileScope.
+    static void begin();
+    static void end(ProfileCat cat, std::uint32_t name, std::int64_t t0_ns);
+
+private:
+    Profiler() = default;
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    static std::atomic<bool> enabled_;
+};
+
+class ProfileScope {
+public:
+    ProfileScope(ProfileCat cat, std::uint32_t name)
+        : cat_(cat), name_(name), t0_(Profiler::enabled() ? Profiler::nowNs() : -1) {
+        if (t0_ >= 0) Profiler::begin();
+    }
+    ~ProfileScope() {
+        if (t0_ >= 0) Profiler::end(cat_, name_, t0_);
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileCat    cat_;
+    std::uint32_t name_;
+    std::int64_t  t0_;
+};
+
+#define SF_PROFILE_CONCAT_(a, b) a##b
+#define SF_PROFILE_CONCAT(a, b) SF_PROFILE_CONCAT_(a, b)
+
+// Times the rest of the enclosing block under a fixed name.
+#define SF_PROFILE_SCOPE(cat, name)                                                         \
+    static const std::uint32_t SF_PROFILE_CONCAT(sf_prof_id_, __LINE__) =                   \
+        Profiler::instance().intern(name);                                                  \
+    ProfileScope SF_PROFILE_CONCAT(sf_prof_scope_, __LINE__)(                               \
+        cat, SF_PROFILE_CONCAT(sf_prof_id_, __LINE__))
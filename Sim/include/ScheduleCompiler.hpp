@@ -0,0 +1,86 @@
+#pragma once
+#include <mpi.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "helpers.hpp"
+
+// -----------------------------------------------------------------------------
+// ScheduleCompiler
+//
+// Turns a text job file (parseJobLine() rows) into a validated schedule and
+// keeps a compiled copy next to the source, <jobs file>.sfsched, so later
+// runs skip the text parse:
+//
+//   header:
+//     char     magic[8]         "SFSCHED\0"
+//     uint32   version          (kScheduleCacheVersion)
+//     uint64   source_size      bytes
+//     int64    source_mtime     filesystem clock ticks
+//     uint64   source_hash      FNV-1a of the source text
+//     uint32   rows_read        non-comment, non-blank lines
+//     uint32   rows_skipped     malformed lines dropped at compile time
+//     uint32   njobs
+//   njobs x record:
+//     int32 start_tick, int32 end_tick, float64 Fwafer_cm2s, float64 heater_W,
+//     int32 mbe_on, int32 substrate_on, int32 phase_code,
+//     float64 substrate_target_K
+//
+// A cache whose size and mtime match the source is used as is; otherwise the
+// source is hashed and the cache is still used if the hash matches (e.g. a
+// fresh checkout). Anything else - missing, truncated, other version, rows
+// that fail validateJob() - recompiles and rewrites the cache. Failing to
+// write the cache (read-only input tree) is not an error.
+//
+// broadcast() ships the whole schedule from root to every rank in one
+// MPI_Bcast, so all ranks hold identical rows. Job is trivially copyable and
+// all ranks run the same binary, so rows travel as raw bytes.
+// -----------------------------------------------------------------------------
+
+constexpr std::uint32_t kScheduleCacheVersion = 1;
+
+enum class ScheduleCacheMode {
+    Auto = 0,   // use a valid cache, (re)write a stale one
+    Off,        // always parse the text, never touch the cache
+    Rebuild     // always parse the text and rewrite the cache
+};
+
+// "auto" / "off" / "rebuild". Throws std::runtime_error otherwise.
+ScheduleCacheMode parseScheduleCacheMode(const std::string& text);
+
+struct CompiledSchedule {
+    std::vector<SimHelpers::Job> jobs;
+    bool found        = false;   // source file exists
+    bool from_cache   = false;   // rows came from the .sfsched file
+    bool cache_written = false;
+    int  rows_read    = 0;
+    int  rows_skipped = 0;
+    std::uint64_t source_hash = 0;
+};
+
+class ScheduleCompiler {
+public:
+    // Path of the compiled copy for a source file.
+    static std::string cachePath(const std::string& sourcePath);
+
+    // Loads sourcePath through the cache. A missing source gives found ==
+    // false and no rows. Malformed rows are skipped and reported through
+    // warn (when set) only when the text is actually parsed.
+    static CompiledSchedule load(const std::string& sourcePath,
+                                 ScheduleCacheMode mode,
+                                 const SimHelpers::LogFn& warn = {});
+
+    // Collective: every rank leaves with root's jobs.
+    static void broadcast(std::vector<SimHelpers::Job>& jobs, int root, MPI_Comm comm);
+
+private:
+    static CompiledSchedule compileText_(const std::string& sourcePath,
+                                         const SimHelpers::LogFn& warn);
+    static bool readCache_(const std::string& path, std::uint64_t size,
+                           std::int64_t mtime, const std::string& sourcePath,
+                           CompiledSchedule& out);
+    static bool writeCache_(const std::string& path, std::uint64_t size,
+                            std::int64_t mtime, const CompiledSchedule& s);
+};
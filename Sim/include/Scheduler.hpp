@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "helpers.hpp"   // Job, PhaseCode, DEFAULT_IDLE_SUBSTRATE_TARGET_K
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// ---------------------------------------------------------------------------
+// Runtime scheduler model
+//
+// Important semantic shift:
+// - jobs.txt start_tick now means "release / eligibility time"
+// - requested beam-on duration is derived from (end_tick - start_tick)
+// - actual prep start / actual deposition start / actual deposition end are
+//   realized at runtime by the scheduler
+//
+// State-code mapping for TrainingState.csv:
+//   0 = pending
+//   1 = queued
+//   2 = warming
+//   3 = cooling
+//   4 = thermal_prep
+//   5 = live_deposition
+//   6 = done
+//   7 = aborted
+// ---------------------------------------------------------------------------
+enum class JobRunState {
+  Pending = 0,
+  Queued = 1,
+  Warming = 2,
+  Cooling = 3,
+  ThermalPrep = 4,
+  LiveDeposition = 5,
+  Done = 6,
+  Aborted = 7
+};
+
+// Stable text label for logs and CSV output.
+const char* jobRunStateName(JobRunState s);
+
+inline double jobRunStateCode(JobRunState s) {
+  return static_cast<double>(static_cast<int>(s));
+}
+
+struct RuntimeJobState {
+  // Immutable requested plan
+  int    requested_start_tick = 0;
+  int    requested_end_tick = -1;
+
+  // Total scheduled recipe time represented by the row.
+  int    requested_phase_duration_ticks = 0;
+
+  // Beam-on deposition time owed by growth-like rows only.
+  int    requested_live_duration_ticks = 0;
+
+  double requested_flux_cm2s = 0.0;
+  double requested_heater_cap_W = 0.0;
+
+  int    requested_mbe_on = 0;
+  int    requested_substrate_on = 0;
+  SimHelpers::PhaseCode requested_phase_code = SimHelpers::PhaseCode::IDLE;
+  double requested_substrate_target_K = SimHelpers::DEFAULT_IDLE_SUBSTRATE_TARGET_K;
+
+  // Runtime execution state
+  JobRunState state = JobRunState::Pending;
+  bool released_to_queue = false;
+  bool done = false;
+  bool aborted = false;
+
+  // Latched execution semantics for growth-like phases.
+  bool has_started_live_execution = false;
+
+  // Latched when a growth job loses required hold after live execution started.
+  bool live_execution_hold_faulted = false;
+
+  // Realized timeline
+  int actual_queue_enter_tick = -1;
+  int actual_thermal_prep_start_tick = -1;
+  int actual_warmup_start_tick = -1;
+  int actual_cooldown_start_tick = -1;
+
+  // Realized start and end of the recipe phase once thermally executable.
+  int actual_phase_start_tick = -1;
+  int actual_phase_end_tick = -1;
+
+  // Realized beam-on deposition interval for growth-like rows.
+  int actual_deposition_start_tick = -1;
+  int actual_deposition_end_tick = -1;
+
+  // Total recipe phase accounting
+  int phase_ticks_completed = 0;
+  int remaining_phase_ticks = 0;
+
+  // Guaranteed beam-on accounting
+  int live_ticks_completed = 0;
+  int remaining_live_ticks = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Scheduler
+//
+// Owns the runtime job table and the event structures the leader used to
+// rebuild by scanning every row each tick:
+//
+// - a release queue (min-heap on requested_start_tick, then row index), so
+//   Pending -> Queued costs O(log n) per released job and nothing otherwise
+// - a ready queue (min-heap on row index) of released jobs that have not yet
+//   taken control; promote() hands control to the earliest one
+// - the next growth-like flux after every row, precomputed at load()
+// - a count of jobs not yet Done or Aborted
+//
+// Which job controls the thermal targets, and every per-tick phase decision,
+// stays with the caller. The class has no MPI or logging dependency, so it
+// can be driven and timed on its own.
+// ---------------------------------------------------------------------------
+class Scheduler {
+public:
+  Scheduler() = default;
+  explicit Scheduler(const std::vector<SimHelpers::Job>& jobs) { load(jobs); }
+
+  // Replaces the job table with one Pending row per schedule entry.
+  void load(const std::vector<SimHelpers::Job>& jobs);
+
+  std::size_t size() const { return jobs_.size(); }
+  RuntimeJobState&       job(std::size_t i)       { return jobs_[i]; }
+  const RuntimeJobState& job(std::size_t i) const { return jobs_[i]; }
+  const std::vector<RuntimeJobState>& jobs() const { return jobs_; }
+
+  // Moves every Pending job with requested_start_tick <= tick into the
+  // queue and stamps actual_queue_enter_tick. Returns the rows released by
+  // this call in ascending index order (valid until the next call).
+  const std::vector<int>& releaseDue(int tick);
+
+  // Tick of the next release, or INT_MAX when every job has been released.
+  int nextReleaseTick() const;
+
+  // Removes and returns the lowest-index released job that has not taken
+  // control yet, or -1 if the queue is empty. Call only when no job holds
+  // control.
+  int promote();
+  bool hasQueued() const { return !ready_.empty(); }
+
+  // Terminal transitions. Each sets done / aborted and the state; calling
+  // either on a job that is already terminal has no effect.
+  void complete(int index);
+  void abort(int index);
+
+  bool anyUnfinished() const { return unfinished_ > 0; }
+  std::size_t unfinishedCount() const { return unfinished_; }
+
+  // Next positive growth-like flux after row index (0.0 if none), O(1):
+  // the anchor beam-off pre-growth phases such as SOURCE_DEGAS and SOAK use
+  // for source thermal conditioning.
+  double nextGrowthFluxCm2s(int index) const;
+
+  // Checkpoint/restart: the runtime half of every row plus both queues,
+  // under "scheduler.". loadState() expects load() with the same schedule;
+  // the requested plan is not stored and a row-count mismatch throws.
+  void saveState(CheckpointWriter& ckpt) const;
+  void loadState(const CheckpointReader& ckpt);
+
+private:
+  using ReleaseKey = std::pair<int, int>;   // (requested_start_tick, index)
+
+  std::vector<RuntimeJobState> jobs_;
+  std::vector<ReleaseKey>      release_heap_;   // std::greater heap
+  std::vector<int>             ready_;          // std::greater heap
+  std::vector<double>          next_growth_flux_;
+  std::vector<int>             released_;
+  std::size_t                  unfinished_ = 0;
+};
@@ -21,6 +21,48 @@ public:
 
     // Set spacecraft housekeeping power draw (W)
     void setBaseLoadW(double w);
+    double baseLoadW() const { return base_load_W_; }
+
+    // Moves the tick counter and clock past n ticks that were advanced
+    // outside tick() (see FastForward.hpp). Subsystems are not ticked.
+    void skipTicks(int n);
+
+    // Checkpoint/restart: the tick clock, the base load and every
+    // subsystem's saveState() / loadState(), in registration order.
+    // loadState() expects initialize() to have run.
+    void saveState(CheckpointWriter& ckpt) const;
+    void loadState(const CheckpointReader& ckpt);
+
+    // Worker threads for the Loads phase (0 = serial, the default).
+    // Must be called before initialize().
+    void setTickThreads(int n);
+
+    // How consumers get bus power. Inline: each drawPower() is granted on
+    // the spot, in call order. Batched: the base load and every
+    // Subsystem::postPowerRequests() post requests, PowerBus::allocate()
+    // serves them once before the Loads phase, and consumers read grants,
+    // so Loads ticks never touch the bus. Both grant the same watts.
+    enum class PowerAllocation { Inline, Batched };
+    void setPowerAllocation(PowerAllocation mode) { power_alloc_ = mode; }
+    PowerAllocation powerAllocation() const { return power_alloc_; }
+
+    // SimulationEngine.csv snapshot row, shared with StaticEngine so both
+    // engines produce identical files.
+    struct Snapshot {
+        double bus_remaining_W   = 0.0;
+        double total_requested_W = 0.0;
+        double total_granted_W   = 0.0;
+        double total_generated_W = 0.0;
+        double base_drawn_W      = 0.0;
+        bool   job_failed        = false;
+    };
+    static const std::vector<std::string>& snapshotColumns();
+    // The bus totals latched by the last tick() (what its row logged).
+    Snapshot snapshot() const;
+    static void logSnapshot(LogHandle& log, int tick, double time,
+                            const Snapshot& snap,
+                            const Battery* battery,
+                            const SolarArray* solar);
 
 private:
     std::vector<Subsystem*> subsystems_;
@@ -37,6 +79,8 @@ private:
 
     bool job_failed_flag_ = false;
 
+    PowerAllocation power_alloc_ = PowerAllocation::Inline;
+
     // Spacecraft baseline power draw
     double base_load_W_  = 400.0; // commanded housekeeping draw
     double base_drawn_W_ = 0.0;   // actually granted by bus/battery this tick
@@ -47,5 +91,7 @@ private:
     double latched_total_granted_W_   = 0.0;
     double latched_total_generated_W_ = 0.0;
 
+    LogHandle log_;
+
     void logRow_(int tick, double time);
 };
@@ -12,11 +12,19 @@ public:
     void initialize() override;
     void tick(const TickContext& ctx) override;
     void shutdown() override;
+    void saveState(CheckpointWriter& ckpt) const override;
+    void loadState(const CheckpointReader& ckpt) override;
+
+    static constexpr TickPhase kTickPhase = TickPhase::Generation;
+    TickPhase tickPhase() const override { return kTickPhase; }
 
     void setPowerBus(PowerBus* bus);
 
     double getLastOutput() const;
 
+    // Electrical output (W) for a given sunlight scale, without ticking.
+    double outputFor(double solar_scale) const;
+
     // Regime getters (for logging + dataset conditioning)
     double getEfficiency() const { return efficiency_; }
     double getBaseInputW() const { return base_input_; }
@@ -26,4 +34,6 @@ private:
     double efficiency_;   // fraction of incident solar converted to electrical power
     double base_input_;   // baseline solar input at solar_scale=1 (W)
     double last_output_;  // last tick electrical output (W)
+
+    LogHandle log_;
 };
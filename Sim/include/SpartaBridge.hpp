@@ -1,23 +1,87 @@
 #pragma once
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <vector>
 #include <mpi.h>
 
+#include "SpartaDevice.hpp"
+
 class SpartaBridge {
 public:
-  // Opens SPARTA with CUDA/Kokkos enabled (1 GPU) and logs to i
-  explicit SpartaBridge(MPI_Comm comm = MPI_COMM_WORLD);
+  // Opens SPARTA with CUDA/Kokkos on the device chosen by `devices` for this
+  // rank (see SpartaDevice.hpp; the default keeps GPU 0). Collective over comm.
+  explicit SpartaBridge(MPI_Comm comm = MPI_COMM_WORLD,
+                        const SpartaDevicePolicy& devices = {});
   ~SpartaBridge();
 
   // Runs a deck from PROJECT_SOURCE_DIR/<input_subdir>
   void runDeck(const std::string& deck_basename,
                const std::string& input_subdir = "input");
 
-  // Convenience wrappers
+  // Convenience wrappers. Each call returns once SPARTA has executed the
+  // command, for the embedded instance and the external shim alike.
   void command(const char* cmd);
   void runSteps(int n);
   void clear();
 
+  // In-process value access. Only an embedded instance (ENABLE_SPARTA) can
+  // answer; the external-process shim always returns std::nullopt and
+  // inProcess() is false there.
+  //
+  // Both calls may trigger a SPARTA-side MPI reduction, so every rank must
+  // make the same sequence of extract calls.
+  bool inProcess() const;
+
+  // Global compute value: index 0 reads the scalar, index i >= 1 reads
+  // element i of the global vector (1-based, like c_ID[i] in a deck).
+  // std::nullopt if the compute does not exist.
+  std::optional<double> extractCompute(const std::string& id, int index = 0);
+
+  // Equal-style variable, evaluated now (so f_ID / c_ID references in the
+  // formula are read from the live instance). std::nullopt if undefined.
+  std::optional<double> extractVariable(const std::string& name);
+
+  // Per-surface-element data (embedded instance only; the shim has no
+  // elements and no values). SPARTA spreads explicit surface elements over
+  // the ranks; both calls cover the elements this rank owns, indexed the
+  // same way, and are local (no collective).
+  //
+  // surfGroupTriangles(): this rank's triangles in surface group `group`.
+  // Appends the owned-element index to `local` and the three corners to
+  // `corners` (9 values per triangle); returns the number found, 0 for an
+  // unknown group, 2d or implicit surfaces.
+  std::size_t surfGroupTriangles(const std::string& group, std::vector<int>& local,
+                                 std::vector<double>& corners);
+
+  // Per-surface output of a fix (e.g. fix ave/surf), read in place: value
+  // of owned element m is data[m * stride]. column 0 reads a per-surf
+  // vector, column i >= 1 column i of a per-surf array. The pointer stays
+  // valid until the next SPARTA command. std::nullopt if the fix does not
+  // exist or has no such per-surf output.
+  struct SurfValues {
+    const double* data   = nullptr;
+    std::size_t   stride = 1;
+    std::size_t   n      = 0;
+  };
+  std::optional<SurfValues> extractSurfFix(const std::string& id, int column = 0);
+
+  // True when command()/runSteps() reach a live instance: always for the
+  // embedded library; for the shim once its persistent child is running
+  // (same answer on every rank). Hot updates and restart snapshots need it.
+  bool acceptsCommands() const;
+
+  // Identifies the SPARTA build and layout behind the bridge, for caches of
+  // SPARTA state: "SPARTA <version> np <ranks>" embedded, the executable and
+  // rank count the shim launches (SPARTA_EXE, SPARTA_NP) otherwise.
+  std::string versionTag() const;
+
+  // Device assignment in effect. Embedded: this rank's device. Shim: the
+  // pool handed to the external launcher.
+  const SpartaDeviceAssignment& device() const { return device_; }
+
 private:
   void*    spa_  = nullptr;
   MPI_Comm comm_;
+  SpartaDeviceAssignment device_;
 };
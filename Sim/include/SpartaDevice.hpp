@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mpi.h>
+
+// -----------------------------------------------------------------------------
+// GPU device policy for the SPARTA Kokkos path
+//
+// Which device a SPARTA instance runs on is decided by node-local rank within
+// the SpartaBridge communicator, so each sub-communicator (one per SPARTA
+// instance) can be given its own device pool:
+//
+//   Default     legacy behaviour: CUDA_VISIBLE_DEVICES=0, Kokkos arguments
+//               taken from SPARTA_EXTRA_ARGS unchanged
+//   RoundRobin  node-local rank i -> devices[i % devices.size()]
+//               (empty devices = 0 .. gpus_per_node-1)
+//   Map         node-local rank i -> devices[i] (wraps if there are more
+//               local ranks than entries)
+//   Cpu         no GPU: CUDA_VISIBLE_DEVICES="" and the Kokkos GPU
+//               arguments are dropped
+//
+// Spec strings (--sparta-devices): "default", "rr", "rr:N" (N GPUs per node),
+// "rr:0,2,4" (device pool), "map:0,0,1,1", "cpu".
+// -----------------------------------------------------------------------------
+
+struct SpartaDevicePolicy {
+  enum class Mode { Default, RoundRobin, Map, Cpu };
+
+  Mode             mode = Mode::Default;
+  std::vector<int> devices;
+  int              gpus_per_node = 1;
+
+  // Throws std::runtime_error on a malformed spec.
+  static SpartaDevicePolicy parse(const std::string& spec);
+  std::string describe() const;
+};
+
+// Result for one rank; see resolveSpartaDevice().
+struct SpartaDeviceAssignment {
+  int         local_rank = 0;     // node-local rank within the communicator
+  int         local_size = 1;
+  int         device     = 0;     // -1 = CPU
+  std::string visible_devices;    // value for CUDA_VISIBLE_DEVICES
+  std::string kokkos_args;        // appended to the filtered extra args
+  bool        legacy     = true;  // Default mode: leave the args alone
+};
+
+// Collective over comm (node-local split).
+SpartaDeviceAssignment resolveSpartaDevice(const SpartaDevicePolicy& policy, MPI_Comm comm);
+
+// Device pool seen by an external launcher on this node: every device the
+// policy can hand out, for CUDA_VISIBLE_DEVICES plus "-k on g <count>".
+SpartaDeviceAssignment resolveSpartaDevicePool(const SpartaDevicePolicy& policy);
+
+// extra_args with the policy applied: unchanged for Default, otherwise
+// any "-k/-kokkos ..." and "-sf/-suffix kk" options are replaced by
+// a.kokkos_args.
+std::string applySpartaDeviceArgs(const std::string& extra_args,
+                                  const SpartaDeviceAssignment& a);
+
+// One line per rank of comm, gathered on rank 0 (empty elsewhere), e.g.
+// "rank 1 (node-local 1/4) -> GPU 1". Collective.
+std::string describeSpartaDeviceMap(const SpartaDeviceAssignment& a, MPI_Comm comm);
@@ -11,6 +11,16 @@ struct SpartaDiag {
     double density_m3{std::numeric_limits<double>::quiet_NaN()};
 };
 
+class CsvTailReader;
+
+// Parses one "step,time,temp_K,density_m3" row.
+std::optional<SpartaDiag> parse_sparta_diag_row(const std::string& row);
+
+// Latest row of a growing wake_diag.csv; only bytes appended since the
+// reader's previous poll are read.
+std::optional<SpartaDiag> read_sparta_diag_csv(CsvTailReader& tail);
+
+// One-shot convenience: reads the whole file.
 std::optional<SpartaDiag> read_sparta_diag_csv(const std::filesystem::path& file);
 
 // Boltzmann constant [J/K]
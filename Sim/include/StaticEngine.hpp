@@ -0,0 +1,158 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Subsystem.hpp"
+#include "SimulationEngine.hpp"
+#include "PowerBus.hpp"
+#include "Battery.hpp"
+#include "SolarArray.hpp"
+#include "Logger.hpp"
+
+// Phase a subsystem type runs in: T::kTickPhase when declared, else Loads
+// (the Subsystem::tickPhase() default).
+template <typename T, typename = void>
+struct StaticTickPhase {
+    static constexpr TickPhase value = TickPhase::Loads;
+};
+
+template <typename T>
+struct StaticTickPhase<T, std::void_t<decltype(T::kTickPhase)>> {
+    static constexpr TickPhase value = T::kTickPhase;
+};
+
+// Compile-time specialised counterpart of SimulationEngine for a fixed set of
+// subsystem types, e.g.
+//
+//   StaticEngine<SolarArray, HeaterBank, PowerBus, Battery> se(solar, heater, bus, battery);
+//
+// Each phase is unrolled over the pack and every tick() is a qualified
+// (non-virtual) call, so the compiler can inline the whole tick. Phase
+// semantics, the base-load draw, the bus latch and the SimulationEngine.csv
+// snapshot are identical to SimulationEngine::tick().
+//
+// Within a phase, subsystems run in pack order (the serial order the dynamic
+// engine uses for the same addSubsystem() order). tickAfter() is checked once
+// in initialize(): a predecessor listed later in the pack throws.
+// Always serial; use SimulationEngine for --tick-threads.
+template <typename... Ts>
+class StaticEngine {
+    static_assert(sizeof...(Ts) > 0, "StaticEngine needs at least one subsystem");
+    static_assert((std::is_base_of<Subsystem, Ts>::value && ...),
+                  "StaticEngine types must derive from Subsystem");
+
+public:
+    explicit StaticEngine(Ts&... subs) : subs_(&subs...) {}
+
+    void setTickStep(double dt) { tick_step_ = dt; }
+    void setBaseLoadW(double w) { base_load_W_ = w; }
+    void markJobFailedThisTick() { job_failed_flag_ = true; }
+
+    void initialize() {
+        (std::get<Ts*>(subs_)->Ts::initialize(), ...);
+        checkOrder_();
+
+        job_failed_flag_ = false;
+        snap_ = SimulationEngine::Snapshot{};
+
+        log_ = Logger::instance().registerSchema(
+            "SimulationEngine", SimulationEngine::snapshotColumns());
+        logRow_(0, 0.0);
+
+        tick_count_ = 1;
+        sim_time_   = tick_step_;
+    }
+
+    void tick() {
+        const TickContext ctx{ tick_count_, sim_time_, tick_step_ };
+
+        runPhase_<TickPhase::Generation>(ctx);
+
+        if constexpr (kHasBus) {
+            PowerBus* bus = std::get<PowerBus*>(subs_);
+            snap_.base_drawn_W = base_load_W_ > 0.0 ? bus->drawPower(base_load_W_, ctx) : 0.0;
+        }
+
+        runPhase_<TickPhase::Loads>(ctx);
+
+        if constexpr (kHasBus) {
+            PowerBus* bus = std::get<PowerBus*>(subs_);
+            snap_.bus_remaining_W   = bus->getAvailablePower();
+            snap_.total_requested_W = bus->getRequestedThisTickW();
+            snap_.total_granted_W   = bus->getGrantedThisTickW();
+            snap_.total_generated_W = bus->getAddedThisTickW();
+        }
+
+        runPhase_<TickPhase::Settle>(ctx);
+        runPhase_<TickPhase::Storage>(ctx);
+
+        logRow_(tick_count_, sim_time_);
+
+        job_failed_flag_ = false;
+
+        tick_count_ += 1;
+        sim_time_   += tick_step_;
+    }
+
+    void shutdown() {
+        (std::get<Ts*>(subs_)->Ts::shutdown(), ...);
+    }
+
+private:
+    template <typename T>
+    static constexpr bool kHas = (std::is_same<T, Ts>::value || ...);
+    static constexpr bool kHasBus = kHas<PowerBus>;
+
+    template <TickPhase P, typename T>
+    static void tickIf_(T* s, const TickContext& ctx) {
+        if constexpr (StaticTickPhase<T>::value == P) s->T::tick(ctx);
+    }
+
+    template <TickPhase P>
+    void runPhase_(const TickContext& ctx) {
+        (tickIf_<P>(std::get<Ts*>(subs_), ctx), ...);
+    }
+
+    void checkOrder_() const {
+        const Subsystem* subs[] = { std::get<Ts*>(subs_)... };
+        const TickPhase phases[] = { StaticTickPhase<Ts>::value... };
+        constexpr std::size_t n = sizeof...(Ts);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            for (const auto& dep : subs[i]->tickAfter()) {
+                for (std::size_t j = i + 1; j < n; ++j) {
+                    if (phases[j] == phases[i] && subs[j]->getName() == dep) {
+                        throw std::runtime_error(
+                            "StaticEngine: " + subs[i]->getName() + " must tick after " +
+                            dep + " but is listed before it");
+                    }
+                }
+            }
+        }
+    }
+
+    void logRow_(int tick, double time) {
+        const Battery*    battery = nullptr;
+        const SolarArray* solar   = nullptr;
+        if constexpr (kHas<Battery>)    battery = std::get<Battery*>(subs_);
+        if constexpr (kHas<SolarArray>) solar   = std::get<SolarArray*>(subs_);
+
+        snap_.job_failed = job_failed_flag_;
+        SimulationEngine::logSnapshot(log_, tick, time, snap_, battery, solar);
+    }
+
+    std::tuple<Ts*...> subs_;
+
+    int    tick_count_ = 0;
+    double sim_time_   = 0.0;
+    double tick_step_  = 60.0;
+
+    bool   job_failed_flag_ = false;
+    double base_load_W_     = 400.0;
+
+    SimulationEngine::Snapshot snap_;
+    LogHandle log_;
+};
@@ -7,6 +7,7 @@
 #include "Subsystem.hpp"
 #include "TickContext.hpp"
 #include "Logger.hpp"
+#include "ThermalIntegrator.hpp"
 
 /*
     SubstrateHeater models the wafer-side thermal plant for the simulator.
@@ -235,10 +236,20 @@ public:
       - negative when the environment is passively warming the substrate
 
       The substrate temperature is advanced using the lumped thermal
-      capacitance C_J_per_K_.
+      capacitance C_J_per_K_, by explicit Euler unless a Stable integrator
+      has been configured (adaptive exponential substeps for the radiative
+      term; see ThermalIntegrator.hpp).
   */
   void applyHeat(double watts, double dt_s);
 
+  /*
+      Time-stepping scheme used by applyHeat(), and the substeps it used on
+      the most recent call (logged as "substeps" under the stable
+      integrator). Set it before initialize(), which registers the schema.
+  */
+  void setThermalIntegrator(const ThermalIntegratorConfig& cfg) { integrator_.configure(cfg); }
+  int  lastThermalSubsteps() const { return integrator_.lastSubsteps(); }
+
   /*
       Backward-compatible readiness check.
 
@@ -307,6 +318,12 @@ public:
   double ambientTempK() const { return T_env_eff_K_; }
   double solarScale() const { return solar_scale_; }
   double solarAbsorbedPowerW() const { return P_solar_abs_W_; }
+
+  /*
+      Passive (unheated) equilibrium temperatures in full eclipse (lo_K) and
+      full sun (hi_K). An idle wafer settles and swings inside this band.
+  */
+  void idleBandK(double& lo_K, double& hi_K) const;
   double requestedPowerW() const { return P_requested_W_; }
   double deliveredPowerW() const { return P_delivered_W_; }
   int tempMissStreak() const { return temp_miss_streak_; }
@@ -315,7 +332,15 @@ public:
 
   void initialize() override;
   void tick(const TickContext& ctx) override;
+
+  /*
+      HeaterBank::tick() applies the delivered substrate power, so this
+      subsystem's tick must follow it inside the Loads phase.
+  */
+  std::vector<std::string> tickAfter() const override { return {"HeaterBank"}; }
   void shutdown() override;
+  void saveState(CheckpointWriter& ckpt) const override;
+  void loadState(const CheckpointReader& ckpt) override;
 
 private:
   /*
@@ -325,6 +350,13 @@ private:
   double wafer_area_m2_;
   double maxPower_W_;
 
+  /*
+      Pre-registered wide log schema (written by the leader only).
+  */
+  LogHandle log_;
+
+  ThermalIntegrator integrator_;
+
   /*
       Thermal state.
 
@@ -474,6 +506,12 @@ private:
   */
   double lossPowerW(double T_K) const;
 
+  /*
+      Unheated equilibrium for a given environment: the temperature where
+      the exchange term against T_env_K balances P_solar_W (bisection).
+  */
+  double passiveEquilibriumK(double T_env_K, double P_solar_W) const;
+
   /*
       Compute the current effective ambient temperature from solar scale.
   */
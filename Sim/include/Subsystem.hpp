@@ -1,7 +1,28 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "TickContext.hpp"
 
+class CheckpointWriter;
+class CheckpointReader;
+
+// Where a subsystem runs inside one SimulationEngine tick. Phases execute in
+// this order; subsystems sharing a phase may run concurrently unless ordered
+// by tickAfter().
+//
+//   Generation -> (engine: spacecraft base load) -> Loads
+//   -> (engine: latch bus counters) -> Settle -> Storage -> (engine: snapshot)
+//
+// With batched power allocation (SimulationEngine::setPowerAllocation) the
+// base-load step becomes: base load and every postPowerRequests() post into
+// the PowerBus, which allocates once; Loads then read their grants.
+enum class TickPhase {
+    Generation = 0,   // sources add power into the bus
+    Loads,            // consumers, thermal response, sensors
+    Settle,           // bus settlement (surplus -> battery, counter reset)
+    Storage           // storage bookkeeping after settlement
+};
+
 class Subsystem {
 public:
     explicit Subsystem(const std::string& name) : name_(name) {}
@@ -12,6 +33,22 @@ public:
     virtual void tick(const TickContext& ctx) = 0;
     virtual void shutdown() = 0;
 
+    // scheduling: phase and same-phase predecessors (by getName()).
+    // Unknown names are ignored so optional subsystems can be left out.
+    virtual TickPhase tickPhase() const { return TickPhase::Loads; }
+    virtual std::vector<std::string> tickAfter() const { return {}; }
+
+    // batched power allocation: post this tick's PowerBus requests (see
+    // PowerBus::postRequest). Called serially before the Loads phase;
+    // consumers that post read their grants in tick() instead of drawing.
+    virtual void postPowerRequests(const TickContext&) {}
+
+    // checkpoint/restart (see Checkpoint.hpp): dynamic state under keys
+    // prefixed "<name>.". loadState() runs after initialize() on resume.
+    // Stateless subsystems keep the defaults.
+    virtual void saveState(CheckpointWriter&) const {}
+    virtual void loadState(const CheckpointReader&) {}
+
     // access
     std::string getName() const { return name_; }
 
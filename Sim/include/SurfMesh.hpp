@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// SurfMesh (surfprep)
+//
+// A 3-d SPARTA surface (read_surf file) as an indexed triangle mesh, with the
+// clean-up steps the wake decks need before a run:
+//
+//   weld()            merge vertices closer than a tolerance (per-triangle
+//                     coordinate files repeat every shared corner)
+//   removeDegenerate  drop triangles with a repeated vertex or ~zero area
+//   removeDuplicates  drop triangles on the same three vertices
+//   orient()          make neighbouring triangles agree, then point each
+//                     closed component's normals out of (or into) it
+//   fillHoles()       close every boundary loop with a fan around its centroid
+//   decimate()        quadric edge collapse down to a triangle budget; a
+//                     collapse is only taken while the summed squared
+//                     distance to the original planes of the merged region
+//                     stays under max_error^2, so no original plane moves
+//                     further than max_error. Triangles touching a "fine"
+//                     region (orifice, wafer) are never collapsed.
+//
+// Both read_surf layouts are read: "Points" + "Triangles" sections (ID
+// [type] p1 p2 p3) and per-triangle coordinates (ID [type] x1 y1 z1 x2 y2 z2
+// x3 y3 z3, no Points section). write() produces either.
+//
+// Errors (unreadable file, malformed line, bad point index) throw
+// std::runtime_error.
+// -----------------------------------------------------------------------------
+
+enum class SurfFileFormat { Points, Inline };
+
+enum class SurfNormals {
+    Outward,   // closed components point out (SPARTA flow outside the body)
+    Inward,    // closed components point in (flow inside an enclosure)
+    Keep       // only make components consistent, keeping the majority
+};
+
+// Axis-aligned box or sphere whose triangles decimate() does not touch.
+struct SurfRegion {
+    bool                  sphere = true;
+    std::array<double, 3> lo{{0.0, 0.0, 0.0}};   // sphere: centre
+    std::array<double, 3> hi{{0.0, 0.0, 0.0}};   // sphere: hi[0] is the radius
+
+    bool contains(const std::array<double, 3>& p) const;
+};
+
+struct SurfEdgeStats {
+    std::size_t edges       = 0;
+    std::size_t boundary    = 0;   // used by one triangle
+    std::size_t nonmanifold = 0;   // used by more than two
+    std::size_t misoriented = 0;   // two triangles traversing it the same way
+
+    bool watertight() const { return boundary == 0 && nonmanifold == 0 && misoriented == 0; }
+};
+
+struct SurfDecimateResult {
+    std::size_t collapses    = 0;
+    std::size_t protected_tris = 0;   // triangles in fine regions
+    double      max_error    = 0.0;   // largest accepted sqrt(quadric cost)
+    bool        reached_target = false;
+};
+
+class SurfMesh {
+public:
+    using Vec3 = std::array<double, 3>;
+    using Tri  = std::array<int, 3>;
+
+    static SurfMesh read(const std::string& path);
+    void write(const std::string& path, SurfFileFormat format, const std::string& title) const;
+
+    const std::vector<Vec3>& points() const { return points_; }
+    const std::vector<Tri>&  triangles() const { return tris_; }
+    SurfFileFormat           sourceFormat() const { return source_format_; }
+
+    // Length of the bounding-box diagonal; the default tolerances scale with it.
+    double extent() const;
+    double area() const;
+    // Signed enclosed volume (divergence theorem); positive for outward
+    // normals on a closed surface.
+    double volume() const;
+    SurfEdgeStats edgeStats() const;
+    std::size_t components() const;
+
+    // Each returns how many vertices/triangles it changed. Unused points are
+    // dropped by weld() and decimate().
+    std::size_t weld(double tol);
+    std::size_t removeDegenerate(double area_tol);
+    std::size_t removeDuplicates();
+    std::size_t orient(SurfNormals mode);
+    std::size_t fillHoles();
+    SurfDecimateResult decimate(std::size_t target_tris, double max_error,
+                                const std::vector<SurfRegion>& fine);
+
+private:
+    void compact_();   // drops unreferenced points, renumbers triangles
+
+    std::vector<Vec3> points_;
+    std::vector<Tri>  tris_;
+    std::vector<int>  types_;   // read_surf type per triangle (1 if absent)
+    SurfFileFormat    source_format_ = SurfFileFormat::Points;
+};
@@ -0,0 +1,232 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// TelemetryRing
+//
+// Live per-tick state for in-situ consumers (an ML controller next to the
+// sim) through a POSIX shared-memory segment instead of polling the CSVs.
+// The sim is the single producer: each tick writes one fixed-width record
+// into a ring of power-of-two slots, and any number of readers map the
+// segment and read records in place at tick rate. A reader that falls more
+// than one ring behind loses the overwritten records (they are still in the
+// CSVs); the producer never waits for readers.
+//
+// Layout (native endian and widths, every block 64-byte aligned):
+//
+//   header (128 bytes):
+//     char     magic[8]        "SFTELEM\0", written last by the producer
+//     uint32   version         layout (kTelemetryLayoutVersion)
+//     uint32   ncols           doubles per record after tick and time
+//     uint32   slots           ring capacity, a power of two
+//     uint32   slot_bytes      stride of one slot
+//     uint64   schema_hash     FNV-1a of the column names (telemetrySchemaHash)
+//     uint64   columns_offset  ncols x char[32] names, NUL padded
+//     uint64   control_offset  control block
+//     uint64   slots_offset    first slot
+//     uint32   producer_pid
+//     uint32   closed          1 once the producer has finished
+//     ... second cache line: uint64 head, records published so far
+//
+//   control block (128 bytes): the reverse channel, see TelemetryControl
+//     uint64   seq             even when stable, odd while a reader writes
+//     uint64   applied         control generation the sim last applied
+//     int64    applied_tick
+//     uint32   mask, pad
+//     double   values[kTelemetryControlFields]
+//
+//   slot k % slots, record k:
+//     uint64   seq             2k+1 while written, 2k+2 once complete
+//     int64    tick
+//     double   time_s
+//     double   values[ncols]
+//
+// Readers check magic, version and, when they were built against one
+// schema, schema_hash; a new column changes the hash. Every slot is checked
+// seqlock-style: TelemetryReader::visit() hands out the values in place and
+// then reports whether the producer overwrote them meanwhile.
+// -----------------------------------------------------------------------------
+
+constexpr std::uint32_t kTelemetryLayoutVersion = 1;
+constexpr std::size_t   kTelemetryNameBytes     = 32;
+constexpr int           kTelemetryControlFields = 8;
+
+// FNV-1a over the column names joined by ','.
+std::uint64_t telemetrySchemaHash(const std::vector<std::string>& columns);
+
+// One control message from an external policy. Fields whose bit is set in
+// mask override what the scheduler derives from the job's recipe row for
+// the controlling job, until a later message clears the bit; mask 0 hands
+// control back to the recipe.
+struct TelemetryControl {
+    enum Field : std::uint32_t {
+        EffusionTargetK  = 1u << 0,   // effusion cell target (K)
+        SubstrateTargetK = 1u << 1,   // substrate heater target (K)
+        SubstrateControl = 1u << 2,   // substrate heater control on (0/1)
+        SourceControl    = 1u << 3,   // effusion source heating on (0/1)
+        BeamAllowed      = 1u << 4,   // beam permission (0/1); growth phases only
+    };
+
+    std::uint32_t mask = 0;
+    double effusion_target_K  = 0.0;
+    double substrate_target_K = 0.0;
+    bool   substrate_control  = false;
+    bool   source_control     = false;
+    bool   beam_allowed       = false;
+
+    bool has(Field f) const { return (mask & f) != 0; }
+
+    // "effusion_target_K=1100,substrate_control=1"; throws std::runtime_error
+    // on an unknown key or a bad number.
+    static TelemetryControl parse(const std::string& spec);
+};
+
+// Shared layout pieces; see the table above.
+namespace telemetry_detail {
+struct Header;
+struct Control;
+struct Slot;
+} // namespace telemetry_detail
+
+class TelemetryPublisher {
+public:
+    TelemetryPublisher() = default;
+    ~TelemetryPublisher();
+
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    // Creates the segment (a leading '/' is added to name if missing),
+    // replacing a stale one of the same name; readers still attached to
+    // that one see it closed. slots is rounded up to a power of two.
+    // Throws std::runtime_error on failure.
+    void open(const std::string& name, const std::vector<std::string>& columns,
+              std::size_t slots);
+
+    // Marks the segment closed and unlinks it; attached readers keep their
+    // mapping and can drain it. Called by the destructor.
+    void close();
+
+    bool isOpen() const { return hdr_ != nullptr; }
+    const std::string& name() const { return name_; }
+    std::size_t width() const { return ncols_; }
+    std::uint64_t published() const { return head_; }
+
+    // One record; values must match the column count (std::runtime_error).
+    void publish(long tick, double time, std::initializer_list<double> vals);
+    void publish(long tick, double time, const double* vals, std::size_t n);
+
+    // True when a reader posted a control message not seen before; it is
+    // copied to out and acknowledged with tick. Never blocks: a message
+    // being written right now is picked up on a later call.
+    bool pollControl(TelemetryControl& out, long tick);
+
+    // Generation of the last control message taken by pollControl (0 = none).
+    std::uint64_t controlGeneration() const { return control_seen_ / 2; }
+
+private:
+    telemetry_detail::Slot* slot_(std::uint64_t k) const;
+
+    std::string   name_;
+    void*         base_  = nullptr;
+    std::size_t   bytes_ = 0;
+    telemetry_detail::Header*  hdr_  = nullptr;
+    telemetry_detail::Control* ctl_  = nullptr;
+    unsigned char*             slots_ = nullptr;
+    std::size_t   ncols_ = 0;
+    std::size_t   slot_bytes_ = 0;
+    std::uint64_t mask_ = 0;
+    std::uint64_t head_ = 0;
+    std::uint64_t control_seen_ = 0;
+};
+
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    // Maps an existing segment, read-only if the permissions allow no more
+    // (sendControl then throws). Throws std::runtime_error if it is missing,
+    // not (yet) initialized, of another layout version, or, with a nonzero
+    // expected_hash, of another schema.
+    void open(const std::string& name, std::uint64_t expected_hash = 0);
+    void close();
+
+    std::size_t width() const { return ncols_; }
+    std::size_t slots() const { return static_cast<std::size_t>(mask_ + 1); }
+    const std::vector<std::string>& columns() const { return columns_; }
+    std::uint64_t schemaHash() const;
+    int  producerPid() const;
+    bool closed() const;
+
+    // Records published so far, and the oldest one still in the ring.
+    std::uint64_t head() const;
+    std::uint64_t oldest() const {
+        const std::uint64_t h = head();
+        return h > mask_ + 1 ? h - (mask_ + 1) : 0;
+    }
+
+    // Calls f(tick, time, const double* values) on record k in place and
+    // returns true if the record stayed intact while f ran. False means k
+    // is not published yet or was (or is being) overwritten; whatever f saw
+    // must then be discarded.
+    template <typename F>
+    bool visit(std::uint64_t k, F&& f) const;
+
+    // Posts a control message for the producer's next pollControl(). One
+    // controlling reader at a time.
+    void sendControl(const TelemetryControl& ctl);
+
+    // Generation and tick of the last control message the sim applied.
+    std::uint64_t controlApplied() const;
+    long          controlAppliedTick() const;
+
+private:
+    const telemetry_detail::Slot* slot_(std::uint64_t k) const;
+
+    void*         base_  = nullptr;
+    std::size_t   bytes_ = 0;
+    const telemetry_detail::Header* hdr_ = nullptr;
+    telemetry_detail::Control*      ctl_ = nullptr;
+    const unsigned char*            slots_ = nullptr;
+    std::size_t   ncols_ = 0;
+    std::size_t   slot_bytes_ = 0;
+    std::uint64_t mask_ = 0;
+    bool          writable_ = false;
+    std::vector<std::string> columns_;
+};
+
+namespace telemetry_detail {
+
+// Slot prefix; the ncols values follow it directly.
+struct Slot {
+    std::atomic<std::uint64_t> seq;
+    std::int64_t  tick;
+    double        time;
+
+    const double* values() const { return reinterpret_cast<const double*>(this + 1); }
+    double*       values() { return reinterpret_cast<double*>(this + 1); }
+};
+static_assert(sizeof(Slot) == 24, "slot prefix is three 8-byte words");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory sequence numbers must be lock-free");
+
+} // namespace telemetry_detail
+
+template <typename F>
+bool TelemetryReader::visit(std::uint64_t k, F&& f) const {
+    const telemetry_detail::Slot* s = slot_(k);
+    const std::uint64_t want = 2 * k + 2;
+    if (s->seq.load(std::memory_order_acquire) != want) return false;
+    f(static_cast<long>(s->tick), s->time, s->values());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s->seq.load(std::memory_order_relaxed) == want;
+}
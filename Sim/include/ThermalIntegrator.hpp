@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+
+// -----------------------------------------------------------------------------
+// ThermalIntegrator
+//
+// Time stepping for the lumped thermal nodes (EffusionCell, SubstrateHeater).
+// Both nodes follow
+//
+//   C dT/dt = P_in - h (T - T_env) - k_rad (T^4 - T_env^4)
+//
+// with P_in = heater + absorbed solar, held constant over one tick.
+//
+// Kinds:
+//
+//   Euler   explicit Euler over the whole tick. This is the historical update,
+//           kept as the default so existing runs reproduce bit for bit. It
+//           becomes inaccurate, and then oscillates, once dt approaches C/h.
+//
+//   Stable  an unconditionally stable update for large ticks:
+//           - k_rad == 0 (linear RC node): the exact exponential solution
+//               T(dt) = T_eq + (T - T_eq) exp(-h dt / C)
+//           - k_rad > 0: exponential-Euler substeps on the tangent
+//             linearization, which is exact for the linear part and never
+//             amplifies. Step doubling raises the substep count until the
+//             estimated error is within tol_K (capped at max_substeps), and
+//             the last pair is Richardson-extrapolated.
+//
+// lastSubsteps() reports the substeps used by the most recent advance(), so
+// the owning subsystem can write it to its log row.
+// -----------------------------------------------------------------------------
+
+enum class ThermalIntegratorKind {
+    Euler = 0,
+    Stable
+};
+
+// "euler" / "stable" (case sensitive). Throws std::runtime_error otherwise.
+ThermalIntegratorKind parseThermalIntegratorKind(const std::string& text);
+const char* thermalIntegratorKindName(ThermalIntegratorKind kind);
+
+struct ThermalIntegratorConfig {
+    ThermalIntegratorKind kind = ThermalIntegratorKind::Euler;
+    double tol_K        = 0.01;   // per-tick error target for radiative nodes
+    int    max_substeps = 256;
+};
+
+// Coefficients of one node over one tick.
+struct ThermalNode {
+    double C_J_per_K    = 1.0;
+    double h_W_per_K    = 0.0;   // linear exchange with T_env_K
+    double k_rad_W_K4   = 0.0;   // emissivity * sigma * area (0 = linear node)
+    double T_env_K      = 0.0;
+    double P_in_W       = 0.0;   // heater + absorbed solar
+
+    // Net power into the node at temperature T_K.
+    double netW(double T_K) const;
+};
+
+class ThermalIntegrator {
+public:
+    ThermalIntegrator() = default;
+    explicit ThermalIntegrator(const ThermalIntegratorConfig& cfg) : cfg_(cfg) {}
+
+    void configure(const ThermalIntegratorConfig& cfg) { cfg_ = cfg; }
+    const ThermalIntegratorConfig& config() const { return cfg_; }
+    ThermalIntegratorKind kind() const { return cfg_.kind; }
+
+    // Temperature after dt_s seconds starting from T_K. Never negative.
+    double advance(const ThermalNode& node, double T_K, double dt_s);
+
+    int lastSubsteps() const { return last_substeps_; }
+
+private:
+    // n exponential-Euler substeps over dt_s.
+    static double expEulerSteps(const ThermalNode& node, double T_K, double dt_s, int n);
+
+    ThermalIntegratorConfig cfg_;
+    int last_substeps_ = 1;
+};
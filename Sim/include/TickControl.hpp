@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <mpi.h>
+
+/*
+    Per-tick control-plane message for the wake loop.
+
+    Rank 0 fills one TickControl after its share of the tick and publishes it
+    with a single MPI_Ibcast; followers post the matching receive at the top
+    of the tick and only wait for it where they need the values. It replaces
+    the separate solar-scale and stop-flag broadcasts and carries the agreed
+    reload / hot-update decision, so WakeChamber::runDecided() needs no
+    reduction or barrier of its own.
+
+    Beam parameters are the values rank 0 last wrote to params.inc; the hot
+    bits say which of them the next block must push into the live instance.
+    skip_ticks > 0 means rank 0 fast-forwarded that many ticks after this
+    one (FastForward.hpp); every rank resumes the loop past them.
+*/
+struct TickControl {
+    enum Flag : std::int32_t {
+        Stop        = 1 << 0,
+        Advance     = 1 << 1,   // run a SPARTA block at this coupling point
+        Reconcile   = 1 << 2,   // pipelined: reload / hot-update check due
+        Reload      = 1 << 3,   // full deck reload before the block
+        HotFwafer   = 1 << 4,   // push Fwafer_cm2s
+        HotMbe      = 1 << 5    // push mbe_active
+    };
+
+    double       solar_scale = 1.0;
+    double       Fwafer_cm2s = 0.0;
+    double       mbe_active  = 0.0;
+    std::int32_t tick        = 0;
+    std::int32_t flags       = 0;
+    std::int32_t skip_ticks  = 0;   // ticks fast-forwarded after this one
+
+    bool has(Flag f) const { return (flags & f) != 0; }
+    void set(Flag f, bool on = true) { flags = on ? (flags | f) : (flags & ~f); }
+};
+static_assert(std::is_trivially_copyable<TickControl>::value,
+              "TickControl is broadcast as raw bytes");
+
+// Starts the broadcast of ctl from root. ctl must stay untouched (root) or
+// unread (followers) until the request completes.
+inline MPI_Request postTickControl(TickControl& ctl, int root, MPI_Comm comm) {
+    MPI_Request req = MPI_REQUEST_NULL;
+    MPI_Ibcast(&ctl, static_cast<int>(sizeof(TickControl)), MPI_BYTE, root, comm, &req);
+    return req;
+}
@@ -1,30 +1,82 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <atomic>
+#include <exception>
 #include "Subsystem.hpp"
 #include "TickContext.hpp"
 
+// Phase/DAG executor for subsystem ticks.
+//
+// Subsystems are grouped by Subsystem::tickPhase(); within a phase,
+// Subsystem::tickAfter() edges form a DAG. runPhase() executes one phase:
+// every node runs after all of its predecessors, and independent nodes run
+// concurrently on a fixed worker pool (the calling thread helps). Idle
+// workers park on a condition variable, so nothing spins between ticks.
+//
+// With zero workers (the default) runPhase() executes the phase serially on
+// the caller in a topological order that keeps addSubsystem() order as the
+// tie-break, which reproduces the old serial engine exactly.
 class TickPhaseEngine {
 public:
     TickPhaseEngine();
     ~TickPhaseEngine();
 
+    TickPhaseEngine(const TickPhaseEngine&) = delete;
+    TickPhaseEngine& operator=(const TickPhaseEngine&) = delete;
+
     void addSubsystem(Subsystem* s);
+
+    // Number of pool threads in addition to the caller. Takes effect on start().
+    void setWorkers(int n);
+    int  workers() const { return workers_; }
+
+    // Resolves tickAfter() names into per-phase DAGs and starts the pool.
+    // Throws std::runtime_error on a dependency cycle.
+    void start();
+    void stop();
+
+    // Runs every subsystem of one phase, respecting dependencies.
+    // Rethrows the first exception raised by a subsystem tick.
+    void runPhase(TickPhase phase, const TickContext& ctx);
+
+    // Runs all phases in order (no engine work in between).
     void runTick(const TickContext& ctx);
-    void start();   // NEW
-    void stop();    // NEW
 
 private:
-    std::vector<Subsystem*> subsystems_;
+    struct Node {
+        Subsystem*       sub = nullptr;
+        std::vector<int> succ;      // indices into the same phase's nodes
+        int              indeg = 0;
+        std::uint32_t    profileId = 0;   // Profiler name of the subsystem
+    };
+    struct Phase {
+        std::vector<Node> nodes;
+        std::vector<int>  serialOrder;   // topological, addSubsystem() tie-break
+    };
+
+    void buildPhases_();
+    void workerLoop_();
+    bool runOneReady_(std::unique_lock<std::mutex>& lk);
+
+    std::vector<Subsystem*>  subsystems_;
+    std::vector<Phase>       phases_;
+    int                      workers_ = 0;
+    bool                     built_   = false;
+
+    // Pool state (guarded by mtx_)
     std::vector<std::thread> threads_;
-    std::mutex mtx_;
-    std::condition_variable cv_;
-    std::atomic<bool> running_{false};
+    std::mutex               mtx_;
+    std::condition_variable  workCv_;   // workers park here
+    std::condition_variable  doneCv_;   // caller waits here for phase completion
+    bool                     running_ = false;
 
-    TickContext currentCtx_; // store full context
-    std::atomic<int> tickIndex_{0};
-    std::atomic<int> doneCount_{0};
+    Phase*             current_ = nullptr;
+    TickContext        currentCtx_{};
+    std::vector<int>   pendingIndeg_;
+    std::vector<int>   ready_;
+    int                remaining_ = 0;
+    std::exception_ptr error_;
 };
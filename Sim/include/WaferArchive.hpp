@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Per-run wafer dose archive (.sfw)
+//
+// GrowthMonitor appends one record per job as soon as the job reaches Done
+// or Aborted, then frees the job's dose storage. Records are flushed as they
+// are written, so a crashed run keeps every job finished before the crash.
+//
+// Layout (little-endian, native widths):
+//
+//   header:
+//     char     magic[8]      "SFWAFER\0"
+//     uint32   version       (kWaferArchiveVersion)
+//     int32    gridN
+//     uint32   ncells        in-wafer cells
+//     ncells x uint32        row-major grid index (row * gridN + col)
+//
+//   record (repeated until EOF):
+//     uint32   tag           "WREC"
+//     int32    job_index
+//     uint8    status        WaferJobStatus
+//     uint8    encoding      0 = raw: ncells float64 doses (header cell order)
+//                            1 = uniform: one float64 dose for every cell
+//     float64  t_end_s
+//     payload
+//
+// A truncated trailing record is ignored by the reader.
+
+enum class WaferJobStatus : std::uint8_t {
+    Done       = 0,
+    Aborted    = 1,
+    Unfinished = 2   // still open at shutdown
+};
+
+constexpr std::uint32_t kWaferArchiveVersion = 1;
+
+struct WaferRecord {
+    int            job_index = -1;
+    WaferJobStatus status    = WaferJobStatus::Done;
+    double         t_end_s   = 0.0;
+    bool           uniform   = true;
+    std::vector<double> dose;  // 1 value if uniform, else ncells
+};
+
+// Appends job records. Not thread-safe; GrowthMonitor owns one per run.
+class WaferArchiveWriter {
+public:
+    WaferArchiveWriter() = default;
+    ~WaferArchiveWriter();
+
+    WaferArchiveWriter(const WaferArchiveWriter&) = delete;
+    WaferArchiveWriter& operator=(const WaferArchiveWriter&) = delete;
+
+    // Opens (truncates) path and writes the header.
+    // Throws std::runtime_error if the file cannot be opened.
+    void open(const std::string& path, int gridN, const std::vector<std::uint32_t>& cells);
+
+    // Reopens an existing archive for appending (no header is written);
+    // ncells must match its header. Throws std::runtime_error on failure.
+    void openAppend(const std::string& path, std::size_t ncells);
+
+    bool is_open() const { return fp_ != nullptr; }
+
+    // Current file length in bytes (records are flushed as written).
+    std::uint64_t bytes() const;
+
+    // dose is ncells values, or nullptr for a uniform map of uniform_dose.
+    void append(int job_index, WaferJobStatus status, double t_end_s,
+                double uniform_dose, const double* dose);
+
+    void close();
+
+private:
+    std::FILE*  fp_     = nullptr;
+    std::size_t ncells_ = 0;
+};
+
+// Reads a whole archive. Records are small relative to a run, so the reader
+// keeps only their file offsets and loads payloads on demand.
+class WaferArchiveReader {
+public:
+    WaferArchiveReader() = default;
+    ~WaferArchiveReader();
+
+    WaferArchiveReader(const WaferArchiveReader&) = delete;
+    WaferArchiveReader& operator=(const WaferArchiveReader&) = delete;
+
+    // Throws std::runtime_error on a missing file, bad magic or version.
+    void open(const std::string& path);
+
+    int gridN() const { return gridN_; }
+    const std::vector<std::uint32_t>& cells() const { return cells_; }
+    std::size_t recordCount() const { return offsets_.size(); }
+
+    // Loads record i (in file order). Throws on I/O failure.
+    WaferRecord record(std::size_t i);
+
+    // Writes GrowthMonitor's CSV layout
+    // (job_index,wafer_index,row,col,t_end_s,dose_arb), jobs in index order.
+    // Returns the number of data rows written.
+    std::size_t writeCsv(std::ostream& out);
+
+private:
+    std::FILE*                  fp_ = nullptr;
+    int                         gridN_ = 0;
+    std::vector<std::uint32_t>  cells_;
+    std::vector<long>           offsets_;   // start of each record's tag
+    std::vector<int>            jobs_;      // job_index per record
+};
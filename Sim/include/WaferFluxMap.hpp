@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+    Sparse element -> cell map from SPARTA wafer surface elements onto the
+    GrowthMonitor grid.
+
+    Built once from the triangles of the wafer surface group. Elements facing
+    the beam (unit normal along normal_axis with the sign of facing, within
+    60 degrees) span the wafer disc; its centre and radius come from their
+    vertices and the GrowthMonitor grid is laid over that disc the same way
+    it is over a DepositionMap (column <-> first in-plane axis, row <->
+    second). Each wafer cell then gets
+    - the area-weighted mean of the elements whose centroid falls in it, or
+    - if none does, the element whose projected triangle contains the cell
+      centre, or the nearest centroid,
+    so every cell has at least one entry and the weights of a row sum to 1.
+
+    The matrix is stored by cell (CSR). Every rank builds the same matrix
+    from the gathered elements and keeps only the entries of the elements it
+    owns, indexed by the owner's local element index, so apply() on the
+    rank's own per-element values followed by a sum over ranks gives the
+    full per-cell flux.
+*/
+class WaferFluxMap {
+public:
+    struct Element {
+        int    owner = 0;                 // rank holding the element's values
+        int    local = 0;                 // index into that rank's values
+        double p[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};  // triangle corners
+    };
+
+    struct Geometry {
+        int gridN = 32;
+        std::vector<std::uint32_t> cells; // row-major wafer cells (GrowthMonitor order)
+        int normal_axis = 0;              // wafer normal along x
+        int facing      = -1;             // front face looks towards -x
+    };
+
+    struct Stats {
+        std::size_t elements     = 0;     // front-facing elements used
+        std::size_t by_centroid  = 0;     // cells averaged from centroids
+        std::size_t by_contain   = 0;     // cells inside one element
+        std::size_t by_nearest   = 0;     // cells given the nearest element
+        double      center[2]    = {0.0, 0.0};
+        double      radius       = 0.0;
+        bool        both_faces   = false; // no element faced the beam
+    };
+
+    // Returns false (and leaves the map empty) when no element lies in the
+    // wafer plane. rank selects the entries this rank keeps.
+    bool build(const std::vector<Element>& elements, const Geometry& geom, int rank);
+
+    bool empty() const { return rows_ == 0; }
+    std::size_t cells() const { return rows_; }
+    const Stats& stats() const { return stats_; }
+
+    // out[k] = sum of w * values[local * stride] over this rank's entries of
+    // cell k (out has cells() values). Local indices at or past n count 0.
+    void apply(const double* values, std::size_t stride, std::size_t n, double* out) const;
+
+private:
+    std::size_t rows_ = 0;
+    std::vector<std::uint32_t> row_ptr_;  // rows_ + 1
+    std::vector<std::uint32_t> col_;      // owner-local element index
+    std::vector<double>        w_;
+    Stats stats_;
+};
@@ -1,14 +1,33 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <filesystem>
 #include <mpi.h>
 
+#include "CsvTailReader.hpp"
 #include "TickContext.hpp"
+#include "Logger.hpp"
+#include "SpartaDevice.hpp"
+#include "WaferFluxMap.hpp"
+#include "WakeResponseCache.hpp"
+#include "WarmStartCache.hpp"
 
-// Forward declaration to keep the header lightweight.
+// Forward declarations to keep the header lightweight.
 class SpartaBridge;
+class CheckpointWriter;
+class CheckpointReader;
 
 /*
     WakeChamber is the C++ wrapper around the SPARTA wake simulation.
@@ -41,6 +60,18 @@ public:
     */
     void init(const std::string& deck_basename, const std::string& input_subdir);
 
+    /*
+        GPU device policy for the SPARTA instance (see SpartaDevice.hpp).
+        Set before init(); each WakeChamber communicator resolves it by its
+        own node-local ranks, so instances on different sub-communicators can
+        be given disjoint device pools.
+
+        deviceMap() is the mapping chosen at init(), one line per rank
+        (rank 0 only; empty elsewhere).
+    */
+    void setDevicePolicy(SpartaDevicePolicy policy) { device_policy_ = std::move(policy); }
+    const std::string& deviceMap() const { return device_map_; }
+
     /*
         Advance one outer wake tick.
 
@@ -62,6 +93,73 @@ public:
     */
     void markDirtyReload();
 
+    /*
+        Declare deck variables that can change on the live SPARTA instance.
+
+        names:
+            Equal-style deck variables (for example Fwafer_cm2s, mbe_active)
+
+        update_include:
+            Deck fragment, relative to the input directory, that recomputes
+            everything derived from those variables (dependent variables,
+            mixture densities). It is run with "include" after the new values
+            are set, and the next run command re-initializes the fixes that
+            use them, so particles and the developed flow field are kept.
+
+        Hot updates need an instance that accepts commands: embedded SPARTA
+        (ENABLE_SPARTA) or the shim's persistent child. Without one every
+        update falls back to a full reload.
+    */
+    void setHotParameters(std::vector<std::string> names, std::string update_include);
+
+    /*
+        Report new values for deck variables whose params.inc has already
+        been rewritten.
+
+        Declared hot parameters are queued and pushed into the live instance
+        by the next runIfDirtyOrAdvanceCollective() (or runDecided()). Any other name, or no
+        live instance, marks a full reload instead.
+    */
+    void updateParameters(const std::vector<std::pair<std::string, double>>& values);
+
+    /*
+        Enable restart-snapshot reloads.
+
+        After the first block of steps following init(), all ranks write a
+        SPARTA restart file to snapshot_path (relative to the input directory).
+        Later full reloads then clear and run resume_deck instead of the
+        original deck; resume_deck is expected to include params.inc,
+        read_restart ${wake_snapshot} and re-issue what restart files do not
+        store (fixes, computes, collision models). The grid and surfaces are
+        not rebuilt.
+
+        Needs an instance that accepts commands (embedded SPARTA or the
+        shim's persistent child); otherwise no snapshot is written and
+        reloads keep re-running the full deck.
+    */
+    void enableRestartSnapshot(std::string resume_deck, std::string snapshot_path);
+
+    /*
+        Persistent warm-start cache (see WarmStartCache). Call before init().
+
+        init() looks the deck up under dir; on a hit SPARTA is built from the
+        cached restart file with the resume deck (so enableRestartSnapshot()
+        must be on) instead of starting from an empty domain. On a miss the
+        deck runs as usual and, once the run has advanced `steps` steps with
+        no reload or hot update in between, all ranks write the restart file
+        that becomes the entry. Needs an instance that accepts commands;
+        otherwise nothing is stored.
+    */
+    struct WarmStart {
+        std::string dir;
+        long        steps = 1000;
+    };
+    void enableWarmStart(WarmStart ws);
+    const WarmStartCache* warmStartCache() const { return warm_cache_.get(); }
+    bool warmStarted() const { return warm_started_; }
+    // Rank 0: key, hit or miss and cache size, for the startup log.
+    const std::string& warmStartSummary() const { return warm_summary_; }
+
     /*
         Legacy local reload-or-advance method.
 
@@ -74,12 +172,172 @@ public:
         MPI-safe reload-or-advance method.
 
         If any rank reports that a reload is needed, all ranks reload together.
-        Otherwise, all ranks simply advance together.
+        Otherwise queued hot updates (rank 0's values) are applied on all
+        ranks, then all ranks advance together.
 
         This is the method that should be used in multi-rank SPARTA runs.
     */
     bool runIfDirtyOrAdvanceCollective(int n);
 
+    /*
+        Reload-or-advance on a decision every rank already holds, e.g. rank
+        0's pending state received in a TickControl message. reload and hot
+        (one value per hotNames() entry, NaN = unchanged) must be identical
+        on all ranks; no reduction, barrier or broadcast is issued here.
+    */
+    bool runDecided(int n, bool reload, const std::vector<double>& hot);
+
+    /*
+        Move this rank's queued reload / hot values out (and reset them), for
+        a caller that distributes the decision itself.
+    */
+    void takePending(bool& reload, std::vector<double>& hot) { takePending_(reload, hot); }
+    const std::vector<std::string>& hotNames() const { return hot_names_; }
+
+    /*
+        Pipelined coupling (opt-in).
+
+        startPipeline() moves SPARTA advancement onto a worker thread on every
+        rank, so SPARTA runs block k while the leader computes the next ticks
+        from block k-1 diagnostics. Up to lag_blocks blocks may be in flight;
+        advancePipelined() only blocks the caller when that limit is reached.
+
+        Requirements:
+        - MPI initialized with MPI_THREAD_MULTIPLE
+        - the WakeChamber communicator must not be MPI_COMM_WORLD (pass a
+          dup), since the worker's SPARTA collectives run concurrently with
+          the caller's own MPI calls
+
+        Must be called collectively after init().
+    */
+    void startPipeline(int lag_blocks);
+    bool pipelined() const { return worker_.joinable(); }
+
+    /*
+        True if this rank has a reload or hot update queued. The leader
+        broadcasts this as the reconcile flag for advancePipelined().
+    */
+    bool paramsPending() const;
+
+    /*
+        Queue one SPARTA block (all ranks, same order, same arguments).
+
+        reconcile = true runs the full runIfDirtyOrAdvanceCollective() logic
+        (reload / hot-update decision) before the block; false just advances,
+        with no collective in WakeChamber itself.
+    */
+    void advancePipelined(int n, bool reconcile);
+
+    /*
+        Drain queued blocks and join the worker (collective).
+    */
+    void stopPipeline();
+
+    struct PipelineStats {
+        long   blocks{0};
+        double sparta_s{0.0};       // worker time spent advancing SPARTA
+        double leader_wait_s{0.0};  // caller time blocked on the lag limit
+        // Fraction of SPARTA time hidden behind caller work:
+        // 1 - leader_wait_s / sparta_s.
+        double overlap() const {
+            if (sparta_s <= 0.0) return 0.0;
+            const double f = 1.0 - leader_wait_s / sparta_s;
+            return f < 0.0 ? 0.0 : (f > 1.0 ? 1.0 : f);
+        }
+    };
+    PipelineStats pipelineStats() const;
+
+    /*
+        Adaptive coupling cadence (opt-in).
+
+        tick() feeds the probes seen after each block (temperature, density,
+        derived pressure) into a window of the last `window` blocks. The wake
+        is steady once every probe's spread (max - min) over a full window is
+        within rel_tol of its mean. While steady, coupling points are let pass
+        without advancing SPARTA: the stride doubles after each steady block,
+        up to one advance every max_stride coupling points. A pending reload
+        or parameter change returns to dense coupling and restarts the window.
+
+        shouldAdvance() is the leader's decision for one coupling point; the
+        caller broadcasts it so all ranks skip or advance together. With the
+        adaptive cadence on, every decision is written to <label>Adaptive.
+    */
+    struct AdaptiveCadence {
+        double rel_tol{0.01};
+        int    window{4};
+        int    max_stride{8};
+    };
+    void enableAdaptiveCadence(AdaptiveCadence cfg);
+
+    // Steady-state test alone (rel_tol, window), for the response cache
+    // without adaptive skipping; enableAdaptiveCadence() sets it too.
+    void setSteadyCriterion(double rel_tol, int window);
+    bool adaptiveCadence() const { return adaptive_on_; }
+    bool shouldAdvance(const TickContext& ctx, int n);
+
+    struct AdaptiveStats {
+        long   advanced{0};
+        long   skipped{0};          // includes blocks served from the response cache
+        long   skipped_steps{0};
+        double saved_s_est{0.0};    // skipped_steps x measured seconds per step
+    };
+    AdaptiveStats adaptiveStats() const;
+
+    /*
+        Wake-response cache (opt-in, see WakeResponseCache).
+
+        The key is the latest value of each cache key variable, from
+        initial_key (the values the deck was loaded with) and then
+        updateParameters(); until all of them are known nothing is looked up
+        or stored. At each coupling point after a key change the
+        leader looks the key up: on a hit (or interpolation) tick() logs the
+        cached temperature and density and SPARTA is not advanced until the
+        key changes again. On a miss SPARTA runs as usual, and once the
+        probes are steady (same test and window as the adaptive cadence) the
+        window mean is stored for later runs. Lookups and stores are written
+        to <label>Cache.
+
+        Must be enabled on every rank (the advance decision is broadcast);
+        only rank 0 reads or writes the cache file.
+    */
+    void enableResponseCache(std::unique_ptr<WakeResponseCache> cache,
+                             const std::vector<std::pair<std::string, double>>& initial_key = {});
+    const WakeResponseCache* responseCache() const { return cache_.get(); }
+
+    // True when shouldAdvance() can skip blocks (adaptive cadence or cache).
+    bool gatesAdvance() const { return adaptive_on_ || cache_ != nullptr; }
+
+    /*
+        Wafer flux coupling (embedded SPARTA only).
+
+        After every block each rank reads its part of the per-element flux
+        of the wafer surface group straight from the live instance (fix
+        ave/surf `fix`, no files), maps it onto the GrowthMonitor grid with
+        a WaferFluxMap built here once, and the per-cell sums are reduced
+        onto rank 0. takeWaferFlux() then hands the leader the latest map,
+        e.g. for GrowthMonitor::updateFluxProfile().
+
+        Collective, after init() and before startPipeline(). Returns false,
+        and the coupling stays off, when no instance can be queried (shim),
+        the group has no triangles in the wafer plane, or the fix does not
+        exist; waferFluxSummary() (rank 0) says which.
+    */
+    struct WaferFlux {
+        std::string group = "waferGrp";
+        std::string fix   = "waferFluxAve";
+        int         column = 0;        // 0 = per-surf vector, i = array column i
+        WaferFluxMap::Geometry grid;   // GrowthMonitor gridN() / waferCells()
+    };
+    bool enableWaferFlux(WaferFlux cfg);
+    const std::string& waferFluxSummary() const { return wafer_flux_summary_; }
+
+    /*
+        Leader: copy the latest block's flux per wafer cell (cfg.grid.cells
+        order) into out and return true, once per new block. out keeps its
+        storage between calls.
+    */
+    bool takeWaferFlux(std::vector<double>& out);
+
     /*
         Shut down the wake chamber and release the SpartaBridge.
     */
@@ -97,13 +355,60 @@ public:
     */
     void setParameter(const std::string& name, double value);
 
+    /*
+        Names of the SPARTA equal-style variables that tick() reads when SPARTA
+        is embedded (ENABLE_SPARTA). The defaults match in.wake_harness; a
+        variable the deck does not define is logged as NaN (temperature,
+        density) or 0 (shield counters).
+    */
+    struct Probes {
+        std::string temp_K        = "wake_temp_K";
+        std::string density_m3    = "wake_nrho_m3";
+        std::string shield_hits   = "shield_hits";
+        std::string shield_reemit = "shield_reemit";
+    };
+    void setProbes(Probes probes) { probes_ = std::move(probes); }
+
     /*
         Per-engine-tick logging hook.
 
         This reads SPARTA diagnostics and writes a wide logging row for the current tick.
+        With an embedded SPARTA the probes are read from the live instance; with
+        the external-process shim they come from the deck's CSV output.
     */
     void tick(const TickContext& ctx);
 
+    /*
+        The probe values of the last tick() row (leader), for the live
+        telemetry ring: NaN temperature/density until SPARTA has reported.
+    */
+    struct ProbeValues {
+        double temp_K{std::numeric_limits<double>::quiet_NaN()};
+        double density_m3{std::numeric_limits<double>::quiet_NaN()};
+        double n_ratio{0.0};
+        double pressure_Pa{0.0};
+        double shield_hits{0.0};
+        double shield_reemit{0.0};
+    };
+    const ProbeValues& lastProbes() const { return last_probes_; }
+
+    /*
+        Harness checkpoint/restart (--checkpoint-every, --resume).
+
+        writeCheckpoint() is collective: when the instance accepts commands,
+        all ranks issue write_restart to restart_path (absolute), and the
+        wake's counters, adaptive window and cache state are stored under
+        "wake." in ckpt. Returns true if the restart file was requested.
+
+        resumeFromCheckpoint() is collective too, and runs after init(). It
+        restores the stored state and, when restart_path exists and a resume
+        deck is enabled (see enableRestartSnapshot()), clears the instance and
+        rebuilds it from the restart file with that deck. Otherwise the flow
+        continues from the freshly loaded deck and false is returned.
+    */
+    bool writeCheckpoint(CheckpointWriter& ckpt, const std::string& restart_path);
+    bool resumeFromCheckpoint(const CheckpointReader& ckpt, const std::string& restart_path);
+
 private:
     /*
         Log wake lifecycle and reload events.
@@ -114,25 +419,224 @@ private:
                    double ran_steps,
                    double cum_steps,
                    double reload,
-                   double mark_reload);
+                   double mark_reload,
+                   double hot_update = 0.0,
+                   double reload_ms = 0.0,
+                   double restore_source = 0.0,
+                   double snapshot_written = 0.0);
+
+    /*
+        Clear and rebuild the SPARTA state, from the snapshot when one exists.
+        Must be issued on all ranks.
+    */
+    void reload_();
+
+    /*
+        Write the restart snapshot once, after the first block of steps.
+    */
+    void maybeWriteSnapshot_();
+
+    /*
+        Collective: build the warm-start key and look it up (rank 0), then
+        broadcast the decision. True on a hit.
+    */
+    bool warmLookup_();
+
+    /*
+        Write the warm-start entry once the warm-up is complete.
+    */
+    void maybeStoreWarmStart_();
+
+    /*
+        Drop a pending warm-start store: the state no longer follows from
+        the deck and the starting parameters alone.
+    */
+    void abandonWarmStart_();
+
+    /*
+        Collective: broadcast rank 0's queued hot values and send them to SPARTA.
+    */
+    void applyHotUpdates_(std::vector<double>& hot);
+
+    /*
+        Send hot values (identical on all ranks) to SPARTA.
+    */
+    void sendHotUpdates_(const std::vector<double>& hot);
+
+    /*
+        Collective reload / hot-update decision plus one block, on the given
+        pending state (taken from dirtyReload_ / hot_pending_ by the caller).
+    */
+    bool advanceCollective_(int n, bool dirty, std::vector<double>& hot);
+
+    /*
+        Move this rank's pending reload / hot values out and reset them.
+    */
+    void takePending_(bool& dirty, std::vector<double>& hot);
+
+    /*
+        Read the probe variables from the live instance (all ranks, after
+        every block) into sample_.
+    */
+    void sampleProbes_();
+
+    /*
+        Map this rank's wafer elements and reduce the cell sums onto rank 0
+        (all ranks, after every block, when the wafer flux is enabled).
+    */
+    void sampleWaferFlux_();
+
+    void pipelineWorker_();
+
+    /*
+        Largest relative probe spread over the adaptive window, or +inf while
+        the window is not full.
+    */
+    double adaptiveSpread_() const;
+
+    /*
+        Leader: look the current key up after a change (true = serve it), or
+        store the steady window once for a key that missed.
+    */
+    bool cacheServe_(const TickContext& ctx);
+    void cacheStore_(const TickContext& ctx, double window_steps);
+    void logCache_(const TickContext& ctx, double result);
+
+    /*
+        Shim fallback: last rows of wake_diag.csv and shield_collide.csv.
+    */
+    void readDiagFiles_(double& temp_K, double& density_m3,
+                        double& shield_hits, double& reemit_total);
 
 private:
     MPI_Comm comm_;
     std::string label_;
 
     std::unique_ptr<SpartaBridge> sp_{};
+    SpartaDevicePolicy device_policy_;
+    std::string device_map_;
 
     bool initialized_{false};
     bool dirtyReload_{false};
 
-    int cum_steps_{0};
-    int last_run_steps_{0};
+    // Atomic: advanced on the pipeline worker, read by tick()/event rows.
+    std::atomic<int> cum_steps_{0};
+    std::atomic<int> last_run_steps_{0};
     long long event_id_{0};
 
     std::string deck_;
     std::string input_subdir_;
 
-    // SPARTA diagnostic CSV written by the deck every block of steps.
-    std::filesystem::path diag_path_ =
-        std::filesystem::path("data") / "tmp" / "wake_diag.csv";
+    // Per-instance so several chambers (farm groups) can share a process.
+    int    last_logged_tick_{-1};         // tick() logs once per outer tick
+    ProbeValues last_probes_;
+    double n_inf_{0.0};                   // first valid density, ratio reference
+    int    block_steps_{1000};            // remembered step() block size
+    std::map<std::string, double> param_state_;  // setParameter() values, rewritten whole
+
+    // Pre-registered rows: per-tick diagnostics and <label>Events.
+    LogHandle tickLog_;
+    LogHandle eventLog_;
+
+    Probes probes_;
+
+    // Hot-updatable deck variables; NaN in hot_pending_ means "unchanged".
+    std::vector<std::string> hot_names_;
+    std::vector<double> hot_pending_;
+    std::vector<double> hot_scratch_;             // runDecided()'s dropped queue, kept for its capacity
+    std::string hot_include_;
+
+    // Restart-snapshot reloads (empty resume_deck_ = disabled).
+    std::string resume_deck_;
+    std::string snapshot_path_;
+    bool snapshot_ready_{false};
+    std::atomic<int> reload_count_{0};
+
+    // Warm-start cache (null = disabled). warm_key_ / warm_token_ are rank
+    // 0's, broadcast so every rank writes the same restart file name.
+    std::unique_ptr<WarmStartCache> warm_cache_;
+    long          warm_steps_{1000};
+    std::uint64_t warm_key_{0};
+    long          warm_token_{0};
+    bool          warm_started_{false};
+    bool          warm_pending_{false};
+    std::string   warm_summary_;
+    std::string   warm_desc_;
+
+    // Latest probe values, sampled on all ranks after each block; tick()
+    // (leader only) logs them without touching SPARTA.
+    struct ProbeSample {
+        bool   valid{false};
+        double temp_K{std::numeric_limits<double>::quiet_NaN()};
+        double density_m3{std::numeric_limits<double>::quiet_NaN()};
+        double shield_hits{0.0};
+        double shield_reemit{0.0};
+    };
+    mutable std::mutex sample_mtx_;
+    ProbeSample sample_;
+
+    // Wafer flux coupling: map, per-block rank partials and the reduced
+    // map (rank 0, guarded by sample_mtx_), allocated by enableWaferFlux().
+    WaferFlux wafer_flux_cfg_;
+    WaferFluxMap wafer_flux_map_;
+    bool wafer_flux_on_{false};
+    std::vector<double> wafer_flux_partial_;
+    std::vector<double> wafer_flux_sum_;
+    std::vector<double> wafer_flux_sample_;
+    std::uint64_t wafer_flux_seq_{0};
+    std::uint64_t wafer_flux_taken_{0};
+    std::string wafer_flux_summary_;
+
+    // Event rows can come from the caller and the pipeline worker.
+    std::mutex event_mtx_;
+
+    // Pipelined coupling state.
+    struct PipelineJob {
+        int n{0};
+        bool reconcile{false};
+        bool dirty{false};
+        std::vector<double> hot;
+    };
+    std::thread worker_;
+    mutable std::mutex pipe_mtx_;
+    std::condition_variable pipe_cv_;
+    std::deque<PipelineJob> pipe_queue_;
+    int pipe_inflight_{0};
+    int pipe_lag_{1};
+    bool pipe_stop_{false};
+    std::exception_ptr pipe_error_;
+    PipelineStats pipe_stats_;
+    LogHandle pipeLog_;
+
+    // Wall time of completed blocks, for the adaptive saved-time estimate.
+    double timed_block_s_{0.0};
+    long   timed_steps_{0};
+
+    // Adaptive cadence (leader-side state).
+    bool adaptive_on_{false};
+    AdaptiveCadence adaptive_cfg_;
+    std::deque<std::vector<double>> adaptive_hist_;
+    int adaptive_stride_{1};
+    int adaptive_since_{0};
+    AdaptiveStats adaptive_stats_;
+    LogHandle adaptiveLog_;
+
+    // Wake-response cache (leader-side state).
+    std::unique_ptr<WakeResponseCache> cache_;
+    std::vector<double> cache_key_;         // NaN = not reported yet
+    bool cache_key_changed_{false};
+    bool cache_serving_{false};
+    bool cache_stored_{false};              // current key already stored
+    double cache_key_steps_{0.0};           // cum_steps_ at the key change
+    WakeResponseCache::Response cache_served_;
+    LogHandle cacheLog_;
+
+    // SPARTA diagnostic CSVs appended by the deck every block of steps
+    // (shim builds only); paths are set by init().
+    CsvTailReader diag_tail_{std::filesystem::path("data") / "tmp" / "wake_diag.csv"};
+    CsvTailReader shield_tail_;
+
+    // Last valid CSV readings, reused while the file lags behind the run.
+    double file_temp_K_{0.0};
+    double file_density_m3_{0.0};
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/*
+    Persistent cache of converged wake responses.
+
+    Each entry maps a parameter key (the values of the configured deck
+    variables, e.g. Fwafer_cm2s and mbe_active) plus a hash of the deck files
+    to the quasi-steady WakeChamber diagnostics reached for it. Entries are
+    appended to a CSV file as they are stored, so later runs of the same
+    deck start with every point an earlier run converged:
+
+        deck_hash,<key names...>,temp_K,density_m3,cum_steps
+
+    Rows written for another deck hash stay in the file but are stale: they
+    are never served, and a lookup whose key only matches stale rows is
+    counted in Stats::stale. When the same key is stored twice, the last row
+    wins.
+
+    With interp_rel > 0, a key with no exact match is linearly interpolated
+    along the first key variable between the nearest stored neighbours that
+    agree on every other key variable, provided they are within interp_rel
+    of each other (relative to the larger magnitude).
+
+    Not thread-safe; WakeChamber uses it from the leader only.
+*/
+class WakeResponseCache {
+public:
+    struct Response {
+        double temp_K{0.0};
+        double density_m3{0.0};
+        double cum_steps{0.0};  // SPARTA steps run when the point converged
+    };
+
+    enum class Lookup { Miss = 0, Hit = 1, Interpolated = 2 };
+
+    struct Stats {
+        long hits{0};
+        long interpolated{0};
+        long misses{0};
+        long stale{0};          // misses that matched rows of another deck
+        long stored{0};
+        long loaded{0};         // current-deck rows read from the file
+        long loaded_stale{0};   // other-deck rows read from the file
+    };
+
+    WakeResponseCache(std::string path, std::vector<std::string> key_names,
+                      std::uint64_t deck_hash, double interp_rel = 0.0);
+
+    // Reads the file if it exists. A file whose header names other key
+    // variables is ignored (the cache starts empty and the first store()
+    // rewrites it).
+    void load();
+
+    // key holds one value per key name, in order.
+    Lookup lookup(const std::vector<double>& key, Response& out);
+    bool contains(const std::vector<double>& key) const;
+
+    // Adds or replaces the entry and appends it to the file.
+    void store(const std::vector<double>& key, const Response& r);
+
+    const std::vector<std::string>& keyNames() const { return key_names_; }
+    std::uint64_t deckHash() const { return deck_hash_; }
+    const Stats& stats() const { return stats_; }
+
+    // FNV-1a over the contents of the given files, in order. A missing file
+    // contributes only its name, so creating it later changes the hash.
+    static std::uint64_t hashFiles(const std::vector<std::string>& paths);
+
+private:
+    struct Entry {
+        std::uint64_t deck_hash{0};
+        std::vector<double> key;
+        Response r;
+    };
+
+    long find_(const std::vector<double>& key, std::uint64_t hash) const;
+    void writeHeader_(std::ostream& out) const;
+    void writeRow_(std::ostream& out, const Entry& e) const;
+
+    std::string path_;
+    std::vector<std::string> key_names_;
+    std::uint64_t deck_hash_{0};
+    double interp_rel_{0.0};
+    bool header_ok_{false};     // file exists with a matching header
+
+    std::vector<Entry> entries_;
+    Stats stats_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+    Persistent cache of warmed-up SPARTA flow states.
+
+    The wake decks start from an empty domain; the flow only develops over
+    the first blocks the harness runs, and every run with the same deck and
+    starting parameters repeats those blocks. An entry is the SPARTA restart
+    file written once a run has advanced `steps` steps without a reload or a
+    parameter change, stored as
+
+        <dir>/warm_<key>.restart   restart file (particles, grid, surfaces)
+        <dir>/warm_<key>.txt       what the key was built from
+
+    The key is an FNV-1a hash over
+    - the deck and every file it reads, following include lines (which
+      brings in params.inc, so the starting parameters are covered) plus
+      the surface, species, collision and reaction files, see deckFiles();
+    - the resume deck entries are restored with;
+    - the SPARTA build and rank count (SpartaBridge::versionTag());
+    - the harness rank count and the warm-up length in steps.
+    Anything that changes the warmed state changes the key, so entries are
+    never stale, only unused; nothing is evicted.
+
+    Entries are written under a temporary name and renamed into place, so
+    runs sharing a directory never read half a restart file.
+
+    Not thread-safe; WakeChamber uses it from rank 0 only.
+*/
+class WarmStartCache {
+public:
+    struct Stats {
+        long          entries{0};       // restart files in the directory at scan()
+        std::uint64_t bytes{0};
+        long          hits{0};
+        long          misses{0};
+        long          stored{0};
+        long          abandoned{0};     // warm-ups cut short by a reload or parameter change
+    };
+
+    // dir is made absolute against the current directory. Throws
+    // std::runtime_error if it is empty.
+    explicit WarmStartCache(std::string dir);
+
+    // deck and, recursively, the files it includes and reads, as written in
+    // the decks (relative to input_dir), in first-use order without repeats.
+    // Paths that use deck variables (${...}) cannot be resolved and are
+    // skipped.
+    static std::vector<std::string> deckFiles(const std::string& input_dir,
+                                              const std::string& deck);
+
+    // Hashes each file's name and contents (read from input_dir, so mirrored
+    // input directories give the same key), then the other fields.
+    static std::uint64_t makeKey(const std::string& input_dir,
+                                 const std::vector<std::string>& files,
+                                 const std::string& sparta_tag, int ranks, long steps);
+
+    // Counts the entries and their size on disk.
+    void scan();
+
+    // Counts a hit or a miss. True if the entry's restart file exists.
+    bool lookup(std::uint64_t key);
+
+    // token makes the temporary name unique per writer (e.g. rank 0's pid);
+    // every SPARTA rank must be given the same name.
+    std::string entryPath(std::uint64_t key) const;
+    std::string tempPath(std::uint64_t key, long token) const;
+
+    // Moves tempPath(key, token) into place and writes the description next
+    // to it. False (and no entry) if SPARTA did not write the temporary file.
+    bool commit(std::uint64_t key, long token, const std::string& description);
+    void abandon() { ++stats_.abandoned; }
+
+    const std::string& dir() const { return dir_; }
+    const Stats& stats() const { return stats_; }
+
+    static std::string keyHex(std::uint64_t key);
+
+private:
+    std::string dir_;
+    Stats stats_;
+};
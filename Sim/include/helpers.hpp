@@ -28,6 +28,144 @@ struct Args {
 
   int    nticks = 500;
   double dt     = 60.0;
+
+  // Worker threads for concurrent subsystem ticks (0 = serial engine).
+  int tickThreads = 0;
+
+  // PowerBus allocation: inline|batched (see SimulationEngine.hpp).
+  std::string powerAlloc = "inline";
+
+  // Power-mode tick engine: "dynamic" (SimulationEngine) or "static"
+  // (StaticEngine, compile-time subsystem set).
+  std::string engine = "dynamic";
+
+  // Ensemble mode: member spec CSV (see PowerEnsemble.hpp), or N copies of
+  // the default power harness when no spec is given; rows every K ticks.
+  std::string ensembleSpec;
+  int ensembleMembers  = 0;
+  int ensembleLogEvery = 1;
+
+  // Mission mode (see MissionProfile.hpp): constant loads of the fused power
+  // kernel, orbits per MissionOrbits row, and the ticks checked against
+  // SimulationEngine first (-1 = one ephemeris period, 0 = no check).
+  double missionBaseLoadW    = 400.0;
+  double missionPayloadW     = 0.0;
+  int    missionOrbitsPerRow = 1;
+  long   missionValidate     = -1;
+
+  // Deck fragment re-run on the live wake instance after Fwafer_cm2s /
+  // mbe_active change (needs a live instance); "none" forces full reloads.
+  std::string wakeHotInclude = "wake_hot.inc";
+
+  // --wake-deck generate (see DeckBuilder.hpp): coarse grid "NX,NY,NZ"
+  // (empty = the DeckBuilder default), beam-region refinement (cells per
+  // axis per coarse cell) and the probe CSV cadence in blocks (0 = off).
+  std::string deckGrid;
+  int         deckRefine   = 4;
+  int         deckCsvEvery = 0;
+
+  // Per-surf fix on waferGrp whose flux shapes the GrowthMonitor dose
+  // (embedded SPARTA only, see WakeChamber::enableWaferFlux); "none" keeps
+  // the dose uniform.
+  std::string waferFluxFix = "waferFluxAve";
+
+  // Deck used for full reloads once a restart snapshot exists (needs a
+  // live instance). "auto" = in.wake_resume with the default wake deck;
+  // "none" always replays the wake deck.
+  std::string wakeResumeDeck = "auto";
+
+  // Pipelined wake coupling: SPARTA may run this many blocks ahead of the
+  // leader's diagnostics (0 = serial coupling).
+  int wakePipelineLag = 0;
+
+  // SPARTA GPU device policy (SpartaDevicePolicy::parse spec).
+  std::string spartaDevices = "default";
+
+  // Adaptive wake cadence: relative probe tolerance for steady state
+  // (0 = fixed cadence), window in blocks, and the largest coupling stride.
+  double wakeAdaptiveTol       = 0.0;
+  int    wakeAdaptiveWindow    = 4;
+  int    wakeAdaptiveMaxStride = 8;
+
+  // Wake-response cache file ("" = off) and the largest relative Fwafer_cm2s
+  // gap bridged by interpolation (0 = exact hits only).
+  std::string wakeCache;
+  double wakeCacheInterp = 0.0;
+
+  // Warm-start cache directory ("" = off) and the warm-up length stored in
+  // it, in --sparta-block blocks.
+  std::string warmCache;
+  int         warmCacheBlocks = 5;
+
+  // Fast-forward over quiescent wake-mode intervals (see FastForward.hpp):
+  // thermal margin around the idle bands, shortest gap worth skipping and
+  // the FastForwardSamples decimation (0 = summary rows only).
+  bool   fastForward         = false;
+  double fastForwardTolK     = 5.0;
+  int    fastForwardMinTicks = 10;
+  int    fastForwardDecimate = 0;
+
+  // Live telemetry ring (see TelemetryRing.hpp): shared-memory segment name
+  // ("" = off, "auto" = sf_telemetry_<RUN_ID or pid>), ring slots, and
+  // whether the segment's control channel may override the recipe targets.
+  std::string telemetry;
+  int         telemetrySlots   = 4096;
+  bool        telemetryControl = false;
+
+  // Training-data export (see DatasetExport.hpp): directory of the .npy
+  // arrays ("" = off, "auto" = <log dir>/dataset; runs with their own log
+  // subdirectory get the same subdirectory under it).
+  std::string dataset;
+
+  // Orbit ephemeris table resolution in samples per period (0 = direct trig).
+  int orbitEphemeris = 0;
+
+  // Thermal node time stepping: "euler" or "stable" (see
+  // ThermalIntegrator.hpp), with the radiative substep tolerance and cap.
+  std::string thermalIntegrator  = "euler";
+  double      thermalTolK        = 0.01;
+  int         thermalMaxSubsteps = 256;
+
+  // Sweep mode: axis spec (see ParameterSweep.hpp), worker threads per rank
+  // and the directory job_file names are resolved in.
+  std::string sweepSpec;
+  int         sweepThreads = 1;
+  std::string sweepJobsDir = "active_jobs";
+
+  // Branch mode (see Branching.hpp): branch spec and the fork tick. Threads
+  // and the jobs directory come from the sweep options above.
+  std::string branchSpec;
+  int         branchAt = 0;
+
+  // Farm mode (see JobFarm.hpp): job files (names, globs, "*") in the
+  // sweep jobs directory and ranks per harness group.
+  std::string farmJobs      = "*";
+  int         farmGroupSize = 1;
+
+  // Scoped phase timings (see Profiler.hpp).
+  bool        profile = false;
+
+  // Per-tick heap allocation counts (see AllocCounter.hpp) and the ticks
+  // left out of the steady-state summary.
+  bool allocReport = false;
+  int  allocWarmup = 10;
+
+  // Flight recorder (see FlightRecorder.hpp): ring size and hang deadline in
+  // seconds (0 = no watchdog).
+  int         flightEvents    = 4096;
+  double      watchdogSeconds = 600.0;
+
+  // Compiled job-file cache (see ScheduleCompiler.hpp): auto|off|rebuild.
+  std::string scheduleCache = "auto";
+
+  // Wake-mode checkpoint/restart: snapshot every N ticks (0 = off) into
+  // checkpointDir (empty = <log dir>/checkpoint); --resume continues from it.
+  int         checkpointEvery = 0;
+  std::string checkpointDir;
+  bool        resume = false;
+
+  // Chattier startup logs (e.g. one line per loaded job row).
+  bool verbose = false;
 };
 
 // -----------------------------------------------------------------------------
@@ -237,6 +375,10 @@ int deriveLiveDepositionTicks(const Job& job);
 // -----------------------------------------------------------------------------
 // params.inc writer
 // -----------------------------------------------------------------------------
+// Apply the params.inc conventions in place: non-positive or non-finite flux
+// becomes FWAFFER_FLOOR_CM2S and mbe_active is snapped to 0 or 1.
+void sanitize_params_inc(double& Fwafer_cm2s, double& mbe_active);
+
 // Rewrite inputDir/params.inc with the latest SPARTA-facing parameters.
 //
 // MPI behavior:
@@ -12,6 +12,7 @@
 // - Simple Sun direction in the same frame for eclipse checks
 
 #include <cstddef>
+#include <vector>
 
 struct OrbitState {
     // Simulation time since t0 (seconds)
@@ -71,6 +72,31 @@ public:
     // - recompute simple sunlight and solar_scale
     void step();
 
+    // Advance by `steps` time steps at once. The new angle and time are
+    // computed in closed form rather than by repeated step() calls, so the
+    // result can differ from stepping by floating-point rounding only.
+    void advance(long steps);
+
+    // Orbit state `steps` time steps after the current one, in closed form.
+    // Does not modify the model.
+    OrbitState stateAfter(long steps) const;
+
+    // Ephemeris mode: precompute cos/sin over one period at
+    // samples_per_period points and serve step(), advance() and stateAfter()
+    // by linear interpolation instead of trig calls. in_sun still comes from
+    // the exact eclipse arc, so eclipse entry and exit land on the same
+    // ticks as the direct model. samples_per_period <= 0 disables it.
+    void enableEphemeris(int samples_per_period);
+    bool ephemerisEnabled() const { return !cos_table_.empty(); }
+    int  ephemerisSamples() const;
+
+    // First orbit time strictly after t_s at which the spacecraft enters
+    // (nextEclipseEntry) or leaves (nextEclipseExit) eclipse, computed
+    // analytically from the circular orbit and the current state. Returns
+    // +infinity when the orbit never changes illumination.
+    double nextEclipseEntry(double t_s) const;
+    double nextEclipseExit(double t_s) const;
+
     // Recompute all derived quantities from the current theta_rad and t_orbit_s.
     // This can be used after changing parameters externally.
     void recompute_state();
@@ -113,6 +139,22 @@ private:
     // is changed in the future.
     void update_orbit_parameters();
 
+    // Recompute the inclination / Sun direction terms and the lit arc.
+    // Called from the constructor and the setters that change them.
+    void update_eclipse_geometry();
+
+    // Position, velocity and sunlight for a given time and angle.
+    OrbitState compute_state(double t_orbit_s, double theta_rad) const;
+
+    // compute_state() served from the ephemeris table.
+    OrbitState compute_state_table(double t_orbit_s, double theta_rad) const;
+
+    // Interpolated cos/sin of an angle in [0, 2*pi) from the table.
+    void table_cos_sin(double angle_rad, double &c, double &s) const;
+
+    // Orbit time strictly after t_s at which theta reaches target_rad.
+    double next_time_at_angle(double t_s, double target_rad) const;
+
     // Physical constants
     double Re_m_;      // Earth radius (meters)
     double mu_m3_s2_;  // Earth gravitational parameter mu (m^3 / s^2)
@@ -130,6 +172,18 @@ private:
     // Sun direction in the reference plane (radians)
     double sun_theta_rad_;
 
+    // Cached cos/sin of the inclination.
+    double cos_incl_ = 1.0, sin_incl_ = 0.0;
+
+    // cos(angle between r and Sun) = sun_amp_ * cos(theta - sun_phase_rad_),
+    // so the lit arc is |theta - sun_phase_rad_| < pi/2.
+    double sun_amp_       = 1.0;
+    double sun_phase_rad_ = 0.0;
+
+    // Ephemeris table: cos/sin at 2*pi*k/M for k = 0..M (empty = off).
+    std::vector<double> cos_table_;
+    std::vector<double> sin_table_;
+
     // Current dynamic state
     OrbitState state_;
 };
@@ -0,0 +1,115 @@
+#include "AllocCounter.hpp"
+
+#include <atomic>
+
+#if SF_COUNT_ALLOCS
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocs{0};
+std::atomic<std::uint64_t> g_bytes{0};
+
+// Zero-initialized PODs: no TLS constructor runs inside operator new.
+thread_local std::uint64_t t_allocs = 0;
+thread_local std::uint64_t t_bytes  = 0;
+
+#if SF_COUNT_ALLOCS
+inline void count(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(n, std::memory_order_relaxed);
+    ++t_allocs;
+    t_bytes += n;
+}
+
+void* counted_alloc(std::size_t n) {
+    count(n);
+    for (;;) {
+        if (void* p = std::malloc(n ? n : 1)) return p;
+        std::new_handler h = std::get_new_handler();
+        if (!h) throw std::bad_alloc();
+        h();
+    }
+}
+
+void* counted_alloc_aligned(std::size_t n, std::align_val_t al) {
+    count(n);
+    const std::size_t a = static_cast<std::size_t>(al);
+    const std::size_t size = ((n ? n : 1) + a - 1) / a * a;   // aligned_alloc wants a multiple
+    for (;;) {
+        if (void* p = std::aligned_alloc(a, size)) return p;
+        std::new_handler h = std::get_new_handler();
+        if (!h) throw std::bad_alloc();
+        h();
+    }
+}
+#endif
+
+} // namespace
+
+bool AllocCounter::compiled() { return SF_COUNT_ALLOCS != 0; }
+
+AllocCounter::Snapshot AllocCounter::process() {
+    return {g_allocs.load(std::memory_order_relaxed), g_bytes.load(std::memory_order_relaxed)};
+}
+
+AllocCounter::Snapshot AllocCounter::thread() { return {t_allocs, t_bytes}; }
+
+AllocTickMeter::AllocTickMeter(int warmup_ticks)
+    : warmup_(warmup_ticks),
+      log_(Logger::instance().registerSchema("Allocs", {"allocs", "bytes", "steady"})) {}
+
+void AllocTickMeter::begin() { start_ = AllocCounter::process(); }
+
+void AllocTickMeter::end(int tick, double time) {
+    const AllocCounter::Snapshot d = AllocCounter::process() - start_;
+    const bool steady = tick > warmup_;
+    if (steady) {
+        ++steady_ticks_;
+        if (d.allocs > 0) ++steady_alloc_ticks_;
+        if (d.allocs > steady_max_) {
+            steady_max_ = d.allocs;
+            steady_max_tick_ = tick;
+        }
+    }
+    // After the snapshot: the row itself is not part of the tick.
+    log_.write(tick, time, {static_cast<double>(d.allocs), static_cast<double>(d.bytes),
+                            steady ? 1.0 : 0.0});
+}
+
+#if SF_COUNT_ALLOCS
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void* operator new(std::size_t n, std::align_val_t al) { return counted_alloc_aligned(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al) { return counted_alloc_aligned(n, al); }
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(n); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(n); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept {
+    try { return counted_alloc_aligned(n, al); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept {
+    try { return counted_alloc_aligned(n, al); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
@@ -1,21 +1,20 @@
 #include "Battery.hpp"
 #include "Logger.hpp"
+#include "Checkpoint.hpp"
 #include <algorithm>
 
 Battery::Battery(double capacity)
     : Subsystem("Battery"),
       bus_(nullptr),
       capacity_(capacity),
-      charge_(capacity / 2.0) {}   // Start 50% full
+      charge_(capacity / 2.0),     // Start 50% full
+      log_(Logger::instance().registerSchema(
+          "Battery",
+          {"status","charge_Wh","capacity_Wh","max_charge_W","max_discharge_W"})) {}
 
 void Battery::initialize() {
-    Logger::instance().log_wide(
-        "Battery",
-        0,
-        0.0,
-        {"status","charge_Wh","capacity_Wh","max_charge_W","max_discharge_W"},
-        {1.0, charge_, capacity_, max_charge_rate_W_, max_discharge_rate_W_}
-    );
+    log_.write(0, 0.0,
+               {1.0, charge_, capacity_, max_charge_rate_W_, max_discharge_rate_W_});
 }
 
 void Battery::setPowerBus(PowerBus* bus) { bus_ = bus; }
@@ -63,13 +62,16 @@ double Battery::discharge(double needed_W, double dt) {
 
 void Battery::tick(const TickContext& ctx) {
     // Only logs status — bus controls all charging/discharging
-    Logger::instance().log_wide(
-        "Battery",
-        ctx.tick_index,
-        ctx.time,
-        {"status","charge_Wh","capacity_Wh","max_charge_W","max_discharge_W"},
-        {1.0, charge_, capacity_, max_charge_rate_W_, max_discharge_rate_W_}
-    );
+    log_.write(ctx.tick_index, ctx.time,
+               {1.0, charge_, capacity_, max_charge_rate_W_, max_discharge_rate_W_});
 }
 
 void Battery::shutdown() {}
+
+void Battery::saveState(CheckpointWriter& ckpt) const {
+    ckpt.setDouble(name_ + ".charge_Wh", charge_);
+}
+
+void Battery::loadState(const CheckpointReader& ckpt) {
+    charge_ = ckpt.getDouble(name_ + ".charge_Wh");
+}
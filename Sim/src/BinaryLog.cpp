@@ -0,0 +1,265 @@
+// Sim/src/BinaryLog.cpp
+#include "BinaryLog.hpp"
+
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char          kMagic[8] = {'S', 'F', 'B', 'L', 'O', 'G', '\0', '\0'};
+constexpr std::uint32_t kChunkTag = 0x4B4E4843u; // "CHNK" little-endian
+
+constexpr std::uint8_t kEncRaw      = 0;
+constexpr std::uint8_t kEncConstant = 1;
+
+// Writes one column block, collapsing it to a single value when every row
+// holds the same bit pattern.
+template <typename T>
+void write_column(LogFileOut& out, const T* data, std::size_t n) {
+    bool constant = true;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (std::memcmp(&data[i], &data[0], sizeof(T)) != 0) {
+            constant = false;
+            break;
+        }
+    }
+    if (constant) {
+        out.write(&kEncConstant, 1);
+        out.write(data, sizeof(T));
+    } else {
+        out.write(&kEncRaw, 1);
+        out.write(data, sizeof(T) * n);
+    }
+}
+
+template <typename T>
+bool read_column(LogFileIn& in, T* data, std::size_t n) {
+    const int enc = in.getc();
+    if (enc == kEncConstant) {
+        if (in.read(data, sizeof(T)) != sizeof(T)) return false;
+        for (std::size_t i = 1; i < n; ++i) data[i] = data[0];
+        return true;
+    }
+    if (enc == kEncRaw) {
+        return in.read(data, sizeof(T) * n) == sizeof(T) * n;
+    }
+    return false;
+}
+
+template <typename T>
+void write_pod(LogFileOut& out, const T& v) {
+    out.write(&v, sizeof(T));
+}
+
+template <typename T>
+bool read_pod(LogFileIn& in, T& v) {
+    return in.read(&v, sizeof(T)) == sizeof(T);
+}
+
+// Same quoting rules as the CSV sink in Logger.cpp.
+std::string escape_csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n\r") == std::string::npos) {
+        return s;
+    }
+    std::string out;
+    out.reserve(s.size() + 8);
+    out.push_back('"');
+    for (char ch : s) {
+        if (ch == '"') out.push_back('"');
+        out.push_back(ch);
+    }
+    out.push_back('"');
+    return out;
+}
+
+} // anonymous namespace
+
+// ---------------- BinaryLogWriter ----------------
+
+BinaryLogWriter::~BinaryLogWriter() {
+    close();
+}
+
+void BinaryLogWriter::open(const std::string& path,
+                           const std::vector<std::string>& value_columns,
+                           LogCodec codec) {
+    close();
+    out_.open(path, /*append=*/false, codec);
+
+    ncols_ = value_columns.size();
+    nrows_ = 0;
+    ticks_.assign(kBinaryLogChunkRows, 0);
+    times_.assign(kBinaryLogChunkRows, 0.0);
+    values_.assign(ncols_ * kBinaryLogChunkRows, 0.0);
+
+    out_.write(kMagic, sizeof(kMagic));
+    write_pod(out_, kBinaryLogVersion);
+    write_pod(out_, static_cast<std::uint32_t>(ncols_ + 2));
+
+    auto write_col = [&](const std::string& name, BinaryColumnType type) {
+        write_pod(out_, static_cast<std::uint8_t>(type));
+        write_pod(out_, static_cast<std::uint16_t>(name.size()));
+        out_.write(name.data(), name.size());
+    };
+    write_col("tick", BinaryColumnType::Int64);
+    write_col("time_s", BinaryColumnType::Float64);
+    for (const auto& c : value_columns) {
+        write_col(c, BinaryColumnType::Float64);
+    }
+    out_.flush();
+}
+
+void BinaryLogWriter::openAppend(const std::string& path,
+                                 const std::vector<std::string>& value_columns,
+                                 LogCodec codec) {
+    close();
+    out_.open(path, /*append=*/true, codec);
+
+    ncols_ = value_columns.size();
+    nrows_ = 0;
+    ticks_.assign(kBinaryLogChunkRows, 0);
+    times_.assign(kBinaryLogChunkRows, 0.0);
+    values_.assign(ncols_ * kBinaryLogChunkRows, 0.0);
+}
+
+void BinaryLogWriter::append(std::int64_t tick, double time,
+                             const double* vals, std::size_t nvals) {
+    if (!out_.is_open()) return;
+
+    ticks_[nrows_] = tick;
+    times_[nrows_] = time;
+    for (std::size_t c = 0; c < ncols_; ++c) {
+        values_[c * kBinaryLogChunkRows + nrows_] = (c < nvals ? vals[c] : 0.0);
+    }
+
+    if (++nrows_ == kBinaryLogChunkRows) {
+        writeChunk_();
+    }
+}
+
+void BinaryLogWriter::writeChunk_() {
+    if (!out_.is_open() || nrows_ == 0) return;
+
+    write_pod(out_, kChunkTag);
+    write_pod(out_, static_cast<std::uint32_t>(nrows_));
+    write_column(out_, ticks_.data(), nrows_);
+    write_column(out_, times_.data(), nrows_);
+    for (std::size_t c = 0; c < ncols_; ++c) {
+        write_column(out_, values_.data() + c * kBinaryLogChunkRows, nrows_);
+    }
+    nrows_ = 0;
+}
+
+void BinaryLogWriter::flush() {
+    if (!out_.is_open()) return;
+    writeChunk_();
+    out_.flush();
+}
+
+void BinaryLogWriter::seal() {
+    if (!out_.is_open()) return;
+    writeChunk_();
+    out_.seal();
+}
+
+void BinaryLogWriter::close() {
+    if (!out_.is_open()) return;
+    writeChunk_();
+    out_.close();
+}
+
+// ---------------- BinaryLogReader ----------------
+
+BinaryLogReader::~BinaryLogReader() = default;
+
+void BinaryLogReader::open(const std::string& path) {
+    in_.close();
+    columns_.clear();
+    nrows_ = 0;
+
+    in_.open(path);
+
+    char magic[8];
+    std::uint32_t version = 0;
+    std::uint32_t ncols   = 0;
+    if (in_.read(magic, sizeof(magic)) != sizeof(magic) ||
+        std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("BinaryLogReader: bad magic in " + path);
+    }
+    if (!read_pod(in_, version) || version != kBinaryLogVersion) {
+        throw std::runtime_error("BinaryLogReader: unsupported version in " + path);
+    }
+    if (!read_pod(in_, ncols) || ncols < 2) {
+        throw std::runtime_error("BinaryLogReader: bad column count in " + path);
+    }
+
+    columns_.resize(ncols);
+    for (auto& col : columns_) {
+        std::uint8_t  type = 0;
+        std::uint16_t len  = 0;
+        if (!read_pod(in_, type) || !read_pod(in_, len)) {
+            throw std::runtime_error("BinaryLogReader: truncated header in " + path);
+        }
+        col.type = static_cast<BinaryColumnType>(type);
+        col.name.resize(len);
+        if (len && in_.read(&col.name[0], len) != len) {
+            throw std::runtime_error("BinaryLogReader: truncated header in " + path);
+        }
+    }
+    if (columns_[0].type != BinaryColumnType::Int64) {
+        throw std::runtime_error("BinaryLogReader: first column is not int64 tick in " + path);
+    }
+}
+
+bool BinaryLogReader::nextChunk() {
+    nrows_ = 0;
+    if (!in_.is_open()) return false;
+
+    std::uint32_t tag = 0, nrows = 0;
+    if (!read_pod(in_, tag) || tag != kChunkTag || !read_pod(in_, nrows)) {
+        return false;
+    }
+
+    const std::size_t nval = columns_.size() - 1;
+    ticks_.resize(nrows);
+    values_.resize(nval * nrows);
+    if (!read_column(in_, ticks_.data(), nrows)) {
+        return false;
+    }
+    for (std::size_t c = 0; c < nval; ++c) {
+        if (!read_column(in_, values_.data() + c * nrows, nrows)) {
+            return false;
+        }
+    }
+    nrows_ = nrows;
+    return true;
+}
+
+double BinaryLogReader::value(std::size_t col, std::size_t row) const {
+    if (col == 0) return static_cast<double>(ticks_[row]);
+    return values_[(col - 1) * nrows_ + row];
+}
+
+std::size_t BinaryLogReader::writeCsv(std::ostream& out) {
+    for (std::size_t c = 0; c < columns_.size(); ++c) {
+        if (c) out << ',';
+        out << escape_csv_field(columns_[c].name);
+    }
+    out << '\n';
+
+    std::size_t total = 0;
+    while (nextChunk()) {
+        for (std::size_t r = 0; r < nrows_; ++r) {
+            // The CSV sink writes tick as int and everything else as double with
+            // default stream formatting; mirror that exactly.
+            out << static_cast<int>(ticks_[r]);
+            for (std::size_t c = 1; c < columns_.size(); ++c) {
+                out << ',' << values_[(c - 1) * nrows_ + r];
+            }
+            out << '\n';
+        }
+        total += nrows_;
+    }
+    return total;
+}
@@ -0,0 +1,333 @@
+// Sim/src/Branching.cpp
+#include "Branching.hpp"
+
+#include "Checkpoint.hpp"
+#include "Logger.hpp"
+#include "ScheduleCompiler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kPrefixDir  = "prefix";
+constexpr const char* kPrefixCkpt = "prefix.ckpt";
+
+std::string trim(const std::string& s) {
+    const auto b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    const auto e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+bool valid_name(const std::string& s) {
+    if (s.empty()) return false;
+    for (char c : s) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                        (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// Applies one key=value token to p.
+void apply_override(const std::string& tok, const std::string& where, SweepMemberParams& p) {
+    const auto eq = tok.find('=');
+    if (eq == std::string::npos || eq == 0) {
+        throw std::runtime_error("BranchRunner: " + where + ": expected key=value, got '" + tok + "'");
+    }
+    const std::string key = tok.substr(0, eq);
+    const std::string val = tok.substr(eq + 1);
+
+    if (key == "job_file") {
+        p.job_file = (val == "none") ? std::string() : val;
+        return;
+    }
+
+    using Field = double SweepMemberParams::*;
+    static const std::map<std::string, Field> kFields = {
+        {"solar_efficiency",    &SweepMemberParams::solar_efficiency},
+        {"solar_base_input_W",  &SweepMemberParams::solar_base_input_W},
+        {"battery_capacity_Wh", &SweepMemberParams::battery_capacity_Wh},
+        {"heater_max_draw_W",   &SweepMemberParams::heater_max_draw_W},
+    };
+    const auto it = kFields.find(key);
+    if (it == kFields.end()) {
+        throw std::runtime_error("BranchRunner: " + where + ": unknown key '" + key + "'");
+    }
+    char* end = nullptr;
+    const double v = std::strtod(val.c_str(), &end);
+    if (val.empty() || !end || *end != '\0' || !std::isfinite(v) || v < 0.0) {
+        throw std::runtime_error("BranchRunner: " + where + ": bad value '" + val +
+                                 "' for " + key);
+    }
+    p.*(it->second) = v;
+}
+
+std::vector<SimHelpers::Job> load_jobs(const std::string& name, const std::string& jobsDir,
+                                       int& skipped) {
+    if (name.empty()) return {};
+    const std::string path = (name.find('/') != std::string::npos) ? name : jobsDir + "/" + name;
+    const CompiledSchedule s = ScheduleCompiler::load(path, ScheduleCacheMode::Auto);
+    if (!s.found) throw std::runtime_error("BranchRunner: failed to open job file " + path);
+    skipped += s.rows_skipped;
+    return s.jobs;
+}
+
+// The prefix's leading rows that start before the fork, then the branch
+// rows from it on. Job indices up to the fork stay those of the prefix.
+std::vector<SimHelpers::Job> branch_schedule(const std::vector<SimHelpers::Job>& prefixJobs,
+                                             const std::vector<SimHelpers::Job>& ownJobs,
+                                             double fork_min, int& skipped) {
+    std::vector<SimHelpers::Job> out;
+    for (const auto& j : prefixJobs) {
+        if (j.start_tick >= fork_min) break;
+        out.push_back(j);
+    }
+    for (const auto& j : ownJobs) {
+        if (j.start_tick >= fork_min) out.push_back(j);
+        else ++skipped;
+    }
+    return out;
+}
+
+std::string fmt(double v) {
+    std::ostringstream oss;
+    oss.precision(12);
+    oss << v;
+    return oss.str();
+}
+
+} // anonymous namespace
+
+std::vector<BranchSpec> BranchRunner::loadSpec(const std::string& path, double dt,
+                                               SweepMemberParams& prefix) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("BranchRunner: failed to open spec " + path);
+    }
+
+    prefix = SweepMemberParams{};
+    prefix.dt = dt;
+
+    // Branch overrides are applied to the prefix afterwards, so the prefix
+    // line may come anywhere in the file.
+    struct Line { std::string name, where; std::vector<std::string> tokens; };
+    std::vector<Line> lines;
+    std::set<std::string> names;
+
+    std::string text;
+    int lineno = 0;
+    while (std::getline(in, text)) {
+        ++lineno;
+        const auto hash = text.find('#');
+        const std::string t = trim(hash == std::string::npos ? text : text.substr(0, hash));
+        if (t.empty()) continue;
+
+        Line l;
+        l.where = path + ":" + std::to_string(lineno);
+        std::istringstream ss(t);
+        ss >> l.name;
+        for (std::string tok; ss >> tok;) l.tokens.push_back(tok);
+
+        if (!valid_name(l.name)) {
+            throw std::runtime_error("BranchRunner: " + l.where + ": bad branch name '" +
+                                     l.name + "' (letters, digits, '_', '-', '.')");
+        }
+        if (!names.insert(l.name).second) {
+            throw std::runtime_error("BranchRunner: " + l.where + ": '" + l.name +
+                                     "' given twice");
+        }
+        if (l.name == kPrefixDir) {
+            for (const auto& tok : l.tokens) apply_override(tok, l.where, prefix);
+        } else {
+            lines.push_back(std::move(l));
+        }
+    }
+
+    std::vector<BranchSpec> branches;
+    for (const Line& l : lines) {
+        BranchSpec b;
+        b.name   = l.name;
+        b.params = prefix;
+        for (const auto& tok : l.tokens) apply_override(tok, l.where, b.params);
+        branches.push_back(std::move(b));
+    }
+    if (branches.empty()) {
+        throw std::runtime_error("BranchRunner: spec " + path + " has no branches");
+    }
+    return branches;
+}
+
+std::vector<SweepMemberResult> BranchRunner::run(MPI_Comm comm,
+                                                 const SweepMemberParams& prefix,
+                                                 const std::vector<BranchSpec>& branches,
+                                                 const BranchOptions& opt,
+                                                 double& prefix_wall_s) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    const int ticks = std::max(1, static_cast<int>(std::lround(opt.span_s / prefix.dt)));
+    if (opt.fork_tick < 0 || opt.fork_tick > ticks) {
+        throw std::runtime_error("BranchRunner: --branch-at " + std::to_string(opt.fork_tick) +
+                                 " is outside the run's " + std::to_string(ticks) + " ticks");
+    }
+    const fs::path base = Logger::directory();
+    const fs::path prefixDir = base / kPrefixDir;
+    const std::string ckptPath = (prefixDir / kPrefixCkpt).string();
+
+    // ---------------- shared prefix (rank 0) ----------------
+    prefix_wall_s = 0.0;
+    int prefixSkipped = 0;
+    const std::vector<SimHelpers::Job> prefixJobs =
+        load_jobs(prefix.job_file, opt.jobs_dir, prefixSkipped);
+
+    std::string error;
+    if (rank == 0) {
+        try {
+            const auto wall_start = std::chrono::steady_clock::now();
+            const std::string logPrefix = std::string(kPrefixDir) + "/";
+            CheckpointWriter ckpt;
+            {
+                Logger::ScopedPrefix scope(logPrefix);
+                SweepHarness h(prefix, opt.thermal, kPrefixDir, prefixJobs);
+                h.initialize();
+                for (int i = 0; i < opt.fork_tick; ++i) h.step(i);
+                h.saveState(ckpt);
+            }
+            for (const auto& kv : Logger::instance().fileOffsets()) {
+                if (kv.first.compare(0, logPrefix.size(), logPrefix) == 0) {
+                    ckpt.setInt("log." + kv.first, static_cast<std::int64_t>(kv.second));
+                }
+            }
+            ckpt.setInt("branch.fork_tick", opt.fork_tick);
+            fs::create_directories(prefixDir);
+            ckpt.writeFile(ckptPath);
+            Logger::instance().closeStreams(logPrefix);
+            prefix_wall_s =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+    }
+
+    // Every rank needs the prefix on disk before its branches start.
+    int failed = error.empty() ? 0 : 1;
+    MPI_Bcast(&failed, 1, MPI_INT, 0, comm);
+    if (failed) {
+        throw std::runtime_error(rank == 0 ? error : "BranchRunner: the shared prefix failed on rank 0");
+    }
+    MPI_Bcast(&prefix_wall_s, 1, MPI_DOUBLE, 0, comm);
+
+    // ---------------- branches ----------------
+    const double fork_min = opt.fork_tick * prefix.dt / 60.0;
+    auto runBranch = [&](int k) -> SweepMemberResult {
+        const auto wall_start = std::chrono::steady_clock::now();
+        const BranchSpec& b = branches[static_cast<std::size_t>(k)];
+        const std::string subdir = "branch_" + b.name;
+        const fs::path dir = base / subdir;
+
+        CheckpointReader ckpt;
+        ckpt.open(ckptPath);
+
+        // Start the branch's files as copies of the prefix's, cut at the
+        // fork, and append from there.
+        fs::create_directories(dir);
+        for (const auto& entry : fs::directory_iterator(prefixDir)) {
+            if (!entry.is_regular_file() || entry.path().filename() == kPrefixCkpt) continue;
+            fs::copy_file(entry.path(), dir / entry.path().filename(),
+                          fs::copy_options::overwrite_existing);
+        }
+        std::map<std::string, std::uint64_t> offsets;
+        const std::string logKey = std::string("log.") + kPrefixDir + "/";
+        for (const std::string& key : ckpt.keys(logKey)) {
+            offsets[subdir + "/" + key.substr(logKey.size())] =
+                static_cast<std::uint64_t>(ckpt.getInt(key));
+        }
+        Logger::instance().resumeAppend(offsets);
+
+        SweepMemberResult r;
+        r.member = k;
+        r.ticks  = ticks;
+
+        std::vector<SimHelpers::Job> jobs = prefixJobs;
+        if (b.params.job_file != prefix.job_file) {
+            const std::vector<SimHelpers::Job> own = load_jobs(b.params.job_file, opt.jobs_dir, r.skipped_rows);
+            jobs = branch_schedule(prefixJobs, own, fork_min, r.skipped_rows);
+        }
+        r.jobs = static_cast<int>(jobs.size());
+
+        {
+            Logger::ScopedPrefix scope(subdir + "/");
+            SweepHarness h(b.params, opt.thermal, subdir, std::move(jobs));
+            {
+                // The prefix already logged the start-up rows.
+                Logger::ScopedDiscard quiet;
+                h.initialize();
+            }
+            h.loadState(ckpt);
+            for (int i = opt.fork_tick; i < ticks; ++i) h.step(i);
+            h.finish();
+
+            const SweepMemberResult& t = h.totals();
+            r.battery_final_Wh  = t.battery_final_Wh;
+            r.battery_min_Wh    = t.battery_min_Wh;
+            r.solar_Wh          = t.solar_Wh;
+            r.effusion_heat_Wh  = t.effusion_heat_Wh;
+            r.substrate_heat_Wh = t.substrate_heat_Wh;
+            r.unmet_heat_Wh     = t.unmet_heat_Wh;
+            r.effusion_max_K    = t.effusion_max_K;
+            r.effusion_final_K  = t.effusion_final_K;
+            r.substrate_max_K   = t.substrate_max_K;
+            r.substrate_final_K = t.substrate_final_K;
+        }
+        Logger::instance().closeStreams(subdir + "/");
+
+        r.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        return r;
+    };
+
+    return ParameterSweep::distribute(comm, static_cast<int>(branches.size()),
+                                      opt.threads, runBranch);
+}
+
+void BranchRunner::writeTable(const std::vector<BranchSpec>& branches,
+                              const std::vector<SweepMemberResult>& results,
+                              const BranchOptions& opt) {
+    static const std::vector<std::string> kColumns = {
+        "branch", "job_file", "solar_efficiency", "solar_base_input_W", "battery_capacity_Wh",
+        "heater_max_draw_W", "dt", "fork_tick", "ticks", "jobs", "skipped_rows",
+        "battery_final_Wh", "battery_min_Wh", "solar_Wh",
+        "effusion_heat_Wh", "substrate_heat_Wh", "unmet_heat_Wh",
+        "effusion_max_K", "effusion_final_K", "substrate_max_K", "substrate_final_K",
+        "rank", "wall_s"
+    };
+
+    for (const auto& r : results) {
+        const BranchSpec& b = branches.at(static_cast<std::size_t>(r.member));
+        const SweepMemberParams& p = b.params;
+        Logger::instance().log_wide(
+            "Branch", r.member, opt.span_s, kColumns,
+            std::vector<std::string>{
+                b.name, p.job_file.empty() ? "none" : p.job_file,
+                fmt(p.solar_efficiency), fmt(p.solar_base_input_W),
+                fmt(p.battery_capacity_Wh), fmt(p.heater_max_draw_W), fmt(p.dt),
+                std::to_string(opt.fork_tick), std::to_string(r.ticks), std::to_string(r.jobs),
+                std::to_string(r.skipped_rows),
+                fmt(r.battery_final_Wh), fmt(r.battery_min_Wh), fmt(r.solar_Wh),
+                fmt(r.effusion_heat_Wh), fmt(r.substrate_heat_Wh), fmt(r.unmet_heat_Wh),
+                fmt(r.effusion_max_K), fmt(r.effusion_final_K),
+                fmt(r.substrate_max_K), fmt(r.substrate_final_K),
+                std::to_string(r.rank), fmt(r.wall_s)
+            });
+    }
+}
@@ -0,0 +1,297 @@
+// Sim/src/Checkpoint.cpp
+#include "Checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'F', 'C', 'K', 'P', 'T', '\0', '\0'};
+
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr std::uint64_t kFnvPrime  = 1099511628211ull;
+
+std::uint64_t fnv1a(const char* p, std::size_t n) {
+    std::uint64_t h = kFnvOffset;
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+template <typename T>
+void put_pod(std::string& out, const T& v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+// Bounds-checked cursor over the file contents.
+class Cursor {
+public:
+    Cursor(const std::string& buf, std::size_t end, const std::string& path)
+        : buf_(buf), end_(end), path_(path) {}
+
+    template <typename T>
+    T pod() {
+        T v;
+        need_(sizeof(T));
+        std::memcpy(&v, buf_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+
+    const char* bytes(std::size_t n) {
+        need_(n);
+        const char* p = buf_.data() + pos_;
+        pos_ += n;
+        return p;
+    }
+
+    // count elements of elem bytes each; count is checked before multiplying.
+    const char* array(std::uint64_t count, std::size_t elem) {
+        if (count > (end_ - pos_) / elem) {
+            throw std::runtime_error("Checkpoint: truncated file " + path_);
+        }
+        return bytes(static_cast<std::size_t>(count) * elem);
+    }
+
+    bool done() const { return pos_ == end_; }
+
+private:
+    void need_(std::size_t n) const {
+        if (n > end_ - pos_) {
+            throw std::runtime_error("Checkpoint: truncated file " + path_);
+        }
+    }
+
+    const std::string& buf_;
+    std::size_t        end_;
+    std::size_t        pos_ = 0;
+    const std::string& path_;
+};
+
+const char* type_name(CheckpointValueType t) {
+    switch (t) {
+        case CheckpointValueType::Int64:   return "int64";
+        case CheckpointValueType::Float64: return "float64";
+        case CheckpointValueType::Text:    return "text";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+// ---------------- CheckpointWriter ----------------
+
+void CheckpointWriter::setInts(const std::string& key, const std::vector<std::int64_t>& v) {
+    Entry e;
+    e.type = CheckpointValueType::Int64;
+    e.ints = v;
+    entries_[key] = std::move(e);
+}
+
+void CheckpointWriter::setInts(const std::string& key, const std::vector<int>& v) {
+    setInts(key, std::vector<std::int64_t>(v.begin(), v.end()));
+}
+
+void CheckpointWriter::setDoubles(const std::string& key, const std::vector<double>& v) {
+    Entry e;
+    e.type    = CheckpointValueType::Float64;
+    e.doubles = v;
+    entries_[key] = std::move(e);
+}
+
+void CheckpointWriter::setText(const std::string& key, const std::string& v) {
+    Entry e;
+    e.type = CheckpointValueType::Text;
+    e.text = v;
+    entries_[key] = std::move(e);
+}
+
+std::uint64_t CheckpointWriter::writeFile(const std::string& path) const {
+    std::string buf;
+    buf.append(kMagic, sizeof(kMagic));
+    put_pod(buf, kCheckpointVersion);
+    put_pod(buf, static_cast<std::uint32_t>(entries_.size()));
+
+    for (const auto& kv : entries_) {
+        const Entry& e = kv.second;
+        if (kv.first.size() > 0xFFFFu) {
+            throw std::runtime_error("Checkpoint: key too long: " + kv.first.substr(0, 64));
+        }
+        put_pod(buf, static_cast<std::uint8_t>(e.type));
+        put_pod(buf, static_cast<std::uint16_t>(kv.first.size()));
+        buf.append(kv.first);
+        switch (e.type) {
+            case CheckpointValueType::Int64:
+                put_pod(buf, static_cast<std::uint64_t>(e.ints.size()));
+                buf.append(reinterpret_cast<const char*>(e.ints.data()),
+                           e.ints.size() * sizeof(std::int64_t));
+                break;
+            case CheckpointValueType::Float64:
+                put_pod(buf, static_cast<std::uint64_t>(e.doubles.size()));
+                buf.append(reinterpret_cast<const char*>(e.doubles.data()),
+                           e.doubles.size() * sizeof(double));
+                break;
+            case CheckpointValueType::Text:
+                put_pod(buf, static_cast<std::uint64_t>(e.text.size()));
+                buf.append(e.text);
+                break;
+        }
+    }
+    put_pod(buf, fnv1a(buf.data(), buf.size()));
+
+    const std::string tmp = path + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Checkpoint: failed to open " + tmp);
+        }
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        out.flush();
+        if (!out) {
+            out.close();
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Checkpoint: failed while writing " + tmp);
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("Checkpoint: failed to rename " + tmp + " to " + path +
+                                 " : " + ec.message());
+    }
+    return buf.size();
+}
+
+// ---------------- CheckpointReader ----------------
+
+void CheckpointReader::open(const std::string& path) {
+    path_ = path;
+    entries_.clear();
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Checkpoint: cannot open " + path);
+    }
+    const std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (buf.size() < sizeof(kMagic) + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) ||
+        std::memcmp(buf.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Checkpoint: " + path + " is not a checkpoint file");
+    }
+
+    const std::size_t body = buf.size() - sizeof(std::uint64_t);
+    std::uint64_t stored = 0;
+    std::memcpy(&stored, buf.data() + body, sizeof(stored));
+    if (stored != fnv1a(buf.data(), body)) {
+        throw std::runtime_error("Checkpoint: checksum mismatch in " + path);
+    }
+
+    Cursor cur(buf, body, path_);
+    cur.bytes(sizeof(kMagic));
+    const auto version = cur.pod<std::uint32_t>();
+    if (version != kCheckpointVersion) {
+        throw std::runtime_error("Checkpoint: " + path + " has unsupported version " +
+                                 std::to_string(version));
+    }
+
+    const auto n = cur.pod<std::uint32_t>();
+    for (std::uint32_t k = 0; k < n; ++k) {
+        Entry e;
+        const auto type = cur.pod<std::uint8_t>();
+        if (type > static_cast<std::uint8_t>(CheckpointValueType::Text)) {
+            throw std::runtime_error("Checkpoint: unknown value type in " + path);
+        }
+        e.type = static_cast<CheckpointValueType>(type);
+
+        const auto key_len = cur.pod<std::uint16_t>();
+        std::string key(cur.bytes(key_len), key_len);
+
+        const auto count = cur.pod<std::uint64_t>();
+        switch (e.type) {
+            case CheckpointValueType::Int64: {
+                const char* p = cur.array(count, sizeof(std::int64_t));
+                e.ints.resize(count);
+                std::memcpy(e.ints.data(), p, count * sizeof(std::int64_t));
+                break;
+            }
+            case CheckpointValueType::Float64: {
+                const char* p = cur.array(count, sizeof(double));
+                e.doubles.resize(count);
+                std::memcpy(e.doubles.data(), p, count * sizeof(double));
+                break;
+            }
+            case CheckpointValueType::Text:
+                e.text.assign(cur.array(count, 1), count);
+                break;
+        }
+        entries_[key] = std::move(e);
+    }
+    if (!cur.done()) {
+        throw std::runtime_error("Checkpoint: trailing bytes in " + path);
+    }
+}
+
+const CheckpointReader::Entry& CheckpointReader::entry_(const std::string& key,
+                                                        CheckpointValueType type) const {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        throw std::runtime_error("Checkpoint: " + path_ + " has no entry '" + key + "'");
+    }
+    if (it->second.type != type) {
+        std::ostringstream oss;
+        oss << "Checkpoint: entry '" << key << "' in " << path_ << " is "
+            << type_name(it->second.type) << ", expected " << type_name(type);
+        throw std::runtime_error(oss.str());
+    }
+    return it->second;
+}
+
+std::int64_t CheckpointReader::getInt(const std::string& key) const {
+    const Entry& e = entry_(key, CheckpointValueType::Int64);
+    if (e.ints.size() != 1) {
+        throw std::runtime_error("Checkpoint: entry '" + key + "' is not a scalar");
+    }
+    return e.ints.front();
+}
+
+double CheckpointReader::getDouble(const std::string& key) const {
+    const Entry& e = entry_(key, CheckpointValueType::Float64);
+    if (e.doubles.size() != 1) {
+        throw std::runtime_error("Checkpoint: entry '" + key + "' is not a scalar");
+    }
+    return e.doubles.front();
+}
+
+std::vector<std::int64_t> CheckpointReader::getInts(const std::string& key) const {
+    return entry_(key, CheckpointValueType::Int64).ints;
+}
+
+std::vector<double> CheckpointReader::getDoubles(const std::string& key) const {
+    return entry_(key, CheckpointValueType::Float64).doubles;
+}
+
+const std::string& CheckpointReader::getText(const std::string& key) const {
+    return entry_(key, CheckpointValueType::Text).text;
+}
+
+std::vector<std::string> CheckpointReader::keys(const std::string& prefix) const {
+    std::vector<std::string> out;
+    for (auto it = entries_.lower_bound(prefix); it != entries_.end(); ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+        out.push_back(it->first);
+    }
+    return out;
+}
@@ -0,0 +1,133 @@
+#include "CsvTailReader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Narrows [b, e) of s to its non-whitespace part.
+void trim(const std::string& s, std::size_t& b, std::size_t& e) {
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+}
+
+// Offset of field col, or npos if the row has no such field.
+std::size_t field_start(const std::string& row, std::size_t col) {
+    std::size_t b = 0;
+    for (std::size_t i = 0; i < col; ++i) {
+        const std::size_t c = row.find(',', b);
+        if (c == std::string::npos) return std::string::npos;
+        b = c + 1;
+    }
+    return b < row.size() ? b : std::string::npos;
+}
+
+} // namespace
+
+void CsvTailReader::reset(std::filesystem::path file) {
+    path_ = std::move(file);
+    dev_ = ino_ = 0;
+    restart_();
+}
+
+void CsvTailReader::restart_() {
+    offset_ = 0;
+    tail_len_ = 0;
+    header_done_ = false;
+    last_.clear();
+}
+
+bool CsvTailReader::poll() {
+    struct stat st{};
+    if (::stat(path_.c_str(), &st) != 0) {
+        // Gone (or not created yet): next appearance starts from the top.
+        dev_ = ino_ = 0;
+        restart_();
+        return false;
+    }
+
+    const std::uint64_t size = static_cast<std::uint64_t>(st.st_size);
+    const std::int64_t mtime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                               static_cast<std::int64_t>(st.st_mtim.tv_nsec);
+    if (static_cast<std::uint64_t>(st.st_dev) != dev_ ||
+        static_cast<std::uint64_t>(st.st_ino) != ino_ || size < offset_) {
+        dev_ = static_cast<std::uint64_t>(st.st_dev);
+        ino_ = static_cast<std::uint64_t>(st.st_ino);
+        restart_();
+    }
+    if (size == offset_ && mtime == mtime_) return !last_.empty();
+
+    // Plain pread into a buffer that keeps its capacity: a poll in steady
+    // state opens no stream and allocates nothing. The read starts tail_len_
+    // bytes early so an in-place rewrite shows up as changed bytes there.
+    const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return !last_.empty();
+    std::uint64_t base = 0;
+    for (;;) {
+        base = offset_ - tail_len_;
+        chunk_.resize(static_cast<std::size_t>(size - base));
+        std::size_t got = 0;
+        while (got < chunk_.size()) {
+            const ssize_t r = ::pread(fd, &chunk_[got], chunk_.size() - got,
+                                      static_cast<off_t>(base + got));
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) break;
+            got += static_cast<std::size_t>(r);
+        }
+        chunk_.resize(got);
+        if (tail_len_ == 0 ||
+            (got >= tail_len_ && std::memcmp(chunk_.data(), tail_, tail_len_) == 0)) {
+            break;
+        }
+        restart_();   // rewritten under us: read the whole file again
+    }
+    ::close(fd);
+    mtime_ = mtime;
+
+    // Only whole lines are consumed; a partial tail waits for the next poll.
+    std::size_t start = tail_len_;
+    for (;;) {
+        const std::size_t nl = chunk_.find('\n', start);
+        if (nl == std::string::npos) break;
+        if (!header_done_) {
+            header_done_ = true;
+        } else {
+            std::size_t b = start, e = nl;
+            trim(chunk_, b, e);
+            if (b < e) last_.assign(chunk_, b, e - b);
+        }
+        start = nl + 1;
+    }
+    offset_ = base + start;
+
+    // Remember the bytes before the new offset; chunk_ starts a full tail
+    // before the old offset or at 0, so they are all inside it.
+    tail_len_ = static_cast<std::size_t>(std::min<std::uint64_t>(kTailBytes, offset_));
+    std::memcpy(tail_, chunk_.data() + (start - tail_len_), tail_len_);
+    return !last_.empty();
+}
+
+bool CsvTailReader::hasField(const std::string& row, std::size_t col) {
+    return field_start(row, col) != std::string::npos;
+}
+
+bool CsvTailReader::fieldDouble(const std::string& row, std::size_t col, double& out) {
+    const std::size_t b = field_start(row, col);
+    if (b == std::string::npos) return false;
+    // strtod stops at the comma; the row's terminator ends the last field.
+    const char* p = row.c_str() + b;
+    char* end = nullptr;
+    errno = 0;
+    const double v = std::strtod(p, &end);
+    if (end == p || errno == ERANGE) return false;
+    out = v;
+    return true;
+}
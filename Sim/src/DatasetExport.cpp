@@ -0,0 +1,356 @@
+// Sim/src/DatasetExport.cpp
+#include "DatasetExport.hpp"
+
+#include "WaferArchive.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Magic, version, header length and the dict, padded so the data starts on
+// a 64-byte boundary; large enough for any shape this exporter writes.
+constexpr std::size_t kNpyHeaderBytes = 128;
+constexpr std::size_t kNpyBufferBytes = std::size_t{1} << 20;
+
+// Row files get their headers patched this often, so a crashed run keeps
+// a loadable prefix.
+constexpr std::uint64_t kSyncRows = 4096;
+
+char byte_order(std::size_t item_bytes) {
+    if (item_bytes == 1) return '|';
+    const std::uint16_t probe = 1;
+    unsigned char first = 0;
+    std::memcpy(&first, &probe, 1);
+    return first == 1 ? '<' : '>';
+}
+
+std::string json_string(const std::string& v) {
+    std::string out = "\"";
+    for (char c : v) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + '"';
+}
+
+std::string json_shape(const std::vector<std::size_t>& shape) {
+    std::ostringstream s;
+    s << '[';
+    for (std::size_t i = 0; i < shape.size(); ++i) s << (i ? ", " : "") << shape[i];
+    s << ']';
+    return s.str();
+}
+
+// A complete array in one go (job_rows, wafer tensors).
+void write_npy(const std::string& path, const std::string& descr, std::size_t item_bytes,
+               const std::vector<std::size_t>& shape, const void* data) {
+    NpyFile f;
+    const std::vector<std::size_t> inner(shape.begin() + 1, shape.end());
+    f.open(path, descr, item_bytes, inner);
+    std::size_t n = shape.empty() ? 0 : shape[0];
+    for (std::size_t d : inner) n *= d;
+    f.append(data, n);
+    f.close();
+}
+
+} // anonymous namespace
+
+// ---------------- NpyFile ----------------
+
+NpyFile::~NpyFile() {
+    close();
+}
+
+void NpyFile::open(const std::string& path, const std::string& descr, std::size_t item_bytes,
+                   const std::vector<std::size_t>& inner) {
+    close();
+    fp_ = std::fopen(path.c_str(), "wb");
+    if (!fp_) {
+        throw std::runtime_error("NpyFile: failed to open " + path);
+    }
+    buffer_.resize(kNpyBufferBytes);
+    std::setvbuf(fp_, buffer_.data(), _IOFBF, buffer_.size());
+
+    descr_      = descr;
+    item_bytes_ = item_bytes;
+    inner_      = inner;
+    row_items_  = 1;
+    for (std::size_t d : inner_) row_items_ *= d;
+    rows_ = 0;
+    try {
+        writeHeader_();
+    } catch (...) {
+        // Left open, close() would retry the header and throw from ~NpyFile.
+        std::fclose(fp_);
+        fp_ = nullptr;
+        throw;
+    }
+}
+
+std::string NpyFile::dtype() const {
+    return std::string(1, byte_order(item_bytes_)) + descr_;
+}
+
+std::vector<std::size_t> NpyFile::shape() const {
+    std::vector<std::size_t> s{static_cast<std::size_t>(rows_)};
+    s.insert(s.end(), inner_.begin(), inner_.end());
+    return s;
+}
+
+// Formatted in place: sync() runs on the tick path and must not allocate.
+void NpyFile::writeHeader_() {
+    constexpr std::size_t text_bytes = kNpyHeaderBytes - 10;
+    char text[text_bytes + 1];
+    int len = std::snprintf(text, sizeof(text), "{'descr': '%c%s', 'fortran_order': False, 'shape': (%llu",
+                            byte_order(item_bytes_), descr_.c_str(),
+                            static_cast<unsigned long long>(rows_));
+    for (std::size_t d : inner_) {
+        if (len > 0 && static_cast<std::size_t>(len) < sizeof(text)) {
+            len += std::snprintf(text + len, sizeof(text) - static_cast<std::size_t>(len), ", %llu",
+                                 static_cast<unsigned long long>(d));
+        }
+    }
+    if (len > 0 && static_cast<std::size_t>(len) < sizeof(text)) {
+        len += std::snprintf(text + len, sizeof(text) - static_cast<std::size_t>(len), "%s), }",
+                             inner_.empty() ? "," : "");
+    }
+    if (len <= 0 || static_cast<std::size_t>(len) + 1 > text_bytes) {
+        throw std::runtime_error("NpyFile: shape too long for the header");
+    }
+    std::memset(text + len, ' ', text_bytes - 1 - static_cast<std::size_t>(len));
+    text[text_bytes - 1] = '\n';
+
+    const unsigned char pre[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                   static_cast<unsigned char>(text_bytes & 0xff),
+                                   static_cast<unsigned char>(text_bytes >> 8)};
+    std::fwrite(pre, 1, sizeof(pre), fp_);
+    std::fwrite(text, 1, text_bytes, fp_);
+}
+
+void NpyFile::append(const void* data, std::size_t n) {
+    if (!fp_ || n == 0) return;
+    if (n % row_items_ != 0) {
+        throw std::runtime_error("NpyFile: " + std::to_string(n) + " item(s) are not whole rows of " +
+                                 std::to_string(row_items_));
+    }
+    if (std::fwrite(data, item_bytes_, n, fp_) != n) {
+        throw std::runtime_error("NpyFile: write failed");
+    }
+    rows_ += n / row_items_;
+}
+
+void NpyFile::sync() {
+    if (!fp_) return;
+    std::fseek(fp_, 0, SEEK_SET);
+    writeHeader_();
+    std::fseek(fp_, 0, SEEK_END);
+    std::fflush(fp_);
+}
+
+void NpyFile::close() {
+    if (!fp_) return;
+    sync();
+    std::fclose(fp_);
+    fp_ = nullptr;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+}
+
+// ---------------- DatasetExport ----------------
+
+DatasetExport::~DatasetExport() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void DatasetExport::open(const std::string& dir, const std::vector<std::string>& columns,
+                         std::size_t n_jobs, double dt) {
+    close();
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+        throw std::runtime_error("DatasetExport: cannot create " + dir + " : " + ec.message());
+    }
+    dir_     = dir;
+    columns_ = columns;
+    n_jobs_  = n_jobs;
+    dt_      = dt;
+    first_tick_ = last_tick_ = -1;
+    job_rows_.assign(2 * n_jobs_, -1);
+    grid_n_ = 0;
+    wafer_cells_ = wafer_records_ = 0;
+
+    const fs::path d(dir_);
+    tick_.open((d / "tick.npy").string(), "i8", sizeof(std::int64_t), {});
+    time_.open((d / "time_s.npy").string(), "f8", sizeof(double), {});
+    job_.open((d / "job.npy").string(), "i4", sizeof(std::int32_t), {});
+    features_.open((d / "features.npy").string(), "f8", sizeof(double), {columns_.size()});
+
+    // Stale wafer tensors of an earlier run in the same directory.
+    for (const char* f : {"wafer_maps.npy", "wafer_mask.npy", "wafer_status.npy"}) {
+        fs::remove(d / f, ec);
+    }
+    writeSchema_();
+}
+
+void DatasetExport::append(long tick, double time, int job, const double* vals, std::size_t n) {
+    if (!isOpen()) return;
+    if (n != columns_.size()) {
+        throw std::runtime_error("DatasetExport: row has " + std::to_string(n) + " value(s), schema has " +
+                                 std::to_string(columns_.size()));
+    }
+    const std::int64_t row = static_cast<std::int64_t>(features_.rows());
+    const std::int64_t t64 = tick;
+    const std::int32_t j32 = job;
+    tick_.append(&t64, 1);
+    time_.append(&time, 1);
+    job_.append(&j32, 1);
+    features_.append(vals, n);
+
+    if (features_.rows() % kSyncRows == 0) {
+        tick_.sync();
+        time_.sync();
+        job_.sync();
+        features_.sync();
+    }
+
+    if (first_tick_ < 0) first_tick_ = tick;
+    last_tick_ = tick;
+    if (job >= 0 && static_cast<std::size_t>(job) < n_jobs_) {
+        std::int64_t* jr = &job_rows_[2 * static_cast<std::size_t>(job)];
+        if (jr[0] < 0) jr[0] = row;
+        jr[1] = row;
+    }
+}
+
+void DatasetExport::writeWaferMaps(const std::string& archive_path) {
+    if (!isOpen()) return;
+
+    WaferArchiveReader reader;
+    reader.open(archive_path);
+    const int N = reader.gridN();
+    const std::vector<std::uint32_t>& cells = reader.cells();
+    const std::size_t plane = static_cast<std::size_t>(N) * static_cast<std::size_t>(N);
+
+    // Last record of each job wins, as in the CSV.
+    std::vector<long> latest(n_jobs_, -1);
+    for (std::size_t i = 0; i < reader.recordCount(); ++i) {
+        const int j = reader.record(i).job_index;
+        if (j >= 0 && static_cast<std::size_t>(j) < n_jobs_) latest[static_cast<std::size_t>(j)] = static_cast<long>(i);
+    }
+
+    const fs::path d(dir_);
+    NpyFile maps;
+    maps.open((d / "wafer_maps.npy").string(), "f8", sizeof(double),
+              {static_cast<std::size_t>(N), static_cast<std::size_t>(N)});
+    std::vector<double>      grid(plane);
+    std::vector<std::int8_t> status(n_jobs_, -1);
+    std::size_t records = 0;
+    for (std::size_t j = 0; j < n_jobs_; ++j) {
+        std::fill(grid.begin(), grid.end(), 0.0);
+        if (latest[j] >= 0) {
+            const WaferRecord rec = reader.record(static_cast<std::size_t>(latest[j]));
+            for (std::size_t c = 0; c < cells.size(); ++c) {
+                grid[cells[c]] = rec.uniform ? rec.dose[0] : rec.dose[c];
+            }
+            status[j] = static_cast<std::int8_t>(rec.status);
+            ++records;
+        }
+        maps.append(grid.data(), plane);
+    }
+    maps.close();
+
+    std::vector<std::uint8_t> mask(plane, 0);
+    for (std::uint32_t c : cells) mask[c] = 1;
+    write_npy((d / "wafer_mask.npy").string(), "u1", 1,
+              {static_cast<std::size_t>(N), static_cast<std::size_t>(N)}, mask.data());
+    write_npy((d / "wafer_status.npy").string(), "i1", 1, {n_jobs_}, status.data());
+
+    grid_n_        = N;
+    wafer_cells_   = cells.size();
+    wafer_records_ = records;
+}
+
+void DatasetExport::close() {
+    if (!isOpen()) return;
+    tick_.close();
+    time_.close();
+    job_.close();
+    features_.close();
+    write_npy((fs::path(dir_) / "job_rows.npy").string(), "i8", sizeof(std::int64_t),
+              {n_jobs_, 2}, job_rows_.data());
+    writeSchema_();
+}
+
+void DatasetExport::writeSchema_() const {
+    const std::uint64_t rows = tick_.rows();
+    const std::size_t   ncol = columns_.size();
+    const char* run_id = std::getenv("RUN_ID");
+
+    std::ostringstream js;
+    js << "{\n"
+       << "  \"format\": \"spaceforge-dataset\",\n"
+       << "  \"version\": 1,\n"
+       << "  \"run_id\": " << json_string(run_id ? run_id : "") << ",\n"
+       << "  \"dt_s\": " << dt_ << ",\n"
+       << "  \"rows\": " << rows << ",\n"
+       << "  \"first_tick\": " << first_tick_ << ",\n"
+       << "  \"last_tick\": " << last_tick_ << ",\n"
+       << "  \"n_jobs\": " << n_jobs_ << ",\n"
+       << "  \"columns\": [";
+    for (std::size_t c = 0; c < ncol; ++c) js << (c ? ", " : "") << json_string(columns_[c]);
+    js << "],\n";
+
+    struct Entry { const char* name; std::string dtype; std::vector<std::size_t> shape; };
+    std::vector<Entry> arrays = {
+        {"tick",     tick_.dtype(),     {static_cast<std::size_t>(rows)}},
+        {"time_s",   time_.dtype(),     {static_cast<std::size_t>(rows)}},
+        {"job",      job_.dtype(),      {static_cast<std::size_t>(rows)}},
+        {"features", features_.dtype(), {static_cast<std::size_t>(rows), ncol}},
+        {"job_rows", tick_.dtype(),     {n_jobs_, 2}},
+    };
+    if (grid_n_ > 0) {
+        const std::size_t N = static_cast<std::size_t>(grid_n_);
+        arrays.push_back({"wafer_maps",   features_.dtype(), {n_jobs_, N, N}});
+        arrays.push_back({"wafer_mask",   "|u1",             {N, N}});
+        arrays.push_back({"wafer_status", "|i1",             {n_jobs_}});
+    }
+    js << "  \"arrays\": {\n";
+    for (std::size_t i = 0; i < arrays.size(); ++i) {
+        js << "    " << json_string(arrays[i].name) << ": {\"file\": "
+           << json_string(std::string(arrays[i].name) + ".npy")
+           << ", \"dtype\": " << json_string(arrays[i].dtype)
+           << ", \"shape\": " << json_shape(arrays[i].shape) << "}"
+           << (i + 1 < arrays.size() ? ",\n" : "\n");
+    }
+    js << "  }";
+    if (grid_n_ > 0) {
+        js << ",\n  \"wafer\": {\"grid_n\": " << grid_n_ << ", \"cells\": " << wafer_cells_
+           << ", \"jobs_with_record\": " << wafer_records_
+           << ", \"status\": {\"-1\": \"none\", \"0\": \"done\", \"1\": \"aborted\", \"2\": \"unfinished\"}}";
+    }
+    js << "\n}\n";
+
+    // Replaced atomically, so a reader never sees half a schema.
+    const fs::path path = fs::path(dir_) / "schema.json";
+    const fs::path tmp  = fs::path(dir_) / "schema.json.tmp";
+    {
+        std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+        if (!out) throw std::runtime_error("DatasetExport: cannot write " + tmp.string());
+        out << js.str();
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) throw std::runtime_error("DatasetExport: cannot write " + path.string() + " : " + ec.message());
+}
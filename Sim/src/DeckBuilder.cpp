@@ -0,0 +1,458 @@
+// Sim/src/DeckBuilder.cpp
+#include "DeckBuilder.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Shortest text that reads back as the same double.
+std::string num(double v) {
+    char buf[32];
+    for (int prec = 6; prec <= 17; ++prec) {
+        std::snprintf(buf, sizeof(buf), "%.*g", prec, v);
+        if (std::strtod(buf, nullptr) == v) break;
+    }
+    return buf;
+}
+
+std::string box(const DeckBox& b) {
+    std::string s;
+    for (int k = 0; k < 3; ++k) s += "  " + num(b.lo[k]) + " " + num(b.hi[k]);
+    return s;
+}
+
+std::string lower(std::string s) {
+    for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+bool overlaps(const DeckBox& a, const std::array<double, 3>& lo, const std::array<double, 3>& hi) {
+    for (int k = 0; k < 3; ++k) {
+        if (hi[k] < a.lo[k] || lo[k] > a.hi[k]) return false;
+    }
+    return true;
+}
+
+void section(std::ostringstream& os, const char* title) {
+    os << "\n# ------------------------------------------------------------------\n"
+       << "# " << title << "\n"
+       << "# ------------------------------------------------------------------\n";
+}
+
+const char* const kHeaderNote =
+    "# Generated by DeckBuilder (Sim/src/DeckBuilder.cpp) from a WakeDeckConfig.\n"
+    "# Edit the config, not this file: the harness rewrites it on every\n"
+    "# --wake-deck generate run.\n";
+
+} // anonymous namespace
+
+WakeDeckConfig WakeDeckConfig::harnessDefaults() {
+    WakeDeckConfig c;
+    c.domain = {{{-13.0, -5.0, -5.0}}, {{12.0, 5.0, 5.0}}};
+
+    // Orifice to wafer (x 1.61 .. 4.05) with a margin for the plume, and a
+    // coarser band around the cupola body ending where the beam region
+    // starts.
+    c.refine.push_back({"beam",   {{{1.0, -0.8, -0.8}}, {{4.6, 0.8, 0.8}}}, 4});
+    c.refine.push_back({"cupola", {{{-3.2, -2.4, -2.4}}, {{1.0, 2.4, 2.4}}}, 2});
+
+    c.surfaces = {{"surf/cupola.surf", {{0.0, 0.0, 0.0}}},
+                  {"surf/mbe_orifice_10mm.surf", {{0.0, 0.0, 0.0}}},
+                  {"surf/wafer_300mm.surf", {{3.6, 0.0, 0.0}}}};
+
+    c.surf_groups = {{"cupGrp",       {{{-2.9, -5.0, -5.0}}, {{1.61095, 5.0, 5.0}}}},
+                     {"mbeNozzleGrp", {{{1.61215, -0.0062, -0.0062}}, {{1.61225, 0.0062, 0.0062}}}},
+                     {"waferGrp",     {{{3.95, -0.16, -0.14}}, {{4.05, 0.16, 0.14}}}}};
+
+    c.probes = {{"Front", {{{-7.0, -2.60, -2.60}}, {{-3.2, 2.60, 2.60}}}},
+                {"Wake",  {{{10.5, -1.462853806757, -1.538135592828}}, {{11.5, 1.462853806757, 1.538135592828}}}},
+                {"Free",  {{{10.5, -0.60, 2.00}}, {{11.5, 0.60, 5.00}}}},
+                {"Gap",   {{{2.255, -1.65, -1.994642674}}, {{3.445, 1.65, 1.305357326}}}}};
+
+    // Only the external-process shim reads probes from a file, and only an
+    // embedded instance can hand over the per-element wafer flux.
+    c.diag_csv   = !ENABLE_SPARTA;
+    c.wafer_flux = ENABLE_SPARTA;
+    return c;
+}
+
+DeckBuilder::DeckBuilder(WakeDeckConfig cfg) : cfg_(std::move(cfg)) {
+    validate_();
+}
+
+void DeckBuilder::validate_() const {
+    auto fail = [](const std::string& what) {
+        throw std::runtime_error("DeckBuilder: " + what);
+    };
+    if (cfg_.deck.empty()) fail("empty deck name");
+    for (int k = 0; k < 3; ++k) {
+        if (cfg_.grid[k] < 1) fail("grid counts must be positive");
+        if (!(cfg_.domain.hi[k] > cfg_.domain.lo[k])) fail("empty domain box");
+    }
+    for (const DeckRefineRegion& r : cfg_.refine) {
+        if (r.name.empty()) fail("refine region without a name");
+        if (r.cells < 2) fail("refine region " + r.name + " needs cells >= 2");
+        if (!overlaps(cfg_.domain, r.box.lo, r.box.hi)) fail("refine region " + r.name + " is outside the domain");
+    }
+    auto has_group = [&](const char* name) {
+        return std::any_of(cfg_.surf_groups.begin(), cfg_.surf_groups.end(),
+                           [&](const DeckSurfGroup& g) { return g.name == name; });
+    };
+    // The runtime physics emits from these two groups.
+    if (!has_group("cupGrp") || !has_group("mbeNozzleGrp")) fail("surf_groups need cupGrp and mbeNozzleGrp");
+    if (cfg_.wafer_flux && (!has_group("waferGrp") || cfg_.wafer_flux_fix.empty())) {
+        fail("wafer_flux needs a waferGrp surf group and a fix ID");
+    }
+    if (std::none_of(cfg_.probes.begin(), cfg_.probes.end(),
+                     [&](const DeckProbe& p) { return p.name == cfg_.wake_probe; })) {
+        fail("wake_probe " + cfg_.wake_probe + " is not in probes");
+    }
+    if (cfg_.block_steps < 1) fail("block_steps must be positive");
+    if (cfg_.sample_every < 1 || cfg_.block_steps % cfg_.sample_every != 0) {
+        fail("sample_every must divide block_steps");
+    }
+    if (cfg_.csv_every_blocks < 0 || cfg_.stats_every_blocks < 0) fail("negative output cadence");
+    if (cfg_.ticks_per_block < 1 || !(cfg_.dt_tick_s > 0.0)) fail("ticks_per_block and dt_tick_s must be positive");
+}
+
+// ---------------- main deck ----------------
+
+std::string DeckBuilder::deckText() const {
+    const WakeDeckConfig& c = cfg_;
+    std::ostringstream os;
+    os << "# --- LEO wake + pencil-beam MBE orifice (harness-driven) ---\n" << kHeaderNote
+       << "#\n"
+       << "# Coarse grid " << c.grid[0] << " x " << c.grid[1] << " x " << c.grid[2] << ", "
+       << c.refine.size() << " refined region(s), ~" << estimatedCells() << " cells (a uniform grid at\n"
+       << "# the finest spacing would need " << uniformEquivalentCells() << ").\n\n"
+       << "units              si\n"
+       << "seed               " << c.seed << "\n"
+       << "dimension          3\n"
+       << "boundary           o o o\n\n"
+       << "# Harness-driven variables: Fwafer_cm2s, mbe_active\n"
+       << "include            params.inc\n";
+
+    section(os, "Domain & grid: coarse far field, refined near the beam and bodies");
+    os << "create_box        " << box(c.domain) << "\n"
+       << "create_grid        " << c.grid[0] << " " << c.grid[1] << " " << c.grid[2] << "\n";
+    for (const DeckRefineRegion& r : c.refine) {
+        os << "region             rRefine_" << r.name << " block" << box(r.box) << "\n"
+           << "adapt_grid         all refine random 1.0 0.0 region rRefine_" << r.name << " one cells "
+           << r.cells << " " << r.cells << " " << r.cells << "\n";
+    }
+    if (!c.refine.empty() && c.balance) {
+        os << "balance_grid       rcb cell\n";
+    }
+
+    section(os, "Gas & flow (DSMC with VSS)");
+    os << "species            data/o.species O N2 He H2O\n"
+       << "variable           Tgas          equal " << num(c.T_gas_K) << "\n"
+       << "mixture            mixWake O N2 He temp ${Tgas} vstream " << num(c.vstream_ms) << " 0.0 0.0\n"
+       << "mixture            mixWake O  frac 0.893\n"
+       << "mixture            mixWake N2 frac 0.087\n"
+       << "mixture            mixWake He frac 0.020\n\n"
+       << "# Superset mixture for collisions & \"total\" thermo computes (includes H2O)\n"
+       << "mixture            mixAll  O N2 He H2O\n";
+    if (c.csv_every_blocks > 0 && c.rga_csv) {
+        os << "\n# RGA mixture: one group per species\n"
+           << "mixture            mixRGA  O N2 He H2O group SELF\n";
+    }
+
+    section(os, "Surfaces + groups");
+    for (const DeckSurface& s : c.surfaces) {
+        os << "read_surf          " << s.file;
+        if (s.trans[0] != 0.0 || s.trans[1] != 0.0 || s.trans[2] != 0.0) {
+            os << " trans " << num(s.trans[0]) << " " << num(s.trans[1]) << " " << num(s.trans[2]);
+        }
+        os << "\n";
+    }
+    for (const DeckSurfGroup& g : c.surf_groups) {
+        os << "\nregion r_" << g.name << " block" << box(g.box) << "\n"
+           << "group  " << g.name << " surf clear\n"
+           << "group  " << g.name << " surf region r_" << g.name << " center\n";
+    }
+
+    section(os, "Runtime setup shared with the resume deck (restart-snapshot reloads)");
+    os << "include            " << c.runtimeInclude() << "\n";
+    return os.str();
+}
+
+// ---------------- runtime include ----------------
+
+std::string DeckBuilder::runtimeText() const {
+    const WakeDeckConfig& c = cfg_;
+    const bool csv = c.csv_every_blocks > 0;
+    const bool rga = csv && c.rga_csv;
+    const long window = static_cast<long>(c.block_steps) * std::max(c.csv_every_blocks, 1);
+    const std::string avg = std::to_string(c.sample_every) + " " +
+                            std::to_string(window / c.sample_every) + " " + std::to_string(window);
+
+    // Probes with a consumer: the wake probe feeds the in-process variables
+    // and wake_diag.csv; the rest only the 4-probe CSV.
+    std::vector<DeckProbe> probes;
+    for (const DeckProbe& p : c.probes) {
+        if (csv || p.name == c.wake_probe) probes.push_back(p);
+    }
+    const std::string W = c.wake_probe;
+
+    std::ostringstream os;
+    os << "# " << c.runtimeInclude() << " -- everything in " << c.deck
+       << " that a SPARTA restart file\n"
+       << "# does not carry. Included by " << c.deck << " and by " << c.resumeDeck() << ".\n"
+       << kHeaderNote << "\n"
+       << "timestep           " << num(c.timestep_s) << "\n";
+
+    section(os, "Collisions and reflections: cupola 10% diffuse ONLY; wafer+nozzle specular");
+    os << "collide            vss mixAll data/o.vss\n"
+       << "surf_collide       sc_spec specular\n"
+       << "surf_collide       sc_diff diffuse " << num(c.T_surf_K) << " 0.9\n"
+       << "surf_modify        all     collide sc_spec\n"
+       << "surf_modify        cupGrp  collide sc_diff\n";
+
+    section(os, "Unit helpers & constants");
+    os << "variable           kB            equal 1.380649e-23\n"
+       << "variable           Torr2Pa       equal 133.32236842105263\n"
+       << "variable           Pa2Torr       equal 7.500616827e-3\n"
+       << "variable           pi            equal 3.141592653589793\n"
+       << "variable           mO            equal 2.66e-26\n"
+       << "variable           mH2O          equal 2.9915e-26\n";
+
+    section(os, "User-tunable knobs (overridable via -var); Fwafer_cm2s comes from params.inc");
+    os << "variable           pTorrTarget   index 1.0e-7\n"
+       << "variable           Pcup_Torr     index 9.0e-9\n"
+       << "variable           runID         index run_default\n";
+
+    section(os, "Freestream inflow (target ambient)");
+    os << "variable           pInf          equal ${Torr2Pa}*${pTorrTarget}\n"
+       << "variable           nInf          equal ${pInf}/(${kB}*${Tgas})\n"
+       << "variable           FNUM          equal " << num(c.fnum) << "\n"
+       << "global             fnum ${FNUM}\n"
+       << "mixture            mixWake nrho ${nInf}\n"
+       << "fix                in emit/face mixWake xlo\n";
+
+    section(os, "Cupola outgassing using WSF-style flux target (H2O)");
+    os << "variable           Gcup           equal 0.078811435\n"
+       << "variable           kGauge         equal 2.63e-21\n"
+       << "variable           Qcup_cm2s      equal ${Pcup_Torr}/(${kGauge}*${Gcup})\n"
+       << "variable           Qcup_m2s       equal ${Qcup_cm2s}*1.0e4\n"
+       << "variable           Tsurf          equal " << num(c.T_surf_K) << "\n"
+       << "variable           cbar_cup       equal sqrt(8.0*${kB}*${Tsurf}/(${pi}*${mH2O}))\n"
+       << "variable           nrho_cup       equal 4.0*${Qcup_m2s}/${cbar_cup}\n"
+       << "mixture            mixCup  H2O  temp ${Tsurf} nrho ${nrho_cup}\n"
+       << "fix                cup_emit  emit/surf  mixCup  cupGrp  normal yes\n";
+
+    section(os, "Lambertian effusion (MBE) -- O");
+    os << "variable           x_orif        equal " << num(c.x_orifice_m) << "\n"
+       << "variable           x_wafer       equal " << num(c.x_wafer_m) << "\n"
+       << "variable           d_orif_wafer  equal ${x_wafer}-${x_orif}\n"
+       << "variable           D_orif        equal " << num(c.D_orifice_m) << "\n"
+       << "variable           R_orif        equal 0.5*${D_orif}\n"
+       << "variable           A_orif        equal ${pi}*${R_orif}*${R_orif}\n"
+       << "variable           Tbeam         equal " << num(c.T_beam_K) << "\n"
+       << "variable           cbar_beam     equal sqrt(8.0*${kB}*${Tbeam}/(${pi}*${mO}))\n\n"
+       << "# Fwafer_cm2s / mbe_active derived quantities; re-run on the live\n"
+       << "# instance by WakeChamber::setHotParameters.\n"
+       << "include            " << c.hot_include << "\n"
+       << "fix                mbe_emit emit/surf mixMBE mbeNozzleGrp normal yes\n";
+
+    section(os, csv ? "Probes" : "Probes (wake probe only: no probe CSV requested)");
+    for (const DeckProbe& p : probes) {
+        os << "region   probe_" << lower(p.name) << " block" << box(p.box) << "\n"
+           << "group    g" << p.name << "Pt grid region probe_" << lower(p.name) << " one\n";
+    }
+
+    section(os, "Cadence: one block = one harness --sparta-block");
+    os << "variable           block          equal " << c.block_steps << "\n"
+       << "variable           tick           equal floor(step/${block})*" << c.ticks_per_block << "\n"
+       << "variable           dt_tick_s      equal " << num(c.dt_tick_s) << "\n"
+       << "variable           phys_time_s    equal v_tick*${dt_tick_s}\n";
+    if (csv) {
+        os << "variable           orbit_real_s   equal 5640.0\n"
+           << "variable           theta_orbit    equal 2.0*${pi}*v_phys_time_s/${orbit_real_s}\n"
+           << "variable           cup_scale      equal 0.5*(1.0+sin(v_theta_orbit))\n";
+    }
+
+    section(os, "Thermo computes (pressure = n k_B T, mixAll)");
+    for (const DeckProbe& p : probes) {
+        os << "compute            t" << p.name << "Pt thermal/grid g" << p.name << "Pt mixAll temp press\n";
+    }
+    os << "compute            T" << W << "Pt reduce ave c_t" << W << "Pt[1]\n"
+       << "compute            n" << W << "All grid g" << W << "Pt mixAll nrho\n"
+       << "compute            n" << W << "Pt reduce ave c_n" << W << "All[1]\n\n"
+       << "# In-process probes read by WakeChamber::tick() (ENABLE_SPARTA builds)\n"
+       << "variable           wake_temp_K  equal c_T" << W << "Pt\n"
+       << "variable           wake_nrho_m3 equal c_n" << W << "Pt\n";
+
+    if (csv) {
+        for (const DeckProbe& p : probes) {
+            os << "compute            p" << p.name << "Pt reduce ave c_t" << p.name << "Pt[2]\n";
+        }
+    }
+    if (rga) {
+        os << "\n# RGA: p_s = n_s kB T at the wake probe\n"
+           << "compute            n" << W << "RGA grid g" << W << "Pt mixRGA nrho\n";
+        const char* species[] = {"O", "N2", "He", "H2O"};
+        for (int s = 0; s < 4; ++s) {
+            os << "compute            n" << W << "_" << species[s] << " reduce ave c_n" << W << "RGA[" << (s + 1) << "]\n";
+        }
+        for (const char* sp : species) {
+            os << "variable           p" << sp << "_nowPa equal c_n" << W << "_" << sp << "*${kB}*c_T" << W << "Pt\n";
+        }
+    }
+
+    os << "\n# Initialize (0 steps) so everything is defined.\n"
+       << "run                0\n";
+
+    if (csv) {
+        section(os, "Averaging over the CSV window (csv_every_blocks blocks)");
+        std::string cols = "${tick},${phys_time_s}";
+        std::string header = "tick,time_s_phys";
+        for (const DeckProbe& p : probes) {
+            const std::string up = p.name;
+            os << "fix                avg" << up << " ave/time " << avg << " c_p" << up << "Pt\n"
+               << "variable           P_" << up << "_Torr equal v_Pa2Torr*f_avg" << up << "\n";
+            cols += ",${P_" + up + "_Torr}";
+            header += ",p_" + lower(up) + "_Torr";
+        }
+        os << "fix                avgCupEmit  ave/time " << avg << " f_cup_emit[1]\n"
+           << "variable           CUP_EMIT_real_per_s equal f_avgCupEmit*${FNUM}/dt\n\n"
+           << "# Columns (no header; the deck is reloaded between jobs and only appends):\n"
+           << "#   " << header << ",cup_scale_frac,cup_emit_real_per_s,Fwafer_log_cm2s,mbe_active\n"
+           << "fix out print " << window << " \"" << cols
+           << ",${cup_scale},${CUP_EMIT_real_per_s},${Fwafer_log_cm2s},${mbe_active}\" append ../data/raw/${runID}/wake_4probes.csv screen no\n";
+        if (rga) {
+            const char* species[] = {"O", "N2", "He", "H2O"};
+            std::string rcols = "${tick},${phys_time_s}", sum;
+            for (const char* sp : species) {
+                os << "fix                avg_p" << sp << " ave/time " << avg << " v_p" << sp << "_nowPa\n"
+                   << "variable           P_" << W << "_" << sp << "_Torr equal v_Pa2Torr*f_avg_p" << sp << "\n";
+                rcols += std::string(",${P_") + W + "_" + sp + "_Torr}";
+                sum += std::string(sum.empty() ? "" : "+") + "v_P_" + W + "_" + sp + "_Torr";
+            }
+            os << "variable           P_" << W << "_RGA_SUM_Torr equal " << sum << "\n\n"
+               << "# Columns: tick,time_s_phys,p_O_Torr,p_N2_Torr,p_He_Torr,p_H2O_Torr,p_sum_Torr,p_total_Torr\n"
+               << "fix rga_out print " << window << " \"" << rcols << ",${P_" << W << "_RGA_SUM_Torr},${P_" << W
+               << "_Torr}\" append ../data/raw/${runID}/residualGasAnalyzer.csv screen no\n";
+        }
+    }
+
+    if (c.diag_csv) {
+        section(os, "External-process shim: WakeChamber tails data/tmp/wake_diag.csv");
+        os << "variable           diag_step equal step\n"
+           << "variable           diag_time equal time\n"
+           << "fix diag_out print " << c.block_steps
+           << " \"${diag_step},${diag_time},${wake_temp_K},${wake_nrho_m3}\" file data/tmp/wake_diag.csv"
+           << " screen no title \"step,time,temp_K,density_m3\"\n";
+    }
+
+    if (c.wafer_flux) {
+        section(os, "Wafer flux per surface element, read in place by WakeChamber (--wafer-flux)");
+        os << "compute            waferFlux surf waferGrp mixMBE nflux\n"
+           << "fix                " << c.wafer_flux_fix << " ave/surf waferGrp " << c.sample_every << " "
+           << c.block_steps / c.sample_every << " " << c.block_steps << " c_waferFlux\n";
+    }
+
+    section(os, "Stepping is driven by the harness ('run N' per block)");
+    os << "stats              " << static_cast<long>(c.block_steps) * c.stats_every_blocks << "\n"
+       << "variable           maxSteps index 0\n";
+    return os.str();
+}
+
+// ---------------- resume deck ----------------
+
+std::string DeckBuilder::resumeText() const {
+    std::ostringstream os;
+    os << "# --- Wake deck reload from an in-run restart snapshot (" << cfg_.deck << ") ---\n"
+       << kHeaderNote
+       << "# Issued by WakeChamber instead of " << cfg_.deck << " once a snapshot exists;\n"
+       << "# the harness defines wake_snapshot (restart file path) before running it.\n\n"
+       << "include            params.inc\n"
+       << "read_restart       ${wake_snapshot}\n\n"
+       << "include            " << cfg_.runtimeInclude() << "\n";
+    return os.str();
+}
+
+// ---------------- files ----------------
+
+std::vector<std::string> DeckBuilder::write(const std::string& input_dir) const {
+    const std::pair<std::string, std::string> files[] = {
+        {cfg_.deck, deckText()},
+        {cfg_.runtimeInclude(), runtimeText()},
+        {cfg_.resumeDeck(), resumeText()},
+    };
+    std::vector<std::string> written;
+    for (const auto& f : files) {
+        const fs::path path = fs::path(input_dir) / f.first;
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (in) {
+                std::ostringstream cur;
+                cur << in.rdbuf();
+                if (cur.str() == f.second) continue;
+            }
+        }
+        // Write-then-rename, so a concurrent reader never sees half a deck.
+        const fs::path tmp = path.string() + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error("DeckBuilder: cannot write " + tmp.string());
+            out << f.second;
+            if (!out) throw std::runtime_error("DeckBuilder: failed while writing " + tmp.string());
+        }
+        fs::rename(tmp, path);
+        written.push_back(path.string());
+    }
+    return written;
+}
+
+namespace {
+
+// Cells after refinement, and the largest split of any one coarse cell.
+void refine_scan(const WakeDeckConfig& c, std::size_t& total, std::size_t& max_split) {
+    std::array<double, 3> h;
+    for (int k = 0; k < 3; ++k) h[k] = (c.domain.hi[k] - c.domain.lo[k]) / c.grid[k];
+
+    total = 0;
+    max_split = 1;
+    for (int i = 0; i < c.grid[0]; ++i) {
+        for (int j = 0; j < c.grid[1]; ++j) {
+            for (int k = 0; k < c.grid[2]; ++k) {
+                const std::array<double, 3> lo{{c.domain.lo[0] + i * h[0], c.domain.lo[1] + j * h[1],
+                                                c.domain.lo[2] + k * h[2]}};
+                const std::array<double, 3> hi{{lo[0] + h[0], lo[1] + h[1], lo[2] + h[2]}};
+                std::size_t n = 1;
+                for (const DeckRefineRegion& r : c.refine) {
+                    if (overlaps(r.box, lo, hi)) n *= static_cast<std::size_t>(r.cells) * r.cells * r.cells;
+                }
+                total += n;
+                max_split = std::max(max_split, n);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+std::size_t DeckBuilder::estimatedCells() const {
+    std::size_t total = 0, max_split = 1;
+    refine_scan(cfg_, total, max_split);
+    return total;
+}
+
+std::size_t DeckBuilder::uniformEquivalentCells() const {
+    std::size_t total = 0, max_split = 1;
+    refine_scan(cfg_, total, max_split);
+    std::size_t n = max_split;
+    for (int k = 0; k < 3; ++k) n *= static_cast<std::size_t>(cfg_.grid[k]);
+    return n;
+}
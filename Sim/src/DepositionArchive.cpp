@@ -0,0 +1,283 @@
+#include "DepositionArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if SF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'F', 'D', 'E', 'P', 'A', 'R', '\0'};
+
+struct ArchiveHeader {
+  char          magic[8];
+  std::uint32_t version;
+  std::uint32_t count;
+  std::uint64_t toc_offset;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(ArchiveHeader) == 32, "archive header must stay 32 bytes");
+
+std::uint32_t crc_table_entry(std::uint32_t c) {
+  for (int k = 0; k < 8; ++k) c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+  return c;
+}
+
+struct CrcTable {
+  std::uint32_t t[256];
+  CrcTable() { for (std::uint32_t i = 0; i < 256; ++i) t[i] = crc_table_entry(i); }
+};
+
+void write_all(std::FILE* fp, const void* p, std::size_t n) {
+  if (n && std::fwrite(p, 1, n, fp) != n) {
+    throw std::runtime_error("DepositionArchiveWriter: write failed");
+  }
+}
+
+} // namespace
+
+bool depositionArchiveHasDeflate() {
+#if SF_HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::uint32_t depositionArchiveCrc32(const void* data, std::size_t n) {
+  static const CrcTable table;
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  std::uint32_t c = 0xFFFFFFFFu;
+  for (std::size_t i = 0; i < n; ++i) c = table.t[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
+  return c ^ 0xFFFFFFFFu;
+}
+
+// ---------------- DepositionArchiveWriter ----------------
+
+DepositionArchiveWriter::~DepositionArchiveWriter() {
+  try { close(); } catch (...) {}
+}
+
+void DepositionArchiveWriter::open(const std::string& path) {
+  close();
+  fp_ = std::fopen(path.c_str(), "wb");
+  if (!fp_) throw std::runtime_error("DepositionArchiveWriter: cannot open " + path);
+  toc_.clear();
+
+  ArchiveHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kDepositionArchiveVersion;
+  write_all(fp_, &h, sizeof(h));
+}
+
+void DepositionArchiveWriter::add(int job, int wafer, double time_s,
+                                  const DepositionMap& map, DepositionEncoding enc) {
+  if (!fp_) throw std::runtime_error("DepositionArchiveWriter: not open");
+  if (map.N <= 0 || map.bins.size() != static_cast<std::size_t>(map.N) * map.N) {
+    throw std::runtime_error("DepositionArchiveWriter: malformed map");
+  }
+
+  // 8-byte aligned payloads keep mmap'd Float64 views aligned.
+  long pos = std::ftell(fp_);
+  static const unsigned char zeros[8] = {};
+  if (pos % 8) {
+    write_all(fp_, zeros, 8 - static_cast<std::size_t>(pos % 8));
+    pos = std::ftell(fp_);
+  }
+
+  std::vector<unsigned char> buf;
+  const void*  payload = map.bins.data();
+  std::size_t  bytes   = map.bins.size() * sizeof(double);
+
+  if (enc == DepositionEncoding::Float32) {
+    buf.resize(map.bins.size() * sizeof(float));
+    float* f = reinterpret_cast<float*>(buf.data());
+    for (std::size_t i = 0; i < map.bins.size(); ++i) f[i] = static_cast<float>(map.bins[i]);
+    payload = buf.data();
+    bytes   = buf.size();
+  } else if (enc == DepositionEncoding::Deflate) {
+#if SF_HAVE_ZLIB
+    uLongf out_len = compressBound(static_cast<uLong>(bytes));
+    buf.resize(out_len);
+    if (compress2(buf.data(), &out_len, static_cast<const Bytef*>(payload),
+                  static_cast<uLong>(bytes), Z_DEFAULT_COMPRESSION) != Z_OK) {
+      throw std::runtime_error("DepositionArchiveWriter: compression failed");
+    }
+    buf.resize(out_len);
+    payload = buf.data();
+    bytes   = buf.size();
+#else
+    throw std::runtime_error("DepositionArchiveWriter: built without zlib (Deflate unavailable)");
+#endif
+  }
+
+  DepositionArchiveEntry e{};
+  e.job          = job;
+  e.wafer        = wafer;
+  e.time_s       = time_s;
+  e.N            = map.N;
+  e.encoding     = static_cast<std::uint8_t>(enc);
+  e.radius       = map.radius;
+  e.offset       = static_cast<std::uint64_t>(pos);
+  e.stored_bytes = bytes;
+  e.crc32        = depositionArchiveCrc32(payload, bytes);
+
+  write_all(fp_, payload, bytes);
+  toc_.push_back(e);
+}
+
+void DepositionArchiveWriter::close() {
+  if (!fp_) return;
+
+  std::FILE* fp = fp_;
+  fp_ = nullptr;
+
+  ArchiveHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version    = kDepositionArchiveVersion;
+  h.count      = static_cast<std::uint32_t>(toc_.size());
+  long pos = std::ftell(fp);
+  static const unsigned char zeros[8] = {};
+  if (pos % 8) {
+    std::fwrite(zeros, 1, 8 - static_cast<std::size_t>(pos % 8), fp);
+    pos = std::ftell(fp);
+  }
+  h.toc_offset = static_cast<std::uint64_t>(pos);
+
+  const bool ok =
+      std::fwrite(toc_.data(), sizeof(DepositionArchiveEntry), toc_.size(), fp) == toc_.size() &&
+      std::fseek(fp, 0, SEEK_SET) == 0 &&
+      std::fwrite(&h, sizeof(h), 1, fp) == 1;
+  const bool closed = std::fclose(fp) == 0;
+  toc_.clear();
+  if (!ok || !closed) throw std::runtime_error("DepositionArchiveWriter: failed to finalize archive");
+}
+
+// ---------------- DepositionArchiveReader ----------------
+
+DepositionArchiveReader::~DepositionArchiveReader() {
+  close();
+}
+
+void DepositionArchiveReader::close() {
+  if (base_) munmap(const_cast<unsigned char*>(base_), len_);
+  base_ = nullptr;
+  len_  = 0;
+  toc_  = nullptr;
+  ntoc_ = 0;
+}
+
+void DepositionArchiveReader::open(const std::string& path) {
+  close();
+
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("DepositionArchiveReader: cannot open " + path);
+
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(ArchiveHeader))) {
+    ::close(fd);
+    throw std::runtime_error("DepositionArchiveReader: truncated archive " + path);
+  }
+  void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::runtime_error("DepositionArchiveReader: mmap failed for " + path);
+
+  base_ = static_cast<const unsigned char*>(p);
+  len_  = static_cast<std::size_t>(st.st_size);
+
+  ArchiveHeader h;
+  std::memcpy(&h, base_, sizeof(h));
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+      h.version != kDepositionArchiveVersion) {
+    close();
+    throw std::runtime_error("DepositionArchiveReader: bad magic or version in " + path);
+  }
+  const std::uint64_t toc_bytes = std::uint64_t(h.count) * sizeof(DepositionArchiveEntry);
+  if (h.toc_offset < sizeof(ArchiveHeader) || h.toc_offset + toc_bytes > len_) {
+    close();
+    throw std::runtime_error("DepositionArchiveReader: missing or truncated TOC in " + path);
+  }
+
+  toc_  = reinterpret_cast<const DepositionArchiveEntry*>(base_ + h.toc_offset);
+  ntoc_ = h.count;
+
+  for (std::size_t i = 0; i < ntoc_; ++i) {
+    if (toc_[i].offset + toc_[i].stored_bytes > h.toc_offset || toc_[i].N <= 0) {
+      close();
+      throw std::runtime_error("DepositionArchiveReader: corrupt TOC entry in " + path);
+    }
+  }
+}
+
+long DepositionArchiveReader::find(int job, int wafer, double time_s) const {
+  long best = -1;
+  for (std::size_t i = 0; i < ntoc_; ++i) {
+    const DepositionArchiveEntry& e = toc_[i];
+    if (e.job != job || e.wafer != wafer || e.time_s > time_s) continue;
+    if (best < 0 || e.time_s >= toc_[best].time_s) best = static_cast<long>(i);
+  }
+  return best;
+}
+
+const double* DepositionArchiveReader::view(std::size_t i) const {
+  if (i >= ntoc_ || toc_[i].encoding != static_cast<std::uint8_t>(DepositionEncoding::Float64)) {
+    return nullptr;
+  }
+  return reinterpret_cast<const double*>(base_ + toc_[i].offset);
+}
+
+bool DepositionArchiveReader::verify(std::size_t i) const {
+  if (i >= ntoc_) return false;
+  return depositionArchiveCrc32(base_ + toc_[i].offset, toc_[i].stored_bytes) == toc_[i].crc32;
+}
+
+void DepositionArchiveReader::load(std::size_t i, DepositionMap& map) const {
+  if (i >= ntoc_) throw std::runtime_error("DepositionArchiveReader: index out of range");
+  if (!verify(i)) throw std::runtime_error("DepositionArchiveReader: checksum mismatch");
+
+  const DepositionArchiveEntry& e = toc_[i];
+  const std::size_t cells = static_cast<std::size_t>(e.N) * static_cast<std::size_t>(e.N);
+  const unsigned char* src = base_ + e.offset;
+
+  map.N      = e.N;
+  map.radius = e.radius;
+  map.bins.assign(cells, 0.0);
+
+  switch (static_cast<DepositionEncoding>(e.encoding)) {
+  case DepositionEncoding::Float64:
+    if (e.stored_bytes != cells * sizeof(double)) break;
+    std::memcpy(map.bins.data(), src, e.stored_bytes);
+    return;
+  case DepositionEncoding::Float32: {
+    if (e.stored_bytes != cells * sizeof(float)) break;
+    for (std::size_t k = 0; k < cells; ++k) {
+      float f;
+      std::memcpy(&f, src + k * sizeof(float), sizeof(float));
+      map.bins[k] = f;
+    }
+    return;
+  }
+  case DepositionEncoding::Deflate: {
+#if SF_HAVE_ZLIB
+    uLongf out_len = static_cast<uLongf>(cells * sizeof(double));
+    if (uncompress(reinterpret_cast<Bytef*>(map.bins.data()), &out_len, src,
+                   static_cast<uLong>(e.stored_bytes)) == Z_OK &&
+        out_len == cells * sizeof(double)) {
+      return;
+    }
+    break;
+#else
+    throw std::runtime_error("DepositionArchiveReader: built without zlib (Deflate unavailable)");
+#endif
+  }
+  }
+  throw std::runtime_error("DepositionArchiveReader: failed to decode map");
+}
@@ -6,6 +6,8 @@
 #include <fstream>
 #include <limits>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace {
 constexpr double NM_PER_M = 1e9;
@@ -19,8 +21,88 @@ struct BinHeader {
   uint64_t count;      // N*N (for sanity)
 };
 
+// Hits per normalize/bin block (indices stay in L1) and the smallest batch
+// worth handing to a worker thread.
+constexpr std::size_t kHitBlock         = 2048;
+constexpr std::size_t kMinHitsPerThread = 1u << 16;
+
+// Same geometry as DepositionMap::addHit(): -1 marks a hit outside the disk
+// (or a NaN coordinate). The disk test comes first, so only in-disk values
+// reach the int conversion.
+void bin_block(const double* x, const double* y, std::size_t n,
+               int N, double radius, int32_t* idx) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const double nx = x[i] / radius;
+    const double ny = y[i] / radius;
+    if (!(nx*nx + ny*ny <= 1.0)) {
+      idx[i] = -1;
+      continue;
+    }
+    int ix = static_cast<int>((nx*0.5 + 0.5) * N);
+    int iy = static_cast<int>((ny*0.5 + 0.5) * N);
+    ix = ix < 0 ? 0 : (ix >= N ? N-1 : ix);
+    iy = iy < 0 ? 0 : (iy >= N ? N-1 : iy);
+    idx[i] = iy * N + ix;
+  }
+}
+
+void accumulate(const double* x, const double* y, const double* w,
+                std::size_t n, int N, double radius, double* out) {
+  int32_t idx[kHitBlock];
+  for (std::size_t b = 0; b < n; b += kHitBlock) {
+    const std::size_t m = std::min(kHitBlock, n - b);
+    bin_block(x + b, y + b, m, N, radius, idx);
+    if (w) {
+      for (std::size_t i = 0; i < m; ++i) {
+        if (idx[i] >= 0) out[idx[i]] += w[b + i];
+      }
+    } else {
+      for (std::size_t i = 0; i < m; ++i) {
+        if (idx[i] >= 0) out[idx[i]] += 1.0;
+      }
+    }
+  }
+}
+
 } // namespace
 
+void DepositionMap::addHits(const double* x, const double* y, const double* w,
+                            std::size_t n, int threads) {
+  if (n == 0 || N <= 0) return;
+  if (!x || !y) throw std::invalid_argument("DepositionMap::addHits: null x/y");
+
+  std::size_t nt = threads > 0 ? static_cast<std::size_t>(threads)
+                               : std::max(1u, std::thread::hardware_concurrency());
+  nt = std::min(nt, std::max<std::size_t>(1, n / kMinHitsPerThread));
+
+  if (nt == 1) {
+    accumulate(x, y, w, n, N, radius, bins.data());
+    return;
+  }
+
+  // Worker 0 writes straight into bins; the others into private partials.
+  const std::size_t cells = bins.size();
+  std::vector<std::vector<double>> partial(nt - 1, std::vector<double>(cells, 0.0));
+  std::vector<std::thread> pool;
+  pool.reserve(nt - 1);
+
+  const std::size_t per = (n + nt - 1) / nt;
+  for (std::size_t t = 1; t < nt; ++t) {
+    const std::size_t b = std::min(n, t * per);
+    const std::size_t e = std::min(n, b + per);
+    pool.emplace_back([=, &partial]() {
+      accumulate(x + b, y + b, w ? w + b : nullptr, e - b, N, radius,
+                 partial[t - 1].data());
+    });
+  }
+  accumulate(x, y, w, std::min(n, per), N, radius, bins.data());
+
+  for (auto& th : pool) th.join();
+  for (const auto& p : partial) {
+    for (std::size_t c = 0; c < cells; ++c) bins[c] += p[c];
+  }
+}
+
 void DepositionMap::toThickness(double mass_per_particle_kg,
                                 double rho_kg_per_m3,
                                 double cellArea_m2) {
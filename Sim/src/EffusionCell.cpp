@@ -2,13 +2,15 @@
 #include "EffusionCell.hpp"
 #include "Logger.hpp"
 #include "WakeChamber.hpp"
+#include "Checkpoint.hpp"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
-
-// Avoid duplicate logs per process if tick() is called twice on one rank.
-static int s_last_logged_tick = -1;
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 // Gate streaks are computed in main.cpp and mirrored here so they appear in
 // EffusionCell.csv without changing the logger call sites there.
@@ -29,53 +31,55 @@ void EffusionCell::initialize() {
     target_temp_K_         = temperature_;
     last_pushed_temp_      = temperature_;
 
+    // "substeps" only under the stable integrator; euler keeps the
+    // historical header.
+    std::vector<std::string> columns = {
+        "status",
+        "act_temp_K",
+        "target_temp_K",
+        "T_env_eff_K",
+        "solar_scale",
+        "P_solar_abs_W",
+        "heatInput_w",
+        "underflux_streak",
+        "temp_miss_streak",
+        "P_loss_W",
+        "P_net_W",
+        "C_J",
+        "h_WK"
+    };
+    if (integrator_.kind() == ThermalIntegratorKind::Stable) columns.push_back("substeps");
+    log_ = Logger::instance().registerSchema("EffusionCell", columns);
+
     // Initialize the orbit-aware environment using the current solar scale.
     // main.cpp will update this each tick before source demand is computed.
     setOrbitThermalEnvironment(solar_scale_);
 }
 
 void EffusionCell::tick(const TickContext& ctx) {
-    // De-duplicate logging on this process in case tick() is invoked twice.
-    if (ctx.tick_index == s_last_logged_tick) {
+    // De-duplicate logging in case tick() is invoked twice for one tick.
+    if (ctx.tick_index == last_logged_tick_) {
         return;
     }
-    s_last_logged_tick = ctx.tick_index;
-
-    Logger::instance().log_wide(
-        "EffusionCell",
-        ctx.tick_index,
-        ctx.time,
-        {
-            "status",
-            "act_temp_K",
-            "target_temp_K",
-            "T_env_eff_K",
-            "solar_scale",
-            "P_solar_abs_W",
-            "heatInput_w",
-            "underflux_streak",
-            "temp_miss_streak",
-            "P_loss_W",
-            "P_net_W",
-            "C_J",
-            "h_WK"
-        },
-        {
-            1.0,
-            temperature_,
-            target_temp_K_,
-            ambient_temp_K_,
-            solar_scale_,
-            solar_absorbed_power_W_,
-            heat_input_w_,
-            static_cast<double>(g_underflux_streak_for_log),
-            static_cast<double>(g_temp_miss_streak_for_log),
-            last_p_loss_W_,
-            last_net_W_,
-            c_j_per_k_,
-            h_w_per_k_
-        }
-    );
+    last_logged_tick_ = ctx.tick_index;
+
+    const double row[] = {
+        1.0,
+        temperature_,
+        target_temp_K_,
+        ambient_temp_K_,
+        solar_scale_,
+        solar_absorbed_power_W_,
+        heat_input_w_,
+        static_cast<double>(g_underflux_streak_for_log),
+        static_cast<double>(g_temp_miss_streak_for_log),
+        last_p_loss_W_,
+        last_net_W_,
+        c_j_per_k_,
+        h_w_per_k_,
+        static_cast<double>(integrator_.lastSubsteps())
+    };
+    log_.write(ctx.tick_index, ctx.time, row, log_.width());
 
     // Optionally push the current actual source temperature into SPARTA at a
     // limited cadence when the temperature has changed enough to matter.
@@ -95,6 +99,32 @@ void EffusionCell::shutdown() {
     // No special shutdown rows are needed.
 }
 
+void EffusionCell::saveState(CheckpointWriter& ckpt) const {
+    ckpt.setDoubles(name_ + ".thermal",
+                    {temperature_, target_temp_K_, last_heat_W_, heat_input_w_,
+                     last_p_loss_W_, last_net_W_, ambient_temp_K_, solar_scale_,
+                     solar_absorbed_power_W_, last_pushed_temp_});
+    ckpt.setInt(name_ + ".last_logged_tick", last_logged_tick_);
+}
+
+void EffusionCell::loadState(const CheckpointReader& ckpt) {
+    const std::vector<double> v = ckpt.getDoubles(name_ + ".thermal");
+    if (v.size() != 10) {
+        throw std::runtime_error("EffusionCell: malformed checkpoint state");
+    }
+    temperature_            = v[0];
+    target_temp_K_          = v[1];
+    last_heat_W_            = v[2];
+    heat_input_w_           = v[3];
+    last_p_loss_W_          = v[4];
+    last_net_W_             = v[5];
+    ambient_temp_K_         = v[6];
+    solar_scale_            = v[7];
+    solar_absorbed_power_W_ = v[8];
+    last_pushed_temp_       = v[9];
+    last_logged_tick_       = static_cast<int>(ckpt.getInt(name_ + ".last_logged_tick"));
+}
+
 void EffusionCell::setOrbitThermalEnvironment(double solar_scale) {
     double s = solar_scale;
     if (!std::isfinite(s)) {
@@ -122,6 +152,15 @@ void EffusionCell::setOrbitThermalEnvironment(double solar_scale) {
     }
 }
 
+void EffusionCell::idleBandK(double& lo_K, double& hi_K) const {
+    // Unheated steady state of the RC node: h (T - T_amb) = P_solar_abs.
+    const double p_sun_W =
+        solar_absorptivity_ * projected_area_m2_ * solar_constant_W_m2_;
+    lo_K = night_ambient_temp_K_;
+    hi_K = day_ambient_temp_K_ + p_sun_W / h_w_per_k_;
+    if (hi_K < lo_K) std::swap(lo_K, hi_K);
+}
+
 void EffusionCell::applyHeat(double watts, double dt) {
     const double pin_W  = std::max(0.0, watts);
     const double dt_pos = std::max(0.0, dt);
@@ -139,8 +178,17 @@ void EffusionCell::applyHeat(double watts, double dt) {
     last_p_loss_W_ = h_w_per_k_ * (temperature_ - ambient_temp_K_);
     last_net_W_    = pin_W + solar_absorbed_power_W_ - last_p_loss_W_;
 
-    const double dT_K = (last_net_W_ / c_j_per_k_) * dt_pos;
-    temperature_ += dT_K;
+    if (integrator_.kind() == ThermalIntegratorKind::Euler) {
+        const double dT_K = (last_net_W_ / c_j_per_k_) * dt_pos;
+        temperature_ += dT_K;
+    } else {
+        ThermalNode node;
+        node.C_J_per_K = c_j_per_k_;
+        node.h_W_per_K = h_w_per_k_;
+        node.T_env_K   = ambient_temp_K_;
+        node.P_in_W    = pin_W + solar_absorbed_power_W_;
+        temperature_ = integrator_.advance(node, temperature_, dt_pos);
+    }
 
     // Basic safety clamps.
     if (!std::isfinite(temperature_)) {
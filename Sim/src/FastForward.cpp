@@ -0,0 +1,113 @@
+#include "FastForward.hpp"
+
+#include "Battery.hpp"
+#include "EffusionCell.hpp"
+#include "PowerBus.hpp"
+#include "SimulationEngine.hpp"
+#include "SolarArray.hpp"
+#include "SubstrateHeater.hpp"
+#include "orbit.hpp"
+
+// Driven by main.cpp from the orbit model; left at the last skipped tick.
+extern double g_orbit_solar_scale;
+
+FastForward::FastForward(OrbitModel& orbit, SimulationEngine& engine, SolarArray& solar,
+                         PowerBus& bus, Battery& battery, EffusionCell& effusion,
+                         SubstrateHeater& substrate)
+    : orbit_(orbit), engine_(engine), solar_(solar), bus_(bus), battery_(battery),
+      effusion_(effusion), substrate_(substrate) {}
+
+void FastForward::configure(const FastForwardConfig& cfg) {
+    cfg_ = cfg;
+    if (!cfg_.enabled) return;
+
+    log_ = Logger::instance().registerSchema(
+        "FastForward",
+        {"first_tick", "ticks_skipped", "sun_ticks", "eclipse_ticks",
+         "eclipse_transitions", "solar_Wh", "base_load_Wh",
+         "battery_start_Wh", "battery_end_Wh",
+         "effusion_temp_K", "substrate_temp_K"});
+    if (cfg_.decimate > 0) {
+        samples_ = Logger::instance().registerSchema(
+            "FastForwardSamples",
+            {"t_orbit_s", "in_sun", "solar_scale", "solar_output_W",
+             "battery_charge_Wh", "effusion_temp_K", "substrate_temp_K"});
+    }
+}
+
+bool FastForward::thermallyIdle() const {
+    const double tol = cfg_.thermal_tol_K;
+
+    double lo = 0.0, hi = 0.0;
+    effusion_.idleBandK(lo, hi);
+    const double T_eff = effusion_.getTemperatureK();
+    if (T_eff < lo - tol || T_eff > hi + tol) return false;
+
+    substrate_.idleBandK(lo, hi);
+    const double T_sub = substrate_.substrateTempK();
+    return T_sub >= lo - tol && T_sub <= hi + tol;
+}
+
+FastForwardSpan FastForward::advance(int first_tick, int n, double dt) {
+    FastForwardSpan span;
+    span.first_tick = first_tick;
+    span.last_tick  = first_tick - 1;
+    if (n <= 0) return span;
+
+    span.last_tick        = first_tick + n - 1;
+    span.battery_start_Wh = battery_.getCharge();
+
+    const double base_load_W = engine_.baseLoadW();
+    bool was_in_sun = orbit_.state().in_sun;
+
+    // Same per-tick order as SimulationEngine::tick() with idle demands:
+    // generation, base load, passive thermal update, bus settlement.
+    for (int k = 1; k <= n; ++k) {
+        const OrbitState o = orbit_.stateAfter(k);
+        const int tick = first_tick + k - 1;
+        const TickContext ctx{ tick, tick * dt, dt };
+
+        if (o.in_sun) ++span.sun_ticks; else ++span.eclipse_ticks;
+        if (o.in_sun != was_in_sun) ++span.eclipse_transitions;
+        was_in_sun = o.in_sun;
+
+        effusion_.setOrbitThermalEnvironment(o.solar_scale);
+        substrate_.setOrbitThermalEnvironment(o.solar_scale);
+
+        const double solar_W = solar_.outputFor(o.solar_scale);
+        bus_.addPower(solar_W);
+        const double base_W = (base_load_W > 0.0) ? bus_.drawPower(base_load_W, ctx) : 0.0;
+
+        effusion_.applyHeat(0.0, dt);
+        substrate_.applyHeat(0.0, dt);
+
+        bus_.settleWithoutLog(dt);
+
+        span.solar_Wh     += solar_W * dt / 3600.0;
+        span.base_load_Wh += base_W * dt / 3600.0;
+
+        if (cfg_.decimate > 0 && k % cfg_.decimate == 0) {
+            samples_.write(tick, ctx.time,
+                           {o.t_orbit_s, o.in_sun ? 1.0 : 0.0, o.solar_scale, solar_W,
+                            battery_.getCharge(), effusion_.getTemperatureK(),
+                            substrate_.substrateTempK()});
+        }
+    }
+
+    orbit_.advance(n);
+    engine_.skipTicks(n);
+    g_orbit_solar_scale = orbit_.state().solar_scale;
+
+    span.battery_end_Wh = battery_.getCharge();
+    ++spans_;
+    ticks_skipped_ += n;
+
+    log_.write(span.last_tick, span.last_tick * dt,
+               {static_cast<double>(span.first_tick), static_cast<double>(n),
+                static_cast<double>(span.sun_ticks), static_cast<double>(span.eclipse_ticks),
+                static_cast<double>(span.eclipse_transitions),
+                span.solar_Wh, span.base_load_Wh,
+                span.battery_start_Wh, span.battery_end_Wh,
+                effusion_.getTemperatureK(), substrate_.substrateTempK()});
+    return span;
+}
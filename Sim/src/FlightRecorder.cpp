@@ -0,0 +1,290 @@
+// Sim/src/FlightRecorder.cpp
+#include "FlightRecorder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const kKindNames[] = {"mark ", "enter", "exit "};
+
+const int kSignals[] = {SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGTERM, SIGINT};
+constexpr int kNumSignals = sizeof(kSignals) / sizeof(kSignals[0]);
+struct sigaction g_prev[kNumSignals];
+
+std::atomic<int> g_next_tid{0};
+
+std::uint8_t thread_id() {
+    thread_local const int tid = g_next_tid.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<std::uint8_t>(std::min(tid, 255));
+}
+
+const char* signal_name(int sig) {
+    switch (sig) {
+        case SIGABRT: return "SIGABRT";
+        case SIGSEGV: return "SIGSEGV";
+        case SIGBUS:  return "SIGBUS";
+        case SIGFPE:  return "SIGFPE";
+        case SIGILL:  return "SIGILL";
+        case SIGTERM: return "SIGTERM";
+        case SIGINT:  return "SIGINT";
+        default:      return "signal";
+    }
+}
+
+void on_signal(int sig) {
+    FlightRecorder::instance().dump(signal_name(sig));
+    // Hand the signal to whatever was installed before us (MPI's handlers or
+    // the default action); it is delivered once this handler returns.
+    for (int k = 0; k < kNumSignals; ++k) {
+        if (kSignals[k] == sig) sigaction(sig, &g_prev[k], nullptr);
+    }
+    raise(sig);
+}
+
+// Fixed-buffer writer for the dump; only write(2), so usable from a signal
+// handler.
+class Out {
+public:
+    explicit Out(int fd) : fd_(fd) {}
+    ~Out() { flush(); }
+
+    Out& str(const char* s) {
+        if (!s) s = "?";
+        while (*s) put(*s++);
+        return *this;
+    }
+    Out& num(long long v) {
+        char tmp[24];
+        int  n = 0;
+        const bool neg = v < 0;
+        unsigned long long u = neg ? 0ULL - static_cast<unsigned long long>(v)
+                                   : static_cast<unsigned long long>(v);
+        do { tmp[n++] = static_cast<char>('0' + u % 10); u /= 10; } while (u);
+        if (neg) put('-');
+        while (n) put(tmp[--n]);
+        return *this;
+    }
+    Out& pad(long long v, int width) {
+        int digits = v < 0 ? 2 : 1;
+        for (long long t = v < 0 ? -v : v; t >= 10; t /= 10) ++digits;
+        for (; digits < width; ++digits) put(' ');
+        return num(v);
+    }
+    // Nanoseconds as seconds with microsecond resolution.
+    Out& sec(std::int64_t ns) {
+        if (ns < 0) { put('-'); ns = -ns; }
+        num(ns / 1000000000);
+        put('.');
+        const long long us = (ns / 1000) % 1000000;
+        for (long long d = 100000; d > 1 && us < d; d /= 10) put('0');
+        return num(us);
+    }
+    void flush() {
+        std::size_t off = 0;
+        while (off < n_) {
+            const ssize_t w = ::write(fd_, buf_ + off, n_ - off);
+            if (w <= 0) break;
+            off += static_cast<std::size_t>(w);
+        }
+        n_ = 0;
+    }
+
+private:
+    void put(char c) {
+        if (n_ == sizeof(buf_)) flush();
+        buf_[n_++] = c;
+    }
+
+    int         fd_;
+    char        buf_[8192];
+    std::size_t n_ = 0;
+};
+
+} // anonymous namespace
+
+FlightRecorder& FlightRecorder::instance() {
+    static FlightRecorder r;
+    return r;
+}
+
+void FlightRecorder::init(int rank, std::size_t capacity, const std::string& dumpDir) {
+    if (ready_.load(std::memory_order_acquire)) return;
+    std::size_t n = 16;
+    while (n < capacity) n <<= 1;
+    ring_.reset(new Slot[n]);
+    mask_    = n - 1;
+    rank_    = rank;
+    epochNs_ = nowNs();
+
+    std::string path = dumpDir.empty() ? std::string(".") : dumpDir;
+    // An early fatal can dump before the Logger has created the directory.
+    std::error_code ec;
+    std::filesystem::create_directories(path, ec);
+    path += "/flight_r" + std::to_string(rank) + ".txt";
+    std::strncpy(path_, path.c_str(), sizeof(path_) - 1);
+    ready_.store(true, std::memory_order_release);
+}
+
+void FlightRecorder::installSignalHandlers() {
+    for (int k = 0; k < kNumSignals; ++k) {
+        struct sigaction sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = on_signal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(kSignals[k], &sa, &g_prev[k]);
+    }
+}
+
+void FlightRecorder::record(Kind kind, int tick, const char* phase) noexcept {
+    if (!ready_.load(std::memory_order_acquire)) return;
+    const std::int64_t now = nowNs();
+    if (kind == Kind::Mark && tick != tick_.load(std::memory_order_relaxed)) {
+        tickStartNs_.store(now, std::memory_order_relaxed);
+        tick_.store(tick, std::memory_order_release);
+    }
+    const std::uint64_t i = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = ring_[i & mask_];
+    s.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.t_ns.store(now, std::memory_order_relaxed);
+    s.phase.store(phase, std::memory_order_relaxed);
+    s.tick.store(tick, std::memory_order_relaxed);
+    s.kind.store(static_cast<std::uint8_t>(kind), std::memory_order_relaxed);
+    s.tid.store(thread_id(), std::memory_order_relaxed);
+    s.seq.store(i + 1, std::memory_order_release);
+}
+
+void FlightRecorder::dump(const char* reason) noexcept {
+    if (!ready_.load(std::memory_order_acquire)) return;
+    if (dumping_.exchange(true, std::memory_order_acq_rel)) return;
+
+    const std::int64_t now   = nowNs();
+    const std::uint64_t head = head_.load(std::memory_order_acquire);
+    const std::uint64_t cap  = mask_ + 1;
+    const std::uint64_t first = head > cap ? head - cap : 0;
+    const int          tick  = tick_.load(std::memory_order_acquire);
+    const std::int64_t start = tickStartNs_.load(std::memory_order_relaxed);
+    const int          nth   = dumps_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // If the file cannot be opened the dump goes to stderr instead.
+    const int file     = ::open(path_, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    const int open_err = file < 0 ? errno : 0;
+    const int fd       = file >= 0 ? file : STDERR_FILENO;
+    {
+        Out o(fd);
+        o.str("==== flight recorder rank ").num(rank_).str(": ").str(reason)
+         .str(" (dump ").num(nth).str(") at t=").sec(now - epochNs_).str(" s ====\n");
+        o.str("tick ").num(tick).str(", running ").sec(start > 0 ? now - start : 0).str(" s");
+        if (deadlineNs_ > 0) o.str(" (watchdog deadline ").sec(deadlineNs_).str(" s)");
+        o.str("\n");
+
+        // Collectives entered but not left: walk back from the newest event,
+        // per thread, pairing each exit with the enter before it.
+        constexpr int kMaxThreads = 32, kMaxOpen = 8;
+        int  depth[kMaxThreads] = {0};
+        int  nopen[kMaxThreads] = {0};
+        std::uint64_t open[kMaxThreads][kMaxOpen];
+        bool last_done = false;
+        for (std::uint64_t i = head; i-- > first;) {
+            const Slot& s = ring_[i & mask_];
+            if (s.seq.load(std::memory_order_acquire) != i + 1) continue;
+            const int t    = std::min<int>(s.tid.load(std::memory_order_relaxed), kMaxThreads - 1);
+            const auto k   = static_cast<Kind>(s.kind.load(std::memory_order_relaxed));
+            if (!last_done) {
+                o.str("last event ").sec(now - s.t_ns.load(std::memory_order_relaxed))
+                 .str(" s ago: ").str(kKindNames[static_cast<int>(k)]).str(" ")
+                 .str(s.phase.load(std::memory_order_relaxed)).str(" [thread ").num(t).str("]\n");
+                last_done = true;
+            }
+            if (k == Kind::Exit) {
+                ++depth[t];
+            } else if (k == Kind::Enter) {
+                if (depth[t] > 0) --depth[t];
+                else if (nopen[t] < kMaxOpen) open[t][nopen[t]++] = i;
+            }
+        }
+        bool any_open = false;
+        for (int t = 0; t < kMaxThreads; ++t) {
+            for (int j = nopen[t]; j-- > 0;) {   // outermost first
+                const Slot& s = ring_[open[t][j] & mask_];
+                o.str("in: thread ").num(t).str(" ").str(s.phase.load(std::memory_order_relaxed))
+                 .str(" for ").sec(now - s.t_ns.load(std::memory_order_relaxed)).str(" s\n");
+                any_open = true;
+            }
+        }
+        if (!any_open) o.str("in: no open collective\n");
+
+        o.str("events ").num(static_cast<long long>(head - first)).str(" of ")
+         .num(static_cast<long long>(head)).str(" (oldest first): t_s tick thread kind phase\n");
+        for (std::uint64_t i = first; i < head; ++i) {
+            const Slot& s = ring_[i & mask_];
+            if (s.seq.load(std::memory_order_acquire) != i + 1) continue;
+            const std::int64_t t_ns  = s.t_ns.load(std::memory_order_relaxed);
+            const char*        phase = s.phase.load(std::memory_order_relaxed);
+            const int          tk    = s.tick.load(std::memory_order_relaxed);
+            const int          kind  = s.kind.load(std::memory_order_relaxed);
+            const int          tid   = s.tid.load(std::memory_order_relaxed);
+            if (s.seq.load(std::memory_order_acquire) != i + 1) continue;
+            o.str("  ").sec(t_ns - epochNs_).str(" ").pad(tk, 6).str(" ").pad(tid, 2).str(" ")
+             .str(kKindNames[kind < 3 ? kind : 0]).str(" ").str(phase).str("\n");
+        }
+        o.str("\n");
+        o.flush();
+    }
+    if (file >= 0) ::close(file);
+
+    Out e(STDERR_FILENO);
+    e.str("[flight] rank ").num(rank_).str(": ").str(reason).str(" at tick ").num(tick);
+    if (file >= 0) {
+        e.str(", recorder dumped to ").str(path_).str("\n");
+    } else {
+        e.str(", could not open ").str(path_).str(" (errno ").num(open_err)
+         .str("), recorder dumped to stderr above\n");
+    }
+    e.flush();
+
+    dumping_.store(false, std::memory_order_release);
+}
+
+void FlightRecorder::startWatchdog(double deadline_s) {
+    if (deadline_s <= 0.0 || watchdog_.joinable()) return;
+    deadlineNs_ = static_cast<std::int64_t>(deadline_s * 1e9);
+    {
+        std::lock_guard<std::mutex> lock(wdMtx_);
+        wdStop_ = false;
+    }
+    watchdog_ = std::thread([this] { watchdogLoop_(); });
+}
+
+void FlightRecorder::stopWatchdog() {
+    if (!watchdog_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(wdMtx_);
+        wdStop_ = true;
+    }
+    wdCv_.notify_all();
+    watchdog_.join();
+}
+
+void FlightRecorder::watchdogLoop_() {
+    const auto poll = std::chrono::nanoseconds(
+        std::clamp<std::int64_t>(deadlineNs_ / 10, 50000000, 1000000000));
+    std::int64_t dumpedStart = -1;
+
+    std::unique_lock<std::mutex> lock(wdMtx_);
+    while (!wdCv_.wait_for(lock, poll, [this] { return wdStop_; })) {
+        const std::int64_t start = tickStartNs_.load(std::memory_order_relaxed);
+        if (start <= 0 || start == dumpedStart) continue;   // once per tick
+        if (nowNs() - start > deadlineNs_) {
+            dump("tick exceeded the watchdog deadline");
+            dumpedStart = start;
+        }
+    }
+}
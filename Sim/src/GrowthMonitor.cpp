@@ -1,11 +1,16 @@
 #include "GrowthMonitor.hpp"
 #include "PowerBus.hpp"   // for drawPower()
+#include "DepositionMap.hpp"
+#include "Checkpoint.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <stdexcept>
+#include <string>
 
 namespace {
 namespace fs = std::filesystem;
@@ -52,6 +57,7 @@ GrowthMonitor::GrowthMonitor(int gridN)
       gridN_(gridN),
       waferRadiusCells_(0.5 * static_cast<double>(gridN) * 0.95)  // inside edge
 {
+    buildWaferMask();
 }
 
 
@@ -77,6 +83,72 @@ void GrowthMonitor::markJobAborted(int jobIndex) {
 }
 
 
+// -----------------------------------------------------------------------------
+// Flux profile
+// -----------------------------------------------------------------------------
+void GrowthMonitor::setFluxProfile(const DepositionMap& map) {
+    if (gridN_ <= 0) {
+        gridN_ = 32;
+    }
+    if (waferCells_.empty()) buildWaferMask();
+
+    if (map.N <= 0 || map.bins.size() != static_cast<std::size_t>(map.N) *
+                                         static_cast<std::size_t>(map.N)) {
+        clearFluxProfile();
+        return;
+    }
+
+    // Nearest-bin resample: both grids span the wafer diameter, so cell
+    // centre (c + 0.5) / gridN_ maps to the same fraction of map.N.
+    std::vector<double> w(waferCells_.size(), 0.0);
+    double sum = 0.0;
+    for (std::size_t k = 0; k < waferCells_.size(); ++k) {
+        const int r = static_cast<int>(waferCells_[k]) / gridN_;
+        const int c = static_cast<int>(waferCells_[k]) % gridN_;
+        int ix = static_cast<int>((c + 0.5) / gridN_ * map.N);
+        int iy = static_cast<int>((r + 0.5) / gridN_ * map.N);
+        ix = std::clamp(ix, 0, map.N - 1);
+        iy = std::clamp(iy, 0, map.N - 1);
+
+        const double v = map.bins[static_cast<std::size_t>(iy) * map.N + ix];
+        w[k] = (std::isfinite(v) && v > 0.0) ? v : 0.0;
+        sum += w[k];
+    }
+
+    if (!(sum > 0.0)) {
+        clearFluxProfile();
+        return;
+    }
+
+    const double scale = static_cast<double>(w.size()) / sum;
+    for (double& x : w) x *= scale;
+    fluxProfile_.swap(w);
+}
+
+bool GrowthMonitor::updateFluxProfile(const double* cell_flux, std::size_t n) {
+    if (!cell_flux || n == 0 || n != waferCells_.size()) return false;
+
+    double sum = 0.0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const double v = cell_flux[k];
+        if (std::isfinite(v) && v > 0.0) sum += v;
+    }
+    if (!(sum > 0.0)) return false;
+
+    const double scale = static_cast<double>(n) / sum;
+    fluxProfile_.resize(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        const double v = cell_flux[k];
+        fluxProfile_[k] = (std::isfinite(v) && v > 0.0) ? v * scale : 0.0;
+    }
+    return true;
+}
+
+void GrowthMonitor::clearFluxProfile() {
+    fluxProfile_.clear();
+}
+
+
 // -----------------------------------------------------------------------------
 // initialize(): now resolves CSV path into data/raw/{RUN_ID}
 // -----------------------------------------------------------------------------
@@ -97,6 +169,7 @@ void GrowthMonitor::initialize() {
 
     // Determine directory: follows Logger semantics
     fs::path base_dir = resolve_growthmonitor_base_dir();
+    if (!outputSubdir_.empty()) base_dir /= outputSubdir_;
 
     std::error_code ec;
     fs::create_directories(base_dir, ec);
@@ -106,23 +179,41 @@ void GrowthMonitor::initialize() {
     }
 
     // Full path: data/raw/{RUN_ID}/GrowthMonitor_{RUN_ID}.csv
-    csvFilename_ = (base_dir / ("GrowthMonitor_" + run_id + ".csv")).string();
+    csvFilename_     = (base_dir / ("GrowthMonitor_" + run_id + ".csv")).string();
+    archiveFilename_ = (base_dir / ("GrowthMonitor_" + run_id + ".sfw")).string();
+
+    // The archive itself is opened by the first archived job (or shutdown),
+    // so a resumed run can roll it back before anything truncates it.
 }
 
 
 // -----------------------------------------------------------------------------
 // tick()
 // -----------------------------------------------------------------------------
-void GrowthMonitor::tick(const TickContext& ctx) {
-    if (!isLeader_) return;
+bool GrowthMonitor::integratesThisTick_() const {
+    if (!isLeader_) return false;
+
+    if (activeJobIndex_ < 0) return false;
+    if (!mbeOn_) return false;
+    if (!std::isfinite(currentFwaferCm2s_) || currentFwaferCm2s_ <= 0.0) return false;
+    if (static_cast<std::size_t>(activeJobIndex_) >= jobs_.size()) return false;
+    return true;
+}
 
-    if (activeJobIndex_ < 0) return;
-    if (!mbeOn_) return;
-    if (!std::isfinite(currentFwaferCm2s_) || currentFwaferCm2s_ <= 0.0) return;
-    if (static_cast<std::size_t>(activeJobIndex_) >= jobs_.size()) return;
+void GrowthMonitor::postPowerRequests(const TickContext&) {
+    if (bus_ && monitorPowerW_ > 0.0 && integratesThisTick_()) {
+        powerTicket_ = bus_->postRequest(PowerPriority::Instrument, monitorPowerW_);
+    }
+}
+
+void GrowthMonitor::tick(const TickContext& ctx) {
+    if (!integratesThisTick_()) return;
 
-    // Draw monitor power (not tracked for now)
-    if (bus_ && monitorPowerW_ > 0.0) {
+    // Draw monitor power (not tracked for now); a batched request was
+    // already granted.
+    if (powerTicket_ >= 0) {
+        powerTicket_ = -1;
+    } else if (bus_ && monitorPowerW_ > 0.0) {
         (void)bus_->drawPower(monitorPowerW_, ctx);
     }
 
@@ -131,19 +222,137 @@ void GrowthMonitor::tick(const TickContext& ctx) {
 
 
 // -----------------------------------------------------------------------------
-// shutdown() — writes the CSV
+// finishJob() — archive one job as soon as the scheduler closes it
+// -----------------------------------------------------------------------------
+void GrowthMonitor::finishJob(int jobIndex) {
+    if (!isLeader_) return;
+    if (jobIndex < 0) return;
+    if (static_cast<std::size_t>(jobIndex) >= jobs_.size()) return;
+
+    const std::size_t j = static_cast<std::size_t>(jobIndex);
+    emitJob(j, jobs_[j].aborted ? WaferJobStatus::Aborted : WaferJobStatus::Done);
+}
+
+
+// -----------------------------------------------------------------------------
+// shutdown() — archives open jobs, then writes the CSV
 // -----------------------------------------------------------------------------
 void GrowthMonitor::shutdown() {
     if (!isLeader_) return;
-    writeCsv();
+
+    for (std::size_t j = 0; j < jobs_.size(); ++j) {
+        emitJob(j, jobs_[j].aborted ? WaferJobStatus::Aborted : WaferJobStatus::Unfinished);
+    }
+    openArchive();
+    archive_.close();
+
+    const char* csv_env = std::getenv("SF_WAFER_CSV");
+    if (!(csv_env && std::string(csv_env) == "0")) {
+        writeCsv();
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// Checkpoint state
+// -----------------------------------------------------------------------------
+void GrowthMonitor::saveState(CheckpointWriter& ckpt) const {
+    if (!isLeader_) return;
+
+    std::vector<int>    flags;
+    std::vector<double> t_end, uniform;
+    flags.reserve(3 * jobs_.size());
+    for (std::size_t j = 0; j < jobs_.size(); ++j) {
+        const JobAccum& job = jobs_[j];
+        flags.push_back(job.aborted ? 1 : 0);
+        flags.push_back(job.had_growth ? 1 : 0);
+        flags.push_back(job.emitted ? 1 : 0);
+        t_end.push_back(job.last_t_end_s);
+        uniform.push_back(job.uniform_dose);
+        if (!job.cell_dose.empty()) {
+            ckpt.setDoubles(name_ + ".cell_dose." + std::to_string(j), job.cell_dose);
+        }
+    }
+    ckpt.setInt(name_ + ".njobs", static_cast<std::int64_t>(jobs_.size()));
+    ckpt.setInts(name_ + ".job_flags", flags);
+    ckpt.setDoubles(name_ + ".job_t_end_s", t_end);
+    ckpt.setDoubles(name_ + ".job_uniform_dose", uniform);
+
+    ckpt.setInt(name_ + ".active_job", activeJobIndex_);
+    ckpt.setBool(name_ + ".mbe_on", mbeOn_);
+    ckpt.setDouble(name_ + ".Fwafer_cm2s", currentFwaferCm2s_);
+    ckpt.setDoubles(name_ + ".flux_profile", fluxProfile_);
+    ckpt.setBool(name_ + ".warned_late_dose", warnedLateDose_);
+    ckpt.setInt(name_ + ".archive_bytes",
+                static_cast<std::int64_t>(archive_.is_open() ? archive_.bytes() : 0));
+}
+
+void GrowthMonitor::loadState(const CheckpointReader& ckpt) {
+    if (!isLeader_) return;
+
+    const std::size_t n = static_cast<std::size_t>(ckpt.getInt(name_ + ".njobs"));
+    const std::vector<std::int64_t> flags = ckpt.getInts(name_ + ".job_flags");
+    const std::vector<double> t_end   = ckpt.getDoubles(name_ + ".job_t_end_s");
+    const std::vector<double> uniform = ckpt.getDoubles(name_ + ".job_uniform_dose");
+    // Branch mode continues with another schedule tail: rows past the
+    // shorter of the two schedules must not have been touched yet.
+    if (flags.size() != 3 * n || t_end.size() != n || uniform.size() != n) {
+        throw std::runtime_error("GrowthMonitor: malformed job state in checkpoint");
+    }
+    for (std::size_t j = jobs_.size(); j < n; ++j) {
+        if (flags[3 * j] || flags[3 * j + 1] || flags[3 * j + 2] ||
+            ckpt.has(name_ + ".cell_dose." + std::to_string(j))) {
+            throw std::runtime_error("GrowthMonitor: checkpoint has " + std::to_string(n) +
+                                     " job(s), this run has " + std::to_string(jobs_.size()));
+        }
+    }
+
+    for (std::size_t j = 0; j < std::min(n, jobs_.size()); ++j) {
+        JobAccum& job    = jobs_[j];
+        job.aborted      = flags[3 * j] != 0;
+        job.had_growth   = flags[3 * j + 1] != 0;
+        job.emitted      = flags[3 * j + 2] != 0;
+        job.last_t_end_s = t_end[j];
+        job.uniform_dose = uniform[j];
+        const std::string key = name_ + ".cell_dose." + std::to_string(j);
+        job.cell_dose = ckpt.has(key) ? ckpt.getDoubles(key) : std::vector<double>{};
+    }
+
+    activeJobIndex_    = static_cast<int>(ckpt.getInt(name_ + ".active_job"));
+    mbeOn_             = ckpt.getBool(name_ + ".mbe_on");
+    currentFwaferCm2s_ = ckpt.getDouble(name_ + ".Fwafer_cm2s");
+    fluxProfile_       = ckpt.getDoubles(name_ + ".flux_profile");
+    warnedLateDose_    = ckpt.getBool(name_ + ".warned_late_dose");
+
+    // Drop records archived after the checkpoint and keep appending.
+    const std::int64_t bytes = ckpt.getInt(name_ + ".archive_bytes");
+    archive_.close();
+    if (bytes > 0 && !archiveFilename_.empty()) {
+        std::error_code ec;
+        fs::resize_file(archiveFilename_, static_cast<std::uintmax_t>(bytes), ec);
+        if (ec) {
+            throw std::runtime_error("GrowthMonitor: cannot roll back " + archiveFilename_ +
+                                     " : " + ec.message());
+        }
+        archive_.openAppend(archiveFilename_, waferCells_.size());
+    }
 }
 
 
 // -----------------------------------------------------------------------------
 // Internal helpers
 // -----------------------------------------------------------------------------
+void GrowthMonitor::openArchive() {
+    if (archive_.is_open() || archiveFilename_.empty()) return;
+    try {
+        archive_.open(archiveFilename_, gridN_, waferCells_);
+    } catch (const std::exception& e) {
+        std::cerr << "[GrowthMonitor] " << e.what() << "\n";
+    }
+}
+
 void GrowthMonitor::buildWaferMask() {
-    waferMask_.assign(static_cast<std::size_t>(gridN_ * gridN_), 0);
+    waferCells_.clear();
 
     const double cx = 0.5 * static_cast<double>(gridN_ - 1);
     const double cy = 0.5 * static_cast<double>(gridN_ - 1);
@@ -156,17 +365,20 @@ void GrowthMonitor::buildWaferMask() {
             const double dy = y - cy;
             const double dist = std::sqrt(dx * dx + dy * dy);
 
-            const std::size_t idx = static_cast<std::size_t>(r * gridN_ + c);
-            waferMask_[idx] = (dist <= waferRadiusCells_) ? 1u : 0u;
+            if (dist <= waferRadiusCells_) {
+                waferCells_.push_back(static_cast<std::uint32_t>(r * gridN_ + c));
+            }
         }
     }
 }
 
+// cell_dose is allocated by integrateDose() on the job's first tick under a
+// flux profile; until then the job only has its uniform_dose.
 void GrowthMonitor::ensureJobStorage() {
-    const std::size_t totalCells = static_cast<std::size_t>(gridN_) *
-                                   static_cast<std::size_t>(gridN_);
     for (std::size_t j = 0; j < jobs_.size(); ++j) {
-        jobs_[j].dose.assign(totalCells, 0.0);
+        jobs_[j].uniform_dose = 0.0;
+        jobs_[j].cell_dose.clear();
+        jobs_[j].cell_dose.shrink_to_fit();
         jobs_[j].had_growth   = false;
         jobs_[j].last_t_end_s = 0.0;
         jobs_[j].aborted      = false;
@@ -177,14 +389,25 @@ void GrowthMonitor::integrateDose(double dt, double t_now) {
     if (dt <= 0.0) return;
 
     JobAccum& job = jobs_[static_cast<std::size_t>(activeJobIndex_)];
+    if (job.emitted) {
+        if (!warnedLateDose_) {
+            std::cerr << "[GrowthMonitor] dose for job " << activeJobIndex_
+                      << " after it was archived is ignored\n";
+            warnedLateDose_ = true;
+        }
+        return;
+    }
 
     const double increment = currentFwaferCm2s_ * dt;
-    const std::size_t totalCells = static_cast<std::size_t>(gridN_) *
-                                   static_cast<std::size_t>(gridN_);
 
-    for (std::size_t idx = 0; idx < totalCells; ++idx) {
-        if (!waferMask_[idx]) continue;
-        job.dose[idx] += increment;
+    if (fluxProfile_.empty()) {
+        // Uniform flux adds the same dose to every wafer cell.
+        job.uniform_dose += increment;
+    } else {
+        if (job.cell_dose.empty()) job.cell_dose.assign(waferCells_.size(), 0.0);
+        for (std::size_t k = 0; k < waferCells_.size(); ++k) {
+            job.cell_dose[k] += increment * fluxProfile_[k];
+        }
     }
 
     job.had_growth   = true;
@@ -193,10 +416,32 @@ void GrowthMonitor::integrateDose(double dt, double t_now) {
 
 
 // -----------------------------------------------------------------------------
-// writeCsv()
+// emitJob() / writeCsv()
 // -----------------------------------------------------------------------------
-void GrowthMonitor::writeCsv() const {
-    if (csvFilename_.empty()) return;
+void GrowthMonitor::emitJob(std::size_t j, WaferJobStatus status) {
+    JobAccum& job = jobs_[j];
+    if (job.emitted) return;
+    job.emitted = true;
+
+    // Jobs that never grew are left out, as in the CSV.
+    if (job.had_growth) {
+        openArchive();
+        if (job.cell_dose.empty()) {
+            archive_.append(static_cast<int>(j), status, job.last_t_end_s,
+                            job.uniform_dose, nullptr);
+        } else {
+            for (double& d : job.cell_dose) d += job.uniform_dose;
+            archive_.append(static_cast<int>(j), status, job.last_t_end_s,
+                            0.0, job.cell_dose.data());
+        }
+    }
+
+    job.cell_dose.clear();
+    job.cell_dose.shrink_to_fit();
+}
+
+void GrowthMonitor::writeCsv() {
+    if (csvFilename_.empty() || archiveFilename_.empty()) return;
 
     std::ofstream out(csvFilename_, std::ios::out | std::ios::trunc);
     if (!out) {
@@ -205,32 +450,12 @@ void GrowthMonitor::writeCsv() const {
         return;
     }
 
-    out << "job_index,wafer_index,row,col,t_end_s,dose_arb\n";
-
-    const std::size_t totalCells = static_cast<std::size_t>(gridN_) *
-                                   static_cast<std::size_t>(gridN_);
-
-    for (std::size_t j = 0; j < jobs_.size(); ++j) {
-        const JobAccum& job = jobs_[j];
-        if (!job.had_growth) continue;
-
-        const double t_end = job.last_t_end_s;
-        const int waferIndex = 0;
-
-        for (int r = 0; r < gridN_; ++r) {
-            for (int c = 0; c < gridN_; ++c) {
-                const std::size_t idx = static_cast<std::size_t>(r * gridN_ + c);
-                if (!waferMask_[idx]) continue;
-
-                const double val = job.dose[idx];
-                out << static_cast<int>(j) << ","
-                    << waferIndex << ","
-                    << r << ","
-                    << c << ","
-                    << t_end << ","
-                    << val << "\n";
-            }
-        }
+    try {
+        WaferArchiveReader reader;
+        reader.open(archiveFilename_);
+        reader.writeCsv(out);
+    } catch (const std::exception& e) {
+        std::cerr << "[GrowthMonitor] " << e.what() << "\n";
     }
 
     out.close();
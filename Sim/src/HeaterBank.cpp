@@ -1,10 +1,22 @@
 #include "HeaterBank.hpp"
 #include "EffusionCell.hpp"
 #include "SubstrateHeater.hpp"
+#include "Checkpoint.hpp"
 #include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 HeaterBank::HeaterBank(double maxDraw)
-: Subsystem("HeaterBank"), maxDraw_(maxDraw) {}
+: Subsystem("HeaterBank"), maxDraw_(maxDraw),
+  log_(Logger::instance().registerSchema(
+      name_,
+      {
+          "eff_requested_W",
+          "eff_delivered_W",
+          "sub_requested_W",
+          "sub_delivered_W",
+          "priority_substrate"
+      })) {}
 
 void HeaterBank::setPowerBus(PowerBus* bus) { bus_ = bus; }
 
@@ -27,11 +39,8 @@ void HeaterBank::setPrioritySubstrate(bool priority) {
 
 void HeaterBank::initialize() {}
 
-void HeaterBank::tick(const TickContext& ctx) {
-    if (!bus_) return;
-
-    double effReq, subReq;
-
+// Demands clipped to the bank's max draw.
+void HeaterBank::clippedRequests_(double& effReq, double& subReq) {
     {
         std::lock_guard<std::mutex> lock(demandMtx_);
         effReq = effusionDemand_;
@@ -45,19 +54,52 @@ void HeaterBank::tick(const TickContext& ctx) {
         effReq *= scale;
         subReq *= scale;
     }
+}
+
+void HeaterBank::postPowerRequests(const TickContext&) {
+    if (!bus_) return;
+
+    clippedRequests_(postedEffReq_, postedSubReq_);
+    const PowerPriority effPrio = prioritySubstrate_ ? PowerPriority::HeaterSecondary
+                                                     : PowerPriority::HeaterPrimary;
+    const PowerPriority subPrio = prioritySubstrate_ ? PowerPriority::HeaterPrimary
+                                                     : PowerPriority::HeaterSecondary;
+    effTicket_ = bus_->postRequest(effPrio, postedEffReq_);
+    subTicket_ = bus_->postRequest(subPrio, postedSubReq_);
+}
+
+void HeaterBank::tick(const TickContext& ctx) {
+    if (!bus_) return;
 
+    double effReq, subReq;
     double effDelivered = 0.0;
     double subDelivered = 0.0;
 
-    // ---- Priority allocation ----
-    if (prioritySubstrate_) {
-        subDelivered = bus_->drawPower(subReq, ctx);
-        effDelivered = bus_->drawPower(effReq, ctx);
+    if (effTicket_ >= 0) {
+        // Batched: granted by PowerBus::allocate() before the Loads phase.
+        effReq       = postedEffReq_;
+        subReq       = postedSubReq_;
+        effDelivered = bus_->grant(effTicket_);
+        subDelivered = bus_->grant(subTicket_);
+        effTicket_ = subTicket_ = -1;
     } else {
-        effDelivered = bus_->drawPower(effReq, ctx);
-        subDelivered = bus_->drawPower(subReq, ctx);
+        clippedRequests_(effReq, subReq);
+
+        // ---- Priority allocation ----
+        if (prioritySubstrate_) {
+            subDelivered = bus_->drawPower(subReq, ctx);
+            effDelivered = bus_->drawPower(effReq, ctx);
+        } else {
+            effDelivered = bus_->drawPower(effReq, ctx);
+            subDelivered = bus_->drawPower(subReq, ctx);
+        }
     }
 
+    lastEffReq_       = effReq;
+    lastEffDelivered_ = effDelivered;
+    lastSubReq_       = subReq;
+    lastSubDelivered_ = subDelivered;
+
     // Apply heat
     if (effusion_) {
         effusion_->applyHeat(effDelivered, ctx.dt);
@@ -67,17 +109,9 @@ void HeaterBank::tick(const TickContext& ctx) {
         substrate_->applyHeat(subDelivered, ctx.dt);
     }
 
-    Logger::instance().log_wide(
-        name_,
+    log_.write(
         ctx.tick_index,
         ctx.time,
-        {
-            "eff_requested_W",
-            "eff_delivered_W",
-            "sub_requested_W",
-            "sub_delivered_W",
-            "priority_substrate"
-        },
         {
             effReq,
             effDelivered,
@@ -88,4 +122,29 @@ void HeaterBank::tick(const TickContext& ctx) {
     );
 }
 
-void HeaterBank::shutdown() {}
\ No newline at end of file
+void HeaterBank::shutdown() {}
+
+void HeaterBank::saveState(CheckpointWriter& ckpt) const {
+    ckpt.setDoubles(name_ + ".demand_W", {effusionDemand_, substrateDemand_});
+    ckpt.setDoubles(name_ + ".last_W",
+                    {lastEffReq_, lastEffDelivered_, lastSubReq_, lastSubDelivered_});
+    ckpt.setBool(name_ + ".priority_substrate", prioritySubstrate_);
+}
+
+void HeaterBank::loadState(const CheckpointReader& ckpt) {
+    const std::vector<double> demand = ckpt.getDoubles(name_ + ".demand_W");
+    const std::vector<double> last   = ckpt.getDoubles(name_ + ".last_W");
+    if (demand.size() != 2 || last.size() != 4) {
+        throw std::runtime_error("HeaterBank: malformed checkpoint state");
+    }
+    {
+        std::lock_guard<std::mutex> lock(demandMtx_);
+        effusionDemand_  = demand[0];
+        substrateDemand_ = demand[1];
+    }
+    lastEffReq_        = last[0];
+    lastEffDelivered_  = last[1];
+    lastSubReq_        = last[2];
+    lastSubDelivered_  = last[3];
+    prioritySubstrate_ = ckpt.getBool(name_ + ".priority_substrate");
+}
@@ -0,0 +1,274 @@
+#include "JobFarm.hpp"
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "Logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kTagRequest = 7311;   // group leader -> rank 0: {finished job, wall_s}
+constexpr int kTagReply   = 7312;   // rank 0 -> group leader: next job or -1
+
+std::vector<std::string> split_spec(const std::string& spec) {
+    std::vector<std::string> out;
+    std::string cur;
+    for (char c : spec) {
+        if (c == ',' || std::isspace(static_cast<unsigned char>(c))) {
+            if (!cur.empty()) out.push_back(cur);
+            cur.clear();
+        } else {
+            cur += c;
+        }
+    }
+    if (!cur.empty()) out.push_back(cur);
+    return out;
+}
+
+std::vector<std::string> list_job_files(const std::string& dir) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file() && it->path().extension() == ".txt") {
+            out.push_back(it->path().filename().string());
+        }
+    }
+    if (ec) {
+        throw std::runtime_error("JobFarm: cannot list jobs directory " + dir + " : " + ec.message());
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::string fmt(double v) {
+    std::ostringstream oss;
+    oss.precision(12);
+    oss << v;
+    return oss.str();
+}
+
+void link_entry(const fs::path& target, const fs::path& at) {
+    std::error_code ec;
+    fs::create_symlink(target, at, ec);
+    if (ec) {
+        throw std::runtime_error("JobFarm: cannot link " + at.string() + " -> " + target.string() +
+                                 " : " + ec.message());
+    }
+}
+
+} // anonymous namespace
+
+std::vector<FarmJob> JobFarm::loadJobs(const std::string& spec, const std::string& jobsDir) {
+    std::vector<std::string> files;
+    std::map<std::string, std::vector<std::string>> listed;   // directory -> .txt files, on first glob
+    for (const std::string& tok : split_spec(spec)) {
+        // A glob expands in its own directory component: the jobs directory
+        // for a bare pattern, the given one for "dir/pattern".
+        const std::size_t slash = tok.rfind('/');
+        const std::string name = slash == std::string::npos ? tok : tok.substr(slash + 1);
+        if (name.find_first_of("*?[") == std::string::npos) {
+            files.push_back(tok);
+            continue;
+        }
+        const std::string dir    = slash == std::string::npos ? jobsDir : tok.substr(0, slash + 1);
+        const std::string prefix = slash == std::string::npos ? std::string() : dir;
+        auto it = listed.find(dir);
+        if (it == listed.end()) it = listed.emplace(dir, list_job_files(dir)).first;
+        const std::size_t before = files.size();
+        for (const std::string& f : it->second) {
+            if (::fnmatch(name.c_str(), f.c_str(), 0) == 0) files.push_back(prefix + f);
+        }
+        if (files.size() == before) {
+            throw std::runtime_error("JobFarm: '" + tok + "' matches no .txt job file in " + dir);
+        }
+    }
+    if (files.empty()) {
+        throw std::runtime_error("JobFarm: job spec '" + spec + "' lists no job files");
+    }
+
+    // run_id = file stem; repeats get the list position appended.
+    std::vector<FarmJob> jobs;
+    std::set<std::string> ids;
+    for (std::size_t k = 0; k < files.size(); ++k) {
+        FarmJob j;
+        j.file   = files[k];
+        j.path   = j.file.find('/') != std::string::npos ? j.file : jobsDir + "/" + j.file;
+        std::error_code ec;
+        if (!fs::is_regular_file(j.path, ec)) {
+            throw std::runtime_error("JobFarm: job file " + j.path + " does not exist");
+        }
+        j.run_id = fs::path(j.file).stem().string();
+        if (!ids.insert(j.run_id).second) {
+            j.run_id += "_" + std::to_string(k);
+            ids.insert(j.run_id);
+        }
+        jobs.push_back(j);
+    }
+    return jobs;
+}
+
+int JobFarm::groupCount(int size, int groupSize) {
+    const int g = std::max(1, groupSize);
+    if (size <= 1) return size;
+    return (size - 1) / g;
+}
+
+std::vector<FarmJobResult> JobFarm::run(MPI_Comm comm, const std::vector<FarmJob>& jobs,
+                                        const FarmOptions& opt, const Body& body) {
+    int rank = 0, size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    const int groupSize = std::max(1, opt.group_size);
+    const int groups    = groupCount(size, groupSize);
+    if (groups < 1) {
+        throw std::runtime_error("JobFarm: --farm-group-size " + std::to_string(groupSize) +
+                                 " needs at least " + std::to_string(groupSize + 1) +
+                                 " ranks (rank 0 is the master)");
+    }
+    const int total = static_cast<int>(jobs.size());
+    const fs::path workDir = opt.work_dir.empty() ? fs::path(Logger::directory()) / "farm"
+                                                  : fs::path(opt.work_dir);
+    const fs::path cwd = fs::current_path();
+    const double t0 = MPI_Wtime();
+
+    auto runJob = [&](MPI_Comm group, int g, int k, const std::string& input) {
+        body(group, g, jobs[static_cast<std::size_t>(k)], input);
+        std::error_code ec;
+        fs::current_path(cwd, ec);
+    };
+
+    std::vector<FarmJobResult> results;
+
+    // Single rank: no master, the jobs run back to back.
+    if (size == 1) {
+        const std::string input = mirrorInput(opt.input_dir, (workDir / "g0" / "input").string());
+        for (int k = 0; k < total; ++k) {
+            FarmJobResult r;
+            r.job     = k;
+            r.start_s = MPI_Wtime() - t0;
+            runJob(comm, 0, k, input);
+            r.wall_s  = MPI_Wtime() - t0 - r.start_s;
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    int color = MPI_UNDEFINED;
+    if (rank > 0 && (rank - 1) / groupSize < groups) color = (rank - 1) / groupSize;
+    MPI_Comm group = MPI_COMM_NULL;
+    MPI_Comm_split(comm, color, rank, &group);
+
+    if (rank == 0) {
+        // Master: serve requests until every group has been told to stop.
+        results.resize(jobs.size());
+        int next = 0;
+        int retired = 0;
+        while (retired < groups) {
+            double done[2] = {-1.0, 0.0};
+            MPI_Status st;
+            MPI_Recv(done, 2, MPI_DOUBLE, MPI_ANY_SOURCE, kTagRequest, comm, &st);
+            const int prev = static_cast<int>(done[0]);
+            if (prev >= 0 && prev < total) results[static_cast<std::size_t>(prev)].wall_s = done[1];
+
+            int k = next < total ? next++ : -1;
+            if (k >= 0) {
+                FarmJobResult& r = results[static_cast<std::size_t>(k)];
+                r.job     = k;
+                r.group   = (st.MPI_SOURCE - 1) / groupSize;
+                r.ranks   = groupSize;
+                r.start_s = MPI_Wtime() - t0;
+            } else {
+                ++retired;
+            }
+            MPI_Send(&k, 1, MPI_INT, st.MPI_SOURCE, kTagReply, comm);
+        }
+        return results;
+    }
+
+    if (group == MPI_COMM_NULL) return results;   // leftover rank, idle
+
+    int grank = 0;
+    MPI_Comm_rank(group, &grank);
+    const std::string inputDir = fs::absolute(workDir / ("g" + std::to_string(color)) / "input").string();
+    if (grank == 0) mirrorInput(opt.input_dir, inputDir);
+    MPI_Barrier(group);
+
+    double done[2] = {-1.0, 0.0};
+    for (;;) {
+        int k = -1;
+        if (grank == 0) {
+            MPI_Send(done, 2, MPI_DOUBLE, 0, kTagRequest, comm);
+            MPI_Recv(&k, 1, MPI_INT, 0, kTagReply, comm, MPI_STATUS_IGNORE);
+        }
+        MPI_Bcast(&k, 1, MPI_INT, 0, group);
+        if (k < 0) break;
+
+        const double t = MPI_Wtime();
+        runJob(group, color, k, inputDir);
+        done[0] = static_cast<double>(k);
+        done[1] = MPI_Wtime() - t;
+    }
+    MPI_Comm_free(&group);
+    return results;
+}
+
+std::string JobFarm::mirrorInput(const std::string& src, const std::string& dest) {
+    const fs::path from = fs::absolute(src);
+    const fs::path to   = fs::absolute(dest);
+    std::error_code ec;
+    if (!fs::is_directory(from, ec)) {
+        throw std::runtime_error("JobFarm: input directory " + from.string() + " not found");
+    }
+    fs::remove_all(to, ec);
+    if (!ec) fs::create_directories(to, ec);
+    if (ec) {
+        throw std::runtime_error("JobFarm: cannot create " + to.string() + " : " + ec.message());
+    }
+
+    for (const fs::directory_entry& e : fs::directory_iterator(from)) {
+        const std::string name = e.path().filename().string();
+        // Written by every run: params.inc by the harness, log.* by SPARTA
+        // in its working directory.
+        if (name == "params.inc" || name.rfind("log.", 0) == 0) continue;
+        if (name != "data" || !e.is_directory()) {
+            link_entry(e.path(), to / name);
+            continue;
+        }
+        // data/: shared species and surfaces, private tmp/ (diagnostics,
+        // restart snapshots).
+        fs::create_directory(to / "data");
+        for (const fs::directory_entry& d : fs::directory_iterator(e.path())) {
+            if (d.path().filename() == "tmp") continue;
+            link_entry(d.path(), to / "data" / d.path().filename());
+        }
+        fs::create_directory(to / "data" / "tmp");
+    }
+    return to.string();
+}
+
+void JobFarm::writeTable(const std::vector<FarmJob>& jobs,
+                         const std::vector<FarmJobResult>& results) {
+    static const std::vector<std::string> kColumns = {
+        "job_file", "run_id", "group", "ranks", "start_s", "wall_s"
+    };
+
+    for (const auto& r : results) {
+        const FarmJob& j = jobs.at(static_cast<std::size_t>(r.job));
+        Logger::instance().log_wide(
+            "Farm", r.job, r.start_s, kColumns,
+            std::vector<std::string>{
+                j.file, j.run_id, std::to_string(r.group), std::to_string(r.ranks),
+                fmt(r.start_s), fmt(r.wall_s)
+            });
+    }
+}
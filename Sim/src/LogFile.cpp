@@ -0,0 +1,368 @@
+// Sim/src/LogFile.cpp
+#include "LogFile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#if SF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+long env_long(const char* name, long def) {
+    if (const char* env = std::getenv(name)) {
+        if (*env) {
+            char* end = nullptr;
+            const long v = std::strtol(env, &end, 10);
+            if (end && *end == '\0') return v;
+            std::cerr << "[Logger] Ignoring non-integer " << name << "='" << env << "'\n";
+        }
+    }
+    return def;
+}
+
+std::size_t block_size() {
+    static const std::size_t n =
+        static_cast<std::size_t>(std::max(4096L, env_long("SF_LOG_BLOCK", 1L << 20)));
+    return n;
+}
+
+#if SF_HAVE_ZLIB
+int compress_level() {
+    static const int level =
+        static_cast<int>(std::min(9L, std::max(1L, env_long("SF_LOG_COMPRESS_LEVEL", 1))));
+    return level;
+}
+#endif
+
+} // anonymous namespace
+
+LogCodec resolveLogCodec() {
+    static const LogCodec codec = [] {
+        const char* env = std::getenv("SF_LOG_COMPRESS");
+        if (!env || !*env) return LogCodec::None;
+        const std::string v(env);
+        if (v == "none" || v == "0") return LogCodec::None;
+#if SF_HAVE_ZLIB
+        if (v == "gzip" || v == "gz") return LogCodec::Gzip;
+        std::cerr << "[Logger] SF_LOG_COMPRESS='" << v
+                  << "' is not available in this build, using gzip\n";
+        return LogCodec::Gzip;
+#else
+        std::cerr << "[Logger] SF_LOG_COMPRESS='" << v
+                  << "' needs a zlib build, writing uncompressed logs\n";
+        return LogCodec::None;
+#endif
+    }();
+    return codec;
+}
+
+const char* logCodecExtension(LogCodec codec) {
+    return codec == LogCodec::Gzip ? ".gz" : "";
+}
+
+std::vector<std::vector<std::string>> parseCsvRecords(const std::string& text) {
+    std::vector<std::vector<std::string>> rows;
+    std::vector<std::string> row;
+    std::string field;
+    bool quoted = false, any = false;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const char ch = text[i];
+        if (quoted) {
+            if (ch != '"') {
+                field.push_back(ch);
+            } else if (i + 1 < text.size() && text[i + 1] == '"') {
+                field.push_back('"');
+                ++i;
+            } else {
+                quoted = false;
+            }
+        } else if (ch == '"') {
+            quoted = any = true;
+        } else if (ch == ',') {
+            row.push_back(std::move(field));
+            field.clear();
+            any = true;
+        } else if (ch == '\n') {
+            row.push_back(std::move(field));
+            field.clear();
+            rows.push_back(std::move(row));
+            row.clear();
+            any = false;
+        } else if (ch != '\r') {
+            field.push_back(ch);
+            any = true;
+        }
+    }
+    if (any) {
+        row.push_back(std::move(field));
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+// ---------------- LogFileOut ----------------
+
+struct LogFileOut::Deflater {
+#if SF_HAVE_ZLIB
+    z_stream zs;
+#endif
+};
+
+LogFileOut::LogFileOut() = default;
+
+LogFileOut::~LogFileOut() {
+    try { close(); } catch (...) {}
+}
+
+void LogFileOut::open(const std::string& path, bool append, LogCodec codec) {
+    close();
+#if !SF_HAVE_ZLIB
+    if (codec == LogCodec::Gzip) {
+        throw std::runtime_error("LogFileOut: built without zlib (gzip unavailable) for " + path);
+    }
+#endif
+    fp_ = std::fopen(path.c_str(), append ? "ab" : "wb");
+    if (!fp_) {
+        throw std::runtime_error("LogFileOut: failed to open " + path);
+    }
+    codec_       = codec;
+    block_bytes_ = 0;
+    member_open_ = false;
+
+#if SF_HAVE_ZLIB
+    if (codec_ == LogCodec::Gzip) {
+        z_ = std::make_unique<Deflater>();
+        std::memset(&z_->zs, 0, sizeof(z_->zs));
+        // windowBits 15 + 16: gzip header and trailer around the deflate data.
+        if (deflateInit2(&z_->zs, compress_level(), Z_DEFLATED, 15 + 16, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            std::fclose(fp_);
+            fp_ = nullptr;
+            z_.reset();
+            throw std::runtime_error("LogFileOut: deflateInit2 failed for " + path);
+        }
+    }
+#endif
+}
+
+void LogFileOut::deflate_(int mode) {
+#if SF_HAVE_ZLIB
+    z_stream& zs = z_->zs;
+    unsigned char out[16384];
+    for (;;) {
+        zs.next_out  = out;
+        zs.avail_out = sizeof(out);
+        const int rc = ::deflate(&zs, mode);
+        if (rc == Z_STREAM_ERROR) {
+            throw std::runtime_error("LogFileOut: deflate failed");
+        }
+        const std::size_t have = sizeof(out) - zs.avail_out;
+        if (have && std::fwrite(out, 1, have, fp_) != have) {
+            throw std::runtime_error("LogFileOut: write failed");
+        }
+        if (mode == Z_FINISH ? rc == Z_STREAM_END : zs.avail_out != 0) break;
+    }
+#else
+    (void)mode;
+#endif
+}
+
+void LogFileOut::write(const void* data, std::size_t n) {
+    if (!fp_ || n == 0) return;
+    if (codec_ == LogCodec::None) {
+        if (std::fwrite(data, 1, n, fp_) != n) {
+            throw std::runtime_error("LogFileOut: write failed");
+        }
+        return;
+    }
+#if SF_HAVE_ZLIB
+    z_stream& zs = z_->zs;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    while (n > 0) {
+        const std::size_t take = std::min(n, block_size() - block_bytes_);
+        zs.next_in  = const_cast<unsigned char*>(p);
+        zs.avail_in = static_cast<uInt>(take);
+        deflate_(Z_NO_FLUSH);
+        p += take;
+        n -= take;
+        block_bytes_ += take;
+        member_open_  = true;
+        if (block_bytes_ >= block_size()) {
+            deflate_(Z_SYNC_FLUSH);
+            std::fflush(fp_);
+            block_bytes_ = 0;
+        }
+    }
+#endif
+}
+
+void LogFileOut::flush() {
+    if (fp_ && codec_ == LogCodec::None) std::fflush(fp_);
+}
+
+void LogFileOut::seal() {
+    if (!fp_) return;
+#if SF_HAVE_ZLIB
+    if (codec_ == LogCodec::Gzip && member_open_) {
+        z_->zs.next_in  = nullptr;
+        z_->zs.avail_in = 0;
+        deflate_(Z_FINISH);
+        deflateReset(&z_->zs);   // the next write starts a new member
+        block_bytes_ = 0;
+        member_open_ = false;
+    }
+#endif
+    std::fflush(fp_);
+}
+
+void LogFileOut::close() {
+    if (!fp_) return;
+    seal();
+#if SF_HAVE_ZLIB
+    if (z_) deflateEnd(&z_->zs);
+#endif
+    z_.reset();
+    std::fclose(fp_);
+    fp_ = nullptr;
+}
+
+// ---------------- LogFileIn ----------------
+
+LogFileIn::~LogFileIn() {
+    close();
+}
+
+void LogFileIn::open(const std::string& path) {
+    close();
+#if SF_HAVE_ZLIB
+    // gzread passes uncompressed files through unchanged.
+    gzFile gz = gzopen(path.c_str(), "rb");
+    if (!gz) throw std::runtime_error("LogFileIn: failed to open " + path);
+    gzbuffer(gz, 1 << 16);
+    handle_ = gz;
+#else
+    std::FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) throw std::runtime_error("LogFileIn: failed to open " + path);
+    unsigned char magic[2] = {0, 0};
+    const std::size_t got = std::fread(magic, 1, 2, fp);
+    if (got == 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        std::fclose(fp);
+        throw std::runtime_error("LogFileIn: built without zlib, cannot read compressed " + path);
+    }
+    std::rewind(fp);
+    handle_ = fp;
+#endif
+}
+
+std::size_t LogFileIn::read(void* data, std::size_t n) {
+    if (!handle_ || n == 0) return 0;
+#if SF_HAVE_ZLIB
+    std::size_t total = 0;
+    char* p = static_cast<char*>(data);
+    while (total < n) {
+        const unsigned take = static_cast<unsigned>(std::min<std::size_t>(n - total, 1u << 30));
+        const int got = gzread(static_cast<gzFile>(handle_), p + total, take);
+        if (got <= 0) break;
+        total += static_cast<std::size_t>(got);
+    }
+    return total;
+#else
+    return std::fread(data, 1, n, static_cast<std::FILE*>(handle_));
+#endif
+}
+
+int LogFileIn::getc() {
+    unsigned char c = 0;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+void LogFileIn::close() {
+    if (!handle_) return;
+#if SF_HAVE_ZLIB
+    gzclose(static_cast<gzFile>(handle_));
+#else
+    std::fclose(static_cast<std::FILE*>(handle_));
+#endif
+    handle_ = nullptr;
+}
+
+// ---------------- LogOStream ----------------
+
+LogOStream::Buf::Buf(LogFileOut& f) : file_(f) {
+    setp(buf_, buf_ + sizeof(buf_));
+}
+
+int LogOStream::Buf::drain() {
+    const std::size_t n = static_cast<std::size_t>(pptr() - pbase());
+    if (n == 0) return 0;
+    try {
+        file_.write(pbase(), n);
+    } catch (const std::exception&) {
+        return -1;   // the stream sets badbit
+    }
+    setp(buf_, buf_ + sizeof(buf_));
+    return 0;
+}
+
+LogOStream::Buf::int_type LogOStream::Buf::overflow(int_type ch) {
+    if (drain() != 0) return traits_type::eof();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize LogOStream::Buf::xsputn(const char* s, std::streamsize n) {
+    std::streamsize done = 0;
+    while (done < n) {
+        if (pptr() == epptr() && drain() != 0) break;
+        const std::streamsize room = epptr() - pptr();
+        const std::streamsize take = std::min(room, n - done);
+        std::memcpy(pptr(), s + done, static_cast<std::size_t>(take));
+        pbump(static_cast<int>(take));
+        done += take;
+    }
+    return done;
+}
+
+int LogOStream::Buf::sync() {
+    if (drain() != 0) return -1;
+    try {
+        file_.flush();
+    } catch (const std::exception&) {
+        return -1;
+    }
+    return 0;
+}
+
+LogOStream::LogOStream() : std::ostream(nullptr), buf_(file_) {
+    rdbuf(&buf_);
+}
+
+LogOStream::~LogOStream() {
+    try { close(); } catch (...) {}
+}
+
+void LogOStream::open(const std::string& path, bool append, LogCodec codec) {
+    close();
+    file_.open(path, append, codec);
+    clear();
+}
+
+void LogOStream::seal() {
+    if (!file_.is_open()) return;
+    flush();
+    file_.seal();
+}
+
+void LogOStream::close() {
+    if (!file_.is_open()) return;
+    flush();
+    file_.close();
+}
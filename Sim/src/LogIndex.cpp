@@ -0,0 +1,479 @@
+// Sim/src/LogIndex.cpp
+#include "LogIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char        kMagic[8]  = {'S', 'F', 'L', 'I', 'D', 'X', '\0', '\0'};
+constexpr std::size_t kTailBytes = 64;
+constexpr std::size_t kScanChunk = std::size_t{8} << 20;
+
+template <typename T>
+void write_pod(std::FILE* fp, const T& v) {
+    std::fwrite(&v, sizeof(T), 1, fp);
+}
+
+template <typename T>
+bool read_pod(std::FILE* fp, T& v) {
+    return std::fread(&v, sizeof(T), 1, fp) == 1;
+}
+
+std::uint64_t fnv1a(const char* p, std::size_t n) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// FNV-1a of the kTailBytes bytes before end (fewer at the start of a file).
+bool tail_hash(std::FILE* fp, std::uint64_t end, std::uint64_t& out) {
+    const std::uint64_t n = std::min<std::uint64_t>(end, kTailBytes);
+    char buf[kTailBytes];
+    if (std::fseek(fp, static_cast<long>(end - n), SEEK_SET) != 0) return false;
+    if (std::fread(buf, 1, static_cast<std::size_t>(n), fp) != n) return false;
+    out = fnv1a(buf, static_cast<std::size_t>(n));
+    return true;
+}
+
+std::int64_t mtime_of(const fs::path& p) {
+    std::error_code ec;
+    const auto t = fs::last_write_time(p, ec);
+    return ec ? 0 : static_cast<std::int64_t>(t.time_since_epoch().count());
+}
+
+// A whole field as a number (std::strtod syntax); NaN does not count, so
+// "nan" cells keep a block's bounds unusable like text does.
+bool parse_number(const char* p, std::size_t n, double& out) {
+    if (n == 0 || n >= 64) return false;
+    char buf[64];
+    std::memcpy(buf, p, n);
+    buf[n] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buf, &end);
+    return end == buf + n && !std::isnan(out);
+}
+
+bool parse_number(const std::string& s, double& out) {
+    return parse_number(s.data(), s.size(), out);
+}
+
+// End of the record starting at pos (index of its '\n'), or npos if the
+// data ends inside it.
+std::size_t record_end(const std::string& data, std::size_t pos) {
+    bool quoted = false;
+    for (std::size_t i = pos; i < data.size(); ++i) {
+        const char c = data[i];
+        if (c == '"') quoted = !quoted;
+        else if (c == '\n' && !quoted) return i;
+    }
+    return std::string::npos;
+}
+
+std::size_t trimmed(const std::string& data, std::size_t begin, std::size_t end) {
+    return (end > begin && data[end - 1] == '\r') ? end - 1 : end;
+}
+
+bool compare(LogQueryTerm::Op op, int c) {
+    switch (op) {
+    case LogQueryTerm::Eq: return c == 0;
+    case LogQueryTerm::Ne: return c != 0;
+    case LogQueryTerm::Lt: return c < 0;
+    case LogQueryTerm::Le: return c <= 0;
+    case LogQueryTerm::Gt: return c > 0;
+    case LogQueryTerm::Ge: return c >= 0;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+// ---------------- LogQuery ----------------
+
+void LogQuery::addTerm(const std::string& column, LogQueryTerm::Op op, const std::string& text) {
+    LogQueryTerm t;
+    t.column  = column;
+    t.op      = op;
+    t.text    = text;
+    t.numeric = parse_number(text, t.value);
+    terms_.push_back(std::move(t));
+}
+
+void LogQuery::addTerms(const std::string& spec) {
+    std::size_t pos = 0;
+    while (pos <= spec.size()) {
+        std::size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string term = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+        if (term.empty()) continue;
+
+        const std::size_t at = term.find_first_of("=!<>");
+        if (at == std::string::npos || at == 0) {
+            throw std::runtime_error("LogQuery: bad term '" + term + "' (want column<op>value)");
+        }
+        std::size_t len = 1;
+        LogQueryTerm::Op op = LogQueryTerm::Eq;
+        const char c0 = term[at];
+        const char c1 = at + 1 < term.size() ? term[at + 1] : '\0';
+        if (c0 == '=')      { op = LogQueryTerm::Eq; len = c1 == '=' ? 2 : 1; }
+        else if (c0 == '!') {
+            if (c1 != '=') throw std::runtime_error("LogQuery: bad operator in '" + term + "'");
+            op = LogQueryTerm::Ne; len = 2;
+        }
+        else if (c0 == '<') { op = c1 == '=' ? LogQueryTerm::Le : LogQueryTerm::Lt; len = c1 == '=' ? 2 : 1; }
+        else                { op = c1 == '=' ? LogQueryTerm::Ge : LogQueryTerm::Gt; len = c1 == '=' ? 2 : 1; }
+        addTerm(term.substr(0, at), op, term.substr(at + len));
+    }
+}
+
+void LogQuery::addTickRange(long first, long last) {
+    addTerm("tick", LogQueryTerm::Ge, std::to_string(first));
+    addTerm("tick", LogQueryTerm::Le, std::to_string(last));
+}
+
+// ---------------- LogIndex ----------------
+
+std::string LogIndex::indexPath(const std::string& csvPath) {
+    return csvPath + ".sfidx";
+}
+
+int LogIndex::column(const std::string& name) const {
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+        if (columns_[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+std::uint64_t LogIndex::rows() const {
+    std::uint64_t n = 0;
+    for (const Block& b : blocks_) n += b.rows;
+    return n;
+}
+
+LogIndex LogIndex::load(const std::string& csvPath, std::size_t block_rows, bool rebuild,
+                        LoadInfo* info) {
+    LoadInfo local;
+    LoadInfo& li = info ? *info : local;
+    li = LoadInfo{};
+
+    std::error_code ec;
+    const std::uint64_t size = fs::file_size(csvPath, ec);
+    if (ec) throw std::runtime_error("LogIndex: cannot read " + csvPath + " : " + ec.message());
+    const std::int64_t mtime = mtime_of(csvPath);
+
+    std::FILE* fp = std::fopen(csvPath.c_str(), "rb");
+    if (!fp) throw std::runtime_error("LogIndex: cannot open " + csvPath);
+
+    LogIndex idx;
+    idx.path_       = csvPath;
+    idx.block_rows_ = std::max<std::size_t>(1, block_rows);
+
+    // The sidecar, if it still describes a prefix of the file.
+    bool loaded = false;
+    if (!rebuild) {
+        if (std::FILE* ip = std::fopen(indexPath(csvPath).c_str(), "rb")) {
+            char magic[8] = {};
+            std::uint32_t version = 0, ncols = 0, brows = 0, nblocks = 0, hbytes = 0;
+            std::uint64_t indexed = 0, thash = 0;
+            std::int64_t  imtime = 0;
+            bool ok = std::fread(magic, 1, 8, ip) == 8 && std::memcmp(magic, kMagic, 8) == 0 &&
+                      read_pod(ip, version) && version == kLogIndexVersion &&
+                      read_pod(ip, ncols) && read_pod(ip, brows) && read_pod(ip, nblocks) &&
+                      read_pod(ip, indexed) && read_pod(ip, imtime) && read_pod(ip, thash) &&
+                      read_pod(ip, hbytes) && brows == idx.block_rows_ &&
+                      hbytes <= indexed && nblocks <= indexed && ncols <= hbytes + 1;
+            if (ok) {
+                idx.header_.resize(hbytes);
+                ok = std::fread(&idx.header_[0], 1, hbytes, ip) == hbytes;
+            }
+            for (std::uint32_t b = 0; ok && b < nblocks; ++b) {
+                Block blk;
+                std::uint32_t pad = 0;
+                ok = read_pod(ip, blk.offset) && read_pod(ip, blk.bytes) && read_pod(ip, blk.rows) &&
+                     read_pod(ip, pad);
+                blk.min.resize(ncols);
+                blk.max.resize(ncols);
+                for (std::uint32_t c = 0; ok && c < ncols; ++c) {
+                    ok = read_pod(ip, blk.min[c]) && read_pod(ip, blk.max[c]);
+                }
+                idx.blocks_.push_back(std::move(blk));
+            }
+            std::fclose(ip);
+
+            std::uint64_t h = 0;
+            if (ok && indexed <= size && tail_hash(fp, indexed, h) && h == thash &&
+                (indexed < size || imtime == mtime)) {
+                idx.splitRecord(idx.header_, idx.columns_);
+                idx.indexed_bytes_ = indexed;
+                loaded = idx.columns_.size() == ncols;
+            }
+            if (!loaded) {
+                idx.blocks_.clear();
+                idx.header_.clear();
+                idx.columns_.clear();
+            }
+        }
+    }
+
+    if (loaded && idx.indexed_bytes_ == size) {
+        std::fclose(fp);
+        idx.mtime_ = mtime;
+        return idx;
+    }
+
+    // Index from scratch, or just the rows after the loaded blocks.
+    const std::uint64_t before = idx.indexed_bytes_;
+    std::string data;
+    try {
+        std::fseek(fp, static_cast<long>(idx.indexed_bytes_), SEEK_SET);
+        std::uint64_t base = idx.indexed_bytes_;
+        std::vector<char> chunk(kScanChunk);
+        for (;;) {
+            const std::size_t got = std::fread(chunk.data(), 1, chunk.size(), fp);
+            if (got == 0) break;
+            data.append(chunk.data(), got);
+            idx.scan_(data, base, idx.block_rows_);
+            // scan_ consumed whole records up to indexed_bytes_.
+            const std::size_t used = static_cast<std::size_t>(idx.indexed_bytes_ - base);
+            data.erase(0, used);
+            base = idx.indexed_bytes_;
+        }
+    } catch (...) {
+        std::fclose(fp);
+        throw;
+    }
+    std::fclose(fp);
+
+    li.built    = !loaded;
+    li.extended = loaded && idx.indexed_bytes_ > before;
+    idx.mtime_  = mtime;
+    li.written  = idx.write_();
+    return idx;
+}
+
+// Consumes the complete records of data (which starts at file offset
+// base): the header while none has been seen, then data rows, which extend
+// the last block until it holds block_rows rows.
+void LogIndex::scan_(const std::string& data, std::uint64_t base, std::size_t block_rows) {
+    std::size_t pos = 0;
+
+    while (pos < data.size()) {
+        const std::size_t end = record_end(data, pos);
+        if (end == std::string::npos) break;
+        const std::size_t stop = trimmed(data, pos, end);
+
+        if (header_.empty() && columns_.empty()) {
+            header_.assign(data, pos, stop - pos);
+            splitRecord(header_, columns_);
+            pos = end + 1;
+            indexed_bytes_ = base + pos;
+            continue;
+        }
+        if (stop == pos) {   // blank line
+            pos = end + 1;
+            indexed_bytes_ = base + pos;
+            continue;
+        }
+
+        const std::size_t ncols = columns_.size();
+        if (blocks_.empty() || blocks_.back().rows >= block_rows) {
+            Block b;
+            b.offset = base + pos;
+            b.min.assign(ncols, std::numeric_limits<double>::infinity());
+            b.max.assign(ncols, -std::numeric_limits<double>::infinity());
+            blocks_.push_back(std::move(b));
+        }
+        Block& b = blocks_.back();
+
+        // Fields in place; a quoted field is text and never numeric.
+        std::size_t col = 0, f = pos;
+        while (col < ncols) {
+            std::size_t g = f;
+            bool quoted = false;
+            while (g < stop && (quoted || data[g] != ',')) {
+                if (data[g] == '"') quoted = !quoted;
+                ++g;
+            }
+            double v = 0.0;
+            if (!std::isnan(b.min[col])) {
+                if (parse_number(data.data() + f, g - f, v)) {
+                    if (v < b.min[col]) b.min[col] = v;
+                    if (v > b.max[col]) b.max[col] = v;
+                } else {
+                    b.min[col] = b.max[col] = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+            ++col;
+            if (g >= stop) break;
+            f = g + 1;
+        }
+        for (; col < ncols; ++col) {   // short row
+            b.min[col] = b.max[col] = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        pos = end + 1;
+        b.rows  += 1;
+        b.bytes  = base + pos - b.offset;
+        indexed_bytes_ = base + pos;
+    }
+}
+
+bool LogIndex::write_() const {
+    const std::string path = indexPath(path_);
+    const std::string tmp  = path + ".tmp";
+    std::FILE* src = std::fopen(path_.c_str(), "rb");
+    if (!src) return false;
+    std::uint64_t thash = 0;
+    const bool hashed = tail_hash(src, indexed_bytes_, thash);
+    std::fclose(src);
+    if (!hashed) return false;
+
+    std::FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (!fp) return false;
+    std::fwrite(kMagic, 1, sizeof(kMagic), fp);
+    write_pod(fp, kLogIndexVersion);
+    write_pod(fp, static_cast<std::uint32_t>(columns_.size()));
+    write_pod(fp, static_cast<std::uint32_t>(block_rows_));
+    write_pod(fp, static_cast<std::uint32_t>(blocks_.size()));
+    write_pod(fp, indexed_bytes_);
+    write_pod(fp, mtime_);
+    write_pod(fp, thash);
+    write_pod(fp, static_cast<std::uint32_t>(header_.size()));
+    std::fwrite(header_.data(), 1, header_.size(), fp);
+    for (const Block& b : blocks_) {
+        write_pod(fp, b.offset);
+        write_pod(fp, b.bytes);
+        write_pod(fp, b.rows);
+        write_pod(fp, std::uint32_t{0});
+        for (std::size_t c = 0; c < columns_.size(); ++c) {
+            write_pod(fp, b.min[c]);
+            write_pod(fp, b.max[c]);
+        }
+    }
+    const bool ok = std::ferror(fp) == 0;
+    std::fclose(fp);
+
+    std::error_code ec;
+    if (ok) fs::rename(tmp, path, ec);
+    if (!ok || ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool LogIndex::resolve(const LogQuery& q, std::vector<int>& cols) const {
+    cols.clear();
+    for (const LogQueryTerm& t : q.terms()) {
+        const int c = column(t.column);
+        if (c < 0) return false;
+        cols.push_back(c);
+    }
+    return true;
+}
+
+bool LogIndex::mayMatch(std::size_t b, const LogQuery& q, const std::vector<int>& cols) const {
+    const Block& blk = blocks_[b];
+    const std::vector<LogQueryTerm>& terms = q.terms();
+    for (std::size_t k = 0; k < terms.size(); ++k) {
+        const LogQueryTerm& t = terms[k];
+        const double lo = blk.min[static_cast<std::size_t>(cols[k])];
+        const double hi = blk.max[static_cast<std::size_t>(cols[k])];
+        if (!t.numeric || std::isnan(lo)) continue;
+        const double v = t.value;
+        bool may = true;
+        switch (t.op) {
+        case LogQueryTerm::Eq: may = lo <= v && v <= hi; break;
+        case LogQueryTerm::Ne: may = !(lo == v && hi == v); break;
+        case LogQueryTerm::Lt: may = lo < v; break;
+        case LogQueryTerm::Le: may = lo <= v; break;
+        case LogQueryTerm::Gt: may = hi > v; break;
+        case LogQueryTerm::Ge: may = hi >= v; break;
+        }
+        if (!may) return false;
+    }
+    return true;
+}
+
+void LogIndex::readBlock(std::FILE* fp, std::size_t b, std::string& out) const {
+    const Block& blk = blocks_[b];
+    out.resize(static_cast<std::size_t>(blk.bytes));
+    if (std::fseek(fp, static_cast<long>(blk.offset), SEEK_SET) != 0 ||
+        std::fread(&out[0], 1, out.size(), fp) != out.size()) {
+        throw std::runtime_error("LogIndex: short read in " + path_ +
+                                 " (file changed since it was indexed?)");
+    }
+}
+
+bool LogIndex::nextRecord(const std::string& data, std::size_t& pos, std::string& line) {
+    while (pos < data.size()) {
+        std::size_t end = record_end(data, pos);
+        if (end == std::string::npos) end = data.size();
+        const std::size_t stop = trimmed(data, pos, end);
+        const std::size_t start = pos;
+        pos = end + 1;
+        if (stop > start) {
+            line.assign(data, start, stop - start);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LogIndex::splitRecord(const std::string& line, std::vector<std::string>& fields) {
+    fields.clear();
+    std::string cur;
+    bool quoted = false;
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                cur.push_back('"');
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                cur.push_back(c);
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(std::move(cur));
+            cur.clear();
+        } else {
+            cur.push_back(c);
+        }
+    }
+    fields.push_back(std::move(cur));
+}
+
+bool LogIndex::rowMatches(const std::vector<std::string>& fields, const LogQuery& q,
+                          const std::vector<int>& cols) {
+    const std::vector<LogQueryTerm>& terms = q.terms();
+    for (std::size_t k = 0; k < terms.size(); ++k) {
+        const std::size_t c = static_cast<std::size_t>(cols[k]);
+        if (c >= fields.size()) return false;
+        const LogQueryTerm& t = terms[k];
+        double v = 0.0;
+        int cmp = 0;
+        if (t.numeric && parse_number(fields[c], v)) {
+            cmp = v < t.value ? -1 : (v > t.value ? 1 : 0);
+        } else {
+            const int r = fields[c].compare(t.text);
+            cmp = r < 0 ? -1 : (r > 0 ? 1 : 0);
+        }
+        if (!compare(t.op, cmp)) return false;
+    }
+    return true;
+}
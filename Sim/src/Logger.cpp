@@ -11,6 +11,15 @@
 #include <vector>
 #include <stdexcept>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <string_view>
+#include <unordered_map>
+
+#include "MpscRing.hpp"
+#include "Profiler.hpp"
 
 namespace {
 namespace fs = std::filesystem;
@@ -50,13 +59,86 @@ fs::path resolve_base_dir() {
     return base;
 }
 
-// Escape a CSV field if needed.
+// Output format for numeric wide logs, read once from env SF_LOG_FORMAT.
+enum class LogFormat { Csv, Binary };
+
+LogFormat resolve_log_format() {
+    static const LogFormat fmt = [] {
+        const char* env = std::getenv("SF_LOG_FORMAT");
+        if (!env || !*env) return LogFormat::Csv;
+        const std::string v(env);
+        if (v == "csv") return LogFormat::Csv;
+        if (v == "bin" || v == "binary") return LogFormat::Binary;
+        std::cerr << "[Logger] Unknown SF_LOG_FORMAT='" << v
+                  << "', falling back to csv\n";
+        return LogFormat::Csv;
+    }();
+    return fmt;
+}
+
+// Dictionary-encoded string columns, read once from env SF_LOG_DICT.
+bool resolve_log_dict() {
+    static const bool on = [] {
+        const char* env = std::getenv("SF_LOG_DICT");
+        return env && *env && std::string(env) != "0";
+    }();
+    return on;
+}
+
+// File names relative to the log directory. The row files carry the
+// codec's suffix; dictionaries are small and stay plain CSV.
+std::string csv_file(const std::string& subsystem) {
+    return subsystem + ".csv" + logCodecExtension(resolveLogCodec());
+}
+
+std::string bin_file(const std::string& subsystem) {
+    return subsystem + ".sfb" + logCodecExtension(resolveLogCodec());
+}
+
+std::string dict_file(const std::string& subsystem) {
+    return subsystem + ".dict.csv";
+}
+
+// Create the log directory or throw.
+fs::path ensure_base_dir() {
+    fs::path base_dir = resolve_base_dir();
+    std::error_code ec;
+    fs::create_directories(base_dir, ec);
+    if (ec) {
+        throw std::runtime_error(
+            "Logger: failed to create log directory " + base_dir.string() +
+            " : " + ec.message()
+        );
+    }
+    return base_dir;
+}
+
+// Prefixed subsystem names ("member_3/Battery") live in a subdirectory.
+void ensure_parent_dir(const fs::path& file) {
+    std::error_code ec;
+    fs::create_directories(file.parent_path(), ec);
+    if (ec) {
+        throw std::runtime_error(
+            "Logger: failed to create log directory " + file.parent_path().string() +
+            " : " + ec.message()
+        );
+    }
+}
+
+// Stream-name prefix for the calling thread (see Logger::ScopedPrefix).
+thread_local std::string t_stream_prefix;
+
+// Nesting depth of Logger::ScopedDiscard on the calling thread.
+thread_local int t_discard_depth = 0;
+
+// Write a CSV field, escaped if needed.
 //
 // Rules:
 // - If the field contains comma, quote, newline, or carriage return,
 //   wrap it in double quotes.
 // - Any embedded double quote becomes two double quotes.
-std::string escape_csv_field(const std::string& s) {
+// Written straight to the stream, so rows do not build escaped copies.
+void write_csv_field(std::ostream& out, std::string_view s) {
     bool needs_quotes = false;
     for (char ch : s) {
         if (ch == ',' || ch == '"' || ch == '\n' || ch == '\r') {
@@ -66,64 +148,49 @@ std::string escape_csv_field(const std::string& s) {
     }
 
     if (!needs_quotes) {
-        return s;
+        out.write(s.data(), static_cast<std::streamsize>(s.size()));
+        return;
     }
 
-    std::string out;
-    out.reserve(s.size() + 8);
-    out.push_back('"');
+    out.put('"');
     for (char ch : s) {
-        if (ch == '"') {
-            out.push_back('"');
-            out.push_back('"');
-        } else {
-            out.push_back(ch);
-        }
+        if (ch == '"') out.put('"');
+        out.put(ch);
     }
-    out.push_back('"');
-    return out;
+    out.put('"');
 }
 
-// Get or open the per-subsystem CSV file.
-// If this is the first time we open it, we also write the header.
+// Open the per-subsystem CSV file and write its header.
 //
 // For "tall" logs (log()), the header is: tick,time_s,key,value
 // For "wide" logs (log_wide()), the header is: tick,time_s,<columns...>
-std::ofstream& get_stream_for_subsystem(
+// append reopens a resumed file after its last row, without a header.
+void open_csv_for_subsystem(
+    LogOStream& out,
     const std::string& subsystem,
-    std::map<std::string, std::ofstream>& per_node,
     const std::vector<std::string>* wide_cols,
-    bool is_wide
+    bool is_wide,
+    bool append
 ) {
-    auto it = per_node.find(subsystem);
-    if (it != per_node.end()) {
-        return it->second;
-    }
-
-    fs::path base_dir = resolve_base_dir();
-    std::error_code ec;
-    fs::create_directories(base_dir, ec);
-    if (ec) {
-        throw std::runtime_error(
-            "Logger: failed to create log directory " + base_dir.string() +
-            " : " + ec.message()
-        );
-    }
-
-    fs::path csv_path = base_dir / (subsystem + ".csv");
-    std::ofstream out(csv_path, std::ios::out | std::ios::trunc);
-    if (!out) {
+    fs::path base_dir = ensure_base_dir();
+    fs::path csv_path = base_dir / csv_file(subsystem);
+    ensure_parent_dir(csv_path);
+    try {
+        out.open(csv_path.string(), append, resolveLogCodec());
+    } catch (const std::exception&) {
         throw std::runtime_error(
             "Logger: failed to open log file " + csv_path.string()
         );
     }
+    if (append) return;
 
     // Write header
     if (is_wide) {
         out << "tick,time_s";
         if (wide_cols) {
             for (const auto& c : *wide_cols) {
-                out << ',' << escape_csv_field(c);
+                out << ',';
+                write_csv_field(out, c);
             }
         }
         out << '\n';
@@ -131,9 +198,55 @@ std::ofstream& get_stream_for_subsystem(
         out << "tick,time_s,key,value\n";
     }
     out.flush();
+}
+
+
+// Open the per-subsystem binary file (SF_LOG_FORMAT=bin).
+// The schema header is taken from the first call's column list.
+std::unique_ptr<BinaryLogWriter> open_binary_for_subsystem(
+    const std::string& subsystem,
+    const std::vector<std::string>& cols,
+    bool append
+) {
+    fs::path bin_path = ensure_base_dir() / bin_file(subsystem);
+    ensure_parent_dir(bin_path);
+    auto writer = std::make_unique<BinaryLogWriter>();
+    if (append) {
+        writer->openAppend(bin_path.string(), cols, resolveLogCodec());
+    } else {
+        writer->open(bin_path.string(), cols, resolveLogCodec());
+    }
+    return writer;
+}
+
+// Integer env knob with a default.
+long env_long(const char* name, long def) {
+    if (const char* env = std::getenv(name)) {
+        if (*env) {
+            char* end = nullptr;
+            long v = std::strtol(env, &end, 10);
+            if (end && *end == '\0') return v;
+            std::cerr << "[Logger] Ignoring non-integer " << name << "='" << env << "'\n";
+        }
+    }
+    return def;
+}
+
+std::size_t round_up_pow2(std::size_t v) {
+    std::size_t p = 2;
+    while (p < v) p <<= 1;
+    return p;
+}
 
-    auto [new_it, _] = per_node.emplace(subsystem, std::move(out));
-    return new_it->second;
+// MPI-IO calls return their error codes (files default to
+// MPI_ERRORS_RETURN); turn failures into exceptions.
+void check_mpi(int rc, const char* what, const std::string& path) {
+    if (rc == MPI_SUCCESS) return;
+    char msg[MPI_MAX_ERROR_STRING];
+    int len = 0;
+    MPI_Error_string(rc, msg, &len);
+    throw std::runtime_error(std::string("Logger: ") + what + " failed for " + path +
+                             " : " + std::string(msg, static_cast<std::size_t>(len)));
 }
 
 } // anonymous namespace
@@ -145,30 +258,335 @@ Logger& Logger::instance() {
     return inst;
 }
 
+Logger::Logger() {
+    const char* env = std::getenv("SF_LOG_ASYNC");
+    async_ = env && *env && std::string(env) != "0";
+    if (!async_) return;
+
+    const long ring = env_long("SF_LOG_RING", 8192);
+    batch_rows_ = static_cast<std::size_t>(std::max(1L, env_long("SF_LOG_BATCH", 512)));
+    flush_ms_   = static_cast<int>(std::max(1L, env_long("SF_LOG_FLUSH_MS", 250)));
+
+    ring_ = std::make_unique<MpscRing<Record>>(
+        round_up_pow2(static_cast<std::size_t>(std::max(2L, ring))));
+    writer_ = std::thread([this] { writerLoop_(); });
+}
+
 Logger::~Logger() {
+    if (writer_.joinable()) {
+        stop_.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lk(wake_mtx_);
+        }
+        wake_cv_.notify_one();
+        writer_.join();   // writer drains the ring before exiting
+    }
+
     std::lock_guard<std::mutex> lock(mtx_);
-    if (central_.is_open()) central_.close();
-    for (auto& kv : per_node_) {
-        if (kv.second.is_open()) kv.second.close();
+    for (auto& kv : sinks_) {
+        Sink& s = *kv.second;
+        std::lock_guard<std::mutex> io(s.io_mtx);
+        if (s.csv.is_open()) s.csv.close();
+        if (s.dict.is_open()) s.dict.close();
+        if (s.bin) s.bin->close();
     }
 }
 
+// Look up (or create) the sink for a subsystem, under the calling thread's
+// ScopedPrefix. Sinks are never removed (closeStreams() only closes their
+// files), so the returned reference stays valid for the Logger's lifetime.
+Logger::Sink& Logger::lookup_(const std::string& subsystem) {
+    // Per-thread scratch name: no allocation once a sink exists.
+    thread_local std::string t_name;
+    const std::string* name = &subsystem;
+    if (!t_stream_prefix.empty()) {
+        t_name.assign(t_stream_prefix);
+        t_name += subsystem;
+        name = &t_name;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    auto it = sinks_.find(*name);
+    if (it == sinks_.end()) {
+        auto s = std::make_unique<Sink>();
+        s->name = *name;
+        it = sinks_.emplace(*name, std::move(s)).first;
+    }
+    return *it->second;
+}
+
+Logger::ScopedPrefix::ScopedPrefix(const std::string& prefix)
+    : saved_(t_stream_prefix) {
+    t_stream_prefix += prefix;
+}
+
+Logger::ScopedPrefix::~ScopedPrefix() {
+    t_stream_prefix = saved_;
+}
+
+Logger::ScopedDiscard::ScopedDiscard() {
+    ++t_discard_depth;
+}
+
+Logger::ScopedDiscard::~ScopedDiscard() {
+    --t_discard_depth;
+}
+
+std::string Logger::directory() {
+    return resolve_base_dir().string();
+}
+
+std::map<std::string, std::uint64_t> Logger::fileOffsets() {
+    flush();
+
+    const fs::path base = resolve_base_dir();
+    std::map<std::string, std::uint64_t> out;
+    auto record = [&](const std::string& file) {
+        std::error_code ec;
+        const auto size = fs::file_size(base / file, ec);
+        if (!ec) out[file] = static_cast<std::uint64_t>(size);
+    };
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& kv : sinks_) {
+        Sink& s = *kv.second;
+        std::lock_guard<std::mutex> io(s.io_mtx);
+        if (s.csv.is_open()) record(csv_file(kv.first));
+        if (s.dict.is_open()) record(dict_file(kv.first));
+        if (s.bin && s.bin->is_open()) record(bin_file(kv.first));
+    }
+    return out;
+}
+
+void Logger::resumeAppend(const std::map<std::string, std::uint64_t>& offsets) {
+    flush();
+
+    const fs::path base = resolve_base_dir();
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    // Anything already open on a rolled-back file is closed first; its next
+    // row reopens it in append mode.
+    for (auto& kv : sinks_) {
+        Sink& s = *kv.second;
+        std::lock_guard<std::mutex> io(s.io_mtx);
+        if (s.csv.is_open() && offsets.count(csv_file(kv.first))) {
+            s.csv.close();
+            s.numeric_open.store(false, std::memory_order_release);
+        }
+        if (s.dict.is_open() && offsets.count(dict_file(kv.first))) {
+            s.dict.close();
+            s.codes.clear();
+        }
+        if (s.bin && offsets.count(bin_file(kv.first))) {
+            s.bin->close();
+            s.bin.reset();
+            s.numeric_open.store(false, std::memory_order_release);
+        }
+    }
+
+    std::lock_guard<std::mutex> rl(resume_mtx_);
+    for (const auto& kv : offsets) {
+        const fs::path p = base / kv.first;
+        std::error_code ec;
+        const auto size = fs::file_size(p, ec);
+        if (ec || size < kv.second) {
+            throw std::runtime_error(
+                "Logger: cannot resume " + p.string() +
+                (ec ? " : " + ec.message() : " : file is shorter than at the checkpoint")
+            );
+        }
+        fs::resize_file(p, kv.second, ec);
+        if (ec) {
+            throw std::runtime_error(
+                "Logger: failed to truncate " + p.string() + " : " + ec.message()
+            );
+        }
+        resume_files_.insert(kv.first);
+    }
+}
+
+bool Logger::takeResumed_(const std::string& file) {
+    std::lock_guard<std::mutex> rl(resume_mtx_);
+    return resume_files_.erase(file) != 0;
+}
+
+void Logger::closeStreams(const std::string& prefix) {
+    flush();
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& kv : sinks_) {
+        if (kv.first.compare(0, prefix.size(), prefix) != 0) continue;
+        Sink& s = *kv.second;
+        std::lock_guard<std::mutex> io(s.io_mtx);
+        if (s.csv.is_open()) s.csv.close();
+        if (s.dict.is_open()) s.dict.close();
+        s.codes.clear();
+        if (s.bin) {
+            s.bin->close();
+            s.bin.reset();
+        }
+        s.numeric_open.store(false, std::memory_order_release);
+    }
+}
+
+// Open the CSV file used for text rows (tall log() and string log_wide()).
+// Caller holds s.io_mtx.
+void Logger::openText_(Sink& s, const std::vector<std::string>* wide_cols, bool is_wide) {
+    if (s.shared) {
+        throw std::runtime_error("Logger: text rows on shared stream '" + s.name + "'");
+    }
+    if (!s.csv.is_open()) {
+        open_csv_for_subsystem(s.csv, s.name, wide_cols, is_wide,
+                               takeResumed_(csv_file(s.name)));
+    }
+}
+
+// Opens the sink's dictionary on its first string row: fresh with a header,
+// or, for a resumed file, after its last entry with the codes reloaded.
+// Caller holds s.io_mtx.
+void Logger::openDict_(Sink& s) {
+    if (s.dict.is_open()) return;
+    const fs::path path = ensure_base_dir() / dict_file(s.name);
+    const bool append = takeResumed_(dict_file(s.name));
+    s.codes.clear();
+    if (append) {
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        const auto rows = parseCsvRecords(text.str());
+        for (std::size_t r = 1; r < rows.size(); ++r) {   // row 0 is the header
+            if (rows[r].size() != 3) continue;
+            const std::size_t col = static_cast<std::size_t>(std::stoul(rows[r][0]));
+            if (col >= s.codes.size()) s.codes.resize(col + 1);
+            s.codes[col].emplace(rows[r][2], std::stol(rows[r][1]));
+        }
+    }
+    try {
+        s.dict.open(path.string(), append, LogCodec::None);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Logger: failed to open log file " + path.string());
+    }
+    if (!append) {
+        s.dict << "column,code,value\n";
+    }
+}
+
+// Code for value in column col; a new value is appended to the dictionary
+// (and flushed) before the row that uses it. Caller holds s.io_mtx.
+long Logger::dictCode_(Sink& s, std::size_t col, std::string_view value) {
+    if (col >= s.codes.size()) s.codes.resize(col + 1);
+    auto& codes = s.codes[col];
+    auto it = codes.find(value);
+    if (it != codes.end()) return it->second;
+
+    const long code = static_cast<long>(codes.size());
+    codes.emplace(std::string(value), code);
+    s.dict << col << ',' << code << ',';
+    write_csv_field(s.dict, value);
+    s.dict << '\n';
+    s.dict.flush();
+    return code;
+}
+
+// Open the output for numeric wide rows on first use: .sfb for
+// SF_LOG_FORMAT=bin, otherwise the CSV file. The header comes from the
+// registered schema, or from the first log_wide() call's column list.
+void Logger::openNumeric_(Sink& s, const std::vector<std::string>& cols) {
+    if (s.numeric_open.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    if (s.numeric_open.load(std::memory_order_relaxed)) return;
+
+    if (s.columns.empty()) s.columns = cols;
+    if (s.shared) {
+        // Buffered in memory; flushShared() opens the file.
+    } else if (resolve_log_format() == LogFormat::Binary) {
+        s.bin = open_binary_for_subsystem(s.name, s.columns, takeResumed_(bin_file(s.name)));
+    } else {
+        openText_(s, &s.columns, /*is_wide=*/true);
+    }
+    s.numeric_open.store(true, std::memory_order_release);
+}
+
+// Route one full-width numeric row to the async ring or write it now.
+void Logger::commitNumeric_(Sink& s, int tick, double time,
+                            const double* vals, std::size_t ncols) {
+    if (s.shared) {
+        appendShared_(s, tick, time, vals, ncols);
+        return;
+    }
+    if (async_ && ncols <= kAsyncMaxCols) {
+        pushAsync_(s, tick, time, vals, ncols);
+        return;
+    }
+    if (async_) {
+        sync_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    writeNumericRow_(s, tick, time, vals, ncols);
+    if (!s.bin) s.csv.flush();
+}
+
+Logger::Sink& Logger::registerColumns_(const std::string& subsystem,
+                                       const std::vector<std::string>& columns) {
+    Sink& s = lookup_(subsystem);
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    if (s.columns.empty()) {
+        s.columns = columns;
+    } else if (s.columns != columns) {
+        throw std::runtime_error(
+            "Logger: schema for '" + subsystem + "' re-registered with different columns"
+        );
+    }
+    return s;
+}
+
+LogHandle Logger::registerSchema(const std::string& subsystem,
+                                 const std::vector<std::string>& columns) {
+    Sink& s = registerColumns_(subsystem, columns);
+    return LogHandle(this, &s, columns.size());
+}
+
+TextLogHandle Logger::registerTextSchema(const std::string& subsystem,
+                                         const std::vector<std::string>& columns) {
+    Sink& s = registerColumns_(subsystem, columns);
+    return TextLogHandle(this, &s, columns.size());
+}
+
+// Format one numeric wide row into whichever output the sink uses.
+// Caller holds s.io_mtx.
+void Logger::writeNumericRow_(Sink& s, std::int64_t tick, double time,
+                              const double* vals, std::size_t ncols) {
+    if (s.bin) {
+        // Fixed-width columns, chunked; no per-row formatting or flush.
+        s.bin->append(tick, time, vals, ncols);
+        return;
+    }
+
+    std::ostream& out = s.csv;
+    out << static_cast<int>(tick) << ',' << time;
+    for (std::size_t i = 0; i < ncols; ++i) {
+        out << ',' << vals[i];
+    }
+    out << '\n';
+}
+
 // Tall/long format: one row per (tick, key, value)
 void Logger::log(const std::string& subsystem,
                  int tick, double time,
                  const std::map<std::string, double>& values) {
-    std::lock_guard<std::mutex> lock(mtx_);
-
-    std::ofstream& out = get_stream_for_subsystem(
-        subsystem,
-        per_node_,
-        /*wide_cols=*/nullptr,
-        /*is_wide=*/false
-    );
+    SF_PROFILE_SCOPE(ProfileCat::Log, "Logger::log");
+    if (t_discard_depth > 0) return;
+    Sink& s = lookup_(subsystem);
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    openText_(s, /*wide_cols=*/nullptr, /*is_wide=*/false);
 
+    std::ostream& out = s.csv;
     for (const auto& kv : values) {
-        out << tick << ',' << time << ','
-            << escape_csv_field(kv.first) << ',' << kv.second << '\n';
+        out << tick << ',' << time << ',';
+        write_csv_field(out, kv.first);
+        out << ',' << kv.second << '\n';
     }
     out.flush();
 }
@@ -176,27 +594,24 @@ void Logger::log(const std::string& subsystem,
 // Wide format: one row per tick with multiple named NUMERIC columns
 //
 // This is the original API. It is intentionally preserved so existing code
-// continues to compile and behave exactly as before.
+// continues to compile and behave exactly as before. Values beyond the
+// column list are dropped; missing values are written as 0.0.
 void Logger::log_wide(const std::string& subsystem,
                       int tick, double time,
                       const std::vector<std::string>& cols,
                       const std::vector<double>& vals) {
-    std::lock_guard<std::mutex> lock(mtx_);
+    SF_PROFILE_SCOPE(ProfileCat::Log, "Logger::log_wide");
+    if (t_discard_depth > 0) return;
+    Sink& s = lookup_(subsystem);
+    openNumeric_(s, cols);
 
-    std::ofstream& out = get_stream_for_subsystem(
-        subsystem,
-        per_node_,
-        &cols,
-        /*is_wide=*/true
-    );
-
-    out << tick << ',' << time;
-    for (std::size_t i = 0; i < cols.size(); ++i) {
-        double v = (i < vals.size() ? vals[i] : 0.0);
-        out << ',' << v;
+    if (vals.size() >= cols.size()) {
+        commitNumeric_(s, tick, time, vals.data(), cols.size());
+    } else {
+        std::vector<double> padded(vals);
+        padded.resize(cols.size(), 0.0);
+        commitNumeric_(s, tick, time, padded.data(), padded.size());
     }
-    out << '\n';
-    out.flush();
 }
 
 // Wide format overload: one row per tick with multiple named STRING columns
@@ -207,20 +622,447 @@ void Logger::log_wide(const std::string& subsystem,
                       int tick, double time,
                       const std::vector<std::string>& cols,
                       const std::vector<std::string>& vals) {
-    std::lock_guard<std::mutex> lock(mtx_);
+    SF_PROFILE_SCOPE(ProfileCat::Log, "Logger::log_wide(text)");
+    if (t_discard_depth > 0) return;
+    Sink& s = lookup_(subsystem);
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    openText_(s, &cols, /*is_wide=*/true);
+
+    std::ostream& out = s.csv;
+    static const std::string kEmpty;
+    if (resolve_log_dict()) {
+        openDict_(s);
+        out << tick << ',' << time;
+        for (std::size_t i = 0; i < cols.size(); ++i) {
+            out << ',' << dictCode_(s, i, i < vals.size() ? vals[i] : kEmpty);
+        }
+    } else {
+        out << tick << ',' << time;
+        for (std::size_t i = 0; i < cols.size(); ++i) {
+            out << ',';
+            write_csv_field(out, i < vals.size() ? vals[i] : kEmpty);
+        }
+    }
+    out << '\n';
+    out.flush();
+}
 
-    std::ofstream& out = get_stream_for_subsystem(
-        subsystem,
-        per_node_,
-        &cols,
-        /*is_wide=*/true
-    );
+// One string wide row of a registered text schema (s.columns is its header).
+void Logger::writeTextRow_(Sink& s, int tick, double time,
+                           const std::string_view* vals, std::size_t nvals) {
+    SF_PROFILE_SCOPE(ProfileCat::Log, "TextLogHandle::write");
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    openText_(s, &s.columns, /*is_wide=*/true);
 
+    std::ostream& out = s.csv;
     out << tick << ',' << time;
-    for (std::size_t i = 0; i < cols.size(); ++i) {
-        const std::string v = (i < vals.size() ? vals[i] : std::string{});
-        out << ',' << escape_csv_field(v);
+    if (resolve_log_dict()) {
+        openDict_(s);
+        for (std::size_t i = 0; i < nvals; ++i) out << ',' << dictCode_(s, i, vals[i]);
+    } else {
+        for (std::size_t i = 0; i < nvals; ++i) {
+            out << ',';
+            write_csv_field(out, vals[i]);
+        }
     }
     out << '\n';
     out.flush();
-}
\ No newline at end of file
+}
+
+// ---------------- Async writer ----------------
+
+void Logger::pushAsync_(Sink& s, int tick, double time,
+                        const double* vals, std::size_t ncols) {
+    auto fill = [&](Record& r) {
+        r.sink  = &s;
+        r.tick  = tick;
+        r.time  = time;
+        r.ncols = static_cast<std::uint32_t>(ncols);
+        std::copy(vals, vals + ncols, r.vals);
+    };
+
+    if (!ring_->tryPush(fill)) {
+        // Back-pressure: the writer is behind. Wake it and spin until a slot
+        // frees up rather than dropping rows.
+        ring_full_stalls_.fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t spins = 0;
+        do {
+            wake_cv_.notify_one();
+            std::this_thread::yield();
+            ++spins;
+        } while (!ring_->tryPush(fill));
+        stall_spins_.fetch_add(spins, std::memory_order_relaxed);
+    }
+
+    const std::uint64_t pushed = rows_pushed_.fetch_add(1, std::memory_order_release) + 1;
+    const std::uint64_t depth  = pushed - rows_written_.load(std::memory_order_relaxed);
+    if (depth > max_depth_.load(std::memory_order_relaxed)) {
+        max_depth_.store(depth, std::memory_order_relaxed);
+    }
+
+    // Only pay for a notify when the writer is actually parked.
+    if (writer_sleeping_.load(std::memory_order_acquire) && depth >= batch_rows_) {
+        wake_cv_.notify_one();
+    }
+}
+
+void Logger::flushAllSinks_(bool seal) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& kv : sinks_) {
+        Sink& s = *kv.second;
+        if (s.shared) continue;
+        std::lock_guard<std::mutex> io(s.io_mtx);
+        if (seal) {
+            if (s.csv.is_open()) s.csv.seal();
+            if (s.bin) s.bin->seal();
+        } else {
+            if (s.csv.is_open()) s.csv.flush();
+            if (s.bin) s.bin->flush();
+        }
+        s.dirty = false;
+    }
+}
+
+void Logger::writerLoop_() {
+    using clock = std::chrono::steady_clock;
+    auto last_flush = clock::now();
+    std::size_t since_flush = 0;
+
+    for (;;) {
+        std::size_t popped = 0;
+        while (ring_->tryPop([&](const Record& r) {
+                   Sink& s = *r.sink;
+                   std::lock_guard<std::mutex> io(s.io_mtx);
+                   writeNumericRow_(s, r.tick, r.time, r.vals, r.ncols);
+                   s.dirty = true;
+               })) {
+            ++popped;
+            if (popped % 64 == 0) {
+                rows_written_.fetch_add(64, std::memory_order_release);
+                ring_->publishConsumerPos();
+            }
+        }
+        rows_written_.fetch_add(popped % 64, std::memory_order_release);
+        ring_->publishConsumerPos();
+        since_flush += popped;
+
+        const auto now = clock::now();
+        const bool time_due = now - last_flush >= std::chrono::milliseconds(flush_ms_);
+        if (since_flush > 0 && (since_flush >= batch_rows_ || time_due)) {
+            flushAllSinks_(/*seal=*/false);
+            flushes_.fetch_add(1, std::memory_order_relaxed);
+            since_flush = 0;
+            last_flush = now;
+        }
+        if (popped) {
+            drained_cv_.notify_all();
+        }
+
+        const bool stopping = stop_.load(std::memory_order_acquire);
+        if (stopping && popped == 0) {
+            flushAllSinks_(/*seal=*/false);
+            drained_cv_.notify_all();
+            return;
+        }
+        if (popped == 0) {
+            std::unique_lock<std::mutex> lk(wake_mtx_);
+            writer_sleeping_.store(true, std::memory_order_release);
+            wake_cv_.wait_for(lk, std::chrono::milliseconds(flush_ms_));
+            writer_sleeping_.store(false, std::memory_order_release);
+        }
+    }
+}
+
+void Logger::flush() {
+    if (async_) {
+        const std::uint64_t target = rows_pushed_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lk(wake_mtx_);
+        while (rows_written_.load(std::memory_order_acquire) < target) {
+            wake_cv_.notify_one();
+            drained_cv_.wait_for(lk, std::chrono::milliseconds(5));
+        }
+    }
+    flushAllSinks_(/*seal=*/true);
+}
+
+Logger::Stats Logger::stats() const {
+    Stats st;
+    st.rows_pushed      = rows_pushed_.load(std::memory_order_relaxed);
+    st.rows_written     = rows_written_.load(std::memory_order_relaxed);
+    st.ring_full_stalls = ring_full_stalls_.load(std::memory_order_relaxed);
+    st.stall_spins      = stall_spins_.load(std::memory_order_relaxed);
+    st.sync_fallbacks   = sync_fallbacks_.load(std::memory_order_relaxed);
+    st.flushes          = flushes_.load(std::memory_order_relaxed);
+    st.max_depth        = max_depth_.load(std::memory_order_relaxed);
+    st.ring_capacity    = ring_ ? ring_->capacity() : 0;
+    return st;
+}
+
+// ---------------- MPI-IO shared streams ----------------
+
+void Logger::attachComm(MPI_Comm comm) {
+    if (comm_ != MPI_COMM_NULL) return;
+    MPI_Comm_dup(comm, &comm_);
+    MPI_Comm_rank(comm_, &comm_rank_);
+    MPI_Comm_size(comm_, &comm_size_);
+
+    const char* env = std::getenv("SF_LOG_BACKEND");
+    const std::string backend = (env && *env) ? env : "posix";
+    if (backend == "mpiio") {
+        mpiio_ = true;
+    } else if (backend != "posix") {
+        if (comm_rank_ == 0) {
+            std::cerr << "[Logger] Unknown SF_LOG_BACKEND='" << backend
+                      << "', falling back to posix\n";
+        }
+    }
+    shared_window_ = static_cast<int>(std::max(1L, env_long("SF_LOG_WINDOW", 64)));
+
+    if (!mpiio_) {
+        MPI_Comm_free(&comm_);   // rank and size are all the posix path needs
+        return;
+    }
+
+    const char* agg = std::getenv("SF_LOG_AGGREGATE");
+    if (agg && std::string(agg) == "node") {
+        MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, comm_rank_, MPI_INFO_NULL, &node_comm_);
+        int node_rank = 0;
+        MPI_Comm_rank(node_comm_, &node_rank);
+        MPI_Comm_split(comm_, node_rank == 0 ? 0 : MPI_UNDEFINED, comm_rank_, &io_comm_);
+    } else {
+        MPI_Comm_dup(comm_, &io_comm_);
+    }
+}
+
+LogHandle Logger::registerSharedSchema(const std::string& subsystem,
+                                       const std::vector<std::string>& columns) {
+    if (!mpiio_) {
+        return registerSchema(comm_size_ > 1 ? subsystem + "_r" + std::to_string(comm_rank_)
+                                             : subsystem,
+                              columns);
+    }
+
+    LogHandle h = registerSchema(subsystem, columns);
+    Sink& s = *h.sink_;
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    if (!s.shared) {
+        s.shared = true;
+        // The header leads rank 0's part of the first window.
+        if (comm_rank_ == 0) {
+            std::ostringstream os;
+            os << "tick,time_s";
+            for (const auto& c : columns) {
+                os << ',';
+                write_csv_field(os, c);
+            }
+            os << '\n';
+            s.pending = os.str();
+        }
+    }
+    return h;
+}
+
+// Same text as writeNumericRow_() produces for a CSV sink (%g is the
+// stream's default), appended straight to the sink's pending buffer.
+void Logger::appendShared_(Sink& s, int tick, double time,
+                           const double* vals, std::size_t ncols) {
+    char buf[32];
+    std::lock_guard<std::mutex> io(s.io_mtx);
+    s.pending.append(buf, static_cast<std::size_t>(
+                              std::snprintf(buf, sizeof(buf), "%d,%g", tick, time)));
+    for (std::size_t i = 0; i < ncols; ++i) {
+        s.pending.append(buf, static_cast<std::size_t>(
+                                  std::snprintf(buf, sizeof(buf), ",%g", vals[i])));
+    }
+    s.pending.push_back('\n');
+}
+
+std::vector<Logger::Sink*> Logger::sharedSinks_() {
+    std::vector<Sink*> out;
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& kv : sinks_) {      // name order, identical on every rank
+        if (kv.second->shared) out.push_back(kv.second.get());
+    }
+    return out;
+}
+
+void Logger::flushShared() {
+    if (!mpiio_ || comm_ == MPI_COMM_NULL) return;
+    flush();   // per-rank streams first, so a window never runs ahead of them
+
+    const std::vector<Sink*> sinks = sharedSinks_();
+    const int n = static_cast<int>(sinks.size());
+    int nmin = 0, nmax = 0;
+    MPI_Allreduce(&n, &nmin, 1, MPI_INT, MPI_MIN, comm_);
+    MPI_Allreduce(&n, &nmax, 1, MPI_INT, MPI_MAX, comm_);
+    if (nmin != nmax) {
+        throw std::runtime_error("Logger: ranks registered different shared streams (" +
+                                 std::to_string(nmin) + " vs " + std::to_string(nmax) + ")");
+    }
+    if (n == 0) return;
+
+    // The window moves to each sink's window buffer and pending gets the
+    // previous one back, so neither reallocates once warmed up.
+    for (int i = 0; i < n; ++i) {
+        std::lock_guard<std::mutex> io(sinks[i]->io_mtx);
+        sinks[i]->window.clear();
+        sinks[i]->window.swap(sinks[i]->pending);
+    }
+
+    // Node aggregation: each node's first rank collects the node's window.
+    if (node_comm_ != MPI_COMM_NULL) {
+        int node_rank = 0, node_size = 1;
+        MPI_Comm_rank(node_comm_, &node_rank);
+        MPI_Comm_size(node_comm_, &node_size);
+        std::vector<int> lens(static_cast<std::size_t>(node_rank == 0 ? node_size * n : 0));
+        std::vector<int> mine(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i) {
+            if (sinks[i]->window.size() > static_cast<std::size_t>(INT_MAX)) {
+                throw std::runtime_error("Logger: shared window over 2 GiB for '" + sinks[i]->name + "'");
+            }
+            mine[i] = static_cast<int>(sinks[i]->window.size());
+        }
+        MPI_Gather(mine.data(), n, MPI_INT, lens.data(), n, MPI_INT, 0, node_comm_);
+        for (int i = 0; i < n; ++i) {
+            std::vector<int> counts, displs;
+            std::string all;
+            if (node_rank == 0) {
+                counts.resize(static_cast<std::size_t>(node_size));
+                displs.resize(static_cast<std::size_t>(node_size));
+                long long total = 0;
+                for (int r = 0; r < node_size; ++r) {
+                    counts[r] = lens[static_cast<std::size_t>(r * n + i)];
+                    displs[r] = static_cast<int>(total);
+                    total += counts[r];
+                }
+                if (total > INT_MAX) {
+                    throw std::runtime_error("Logger: shared window over 2 GiB for '" + sinks[i]->name + "'");
+                }
+                all.resize(static_cast<std::size_t>(total));
+            }
+            MPI_Gatherv(sinks[i]->window.data(), mine[i], MPI_CHAR,
+                        node_rank == 0 && !all.empty() ? &all[0] : nullptr,
+                        counts.data(), displs.data(), MPI_CHAR, 0, node_comm_);
+            sinks[i]->window.swap(all);
+        }
+    }
+    if (io_comm_ == MPI_COMM_NULL) return;
+
+    int io_rank = 0;
+    MPI_Comm_rank(io_comm_, &io_rank);
+    std::vector<long long> len(static_cast<std::size_t>(n)), off(len.size(), 0), tot(len.size(), 0);
+    for (int i = 0; i < n; ++i) len[i] = static_cast<long long>(sinks[i]->window.size());
+    MPI_Exscan(len.data(), off.data(), n, MPI_LONG_LONG, MPI_SUM, io_comm_);
+    if (io_rank == 0) std::fill(off.begin(), off.end(), 0LL);
+    MPI_Allreduce(len.data(), tot.data(), n, MPI_LONG_LONG, MPI_SUM, io_comm_);
+
+    for (int i = 0; i < n; ++i) {
+        if (tot[i] == 0) continue;
+        Sink& s = *sinks[i];
+        const fs::path path = ensure_base_dir() / (s.name + ".csv");
+        if (s.fh == MPI_FILE_NULL) {
+            ensure_parent_dir(path);
+            check_mpi(MPI_File_open(io_comm_, path.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                    MPI_INFO_NULL, &s.fh),
+                      "MPI_File_open", path.string());
+            check_mpi(MPI_File_set_size(s.fh, 0), "MPI_File_set_size", path.string());
+            s.offset = 0;
+        }
+        if (len[i] > INT_MAX) {
+            throw std::runtime_error("Logger: shared window over 2 GiB for '" + s.name + "'");
+        }
+        MPI_Status st;
+        check_mpi(MPI_File_write_at_all(s.fh, s.offset + static_cast<MPI_Offset>(off[i]),
+                                        sinks[i]->window.data(), static_cast<int>(len[i]), MPI_CHAR, &st),
+                  "MPI_File_write_at_all", path.string());
+        s.offset += static_cast<MPI_Offset>(tot[i]);
+    }
+}
+
+void Logger::finishShared() {
+    if (!mpiio_ || comm_ == MPI_COMM_NULL) return;
+    flushShared();
+    for (Sink* s : sharedSinks_()) {
+        if (s->fh != MPI_FILE_NULL) MPI_File_close(&s->fh);
+    }
+    if (io_comm_ != MPI_COMM_NULL)   MPI_Comm_free(&io_comm_);
+    if (node_comm_ != MPI_COMM_NULL) MPI_Comm_free(&node_comm_);
+    MPI_Comm_free(&comm_);
+}
+
+// ---------------- LogHandle ----------------
+
+void LogHandle::checkValid_() const {
+    if (!sink_) {
+        throw std::runtime_error("LogHandle: used before Logger::registerSchema()");
+    }
+}
+
+LogHandle::Row LogHandle::row(int tick, double time) {
+    checkValid_();
+    if (++gen_ == 0) {
+        // Generation wrapped; clear stamps so stale marks cannot alias.
+        std::fill(stamp_.begin(), stamp_.end(), 0u);
+        gen_ = 1;
+    }
+    return Row(*this, tick, time);
+}
+
+LogHandle::Row& LogHandle::Row::set(std::size_t col, double v) {
+    if (col >= h_.width_) {
+        throw std::runtime_error(
+            "LogHandle: column " + std::to_string(col) + " out of range for '" +
+            h_.sink_->name + "' (width " + std::to_string(h_.width_) + ")"
+        );
+    }
+    if (h_.stamp_[col] != h_.gen_) {
+        h_.stamp_[col] = h_.gen_;
+        ++nset_;
+    }
+    h_.scratch_[col] = v;
+    return *this;
+}
+
+void LogHandle::Row::commit() {
+    if (nset_ != h_.width_) {
+        throw std::runtime_error(
+            "LogHandle: row for '" + h_.sink_->name + "' set " + std::to_string(nset_) +
+            " of " + std::to_string(h_.width_) + " columns"
+        );
+    }
+    h_.write(tick_, time_, h_.scratch_.data(), h_.width_);
+}
+
+void LogHandle::write(int tick, double time, std::initializer_list<double> vals) {
+    write(tick, time, vals.begin(), vals.size());
+}
+
+void LogHandle::write(int tick, double time, const double* vals, std::size_t n) {
+    checkValid_();
+    if (n != width_) {
+        throw std::runtime_error(
+            "LogHandle: row for '" + sink_->name + "' has " + std::to_string(n) +
+            " values, schema has " + std::to_string(width_)
+        );
+    }
+    if (t_discard_depth > 0) return;
+    SF_PROFILE_SCOPE(ProfileCat::Log, "LogHandle::write");
+    logger_->openNumeric_(*sink_, sink_->columns);
+    logger_->commitNumeric_(*sink_, tick, time, vals, n);
+}
+
+// ---------------- TextLogHandle ----------------
+
+void TextLogHandle::write(int tick, double time, std::initializer_list<std::string_view> vals) {
+    if (!sink_) {
+        throw std::runtime_error("TextLogHandle: used before Logger::registerTextSchema()");
+    }
+    if (vals.size() != width_) {
+        throw std::runtime_error(
+            "TextLogHandle: row for '" + sink_->name + "' has " + std::to_string(vals.size()) +
+            " values, schema has " + std::to_string(width_)
+        );
+    }
+    if (t_discard_depth > 0) return;
+    logger_->writeTextRow_(*sink_, tick, time, vals.begin(), vals.size());
+}
@@ -0,0 +1,291 @@
+// Sim/src/MissionProfile.cpp
+#include "MissionProfile.hpp"
+
+#include "Battery.hpp"
+#include "PowerBus.hpp"
+#include "SimulationEngine.hpp"
+#include "SolarArray.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// SolarArray reads its sunlight here; validate() drives it from the orbit.
+extern double g_orbit_solar_scale;
+
+namespace {
+
+constexpr int         kMaxTableOrbits = 1000;
+constexpr std::size_t kMaxTableTicks  = std::size_t{1} << 22;
+
+// The payload draw of the regular engine: a Loads-phase consumer.
+class ConstantLoad : public Subsystem {
+public:
+    ConstantLoad(PowerBus& bus, double watts) : Subsystem("MissionPayload"), bus_(bus), watts_(watts) {}
+    void initialize() override {}
+    void tick(const TickContext& ctx) override { (void)bus_.drawPower(watts_, ctx); }
+    void shutdown() override {}
+
+private:
+    PowerBus& bus_;
+    double    watts_;
+};
+
+} // anonymous namespace
+
+MissionProfile::MissionProfile(const SolarArray& solar, const Battery& battery,
+                               const OrbitModel& orbit, double dt, const MissionConfig& cfg)
+    : dt_(dt),
+      cfg_(cfg),
+      efficiency_(solar.getEfficiency()),
+      base_input_W_(solar.getBaseInputW()),
+      capacity_Wh_(battery.getCapacityWh()),
+      max_charge_W_(battery.getMaxChargeW()),
+      max_discharge_W_(battery.getMaxDischargeW()),
+      orbit0_(orbit),
+      charge_(battery.getCharge()) {
+    if (!(dt_ > 0.0) || !std::isfinite(dt_)) {
+        throw std::runtime_error("MissionProfile: tick step must be positive");
+    }
+    cfg_.base_load_W    = std::max(0.0, cfg_.base_load_W);
+    cfg_.payload_W      = std::max(0.0, cfg_.payload_W);
+    cfg_.orbits_per_row = std::max(1, cfg_.orbits_per_row);
+
+    // Shortest table that ends on an orbit boundary: L orbits = M ticks.
+    const double per_orbit = orbit.period_s() / dt_;
+    std::size_t ticks = 0;
+    for (int L = 1; L <= kMaxTableOrbits && ticks == 0; ++L) {
+        const double m = per_orbit * L;
+        const double r = std::round(m);
+        if (r >= 1.0 && std::abs(m - r) <= 1e-9 * m) {
+            ticks = static_cast<std::size_t>(r);
+            table_orbits_ = L;
+        }
+    }
+    if (ticks == 0 || ticks > kMaxTableTicks) {
+        throw std::runtime_error("MissionProfile: dt " + std::to_string(dt_) +
+                                 " s repeats the " + std::to_string(orbit.period_s()) +
+                                 " s orbit only after more than " +
+                                 std::to_string(kMaxTableTicks) + " ticks");
+    }
+
+    // Stepped like the wake loop: tick k sees the orbit after k steps.
+    OrbitModel o(orbit);
+    o.set_dt(dt_);
+    solar_W_.resize(ticks);
+    for (std::size_t j = 0; j < ticks; ++j) {
+        o.step();
+        solar_W_[j] = solar.outputFor(o.state().solar_scale);
+    }
+
+    // Tick j + 1 of the table belongs to orbit ceil((j + 1) L / M) - 1.
+    const std::size_t L = static_cast<std::size_t>(table_orbits_);
+    for (std::size_t k = 1; k <= L; ++k) orbit_end_.push_back(k * ticks / L);
+
+    row_.soc_min_Wh = row_.soc_max_Wh = charge_;
+}
+
+void MissionProfile::enableLog() {
+    log_ = Logger::instance().registerSchema(
+        "MissionOrbits",
+        {"first_tick", "orbits", "soc_min", "soc_max", "soc_mean", "charge_end_Wh",
+         "generated_Wh", "served_Wh", "deficit_Wh", "charged_Wh", "curtailed_Wh",
+         "sun_ticks", "deficit_ticks"});
+}
+
+void MissionProfile::run(long n) {
+    while (n > 0) {
+        const std::size_t end = orbit_end_[static_cast<std::size_t>(table_orbit_)];
+        const std::size_t seg = static_cast<std::size_t>(
+            std::min<long>(n, static_cast<long>(end - pos_)));
+        kernel_(pos_, pos_ + seg);
+        pos_ += seg;
+        n    -= static_cast<long>(seg);
+        if (pos_ == end) {
+            finishOrbit_();
+            if (pos_ == solar_W_.size()) {
+                pos_ = 0;
+                table_orbit_ = 0;
+            } else {
+                ++table_orbit_;
+            }
+        }
+    }
+}
+
+// The fused tick. Each draw is PowerBus::serve_ with Battery::discharge
+// inlined (a zero request changes nothing there either, so it needs no
+// early return); settlement is Battery::chargeFromSurplus.
+void MissionProfile::kernel_(std::size_t lo, std::size_t hi) {
+    const double* solar = solar_W_.data();
+    const double dt    = dt_;
+    const double h     = dt / 3600.0;
+    const double cap   = capacity_Wh_;
+    const double max_c = max_charge_W_;
+    const double max_d = max_discharge_W_;
+    const double loads[2] = {cfg_.base_load_W, cfg_.payload_W};
+    const double requested = loads[0] + loads[1];
+
+    double q = charge_;
+    Row r = row_;
+    long tick = tick_;
+
+    for (std::size_t j = lo; j < hi; ++j) {
+        ++tick;
+        const double gen = solar[j];
+        double avail  = gen > 0.0 ? gen : 0.0;   // PowerBus::addPower
+        double drawn  = 0.0;                     // from the battery this tick
+        double served = 0.0;
+
+        for (double req : loads) {
+            const double from_bus = std::min(req, avail);
+            avail -= from_bus;
+            const double remaining = req - from_bus;
+            const double allowed   = std::max(0.0, max_d - drawn);
+            const double batt_req  = std::min(remaining, allowed);
+
+            double w_out = 0.0;
+            if (batt_req > 0.0) {
+                const double deliverable  = std::min(batt_req, max_d);
+                const double max_possible = (q * 3600.0) / dt;
+                w_out = std::min(deliverable, max_possible);
+                q = std::clamp(q - w_out * h, 0.0, cap);
+                drawn += w_out;
+            }
+            served += from_bus + w_out;
+        }
+
+        const double q_before = q;
+        const double in_W = std::min(avail, max_c);
+        q = std::clamp(q + in_W * h, 0.0, cap);
+
+        const double deficit = requested - served;
+        r.gen_W      += gen;
+        r.served_W   += served;
+        r.deficit_W  += deficit;
+        r.surplus_W  += avail;
+        r.charged_Wh += q - q_before;
+        r.soc_sum_Wh += q;
+        r.soc_max_Wh  = std::max(r.soc_max_Wh, q);
+        if (q < r.soc_min_Wh) {
+            r.soc_min_Wh   = q;
+            r.soc_min_tick = tick;
+        }
+        r.sun_ticks           += gen > 0.0 ? 1 : 0;
+        r.orbit_deficit_ticks += deficit > 0.0 ? 1 : 0;
+    }
+
+    r.ticks += static_cast<long>(hi - lo);
+    charge_ = q;
+    row_    = r;
+    tick_   = tick;
+}
+
+void MissionProfile::finishOrbit_() {
+    Row& r = row_;
+    ++r.orbits;
+    ++summary_.orbits;
+    if (r.orbit_deficit_ticks > 0) ++summary_.deficit_orbits;
+    r.deficit_ticks += r.orbit_deficit_ticks;
+    r.orbit_deficit_ticks = 0;
+    if (r.orbits < cfg_.orbits_per_row) return;
+
+    addRow_(summary_, r);
+
+    if (log_.valid()) {
+        const double h = dt_ / 3600.0;
+        const double inv_cap = capacity_Wh_ > 0.0 ? 1.0 / capacity_Wh_ : 0.0;
+        const double mean = r.ticks > 0 ? r.soc_sum_Wh / static_cast<double>(r.ticks) : charge_;
+        log_.write(static_cast<int>(tick_), static_cast<double>(tick_) * dt_,
+                   {static_cast<double>(r.first_tick), static_cast<double>(r.orbits),
+                    r.soc_min_Wh * inv_cap, r.soc_max_Wh * inv_cap, mean * inv_cap, charge_,
+                    r.gen_W * h, r.served_W * h, r.deficit_W * h, r.charged_Wh,
+                    r.surplus_W * h - r.charged_Wh,
+                    static_cast<double>(r.sun_ticks), static_cast<double>(r.deficit_ticks)});
+    }
+
+    r = Row{};
+    r.first_tick = tick_ + 1;
+    r.soc_min_Wh = r.soc_max_Wh = charge_;
+}
+
+void MissionProfile::addRow_(MissionSummary& m, const Row& r) const {
+    const double h = dt_ / 3600.0;
+    m.ticks         += r.ticks;
+    m.generated_Wh  += r.gen_W * h;
+    m.served_Wh     += r.served_W * h;
+    m.deficit_Wh    += r.deficit_W * h;
+    m.deficit_ticks += r.deficit_ticks + r.orbit_deficit_ticks;
+    const double soc_min = capacity_Wh_ > 0.0 ? r.soc_min_Wh / capacity_Wh_ : 0.0;
+    if (r.ticks > 0 && soc_min < m.soc_min) {
+        m.soc_min      = soc_min;
+        m.soc_min_tick = r.soc_min_tick;
+    }
+}
+
+MissionSummary MissionProfile::summary() const {
+    MissionSummary m = summary_;
+    if (row_.ticks > 0) {
+        addRow_(m, row_);
+        if (row_.orbit_deficit_ticks > 0) ++m.deficit_orbits;   // the open orbit
+    }
+    return m;
+}
+
+MissionProfile::Check MissionProfile::validate(long n) const {
+    Check c;
+    c.requested = n;
+    c.ticks = std::max(0L, n);
+    if (c.ticks == 0) return c;
+
+    Logger::ScopedDiscard discard;
+    const double saved_scale = g_orbit_solar_scale;
+
+    PowerBus     bus;
+    SolarArray   solar(efficiency_, base_input_W_);
+    Battery      battery(capacity_Wh_);
+    ConstantLoad payload(bus, cfg_.payload_W);
+    bus.setBattery(&battery);
+    solar.setPowerBus(&bus);
+    battery.setPowerBus(&bus);
+
+    SimulationEngine engine;
+    engine.addSubsystem(&solar);
+    engine.addSubsystem(&payload);
+    engine.addSubsystem(&bus);
+    engine.addSubsystem(&battery);
+    engine.setTickStep(dt_);
+    engine.setBaseLoadW(cfg_.base_load_W);
+    engine.initialize();
+
+    MissionProfile k(*this);
+    k.log_ = LogHandle();
+    k.charge_ = battery.getCharge();
+    k.pos_ = 0;
+    k.table_orbit_ = 0;
+    k.tick_ = 0;
+    k.row_ = Row{};
+    k.row_.soc_min_Wh = k.row_.soc_max_Wh = k.charge_;
+
+    // The orbit is stepped for every tick, so windows past one table check
+    // the kernel's wrap back to the table start against the live orbit.
+    OrbitModel orbit(orbit0_);
+    orbit.set_dt(dt_);
+    const std::size_t table = solar_W_.size();
+    for (long i = 0; i < c.ticks; ++i) {
+        orbit.step();
+        g_orbit_solar_scale = orbit.state().solar_scale;
+        engine.tick();
+        k.run(1);
+        c.max_charge_diff_Wh = std::max(c.max_charge_diff_Wh,
+                                        std::abs(battery.getCharge() - k.charge_));
+        c.max_solar_diff_W = std::max(c.max_solar_diff_W,
+                                      std::abs(solar.getLastOutput() -
+                                               solar_W_[static_cast<std::size_t>(i) % table]));
+    }
+    engine.shutdown();
+
+    g_orbit_solar_scale = saved_scale;
+    return c;
+}
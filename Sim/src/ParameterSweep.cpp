@@ -0,0 +1,605 @@
+// Sim/src/ParameterSweep.cpp
+#include "ParameterSweep.hpp"
+
+#include "Checkpoint.hpp"
+#include "Logger.hpp"
+#include "ScheduleCompiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kTagRequest = 7301;   // worker -> rank 0: next member please
+constexpr int kTagReply   = 7302;   // rank 0 -> worker: member index or -1
+constexpr int kTagDone    = 7303;   // rank -> rank 0: all local workers finished
+
+// Fields per result when results are gathered to rank 0.
+constexpr int kResultFields = 16;
+
+std::string trim(const std::string& s) {
+    const auto b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    const auto e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+std::vector<std::string> split_values(const std::string& s) {
+    std::string t = s;
+    std::replace(t.begin(), t.end(), ',', ' ');
+    std::istringstream in(t);
+    std::vector<std::string> out;
+    std::string tok;
+    while (in >> tok) out.push_back(tok);
+    return out;
+}
+
+bool parse_double(const std::string& s, double& out) {
+    const char* b = s.c_str();
+    char* e = nullptr;
+    out = std::strtod(b, &e);
+    return e != b && e && *e == '\0' && std::isfinite(out);
+}
+
+// "v" or "a:step:b" (inclusive) appended to out.
+void expand_numeric(const std::string& tok, const std::string& where,
+                    std::vector<double>& out) {
+    const auto c1 = tok.find(':');
+    if (c1 == std::string::npos) {
+        double v = 0.0;
+        if (!parse_double(tok, v)) {
+            throw std::runtime_error("ParameterSweep: " + where + ": bad value '" + tok + "'");
+        }
+        out.push_back(v);
+        return;
+    }
+
+    const auto c2 = tok.find(':', c1 + 1);
+    double a = 0.0, step = 0.0, b = 0.0;
+    if (c2 == std::string::npos ||
+        !parse_double(tok.substr(0, c1), a) ||
+        !parse_double(tok.substr(c1 + 1, c2 - c1 - 1), step) ||
+        !parse_double(tok.substr(c2 + 1), b) ||
+        !(step > 0.0) || b < a) {
+        throw std::runtime_error("ParameterSweep: " + where + ": bad range '" + tok +
+                                 "' (expected start:step:end with step > 0)");
+    }
+    // Small slack so 0.2:0.05:0.3 includes 0.3 despite rounding.
+    const long n = static_cast<long>(std::floor((b - a) / step + 1e-9)) + 1;
+    for (long k = 0; k < n; ++k) out.push_back(a + static_cast<double>(k) * step);
+}
+
+std::vector<std::string> list_job_files(const std::string& dir) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file() && it->path().extension() == ".txt") {
+            out.push_back(it->path().filename().string());
+        }
+    }
+    if (ec) {
+        throw std::runtime_error("ParameterSweep: cannot list jobs directory " + dir +
+                                 " : " + ec.message());
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::string job_path(const std::string& name, const std::string& jobsDir) {
+    if (name.find('/') != std::string::npos) return name;
+    return jobsDir + "/" + name;
+}
+
+// Rows as the wake loader reads them (through the compiled schedule cache);
+// malformed rows are counted and skipped.
+std::vector<SimHelpers::Job> load_jobs(const std::string& path, int& skipped) {
+    const CompiledSchedule s = ScheduleCompiler::load(path, ScheduleCacheMode::Auto);
+    if (!s.found) throw std::runtime_error("ParameterSweep: failed to open job file " + path);
+    skipped = s.rows_skipped;
+    return s.jobs;
+}
+
+void pack(const SweepMemberResult& r, std::vector<double>& out) {
+    const double v[kResultFields] = {
+        static_cast<double>(r.member), static_cast<double>(r.rank),
+        static_cast<double>(r.ticks), static_cast<double>(r.jobs),
+        static_cast<double>(r.skipped_rows),
+        r.battery_final_Wh, r.battery_min_Wh, r.solar_Wh,
+        r.effusion_heat_Wh, r.substrate_heat_Wh, r.unmet_heat_Wh,
+        r.effusion_max_K, r.effusion_final_K, r.substrate_max_K, r.substrate_final_K,
+        r.wall_s
+    };
+    out.insert(out.end(), v, v + kResultFields);
+}
+
+SweepMemberResult unpack(const double* v) {
+    SweepMemberResult r;
+    r.member            = static_cast<int>(v[0]);
+    r.rank              = static_cast<int>(v[1]);
+    r.ticks             = static_cast<int>(v[2]);
+    r.jobs              = static_cast<int>(v[3]);
+    r.skipped_rows      = static_cast<int>(v[4]);
+    r.battery_final_Wh  = v[5];
+    r.battery_min_Wh    = v[6];
+    r.solar_Wh          = v[7];
+    r.effusion_heat_Wh  = v[8];
+    r.substrate_heat_Wh = v[9];
+    r.unmet_heat_Wh     = v[10];
+    r.effusion_max_K    = v[11];
+    r.effusion_final_K  = v[12];
+    r.substrate_max_K   = v[13];
+    r.substrate_final_K = v[14];
+    r.wall_s            = v[15];
+    return r;
+}
+
+std::string fmt(double v) {
+    std::ostringstream oss;
+    oss.precision(12);
+    oss << v;
+    return oss.str();
+}
+
+} // anonymous namespace
+
+std::vector<SweepMemberParams> ParameterSweep::loadSpec(const std::string& path,
+                                                        const std::string& jobsDir,
+                                                        double defaultDt) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("ParameterSweep: failed to open spec " + path);
+    }
+
+    using Field = double SweepMemberParams::*;
+    struct NumericAxis { const char* name; Field field; };
+    static const NumericAxis kAxes[] = {
+        {"solar_efficiency",    &SweepMemberParams::solar_efficiency},
+        {"solar_base_input_W",  &SweepMemberParams::solar_base_input_W},
+        {"battery_capacity_Wh", &SweepMemberParams::battery_capacity_Wh},
+        {"heater_max_draw_W",   &SweepMemberParams::heater_max_draw_W},
+        {"dt",                  &SweepMemberParams::dt},
+    };
+
+    // One entry per spec line, in file order. field == nullptr is job_file.
+    struct Axis {
+        std::string name;
+        Field field = nullptr;
+        std::vector<double> values;
+        std::vector<std::string> files;
+        std::size_t size() const { return field ? values.size() : files.size(); }
+    };
+    std::vector<Axis> axes;
+
+    std::string line;
+    int lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        const auto hash = line.find('#');
+        const std::string t = trim(hash == std::string::npos ? line : line.substr(0, hash));
+        if (t.empty()) continue;
+
+        const std::string where = path + ":" + std::to_string(lineno);
+        const auto eq = t.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("ParameterSweep: " + where + ": expected 'name = values'");
+        }
+
+        Axis axis;
+        axis.name = trim(t.substr(0, eq));
+        const auto tokens = split_values(t.substr(eq + 1));
+        if (tokens.empty()) {
+            throw std::runtime_error("ParameterSweep: " + where + ": axis '" + axis.name +
+                                     "' has no values");
+        }
+        for (const auto& a : axes) {
+            if (a.name == axis.name) {
+                throw std::runtime_error("ParameterSweep: " + where + ": axis '" + axis.name +
+                                         "' given twice");
+            }
+        }
+
+        if (axis.name == "job_file") {
+            for (const auto& tok : tokens) {
+                if (tok == "*") {
+                    const auto all = list_job_files(jobsDir);
+                    if (all.empty()) {
+                        throw std::runtime_error("ParameterSweep: " + where +
+                                                 ": no .txt job files in " + jobsDir);
+                    }
+                    axis.files.insert(axis.files.end(), all.begin(), all.end());
+                } else if (tok == "none") {
+                    axis.files.emplace_back();
+                } else {
+                    axis.files.push_back(tok);
+                }
+            }
+        } else {
+            for (const auto& ax : kAxes) {
+                if (axis.name == ax.name) axis.field = ax.field;
+            }
+            if (!axis.field) {
+                throw std::runtime_error("ParameterSweep: unknown axis '" + axis.name +
+                                         "' in " + where);
+            }
+            for (const auto& tok : tokens) expand_numeric(tok, where, axis.values);
+            for (double v : axis.values) {
+                const bool ok = (axis.field == &SweepMemberParams::dt) ? v > 0.0 : v >= 0.0;
+                if (!ok) {
+                    throw std::runtime_error("ParameterSweep: " + where + ": axis '" +
+                                             axis.name + "' value " + fmt(v) + " out of range");
+                }
+            }
+        }
+        axes.push_back(std::move(axis));
+    }
+
+    SweepMemberParams base;
+    base.dt = defaultDt;
+
+    std::size_t total = 1;
+    for (const auto& a : axes) total *= a.size();
+
+    // Mixed-radix counter over the axes, last axis fastest.
+    std::vector<SweepMemberParams> members;
+    members.reserve(total);
+    for (std::size_t m = 0; m < total; ++m) {
+        SweepMemberParams p = base;
+        std::size_t rem = m;
+        for (std::size_t k = axes.size(); k-- > 0;) {
+            const Axis& a = axes[k];
+            const std::size_t idx = rem % a.size();
+            rem /= a.size();
+            if (a.field) p.*(a.field) = a.values[idx];
+            else         p.job_file = a.files[idx];
+        }
+        members.push_back(p);
+    }
+
+    if (members.empty()) {
+        throw std::runtime_error("ParameterSweep: spec " + path + " expands to no members");
+    }
+    return members;
+}
+
+// ---------------- SweepHarness ----------------
+
+SweepHarness::SweepHarness(const SweepMemberParams& p, const ThermalIntegratorConfig& thermal,
+                           const std::string& subdir, std::vector<SimHelpers::Job> jobs)
+    : dt_(p.dt),
+      jobs_(std::move(jobs)),
+      solar_(p.solar_efficiency, p.solar_base_input_W),
+      battery_(p.battery_capacity_Wh),
+      heater_(p.heater_max_draw_W),
+      growth_(/*gridN=*/32),
+      substrateHeater_(/*maxPowerW=*/3000.0, /*wafer_radius_m=*/0.15) {
+    // Same subsystems and wiring as the power-mode harness in main.cpp.
+    bus_.setBattery(&battery_);
+    solar_.setPowerBus(&bus_);
+    battery_.setPowerBus(&bus_);
+    heater_.setPowerBus(&bus_);
+    heater_.setEffusionCell(&effCell_);
+    heater_.setSubstrateHeater(&substrateHeater_);
+    growth_.setPowerBus(&bus_);
+
+    growth_.setIsLeader(true);
+    growth_.setOutputSubdir(subdir);
+    substrateHeater_.setIsLeader(true);
+    growth_.setNumJobs(jobs_.size());
+
+    effCell_.setThermalIntegrator(thermal);
+    substrateHeater_.setThermalIntegrator(thermal);
+
+    engine_.addSubsystem(&solar_);
+    engine_.addSubsystem(&heater_);
+    engine_.addSubsystem(&substrateHeater_);
+    engine_.addSubsystem(&effCell_);
+    engine_.addSubsystem(&growth_);
+    engine_.addSubsystem(&bus_);
+    engine_.addSubsystem(&battery_);
+
+    engine_.setTickStep(dt_);
+}
+
+void SweepHarness::initialize() {
+    engine_.initialize();
+
+    r_.battery_min_Wh  = battery_.getCharge();
+    r_.effusion_max_K  = effCell_.getTemperatureK();
+    r_.substrate_max_K = substrateHeater_.substrateTempK();
+}
+
+void SweepHarness::step(int i) {
+    if (jobs_.empty()) {
+        // --mode power demands.
+        heater_.setEffusionDemand(1500.0);
+        heater_.setSubstrateDemand(0.0);
+        heater_.setPrioritySubstrate(false);
+        growth_.setBeamState(-1, false, 0.0);
+    } else {
+        // Row ticks are minutes; the first row covering t wins.
+        const double t_min = i * dt_ / 60.0;
+        int active = -1;
+        for (std::size_t k = 0; k < jobs_.size(); ++k) {
+            if (jobs_[k].start_tick <= t_min && t_min < jobs_[k].end_tick) {
+                active = static_cast<int>(k);
+                break;
+            }
+        }
+        if (active != current_ && current_ >= 0) growth_.finishJob(current_);
+        current_ = active;
+
+        heater_.setPrioritySubstrate(false);
+        if (active >= 0) {
+            const SimHelpers::Job& j = jobs_[active];
+            const bool beam = j.mbe_on != 0 && j.Fwafer_cm2s > 0.0 &&
+                              SimHelpers::phaseAllowsBeam(j.phase_code);
+            substrateHeater_.setJobState(active, true, j.Fwafer_cm2s,
+                                         j.substrate_on != 0, j.substrate_target_K);
+            heater_.setEffusionDemand(j.heater_W);
+            heater_.setSubstrateDemand(substrateHeater_.computePowerRequestW());
+            growth_.setBeamState(active, beam, j.Fwafer_cm2s);
+        } else {
+            substrateHeater_.setJobState(-1, false, 0.0, false,
+                                         SimHelpers::DEFAULT_IDLE_SUBSTRATE_TARGET_K);
+            heater_.setEffusionDemand(0.0);
+            heater_.setSubstrateDemand(0.0);
+            growth_.setBeamState(-1, false, 0.0);
+        }
+    }
+
+    engine_.tick();
+
+    const double dt_h = dt_ / 3600.0;
+    r_.solar_Wh          += solar_.getLastOutput() * dt_h;
+    r_.effusion_heat_Wh  += heater_.lastEffusionDeliveredW() * dt_h;
+    r_.substrate_heat_Wh += heater_.lastSubstrateDeliveredW() * dt_h;
+    r_.unmet_heat_Wh     += (heater_.lastEffusionRequestW() - heater_.lastEffusionDeliveredW() +
+                             heater_.lastSubstrateRequestW() - heater_.lastSubstrateDeliveredW()) * dt_h;
+    r_.battery_min_Wh  = std::min(r_.battery_min_Wh, battery_.getCharge());
+    r_.effusion_max_K  = std::max(r_.effusion_max_K, effCell_.getTemperatureK());
+    r_.substrate_max_K = std::max(r_.substrate_max_K, substrateHeater_.substrateTempK());
+}
+
+void SweepHarness::finish() {
+    if (current_ >= 0) growth_.finishJob(current_);
+
+    engine_.shutdown();
+
+    r_.battery_final_Wh  = battery_.getCharge();
+    r_.effusion_final_K  = effCell_.getTemperatureK();
+    r_.substrate_final_K = substrateHeater_.substrateTempK();
+}
+
+void SweepHarness::saveState(CheckpointWriter& ckpt) const {
+    engine_.saveState(ckpt);
+    ckpt.setInt("harness.current_job", current_);
+    ckpt.setDoubles("harness.totals", {
+        r_.solar_Wh, r_.effusion_heat_Wh, r_.substrate_heat_Wh, r_.unmet_heat_Wh,
+        r_.battery_min_Wh, r_.effusion_max_K, r_.substrate_max_K});
+}
+
+void SweepHarness::loadState(const CheckpointReader& ckpt) {
+    engine_.loadState(ckpt);
+    current_ = static_cast<int>(ckpt.getInt("harness.current_job"));
+    if (current_ >= static_cast<int>(jobs_.size())) {
+        throw std::runtime_error("SweepHarness: checkpoint's active job " +
+                                 std::to_string(current_) + " is not in this schedule");
+    }
+    const std::vector<double> t = ckpt.getDoubles("harness.totals");
+    if (t.size() != 7) {
+        throw std::runtime_error("SweepHarness: malformed checkpoint entry 'harness.totals'");
+    }
+    r_.solar_Wh          = t[0];
+    r_.effusion_heat_Wh  = t[1];
+    r_.substrate_heat_Wh = t[2];
+    r_.unmet_heat_Wh     = t[3];
+    r_.battery_min_Wh    = t[4];
+    r_.effusion_max_K    = t[5];
+    r_.substrate_max_K   = t[6];
+}
+
+// ---------------- ParameterSweep ----------------
+
+SweepMemberResult ParameterSweep::runMember(int index, const SweepMemberParams& p,
+                                            const SweepOptions& opt) {
+    const auto wall_start = std::chrono::steady_clock::now();
+    const std::string subdir = "member_" + std::to_string(index);
+
+    SweepMemberResult r;
+
+    std::vector<SimHelpers::Job> jobs;
+    int skipped = 0;
+    if (!p.job_file.empty()) {
+        jobs = load_jobs(job_path(p.job_file, opt.jobs_dir), skipped);
+    }
+    const int njobs = static_cast<int>(jobs.size());
+    const int ticks = std::max(1, static_cast<int>(std::lround(opt.span_s / p.dt)));
+
+    {
+        // Every stream opened by this member's subsystems lands in subdir/.
+        Logger::ScopedPrefix scope(subdir + "/");
+
+        SweepHarness h(p, opt.thermal, subdir, std::move(jobs));
+        h.initialize();
+        for (int i = 0; i < ticks; ++i) h.step(i);
+        h.finish();
+        r = h.totals();
+    }
+
+    // The member's streams are finished; don't hold their files open.
+    Logger::instance().closeStreams(subdir + "/");
+
+    r.member       = index;
+    r.ticks        = ticks;
+    r.jobs         = njobs;
+    r.skipped_rows = skipped;
+    r.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    return r;
+}
+
+std::vector<SweepMemberResult> ParameterSweep::run(MPI_Comm comm,
+                                                   const std::vector<SweepMemberParams>& members,
+                                                   const SweepOptions& opt) {
+    return distribute(comm, static_cast<int>(members.size()), opt.threads,
+                      [&](int k) { return runMember(k, members[k], opt); });
+}
+
+std::vector<SweepMemberResult> ParameterSweep::distribute(
+    MPI_Comm comm, int total, int threadsRequested,
+    const std::function<SweepMemberResult(int)>& body) {
+    int rank = 0, size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    const int threads = std::max(1, threadsRequested);
+
+    // Rank 0 owns the counter; other ranks ask for indices one at a time.
+    std::atomic<int> next{0};
+    std::mutex mpi_mtx;
+    auto claim = [&]() -> int {
+        if (rank == 0) {
+            const int k = next.fetch_add(1);
+            return k < total ? k : -1;
+        }
+        std::lock_guard<std::mutex> lock(mpi_mtx);
+        int req = 0, k = -1;
+        MPI_Send(&req, 1, MPI_INT, 0, kTagRequest, comm);
+        MPI_Recv(&k, 1, MPI_INT, 0, kTagReply, comm, MPI_STATUS_IGNORE);
+        return k;
+    };
+
+    std::vector<SweepMemberResult> local;
+    std::mutex local_mtx;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        try {
+            for (int k = claim(); k >= 0 && !failed.load(); k = claim()) {
+                SweepMemberResult res = body(k);
+                res.rank = rank;
+                std::lock_guard<std::mutex> lock(local_mtx);
+                local.push_back(res);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(local_mtx);
+            if (!error) error = std::current_exception();
+            failed.store(true);
+        }
+    };
+
+    // Rank 0's main thread serves the counter while its workers run; on
+    // the other ranks (and single-rank runs) the main thread is a worker.
+    const bool serve = (rank == 0 && size > 1);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < (serve ? threads : threads - 1); ++t) pool.emplace_back(worker);
+
+    if (serve) {
+        int ranks_done = 0;
+        while (ranks_done < size - 1) {
+            int flag = 0;
+            MPI_Status st;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &flag, &st);
+            if (!flag) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            int msg = 0;
+            MPI_Recv(&msg, 1, MPI_INT, st.MPI_SOURCE, st.MPI_TAG, comm, MPI_STATUS_IGNORE);
+            if (st.MPI_TAG == kTagDone) {
+                ++ranks_done;
+            } else {
+                int k = failed.load() ? -1 : next.fetch_add(1);
+                if (k >= total) k = -1;
+                MPI_Send(&k, 1, MPI_INT, st.MPI_SOURCE, kTagReply, comm);
+            }
+        }
+    } else {
+        worker();
+    }
+    for (auto& th : pool) th.join();
+
+    // A failed member aborts the whole run (main turns this into MPI_Abort).
+    if (error) std::rethrow_exception(error);
+    if (rank != 0) {
+        int done = 0;
+        MPI_Send(&done, 1, MPI_INT, 0, kTagDone, comm);
+    }
+
+    // Gather everything to rank 0, ordered by member.
+    std::vector<double> buf;
+    buf.reserve(local.size() * kResultFields);
+    for (const auto& res : local) pack(res, buf);
+
+    const int count = static_cast<int>(buf.size());
+    std::vector<int> counts(rank == 0 ? size : 0), displs(rank == 0 ? size : 0);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+
+    std::vector<double> all;
+    if (rank == 0) {
+        int off = 0;
+        for (int r = 0; r < size; ++r) { displs[r] = off; off += counts[r]; }
+        all.resize(off);
+    }
+    MPI_Gatherv(buf.data(), count, MPI_DOUBLE,
+                all.data(), counts.data(), displs.data(), MPI_DOUBLE, 0, comm);
+
+    std::vector<SweepMemberResult> results;
+    if (rank == 0) {
+        for (std::size_t off = 0; off + kResultFields <= all.size(); off += kResultFields) {
+            results.push_back(unpack(all.data() + off));
+        }
+        std::sort(results.begin(), results.end(),
+                  [](const SweepMemberResult& a, const SweepMemberResult& b) {
+                      return a.member < b.member;
+                  });
+    }
+    return results;
+}
+
+void ParameterSweep::writeTable(const std::vector<SweepMemberParams>& members,
+                                const std::vector<SweepMemberResult>& results,
+                                double span_s) {
+    static const std::vector<std::string> kColumns = {
+        "member", "span_s", "job_file", "solar_efficiency", "solar_base_input_W", "battery_capacity_Wh",
+        "heater_max_draw_W", "dt", "ticks", "jobs", "skipped_rows",
+        "battery_final_Wh", "battery_min_Wh", "solar_Wh",
+        "effusion_heat_Wh", "substrate_heat_Wh", "unmet_heat_Wh",
+        "effusion_max_K", "effusion_final_K", "substrate_max_K", "substrate_final_K",
+        "rank", "wall_s"
+    };
+
+    // Each row is keyed like a member's own streams at its final tick.
+    for (const auto& r : results) {
+        const SweepMemberParams& p = members.at(static_cast<std::size_t>(r.member));
+        const int last_tick = std::max(0, r.ticks - 1);
+        Logger::instance().log_wide(
+            "Sweep", last_tick, last_tick * p.dt, kColumns,
+            std::vector<std::string>{
+                std::to_string(r.member), fmt(span_s),
+                p.job_file.empty() ? "none" : p.job_file,
+                fmt(p.solar_efficiency), fmt(p.solar_base_input_W),
+                fmt(p.battery_capacity_Wh), fmt(p.heater_max_draw_W), fmt(p.dt),
+                std::to_string(r.ticks), std::to_string(r.jobs),
+                std::to_string(r.skipped_rows),
+                fmt(r.battery_final_Wh), fmt(r.battery_min_Wh), fmt(r.solar_Wh),
+                fmt(r.effusion_heat_Wh), fmt(r.substrate_heat_Wh), fmt(r.unmet_heat_Wh),
+                fmt(r.effusion_max_K), fmt(r.effusion_final_K),
+                fmt(r.substrate_max_K), fmt(r.substrate_final_K),
+                std::to_string(r.rank), fmt(r.wall_s)
+            });
+    }
+}
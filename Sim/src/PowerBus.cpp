@@ -1,9 +1,21 @@
 // Sim/src/PowerBus.cpp
 #include "PowerBus.hpp"
 #include "Logger.hpp"
+#include "Checkpoint.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <algorithm>
 
-PowerBus::PowerBus() : Subsystem("PowerBus") {}
+PowerBus::PowerBus()
+    : Subsystem("PowerBus"),
+      log_(Logger::instance().registerSchema(
+          "PowerBus",
+          {"status","solar_added","requested","granted","batt_drawn"})),
+      req_W_(kMaxRequests, 0.0),
+      req_priority_(kMaxRequests, 0),
+      grant_W_(kMaxRequests, 0.0),
+      order_(kMaxRequests, 0) {}
 
 void PowerBus::setBattery(Battery* batt) {
     battery_ = batt;
@@ -15,18 +27,15 @@ void PowerBus::initialize() {
     requested_this_tick_          = 0.0;
     granted_this_tick_            = 0.0;
     battery_discharged_this_tick_ = 0.0; // Initialize our new tracker
+    num_requests_.store(0, std::memory_order_relaxed);
+    allocated_ = false;
 
     // FIX: Match the new column names and initial values
-    Logger::instance().log_wide(
-        "PowerBus",
-        0,
-        0.0,
-        {"status","solar_added","requested","granted","batt_drawn"},
-        {1.0, 0.0, 0.0, 0.0, 0.0}
-    );
+    log_.write(0, 0.0, {1.0, 0.0, 0.0, 0.0, 0.0});
 }
 
 void PowerBus::addPower(double watts) {
+    std::lock_guard<std::mutex> lock(mtx_);
     if (watts > 0.0) {
         available_power_ += watts;
         added_this_tick_ += watts;
@@ -36,6 +45,13 @@ void PowerBus::addPower(double watts) {
 double PowerBus::drawPower(double requested, const TickContext& ctx) {
     if (requested <= 0.0) return 0.0;
 
+    std::lock_guard<std::mutex> lock(mtx_);
+    return serve_(requested, ctx.dt);
+}
+
+// One request against the bus, then the battery. Caller holds mtx_ and
+// passes requested > 0.
+double PowerBus::serve_(double requested, double dt) {
     // Bookkeep what was asked for this tick
     requested_this_tick_ += requested;
 
@@ -61,7 +77,7 @@ double PowerBus::drawPower(double requested, const TickContext& ctx) {
 
         // Only attempt to discharge if we still have allowable rate limits
         if (clamped_batt_request > 0.0) {
-            from_batt = battery_->discharge(clamped_batt_request, ctx.dt);
+            from_batt = battery_->discharge(clamped_batt_request, dt);
             battery_discharged_this_tick_ += from_batt;
         }
     }
@@ -72,6 +88,45 @@ double PowerBus::drawPower(double requested, const TickContext& ctx) {
     return total_granted;
 }
 
+int PowerBus::postRequest(PowerPriority priority, double watts) {
+    const int ticket = num_requests_.fetch_add(1, std::memory_order_relaxed);
+    if (ticket >= kMaxRequests) {
+        throw std::runtime_error("PowerBus: more than " + std::to_string(kMaxRequests) +
+                                 " power requests in one tick");
+    }
+    if (allocated_) {
+        throw std::runtime_error("PowerBus: power request posted after allocate()");
+    }
+    req_W_[ticket]        = std::max(0.0, watts);
+    req_priority_[ticket] = static_cast<std::uint8_t>(priority);
+    grant_W_[ticket]      = 0.0;
+    return ticket;
+}
+
+void PowerBus::allocate(const TickContext& ctx) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const int n = std::min(num_requests_.load(std::memory_order_acquire), kMaxRequests);
+
+    // Stable counting sort by priority: tickets keep posting order within
+    // a priority.
+    constexpr int kLevels = static_cast<int>(PowerPriority::Instrument) + 1;
+    int start[kLevels + 1] = {0};
+    for (int i = 0; i < n; ++i) ++start[std::min<int>(req_priority_[i], kLevels - 1) + 1];
+    for (int p = 0; p < kLevels; ++p) start[p + 1] += start[p];
+    for (int i = 0; i < n; ++i) order_[start[std::min<int>(req_priority_[i], kLevels - 1)]++] = i;
+
+    for (int k = 0; k < n; ++k) {
+        const int i = order_[k];
+        grant_W_[i] = req_W_[i] > 0.0 ? serve_(req_W_[i], ctx.dt) : 0.0;
+    }
+    allocated_ = true;
+}
+
+double PowerBus::grant(int ticket) const {
+    if (ticket < 0 || ticket >= kMaxRequests || !allocated_) return 0.0;
+    return grant_W_[ticket];
+}
+
 void PowerBus::tick(const TickContext& ctx) {
     // After all loads have drawn, any leftover power goes to battery
     if (battery_ && available_power_ > 0.0) {
@@ -79,24 +134,55 @@ void PowerBus::tick(const TickContext& ctx) {
     }
 
     // Log this tick
-Logger::instance().log_wide(
-        "PowerBus",
-        ctx.tick_index,
-        ctx.time,
-        {"status","solar_added","requested","granted","batt_drawn"},
-        {1.0, added_this_tick_, requested_this_tick_, granted_this_tick_, battery_discharged_this_tick_}
-    );
+    log_.write(ctx.tick_index, ctx.time,
+               {1.0, added_this_tick_, requested_this_tick_, granted_this_tick_,
+                battery_discharged_this_tick_});
 
     // Reset per-tick counters — bus does NOT store power across ticks
+    resetTickCounters_();
+}
+
+void PowerBus::settleWithoutLog(double dt) {
+    if (battery_ && available_power_ > 0.0) {
+        battery_->chargeFromSurplus(available_power_, dt);
+    }
+    resetTickCounters_();
+}
+
+void PowerBus::resetTickCounters_() {
     available_power_              = 0.0;
     added_this_tick_              = 0.0;
     requested_this_tick_          = 0.0;
     granted_this_tick_            = 0.0;
     battery_discharged_this_tick_ = 0.0; // Reset our tracker for the next tick
+    num_requests_.store(0, std::memory_order_relaxed);
+    allocated_ = false;
 }
 
 void PowerBus::shutdown() {}
 
+// Counters are reset at settlement, so between ticks only the carried
+// bus power matters; the rest is stored for completeness.
+void PowerBus::saveState(CheckpointWriter& ckpt) const {
+    ckpt.setDoubles(name_ + ".state",
+                    {available_power_, added_this_tick_, requested_this_tick_,
+                     granted_this_tick_, battery_discharged_this_tick_});
+}
+
+void PowerBus::loadState(const CheckpointReader& ckpt) {
+    const std::vector<double> v = ckpt.getDoubles(name_ + ".state");
+    if (v.size() != 5) {
+        throw std::runtime_error("PowerBus: checkpoint state has " +
+                                 std::to_string(v.size()) + " values, expected 5");
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    available_power_              = v[0];
+    added_this_tick_              = v[1];
+    requested_this_tick_          = v[2];
+    granted_this_tick_            = v[3];
+    battery_discharged_this_tick_ = v[4];
+}
+
 double PowerBus::getAvailablePower() const {
     return available_power_;
 }
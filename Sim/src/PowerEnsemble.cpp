@@ -0,0 +1,439 @@
+// Sim/src/PowerEnsemble.cpp
+#include "PowerEnsemble.hpp"
+#include "SimulationEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// EffusionCell model constants (see EffusionCell.hpp).
+constexpr double kEffC_J_per_K      = 800.0;
+constexpr double kEffH_W_per_K      = 0.8;
+constexpr double kEffNightK         = 285.0;
+constexpr double kEffDayK           = 325.0;
+constexpr double kEffAbsorptivity   = 0.35;
+constexpr double kEffAreaM2         = 0.010;
+constexpr double kSolarConstantWm2  = 1361.0;
+constexpr double kEffIdleK          = 300.0;
+
+// SubstrateHeater model constants (see SubstrateHeater.hpp).
+constexpr double kSubSigma          = 5.670374419e-8;
+constexpr double kSubEmissivity     = 0.80;
+constexpr double kSubH_W_per_K      = 0.50;
+constexpr double kSubC_J_per_K      = 1500.0;
+constexpr double kSubNightK         = 250.0;
+constexpr double kSubDayK           = 320.0;
+constexpr double kSubAbsorptivity   = 0.30;
+constexpr double kSubWaferRadiusM   = 0.15;
+constexpr double kSubIdleK          = 300.0;
+constexpr double kSubAreaM2         = kPi * kSubWaferRadiusM * kSubWaferRadiusM;
+
+// PowerBus::drawPower() for one member, written without early returns so
+// the surrounding member loop stays branch-free. req must be >= 0. Every
+// zero-request path leaves the state bit-identical to the scalar early exit.
+inline double draw_power(double req, double dt,
+                         double& available, double& requested, double& granted,
+                         double& batt_drawn, double& charge,
+                         double capacity, double max_discharge) {
+    requested += req;
+
+    const double from_bus = std::min(req, available);
+    available -= from_bus;
+
+    const double remaining = req - from_bus;
+    const double allowed   = std::max(0.0, max_discharge - batt_drawn);
+    const double batt_req  = std::max(0.0, std::min(remaining, allowed));
+
+    // Battery::discharge()
+    const double deliverable = std::min(batt_req, max_discharge);
+    const double max_possible = (charge * 3600.0) / dt;
+    const double w_out = std::min(deliverable, max_possible);
+    charge = std::clamp(charge - w_out * (dt / 3600.0), 0.0, capacity);
+
+    batt_drawn += w_out;
+
+    const double total = from_bus + w_out;
+    granted += total;
+    return total;
+}
+
+bool parse_double(const std::string& s, double& out) {
+    const char* b = s.c_str();
+    char* e = nullptr;
+    out = std::strtod(b, &e);
+    while (e && (*e == ' ' || *e == '\t' || *e == '\r')) ++e;
+    return e != b && e && *e == '\0' && std::isfinite(out);
+}
+
+std::string trim(const std::string& s) {
+    const auto b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    const auto e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+std::vector<std::string> split_csv(const std::string& line) {
+    std::vector<std::string> out;
+    std::stringstream ss(line);
+    std::string cell;
+    while (std::getline(ss, cell, ',')) out.push_back(trim(cell));
+    return out;
+}
+
+void validate(const EnsembleMemberParams& p, std::size_t idx) {
+    const double v[] = {
+        p.battery_capacity_Wh, p.battery_max_charge_W, p.battery_max_discharge_W,
+        p.solar_efficiency, p.solar_base_input_W, p.heater_max_draw_W,
+        p.effusion_demand_W, p.substrate_demand_W, p.base_load_W
+    };
+    for (double x : v) {
+        if (!std::isfinite(x) || x < 0.0) {
+            throw std::runtime_error("PowerEnsemble: member " + std::to_string(idx) +
+                                     " has a negative or non-finite parameter");
+        }
+    }
+}
+
+} // anonymous namespace
+
+std::vector<EnsembleMemberParams> PowerEnsemble::loadSpec(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("PowerEnsemble: failed to open spec " + path);
+    }
+
+    using Field = double EnsembleMemberParams::*;
+    struct Column { const char* name; Field field; };
+    static const Column kColumns[] = {
+        {"battery_capacity_Wh",     &EnsembleMemberParams::battery_capacity_Wh},
+        {"battery_max_charge_W",    &EnsembleMemberParams::battery_max_charge_W},
+        {"battery_max_discharge_W", &EnsembleMemberParams::battery_max_discharge_W},
+        {"solar_efficiency",        &EnsembleMemberParams::solar_efficiency},
+        {"solar_base_input_W",      &EnsembleMemberParams::solar_base_input_W},
+        {"heater_max_draw_W",       &EnsembleMemberParams::heater_max_draw_W},
+        {"effusion_demand_W",       &EnsembleMemberParams::effusion_demand_W},
+        {"substrate_demand_W",      &EnsembleMemberParams::substrate_demand_W},
+        {"base_load_W",             &EnsembleMemberParams::base_load_W},
+    };
+
+    std::vector<EnsembleMemberParams> members;
+    std::vector<int> map;   // header column -> kColumns index, -1 = priority_substrate
+    bool have_header = false;
+
+    std::string line;
+    int lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        const std::string t = trim(line);
+        if (t.empty() || t[0] == '#') continue;
+
+        const auto cells = split_csv(t);
+        if (!have_header) {
+            for (const auto& name : cells) {
+                int idx = -2;
+                for (std::size_t k = 0; k < std::size(kColumns); ++k) {
+                    if (name == kColumns[k].name) idx = static_cast<int>(k);
+                }
+                if (name == "priority_substrate") idx = -1;
+                if (idx == -2) {
+                    throw std::runtime_error("PowerEnsemble: unknown spec column '" + name +
+                                             "' in " + path);
+                }
+                map.push_back(idx);
+            }
+            have_header = true;
+            continue;
+        }
+
+        if (cells.size() != map.size()) {
+            throw std::runtime_error("PowerEnsemble: " + path + ":" + std::to_string(lineno) +
+                                     ": expected " + std::to_string(map.size()) + " values");
+        }
+
+        EnsembleMemberParams p;
+        for (std::size_t c = 0; c < cells.size(); ++c) {
+            double v = 0.0;
+            if (!parse_double(cells[c], v)) {
+                throw std::runtime_error("PowerEnsemble: " + path + ":" + std::to_string(lineno) +
+                                         ": bad value '" + cells[c] + "'");
+            }
+            if (map[c] < 0) {
+                p.priority_substrate = (v != 0.0);
+            } else {
+                p.*(kColumns[map[c]].field) = v;
+            }
+        }
+        validate(p, members.size());
+        members.push_back(p);
+    }
+    return members;
+}
+
+void PowerEnsemble::addMembers(const std::vector<EnsembleMemberParams>& members,
+                               std::size_t firstMember) {
+    if (n_ == 0) first_member_ = firstMember;
+
+    for (const auto& p : members) {
+        validate(p, first_member_ + n_);
+        capacity_.push_back(p.battery_capacity_Wh);
+        max_charge_.push_back(p.battery_max_charge_W);
+        max_discharge_.push_back(p.battery_max_discharge_W);
+        efficiency_.push_back(p.solar_efficiency);
+        base_input_.push_back(p.solar_base_input_W);
+        heater_max_.push_back(p.heater_max_draw_W);
+        eff_demand_.push_back(p.effusion_demand_W);
+        sub_demand_.push_back(p.substrate_demand_W);
+        base_load_.push_back(p.base_load_W);
+        priority_sub_.push_back(p.priority_substrate ? 1.0 : 0.0);
+        ++n_;
+    }
+}
+
+void PowerEnsemble::setTickStep(double dt) {
+    if (!(dt > 0.0) || !std::isfinite(dt)) {
+        throw std::runtime_error("PowerEnsemble: tick step must be positive");
+    }
+    tick_step_ = dt;
+}
+
+void PowerEnsemble::setLogEvery(int every) {
+    log_every_ = std::max(1, every);
+}
+
+void PowerEnsemble::setSolarScale(double s) {
+    if (!std::isfinite(s)) s = 0.0;
+    solar_scale_ = std::clamp(s, 0.0, 1.0);
+}
+
+void PowerEnsemble::setOrbitThermalEnvironment(double solar_scale) {
+    double s = std::isfinite(solar_scale) ? solar_scale : 0.0;
+    s = std::clamp(s, 0.0, 1.0);
+
+    eff_env_scale_   = s;
+    eff_ambient_K_   = kEffNightK + (kEffDayK - kEffNightK) * s;
+    eff_solar_abs_W_ = kEffAbsorptivity * kEffAreaM2 * kSolarConstantWm2 * s;
+
+    sub_env_scale_   = s;
+    sub_env_K_       = kSubNightK + (kSubDayK - kSubNightK) * s;
+    sub_solar_abs_W_ = kSubAbsorptivity * kSubAreaM2 * kSolarConstantWm2 * s;
+}
+
+void PowerEnsemble::initialize() {
+    auto zeros = [&](std::vector<double>& v) { v.assign(n_, 0.0); };
+
+    charge_.resize(n_);
+    for (std::size_t i = 0; i < n_; ++i) charge_[i] = capacity_[i] / 2.0;
+
+    zeros(available_); zeros(added_); zeros(requested_); zeros(granted_);
+    zeros(batt_drawn_); zeros(base_drawn_); zeros(solar_out_);
+    zeros(latch_remaining_); zeros(latch_requested_);
+    zeros(latch_granted_); zeros(latch_added_);
+    zeros(eff_req_); zeros(eff_deliv_); zeros(sub_req_); zeros(sub_deliv_);
+    zeros(eff_ploss_); zeros(eff_net_); zeros(eff_heat_in_);
+    zeros(sub_ploss_);
+    eff_T_.assign(n_, kEffIdleK);
+    sub_T_.assign(n_, kSubIdleK);
+
+    // Same environment the scalar subsystems start from: the effusion cell
+    // evaluates its model at solar_scale 0, the substrate resets to idle.
+    setOrbitThermalEnvironment(0.0);
+    sub_env_scale_   = 1.0;
+    sub_env_K_       = kSubIdleK;
+    sub_solar_abs_W_ = 0.0;
+
+    auto& L = Logger::instance();
+    battLog_ = L.registerSharedSchema("EnsembleBattery" + suffix_,
+        {"member","status","charge_Wh","capacity_Wh","max_charge_W","max_discharge_W"});
+    busLog_ = L.registerSharedSchema("EnsemblePowerBus" + suffix_,
+        {"member","status","solar_added","requested","granted","batt_drawn"});
+    solarLog_ = L.registerSharedSchema("EnsembleSolarArray" + suffix_,
+        {"member","status","solar_scale","solar_input","output","efficiency","base_input"});
+    heaterLog_ = L.registerSharedSchema("EnsembleHeaterBank" + suffix_,
+        {"member","eff_requested_W","eff_delivered_W","sub_requested_W","sub_delivered_W",
+         "priority_substrate"});
+    effLog_ = L.registerSharedSchema("EnsembleEffusionCell" + suffix_,
+        {"member","status","act_temp_K","target_temp_K","T_env_eff_K","solar_scale",
+         "P_solar_abs_W","heatInput_w","P_loss_W","P_net_W","C_J","h_WK"});
+    subLog_ = L.registerSharedSchema("EnsembleSubstrate" + suffix_,
+        {"member","T_sub_K","T_env_eff_K","solar_scale","P_solar_abs_W","P_deliv_W",
+         "P_loss_W","C_J","eps","h_WK"});
+
+    std::vector<std::string> engineCols = {"member"};
+    for (const auto& c : SimulationEngine::snapshotColumns()) engineCols.push_back(c);
+    engineLog_ = L.registerSharedSchema("EnsembleEngine" + suffix_, engineCols);
+
+    logRows_(0, 0.0, true);
+
+    tick_count_ = 1;
+    sim_time_   = tick_step_;
+}
+
+void PowerEnsemble::tick() {
+    const std::size_t n  = n_;
+    const double      dt = tick_step_;
+
+    double* avail  = available_.data();
+    double* added  = added_.data();
+    double* req    = requested_.data();
+    double* gra    = granted_.data();
+    double* bdrawn = batt_drawn_.data();
+    double* charge = charge_.data();
+    const double* cap   = capacity_.data();
+    const double* maxd  = max_discharge_.data();
+
+    // ---- Generation: SolarArray adds into the bus ----
+    const double scale = solar_scale_;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double out = base_input_[i] * scale * efficiency_[i];
+        solar_out_[i] = out;
+        const double add = out > 0.0 ? out : 0.0;
+        avail[i] += add;
+        added[i] += add;
+    }
+
+    // ---- Spacecraft base load ----
+    for (std::size_t i = 0; i < n; ++i) {
+        base_drawn_[i] = draw_power(base_load_[i], dt, avail[i], req[i], gra[i],
+                                    bdrawn[i], charge[i], cap[i], maxd[i]);
+    }
+
+    // ---- Loads: HeaterBank splits its cap, draws in priority order ----
+    for (std::size_t i = 0; i < n; ++i) {
+        double e = eff_demand_[i];
+        double s = sub_demand_[i];
+        const double total = e + s;
+        const double k = total > heater_max_[i] ? heater_max_[i] / total : 1.0;
+        e *= k;
+        s *= k;
+        eff_req_[i] = e;
+        sub_req_[i] = s;
+
+        const bool   sub_first = priority_sub_[i] != 0.0;
+        const double first  = sub_first ? s : e;
+        const double second = sub_first ? e : s;
+        const double g1 = draw_power(first, dt, avail[i], req[i], gra[i],
+                                     bdrawn[i], charge[i], cap[i], maxd[i]);
+        const double g2 = draw_power(second, dt, avail[i], req[i], gra[i],
+                                     bdrawn[i], charge[i], cap[i], maxd[i]);
+        eff_deliv_[i] = sub_first ? g2 : g1;
+        sub_deliv_[i] = sub_first ? g1 : g2;
+    }
+
+    // ---- Loads: heat application (EffusionCell / SubstrateHeater::applyHeat) ----
+    const double eff_amb = eff_ambient_K_;
+    const double eff_abs = eff_solar_abs_W_;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double pin   = std::max(0.0, eff_deliv_[i]);
+        const double ploss = kEffH_W_per_K * (eff_T_[i] - eff_amb);
+        const double net   = pin + eff_abs - ploss;
+        double T = eff_T_[i] + (net / kEffC_J_per_K) * dt;
+        T = T < 0.0 ? 0.0 : T;
+        eff_T_[i]       = T;
+        eff_ploss_[i]   = ploss;
+        eff_net_[i]     = net;
+        eff_heat_in_[i] = pin;
+    }
+
+    const double sub_env  = sub_env_K_;
+    const double sub_env4 = (sub_env * sub_env) * (sub_env * sub_env);
+    const double sub_abs  = sub_solar_abs_W_;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double pdel = std::max(0.0, sub_deliv_[i]);
+        const double T    = sub_T_[i];
+        const double T4   = (T * T) * (T * T);
+        const double ploss = kSubEmissivity * kSubSigma * kSubAreaM2 * (T4 - sub_env4)
+                           + kSubH_W_per_K * (T - sub_env);
+        const double net = pdel + sub_abs - ploss;
+        const double Tn  = T + (net / kSubC_J_per_K) * dt;
+        sub_T_[i]     = Tn < 0.0 ? 0.0 : Tn;
+        sub_deliv_[i] = pdel;
+        sub_ploss_[i] = ploss;
+    }
+
+    // ---- Latch bus counters before settlement ----
+    for (std::size_t i = 0; i < n; ++i) {
+        latch_remaining_[i] = avail[i];
+        latch_requested_[i] = req[i];
+        latch_granted_[i]   = gra[i];
+        latch_added_[i]     = added[i];
+    }
+
+    // ---- Settle: surplus -> battery (Battery::chargeFromSurplus) ----
+    const double max_c_dt = dt / 3600.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double in_W = std::min(avail[i], max_charge_[i]);
+        charge[i] = std::clamp(charge[i] + in_W * max_c_dt, 0.0, cap[i]);
+    }
+
+    // ---- Logs, then the bus resets its per-tick counters ----
+    if (tick_count_ % log_every_ == 0) {
+        logRows_(tick_count_, sim_time_, false);
+    }
+
+    std::fill(available_.begin(), available_.end(), 0.0);
+    std::fill(added_.begin(), added_.end(), 0.0);
+    std::fill(requested_.begin(), requested_.end(), 0.0);
+    std::fill(granted_.begin(), granted_.end(), 0.0);
+    std::fill(batt_drawn_.begin(), batt_drawn_.end(), 0.0);
+
+    tick_count_ += 1;
+    sim_time_   += tick_step_;
+}
+
+void PowerEnsemble::logRows_(int tick, double time, bool initial) {
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double m = static_cast<double>(first_member_ + i);
+
+        if (initial) {
+            solarLog_.write(tick, time, {m, 1.0, 0.0, 0.0, 0.0, efficiency_[i], base_input_[i]});
+            busLog_.write(tick, time, {m, 1.0, 0.0, 0.0, 0.0, 0.0});
+        } else {
+            solarLog_.write(tick, time, {m, 1.0, solar_scale_, base_input_[i] * solar_scale_,
+                                         solar_out_[i], efficiency_[i], base_input_[i]});
+            heaterLog_.write(tick, time, {m, eff_req_[i], eff_deliv_[i], sub_req_[i],
+                                          sub_deliv_[i], priority_sub_[i]});
+            effLog_.write(tick, time, {m, 1.0, eff_T_[i], kEffIdleK, eff_ambient_K_,
+                                       eff_env_scale_, eff_solar_abs_W_, eff_heat_in_[i],
+                                       eff_ploss_[i], eff_net_[i], kEffC_J_per_K,
+                                       kEffH_W_per_K});
+            subLog_.write(tick, time, {m, sub_T_[i], sub_env_K_, sub_env_scale_,
+                                       sub_solar_abs_W_, sub_deliv_[i], sub_ploss_[i],
+                                       kSubC_J_per_K, kSubEmissivity, kSubH_W_per_K});
+            busLog_.write(tick, time, {m, 1.0, added_[i], requested_[i], granted_[i],
+                                       batt_drawn_[i]});
+        }
+
+        battLog_.write(tick, time, {m, 1.0, charge_[i], capacity_[i], max_charge_[i],
+                                    max_discharge_[i]});
+
+        const double solar_out = initial ? 0.0 : solar_out_[i];
+        engineLog_.write(tick, time, {
+            m,
+            1.0,
+            latch_remaining_[i],
+            charge_[i],
+            solar_out,
+            0.0,
+
+            base_drawn_[i],
+            latch_requested_[i],
+            latch_granted_[i],
+            latch_added_[i],
+
+            capacity_[i],
+            max_charge_[i],
+            max_discharge_[i],
+
+            efficiency_[i],
+            base_input_[i]
+        });
+    }
+}
@@ -0,0 +1,298 @@
+// Sim/src/Profiler.cpp
+#include "Profiler.hpp"
+
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+std::atomic<bool> Profiler::enabled_{false};
+
+namespace {
+
+const char* const kCatNames[] = {"engine", "subsystem", "sparta", "params", "log", "mpi", "loop"};
+static_assert(sizeof(kCatNames) / sizeof(kCatNames[0]) == static_cast<std::size_t>(ProfileCat::Count),
+              "one name per ProfileCat");
+
+struct Event {
+    std::int64_t  t0_ns;
+    std::int64_t  dur_ns;
+    std::uint32_t name;
+    ProfileCat    cat;
+};
+
+struct Totals {
+    ProfileCat    cat     = ProfileCat::Engine;
+    std::uint64_t count   = 0;
+    std::int64_t  total_ns = 0;
+    std::int64_t  self_ns  = 0;
+    std::int64_t  max_ns   = 0;
+};
+
+// Owned by one thread while recording; read by write() afterwards. Buffers
+// outlive their threads so short-lived workers still show up.
+struct ThreadBuffer {
+    int                       tid = 0;
+    std::vector<Event>        events;
+    std::vector<Totals>       totals;     // indexed by name id
+    std::vector<std::int64_t> child_ns;   // nested time per open scope
+    std::uint64_t             dropped = 0;
+};
+
+struct State {
+    std::mutex mtx;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::int64_t epoch_ns = 0;
+    std::size_t  max_events = 1000000;
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+ThreadBuffer& thread_buffer() {
+    thread_local ThreadBuffer* buf = nullptr;
+    if (!buf) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mtx);
+        s.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buf = s.buffers.back().get();
+        buf->tid = static_cast<int>(s.buffers.size()) - 1;
+        buf->events.reserve(std::min<std::size_t>(s.max_events, 65536));
+    }
+    return *buf;
+}
+
+void json_string(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+            os << buf;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+std::string fmt(double v) {
+    std::ostringstream oss;
+    oss.precision(9);
+    oss << v;
+    return oss.str();
+}
+
+} // anonymous namespace
+
+Profiler& Profiler::instance() {
+    static Profiler p;
+    return p;
+}
+
+void Profiler::enable() {
+    State& s = state();
+    if (const char* env = std::getenv("SF_PROFILE_MAX_EVENTS")) {
+        const long v = std::atol(env);
+        if (v >= 0) s.max_events = static_cast<std::size_t>(v);
+    }
+    s.epoch_ns = nowNs();
+    thread_buffer();   // the enabling thread is tid 0 ("main")
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+std::uint32_t Profiler::intern(const std::string& name) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    auto it = s.ids.find(name);
+    if (it != s.ids.end()) return it->second;
+    const auto id = static_cast<std::uint32_t>(s.names.size());
+    s.names.push_back(name);
+    s.ids.emplace(name, id);
+    return id;
+}
+
+void Profiler::begin() {
+    thread_buffer().child_ns.push_back(0);
+}
+
+void Profiler::end(ProfileCat cat, std::uint32_t name, std::int64_t t0_ns) {
+    const std::int64_t dur = nowNs() - t0_ns;
+    ThreadBuffer& b = thread_buffer();
+
+    std::int64_t nested = 0;
+    if (!b.child_ns.empty()) {
+        nested = b.child_ns.back();
+        b.child_ns.pop_back();
+    }
+    if (!b.child_ns.empty()) b.child_ns.back() += dur;
+
+    if (name >= b.totals.size()) b.totals.resize(name + 1);
+    Totals& t = b.totals[name];
+    t.cat       = cat;
+    t.count    += 1;
+    t.total_ns += dur;
+    t.self_ns  += dur - nested;
+    t.max_ns    = std::max(t.max_ns, dur);
+
+    if (b.events.size() < state().max_events) {
+        b.events.push_back(Event{t0_ns, dur, name, cat});
+    } else {
+        ++b.dropped;
+    }
+}
+
+void Profiler::write(MPI_Comm comm) {
+    if (!enabled()) return;
+    enabled_.store(false, std::memory_order_relaxed);
+
+    int rank = 0, size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    State& s = state();
+    std::unique_lock<std::mutex> lock(s.mtx);
+    const double wall_s = (nowNs() - s.epoch_ns) * 1e-9;
+    const fs::path dir = Logger::directory();
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    // ---------------- trace ----------------
+    std::uint64_t nevents = 0, dropped = 0;
+    {
+        const fs::path path = dir / ("trace_r" + std::to_string(rank) + ".json");
+        std::ofstream os(path, std::ios::out | std::ios::trunc);
+        if (!os) throw std::runtime_error("Profiler: failed to open " + path.string());
+
+        os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+           << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+        char num[64];
+        for (const auto& b : s.buffers) {
+            os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank
+               << ",\"tid\":" << b->tid << ",\"args\":{\"name\":\""
+               << (b->tid == 0 ? "main" : "thread " + std::to_string(b->tid)) << "\"}}";
+            for (const Event& e : b->events) {
+                os << ",\n{\"name\":";
+                json_string(os, s.names[e.name]);
+                std::snprintf(num, sizeof(num), "%.3f", (e.t0_ns - s.epoch_ns) * 1e-3);
+                os << ",\"cat\":\"" << kCatNames[static_cast<int>(e.cat)]
+                   << "\",\"ph\":\"X\",\"ts\":" << num;
+                std::snprintf(num, sizeof(num), "%.3f", e.dur_ns * 1e-3);
+                os << ",\"dur\":" << num << ",\"pid\":" << rank << ",\"tid\":" << b->tid << "}";
+            }
+            nevents += b->events.size();
+            dropped += b->dropped;
+        }
+        os << "\n]}\n";
+    }
+
+    // ---------------- totals, gathered to rank 0 ----------------
+    std::map<std::uint32_t, Totals> merged;
+    std::map<std::uint32_t, int> threads;
+    for (const auto& b : s.buffers) {
+        for (std::uint32_t id = 0; id < b->totals.size(); ++id) {
+            const Totals& t = b->totals[id];
+            if (t.count == 0) continue;
+            Totals& m = merged[id];
+            m.cat       = t.cat;
+            m.count    += t.count;
+            m.total_ns += t.total_ns;
+            m.self_ns  += t.self_ns;
+            m.max_ns    = std::max(m.max_ns, t.max_ns);
+            threads[id] += 1;
+        }
+    }
+
+    // One line per name: cat \t name \t threads \t count \t total \t self \t max
+    std::string local;
+    {
+        std::ostringstream os;
+        os << "#\t" << fmt(wall_s) << "\t" << nevents << "\t" << dropped << "\n";
+        for (const auto& kv : merged) {
+            const Totals& t = kv.second;
+            os << static_cast<int>(t.cat) << "\t" << s.names[kv.first] << "\t" << threads[kv.first]
+               << "\t" << t.count << "\t" << t.total_ns << "\t" << t.self_ns << "\t" << t.max_ns << "\n";
+        }
+        local = os.str();
+    }
+    // Logger rows below intern their own scope names.
+    lock.unlock();
+
+    int len = static_cast<int>(local.size());
+    std::vector<int> lens(rank == 0 ? size : 0), displs(rank == 0 ? size : 0);
+    MPI_Gather(&len, 1, MPI_INT, lens.data(), 1, MPI_INT, 0, comm);
+    std::string all;
+    if (rank == 0) {
+        int total = 0;
+        for (int r = 0; r < size; ++r) { displs[r] = total; total += lens[r]; }
+        all.resize(static_cast<std::size_t>(total));
+    }
+    MPI_Gatherv(local.data(), len, MPI_CHAR, rank == 0 ? &all[0] : nullptr,
+                lens.data(), displs.data(), MPI_CHAR, 0, comm);
+    if (rank != 0) return;
+
+    static const std::vector<std::string> kColumns = {
+        "rank", "category", "name", "threads", "count", "total_s", "self_s",
+        "mean_us", "max_us", "self_share", "wall_s", "events", "dropped_events"
+    };
+    int row = 0;
+    for (int r = 0; r < size; ++r) {
+        std::istringstream in(all.substr(static_cast<std::size_t>(displs[r]),
+                                         static_cast<std::size_t>(lens[r])));
+        std::string line, rank_wall = "0", rank_events = "0", rank_dropped = "0";
+        double wall = 0.0;
+        std::vector<double> cat_self(static_cast<std::size_t>(ProfileCat::Count), 0.0);
+        std::vector<std::uint64_t> cat_count(cat_self.size(), 0);
+
+        while (std::getline(in, line)) {
+            std::vector<std::string> f;
+            std::istringstream ls(line);
+            for (std::string tok; std::getline(ls, tok, '\t');) f.push_back(tok);
+            if (f.size() == 4 && f[0] == "#") {
+                rank_wall = f[1]; rank_events = f[2]; rank_dropped = f[3];
+                wall = std::atof(f[1].c_str());
+                continue;
+            }
+            if (f.size() != 7) continue;
+            const int cat = std::atoi(f[0].c_str());
+            const double count = std::atof(f[3].c_str());
+            const double total = std::atof(f[4].c_str()) * 1e-9;
+            const double self  = std::atof(f[5].c_str()) * 1e-9;
+            const double max   = std::atof(f[6].c_str()) * 1e-9;
+            cat_self[static_cast<std::size_t>(cat)]  += self;
+            cat_count[static_cast<std::size_t>(cat)] += static_cast<std::uint64_t>(count);
+
+            Logger::instance().log_wide("Profile", row++, wall, kColumns, std::vector<std::string>{
+                std::to_string(r), kCatNames[cat], f[1], f[2], f[3], fmt(total), fmt(self),
+                fmt(count > 0 ? total / count * 1e6 : 0.0), fmt(max * 1e6),
+                fmt(wall > 0.0 ? self / wall : 0.0), rank_wall, rank_events, rank_dropped});
+        }
+        for (std::size_t c = 0; c < cat_self.size(); ++c) {
+            if (cat_count[c] == 0) continue;
+            Logger::instance().log_wide("Profile", row++, wall, kColumns, std::vector<std::string>{
+                std::to_string(r), kCatNames[c], "*", "", std::to_string(cat_count[c]), "",
+                fmt(cat_self[c]), "", "", fmt(wall > 0.0 ? cat_self[c] / wall : 0.0),
+                rank_wall, rank_events, rank_dropped});
+        }
+    }
+    Logger::instance().flush();
+}
@@ -0,0 +1,251 @@
+// Sim/src/ScheduleCompiler.cpp
+#include "ScheduleCompiler.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+using SimHelpers::Job;
+using SimHelpers::PhaseCode;
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'F', 'S', 'C', 'H', 'E', 'D', '\0'};
+
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr std::uint64_t kFnvPrime  = 1099511628211ull;
+
+std::uint64_t fnv1a(const std::string& s) {
+    std::uint64_t h = kFnvOffset;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+template <typename T>
+void write_pod(std::ostream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+bool read_pod(std::istream& in, T& v) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(T)));
+}
+
+bool read_text(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool source_stat(const std::string& path, std::uint64_t& size, std::int64_t& mtime) {
+    std::error_code ec;
+    size = static_cast<std::uint64_t>(fs::file_size(path, ec));
+    if (ec) return false;
+    const auto t = fs::last_write_time(path, ec);
+    if (ec) return false;
+    mtime = static_cast<std::int64_t>(t.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
+ScheduleCacheMode parseScheduleCacheMode(const std::string& text) {
+    if (text == "auto")    return ScheduleCacheMode::Auto;
+    if (text == "off")     return ScheduleCacheMode::Off;
+    if (text == "rebuild") return ScheduleCacheMode::Rebuild;
+    throw std::runtime_error("Unknown schedule cache mode '" + text +
+                             "' (expected auto|off|rebuild)");
+}
+
+std::string ScheduleCompiler::cachePath(const std::string& sourcePath) {
+    return sourcePath + ".sfsched";
+}
+
+CompiledSchedule ScheduleCompiler::compileText_(const std::string& sourcePath,
+                                                const SimHelpers::LogFn& warn) {
+    CompiledSchedule s;
+    std::string text;
+    if (!read_text(sourcePath, text)) return s;
+    s.found       = true;
+    s.source_hash = fnv1a(text);
+
+    std::istringstream in(text);
+    std::string line;
+    int lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        if (line.empty()) continue;
+        if (line[0] == '#') continue;
+        ++s.rows_read;
+
+        Job j{};
+        std::string parseErr;
+        if (!SimHelpers::parseJobLine(line, j, parseErr)) {
+            ++s.rows_skipped;
+            if (warn) {
+                std::ostringstream oss;
+                oss << "[warn] jobs.txt line " << lineno
+                    << " malformed, skipping: " << line
+                    << " | reason: " << parseErr << "\n";
+                warn(oss.str());
+            }
+            continue;
+        }
+        s.jobs.push_back(j);
+    }
+    return s;
+}
+
+bool ScheduleCompiler::readCache_(const std::string& path, std::uint64_t size,
+                                  std::int64_t mtime, const std::string& sourcePath,
+                                  CompiledSchedule& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[8];
+    std::uint32_t version = 0, rows_read = 0, rows_skipped = 0, njobs = 0;
+    std::uint64_t c_size = 0, c_hash = 0;
+    std::int64_t  c_mtime = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+        !read_pod(in, version) || version != kScheduleCacheVersion ||
+        !read_pod(in, c_size) || !read_pod(in, c_mtime) || !read_pod(in, c_hash) ||
+        !read_pod(in, rows_read) || !read_pod(in, rows_skipped) || !read_pod(in, njobs)) {
+        return false;
+    }
+
+    // Same size and mtime: trust the cache. Otherwise it may still describe
+    // the same text (touched or freshly checked out).
+    if (c_size != size || c_mtime != mtime) {
+        std::string text;
+        if (!read_text(sourcePath, text) || fnv1a(text) != c_hash) return false;
+    }
+
+    std::vector<Job> jobs;
+    jobs.reserve(njobs);
+    for (std::uint32_t i = 0; i < njobs; ++i) {
+        std::int32_t start = 0, end = 0, mbe = 0, sub = 0, phase = 0;
+        double flux = 0.0, heater = 0.0, target = 0.0;
+        if (!read_pod(in, start) || !read_pod(in, end) || !read_pod(in, flux) ||
+            !read_pod(in, heater) || !read_pod(in, mbe) || !read_pod(in, sub) ||
+            !read_pod(in, phase) || !read_pod(in, target)) {
+            return false;
+        }
+        if (phase < 0 || phase > static_cast<std::int32_t>(PhaseCode::COOLDOWN)) return false;
+
+        Job j{};
+        j.start_tick         = start;
+        j.end_tick           = end;
+        j.Fwafer_cm2s        = flux;
+        j.heater_W           = heater;
+        j.mbe_on             = mbe;
+        j.substrate_on       = sub;
+        j.phase_code         = static_cast<PhaseCode>(phase);
+        j.substrate_target_K = target;
+
+        std::string err;
+        if (!SimHelpers::validateJob(j, err)) return false;
+        jobs.push_back(j);
+    }
+
+    out.jobs         = std::move(jobs);
+    out.found        = true;
+    out.from_cache   = true;
+    out.rows_read    = static_cast<int>(rows_read);
+    out.rows_skipped = static_cast<int>(rows_skipped);
+    out.source_hash  = c_hash;
+    return true;
+}
+
+bool ScheduleCompiler::writeCache_(const std::string& path, std::uint64_t size,
+                                   std::int64_t mtime, const CompiledSchedule& s) {
+    // Unique temporary name, then rename: concurrent writers never leave a
+    // half-written cache behind.
+    std::ostringstream tmp;
+    tmp << path << ".tmp." << ::getpid() << "."
+        << std::hash<std::thread::id>{}(std::this_thread::get_id());
+    {
+        std::ofstream out(tmp.str(), std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        out.write(kMagic, sizeof(kMagic));
+        write_pod(out, kScheduleCacheVersion);
+        write_pod(out, size);
+        write_pod(out, mtime);
+        write_pod(out, s.source_hash);
+        write_pod(out, static_cast<std::uint32_t>(s.rows_read));
+        write_pod(out, static_cast<std::uint32_t>(s.rows_skipped));
+        write_pod(out, static_cast<std::uint32_t>(s.jobs.size()));
+        for (const Job& j : s.jobs) {
+            write_pod(out, static_cast<std::int32_t>(j.start_tick));
+            write_pod(out, static_cast<std::int32_t>(j.end_tick));
+            write_pod(out, j.Fwafer_cm2s);
+            write_pod(out, j.heater_W);
+            write_pod(out, static_cast<std::int32_t>(j.mbe_on));
+            write_pod(out, static_cast<std::int32_t>(j.substrate_on));
+            write_pod(out, static_cast<std::int32_t>(j.phase_code));
+            write_pod(out, j.substrate_target_K);
+        }
+        if (!out) {
+            out.close();
+            std::remove(tmp.str().c_str());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp.str(), path, ec);
+    if (ec) {
+        std::remove(tmp.str().c_str());
+        return false;
+    }
+    return true;
+}
+
+CompiledSchedule ScheduleCompiler::load(const std::string& sourcePath,
+                                        ScheduleCacheMode mode,
+                                        const SimHelpers::LogFn& warn) {
+    std::uint64_t size = 0;
+    std::int64_t  mtime = 0;
+    if (!source_stat(sourcePath, size, mtime)) return CompiledSchedule{};
+
+    const std::string cache = cachePath(sourcePath);
+    CompiledSchedule s;
+    if (mode == ScheduleCacheMode::Auto && readCache_(cache, size, mtime, sourcePath, s)) {
+        return s;
+    }
+
+    s = compileText_(sourcePath, warn);
+    if (s.found && mode != ScheduleCacheMode::Off) {
+        s.cache_written = writeCache_(cache, size, mtime, s);
+    }
+    return s;
+}
+
+void ScheduleCompiler::broadcast(std::vector<Job>& jobs, int root, MPI_Comm comm) {
+    static_assert(std::is_trivially_copyable<Job>::value,
+                  "Job is broadcast as raw bytes");
+
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    int n = (rank == root) ? static_cast<int>(jobs.size()) : 0;
+    MPI_Bcast(&n, 1, MPI_INT, root, comm);
+    if (rank != root) jobs.resize(static_cast<std::size_t>(n));
+    if (n > 0) {
+        MPI_Bcast(jobs.data(), n * static_cast<int>(sizeof(Job)), MPI_BYTE, root, comm);
+    }
+}
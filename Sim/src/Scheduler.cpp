@@ -0,0 +1,251 @@
+#include "Scheduler.hpp"
+#include "Checkpoint.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+using SimHelpers::Job;
+using SimHelpers::isGrowthPhase;
+using SimHelpers::derivePhaseDurationTicks;
+using SimHelpers::deriveLiveDepositionTicks;
+
+const char* jobRunStateName(JobRunState s) {
+  switch (s) {
+    case JobRunState::Pending:        return "pending";
+    case JobRunState::Queued:         return "queued";
+    case JobRunState::Warming:        return "warming";
+    case JobRunState::Cooling:        return "cooling";
+    case JobRunState::ThermalPrep:    return "thermal_prep";
+    case JobRunState::LiveDeposition: return "live_deposition";
+    case JobRunState::Done:           return "done";
+    case JobRunState::Aborted:        return "aborted";
+    default:                          return "unknown";
+  }
+}
+
+void Scheduler::load(const std::vector<Job>& jobs) {
+  jobs_.clear();
+  jobs_.reserve(jobs.size());
+  release_heap_.clear();
+  release_heap_.reserve(jobs.size());
+  ready_.clear();
+  ready_.reserve(jobs.size());
+  released_.clear();
+
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    const Job& j = jobs[i];
+
+    RuntimeJobState rj;
+
+    // Copy the immutable schedule request into runtime state.
+    rj.requested_start_tick           = j.start_tick;
+    rj.requested_end_tick             = j.end_tick;
+    rj.requested_phase_duration_ticks = derivePhaseDurationTicks(j);
+    rj.requested_live_duration_ticks  = deriveLiveDepositionTicks(j);
+
+    rj.requested_flux_cm2s          = j.Fwafer_cm2s;
+    rj.requested_heater_cap_W       = j.heater_W;
+    rj.requested_mbe_on             = j.mbe_on;
+    rj.requested_substrate_on       = j.substrate_on;
+    rj.requested_phase_code         = j.phase_code;
+    rj.requested_substrate_target_K = j.substrate_target_K;
+
+    // Phase time and live deposition time are tracked separately.
+    // Non-growth timed phases can persist even when live deposition owed is zero.
+    rj.remaining_phase_ticks = rj.requested_phase_duration_ticks;
+    rj.remaining_live_ticks  = rj.requested_live_duration_ticks;
+
+    jobs_.push_back(rj);
+    release_heap_.emplace_back(rj.requested_start_tick, static_cast<int>(i));
+  }
+  std::make_heap(release_heap_.begin(), release_heap_.end(), std::greater<ReleaseKey>());
+  unfinished_ = jobs_.size();
+
+  // next_growth_flux_[i] = first positive growth-like, beam-enabled flux in
+  // rows i+1 .. end; filled back to front.
+  next_growth_flux_.assign(jobs_.size(), 0.0);
+  double next = 0.0;
+  for (std::size_t k = jobs_.size(); k-- > 0;) {
+    next_growth_flux_[k] = next;
+
+    const RuntimeJobState& candidate = jobs_[k];
+    const bool growth_like  = isGrowthPhase(candidate.requested_phase_code);
+    const bool beam_enabled = (candidate.requested_mbe_on != 0);
+    const bool flux_valid   = std::isfinite(candidate.requested_flux_cm2s) &&
+                              candidate.requested_flux_cm2s > 0.0;
+    if (growth_like && beam_enabled && flux_valid) {
+      next = candidate.requested_flux_cm2s;
+    }
+  }
+}
+
+const std::vector<int>& Scheduler::releaseDue(int tick) {
+  released_.clear();
+  while (!release_heap_.empty() && release_heap_.front().first <= tick) {
+    std::pop_heap(release_heap_.begin(), release_heap_.end(), std::greater<ReleaseKey>());
+    const int idx = release_heap_.back().second;
+    release_heap_.pop_back();
+
+    RuntimeJobState& rj = jobs_[idx];
+    if (rj.state != JobRunState::Pending) continue;
+
+    rj.state = JobRunState::Queued;
+    rj.released_to_queue = true;
+    rj.actual_queue_enter_tick = tick;
+
+    released_.push_back(idx);
+    ready_.push_back(idx);
+    std::push_heap(ready_.begin(), ready_.end(), std::greater<int>());
+  }
+  // Several rows can come due on the same tick with different start ticks;
+  // report them in row order.
+  std::sort(released_.begin(), released_.end());
+  return released_;
+}
+
+int Scheduler::nextReleaseTick() const {
+  return release_heap_.empty() ? INT_MAX : release_heap_.front().first;
+}
+
+int Scheduler::promote() {
+  while (!ready_.empty()) {
+    std::pop_heap(ready_.begin(), ready_.end(), std::greater<int>());
+    const int idx = ready_.back();
+    ready_.pop_back();
+
+    const RuntimeJobState& rj = jobs_[idx];
+    if (rj.state == JobRunState::Queued && !rj.done && !rj.aborted) {
+      return idx;
+    }
+  }
+  return -1;
+}
+
+void Scheduler::complete(int index) {
+  RuntimeJobState& rj = jobs_[index];
+  if (rj.done || rj.aborted) return;
+  rj.done  = true;
+  rj.state = JobRunState::Done;
+  --unfinished_;
+}
+
+void Scheduler::abort(int index) {
+  RuntimeJobState& rj = jobs_[index];
+  if (rj.done || rj.aborted) return;
+  rj.aborted = true;
+  rj.state   = JobRunState::Aborted;
+  --unfinished_;
+}
+
+double Scheduler::nextGrowthFluxCm2s(int index) const {
+  if (index < 0 || static_cast<std::size_t>(index) >= next_growth_flux_.size()) {
+    return 0.0;
+  }
+  return next_growth_flux_[index];
+}
+
+namespace {
+constexpr std::size_t kRuntimeFields = 18;
+}
+
+void Scheduler::saveState(CheckpointWriter& ckpt) const {
+  std::vector<int> rows;
+  rows.reserve(jobs_.size() * kRuntimeFields);
+  for (const RuntimeJobState& rj : jobs_) {
+    rows.insert(rows.end(), {
+      static_cast<int>(rj.state),
+      rj.released_to_queue ? 1 : 0,
+      rj.done ? 1 : 0,
+      rj.aborted ? 1 : 0,
+      rj.has_started_live_execution ? 1 : 0,
+      rj.live_execution_hold_faulted ? 1 : 0,
+      rj.actual_queue_enter_tick,
+      rj.actual_thermal_prep_start_tick,
+      rj.actual_warmup_start_tick,
+      rj.actual_cooldown_start_tick,
+      rj.actual_phase_start_tick,
+      rj.actual_phase_end_tick,
+      rj.actual_deposition_start_tick,
+      rj.actual_deposition_end_tick,
+      rj.phase_ticks_completed,
+      rj.remaining_phase_ticks,
+      rj.live_ticks_completed,
+      rj.remaining_live_ticks
+    });
+  }
+
+  std::vector<int> release;
+  release.reserve(2 * release_heap_.size());
+  for (const ReleaseKey& k : release_heap_) {
+    release.push_back(k.first);
+    release.push_back(k.second);
+  }
+
+  ckpt.setInt("scheduler.njobs", static_cast<std::int64_t>(jobs_.size()));
+  ckpt.setInts("scheduler.rows", rows);
+  ckpt.setInts("scheduler.release_heap", release);
+  ckpt.setInts("scheduler.ready", ready_);
+  ckpt.setInt("scheduler.unfinished", static_cast<std::int64_t>(unfinished_));
+}
+
+void Scheduler::loadState(const CheckpointReader& ckpt) {
+  const std::size_t n = static_cast<std::size_t>(ckpt.getInt("scheduler.njobs"));
+  const std::vector<std::int64_t> rows    = ckpt.getInts("scheduler.rows");
+  const std::vector<std::int64_t> release = ckpt.getInts("scheduler.release_heap");
+  const std::vector<std::int64_t> ready   = ckpt.getInts("scheduler.ready");
+  if (n != jobs_.size() || rows.size() != n * kRuntimeFields || release.size() % 2 != 0) {
+    throw std::runtime_error("Scheduler: checkpoint has " + std::to_string(n) +
+                             " job(s), this schedule has " + std::to_string(jobs_.size()));
+  }
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::int64_t* r = rows.data() + i * kRuntimeFields;
+    if (r[0] < 0 || r[0] > static_cast<std::int64_t>(JobRunState::Aborted)) {
+      throw std::runtime_error("Scheduler: bad job state in checkpoint row " + std::to_string(i));
+    }
+    RuntimeJobState& rj = jobs_[i];
+    rj.state                          = static_cast<JobRunState>(r[0]);
+    rj.released_to_queue              = r[1] != 0;
+    rj.done                           = r[2] != 0;
+    rj.aborted                        = r[3] != 0;
+    rj.has_started_live_execution     = r[4] != 0;
+    rj.live_execution_hold_faulted    = r[5] != 0;
+    rj.actual_queue_enter_tick        = static_cast<int>(r[6]);
+    rj.actual_thermal_prep_start_tick = static_cast<int>(r[7]);
+    rj.actual_warmup_start_tick       = static_cast<int>(r[8]);
+    rj.actual_cooldown_start_tick     = static_cast<int>(r[9]);
+    rj.actual_phase_start_tick        = static_cast<int>(r[10]);
+    rj.actual_phase_end_tick          = static_cast<int>(r[11]);
+    rj.actual_deposition_start_tick   = static_cast<int>(r[12]);
+    rj.actual_deposition_end_tick     = static_cast<int>(r[13]);
+    rj.phase_ticks_completed          = static_cast<int>(r[14]);
+    rj.remaining_phase_ticks          = static_cast<int>(r[15]);
+    rj.live_ticks_completed           = static_cast<int>(r[16]);
+    rj.remaining_live_ticks           = static_cast<int>(r[17]);
+  }
+
+  // Heaps are restored in their stored layout, so later pops come out in
+  // exactly the order the interrupted run would have seen.
+  release_heap_.clear();
+  for (std::size_t k = 0; k < release.size(); k += 2) {
+    release_heap_.emplace_back(static_cast<int>(release[k]), static_cast<int>(release[k + 1]));
+  }
+  ready_.assign(ready.begin(), ready.end());
+  for (const ReleaseKey& k : release_heap_) {
+    if (k.second < 0 || static_cast<std::size_t>(k.second) >= n) {
+      throw std::runtime_error("Scheduler: bad release queue entry in checkpoint");
+    }
+  }
+  for (int idx : ready_) {
+    if (idx < 0 || static_cast<std::size_t>(idx) >= n) {
+      throw std::runtime_error("Scheduler: bad ready queue entry in checkpoint");
+    }
+  }
+  released_.clear();
+  unfinished_ = static_cast<std::size_t>(ckpt.getInt("scheduler.unfinished"));
+}
@@ -4,9 +4,16 @@
 #include "SolarArray.hpp"
 #include "HeaterBank.hpp"
 #include "Logger.hpp"
+#include "Checkpoint.hpp"
+#include "Profiler.hpp"
 
 void SimulationEngine::addSubsystem(Subsystem* subsystem) {
     subsystems_.push_back(subsystem);
+    tickEngine_.addSubsystem(subsystem);
+}
+
+void SimulationEngine::setTickThreads(int n) {
+    tickEngine_.setWorkers(n);
 }
 
 void SimulationEngine::setBaseLoadW(double w) {
@@ -24,6 +31,9 @@ void SimulationEngine::initialize() {
 
     for (auto* s : subsystems_) s->initialize();
 
+    // Resolve phases/dependencies and start the (optional) worker pool.
+    tickEngine_.start();
+
     job_failed_flag_ = false;
     base_drawn_W_ = 0.0;
 
@@ -32,6 +42,8 @@ void SimulationEngine::initialize() {
     latched_total_granted_W_   = 0.0;
     latched_total_generated_W_ = 0.0;
 
+    log_ = Logger::instance().registerSchema("SimulationEngine", snapshotColumns());
+
     logRow_(0, 0.0);
 
     tick_count_ = 1;
@@ -44,65 +56,85 @@ void SimulationEngine::tick() {
     // ------------------------------------------------------
     // Phase 0) Generation FIRST (solar adds into the bus)
     // ------------------------------------------------------
-    if (solar_) {
-        solar_->tick(ctx);
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase0.generation");
+        tickEngine_.runPhase(TickPhase::Generation, ctx);
     }
 
     // ------------------------------------------------------
     // Phase 1) Spacecraft baseline draw AFTER generation exists
+    //   Batched: base load first, then every consumer's request; the bus
+    //   allocates once and Loads read their grants.
     // ------------------------------------------------------
-    if (powerbus_ && base_load_W_ > 0.0) {
-        base_drawn_W_ = powerbus_->drawPower(base_load_W_, ctx);
-    } else {
-        base_drawn_W_ = 0.0;
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase1.base_load");
+        if (powerbus_ && power_alloc_ == PowerAllocation::Batched) {
+            const int baseTicket = powerbus_->postRequest(PowerPriority::Housekeeping,
+                                                          base_load_W_);
+            for (auto* s : subsystems_) s->postPowerRequests(ctx);
+            powerbus_->allocate(ctx);
+            base_drawn_W_ = powerbus_->grant(baseTicket);
+        } else if (powerbus_ && base_load_W_ > 0.0) {
+            base_drawn_W_ = powerbus_->drawPower(base_load_W_, ctx);
+        } else {
+            base_drawn_W_ = 0.0;
+        }
     }
 
     // ------------------------------------------------------
-    // Phase 2) Tick everything EXCEPT Solar, PowerBus, Battery
-    //   - Preserve the addSubsystem() order for the rest
-    //   - HeaterBank should run before Effusion/Substrate ticks
+    // Phase 2) Loads: everything that is not Generation/Settle/Storage
+    //   - HeaterBank runs first (applyHeat happens inside its tick);
+    //     Effusion/Substrate/GrowthMonitor declare tickAfter("HeaterBank")
+    //     and may then run concurrently when tick threads are enabled
+    //   - Serial execution preserves the addSubsystem() order
     // ------------------------------------------------------
-    for (auto* s : subsystems_) {
-        if (s == solar_)     continue;
-        if (s == powerbus_)  continue;
-        if (s == battery_)   continue;
-        s->tick(ctx);
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase2.loads");
+        tickEngine_.runPhase(TickPhase::Loads, ctx);
     }
 
     // ------------------------------------------------------
     // Phase 3) LATCH PowerBus counters BEFORE PowerBus::tick()
     //   because PowerBus::tick() logs then resets counters.
     // ------------------------------------------------------
-    if (powerbus_) {
-        latched_bus_remaining_W_   = powerbus_->getAvailablePower();
-        latched_total_requested_W_ = powerbus_->getRequestedThisTickW();
-        latched_total_granted_W_   = powerbus_->getGrantedThisTickW();
-        latched_total_generated_W_ = powerbus_->getAddedThisTickW();
-    } else {
-        latched_bus_remaining_W_   = 0.0;
-        latched_total_requested_W_ = 0.0;
-        latched_total_granted_W_   = 0.0;
-        latched_total_generated_W_ = 0.0;
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase3.latch");
+        if (powerbus_) {
+            latched_bus_remaining_W_   = powerbus_->getAvailablePower();
+            latched_total_requested_W_ = powerbus_->getRequestedThisTickW();
+            latched_total_granted_W_   = powerbus_->getGrantedThisTickW();
+            latched_total_generated_W_ = powerbus_->getAddedThisTickW();
+        } else {
+            latched_bus_remaining_W_   = 0.0;
+            latched_total_requested_W_ = 0.0;
+            latched_total_granted_W_   = 0.0;
+            latched_total_generated_W_ = 0.0;
+        }
     }
 
     // ------------------------------------------------------
     // Phase 4) Bus settlement (surplus -> battery) + PowerBus log/reset
     // ------------------------------------------------------
-    if (powerbus_) {
-        powerbus_->tick(ctx);
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase4.settle");
+        tickEngine_.runPhase(TickPhase::Settle, ctx);
     }
 
     // ------------------------------------------------------
     // Phase 5) Battery tick LAST so Battery.csv reflects post-settlement state
     // ------------------------------------------------------
-    if (battery_) {
-        battery_->tick(ctx);
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase5.storage");
+        tickEngine_.runPhase(TickPhase::Storage, ctx);
     }
 
     // ------------------------------------------------------
     // Phase 6) Log system snapshot (uses latched bus totals)
     // ------------------------------------------------------
-    logRow_(tick_count_, sim_time_);
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Engine, "engine.phase6.snapshot");
+        logRow_(tick_count_, sim_time_);
+    }
 
     job_failed_flag_ = false;
 
@@ -114,17 +146,81 @@ void SimulationEngine::setTickStep(double dt) {
     tick_step_ = dt;
 }
 
+void SimulationEngine::skipTicks(int n) {
+    if (n <= 0) return;
+    tick_count_ += n;
+    sim_time_   += n * tick_step_;
+}
+
+void SimulationEngine::saveState(CheckpointWriter& ckpt) const {
+    ckpt.setInt("engine.tick_count", tick_count_);
+    ckpt.setDouble("engine.sim_time_s", sim_time_);
+    ckpt.setDouble("engine.base_load_W", base_load_W_);
+    ckpt.setBool("engine.job_failed", job_failed_flag_);
+    for (const auto* s : subsystems_) s->saveState(ckpt);
+}
+
+void SimulationEngine::loadState(const CheckpointReader& ckpt) {
+    tick_count_      = static_cast<int>(ckpt.getInt("engine.tick_count"));
+    sim_time_        = ckpt.getDouble("engine.sim_time_s");
+    base_load_W_     = ckpt.getDouble("engine.base_load_W");
+    job_failed_flag_ = ckpt.getBool("engine.job_failed");
+    for (auto* s : subsystems_) s->loadState(ckpt);
+}
+
 void SimulationEngine::markJobFailedThisTick() {
     job_failed_flag_ = true;
 }
 
 void SimulationEngine::shutdown() {
+    tickEngine_.stop();
     for (auto* s : subsystems_) s->shutdown();
 }
 
+const std::vector<std::string>& SimulationEngine::snapshotColumns() {
+    static const std::vector<std::string> cols = {
+        "status",
+        "bus_remaining_W",
+        "battery_charge_Wh",
+        "solar_output_W",
+        "job_failed",
+
+        "spacecraft_base_load_W",
+        "total_power_requested_W",
+        "total_power_granted_W",
+        "total_power_generated_W",
+
+        "battery_capacity_Wh",
+        "battery_max_charge_W",
+        "battery_max_discharge_W",
+
+        "solar_efficiency",
+        "solar_base_input_W"
+    };
+    return cols;
+}
+
+SimulationEngine::Snapshot SimulationEngine::snapshot() const {
+    Snapshot snap;
+    snap.bus_remaining_W   = latched_bus_remaining_W_;
+    snap.total_requested_W = latched_total_requested_W_;
+    snap.total_granted_W   = latched_total_granted_W_;
+    snap.total_generated_W = latched_total_generated_W_;
+    snap.base_drawn_W      = base_drawn_W_;
+    snap.job_failed        = job_failed_flag_;
+    return snap;
+}
+
 void SimulationEngine::logRow_(int tick, double time) {
+    logSnapshot(log_, tick, time, snapshot(), battery_, solar_);
+}
 
-    double bus_remaining = latched_bus_remaining_W_;
+void SimulationEngine::logSnapshot(LogHandle& log, int tick, double time,
+                                   const Snapshot& snap,
+                                   const Battery* battery,
+                                   const SolarArray* solar) {
+
+    double bus_remaining = snap.bus_remaining_W;
     double batt_charge   = 0.0;
     double solar_output  = 0.0;
 
@@ -135,48 +231,28 @@ void SimulationEngine::logRow_(int tick, double time) {
     double sol_eff     = 0.0;
     double sol_base_W  = 0.0;
 
-    const double total_requested_W = latched_total_requested_W_;
-    const double total_granted_W   = latched_total_granted_W_;
-    const double total_generated_W = latched_total_generated_W_;
+    const double total_requested_W = snap.total_requested_W;
+    const double total_granted_W   = snap.total_granted_W;
+    const double total_generated_W = snap.total_generated_W;
 
-    if (battery_) {
-        batt_charge = battery_->getCharge();
-        batt_cap_Wh = battery_->getCapacityWh();
-        batt_cW     = battery_->getMaxChargeW();
-        batt_dW     = battery_->getMaxDischargeW();
+    if (battery) {
+        batt_charge = battery->getCharge();
+        batt_cap_Wh = battery->getCapacityWh();
+        batt_cW     = battery->getMaxChargeW();
+        batt_dW     = battery->getMaxDischargeW();
     }
 
-    if (solar_) {
-        solar_output = solar_->getLastOutput();
-        sol_eff      = solar_->getEfficiency();
-        sol_base_W   = solar_->getBaseInputW();
+    if (solar) {
+        solar_output = solar->getLastOutput();
+        sol_eff      = solar->getEfficiency();
+        sol_base_W   = solar->getBaseInputW();
     }
 
-    const double job_failed = job_failed_flag_ ? 1.0 : 0.0;
+    const double job_failed = snap.job_failed ? 1.0 : 0.0;
 
-    Logger::instance().log_wide(
-        "SimulationEngine",
+    log.write(
         tick,
         time,
-        {
-            "status",
-            "bus_remaining_W",
-            "battery_charge_Wh",
-            "solar_output_W",
-            "job_failed",
-
-            "spacecraft_base_load_W",
-            "total_power_requested_W",
-            "total_power_granted_W",
-            "total_power_generated_W",
-
-            "battery_capacity_Wh",
-            "battery_max_charge_W",
-            "battery_max_discharge_W",
-
-            "solar_efficiency",
-            "solar_base_input_W"
-        },
         {
             1.0,
             bus_remaining,
@@ -184,7 +260,7 @@ void SimulationEngine::logRow_(int tick, double time) {
             solar_output,
             job_failed,
 
-            base_drawn_W_,
+            snap.base_drawn_W,
             total_requested_W,
             total_granted_W,
             total_generated_W,
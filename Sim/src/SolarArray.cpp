@@ -1,5 +1,6 @@
 #include "SolarArray.hpp"
 #include "Logger.hpp"
+#include "Checkpoint.hpp"
 #include <cmath>
 
 // Global sunlight scale driven by OrbitModel in main.cpp.
@@ -31,17 +32,16 @@ SolarArray::SolarArray(double efficiency, double base_input)
       bus_(nullptr),
       efficiency_(efficiency),
       base_input_(base_input),
-      last_output_(0.0) {}
+      last_output_(0.0),
+      // Keep header stable and include regime columns for conditioning.
+      log_(Logger::instance().registerSchema(
+          "SolarArray",
+          {"status","solar_scale","solar_input","output","efficiency","base_input"})) {}
 
 void SolarArray::initialize() {
     last_output_ = 0.0;
 
-    // Keep header stable and include regime columns for conditioning.
-    Logger::instance().log_wide(
-        "SolarArray", 0, 0.0,
-        {"status","solar_scale","solar_input","output","efficiency","base_input"},
-        {1.0, 0.0, 0.0, 0.0, efficiency_, base_input_}
-    );
+    log_.write(0, 0.0, {1.0, 0.0, 0.0, 0.0, efficiency_, base_input_});
 }
 
 void SolarArray::tick(const TickContext& ctx) {
@@ -72,21 +72,36 @@ void SolarArray::tick(const TickContext& ctx) {
         bus_->addPower(output);
     }
 
-    Logger::instance().log_wide(
-        "SolarArray", ctx.tick_index, ctx.time,
-        {"status","solar_scale","solar_input","output","efficiency","base_input"},
-        {1.0, solar_scale, solar_input, output, efficiency_, base_input_}
-    );
+    log_.write(ctx.tick_index, ctx.time,
+               {1.0, solar_scale, solar_input, output, efficiency_, base_input_});
 }
 
 void SolarArray::shutdown() {
     // No -1 sentinel row (keeps file clean/consistent)
 }
 
+void SolarArray::saveState(CheckpointWriter& ckpt) const {
+    ckpt.setDouble(name_ + ".last_output_W", last_output_);
+}
+
+void SolarArray::loadState(const CheckpointReader& ckpt) {
+    last_output_ = ckpt.getDouble(name_ + ".last_output_W");
+}
+
 void SolarArray::setPowerBus(PowerBus* bus) {
     bus_ = bus;
 }
 
+double SolarArray::outputFor(double solar_scale) const {
+    if (!std::isfinite(solar_scale) || solar_scale < 0.0) {
+        solar_scale = 0.0;
+    }
+    if (solar_scale > 1.0) {
+        solar_scale = 1.0;
+    }
+    return base_input_ * solar_scale * efficiency_;
+}
+
 double SolarArray::getLastOutput() const {
     return last_output_;
 }
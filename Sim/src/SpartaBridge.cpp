@@ -1,20 +1,30 @@
 #include "SpartaBridge.hpp"
 #include "library.h"
 
+// SPARTA internals, for in-place per-surface access.
+#include "sparta.h"
+#include "comm.h"
+#include "domain.h"
+#include "fix.h"
+#include "modify.h"
+#include "surf.h"
+#include "universe.h"
+
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include <cstdlib>
+#include <cstdio>
 #include <sstream>
 #include <unistd.h>
 
 namespace fs = std::filesystem;
 
-static void set_gpu_env_defaults() {
+static void set_gpu_env_defaults(const std::string& visible_devices) {
   // Environment defaults (still fine even if we stay on CPU)
-  setenv("CUDA_VISIBLE_DEVICES", "0", 1);
+  setenv("CUDA_VISIBLE_DEVICES", visible_devices.c_str(), 1);
   setenv("OMP_NUM_THREADS",      "1", 1);
   unsetenv("DISPLAY");
   unsetenv("XAUTHORITY");
@@ -31,8 +41,11 @@ static std::vector<std::string> split_args(const std::string& s) {
   return out;
 }
 
-SpartaBridge::SpartaBridge(MPI_Comm comm) : comm_(comm) {
-  set_gpu_env_defaults();
+SpartaBridge::SpartaBridge(MPI_Comm comm, const SpartaDevicePolicy& devices)
+    : comm_(comm), device_(resolveSpartaDevice(devices, comm)) {
+  // Kokkos reads CUDA_VISIBLE_DEVICES when sparta_open() initializes it,
+  // so each rank sees only its own device.
+  set_gpu_env_defaults(device_.visible_devices);
 
   // Base argv: log to log.capi
   std::vector<std::string> args_str = {
@@ -40,12 +53,14 @@ SpartaBridge::SpartaBridge(MPI_Comm comm) : comm_(comm) {
     "-log", "log.capi"
   };
 
-  // If run.sh exported SPARTA_EXTRA_ARGS, append them
-  if (const char* extra = std::getenv("SPARTA_EXTRA_ARGS")) {
-    if (*extra) {
-      auto extras = split_args(std::string(extra));
-      args_str.insert(args_str.end(), extras.begin(), extras.end());
-    }
+  // If run.sh exported SPARTA_EXTRA_ARGS, append them (Kokkos options
+  // rewritten by the device policy)
+  const char* extra = std::getenv("SPARTA_EXTRA_ARGS");
+  const std::string extra_args =
+      applySpartaDeviceArgs(extra ? std::string(extra) : std::string(), device_);
+  if (!extra_args.empty()) {
+    auto extras = split_args(extra_args);
+    args_str.insert(args_str.end(), extras.begin(), extras.end());
   }
 
   // Build argv[]
@@ -104,14 +119,104 @@ void SpartaBridge::command(const char* cmd) {
 
 void SpartaBridge::runSteps(int n) {
   if (n <= 0) return;
-  std::string s = "run " + std::to_string(n);
-  command(s.c_str());
+  char cmd[32];
+  std::snprintf(cmd, sizeof(cmd), "run %d", n);
+  command(cmd);
 }
 
 void SpartaBridge::clear() {
   command("clear");
 }
 
+bool SpartaBridge::inProcess() const {
+  return spa_ != nullptr;
+}
+
+bool SpartaBridge::acceptsCommands() const {
+  return spa_ != nullptr;
+}
+
+std::string SpartaBridge::versionTag() const {
+  if (!spa_) return "SPARTA closed";
+  auto* sparta = static_cast<SPARTA_NS::SPARTA*>(spa_);
+  return std::string("SPARTA ") + sparta->universe->version + " np " +
+         std::to_string(sparta->comm->nprocs);
+}
+
+std::optional<double> SpartaBridge::extractCompute(const std::string& id, int index) {
+  if (!spa_ || index < 0) return std::nullopt;
+  // style 0 = global; type 0 = scalar, 1 = vector
+  void* p = sparta_extract_compute(spa_, const_cast<char*>(id.c_str()),
+                                   0, index > 0 ? 1 : 0);
+  if (!p) return std::nullopt;
+  const double* v = static_cast<const double*>(p);
+  return index > 0 ? v[index - 1] : v[0];
+}
+
+std::optional<double> SpartaBridge::extractVariable(const std::string& name) {
+  if (!spa_) return std::nullopt;
+  // Equal-style variables come back in a malloc'd double owned by the caller.
+  void* p = sparta_extract_variable(spa_, const_cast<char*>(name.c_str()), nullptr);
+  if (!p) return std::nullopt;
+  const double v = *static_cast<double*>(p);
+  std::free(p);
+  return v;
+}
+
+std::size_t SpartaBridge::surfGroupTriangles(const std::string& group,
+                                             std::vector<int>& local,
+                                             std::vector<double>& corners) {
+  if (!spa_) return 0;
+  auto* sparta = static_cast<SPARTA_NS::SPARTA*>(spa_);
+  SPARTA_NS::Surf* surf = sparta->surf;
+  if (!surf->exist || surf->implicit || sparta->domain->dimension != 3) return 0;
+
+  const int igroup = surf->find_group(group.c_str());
+  if (igroup < 0) return 0;
+  const int bit = surf->bitmask[igroup];
+
+  // Non-distributed surfs: every rank has all of them and owns every
+  // nprocs-th one, starting at its rank (Surf::nown).
+  const int me = sparta->comm->me;
+  const int nprocs = sparta->comm->nprocs;
+  std::size_t found = 0;
+  for (int m = 0; m < surf->nown; ++m) {
+    const SPARTA_NS::Surf::Tri& t =
+        surf->distributed ? surf->mytris[m] : surf->tris[me + m * nprocs];
+    if (!(t.mask & bit)) continue;
+    local.push_back(m);
+    corners.insert(corners.end(), t.p1, t.p1 + 3);
+    corners.insert(corners.end(), t.p2, t.p2 + 3);
+    corners.insert(corners.end(), t.p3, t.p3 + 3);
+    ++found;
+  }
+  return found;
+}
+
+std::optional<SpartaBridge::SurfValues> SpartaBridge::extractSurfFix(const std::string& id,
+                                                                     int column) {
+  if (!spa_ || column < 0) return std::nullopt;
+  auto* sparta = static_cast<SPARTA_NS::SPARTA*>(spa_);
+  const int ifix = sparta->modify->find_fix(id.c_str());
+  if (ifix < 0) return std::nullopt;
+  SPARTA_NS::Fix* fix = sparta->modify->fix[ifix];
+  if (!fix->per_surf_flag) return std::nullopt;
+
+  SurfValues out;
+  out.n = static_cast<std::size_t>(sparta->surf->nown);
+  if (fix->size_per_surf_cols == 0) {
+    if (column != 0) return std::nullopt;
+    out.data = fix->vector_surf;
+  } else {
+    if (column < 1 || column > fix->size_per_surf_cols) return std::nullopt;
+    // memory->create() arrays are contiguous rows.
+    out.data = fix->array_surf ? &fix->array_surf[0][column - 1] : nullptr;
+    out.stride = static_cast<std::size_t>(fix->size_per_surf_cols);
+  }
+  if (!out.data) out.n = 0;
+  return out;
+}
+
 SpartaBridge::~SpartaBridge() {
   if (spa_) {
     sparta_close(spa_);
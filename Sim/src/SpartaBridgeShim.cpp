@@ -1,14 +1,51 @@
 #include "SpartaBridge.hpp"
 
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <mpi.h>
 
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+// -----------------------------------------------------------------------------
+// External-process SPARTA bridge (ENABLE_SPARTA=OFF)
+//
+// Rank 0 starts one persistent `mpirun spa_` child on the first wake deck and
+// drives it through its stdin (SPARTA reads commands from stdin when no -in is
+// given). Every command() is followed by a sync marker
+//
+//     print "SFSYNC <n>"
+//
+// and the call returns once that line comes back on the child's stdout, so
+// "run N" blocks until the external instance has really advanced, like the
+// embedded bridge. Child output goes to run_spa.log; ERROR/WARNING lines are
+// echoed to stderr. If the child exits, the next command throws on every
+// rank.
+//
+// The device policy is applied to the child as a whole: CUDA_VISIBLE_DEVICES
+// lists the policy's device pool and "-k on g <count>" lets Kokkos spread the
+// child's ranks over it.
+//
+// Other ranks only mirror whether the child is up (acceptsCommands()), so
+// WakeChamber's collective logic stays matched across ranks. Values cannot be
+// extracted from the child; inProcess() is false and WakeChamber falls back
+// to the deck's CSV output for diagnostics.
+// -----------------------------------------------------------------------------
+
 namespace {
 
 std::string envOr(const char* key, const std::string& def) {
@@ -40,110 +77,292 @@ std::string basename(const std::string& p) {
   return p.substr(pos + 1);
 }
 
-} // namespace
+// State behind SpartaBridge::spa_ in shim builds (one per bridge, every rank).
+struct ShimProcess {
+  bool          live     = false;  // child running (mirrored on all ranks)
+  pid_t         pid      = -1;     // rank 0 only
+  int           to_fd    = -1;     // child's stdin
+  int           from_fd  = -1;     // child's stdout + stderr
+  long          sync_id  = 0;
+  std::string   pending;           // partial output line
+  std::string   out;               // send_sync() scratch, reused so a sync does not allocate
+  std::string   marker;
+  std::ofstream log;
+  std::string   log_path;
+  SpartaDeviceAssignment devices;  // pool for the child
+};
 
-SpartaBridge::SpartaBridge(MPI_Comm comm) : spa_(nullptr), comm_(comm) {}
-SpartaBridge::~SpartaBridge() = default;
+ShimProcess* shim(void* p) { return static_cast<ShimProcess*>(p); }
 
-void SpartaBridge::runDeck(const std::string& deck_basename,
-                           const std::string& input_subdir) {
-  int rank = 0;
-  MPI_Comm_rank(comm_, &rank);
-  if (rank != 0) return;
-
-  // Resolve absolute deck path
-  std::string deck_path = deck_basename;
-  const bool has_slash = deck_basename.find('/') != std::string::npos;
-  if (!isAbsolutePath(deck_path)) {
-    if (!has_slash && !input_subdir.empty()) {
-      deck_path = joinPath(input_subdir, deck_basename);
-    }
+// The harness's own MPI launch leaves OMPI_*/PMIX_* variables behind; a
+// nested mpirun that sees them tries to join this job and exits. Keep only
+// the user-facing OMPI_ALLOW_RUN_AS_ROOT* switches.
+void scrub_launcher_env() {
+  std::vector<std::string> names;
+  for (char** e = environ; e && *e; ++e) {
+    const std::string kv(*e);
+    const std::string name = kv.substr(0, kv.find('='));
+    const bool launcher = name.rfind("OMPI_", 0) == 0 || name.rfind("PMIX_", 0) == 0 ||
+                          name.rfind("PRTE_", 0) == 0;
+    if (launcher && name.rfind("OMPI_ALLOW_RUN_AS_ROOT", 0) != 0) names.push_back(name);
   }
+  for (const std::string& n : names) ::unsetenv(n.c_str());
+}
 
-  // Only launch wake deck
-  static bool warned_nonwake = false;
-  if (deck_path.find("in.wake") == std::string::npos) {
-    if (!warned_nonwake) {
-      std::cerr << "[SpartaBridgeShim] Skipping non-wake deck (" << deck_path << ")\n";
-      warned_nonwake = true;
+// Ignores SIGPIPE while writing to the child, so a dead child surfaces as
+// EPIPE instead of killing the harness; the caller's handler is restored.
+struct SigpipeIgnored {
+  struct sigaction old {};
+  SigpipeIgnored() {
+    struct sigaction ign {};
+    ign.sa_handler = SIG_IGN;
+    sigemptyset(&ign.sa_mask);
+    ::sigaction(SIGPIPE, &ign, &old);
+  }
+  ~SigpipeIgnored() { ::sigaction(SIGPIPE, &old, nullptr); }
+};
+
+void write_all(ShimProcess& s, const std::string& text) {
+  SigpipeIgnored guard;
+  const char* p = text.data();
+  std::size_t n = text.size();
+  while (n > 0) {
+    const ssize_t w = ::write(s.to_fd, p, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) {
+      throw std::runtime_error("SpartaBridgeShim: SPARTA process is gone (see " +
+                               s.log_path + ")");
     }
-    return;
+    p += w;
+    n -= static_cast<std::size_t>(w);
   }
+}
 
-  static std::set<std::string> launched;
-  if (launched.count(deck_path)) {
-    std::cerr << "[SpartaBridgeShim] Deck already launched, skipping: "
-              << deck_path << "\n";
-    return;
+// Reads child output until a line equal to marker; everything is logged.
+void wait_for_line(ShimProcess& s, std::string_view marker) {
+  char buf[4096];
+  for (;;) {
+    // Lines are scanned in place and consumed with one erase.
+    std::string::size_type start = 0, nl;
+    while ((nl = s.pending.find('\n', start)) != std::string::npos) {
+      std::string_view line(s.pending.data() + start, nl - start);
+      start = nl + 1;
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+      if (line == marker) {
+        s.pending.erase(0, start);
+        return;
+      }
+      s.log.write(line.data(), static_cast<std::streamsize>(line.size())) << '\n';
+      if (line.rfind("ERROR", 0) == 0 || line.rfind("WARNING", 0) == 0) {
+        std::cerr << "[SpartaBridgeShim] " << line << "\n";
+      }
+    }
+    s.pending.erase(0, start);
+
+    const ssize_t r = ::read(s.from_fd, buf, sizeof(buf));
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) {
+      s.log.flush();
+      s.live = false;
+      int status = 0;
+      std::string how;
+      if (s.pid > 0 && ::waitpid(s.pid, &status, 0) == s.pid) {
+        s.pid = -1;
+        if (WIFEXITED(status)) how = " with status " + std::to_string(WEXITSTATUS(status));
+        else if (WIFSIGNALED(status)) how = " on signal " + std::to_string(WTERMSIG(status));
+      }
+      throw std::runtime_error("SpartaBridgeShim: SPARTA process exited" + how +
+                               " (see " + s.log_path + ")");
+    }
+    s.pending.append(buf, static_cast<std::size_t>(r));
   }
-  launched.insert(deck_path);
+}
+
+// Sends one input line and blocks until SPARTA has executed it.
+void send_sync(ShimProcess& s, std::string_view cmd) {
+  char id[32];
+  std::snprintf(id, sizeof(id), "SFSYNC %ld", ++s.sync_id);
+  s.marker.assign(id);
+  s.out.assign(cmd.data(), cmd.size());
+  s.out.append("\nprint \"").append(s.marker).append("\"\n");
+  write_all(s, s.out);
+  wait_for_line(s, s.marker);
+  s.log.flush();
+}
 
+void spawn(ShimProcess& s, const std::string& deck_dir) {
   const std::string home = envOr("HOME", "");
   const std::string sparta_exe =
       envOr("SPARTA_EXE", home + "/opt/sparta/build-gpu/src/spa_");
-const std::string extra_args =
-    envOr("SPARTA_EXTRA_ARGS",
-          "-echo both -log log.sparta -k on g 1 -sf kk");
-  const std::string sparta_np  = envOr("SPARTA_NP", "1");
+  const std::string extra_args = applySpartaDeviceArgs(
+      envOr("SPARTA_EXTRA_ARGS", "-echo both -log log.sparta -k on g 1 -sf kk"),
+      s.devices);
+  const std::string sparta_np = envOr("SPARTA_NP", "1");
 
-  // Log & PID files live in the harness build dir (current working directory)
+  // Log file lives in the harness build dir (current working directory)
   const char* pwd_env = std::getenv("PWD");
   const std::string build_dir = (pwd_env && *pwd_env) ? std::string(pwd_env) : ".";
-  const std::string log_path  = joinPath(build_dir, "run_spa.log");
-  const std::string pid_path  = joinPath(build_dir, "run_spa.pid");
-
-  const std::string deck_dir  = dirname(deck_path);
-  const std::string deck_file = basename(deck_path);
-
-  // Construct a simple, robust launch command:
-  //
-  //   cd "<deck_dir>" &&
-  //   nohup env -u DISPLAY -u XAUTHORITY CUDA_VISIBLE_DEVICES=0 OMP_NUM_THREADS=1 \
-  //     mpirun -np <sparta_np> "<sparta_exe>" -in "<deck_file>" <extra_args> \
-  //     >> "<log_path>" 2>&1 & echo $! > "<pid_path>"
-  //
+  s.log_path = joinPath(build_dir, "run_spa.log");
+  s.log.open(s.log_path, std::ios::out | std::ios::trunc);
+
   std::ostringstream cmd;
+  cmd << "exec mpirun -np " << sparta_np << " " << std::quoted(sparta_exe);
+  if (!extra_args.empty()) cmd << " " << extra_args;
+  const std::string cmd_str = cmd.str();
 
-  cmd << "cd " << std::quoted(deck_dir)
-      << " && env -u DISPLAY -u XAUTHORITY "
-      << "CUDA_VISIBLE_DEVICES=0 OMP_NUM_THREADS=1 "
-      << "mpirun -np " << sparta_np << " "
-      << std::quoted(sparta_exe)
-      << " -in " << std::quoted(deck_file) << " ";
+  std::cerr << "[SpartaBridgeShim] Starting persistent SPARTA in " << deck_dir
+            << " (CUDA_VISIBLE_DEVICES=" << s.devices.visible_devices
+            << "):\n  " << cmd_str << "\n";
 
-  if (!extra_args.empty()) {
-    cmd << extra_args << " ";
+  int to_child[2], from_child[2];
+  if (::pipe(to_child) != 0 || ::pipe(from_child) != 0) {
+    throw std::runtime_error("SpartaBridgeShim: pipe() failed");
   }
 
-  // Send all output to both the terminal and the log file
-  cmd << "2>&1 | tee " << std::quoted(log_path);
+  const pid_t pid = ::fork();
+  if (pid < 0) throw std::runtime_error("SpartaBridgeShim: fork() failed");
 
-  const std::string cmd_str = cmd.str();
+  if (pid == 0) {
+    ::dup2(to_child[0], STDIN_FILENO);
+    ::dup2(from_child[1], STDOUT_FILENO);
+    ::dup2(from_child[1], STDERR_FILENO);
+    ::close(to_child[0]);   ::close(to_child[1]);
+    ::close(from_child[0]); ::close(from_child[1]);
+
+    if (::chdir(deck_dir.c_str()) != 0) _exit(127);
+    ::setenv("CUDA_VISIBLE_DEVICES", s.devices.visible_devices.c_str(), 1);
+    ::setenv("OMP_NUM_THREADS", "1", 1);
+    ::unsetenv("DISPLAY");
+    ::unsetenv("XAUTHORITY");
+    scrub_launcher_env();
+    ::execl("/bin/sh", "sh", "-c", cmd_str.c_str(), static_cast<char*>(nullptr));
+    _exit(127);
+  }
+
+  ::close(to_child[0]);
+  ::close(from_child[1]);
+  s.pid     = pid;
+  s.to_fd   = to_child[1];
+  s.from_fd = from_child[0];
+  s.live    = true;
+}
+
+} // namespace
 
-  std::cerr << "[SpartaBridgeShim] Launching external SPARTA:\n  "
-            << cmd_str << "\n";
+SpartaBridge::SpartaBridge(MPI_Comm comm, const SpartaDevicePolicy& devices)
+    : spa_(new ShimProcess), comm_(comm), device_(resolveSpartaDevicePool(devices)) {
+  shim(spa_)->devices = device_;
+}
+
+SpartaBridge::~SpartaBridge() {
+  ShimProcess* s = shim(spa_);
+  if (s->pid > 0) {
+    // EOF on stdin ends SPARTA's input loop; it then exits normally.
+    ::close(s->to_fd);
+    char buf[4096];
+    ssize_t r;
+    while ((r = ::read(s->from_fd, buf, sizeof(buf))) > 0) {
+      s->log.write(buf, r);
+    }
+    ::close(s->from_fd);
+    int status = 0;
+    ::waitpid(s->pid, &status, 0);
+  }
+  delete s;
+}
+
+void SpartaBridge::runDeck(const std::string& deck_basename,
+                           const std::string& input_subdir) {
+  // Only the wake decks are run externally; same decision on every rank.
+  static bool warned_nonwake = false;
+  if (deck_basename.find("in.wake") == std::string::npos) {
+    if (!warned_nonwake) {
+      std::cerr << "[SpartaBridgeShim] Skipping non-wake deck (" << deck_basename << ")\n";
+      warned_nonwake = true;
+    }
+    return;
+  }
+
+  ShimProcess& s = *shim(spa_);
+  int rank = 0;
+  MPI_Comm_rank(comm_, &rank);
 
-  const int rc = std::system(cmd_str.c_str());
+  int live = 0;
+  if (rank == 0) {
+    // Resolve absolute deck path
+    std::string deck_path = deck_basename;
+    const bool has_slash = deck_basename.find('/') != std::string::npos;
+    if (!isAbsolutePath(deck_path)) {
+      if (!has_slash && !input_subdir.empty()) {
+        deck_path = joinPath(input_subdir, deck_basename);
+      }
+    }
 
-  if (rc != 0) {
-    std::cerr << "[SpartaBridgeShim] ERROR: system() returned " << rc
-              << " while launching SPARTA. "
-              << "See " << log_path << " for details (if created).\n";
-  } else {
-    std::cerr << "[SpartaBridgeShim] SPARTA command completed (rc=0). "
-              << "See " << log_path << " for SPARTA output.\n";
+    try {
+      if (!s.live && s.pid < 0) spawn(s, dirname(deck_path));
+      // Reloads reuse the running process: WakeChamber sends "clear" first.
+      send_sync(s, "include " + basename(deck_path));
+    } catch (const std::exception& e) {
+      std::cerr << "[SpartaBridgeShim] ERROR: " << e.what() << "\n";
+    }
+    live = s.live ? 1 : 0;
   }
 
-  // if (rc != 0) {
-  //   std::cerr << "[SpartaBridgeShim] ERROR: system() returned " << rc
-  //             << " while launching SPARTA. "
-  //             << "See " << log_path << " for details (if created).\n";
-  // } else {
-  //   std::cerr << "[SpartaBridgeShim] SPARTA launch dispatched. "
-  //             << "PID -> " << pid_path << "; logs -> " << log_path << "\n";
-  // }
+  MPI_Bcast(&live, 1, MPI_INT, 0, comm_);
+  s.live = (live != 0);
 }
 
-void SpartaBridge::command(const char*) {}
-void SpartaBridge::runSteps(int) {}
-void SpartaBridge::clear() {}
+void SpartaBridge::command(const char* cmd) {
+  ShimProcess& s = *shim(spa_);
+  if (!s.live) return;  // mirrored, so every rank returns here together
+  int rank = 0;
+  MPI_Comm_rank(comm_, &rank);
+
+  // Only rank 0 talks to the child; its outcome is broadcast so a dead child
+  // fails every rank instead of leaving the others in the next collective.
+  int ok = 1;
+  std::string error;
+  if (rank == 0) {
+    try {
+      send_sync(s, cmd);
+    } catch (const std::exception& e) {
+      ok = 0;
+      error = e.what();
+    }
+  }
+  MPI_Bcast(&ok, 1, MPI_INT, 0, comm_);
+  if (!ok) {
+    s.live = false;
+    if (rank != 0) error = "SpartaBridgeShim: SPARTA process on rank 0 failed";
+    throw std::runtime_error(error);
+  }
+}
+
+void SpartaBridge::runSteps(int n) {
+  if (n <= 0) return;
+  char cmd[32];
+  std::snprintf(cmd, sizeof(cmd), "run %d", n);
+  command(cmd);
+}
+
+void SpartaBridge::clear() {
+  command("clear");
+}
+
+// The external process cannot be queried; WakeChamber falls back to the
+// deck's CSV output.
+bool SpartaBridge::inProcess() const { return false; }
+bool SpartaBridge::acceptsCommands() const { return shim(spa_)->live; }
+std::string SpartaBridge::versionTag() const {
+  const std::string home = envOr("HOME", "");
+  return "external " + envOr("SPARTA_EXE", home + "/opt/sparta/build-gpu/src/spa_") +
+         " np " + envOr("SPARTA_NP", "1");
+}
+std::optional<double> SpartaBridge::extractCompute(const std::string&, int) { return std::nullopt; }
+std::optional<double> SpartaBridge::extractVariable(const std::string&) { return std::nullopt; }
+std::size_t SpartaBridge::surfGroupTriangles(const std::string&, std::vector<int>&,
+                                             std::vector<double>&) { return 0; }
+std::optional<SpartaBridge::SurfValues> SpartaBridge::extractSurfFix(const std::string&, int) {
+  return std::nullopt;
+}
@@ -0,0 +1,197 @@
+#include "SpartaDevice.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::vector<int> parse_int_list(const std::string& s) {
+  std::vector<int> out;
+  std::stringstream ss(s);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) {
+    std::size_t used = 0;
+    int v = -1;
+    try {
+      v = std::stoi(tok, &used);
+    } catch (...) {
+      used = 0;
+    }
+    if (used != tok.size() || v < 0) {
+      throw std::runtime_error("SpartaDevicePolicy: bad device id '" + tok + "'");
+    }
+    out.push_back(v);
+  }
+  if (out.empty()) throw std::runtime_error("SpartaDevicePolicy: empty device list");
+  return out;
+}
+
+std::string join_ints(const std::vector<int>& v) {
+  std::ostringstream oss;
+  for (std::size_t i = 0; i < v.size(); ++i) oss << (i ? "," : "") << v[i];
+  return oss.str();
+}
+
+std::vector<int> pool_of(const SpartaDevicePolicy& p) {
+  if (!p.devices.empty()) return p.devices;
+  std::vector<int> pool;
+  for (int d = 0; d < (p.gpus_per_node > 0 ? p.gpus_per_node : 1); ++d) pool.push_back(d);
+  return pool;
+}
+
+const char* kGpuKokkosArgs = "-k on g 1 -sf kk";
+
+} // namespace
+
+SpartaDevicePolicy SpartaDevicePolicy::parse(const std::string& spec) {
+  SpartaDevicePolicy p;
+  const std::string::size_type colon = spec.find(':');
+  const std::string kind = spec.substr(0, colon);
+  const std::string arg  = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+  if (kind.empty() || kind == "default") {
+    p.mode = Mode::Default;
+  } else if (kind == "cpu") {
+    p.mode = Mode::Cpu;
+  } else if (kind == "rr") {
+    p.mode = Mode::RoundRobin;
+    if (arg.find(',') != std::string::npos) {
+      p.devices = parse_int_list(arg);
+    } else if (!arg.empty()) {
+      const std::vector<int> n = parse_int_list(arg);
+      if (n[0] < 1) throw std::runtime_error("SpartaDevicePolicy: rr:N needs N >= 1");
+      p.gpus_per_node = n[0];
+    }
+  } else if (kind == "map") {
+    p.mode = Mode::Map;
+    p.devices = parse_int_list(arg);
+  } else {
+    throw std::runtime_error("SpartaDevicePolicy: unknown policy '" + spec + "'");
+  }
+  return p;
+}
+
+std::string SpartaDevicePolicy::describe() const {
+  switch (mode) {
+  case Mode::Default:    return "default (GPU 0)";
+  case Mode::Cpu:        return "cpu";
+  case Mode::RoundRobin: return "round-robin over " + join_ints(pool_of(*this));
+  case Mode::Map:        return "map " + join_ints(devices);
+  }
+  return "?";
+}
+
+SpartaDeviceAssignment resolveSpartaDevice(const SpartaDevicePolicy& policy, MPI_Comm comm) {
+  SpartaDeviceAssignment a;
+
+  MPI_Comm node = MPI_COMM_NULL;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+  MPI_Comm_rank(node, &a.local_rank);
+  MPI_Comm_size(node, &a.local_size);
+  MPI_Comm_free(&node);
+
+  switch (policy.mode) {
+  case SpartaDevicePolicy::Mode::Default:
+    a.device = 0;
+    a.visible_devices = "0";
+    a.legacy = true;
+    return a;
+  case SpartaDevicePolicy::Mode::Cpu:
+    a.device = -1;
+    a.legacy = false;
+    return a;
+  case SpartaDevicePolicy::Mode::RoundRobin: {
+    const std::vector<int> pool = pool_of(policy);
+    a.device = pool[static_cast<std::size_t>(a.local_rank) % pool.size()];
+    break;
+  }
+  case SpartaDevicePolicy::Mode::Map:
+    a.device = policy.devices[static_cast<std::size_t>(a.local_rank) % policy.devices.size()];
+    break;
+  }
+
+  // One visible device per rank; Kokkos sees it as device 0.
+  a.visible_devices = std::to_string(a.device);
+  a.kokkos_args = kGpuKokkosArgs;
+  a.legacy = false;
+  return a;
+}
+
+SpartaDeviceAssignment resolveSpartaDevicePool(const SpartaDevicePolicy& policy) {
+  SpartaDeviceAssignment a;
+  switch (policy.mode) {
+  case SpartaDevicePolicy::Mode::Default:
+    a.visible_devices = "0";
+    return a;
+  case SpartaDevicePolicy::Mode::Cpu:
+    a.device = -1;
+    a.legacy = false;
+    return a;
+  case SpartaDevicePolicy::Mode::RoundRobin:
+  case SpartaDevicePolicy::Mode::Map: {
+    // Distinct devices in first-use order; Kokkos assigns them to the
+    // launcher's ranks round-robin by its own node-local rank.
+    std::vector<int> pool;
+    for (int d : policy.mode == SpartaDevicePolicy::Mode::Map ? policy.devices : pool_of(policy)) {
+      bool seen = false;
+      for (int x : pool) seen = seen || x == d;
+      if (!seen) pool.push_back(d);
+    }
+    a.device = pool.front();
+    a.visible_devices = join_ints(pool);
+    a.kokkos_args = "-k on g " + std::to_string(pool.size()) + " -sf kk";
+    a.legacy = false;
+    return a;
+  }
+  }
+  return a;
+}
+
+std::string applySpartaDeviceArgs(const std::string& extra_args,
+                                  const SpartaDeviceAssignment& a) {
+  if (a.legacy) return extra_args;
+
+  std::istringstream iss(extra_args);
+  std::vector<std::string> toks;
+  std::string t;
+  while (iss >> t) toks.push_back(t);
+
+  std::ostringstream out;
+  bool first = true;
+  for (std::size_t i = 0; i < toks.size(); ++i) {
+    if (toks[i] == "-k" || toks[i] == "-kokkos") {
+      // Drop the switch and its keyword/value list up to the next option.
+      while (i + 1 < toks.size() && toks[i + 1][0] != '-') ++i;
+      continue;
+    }
+    if ((toks[i] == "-sf" || toks[i] == "-suffix") && i + 1 < toks.size() && toks[i + 1] == "kk") {
+      ++i;
+      continue;
+    }
+    out << (first ? "" : " ") << toks[i];
+    first = false;
+  }
+  if (!a.kokkos_args.empty()) out << (first ? "" : " ") << a.kokkos_args;
+  return out.str();
+}
+
+std::string describeSpartaDeviceMap(const SpartaDeviceAssignment& a, MPI_Comm comm) {
+  int rank = 0, size = 1;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int mine[3] = {a.local_rank, a.local_size, a.device};
+  std::vector<int> all(rank == 0 ? 3 * size : 0);
+  MPI_Gather(mine, 3, MPI_INT, all.data(), 3, MPI_INT, 0, comm);
+  if (rank != 0) return {};
+
+  std::ostringstream oss;
+  for (int r = 0; r < size; ++r) {
+    const int dev = all[3 * r + 2];
+    oss << "rank " << r << " (node-local " << all[3 * r] << "/" << all[3 * r + 1] << ") -> ";
+    if (dev < 0) oss << "CPU";
+    else oss << "GPU " << dev;
+    oss << "\n";
+  }
+  return oss.str();
+}
@@ -1,45 +1,24 @@
 #include "SpartaDiag.hpp"
-#include <fstream>
-#include <sstream>
-#include <vector>
-#include <algorithm>
+#include "CsvTailReader.hpp"
 
-static inline std::string trim(std::string s) {
-    auto issp = [](unsigned char c){ return std::isspace(c); };
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [&](unsigned char c){return !issp(c);} ));
-    s.erase(std::find_if(s.rbegin(), s.rend(), [&](unsigned char c){return !issp(c);}).base(), s.end());
-    return s;
+std::optional<SpartaDiag> parse_sparta_diag_row(const std::string& row) {
+    // Expect: step,time,temp_K,density_m3 (parsed in place, polled every block)
+    SpartaDiag d{};
+    if (!CsvTailReader::fieldDouble(row, 0, d.step) ||
+        !CsvTailReader::fieldDouble(row, 1, d.time_s) ||
+        !CsvTailReader::fieldDouble(row, 2, d.temp_K) ||
+        !CsvTailReader::fieldDouble(row, 3, d.density_m3)) {
+        return std::nullopt;
+    }
+    return d;
 }
 
-static bool split_csv(const std::string& line, std::vector<std::string>& out) {
-    out.clear();
-    std::stringstream ss(line);
-    std::string tok;
-    while (std::getline(ss, tok, ',')) out.push_back(trim(tok));
-    return !out.empty();
+std::optional<SpartaDiag> read_sparta_diag_csv(CsvTailReader& tail) {
+    if (!tail.poll()) return std::nullopt;
+    return parse_sparta_diag_row(tail.lastRow());
 }
 
 std::optional<SpartaDiag> read_sparta_diag_csv(const std::filesystem::path& file) {
-    std::ifstream in(file);
-    if (!in) return std::nullopt;
-
-    std::string line;
-    if (!std::getline(in, line)) return std::nullopt; // header
-    std::string last;
-    while (std::getline(in, line)) if (!trim(line).empty()) last = line;
-    if (last.empty()) return std::nullopt;
-
-    std::vector<std::string> toks;
-    if (!split_csv(last, toks)) return std::nullopt;
-
-    // Expect: step,time,temp_K,density_m3
-    if (toks.size() < 4) return std::nullopt;
-    SpartaDiag d{};
-    try {
-        d.step       = std::stod(toks[0]);
-        d.time_s     = std::stod(toks[1]);
-        d.temp_K     = std::stod(toks[2]);
-        d.density_m3 = std::stod(toks[3]);
-    } catch (...) { return std::nullopt; }
-    return d;
+    CsvTailReader tail(file);
+    return read_sparta_diag_csv(tail);
 }
@@ -1,5 +1,12 @@
 #include "SubstrateHeater.hpp"
 
+#include "Checkpoint.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace {
 
 /*
@@ -66,6 +73,33 @@ void SubstrateHeater::initialize() {
   temp_miss_streak_      = 0;
   job_failed_            = false;
   failure_monitor_armed_ = false;
+
+  /*
+      The schema is registered here rather than in the constructor so that
+      it follows the integrator set by setThermalIntegrator(): the trailing
+      "substeps" column exists only under the stable integrator, and euler
+      runs keep the historical header.
+  */
+  std::vector<std::string> columns = {
+      "job_index",
+      "job_active",
+      "substrate_control_on",
+      "T_sub_K",
+      "T_target_K",
+      "T_env_eff_K",
+      "solar_scale",
+      "P_solar_abs_W",
+      "P_req_W",
+      "P_deliv_W",
+      "P_loss_W",
+      "streak",
+      "failed",
+      "C_J",
+      "eps",
+      "h_WK"
+  };
+  if (integrator_.kind() == ThermalIntegratorKind::Stable) columns.push_back("substeps");
+  log_ = Logger::instance().registerSchema("substrate", columns);
 }
 
 void SubstrateHeater::shutdown() {
@@ -76,6 +110,40 @@ void SubstrateHeater::shutdown() {
   */
 }
 
+void SubstrateHeater::saveState(CheckpointWriter& ckpt) const {
+  ckpt.setDoubles(name_ + ".thermal",
+                  {T_sub_K_, T_target_K_, T_env_K_, T_env_eff_K_, solar_scale_,
+                   P_solar_abs_W_, P_requested_W_, P_delivered_W_, last_P_loss_W_});
+  ckpt.setInts(name_ + ".job",
+               std::vector<int>{job_index_, job_active_ ? 1 : 0,
+                                substrate_control_on_ ? 1 : 0, temp_miss_streak_,
+                                job_failed_ ? 1 : 0, failure_monitor_armed_ ? 1 : 0});
+}
+
+void SubstrateHeater::loadState(const CheckpointReader& ckpt) {
+  const std::vector<double> v = ckpt.getDoubles(name_ + ".thermal");
+  const std::vector<std::int64_t> j = ckpt.getInts(name_ + ".job");
+  if (v.size() != 9 || j.size() != 6) {
+    throw std::runtime_error("SubstrateHeater: malformed checkpoint state");
+  }
+  T_sub_K_        = v[0];
+  T_target_K_     = v[1];
+  T_env_K_        = v[2];
+  T_env_eff_K_    = v[3];
+  solar_scale_    = v[4];
+  P_solar_abs_W_  = v[5];
+  P_requested_W_  = v[6];
+  P_delivered_W_  = v[7];
+  last_P_loss_W_  = v[8];
+
+  job_index_             = static_cast<int>(j[0]);
+  job_active_            = j[1] != 0;
+  substrate_control_on_  = j[2] != 0;
+  temp_miss_streak_      = static_cast<int>(j[3]);
+  job_failed_            = j[4] != 0;
+  failure_monitor_armed_ = j[5] != 0;
+}
+
 void SubstrateHeater::setOrbitThermalEnvironment(double solar_scale) {
   /*
       Clamp the external solar scale to a safe and interpretable range.
@@ -244,6 +312,41 @@ double SubstrateHeater::lossPowerW(double T_K) const {
   return P_rad + P_cond;
 }
 
+double SubstrateHeater::passiveEquilibriumK(double T_env_K, double P_solar_W) const {
+  /*
+      The exchange term is monotonic in T, so bisection on
+      emissivity sigma A (T^4 - T_env^4) + h (T - T_env) = P_solar
+      converges on the single root.
+  */
+  auto residual = [&](double T_K) {
+    return emissivity_ * sigma_ * wafer_area_m2_ *
+               (std::pow(T_K, 4) - std::pow(T_env_K, 4)) +
+           h_cond_WK_ * (T_K - T_env_K) - P_solar_W;
+  };
+
+  double lo = 0.0;
+  double hi = std::max(T_env_K, 1.0);
+  while (residual(hi) < 0.0 && hi < 1.0e5) {
+    hi *= 2.0;
+  }
+  for (int it = 0; it < 60; ++it) {
+    const double mid = 0.5 * (lo + hi);
+    if (residual(mid) < 0.0) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return 0.5 * (lo + hi);
+}
+
+void SubstrateHeater::idleBandK(double& lo_K, double& hi_K) const {
+  const double p_sun_W = alpha_abs_ * A_proj_m2_ * G_solar_W_m2_;
+  lo_K = passiveEquilibriumK(T_env_night_K_, 0.0);
+  hi_K = passiveEquilibriumK(T_env_day_K_, p_sun_W);
+  if (hi_K < lo_K) std::swap(lo_K, hi_K);
+}
+
 double SubstrateHeater::computePowerRequestW() {
   /*
       If there is no meaningful active substrate target, request no power.
@@ -319,7 +422,17 @@ void SubstrateHeater::applyHeat(double watts, double dt_s) {
   /*
       Advance the substrate temperature using the lumped thermal capacitance.
   */
-  T_sub_K_ += (net_W / C_J_per_K_) * dt;
+  if (integrator_.kind() == ThermalIntegratorKind::Euler) {
+    T_sub_K_ += (net_W / C_J_per_K_) * dt;
+  } else {
+    ThermalNode node;
+    node.C_J_per_K  = C_J_per_K_;
+    node.h_W_per_K  = h_cond_WK_;
+    node.k_rad_W_K4 = emissivity_ * sigma_ * wafer_area_m2_;
+    node.T_env_K    = T_env_eff_K_;
+    node.P_in_W     = P_delivered_W_ + P_solar_abs_W_;
+    T_sub_K_ = integrator_.advance(node, T_sub_K_, dt);
+  }
 
   /*
       Clamp invalid or unphysical states back to a safe baseline.
@@ -455,45 +568,26 @@ void SubstrateHeater::tick(const TickContext& ctx) {
          negative means passive warming from the environment
   */
   if (is_leader_) {
-    Logger::instance().log_wide(
-        name_,
-        ctx.tick_index,
-        ctx.time,
-        {
-            "job_index",
-            "job_active",
-            "substrate_control_on",
-            "T_sub_K",
-            "T_target_K",
-            "T_env_eff_K",
-            "solar_scale",
-            "P_solar_abs_W",
-            "P_req_W",
-            "P_deliv_W",
-            "P_loss_W",
-            "streak",
-            "failed",
-            "C_J",
-            "eps",
-            "h_WK"
-        },
-        {
-            static_cast<double>(job_index_),
-            job_active_ ? 1.0 : 0.0,
-            substrate_control_on_ ? 1.0 : 0.0,
-            T_sub_K_,
-            T_target_K_,
-            T_env_eff_K_,
-            solar_scale_,
-            P_solar_abs_W_,
-            P_requested_W_,
-            P_delivered_W_,
-            last_P_loss_W_,
-            static_cast<double>(temp_miss_streak_),
-            job_failed_ ? 1.0 : 0.0,
-            C_J_per_K_,
-            emissivity_,
-            h_cond_WK_
-        });
+    // Under euler the schema ends before "substeps" (see initialize()).
+    const double row[] = {
+      static_cast<double>(job_index_),
+      job_active_ ? 1.0 : 0.0,
+      substrate_control_on_ ? 1.0 : 0.0,
+      T_sub_K_,
+      T_target_K_,
+      T_env_eff_K_,
+      solar_scale_,
+      P_solar_abs_W_,
+      P_requested_W_,
+      P_delivered_W_,
+      last_P_loss_W_,
+      static_cast<double>(temp_miss_streak_),
+      job_failed_ ? 1.0 : 0.0,
+      C_J_per_K_,
+      emissivity_,
+      h_cond_WK_,
+      static_cast<double>(integrator_.lastSubsteps())
+    };
+    log_.write(ctx.tick_index, ctx.time, row, log_.width());
   }
 }
\ No newline at end of file
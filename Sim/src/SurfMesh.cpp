@@ -0,0 +1,736 @@
+// Sim/src/SurfMesh.cpp
+#include "SurfMesh.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+using Vec3 = SurfMesh::Vec3;
+using Tri  = SurfMesh::Tri;
+
+Vec3 sub(const Vec3& a, const Vec3& b) { return {a[0] - b[0], a[1] - b[1], a[2] - b[2]}; }
+double dot(const Vec3& a, const Vec3& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+double norm(const Vec3& a) { return std::sqrt(dot(a, a)); }
+Vec3 cross(const Vec3& a, const Vec3& b) {
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+// Undirected edge key, smaller index in the high word.
+std::uint64_t edge_key(int a, int b) {
+    const auto lo = static_cast<std::uint32_t>(std::min(a, b));
+    const auto hi = static_cast<std::uint32_t>(std::max(a, b));
+    return (static_cast<std::uint64_t>(lo) << 32) | hi;
+}
+
+// Triangles using each edge, with +1 when the triangle runs lo -> hi.
+struct EdgeUse {
+    int face;
+    int dir;
+};
+
+std::unordered_map<std::uint64_t, std::vector<EdgeUse>> edge_uses(const std::vector<Tri>& tris) {
+    std::unordered_map<std::uint64_t, std::vector<EdgeUse>> uses;
+    uses.reserve(tris.size() * 2);
+    for (std::size_t f = 0; f < tris.size(); ++f) {
+        for (int k = 0; k < 3; ++k) {
+            const int a = tris[f][k], b = tris[f][(k + 1) % 3];
+            uses[edge_key(a, b)].push_back({static_cast<int>(f), a < b ? 1 : -1});
+        }
+    }
+    return uses;
+}
+
+Vec3 tri_normal(const std::vector<Vec3>& p, const Tri& t) {
+    return cross(sub(p[t[1]], p[t[0]]), sub(p[t[2]], p[t[0]]));
+}
+
+// Symmetric 4x4 plane quadric: xx xy xz xd yy yz yd zz zd dd.
+struct Quadric {
+    double q[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    static Quadric plane(const Vec3& n, double d) {
+        Quadric k;
+        k.q[0] = n[0] * n[0]; k.q[1] = n[0] * n[1]; k.q[2] = n[0] * n[2]; k.q[3] = n[0] * d;
+        k.q[4] = n[1] * n[1]; k.q[5] = n[1] * n[2]; k.q[6] = n[1] * d;
+        k.q[7] = n[2] * n[2]; k.q[8] = n[2] * d;
+        k.q[9] = d * d;
+        return k;
+    }
+    Quadric& operator+=(const Quadric& o) {
+        for (int i = 0; i < 10; ++i) q[i] += o.q[i];
+        return *this;
+    }
+    double cost(const Vec3& p) const {
+        const double x = p[0], y = p[1], z = p[2];
+        return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x +
+               q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y +
+               q[7] * z * z + 2 * q[8] * z + q[9];
+    }
+    // Minimiser of cost(), if the 3x3 part is well conditioned.
+    bool optimum(Vec3& p) const {
+        const double a = q[0], b = q[1], c = q[2], d = q[4], e = q[5], f = q[7];
+        const double det = a * (d * f - e * e) - b * (b * f - c * e) + c * (b * e - c * d);
+        const double scale = std::max({std::fabs(a), std::fabs(d), std::fabs(f), 1e-300});
+        if (std::fabs(det) < 1e-10 * scale * scale * scale) return false;
+        const double rx = -q[3], ry = -q[6], rz = -q[8];
+        p[0] = (rx * (d * f - e * e) - b * (ry * f - e * rz) + c * (ry * e - d * rz)) / det;
+        p[1] = (a * (ry * f - e * rz) - rx * (b * f - c * e) + c * (b * rz - ry * c)) / det;
+        p[2] = (a * (d * rz - ry * e) - b * (b * rz - ry * c) + rx * (b * e - c * d)) / det;
+        return true;
+    }
+};
+
+std::vector<std::string> tokens(const std::string& line) {
+    std::vector<std::string> out;
+    std::istringstream ss(line);
+    for (std::string t; ss >> t;) out.push_back(t);
+    return out;
+}
+
+std::string lower(std::string s) {
+    for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+double to_double(const std::string& s, const std::string& where) {
+    char* end = nullptr;
+    const double v = std::strtod(s.c_str(), &end);
+    if (!end || *end != '\0') throw std::runtime_error("SurfMesh: bad number '" + s + "' " + where);
+    return v;
+}
+
+long to_long(const std::string& s, const std::string& where) {
+    char* end = nullptr;
+    const long v = std::strtol(s.c_str(), &end, 10);
+    if (!end || *end != '\0') throw std::runtime_error("SurfMesh: bad integer '" + s + "' " + where);
+    return v;
+}
+
+} // anonymous namespace
+
+bool SurfRegion::contains(const std::array<double, 3>& p) const {
+    if (sphere) {
+        const Vec3 d = sub(p, lo);
+        return dot(d, d) <= hi[0] * hi[0];
+    }
+    for (int k = 0; k < 3; ++k) {
+        if (p[k] < lo[k] || p[k] > hi[k]) return false;
+    }
+    return true;
+}
+
+// ---------------- file I/O ----------------
+
+SurfMesh SurfMesh::read(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("SurfMesh: cannot open " + path);
+
+    SurfMesh m;
+    long want_points = -1, want_tris = -1;
+    std::string section;
+    std::map<long, int> point_ids;   // file ID -> index
+    int lineno = 0;
+
+    for (std::string line; std::getline(in, line);) {
+        ++lineno;
+        const auto hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        const auto tok = tokens(line);
+        if (tok.empty()) continue;
+        const std::string where = "at " + path + ":" + std::to_string(lineno);
+
+        if (tok.size() == 1) {
+            const std::string kw = lower(tok[0]);
+            if (kw == "points" || kw == "triangles") {
+                section = kw;
+                continue;
+            }
+            if (kw == "lines") throw std::runtime_error("SurfMesh: 2-d line surfaces are not supported " + where);
+        }
+        if (section.empty()) {
+            // Header: "<N> points", "<N> triangles"
+            if (tok.size() == 2) {
+                const std::string kw = lower(tok[1]);
+                if (kw == "points") { want_points = to_long(tok[0], where); continue; }
+                if (kw == "triangles") { want_tris = to_long(tok[0], where); continue; }
+                if (kw == "lines") throw std::runtime_error("SurfMesh: 2-d line surfaces are not supported " + where);
+            }
+            throw std::runtime_error("SurfMesh: unexpected header line " + where);
+        }
+
+        if (section == "points") {
+            if (tok.size() != 4) throw std::runtime_error("SurfMesh: expected 'ID x y z' " + where);
+            point_ids[to_long(tok[0], where)] = static_cast<int>(m.points_.size());
+            m.points_.push_back({to_double(tok[1], where), to_double(tok[2], where),
+                                 to_double(tok[3], where)});
+            continue;
+        }
+
+        // Triangles
+        const bool indexed = want_points >= 0 || !point_ids.empty();
+        if (indexed) {
+            if (tok.size() != 4 && tok.size() != 5) {
+                throw std::runtime_error("SurfMesh: expected 'ID [type] p1 p2 p3' " + where);
+            }
+            const std::size_t first = tok.size() - 3;
+            Tri t{};
+            for (int k = 0; k < 3; ++k) {
+                auto it = point_ids.find(to_long(tok[first + k], where));
+                if (it == point_ids.end()) throw std::runtime_error("SurfMesh: unknown point " + tok[first + k] + " " + where);
+                t[k] = it->second;
+            }
+            m.tris_.push_back(t);
+            m.types_.push_back(tok.size() == 5 ? static_cast<int>(to_long(tok[1], where)) : 1);
+        } else {
+            if (tok.size() != 10 && tok.size() != 11) {
+                throw std::runtime_error("SurfMesh: expected 'ID [type] x1 y1 z1 x2 y2 z2 x3 y3 z3' " + where);
+            }
+            const std::size_t first = tok.size() - 9;
+            Tri t{};
+            for (int k = 0; k < 3; ++k) {
+                t[k] = static_cast<int>(m.points_.size());
+                m.points_.push_back({to_double(tok[first + 3 * k], where),
+                                     to_double(tok[first + 3 * k + 1], where),
+                                     to_double(tok[first + 3 * k + 2], where)});
+            }
+            m.tris_.push_back(t);
+            m.types_.push_back(tok.size() == 11 ? static_cast<int>(to_long(tok[1], where)) : 1);
+            m.source_format_ = SurfFileFormat::Inline;
+        }
+    }
+
+    if (want_tris >= 0 && static_cast<std::size_t>(want_tris) != m.tris_.size()) {
+        throw std::runtime_error("SurfMesh: " + path + " declares " + std::to_string(want_tris) +
+                                 " triangles but lists " + std::to_string(m.tris_.size()));
+    }
+    if (want_points >= 0 && static_cast<std::size_t>(want_points) != point_ids.size()) {
+        throw std::runtime_error("SurfMesh: " + path + " declares " + std::to_string(want_points) +
+                                 " points but lists " + std::to_string(point_ids.size()));
+    }
+    if (m.tris_.empty()) throw std::runtime_error("SurfMesh: no triangles in " + path);
+    return m;
+}
+
+void SurfMesh::write(const std::string& path, SurfFileFormat format, const std::string& title) const {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) throw std::runtime_error("SurfMesh: cannot write " + path);
+
+    const bool typed = std::any_of(types_.begin(), types_.end(), [](int t) { return t != 1; });
+    char buf[64];
+    auto num = [&](double v) {
+        std::snprintf(buf, sizeof(buf), " %.12e", v);
+        return std::string(buf);
+    };
+
+    out << "# " << title << "\n\n";
+    if (format == SurfFileFormat::Points) {
+        out << points_.size() << " points\n" << tris_.size() << " triangles\n\nPoints\n\n";
+        for (std::size_t i = 0; i < points_.size(); ++i) {
+            out << (i + 1) << num(points_[i][0]) << num(points_[i][1]) << num(points_[i][2]) << "\n";
+        }
+        out << "\nTriangles\n\n";
+        for (std::size_t f = 0; f < tris_.size(); ++f) {
+            out << (f + 1);
+            if (typed) out << ' ' << types_[f];
+            out << ' ' << (tris_[f][0] + 1) << ' ' << (tris_[f][1] + 1) << ' ' << (tris_[f][2] + 1) << "\n";
+        }
+    } else {
+        out << tris_.size() << " triangles\n\nTriangles\n\n";
+        for (std::size_t f = 0; f < tris_.size(); ++f) {
+            out << (f + 1);
+            if (typed) out << ' ' << types_[f];
+            for (int k = 0; k < 3; ++k) {
+                const Vec3& p = points_[tris_[f][k]];
+                out << num(p[0]) << num(p[1]) << num(p[2]);
+            }
+            out << "\n";
+        }
+    }
+    if (!out) throw std::runtime_error("SurfMesh: write failed for " + path);
+}
+
+// ---------------- measures ----------------
+
+double SurfMesh::extent() const {
+    if (points_.empty()) return 0.0;
+    Vec3 lo = points_[0], hi = points_[0];
+    for (const Vec3& p : points_) {
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], p[k]);
+            hi[k] = std::max(hi[k], p[k]);
+        }
+    }
+    return norm(sub(hi, lo));
+}
+
+double SurfMesh::area() const {
+    double a = 0.0;
+    for (const Tri& t : tris_) a += 0.5 * norm(tri_normal(points_, t));
+    return a;
+}
+
+double SurfMesh::volume() const {
+    double v = 0.0;
+    for (const Tri& t : tris_) {
+        v += dot(points_[t[0]], cross(points_[t[1]], points_[t[2]])) / 6.0;
+    }
+    return v;
+}
+
+SurfEdgeStats SurfMesh::edgeStats() const {
+    SurfEdgeStats st;
+    for (const auto& kv : edge_uses(tris_)) {
+        ++st.edges;
+        const auto& u = kv.second;
+        if (u.size() == 1) ++st.boundary;
+        else if (u.size() > 2) ++st.nonmanifold;
+        else if (u[0].dir == u[1].dir) ++st.misoriented;
+    }
+    return st;
+}
+
+std::size_t SurfMesh::components() const {
+    std::vector<int> parent(points_.size());
+    for (std::size_t i = 0; i < parent.size(); ++i) parent[i] = static_cast<int>(i);
+    auto find = [&](int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+    for (const Tri& t : tris_) {
+        parent[find(t[1])] = find(t[0]);
+        parent[find(t[2])] = find(t[0]);
+    }
+    std::vector<char> used(points_.size(), 0), root(points_.size(), 0);
+    for (const Tri& t : tris_) for (int v : t) used[v] = 1;
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < points_.size(); ++i) {
+        if (used[i] && !root[find(static_cast<int>(i))]) {
+            root[find(static_cast<int>(i))] = 1;
+            ++n;
+        }
+    }
+    return n;
+}
+
+// ---------------- repair ----------------
+
+void SurfMesh::compact_() {
+    std::vector<int> remap(points_.size(), -1);
+    std::vector<Vec3> pts;
+    pts.reserve(points_.size());
+    for (Tri& t : tris_) {
+        for (int& v : t) {
+            if (remap[v] < 0) {
+                remap[v] = static_cast<int>(pts.size());
+                pts.push_back(points_[v]);
+            }
+            v = remap[v];
+        }
+    }
+    points_.swap(pts);
+}
+
+std::size_t SurfMesh::weld(double tol) {
+    if (tol <= 0.0 || points_.empty()) return 0;
+
+    // Hash grid with tol-sized cells; a point merges into the first earlier
+    // representative within tol in its own or a neighbouring cell.
+    auto cell = [&](double x) { return static_cast<std::int64_t>(std::floor(x / tol)); };
+    auto key = [](std::int64_t x, std::int64_t y, std::int64_t z) {
+        std::uint64_t h = static_cast<std::uint64_t>(x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<std::uint64_t>(y) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= static_cast<std::uint64_t>(z) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return h;
+    };
+    std::unordered_map<std::uint64_t, std::vector<int>> grid;
+    grid.reserve(points_.size());
+    std::vector<int> remap(points_.size());
+    std::size_t merged = 0;
+
+    for (std::size_t i = 0; i < points_.size(); ++i) {
+        const Vec3& p = points_[i];
+        const std::int64_t cx = cell(p[0]), cy = cell(p[1]), cz = cell(p[2]);
+        int rep = -1;
+        for (std::int64_t dx = -1; dx <= 1 && rep < 0; ++dx) {
+            for (std::int64_t dy = -1; dy <= 1 && rep < 0; ++dy) {
+                for (std::int64_t dz = -1; dz <= 1 && rep < 0; ++dz) {
+                    auto it = grid.find(key(cx + dx, cy + dy, cz + dz));
+                    if (it == grid.end()) continue;
+                    for (int j : it->second) {
+                        if (norm(sub(points_[j], p)) <= tol) { rep = j; break; }
+                    }
+                }
+            }
+        }
+        if (rep >= 0) {
+            remap[i] = rep;
+            ++merged;
+        } else {
+            remap[i] = static_cast<int>(i);
+            grid[key(cx, cy, cz)].push_back(static_cast<int>(i));
+        }
+    }
+    for (Tri& t : tris_) for (int& v : t) v = remap[v];
+    compact_();
+    return merged;
+}
+
+std::size_t SurfMesh::removeDegenerate(double area_tol) {
+    std::vector<Tri> keep;
+    std::vector<int> keep_types;
+    for (std::size_t f = 0; f < tris_.size(); ++f) {
+        const Tri& t = tris_[f];
+        if (t[0] == t[1] || t[1] == t[2] || t[0] == t[2]) continue;
+        if (0.5 * norm(tri_normal(points_, t)) <= area_tol) continue;
+        keep.push_back(t);
+        keep_types.push_back(types_[f]);
+    }
+    const std::size_t removed = tris_.size() - keep.size();
+    tris_.swap(keep);
+    types_.swap(keep_types);
+    compact_();
+    return removed;
+}
+
+std::size_t SurfMesh::removeDuplicates() {
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> seen;
+    std::vector<Tri> keep;
+    std::vector<int> keep_types;
+    for (std::size_t f = 0; f < tris_.size(); ++f) {
+        Tri s = tris_[f];
+        std::sort(s.begin(), s.end());
+        const std::uint64_t h = edge_key(s[0], s[1]) * 0x9E3779B97F4A7C15ull ^ static_cast<std::uint64_t>(s[2]);
+        bool dup = false;
+        for (std::size_t k : seen[h]) {
+            Tri o = keep[k];
+            std::sort(o.begin(), o.end());
+            if (o == s) { dup = true; break; }
+        }
+        if (dup) continue;
+        seen[h].push_back(keep.size());
+        keep.push_back(tris_[f]);
+        keep_types.push_back(types_[f]);
+    }
+    const std::size_t removed = tris_.size() - keep.size();
+    tris_.swap(keep);
+    types_.swap(keep_types);
+    return removed;
+}
+
+std::size_t SurfMesh::orient(SurfNormals mode) {
+    const std::size_t nf = tris_.size();
+    const auto uses = edge_uses(tris_);
+
+    // Faces across each manifold edge, for the flood fill.
+    std::vector<std::vector<std::pair<int, std::uint64_t>>> nbr(nf);
+    for (const auto& kv : uses) {
+        if (kv.second.size() != 2) continue;
+        const int f = kv.second[0].face, g = kv.second[1].face;
+        if (f == g) continue;
+        nbr[f].push_back({g, kv.first});
+        nbr[g].push_back({f, kv.first});
+    }
+    auto dir_of = [&](int f, std::uint64_t e) {
+        for (const EdgeUse& u : uses.at(e)) if (u.face == f) return u.dir;
+        return 0;
+    };
+
+    std::vector<int>  comp(nf, -1);
+    std::vector<char> flip(nf, 0);
+    int ncomp = 0;
+    for (std::size_t seed = 0; seed < nf; ++seed) {
+        if (comp[seed] >= 0) continue;
+        std::vector<int> queue{static_cast<int>(seed)};
+        comp[seed] = ncomp;
+        for (std::size_t qi = 0; qi < queue.size(); ++qi) {
+            const int f = queue[qi];
+            for (const auto& ng : nbr[f]) {
+                const int g = ng.first;
+                if (comp[g] >= 0) continue;
+                const int df = dir_of(f, ng.second) * (flip[f] ? -1 : 1);
+                // Neighbours must run the shared edge the other way.
+                flip[g] = dir_of(g, ng.second) == df ? 1 : 0;
+                comp[g] = ncomp;
+                queue.push_back(g);
+            }
+        }
+        ++ncomp;
+    }
+    for (std::size_t f = 0; f < nf; ++f) {
+        if (flip[f]) std::swap(tris_[f][1], tris_[f][2]);
+    }
+
+    // Per component: closed or not, signed volume, faces flipped so far.
+    std::vector<char>        open(ncomp, 0);
+    std::vector<double>      vol(ncomp, 0.0);
+    std::vector<std::size_t> size(ncomp, 0), flipped(ncomp, 0);
+    for (const auto& kv : uses) {
+        if (kv.second.size() != 2) {
+            for (const EdgeUse& u : kv.second) open[comp[u.face]] = 1;
+        }
+    }
+    for (std::size_t f = 0; f < nf; ++f) {
+        const Tri& t = tris_[f];
+        vol[comp[f]] += dot(points_[t[0]], cross(points_[t[1]], points_[t[2]])) / 6.0;
+        ++size[comp[f]];
+        if (flip[f]) ++flipped[comp[f]];
+    }
+
+    std::vector<char> reverse(ncomp, 0);
+    for (int c = 0; c < ncomp; ++c) {
+        if (!open[c] && mode == SurfNormals::Outward) reverse[c] = vol[c] < 0.0;
+        else if (!open[c] && mode == SurfNormals::Inward) reverse[c] = vol[c] > 0.0;
+        else reverse[c] = 2 * flipped[c] > size[c];   // keep the majority orientation
+    }
+    std::size_t changed = 0;
+    for (std::size_t f = 0; f < nf; ++f) {
+        if (reverse[comp[f]]) {
+            std::swap(tris_[f][1], tris_[f][2]);
+            flip[f] = !flip[f];
+        }
+        if (flip[f]) ++changed;
+    }
+    return changed;
+}
+
+std::size_t SurfMesh::fillHoles() {
+    const auto uses = edge_uses(tris_);
+
+    // Boundary half-edges a -> b (as their triangle runs them), by start.
+    std::unordered_map<int, std::vector<std::pair<int, int>>> out;   // a -> (b, face)
+    std::size_t nboundary = 0;
+    for (const auto& kv : uses) {
+        if (kv.second.size() != 1) continue;
+        const Tri& t = tris_[kv.second[0].face];
+        for (int k = 0; k < 3; ++k) {
+            const int a = t[k], b = t[(k + 1) % 3];
+            if (edge_key(a, b) == kv.first) {
+                out[a].push_back({b, kv.second[0].face});
+                ++nboundary;
+            }
+        }
+    }
+
+    const std::size_t max_loop = nboundary;
+    std::size_t filled = 0;
+    while (nboundary > 0) {
+        auto start = std::find_if(out.begin(), out.end(), [](const auto& kv) { return !kv.second.empty(); });
+        if (start == out.end()) break;
+
+        // Walk one loop of boundary half-edges.
+        std::vector<int> loop{start->first};
+        int type = types_[start->second.back().second];
+        int cur = start->second.back().first;
+        start->second.pop_back();
+        --nboundary;
+        bool closed = false;
+        while (loop.size() <= max_loop) {
+            if (cur == loop[0]) { closed = true; break; }
+            auto it = out.find(cur);
+            if (it == out.end() || it->second.empty()) break;
+            loop.push_back(cur);
+            cur = it->second.back().first;
+            it->second.pop_back();
+            --nboundary;
+        }
+        if (!closed || loop.size() < 3) continue;
+
+        // New faces run every boundary edge the other way.
+        if (loop.size() == 3) {
+            tris_.push_back({loop[0], loop[2], loop[1]});
+            types_.push_back(type);
+        } else {
+            Vec3 c{0.0, 0.0, 0.0};
+            for (int v : loop) for (int k = 0; k < 3; ++k) c[k] += points_[v][k] / loop.size();
+            const int ci = static_cast<int>(points_.size());
+            points_.push_back(c);
+            for (std::size_t i = 0; i < loop.size(); ++i) {
+                tris_.push_back({loop[(i + 1) % loop.size()], loop[i], ci});
+                types_.push_back(type);
+            }
+        }
+        ++filled;
+    }
+    return filled;
+}
+
+// ---------------- decimation ----------------
+
+SurfDecimateResult SurfMesh::decimate(std::size_t target_tris, double max_error,
+                                      const std::vector<SurfRegion>& fine) {
+    SurfDecimateResult res;
+    const std::size_t nv = points_.size(), nf = tris_.size();
+
+    std::vector<Quadric> Q(nv);
+    std::vector<std::vector<int>> vf(nv);
+    for (std::size_t f = 0; f < nf; ++f) {
+        const Tri& t = tris_[f];
+        Vec3 n = tri_normal(points_, t);
+        const double len = norm(n);
+        if (len > 0.0) {
+            for (double& x : n) x /= len;
+            const Quadric k = Quadric::plane(n, -dot(n, points_[t[0]]));
+            for (int v : t) Q[v] += k;
+        }
+        for (int v : t) vf[v].push_back(static_cast<int>(f));
+    }
+
+    // Locked vertices never move: fine regions, boundary and non-manifold
+    // edges, and borders between surface types.
+    std::vector<char> locked(nv, 0);
+    for (std::size_t f = 0; f < nf; ++f) {
+        const Tri& t = tris_[f];
+        Vec3 c{0.0, 0.0, 0.0};
+        for (int v : t) for (int k = 0; k < 3; ++k) c[k] += points_[v][k] / 3.0;
+        bool in = false;
+        for (const SurfRegion& r : fine) {
+            in = in || r.contains(c) || r.contains(points_[t[0]]) || r.contains(points_[t[1]]) ||
+                 r.contains(points_[t[2]]);
+        }
+        if (in) {
+            ++res.protected_tris;
+            for (int v : t) locked[v] = 1;
+        }
+    }
+    for (const auto& kv : edge_uses(tris_)) {
+        bool mixed = false;
+        for (const EdgeUse& u : kv.second) mixed = mixed || types_[u.face] != types_[kv.second[0].face];
+        if (kv.second.size() != 2 || mixed) {
+            locked[static_cast<int>(kv.first >> 32)] = 1;
+            locked[static_cast<int>(kv.first & 0xFFFFFFFFu)] = 1;
+        }
+    }
+
+    std::vector<char>     face_alive(nf, 1), vert_alive(nv, 1);
+    std::vector<unsigned> stamp(nv, 0);
+    std::size_t alive = nf;
+
+    struct Candidate {
+        double   cost;
+        int      a, b;
+        unsigned sa, sb;
+        Vec3     pos;
+        bool operator>(const Candidate& o) const { return cost > o.cost; }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap;
+
+    auto push_edge = [&](int a, int b) {
+        if (locked[a] || locked[b]) return;
+        Quadric q = Q[a];
+        q += Q[b];
+        const Vec3& pa = points_[a];
+        const Vec3& pb = points_[b];
+        const Vec3 mid{0.5 * (pa[0] + pb[0]), 0.5 * (pa[1] + pb[1]), 0.5 * (pa[2] + pb[2])};
+        Candidate c{q.cost(mid), a, b, stamp[a], stamp[b], mid};
+        for (const Vec3* p : {&pa, &pb}) {
+            const double k = q.cost(*p);
+            if (k < c.cost) { c.cost = k; c.pos = *p; }
+        }
+        Vec3 opt;
+        // The optimum only counts near the edge (flat regions make it drift).
+        if (q.optimum(opt) && norm(sub(opt, mid)) <= norm(sub(pa, pb))) {
+            const double k = q.cost(opt);
+            if (k < c.cost) { c.cost = k; c.pos = opt; }
+        }
+        c.cost = std::max(c.cost, 0.0);
+        heap.push(c);
+    };
+    auto neighbours = [&](int v) {
+        std::vector<int> n;
+        for (int f : vf[v]) for (int u : tris_[f]) if (u != v) n.push_back(u);
+        std::sort(n.begin(), n.end());
+        n.erase(std::unique(n.begin(), n.end()), n.end());
+        return n;
+    };
+
+    for (std::size_t v = 0; v < nv; ++v) {
+        for (int u : neighbours(static_cast<int>(v))) {
+            if (static_cast<int>(v) < u) push_edge(static_cast<int>(v), u);
+        }
+    }
+
+    const double max_cost = max_error * max_error;
+    while (alive > target_tris && alive > 4 && !heap.empty()) {
+        const Candidate c = heap.top();
+        heap.pop();
+        if (!vert_alive[c.a] || !vert_alive[c.b] || stamp[c.a] != c.sa || stamp[c.b] != c.sb) continue;
+        if (c.cost > max_cost) break;   // every live candidate costs at least this much
+
+        // Link condition: the only shared neighbours are the two triangles'
+        // apexes, otherwise the collapse pinches the surface.
+        std::vector<int> shared_faces;
+        for (int f : vf[c.a]) {
+            const Tri& t = tris_[f];
+            if (t[0] == c.b || t[1] == c.b || t[2] == c.b) shared_faces.push_back(f);
+        }
+        const auto na = neighbours(c.a), nb = neighbours(c.b);
+        std::vector<int> common;
+        std::set_intersection(na.begin(), na.end(), nb.begin(), nb.end(), std::back_inserter(common));
+        if (shared_faces.size() != 2 || common.size() != 2) continue;
+
+        // No remaining triangle may fold over or collapse.
+        bool ok = true;
+        for (int v : {c.a, c.b}) {
+            for (int f : vf[v]) {
+                if (std::find(shared_faces.begin(), shared_faces.end(), f) != shared_faces.end()) continue;
+                const Tri& t = tris_[f];
+                std::array<Vec3, 3> pts{{points_[t[0]], points_[t[1]], points_[t[2]]}};
+                for (int k = 0; k < 3; ++k) if (t[k] == v) pts[k] = c.pos;
+                const Vec3 before = tri_normal(points_, t);
+                const Vec3 after  = cross(sub(pts[1], pts[0]), sub(pts[2], pts[0]));
+                const double lb = norm(before), la = norm(after);
+                if (la <= 1e-12 * lb || dot(before, after) < 0.25 * lb * la) { ok = false; break; }
+            }
+            if (!ok) break;
+        }
+        if (!ok) continue;
+
+        // Collapse b into a.
+        points_[c.a] = c.pos;
+        Q[c.a] += Q[c.b];
+        for (int f : shared_faces) {
+            face_alive[f] = 0;
+            --alive;
+            for (int u : tris_[f]) {
+                auto& list = vf[u];
+                list.erase(std::remove(list.begin(), list.end(), f), list.end());
+            }
+        }
+        for (int f : vf[c.b]) {
+            for (int& u : tris_[f]) if (u == c.b) u = c.a;
+            vf[c.a].push_back(f);
+        }
+        vf[c.b].clear();
+        vert_alive[c.b] = 0;
+        ++stamp[c.a];
+        ++res.collapses;
+        res.max_error = std::max(res.max_error, std::sqrt(c.cost));
+
+        for (int u : neighbours(c.a)) push_edge(std::min(c.a, u), std::max(c.a, u));
+    }
+    res.reached_target = alive <= target_tris;
+
+    std::vector<Tri> keep;
+    std::vector<int> keep_types;
+    for (std::size_t f = 0; f < nf; ++f) {
+        if (!face_alive[f]) continue;
+        keep.push_back(tris_[f]);
+        keep_types.push_back(types_[f]);
+    }
+    tris_.swap(keep);
+    types_.swap(keep_types);
+    compact_();
+    return res;
+}
@@ -0,0 +1,365 @@
+// Sim/src/TelemetryRing.cpp
+#include "TelemetryRing.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace telemetry_detail {
+
+struct Header {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t ncols;
+    std::uint32_t slots;
+    std::uint32_t slot_bytes;
+    std::uint64_t schema_hash;
+    std::uint64_t columns_offset;
+    std::uint64_t control_offset;
+    std::uint64_t slots_offset;
+    std::uint32_t producer_pid;
+    std::atomic<std::uint32_t> closed;
+    alignas(64) std::atomic<std::uint64_t> head;
+};
+static_assert(sizeof(Header) == 128, "telemetry header is two cache lines");
+
+struct alignas(64) Control {
+    std::atomic<std::uint64_t> seq;
+    std::atomic<std::uint64_t> applied;
+    std::atomic<std::int64_t>  applied_tick;
+    std::uint32_t mask;
+    std::uint32_t pad;
+    double        values[kTelemetryControlFields];
+};
+static_assert(sizeof(Control) == 128, "telemetry control block is two cache lines");
+
+} // namespace telemetry_detail
+
+using telemetry_detail::Control;
+using telemetry_detail::Header;
+using telemetry_detail::Slot;
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'F', 'T', 'E', 'L', 'E', 'M', '\0'};
+
+std::size_t round_up(std::size_t n, std::size_t a) { return (n + a - 1) / a * a; }
+
+std::string shm_name(const std::string& name) {
+    if (name.empty()) throw std::runtime_error("TelemetryRing: empty segment name");
+    return name[0] == '/' ? name : "/" + name;
+}
+
+std::string errno_text() { return std::strerror(errno); }
+
+// Control values: one slot per field, booleans as 0/1.
+enum ControlSlot { kEffusionTarget, kSubstrateTarget, kSubstrateControl, kSourceControl, kBeam };
+
+} // namespace
+
+std::uint64_t telemetrySchemaHash(const std::vector<std::string>& columns) {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](unsigned char c) {
+        h ^= c;
+        h *= 1099511628211ull;
+    };
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) mix(',');
+        for (unsigned char c : columns[i]) mix(c);
+    }
+    return h;
+}
+
+TelemetryControl TelemetryControl::parse(const std::string& spec) {
+    TelemetryControl c;
+    std::size_t pos = 0;
+    while (pos < spec.size()) {
+        std::size_t end = spec.find(',', pos);
+        if (end == std::string::npos) end = spec.size();
+        const std::string item = spec.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) continue;
+
+        const std::size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("TelemetryControl: expected key=value, got '" + item + "'");
+        }
+        const std::string key = item.substr(0, eq);
+        const std::string val = item.substr(eq + 1);
+        char* tail = nullptr;
+        const double v = std::strtod(val.c_str(), &tail);
+        if (val.empty() || *tail != '\0' || !std::isfinite(v)) {
+            throw std::runtime_error("TelemetryControl: bad value for " + key + ": '" + val + "'");
+        }
+
+        if (key == "effusion_target_K") {
+            c.mask |= EffusionTargetK;
+            c.effusion_target_K = v;
+        } else if (key == "substrate_target_K") {
+            c.mask |= SubstrateTargetK;
+            c.substrate_target_K = v;
+        } else if (key == "substrate_control") {
+            c.mask |= SubstrateControl;
+            c.substrate_control = v != 0.0;
+        } else if (key == "source_control") {
+            c.mask |= SourceControl;
+            c.source_control = v != 0.0;
+        } else if (key == "beam_allowed") {
+            c.mask |= BeamAllowed;
+            c.beam_allowed = v != 0.0;
+        } else {
+            throw std::runtime_error("TelemetryControl: unknown key '" + key + "'");
+        }
+    }
+    return c;
+}
+
+// ---------------- TelemetryPublisher ----------------
+
+TelemetryPublisher::~TelemetryPublisher() { close(); }
+
+void TelemetryPublisher::open(const std::string& name, const std::vector<std::string>& columns,
+                              std::size_t slots) {
+    close();
+    if (columns.empty()) throw std::runtime_error("TelemetryRing: no columns");
+    for (const std::string& c : columns) {
+        if (c.empty() || c.size() >= kTelemetryNameBytes) {
+            throw std::runtime_error("TelemetryRing: column name '" + c + "' must have 1-" +
+                                     std::to_string(kTelemetryNameBytes - 1) + " characters");
+        }
+    }
+    std::size_t cap = 2;
+    while (cap < slots) cap <<= 1;
+
+    ncols_      = columns.size();
+    slot_bytes_ = round_up(sizeof(Slot) + ncols_ * sizeof(double), 64);
+    mask_       = cap - 1;
+
+    const std::size_t columns_offset = sizeof(Header);
+    const std::size_t control_offset = round_up(columns_offset + ncols_ * kTelemetryNameBytes, 64);
+    const std::size_t slots_offset   = control_offset + sizeof(Control);
+    bytes_ = slots_offset + cap * slot_bytes_;
+
+    // A fresh segment: readers of an older run keep the old (closed) one.
+    const std::string shm = shm_name(name);
+    shm_unlink(shm.c_str());
+    const int fd = shm_open(shm.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) throw std::runtime_error("TelemetryRing: shm_open " + shm + ": " + errno_text());
+    if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+        const std::string err = errno_text();
+        ::close(fd);
+        shm_unlink(shm.c_str());
+        throw std::runtime_error("TelemetryRing: sizing " + shm + ": " + err);
+    }
+    void* p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(shm.c_str());
+        throw std::runtime_error("TelemetryRing: mmap " + shm + ": " + errno_text());
+    }
+
+    // ftruncate zero-fills, and zero is a valid initial state for the
+    // atomics, so only the fixed fields need writing.
+    base_  = p;
+    name_  = shm;
+    auto* bytes = static_cast<unsigned char*>(p);
+    hdr_   = new (bytes) Header;
+    ctl_   = new (bytes + control_offset) Control;
+    slots_ = bytes + slots_offset;
+
+    hdr_->version        = kTelemetryLayoutVersion;
+    hdr_->ncols          = static_cast<std::uint32_t>(ncols_);
+    hdr_->slots          = static_cast<std::uint32_t>(cap);
+    hdr_->slot_bytes     = static_cast<std::uint32_t>(slot_bytes_);
+    hdr_->schema_hash    = telemetrySchemaHash(columns);
+    hdr_->columns_offset = columns_offset;
+    hdr_->control_offset = control_offset;
+    hdr_->slots_offset   = slots_offset;
+    hdr_->producer_pid   = static_cast<std::uint32_t>(getpid());
+    for (std::size_t i = 0; i < ncols_; ++i) {
+        std::memcpy(bytes + columns_offset + i * kTelemetryNameBytes,
+                    columns[i].data(), columns[i].size());
+    }
+    head_ = 0;
+    control_seen_ = 0;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(hdr_->magic, kMagic, sizeof(kMagic));
+}
+
+void TelemetryPublisher::close() {
+    if (!base_) return;
+    hdr_->closed.store(1, std::memory_order_release);
+    munmap(base_, bytes_);
+    shm_unlink(name_.c_str());
+    base_ = nullptr;
+    hdr_  = nullptr;
+    ctl_  = nullptr;
+    slots_ = nullptr;
+}
+
+Slot* TelemetryPublisher::slot_(std::uint64_t k) const {
+    return reinterpret_cast<Slot*>(slots_ + (k & mask_) * slot_bytes_);
+}
+
+void TelemetryPublisher::publish(long tick, double time, std::initializer_list<double> vals) {
+    publish(tick, time, vals.begin(), vals.size());
+}
+
+void TelemetryPublisher::publish(long tick, double time, const double* vals, std::size_t n) {
+    if (!hdr_) return;
+    if (n != ncols_) {
+        throw std::runtime_error("TelemetryRing: record has " + std::to_string(n) +
+                                 " values, schema has " + std::to_string(ncols_));
+    }
+    const std::uint64_t k = head_;
+    Slot* s = slot_(k);
+    s->seq.store(2 * k + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s->tick = tick;
+    s->time = time;
+    std::memcpy(s->values(), vals, n * sizeof(double));
+    s->seq.store(2 * k + 2, std::memory_order_release);
+    head_ = k + 1;
+    hdr_->head.store(head_, std::memory_order_release);
+}
+
+bool TelemetryPublisher::pollControl(TelemetryControl& out, long tick) {
+    if (!ctl_) return false;
+    const std::uint64_t s1 = ctl_->seq.load(std::memory_order_acquire);
+    if (s1 == control_seen_ || (s1 & 1u) != 0) return false;
+
+    TelemetryControl c;
+    c.mask = ctl_->mask;
+    double v[kTelemetryControlFields];
+    std::memcpy(v, ctl_->values, sizeof(v));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (ctl_->seq.load(std::memory_order_relaxed) != s1) return false;   // torn
+
+    c.effusion_target_K  = v[kEffusionTarget];
+    c.substrate_target_K = v[kSubstrateTarget];
+    c.substrate_control  = v[kSubstrateControl] != 0.0;
+    c.source_control     = v[kSourceControl] != 0.0;
+    c.beam_allowed       = v[kBeam] != 0.0;
+    out = c;
+
+    control_seen_ = s1;
+    ctl_->applied_tick.store(tick, std::memory_order_relaxed);
+    ctl_->applied.store(s1 / 2, std::memory_order_release);
+    return true;
+}
+
+// ---------------- TelemetryReader ----------------
+
+TelemetryReader::~TelemetryReader() { close(); }
+
+void TelemetryReader::open(const std::string& name, std::uint64_t expected_hash) {
+    close();
+    const std::string shm = shm_name(name);
+    // Read-write for the control channel; read-only when that is all the
+    // segment's permissions allow.
+    writable_ = true;
+    int fd = shm_open(shm.c_str(), O_RDWR, 0);
+    if (fd < 0 && errno == EACCES) {
+        writable_ = false;
+        fd = shm_open(shm.c_str(), O_RDONLY, 0);
+    }
+    if (fd < 0) throw std::runtime_error("TelemetryRing: shm_open " + shm + ": " + errno_text());
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("TelemetryRing: " + shm + " is not initialized");
+    }
+    const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    void* p = mmap(nullptr, bytes, writable_ ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("TelemetryRing: mmap " + shm + ": " + errno_text());
+    base_  = p;
+    bytes_ = bytes;
+
+    const auto* h = static_cast<const Header*>(p);
+    const auto fail = [&](const std::string& why) {
+        close();
+        throw std::runtime_error("TelemetryRing: " + shm + ": " + why);
+    };
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0) fail("not an initialized telemetry segment");
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (h->version != kTelemetryLayoutVersion) {
+        fail("layout version " + std::to_string(h->version) + ", expected " +
+             std::to_string(kTelemetryLayoutVersion));
+    }
+    const std::size_t cap = h->slots;
+    if (cap < 2 || (cap & (cap - 1)) != 0 || h->slots_offset + cap * h->slot_bytes > bytes) {
+        fail("inconsistent header");
+    }
+    if (expected_hash != 0 && h->schema_hash != expected_hash) fail("schema differs from the expected one");
+
+    auto* b = static_cast<unsigned char*>(p);
+    hdr_   = h;
+    ctl_   = reinterpret_cast<Control*>(b + h->control_offset);
+    slots_ = b + h->slots_offset;
+    ncols_ = h->ncols;
+    slot_bytes_ = h->slot_bytes;
+    mask_  = cap - 1;
+    columns_.clear();
+    for (std::size_t i = 0; i < ncols_; ++i) {
+        const char* n = reinterpret_cast<const char*>(b + h->columns_offset + i * kTelemetryNameBytes);
+        columns_.emplace_back(n, strnlen(n, kTelemetryNameBytes));
+    }
+}
+
+void TelemetryReader::close() {
+    if (!base_) return;
+    munmap(base_, bytes_);
+    base_ = nullptr;
+    hdr_  = nullptr;
+    ctl_  = nullptr;
+    slots_ = nullptr;
+    columns_.clear();
+}
+
+std::uint64_t TelemetryReader::schemaHash() const { return hdr_ ? hdr_->schema_hash : 0; }
+int TelemetryReader::producerPid() const { return hdr_ ? static_cast<int>(hdr_->producer_pid) : 0; }
+bool TelemetryReader::closed() const {
+    return !hdr_ || hdr_->closed.load(std::memory_order_acquire) != 0;
+}
+std::uint64_t TelemetryReader::head() const {
+    return hdr_ ? hdr_->head.load(std::memory_order_acquire) : 0;
+}
+
+const Slot* TelemetryReader::slot_(std::uint64_t k) const {
+    return reinterpret_cast<const Slot*>(slots_ + (k & mask_) * slot_bytes_);
+}
+
+void TelemetryReader::sendControl(const TelemetryControl& c) {
+    if (!ctl_ || !writable_) {
+        throw std::runtime_error("TelemetryRing: sendControl needs a segment opened read-write");
+    }
+    const std::uint64_t s = ctl_->seq.load(std::memory_order_relaxed) & ~std::uint64_t{1};
+    ctl_->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    double v[kTelemetryControlFields] = {0.0};
+    v[kEffusionTarget]   = c.effusion_target_K;
+    v[kSubstrateTarget]  = c.substrate_target_K;
+    v[kSubstrateControl] = c.substrate_control ? 1.0 : 0.0;
+    v[kSourceControl]    = c.source_control ? 1.0 : 0.0;
+    v[kBeam]             = c.beam_allowed ? 1.0 : 0.0;
+    ctl_->mask = c.mask;
+    std::memcpy(ctl_->values, v, sizeof(v));
+    ctl_->seq.store(s + 2, std::memory_order_release);
+}
+
+std::uint64_t TelemetryReader::controlApplied() const {
+    return ctl_ ? ctl_->applied.load(std::memory_order_acquire) : 0;
+}
+long TelemetryReader::controlAppliedTick() const {
+    return ctl_ ? static_cast<long>(ctl_->applied_tick.load(std::memory_order_relaxed)) : 0;
+}
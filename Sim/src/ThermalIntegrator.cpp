@@ -0,0 +1,90 @@
+#include "ThermalIntegrator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// (exp(z) - 1) / z, continuous at z = 0.
+double phi1(double z) {
+    if (std::fabs(z) < 1e-8) return 1.0 + 0.5 * z;
+    return std::expm1(z) / z;
+}
+
+}  // namespace
+
+ThermalIntegratorKind parseThermalIntegratorKind(const std::string& text) {
+    if (text == "euler")  return ThermalIntegratorKind::Euler;
+    if (text == "stable") return ThermalIntegratorKind::Stable;
+    throw std::runtime_error("Unknown thermal integrator '" + text + "' (expected euler|stable)");
+}
+
+const char* thermalIntegratorKindName(ThermalIntegratorKind kind) {
+    switch (kind) {
+        case ThermalIntegratorKind::Euler:  return "euler";
+        case ThermalIntegratorKind::Stable: return "stable";
+    }
+    return "unknown";
+}
+
+double ThermalNode::netW(double T_K) const {
+    const double T2   = T_K * T_K;
+    const double Te2  = T_env_K * T_env_K;
+    return P_in_W - h_W_per_K * (T_K - T_env_K) - k_rad_W_K4 * (T2 * T2 - Te2 * Te2);
+}
+
+double ThermalIntegrator::expEulerSteps(const ThermalNode& node, double T_K,
+                                        double dt_s, int n) {
+    const double tau = dt_s / n;
+    double T = T_K;
+    for (int s = 0; s < n; ++s) {
+        // Tangent decay rate: -(d net / dT) / C.
+        const double k = (node.h_W_per_K + 4.0 * node.k_rad_W_K4 * T * T * T) / node.C_J_per_K;
+        const double f = node.netW(T) / node.C_J_per_K;
+        T = std::max(0.0, T + f * tau * phi1(-k * tau));
+    }
+    return T;
+}
+
+double ThermalIntegrator::advance(const ThermalNode& node, double T_K, double dt_s) {
+    last_substeps_ = 1;
+    const double dt = std::max(0.0, dt_s);
+    if (dt <= 0.0 || node.C_J_per_K <= 0.0) return T_K;
+
+    if (cfg_.kind == ThermalIntegratorKind::Euler) {
+        return std::max(0.0, T_K + (node.netW(T_K) / node.C_J_per_K) * dt);
+    }
+
+    if (node.k_rad_W_K4 <= 0.0) {
+        // Linear node: exact solution for constant P_in over the tick.
+        if (node.h_W_per_K <= 0.0) {
+            return std::max(0.0, T_K + (node.P_in_W / node.C_J_per_K) * dt);
+        }
+        const double T_eq  = node.T_env_K + node.P_in_W / node.h_W_per_K;
+        const double decay = std::exp(-node.h_W_per_K * dt / node.C_J_per_K);
+        return std::max(0.0, T_eq + (T_K - T_eq) * decay);
+    }
+
+    // Radiative node: the substep is second order (exact tangent decay), so
+    // |fine - coarse| / 3 estimates the error of the 2n-substep pass. Double n
+    // until that is within tol_K, then Richardson-extrapolate the pair.
+    const int max_n = std::max(1, cfg_.max_substeps);
+    const double tol = std::max(1e-12, cfg_.tol_K);
+
+    int n = 1;
+    double coarse = expEulerSteps(node, T_K, dt, n);
+    double result = coarse;
+    while (2 * n <= max_n) {
+        const double fine = expEulerSteps(node, T_K, dt, 2 * n);
+        n *= 2;
+        result = fine;
+        if (std::fabs(fine - coarse) <= 3.0 * tol) {
+            result = std::max(0.0, fine + (fine - coarse) / 3.0);
+            break;
+        }
+        coarse = fine;
+    }
+    last_substeps_ = n;
+    return result;
+}
@@ -1,67 +1,205 @@
 #include "TickPhaseEngine.hpp"
+#include "Profiler.hpp"
 
-TickPhaseEngine::TickPhaseEngine()
-    : running_(false),
-      tickIndex_(-1),
-      doneCount_(0) {}
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 
+namespace {
+constexpr int kNumPhases = static_cast<int>(TickPhase::Storage) + 1;
+}
+
+TickPhaseEngine::TickPhaseEngine() = default;
 
 TickPhaseEngine::~TickPhaseEngine() {
     stop();
 }
 
+void TickPhaseEngine::addSubsystem(Subsystem* s) {
+    subsystems_.push_back(s);
+    built_ = false;
+}
+
+void TickPhaseEngine::setWorkers(int n) {
+    workers_ = std::max(0, n);
+}
+
+// Group subsystems by phase and turn tickAfter() names into edges.
+void TickPhaseEngine::buildPhases_() {
+    phases_.assign(kNumPhases, Phase{});
 
-void TickPhaseEngine::start() {
-    running_ = true;
     for (auto* s : subsystems_) {
-        threads_.emplace_back([&, s]() {
-            int seen = -1;
-            while (true) {
-                std::unique_lock<std::mutex> lock(mtx_);
-                cv_.wait(lock, [&]() { 
-                    return !running_ || tickIndex_ > seen; 
-                });
-
-                if (!running_) break;
-
-                seen = tickIndex_;
-                TickContext ctx = currentCtx_;  // guaranteed valid now
-                lock.unlock();
-
-                s->tick(ctx);
-                doneCount_.fetch_add(1, std::memory_order_relaxed);
+        Node n;
+        n.sub = s;
+        n.profileId = Profiler::instance().intern(s->getName());
+        phases_[static_cast<int>(s->tickPhase())].nodes.push_back(n);
+    }
+
+    for (auto& ph : phases_) {
+        for (std::size_t i = 0; i < ph.nodes.size(); ++i) {
+            for (const auto& dep : ph.nodes[i].sub->tickAfter()) {
+                for (std::size_t j = 0; j < ph.nodes.size(); ++j) {
+                    if (j != i && ph.nodes[j].sub->getName() == dep) {
+                        ph.nodes[j].succ.push_back(static_cast<int>(i));
+                        ph.nodes[i].indeg += 1;
+                    }
+                }
+            }
+        }
+
+        // Kahn's algorithm, always taking the lowest ready index so the serial
+        // order matches addSubsystem() order wherever dependencies allow.
+        std::vector<int> indeg(ph.nodes.size());
+        for (std::size_t i = 0; i < ph.nodes.size(); ++i) indeg[i] = ph.nodes[i].indeg;
+
+        ph.serialOrder.clear();
+        std::vector<bool> taken(ph.nodes.size(), false);
+        for (std::size_t k = 0; k < ph.nodes.size(); ++k) {
+            int pick = -1;
+            for (std::size_t i = 0; i < ph.nodes.size(); ++i) {
+                if (!taken[i] && indeg[i] == 0) {
+                    pick = static_cast<int>(i);
+                    break;
+                }
             }
-        });
+            if (pick < 0) {
+                throw std::runtime_error(
+                    "TickPhaseEngine: dependency cycle among tickAfter() declarations");
+            }
+            taken[pick] = true;
+            ph.serialOrder.push_back(pick);
+            for (int v : ph.nodes[pick].succ) indeg[v] -= 1;
+        }
     }
+
+    // Pool scratch sized once so runPhase() never grows it.
+    ready_.reserve(subsystems_.size());
+    pendingIndeg_.reserve(subsystems_.size());
+    built_ = true;
 }
 
+void TickPhaseEngine::start() {
+    stop();
+    buildPhases_();
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_ = true;
+    for (int i = 0; i < workers_; ++i) {
+        threads_.emplace_back([this]() { workerLoop_(); });
+    }
+}
 
 void TickPhaseEngine::stop() {
-    if (!running_) return;
-    running_ = false;
-    cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) return;
+        running_ = false;
+    }
+    workCv_.notify_all();
     for (auto& t : threads_) {
         if (t.joinable()) t.join();
     }
     threads_.clear();
 }
 
-void TickPhaseEngine::addSubsystem(Subsystem* s) {
-    subsystems_.push_back(s);
-    // Worker threads will be spawned in start()
+// Pops one ready node, runs it with the lock released, then releases its
+// successors. Returns false if nothing was ready. Caller holds lk.
+bool TickPhaseEngine::runOneReady_(std::unique_lock<std::mutex>& lk) {
+    if (!current_ || ready_.empty()) return false;
+
+    // Lowest index first keeps the execution order close to the serial one.
+    auto it = std::min_element(ready_.begin(), ready_.end());
+    const int idx = *it;
+    ready_.erase(it);
+
+    Phase& ph = *current_;
+    Subsystem* s = ph.nodes[idx].sub;
+    const std::uint32_t profileId = ph.nodes[idx].profileId;
+    const TickContext ctx = currentCtx_;
+
+    lk.unlock();
+    std::exception_ptr err;
+    try {
+        ProfileScope scope(ProfileCat::Subsystem, profileId);
+        s->tick(ctx);
+    } catch (...) {
+        err = std::current_exception();
+    }
+    lk.lock();
+
+    if (err && !error_) error_ = err;
+
+    bool released = false;
+    for (int v : ph.nodes[idx].succ) {
+        if (--pendingIndeg_[v] == 0) {
+            ready_.push_back(v);
+            released = true;
+        }
+    }
+    if (--remaining_ == 0) {
+        doneCv_.notify_all();
+    } else if (released) {
+        workCv_.notify_all();
+        doneCv_.notify_one();   // let a parked caller help with the new work
+    }
+    return true;
 }
 
-void TickPhaseEngine::runTick(const TickContext& ctx) {
-    {
-        std::lock_guard<std::mutex> lock(mtx_);
-        tickIndex_   = ctx.tick_index;
-        currentCtx_  = ctx;
-        doneCount_   = 0;
+void TickPhaseEngine::workerLoop_() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (true) {
+        workCv_.wait(lk, [&]() { return !running_ || !ready_.empty(); });
+        if (!running_) break;
+        runOneReady_(lk);
     }
+}
+
+void TickPhaseEngine::runPhase(TickPhase phase, const TickContext& ctx) {
+    if (!built_) buildPhases_();
+
+    Phase& ph = phases_[static_cast<int>(phase)];
+    if (ph.nodes.empty()) return;
+
+    // Serial path: no pool, or nothing to overlap.
+    if (threads_.empty() || ph.nodes.size() == 1) {
+        for (int idx : ph.serialOrder) {
+            ProfileScope scope(ProfileCat::Subsystem, ph.nodes[idx].profileId);
+            ph.nodes[idx].sub->tick(ctx);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    current_    = &ph;
+    currentCtx_ = ctx;
+    error_      = nullptr;
+    remaining_  = static_cast<int>(ph.nodes.size());
+    pendingIndeg_.resize(ph.nodes.size());
+    ready_.clear();
+    for (std::size_t i = 0; i < ph.nodes.size(); ++i) {
+        pendingIndeg_[i] = ph.nodes[i].indeg;
+        if (pendingIndeg_[i] == 0) ready_.push_back(static_cast<int>(i));
+    }
+    workCv_.notify_all();
+
+    // The caller works too, then parks until the last node finishes.
+    while (remaining_ > 0) {
+        if (!runOneReady_(lk)) {
+            doneCv_.wait(lk, [&]() { return remaining_ == 0 || !ready_.empty(); });
+        }
+    }
+    current_ = nullptr;
 
-    cv_.notify_all();
+    if (error_) {
+        std::exception_ptr err = error_;
+        error_ = nullptr;
+        lk.unlock();
+        std::rethrow_exception(err);
+    }
+}
 
-    while (doneCount_.load() < subsystems_.size()) {
-        std::this_thread::yield();
+void TickPhaseEngine::runTick(const TickContext& ctx) {
+    for (int p = 0; p < kNumPhases; ++p) {
+        runPhase(static_cast<TickPhase>(p), ctx);
     }
 }
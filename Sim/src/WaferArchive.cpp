@@ -0,0 +1,214 @@
+// Sim/src/WaferArchive.cpp
+#include "WaferArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char          kMagic[8]  = {'S', 'F', 'W', 'A', 'F', 'E', 'R', '\0'};
+constexpr std::uint32_t kRecordTag = 0x43455257u; // "WREC" little-endian
+
+constexpr std::uint8_t kEncRaw     = 0;
+constexpr std::uint8_t kEncUniform = 1;
+
+template <typename T>
+void write_pod(std::FILE* fp, const T& v) {
+    std::fwrite(&v, sizeof(T), 1, fp);
+}
+
+template <typename T>
+bool read_pod(std::FILE* fp, T& v) {
+    return std::fread(&v, sizeof(T), 1, fp) == 1;
+}
+
+} // anonymous namespace
+
+// ---------------- WaferArchiveWriter ----------------
+
+WaferArchiveWriter::~WaferArchiveWriter() {
+    close();
+}
+
+void WaferArchiveWriter::open(const std::string& path, int gridN,
+                              const std::vector<std::uint32_t>& cells) {
+    close();
+
+    fp_ = std::fopen(path.c_str(), "wb");
+    if (!fp_) {
+        throw std::runtime_error("WaferArchiveWriter: failed to open " + path);
+    }
+    ncells_ = cells.size();
+
+    std::fwrite(kMagic, 1, sizeof(kMagic), fp_);
+    write_pod(fp_, kWaferArchiveVersion);
+    write_pod(fp_, static_cast<std::int32_t>(gridN));
+    write_pod(fp_, static_cast<std::uint32_t>(ncells_));
+    if (ncells_) std::fwrite(cells.data(), sizeof(std::uint32_t), ncells_, fp_);
+    std::fflush(fp_);
+}
+
+void WaferArchiveWriter::openAppend(const std::string& path, std::size_t ncells) {
+    close();
+
+    fp_ = std::fopen(path.c_str(), "ab");
+    if (!fp_) {
+        throw std::runtime_error("WaferArchiveWriter: failed to open " + path);
+    }
+    std::fseek(fp_, 0, SEEK_END);
+    ncells_ = ncells;
+}
+
+std::uint64_t WaferArchiveWriter::bytes() const {
+    if (!fp_) return 0;
+    const long pos = std::ftell(fp_);
+    return pos < 0 ? 0 : static_cast<std::uint64_t>(pos);
+}
+
+void WaferArchiveWriter::append(int job_index, WaferJobStatus status, double t_end_s,
+                                double uniform_dose, const double* dose) {
+    if (!fp_) return;
+
+    write_pod(fp_, kRecordTag);
+    write_pod(fp_, static_cast<std::int32_t>(job_index));
+    write_pod(fp_, static_cast<std::uint8_t>(status));
+    write_pod(fp_, dose ? kEncRaw : kEncUniform);
+    write_pod(fp_, t_end_s);
+    if (dose) {
+        std::fwrite(dose, sizeof(double), ncells_, fp_);
+    } else {
+        write_pod(fp_, uniform_dose);
+    }
+    std::fflush(fp_);
+}
+
+void WaferArchiveWriter::close() {
+    if (!fp_) return;
+    std::fclose(fp_);
+    fp_ = nullptr;
+}
+
+// ---------------- WaferArchiveReader ----------------
+
+WaferArchiveReader::~WaferArchiveReader() {
+    if (fp_) std::fclose(fp_);
+}
+
+void WaferArchiveReader::open(const std::string& path) {
+    if (fp_) {
+        std::fclose(fp_);
+        fp_ = nullptr;
+    }
+    cells_.clear();
+    offsets_.clear();
+    jobs_.clear();
+
+    fp_ = std::fopen(path.c_str(), "rb");
+    if (!fp_) {
+        throw std::runtime_error("WaferArchiveReader: failed to open " + path);
+    }
+
+    char magic[8];
+    std::uint32_t version = 0, ncells = 0;
+    std::int32_t  gridN = 0;
+    if (std::fread(magic, 1, sizeof(magic), fp_) != sizeof(magic) ||
+        std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("WaferArchiveReader: bad magic in " + path);
+    }
+    if (!read_pod(fp_, version) || version != kWaferArchiveVersion) {
+        throw std::runtime_error("WaferArchiveReader: unsupported version in " + path);
+    }
+    if (!read_pod(fp_, gridN) || !read_pod(fp_, ncells) || gridN <= 0) {
+        throw std::runtime_error("WaferArchiveReader: truncated header in " + path);
+    }
+    gridN_ = gridN;
+    cells_.resize(ncells);
+    if (ncells && std::fread(cells_.data(), sizeof(std::uint32_t), ncells, fp_) != ncells) {
+        throw std::runtime_error("WaferArchiveReader: truncated header in " + path);
+    }
+
+    // Index records; stop at the first incomplete one.
+    for (;;) {
+        const long at = std::ftell(fp_);
+        std::uint32_t tag = 0;
+        std::int32_t  job = 0;
+        std::uint8_t  status = 0, enc = 0;
+        double        t_end = 0.0;
+        if (!read_pod(fp_, tag) || tag != kRecordTag ||
+            !read_pod(fp_, job) || !read_pod(fp_, status) ||
+            !read_pod(fp_, enc) || !read_pod(fp_, t_end)) {
+            break;
+        }
+        const long payload = static_cast<long>(sizeof(double)) *
+                             (enc == kEncRaw ? static_cast<long>(ncells) : 1L);
+        if (std::fseek(fp_, payload, SEEK_CUR) != 0) break;
+
+        // fseek past EOF succeeds; confirm the payload is really there.
+        const long end = std::ftell(fp_);
+        if (std::fseek(fp_, 0, SEEK_END) != 0) break;
+        const long size = std::ftell(fp_);
+        if (end > size) break;
+        std::fseek(fp_, end, SEEK_SET);
+
+        offsets_.push_back(at);
+        jobs_.push_back(job);
+    }
+}
+
+WaferRecord WaferArchiveReader::record(std::size_t i) {
+    if (!fp_ || i >= offsets_.size()) {
+        throw std::runtime_error("WaferArchiveReader: record index out of range");
+    }
+    std::fseek(fp_, offsets_[i], SEEK_SET);
+
+    std::uint32_t tag = 0;
+    std::int32_t  job = 0;
+    std::uint8_t  status = 0, enc = 0;
+    WaferRecord rec;
+    if (!read_pod(fp_, tag) || !read_pod(fp_, job) || !read_pod(fp_, status) ||
+        !read_pod(fp_, enc) || !read_pod(fp_, rec.t_end_s)) {
+        throw std::runtime_error("WaferArchiveReader: failed to read record");
+    }
+    rec.job_index = job;
+    rec.status    = static_cast<WaferJobStatus>(status);
+    rec.uniform   = (enc == kEncUniform);
+    rec.dose.resize(rec.uniform ? 1 : cells_.size());
+    if (std::fread(rec.dose.data(), sizeof(double), rec.dose.size(), fp_) != rec.dose.size()) {
+        throw std::runtime_error("WaferArchiveReader: failed to read record payload");
+    }
+    return rec;
+}
+
+std::size_t WaferArchiveReader::writeCsv(std::ostream& out) {
+    out << "job_index,wafer_index,row,col,t_end_s,dose_arb\n";
+
+    // Jobs in index order; a job written twice keeps its last record.
+    std::vector<std::size_t> order(offsets_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return jobs_[a] < jobs_[b]; });
+
+    std::size_t rows = 0;
+    for (std::size_t k = 0; k < order.size(); ++k) {
+        if (k + 1 < order.size() && jobs_[order[k + 1]] == jobs_[order[k]]) continue;
+
+        const WaferRecord rec = record(order[k]);
+        const int waferIndex = 0;
+        for (std::size_t c = 0; c < cells_.size(); ++c) {
+            const int r   = static_cast<int>(cells_[c]) / gridN_;
+            const int col = static_cast<int>(cells_[c]) % gridN_;
+            const double val = rec.uniform ? rec.dose[0] : rec.dose[c];
+            out << rec.job_index << ","
+                << waferIndex << ","
+                << r << ","
+                << col << ","
+                << rec.t_end_s << ","
+                << val << "\n";
+        }
+        rows += cells_.size();
+    }
+    return rows;
+}
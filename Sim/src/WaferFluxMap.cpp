@@ -0,0 +1,171 @@
+#include "WaferFluxMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+struct FaceElem {
+    std::size_t src;         // index into the input elements
+    double u[3], v[3];       // projected corners
+    double cu, cv;           // projected centroid
+    double area;
+};
+
+void cross(const double* a, const double* b, double* out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// Point in the projected triangle (either winding), edges inclusive.
+bool contains(const FaceElem& e, double pu, double pv) {
+    double s[3];
+    for (int i = 0; i < 3; ++i) {
+        const int j = (i + 1) % 3;
+        s[i] = (e.u[j] - e.u[i]) * (pv - e.v[i]) - (e.v[j] - e.v[i]) * (pu - e.u[i]);
+    }
+    return (s[0] >= 0.0 && s[1] >= 0.0 && s[2] >= 0.0) ||
+           (s[0] <= 0.0 && s[1] <= 0.0 && s[2] <= 0.0);
+}
+
+} // namespace
+
+bool WaferFluxMap::build(const std::vector<Element>& elements, const Geometry& geom, int rank) {
+    rows_ = 0;
+    row_ptr_.clear();
+    col_.clear();
+    w_.clear();
+    stats_ = Stats{};
+
+    const int N = geom.gridN;
+    if (N <= 0 || geom.cells.empty() || geom.normal_axis < 0 || geom.normal_axis > 2) return false;
+    const int ax = geom.normal_axis;
+    const int au = (ax + 1) % 3;
+    const int av = (ax + 2) % 3;
+    const double facing = geom.facing < 0 ? -1.0 : 1.0;
+
+    // Front face first; a mesh whose normals point the other way (or a
+    // single sheet) falls back to every element in the wafer plane.
+    std::vector<FaceElem> face;
+    for (int pass = 0; pass < 2 && face.empty(); ++pass) {
+        for (std::size_t i = 0; i < elements.size(); ++i) {
+            const double* p = elements[i].p;
+            const double e1[3] = {p[3] - p[0], p[4] - p[1], p[5] - p[2]};
+            const double e2[3] = {p[6] - p[0], p[7] - p[1], p[8] - p[2]};
+            double n[3];
+            cross(e1, e2, n);
+            const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (!(len > 0.0)) continue;
+            const double along = n[ax] / len;
+            if (pass == 0 ? facing * along <= 0.5 : std::fabs(along) <= 0.5) continue;
+
+            FaceElem f;
+            f.src = i;
+            for (int c = 0; c < 3; ++c) {
+                f.u[c] = p[3 * c + au];
+                f.v[c] = p[3 * c + av];
+            }
+            f.cu   = (f.u[0] + f.u[1] + f.u[2]) / 3.0;
+            f.cv   = (f.v[0] + f.v[1] + f.v[2]) / 3.0;
+            f.area = 0.5 * len;
+            face.push_back(f);
+        }
+        if (pass == 1 && !face.empty()) stats_.both_faces = true;
+    }
+    if (face.empty()) return false;
+
+    // Disc from the face vertices: bounding-box centre, farthest vertex.
+    double ulo = std::numeric_limits<double>::max(), uhi = -ulo;
+    double vlo = ulo, vhi = -ulo;
+    for (const FaceElem& f : face) {
+        for (int c = 0; c < 3; ++c) {
+            ulo = std::min(ulo, f.u[c]); uhi = std::max(uhi, f.u[c]);
+            vlo = std::min(vlo, f.v[c]); vhi = std::max(vhi, f.v[c]);
+        }
+    }
+    const double cu = 0.5 * (ulo + uhi);
+    const double cv = 0.5 * (vlo + vhi);
+    double R = 0.0;
+    for (const FaceElem& f : face) {
+        for (int c = 0; c < 3; ++c) {
+            R = std::max(R, std::hypot(f.u[c] - cu, f.v[c] - cv));
+        }
+    }
+    if (!(R > 0.0)) return false;
+    stats_.elements  = face.size();
+    stats_.center[0] = cu;
+    stats_.center[1] = cv;
+    stats_.radius    = R;
+
+    // Grid cell -> row (wafer cells only), then centroid binning with the
+    // DepositionMap convention.
+    std::vector<int> row_of(static_cast<std::size_t>(N) * N, -1);
+    for (std::size_t k = 0; k < geom.cells.size(); ++k) {
+        if (geom.cells[k] < row_of.size()) row_of[geom.cells[k]] = static_cast<int>(k);
+    }
+    const std::size_t nrows = geom.cells.size();
+    std::vector<std::vector<std::pair<std::size_t, double>>> rows(nrows);
+    for (std::size_t e = 0; e < face.size(); ++e) {
+        const double nu = (face[e].cu - cu) / R;
+        const double nv = (face[e].cv - cv) / R;
+        const int ix = std::clamp(static_cast<int>((nu * 0.5 + 0.5) * N), 0, N - 1);
+        const int iy = std::clamp(static_cast<int>((nv * 0.5 + 0.5) * N), 0, N - 1);
+        const int k = row_of[static_cast<std::size_t>(iy) * N + ix];
+        if (k >= 0) rows[static_cast<std::size_t>(k)].push_back({e, face[e].area});
+    }
+
+    for (std::size_t k = 0; k < nrows; ++k) {
+        if (!rows[k].empty()) {
+            ++stats_.by_centroid;
+            continue;
+        }
+        const int r = static_cast<int>(geom.cells[k]) / N;
+        const int c = static_cast<int>(geom.cells[k]) % N;
+        const double pu = cu + ((c + 0.5) / N * 2.0 - 1.0) * R;
+        const double pv = cv + ((r + 0.5) / N * 2.0 - 1.0) * R;
+
+        std::size_t best = face.size();
+        for (std::size_t e = 0; e < face.size(); ++e) {
+            if (contains(face[e], pu, pv)) { best = e; break; }
+        }
+        if (best < face.size()) {
+            ++stats_.by_contain;
+        } else {
+            double best_d = std::numeric_limits<double>::max();
+            for (std::size_t e = 0; e < face.size(); ++e) {
+                const double d = std::hypot(face[e].cu - pu, face[e].cv - pv);
+                if (d < best_d) { best_d = d; best = e; }
+            }
+            ++stats_.by_nearest;
+        }
+        rows[k].push_back({best, 1.0});
+    }
+
+    // Normalize each row over all elements, then keep this rank's entries.
+    rows_ = nrows;
+    row_ptr_.assign(nrows + 1, 0);
+    for (std::size_t k = 0; k < nrows; ++k) {
+        double sum = 0.0;
+        for (const auto& [e, w] : rows[k]) sum += w;
+        for (const auto& [e, w] : rows[k]) {
+            const Element& src = elements[face[e].src];
+            if (src.owner != rank) continue;
+            col_.push_back(static_cast<std::uint32_t>(src.local));
+            w_.push_back(w / sum);
+        }
+        row_ptr_[k + 1] = static_cast<std::uint32_t>(col_.size());
+    }
+    return true;
+}
+
+void WaferFluxMap::apply(const double* values, std::size_t stride, std::size_t n, double* out) const {
+    for (std::size_t k = 0; k < rows_; ++k) {
+        double s = 0.0;
+        for (std::uint32_t j = row_ptr_[k]; j < row_ptr_[k + 1]; ++j) {
+            if (col_[j] < n) s += w_[j] * values[static_cast<std::size_t>(col_[j]) * stride];
+        }
+        out[k] = s;
+    }
+}
@@ -2,18 +2,25 @@
 #include "SpartaBridge.hpp"
 #include "Logger.hpp"
 #include "SpartaDiag.hpp"
+#include "CsvTailReader.hpp"
+#include "Checkpoint.hpp"
+#include "Profiler.hpp"
+#include "FlightRecorder.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <stdexcept>
 #include <utility>
 #include <vector>
+#include <cstdio>
 #include <cmath>
 #include <sstream>
 #include <optional>
 #include <limits>
 #include <map>
 #include <mpi.h>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
@@ -53,121 +60,62 @@ struct ShieldDiag {
 };
 
 /*
-    Read the last data row from a simple CSV file containing shield collision data.
+    Latest data row of the shield collision CSV, read incrementally.
 
     Returns std::nullopt if:
     - the file does not exist
-    - the file is empty
+    - the file has no data rows yet
     - parsing fails badly enough that no useful row is available
 */
-std::optional<ShieldDiag> read_shield_collide_csv(const fs::path& p) {
-    std::ifstream in(p);
-    if (!in) return std::nullopt;
+std::optional<ShieldDiag> read_shield_collide_csv(CsvTailReader& tail) {
+    if (!tail.poll()) return std::nullopt;
+    const std::string& row = tail.lastRow();
 
-    std::string line;
-    std::string last;
-
-    // Skip header, keep the last non-empty data line.
-    if (!std::getline(in, line)) return std::nullopt;
-    while (std::getline(in, line)) {
-        if (!line.empty()) last = line;
-    }
-    if (last.empty()) return std::nullopt;
-
-    std::stringstream ss(last);
-    std::string token;
-
-    // step
-    if (!std::getline(ss, token, ',')) return std::nullopt;
-    // time
-    if (!std::getline(ss, token, ',')) return std::nullopt;
+    // step, time, then the counters
+    if (!CsvTailReader::hasField(row, 2)) return std::nullopt;
 
     ShieldDiag d;
-
-    if (!std::getline(ss, token, ',')) return std::nullopt;
-    try {
-        d.shield_hits = std::stod(token);
-    } catch (...) {
-        d.shield_hits = 0.0;
-    }
-
-    if (!std::getline(ss, token, ',')) {
-        d.reemit_total = 0.0;
-    } else {
-        try {
-            d.reemit_total = std::stod(token);
-        } catch (...) {
-            d.reemit_total = 0.0;
-        }
-    }
-
+    if (!CsvTailReader::fieldDouble(row, 2, d.shield_hits)) d.shield_hits = 0.0;
+    if (!CsvTailReader::fieldDouble(row, 3, d.reemit_total)) d.reemit_total = 0.0;
     return d;
 }
 
-/*
-    Per-process guard against duplicate tick logging.
-
-    If WakeChamber::tick() is called more than once for the same outer tick
-    on a given rank, the second call becomes a no-op for logging purposes.
-*/
-int& last_logged_tick_ref() {
-    static int v = -1;
-    return v;
-}
-
-/*
-    Carry-forward storage for wake diagnostics.
-
-    If a given tick does not produce a valid temperature or density reading,
-    the most recent valid value is reused. This avoids contaminating logs
-    with NaNs when the diagnostics file lags behind.
-*/
-double& last_tempK_ref() {
-    static double v = 0.0;
-    return v;
-}
-
-double& last_nrho_ref() {
-    static double v = 0.0;
-    return v;
-}
-
-/*
-    Baseline free-stream density used to form a density ratio.
-
-    The first valid density observed becomes the reference density.
-*/
-double& n_inf_ref() {
-    static double v = 0.0;
-    return v;
-}
-
-/*
-    Remembered SPARTA block size.
-
-    The wake chamber advances in repeated blocks of SPARTA steps.
-    If the caller supplies a positive block size, it is remembered here.
-*/
-int& block_steps_ref() {
-    static int v = 1000;
-    return v;
-}
-
-/*
-    In-memory state for params.inc.
-
-    This lets setParameter() rewrite the whole params file every time while
-    keeping previously assigned variables intact.
-*/
-std::map<std::string, double>& param_state_ref() {
-    static std::map<std::string, double> m;
-    return m;
-}
-
 } // namespace
 
 WakeChamber::WakeChamber(MPI_Comm comm, std::string label)
-    : comm_(comm), label_(std::move(label)) {}
+    : comm_(comm), label_(std::move(label)) {
+    tickLog_ = Logger::instance().registerSchema(
+        "WakeChamber",
+        {
+            "status",
+            "ran_steps",
+            "cum_steps",
+            "reload",
+            "mark_reload",
+            "temp_K",
+            "density_m3",
+            "n_ratio",
+            "pressure_Pa",
+            "shield_hits",
+            "shield_reemit"
+        }
+    );
+    eventLog_ = Logger::instance().registerSchema(
+        label_ + "Events",
+        {
+            "status",
+            "ran_steps",
+            "cum_steps",
+            "reload",
+            "mark_reload",
+            "hot_update",
+            "reload_count",
+            "reload_ms",
+            "restore_source",
+            "snapshot_written"
+        }
+    );
+}
 
 WakeChamber::~WakeChamber() = default;
 
@@ -192,21 +140,64 @@ void WakeChamber::init(const std::string& deck_basename,
     input_subdir_ = input_subdir;
 
     // SPARTA writes diagnostics relative to the input directory.
-    diag_path_ = fs::path(input_subdir_) / "data" / "tmp" / "wake_diag.csv";
+    diag_tail_.reset(fs::path(input_subdir_) / "data" / "tmp" / "wake_diag.csv");
+    shield_tail_.reset(fs::path(input_subdir_) / "data" / "tmp" / "shield_collide.csv");
+
+    sp_ = std::make_unique<SpartaBridge>(comm_, device_policy_);
 
-    sp_ = std::make_unique<SpartaBridge>(comm_);
-    sp_->runDeck(deck_, input_subdir_);
+    // Embedded: one device per rank. Shim: one pool for the external child.
+    if (sp_->inProcess()) {
+        device_map_ = describeSpartaDeviceMap(sp_->device(), comm_);
+    } else {
+        int rank = 0;
+        MPI_Comm_rank(comm_, &rank);
+        device_map_.clear();
+        if (rank == 0) {
+            const SpartaDeviceAssignment& d = sp_->device();
+            device_map_ = "external SPARTA -> " +
+                (d.device < 0 ? std::string("CPU")
+                              : "CUDA_VISIBLE_DEVICES=" + d.visible_devices) + "\n";
+        }
+    }
+    if (!device_map_.empty()) {
+        device_map_ = label_ + " devices (" + device_policy_.describe() + "):\n" + device_map_;
+    }
+
+    const bool warm_hit = warm_cache_ && !resume_deck_.empty() && warmLookup_();
+    double restore_source = 0.0;
+    double reload_ms = 0.0;
+    if (warm_hit) {
+        const double t0 = MPI_Wtime();
+        if (!sp_->acceptsCommands()) {
+            // The shim's child only starts with the first deck.
+            sp_->runDeck(deck_, input_subdir_);
+            sp_->command("clear");
+        }
+        sp_->command(("variable wake_snapshot string " + warm_cache_->entryPath(warm_key_)).c_str());
+        sp_->runDeck(resume_deck_, input_subdir_);
+        reload_ms = (MPI_Wtime() - t0) * 1.0e3;
+        restore_source = 4.0;
+    } else {
+        sp_->runDeck(deck_, input_subdir_);
+    }
 
     initialized_ = true;
     dirtyReload_ = false;
     cum_steps_ = 0;
     last_run_steps_ = 0;
+    reload_count_ = 0;
+    snapshot_ready_ = false;
+    warm_started_ = warm_hit;
+    warm_pending_ = warm_cache_ && !warm_hit && !resume_deck_.empty() && sp_->acceptsCommands();
 
     logEvent_(/*status*/1.0,
               /*ran_steps*/0.0,
               /*cum_steps*/0.0,
               /*reload*/0.0,
-              /*mark_reload*/0.0);
+              /*mark_reload*/0.0,
+              /*hot_update*/0.0,
+              reload_ms,
+              restore_source);
 }
 
 /*
@@ -224,13 +215,12 @@ void WakeChamber::step(int nDefault) {
         throw std::runtime_error("WakeChamber::init() not called");
     }
 
-    int& bs = block_steps_ref();
     if (nDefault > 0) {
-        bs = nDefault;
+        block_steps_ = nDefault;
     }
 
-    if (bs > 0) {
-        runSteps(bs);
+    if (block_steps_ > 0) {
+        runSteps(block_steps_);
     }
 }
 
@@ -251,8 +241,26 @@ void WakeChamber::runSteps(int n) {
         return;
     }
 
-    sp_->command(("run " + std::to_string(n)).c_str());
+    SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::runSteps");
+    FlightScope flight("WakeChamber::runSteps");
+    const double t0 = MPI_Wtime();
+    char cmd[32];
+    std::snprintf(cmd, sizeof(cmd), "run %d", n);
+    sp_->command(cmd);
+    const double ran_s = MPI_Wtime() - t0;
     cum_steps_ += n;
+
+    maybeWriteSnapshot_();
+    maybeStoreWarmStart_();
+    sampleProbes_();
+    sampleWaferFlux_();
+
+    {
+        std::lock_guard<std::mutex> lk(sample_mtx_);
+        timed_block_s_ += ran_s;
+        timed_steps_ += n;
+    }
+    // Published last, so tick() sees this block's sample with its step count.
     last_run_steps_ = n;
 }
 
@@ -272,6 +280,304 @@ void WakeChamber::markDirtyReload() {
               /*mark_reload*/1.0);
 }
 
+/*
+    Declare the hot-updatable deck variables.
+*/
+void WakeChamber::setHotParameters(std::vector<std::string> names,
+                                   std::string update_include) {
+    hot_names_ = std::move(names);
+    hot_include_ = std::move(update_include);
+    hot_pending_.assign(hot_names_.size(), std::numeric_limits<double>::quiet_NaN());
+}
+
+/*
+    Queue hot values, or fall back to a full reload.
+
+    The reload decision stays local here; runIfDirtyOrAdvanceCollective()
+    reduces it across ranks like any other markDirtyReload().
+*/
+void WakeChamber::updateParameters(const std::vector<std::pair<std::string, double>>& values) {
+    const bool hot_ok = sp_ && sp_->acceptsCommands();
+
+    if (cache_) {
+        const std::vector<std::string>& names = cache_->keyNames();
+        for (const auto& kv : values) {
+            for (std::size_t k = 0; k < names.size(); ++k) {
+                if (names[k] == kv.first && !(cache_key_[k] == kv.second)) {
+                    cache_key_[k] = kv.second;
+                    cache_key_changed_ = true;
+                }
+            }
+        }
+    }
+
+    bool need_reload = false;
+    for (const auto& kv : values) {
+        std::size_t k = 0;
+        while (k < hot_names_.size() && hot_names_[k] != kv.first) ++k;
+        if (!hot_ok || k == hot_names_.size() || !std::isfinite(kv.second)) {
+            need_reload = true;
+            break;
+        }
+        hot_pending_[k] = kv.second;
+    }
+
+    if (need_reload) {
+        // params.inc already holds every value; the reload picks them all up.
+        std::fill(hot_pending_.begin(), hot_pending_.end(),
+                  std::numeric_limits<double>::quiet_NaN());
+        markDirtyReload();
+    }
+}
+
+/*
+    Push queued hot values into the live instance.
+
+    All ranks must send identical commands, so rank 0's queue is broadcast
+    and used everywhere.
+*/
+void WakeChamber::applyHotUpdates_(std::vector<double>& hot) {
+    hot.resize(hot_names_.size(), std::numeric_limits<double>::quiet_NaN());
+    if (!hot.empty()) {
+        {
+            SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Bcast(wake.hot)");
+            FlightScope flight("MPI_Bcast(wake.hot)");
+            MPI_Bcast(hot.data(), static_cast<int>(hot.size()), MPI_DOUBLE, 0, comm_);
+        }
+    }
+    sendHotUpdates_(hot);
+}
+
+void WakeChamber::sendHotUpdates_(const std::vector<double>& hot) {
+    SF_PROFILE_SCOPE(ProfileCat::Params, "WakeChamber::hotUpdate");
+    bool any = false;
+    for (std::size_t k = 0; k < hot_names_.size() && k < hot.size(); ++k) {
+        if (!std::isfinite(hot[k])) continue;
+        std::ostringstream cmd;
+        cmd.precision(17);
+        cmd << "variable " << hot_names_[k] << " equal " << hot[k];
+        sp_->command(cmd.str().c_str());
+        any = true;
+    }
+    if (any && !hot_include_.empty()) {
+        // Deck-relative like params.inc: runDeck() left SPARTA in the input directory.
+        sp_->command(("include " + hot_include_).c_str());
+    }
+
+    if (any) {
+        abandonWarmStart_();
+        logEvent_(/*status*/1.0,
+                  /*ran_steps*/0.0,
+                  /*cum_steps*/static_cast<double>(cum_steps_),
+                  /*reload*/0.0,
+                  /*mark_reload*/0.0,
+                  /*hot_update*/1.0);
+    }
+}
+
+/*
+    Enable restart-snapshot reloads; the snapshot itself is written by the
+    first runSteps() after init().
+*/
+void WakeChamber::enableRestartSnapshot(std::string resume_deck,
+                                        std::string snapshot_path) {
+    resume_deck_ = std::move(resume_deck);
+    snapshot_path_ = std::move(snapshot_path);
+    snapshot_ready_ = false;
+}
+
+/*
+    Write the in-run restart snapshot.
+
+    Issued on every rank (write_restart is collective inside SPARTA). All
+    ranks agree on snapshot_ready_ because they run the same step sequence.
+*/
+void WakeChamber::maybeWriteSnapshot_() {
+    if (snapshot_ready_ || resume_deck_.empty() || !sp_ || !sp_->acceptsCommands()) {
+        return;
+    }
+
+    // The embedded runDeck() moved this process into the input directory, so
+    // the relative snapshot path resolves the same here and inside SPARTA.
+    // The external child runs there instead; resolve against input_subdir_.
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    if (rank == 0) {
+        fs::path dir = fs::path(snapshot_path_).parent_path();
+        if (!sp_->inProcess() && dir.is_relative()) dir = fs::path(input_subdir_) / dir;
+        std::error_code ec;
+        if (!dir.empty()) fs::create_directories(dir, ec);
+    }
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Barrier(wake.snapshot)");
+        FlightScope flight("MPI_Barrier(wake.snapshot)");
+        MPI_Barrier(comm_);
+    }
+
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::writeSnapshot");
+        sp_->command(("write_restart " + snapshot_path_).c_str());
+    }
+    snapshot_ready_ = true;
+
+    logEvent_(/*status*/1.0,
+              /*ran_steps*/0.0,
+              /*cum_steps*/static_cast<double>(cum_steps_),
+              /*reload*/0.0,
+              /*mark_reload*/0.0,
+              /*hot_update*/0.0,
+              /*reload_ms*/0.0,
+              /*restore_source*/0.0,
+              /*snapshot_written*/1.0);
+}
+
+/*
+    Enable the warm-start cache; init() does the lookup.
+*/
+void WakeChamber::enableWarmStart(WarmStart ws) {
+    warm_cache_ = std::make_unique<WarmStartCache>(std::move(ws.dir));
+    warm_steps_ = std::max(1L, ws.steps);
+    warm_started_ = false;
+    warm_pending_ = false;
+}
+
+bool WakeChamber::warmLookup_() {
+    int rank = 0, size = 1;
+    MPI_Comm_rank(comm_, &rank);
+    MPI_Comm_size(comm_, &size);
+
+    // {key, hit, token}
+    std::uint64_t msg[3] = {0, 0, 0};
+    if (rank == 0) {
+        fs::path input(input_subdir_);
+        if (!input.is_absolute()) input = fs::path(PROJECT_SOURCE_DIR) / input;
+
+        std::vector<std::string> files = WarmStartCache::deckFiles(input.string(), deck_);
+        for (const std::string& f : WarmStartCache::deckFiles(input.string(), resume_deck_)) {
+            if (std::find(files.begin(), files.end(), f) == files.end()) files.push_back(f);
+        }
+        const std::string tag = sp_->versionTag();
+        warm_key_ = WarmStartCache::makeKey(input.string(), files, tag, size, warm_steps_);
+        warm_cache_->scan();
+        const bool hit = warm_cache_->lookup(warm_key_);
+
+        std::ostringstream desc;
+        desc << "deck " << deck_ << "\nresume " << resume_deck_ << "\nsparta " << tag
+             << "\nranks " << size << "\nsteps " << warm_steps_ << "\nfiles";
+        for (const std::string& f : files) desc << ' ' << f;
+        desc << '\n';
+        warm_desc_ = desc.str();
+
+        const WarmStartCache::Stats& st = warm_cache_->stats();
+        std::ostringstream sum;
+        sum << warm_cache_->dir() << ": key " << WarmStartCache::keyHex(warm_key_) << " ("
+            << files.size() << " deck files, " << warm_steps_ << " steps), "
+            << (hit ? "hit" : "miss") << "; " << st.entries << " entries, "
+            << st.bytes / (1024 * 1024) << " MiB";
+        warm_summary_ = sum.str();
+
+        msg[0] = warm_key_;
+        msg[1] = hit ? 1 : 0;
+        msg[2] = static_cast<std::uint64_t>(::getpid());
+    }
+    {
+        FlightScope flight("MPI_Bcast(wake.warm)");
+        MPI_Bcast(msg, 3, MPI_UINT64_T, 0, comm_);
+    }
+    warm_key_   = msg[0];
+    warm_token_ = static_cast<long>(msg[2]);
+    return msg[1] != 0;
+}
+
+/*
+    Store the warm-start entry.
+
+    Issued on every rank, like the snapshot; the restart file is written
+    under a temporary name and rank 0 moves it into place.
+*/
+void WakeChamber::maybeStoreWarmStart_() {
+    if (!warm_pending_ || cum_steps_ < warm_steps_) return;
+    warm_pending_ = false;
+
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    if (rank == 0) {
+        std::error_code ec;
+        fs::create_directories(warm_cache_->dir(), ec);
+    }
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Barrier(wake.warm)");
+        FlightScope flight("MPI_Barrier(wake.warm)");
+        MPI_Barrier(comm_);
+    }
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::storeWarmStart");
+        sp_->command(("write_restart " + warm_cache_->tempPath(warm_key_, warm_token_)).c_str());
+    }
+    if (rank != 0) return;
+
+    const bool stored = warm_cache_->commit(
+        warm_key_, warm_token_, warm_desc_ + "stored_at_steps " + std::to_string(cum_steps_) + "\n");
+    logEvent_(/*status*/stored ? 1.0 : 0.0,
+              /*ran_steps*/0.0,
+              /*cum_steps*/static_cast<double>(cum_steps_),
+              /*reload*/0.0,
+              /*mark_reload*/0.0,
+              /*hot_update*/0.0,
+              /*reload_ms*/0.0,
+              /*restore_source*/0.0,
+              /*snapshot_written*/2.0);
+}
+
+void WakeChamber::abandonWarmStart_() {
+    if (!warm_pending_) return;
+    warm_pending_ = false;
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    if (rank == 0) warm_cache_->abandon();
+}
+
+/*
+    Full reload.
+
+    restore_source in the event row: 1 = original deck, 2 = restart snapshot,
+    3 = harness checkpoint (resumeFromCheckpoint()), 4 = warm-start cache
+    (init()). snapshot_written: 1 = in-run snapshot, 2 = warm-start entry.
+*/
+void WakeChamber::reload_() {
+    SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::reload");
+    FlightScope flight("WakeChamber::reload");
+    const double t0 = MPI_Wtime();
+
+    abandonWarmStart_();
+
+    sp_->command("clear");
+
+    double restore_source = 1.0;
+    if (snapshot_ready_) {
+        // SPARTA's cwd is the input directory (runDeck), like snapshot_path_.
+        sp_->command(("variable wake_snapshot string " + snapshot_path_).c_str());
+        sp_->runDeck(resume_deck_, input_subdir_);
+        restore_source = 2.0;
+    } else {
+        sp_->runDeck(deck_, input_subdir_);
+    }
+
+    const double reload_ms = (MPI_Wtime() - t0) * 1.0e3;
+    ++reload_count_;
+
+    last_run_steps_ = 0;
+
+    logEvent_(/*status*/1.0,
+              /*ran_steps*/0.0,
+              /*cum_steps*/static_cast<double>(cum_steps_),
+              /*reload*/1.0,
+              /*mark_reload*/0.0,
+              /*hot_update*/0.0,
+              reload_ms,
+              restore_source);
+}
+
 /*
     Original local reload-or-advance method.
 
@@ -284,18 +590,15 @@ bool WakeChamber::runIfDirtyOrAdvance(int n) {
         throw std::runtime_error("WakeChamber::init() not called");
     }
 
-    if (dirtyReload_) {
-        sp_->command("clear");
-        sp_->runDeck(deck_, input_subdir_);
-
-        dirtyReload_ = false;
-        last_run_steps_ = 0;
+    bool dirty = false;
+    std::vector<double> hot;
+    takePending_(dirty, hot);
+    // Single-rank path: queued hot values are in params.inc too, so a
+    // reload covers them without a broadcast.
+    for (double v : hot) dirty = dirty || std::isfinite(v);
 
-        logEvent_(/*status*/1.0,
-                  /*ran_steps*/0.0,
-                  /*cum_steps*/static_cast<double>(cum_steps_),
-                  /*reload*/1.0,
-                  /*mark_reload*/0.0);
+    if (dirty) {
+        reload_();
 
         if (n > 0) runSteps(n);
         return true;
@@ -328,10 +631,29 @@ bool WakeChamber::runIfDirtyOrAdvanceCollective(int n) {
         throw std::runtime_error("WakeChamber::runIfDirtyOrAdvanceCollective() not called after init()");
     }
 
-    int local_dirty = dirtyReload_ ? 1 : 0;
-    int global_dirty = 0;
+    bool dirty = false;
+    std::vector<double> hot;
+    takePending_(dirty, hot);
+    return advanceCollective_(n, dirty, hot);
+}
 
-    MPI_Allreduce(&local_dirty, &global_dirty, 1, MPI_INT, MPI_MAX, comm_);
+/*
+    Shared core of the collective advance, also run by the pipeline worker.
+*/
+bool WakeChamber::advanceCollective_(int n, bool dirty, std::vector<double>& hot) {
+    bool local_hot = false;
+    for (double v : hot) local_hot = local_hot || std::isfinite(v);
+
+    // One reduction decides both: [0] full reload, [1] hot update.
+    int local_flags[2] = {dirty ? 1 : 0, local_hot ? 1 : 0};
+    int global_flags[2] = {0, 0};
+
+    {
+        SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Allreduce(wake.advance)");
+        FlightScope flight("MPI_Allreduce(wake.advance)");
+        MPI_Allreduce(local_flags, global_flags, 2, MPI_INT, MPI_MAX, comm_);
+    }
+    const int global_dirty = global_flags[0];
 
     if (global_dirty) {
         /*
@@ -340,19 +662,14 @@ bool WakeChamber::runIfDirtyOrAdvanceCollective(int n) {
             This gives rank 0 time to finish rewriting params.inc and ensures
             all ranks arrive at the same phase before issuing SPARTA commands.
         */
-        MPI_Barrier(comm_);
-
-        sp_->command("clear");
-        sp_->runDeck(deck_, input_subdir_);
-
-        dirtyReload_ = false;
-        last_run_steps_ = 0;
+        {
+            SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Barrier(wake.reload)");
+            FlightScope flight("MPI_Barrier(wake.reload)");
+            MPI_Barrier(comm_);
+        }
 
-        logEvent_(/*status*/1.0,
-                  /*ran_steps*/0.0,
-                  /*cum_steps*/static_cast<double>(cum_steps_),
-                  /*reload*/1.0,
-                  /*mark_reload*/0.0);
+        // The reloaded state reads every value from params.inc.
+        reload_();
 
         if (n > 0) {
             runSteps(n);
@@ -361,6 +678,10 @@ bool WakeChamber::runIfDirtyOrAdvanceCollective(int n) {
         return false;
     }
 
+    if (global_flags[1]) {
+        applyHotUpdates_(hot);
+    }
+
     if (n > 0) {
         runSteps(n);
         return true;
@@ -369,10 +690,577 @@ bool WakeChamber::runIfDirtyOrAdvanceCollective(int n) {
     return false;
 }
 
+/*
+    Advance on a decision all ranks already share (TickControl).
+
+    The local queue is dropped: the caller took rank 0's pending state before
+    publishing it, and followers have nothing queued of their own.
+*/
+bool WakeChamber::runDecided(int n, bool reload, const std::vector<double>& hot) {
+    if (!initialized_) {
+        throw std::runtime_error("WakeChamber::runDecided() not called after init()");
+    }
+
+    bool dirty = false;
+    takePending_(dirty, hot_scratch_);
+
+    if (reload) {
+        // params.inc was complete before rank 0 published the decision.
+        reload_();
+    } else {
+        sendHotUpdates_(hot);
+    }
+
+    if (n > 0) {
+        runSteps(n);
+        return true;
+    }
+    return false;
+}
+
+/*
+    Hand this rank's pending state to one advance and reset it.
+*/
+void WakeChamber::takePending_(bool& dirty, std::vector<double>& hot) {
+    dirty = dirtyReload_;
+    dirtyReload_ = false;
+    hot = hot_pending_;
+    std::fill(hot_pending_.begin(), hot_pending_.end(),
+              std::numeric_limits<double>::quiet_NaN());
+}
+
+bool WakeChamber::paramsPending() const {
+    if (dirtyReload_) return true;
+    for (double v : hot_pending_) {
+        if (std::isfinite(v)) return true;
+    }
+    return false;
+}
+
+/*
+    Sample the probe variables after a block.
+
+    Runs on every rank in the same order as the SPARTA commands, so
+    variables that reduce across ranks inside SPARTA stay collective even
+    though tick() itself only runs on the leader.
+*/
+void WakeChamber::sampleProbes_() {
+    if (!sp_ || !sp_->inProcess()) return;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ProbeSample s;
+    s.valid         = true;
+    s.temp_K        = sp_->extractVariable(probes_.temp_K).value_or(nan);
+    s.density_m3    = sp_->extractVariable(probes_.density_m3).value_or(nan);
+    s.shield_hits   = sp_->extractVariable(probes_.shield_hits).value_or(0.0);
+    s.shield_reemit = sp_->extractVariable(probes_.shield_reemit).value_or(0.0);
+
+    std::lock_guard<std::mutex> lk(sample_mtx_);
+    sample_ = s;
+}
+
+// ---------------- wafer flux coupling ----------------
+
+bool WakeChamber::enableWaferFlux(WaferFlux cfg) {
+    if (!initialized_) {
+        throw std::runtime_error("WakeChamber::enableWaferFlux() called before init()");
+    }
+    if (pipelined()) {
+        throw std::runtime_error("WakeChamber::enableWaferFlux() must precede startPipeline()");
+    }
+    wafer_flux_on_ = false;
+    wafer_flux_summary_.clear();
+
+    int rank = 0, nranks = 1;
+    MPI_Comm_rank(comm_, &rank);
+    MPI_Comm_size(comm_, &nranks);
+
+    if (!sp_->inProcess()) {
+        if (rank == 0) wafer_flux_summary_ = "off: SPARTA runs as an external process";
+        return false;
+    }
+
+    // Gather every rank's wafer triangles: the map normalizes each cell
+    // over all elements, including ones owned elsewhere.
+    std::vector<int> local;
+    std::vector<double> corners;
+    sp_->surfGroupTriangles(cfg.group, local, corners);
+
+    std::vector<double> mine;
+    mine.reserve(local.size() * 10);
+    for (std::size_t i = 0; i < local.size(); ++i) {
+        mine.push_back(static_cast<double>(local[i]));
+        mine.insert(mine.end(), corners.begin() + 9 * i, corners.begin() + 9 * i + 9);
+    }
+    int count = static_cast<int>(mine.size());
+    std::vector<int> counts(nranks), displs(nranks, 0);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm_);
+    for (int r = 1; r < nranks; ++r) displs[r] = displs[r - 1] + counts[r - 1];
+    std::vector<double> all(static_cast<std::size_t>(displs[nranks - 1] + counts[nranks - 1]));
+    MPI_Allgatherv(mine.data(), count, MPI_DOUBLE, all.data(), counts.data(), displs.data(),
+                   MPI_DOUBLE, comm_);
+
+    std::vector<WaferFluxMap::Element> elements;
+    elements.reserve(all.size() / 10);
+    for (int r = 0; r < nranks; ++r) {
+        for (int off = displs[r]; off + 10 <= displs[r] + counts[r]; off += 10) {
+            WaferFluxMap::Element e;
+            e.owner = r;
+            e.local = static_cast<int>(all[static_cast<std::size_t>(off)]);
+            std::copy(all.begin() + off + 1, all.begin() + off + 10, e.p);
+            elements.push_back(e);
+        }
+    }
+
+    // Same fix and per-surf layout on every rank (same deck).
+    const bool have_fix = sp_->extractSurfFix(cfg.fix, cfg.column).has_value();
+
+    if (elements.empty() || !have_fix ||
+        !wafer_flux_map_.build(elements, cfg.grid, rank)) {
+        if (rank == 0) {
+            wafer_flux_summary_ = elements.empty()
+                ? "off: surface group " + cfg.group + " has no triangles"
+                : (!have_fix ? "off: no per-surf fix " + cfg.fix
+                             : "off: no " + cfg.group + " triangle lies in the wafer plane");
+        }
+        return false;
+    }
+
+    const std::size_t n = wafer_flux_map_.cells();
+    wafer_flux_partial_.assign(n, 0.0);
+    wafer_flux_sum_.assign(rank == 0 ? n : 0, 0.0);
+    {
+        std::lock_guard<std::mutex> lk(sample_mtx_);
+        wafer_flux_sample_.assign(rank == 0 ? n : 0, 0.0);
+        wafer_flux_seq_ = 0;
+        wafer_flux_taken_ = 0;
+    }
+    wafer_flux_cfg_ = std::move(cfg);
+    wafer_flux_on_ = true;
+
+    if (rank == 0) {
+        const WaferFluxMap::Stats& st = wafer_flux_map_.stats();
+        std::ostringstream oss;
+        oss << wafer_flux_cfg_.fix << " on " << wafer_flux_cfg_.group << ": "
+            << st.elements << " of " << elements.size() << " triangles"
+            << (st.both_faces ? " (no element faces the beam; both faces used)" : " facing the beam")
+            << ", disc r=" << st.radius << " m -> " << n << " cells ("
+            << st.by_centroid << " by centroid, " << st.by_contain << " inside one element, "
+            << st.by_nearest << " nearest)";
+        wafer_flux_summary_ = oss.str();
+    }
+    return true;
+}
+
+void WakeChamber::sampleWaferFlux_() {
+    if (!wafer_flux_on_) return;
+
+    // A missing fix (deck reloaded without it) contributes zeros, so the
+    // reduction below stays collective.
+    const std::optional<SpartaBridge::SurfValues> v =
+        sp_->extractSurfFix(wafer_flux_cfg_.fix, wafer_flux_cfg_.column);
+    if (v && v->data) {
+        wafer_flux_map_.apply(v->data, v->stride, v->n, wafer_flux_partial_.data());
+    } else {
+        std::fill(wafer_flux_partial_.begin(), wafer_flux_partial_.end(), 0.0);
+    }
+
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    MPI_Reduce(wafer_flux_partial_.data(), rank == 0 ? wafer_flux_sum_.data() : nullptr,
+               static_cast<int>(wafer_flux_partial_.size()), MPI_DOUBLE, MPI_SUM, 0, comm_);
+    if (rank != 0) return;
+
+    std::lock_guard<std::mutex> lk(sample_mtx_);
+    std::copy(wafer_flux_sum_.begin(), wafer_flux_sum_.end(), wafer_flux_sample_.begin());
+    ++wafer_flux_seq_;
+}
+
+bool WakeChamber::takeWaferFlux(std::vector<double>& out) {
+    std::lock_guard<std::mutex> lk(sample_mtx_);
+    if (!wafer_flux_on_ || wafer_flux_seq_ == wafer_flux_taken_ || wafer_flux_sample_.empty()) {
+        return false;
+    }
+    out.resize(wafer_flux_sample_.size());
+    std::copy(wafer_flux_sample_.begin(), wafer_flux_sample_.end(), out.begin());
+    wafer_flux_taken_ = wafer_flux_seq_;
+    return true;
+}
+
+// ---------------- pipelined coupling ----------------
+
+void WakeChamber::startPipeline(int lag_blocks) {
+    if (!initialized_) {
+        throw std::runtime_error("WakeChamber::startPipeline() called before init()");
+    }
+    if (pipelined()) return;
+
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_MULTIPLE) {
+        throw std::runtime_error("WakeChamber::startPipeline: MPI_THREAD_MULTIPLE not available");
+    }
+    int cmp = MPI_UNEQUAL;
+    MPI_Comm_compare(comm_, MPI_COMM_WORLD, &cmp);
+    if (cmp == MPI_IDENT) {
+        throw std::runtime_error("WakeChamber::startPipeline: needs a dedicated communicator (MPI_Comm_dup)");
+    }
+
+    pipeLog_ = Logger::instance().registerSchema(
+        label_ + "Pipeline",
+        {
+            "lag_blocks",
+            "inflight",
+            "reconcile",
+            "leader_wait_ms",
+            "sparta_s_total",
+            "leader_wait_s_total",
+            "overlap_frac"
+        }
+    );
+
+    pipe_lag_ = lag_blocks < 1 ? 1 : lag_blocks;
+    pipe_stop_ = false;
+    pipe_inflight_ = 0;
+    pipe_error_ = nullptr;
+    pipe_stats_ = PipelineStats{};
+    worker_ = std::thread(&WakeChamber::pipelineWorker_, this);
+}
+
+void WakeChamber::advancePipelined(int n, bool reconcile) {
+    if (!pipelined()) {
+        runIfDirtyOrAdvanceCollective(n);
+        return;
+    }
+
+    PipelineJob job;
+    job.n = n;
+    job.reconcile = reconcile;
+    if (reconcile) takePending_(job.dirty, job.hot);
+
+    const double t0 = MPI_Wtime();
+    std::unique_lock<std::mutex> lk(pipe_mtx_);
+    if (pipe_error_) std::rethrow_exception(pipe_error_);
+
+    pipe_queue_.push_back(std::move(job));
+    ++pipe_inflight_;
+    pipe_cv_.notify_all();
+
+    // Explicit lag: keep at most pipe_lag_ blocks ahead of the diagnostics.
+    {
+        FlightScope flight("wake.pipeline_wait");
+        pipe_cv_.wait(lk, [&] { return pipe_inflight_ <= pipe_lag_ || pipe_error_; });
+    }
+    if (pipe_error_) std::rethrow_exception(pipe_error_);
+
+    const double waited = MPI_Wtime() - t0;
+    pipe_stats_.leader_wait_s += waited;
+    ++pipe_stats_.blocks;
+    const PipelineStats st = pipe_stats_;
+    const int inflight = pipe_inflight_;
+    lk.unlock();
+
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    if (rank == 0) {
+        pipeLog_.write(
+            static_cast<int>(st.blocks),
+            0.0,
+            {
+                static_cast<double>(pipe_lag_),
+                static_cast<double>(inflight),
+                reconcile ? 1.0 : 0.0,
+                waited * 1.0e3,
+                st.sparta_s,
+                st.leader_wait_s,
+                st.overlap()
+            }
+        );
+    }
+}
+
+void WakeChamber::pipelineWorker_() {
+    for (;;) {
+        PipelineJob job;
+        {
+            std::unique_lock<std::mutex> lk(pipe_mtx_);
+            pipe_cv_.wait(lk, [&] { return pipe_stop_ || !pipe_queue_.empty(); });
+            if (pipe_queue_.empty()) return;  // stop requested and drained
+            job = std::move(pipe_queue_.front());
+            pipe_queue_.pop_front();
+        }
+
+        const double t0 = MPI_Wtime();
+        std::exception_ptr err;
+        try {
+            if (job.reconcile) {
+                advanceCollective_(job.n, job.dirty, job.hot);
+            } else {
+                runSteps(job.n);
+            }
+        } catch (...) {
+            err = std::current_exception();
+        }
+        const double busy = MPI_Wtime() - t0;
+
+        std::lock_guard<std::mutex> lk(pipe_mtx_);
+        pipe_stats_.sparta_s += busy;
+        --pipe_inflight_;
+        if (err && !pipe_error_) pipe_error_ = err;
+        pipe_cv_.notify_all();
+        if (pipe_error_) return;
+    }
+}
+
+void WakeChamber::stopPipeline() {
+    if (!pipelined()) return;
+    {
+        std::lock_guard<std::mutex> lk(pipe_mtx_);
+        pipe_stop_ = true;
+    }
+    pipe_cv_.notify_all();
+    worker_.join();
+
+    if (pipe_error_) {
+        std::exception_ptr err = pipe_error_;
+        pipe_error_ = nullptr;
+        std::rethrow_exception(err);
+    }
+}
+
+WakeChamber::PipelineStats WakeChamber::pipelineStats() const {
+    std::lock_guard<std::mutex> lk(pipe_mtx_);
+    return pipe_stats_;
+}
+
+// ---------------- adaptive cadence ----------------
+
+void WakeChamber::enableAdaptiveCadence(AdaptiveCadence cfg) {
+    if (cfg.window < 2) cfg.window = 2;
+    if (cfg.max_stride < 1) cfg.max_stride = 1;
+    if (!(cfg.rel_tol >= 0.0)) cfg.rel_tol = 0.0;
+
+    adaptive_cfg_ = cfg;
+    adaptive_on_ = true;
+    adaptive_hist_.clear();
+    adaptive_stride_ = 1;
+    adaptive_since_ = 0;
+    adaptive_stats_ = AdaptiveStats{};
+
+    adaptiveLog_ = Logger::instance().registerSchema(
+        label_ + "Adaptive",
+        {
+            "steady",
+            "spread",
+            "stride",
+            "advance",
+            "advanced_blocks",
+            "skipped_blocks",
+            "skipped_steps",
+            "saved_s_est"
+        }
+    );
+}
+
+void WakeChamber::setSteadyCriterion(double rel_tol, int window) {
+    adaptive_cfg_.rel_tol = (rel_tol >= 0.0) ? rel_tol : 0.0;
+    adaptive_cfg_.window  = window < 2 ? 2 : window;
+    adaptive_hist_.clear();
+}
+
+double WakeChamber::adaptiveSpread_() const {
+    const std::size_t w = static_cast<std::size_t>(adaptive_cfg_.window);
+    if (adaptive_hist_.size() < w) return std::numeric_limits<double>::infinity();
+
+    double worst = 0.0;
+    const std::size_t nprobe = adaptive_hist_.front().size();
+    for (std::size_t k = 0; k < nprobe; ++k) {
+        double lo = adaptive_hist_.front()[k], hi = lo, sum = 0.0;
+        for (const auto& row : adaptive_hist_) {
+            lo = std::min(lo, row[k]);
+            hi = std::max(hi, row[k]);
+            sum += row[k];
+        }
+        const double mean = std::fabs(sum / static_cast<double>(adaptive_hist_.size()));
+        // A probe pinned at zero is steady; otherwise compare to its mean.
+        const double rel = (hi - lo) <= 0.0 ? 0.0
+                         : (mean > 0.0 ? (hi - lo) / mean
+                                       : std::numeric_limits<double>::infinity());
+        worst = std::max(worst, rel);
+    }
+    return worst;
+}
+
+bool WakeChamber::shouldAdvance(const TickContext& ctx, int n) {
+    if (!gatesAdvance()) return true;
+
+    if (paramsPending()) {
+        // The flow is about to change; sample it densely again.
+        adaptive_hist_.clear();
+        adaptive_stride_ = 1;
+        adaptive_since_ = 0;
+    }
+
+    const double spread = adaptiveSpread_();
+    const bool steady = spread <= adaptive_cfg_.rel_tol;
+
+    bool advance = true;
+    if (cache_ && cacheServe_(ctx)) {
+        advance = false;
+    } else {
+        if (cache_ && steady) {
+            cacheStore_(ctx, static_cast<double>(cum_steps_) - cache_key_steps_);
+        }
+        if (adaptive_on_ && steady) {
+            advance = (adaptive_since_ + 1 >= adaptive_stride_);
+        } else {
+            adaptive_stride_ = 1;
+            adaptive_since_ = 0;
+        }
+    }
+
+    if (advance) {
+        adaptive_since_ = 0;
+        ++adaptive_stats_.advanced;
+        if (adaptive_on_ && steady) {
+            adaptive_stride_ = std::min(adaptive_stride_ * 2, adaptive_cfg_.max_stride);
+        }
+    } else {
+        ++adaptive_since_;
+        ++adaptive_stats_.skipped;
+        adaptive_stats_.skipped_steps += n;
+    }
+
+    double sec_per_step = 0.0;
+    {
+        std::lock_guard<std::mutex> lk(sample_mtx_);
+        if (timed_steps_ > 0) sec_per_step = timed_block_s_ / static_cast<double>(timed_steps_);
+    }
+    adaptive_stats_.saved_s_est =
+        static_cast<double>(adaptive_stats_.skipped_steps) * sec_per_step;
+
+    if (adaptive_on_) {
+        adaptiveLog_.write(
+            ctx.tick_index,
+            ctx.time,
+            {
+                steady ? 1.0 : 0.0,
+                std::isfinite(spread) ? spread : -1.0,
+                static_cast<double>(adaptive_stride_),
+                advance ? 1.0 : 0.0,
+                static_cast<double>(adaptive_stats_.advanced),
+                static_cast<double>(adaptive_stats_.skipped),
+                static_cast<double>(adaptive_stats_.skipped_steps),
+                adaptive_stats_.saved_s_est
+            }
+        );
+    }
+    return advance;
+}
+
+WakeChamber::AdaptiveStats WakeChamber::adaptiveStats() const {
+    return adaptive_stats_;
+}
+
+// ---------------- wake-response cache ----------------
+
+void WakeChamber::enableResponseCache(std::unique_ptr<WakeResponseCache> cache,
+                                      const std::vector<std::pair<std::string, double>>& initial_key) {
+    cache_ = std::move(cache);
+    cache_key_changed_ = false;
+    cache_serving_ = false;
+    cache_stored_ = false;
+    cache_key_.clear();
+    if (!cache_) return;
+
+    const std::vector<std::string>& names = cache_->keyNames();
+    cache_key_.assign(names.size(), std::numeric_limits<double>::quiet_NaN());
+    for (const auto& kv : initial_key) {
+        for (std::size_t k = 0; k < names.size(); ++k) {
+            if (names[k] == kv.first) cache_key_[k] = kv.second;
+        }
+    }
+    cache_key_changed_ = true;
+
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    if (rank == 0) cache_->load();
+
+    std::vector<std::string> cols = {"result"};
+    for (const std::string& k : cache_->keyNames()) cols.push_back(k);
+    for (const char* c : {"temp_K", "density_m3", "hits", "interpolated",
+                          "misses", "stale", "stored"}) {
+        cols.push_back(c);
+    }
+    cacheLog_ = Logger::instance().registerSchema(label_ + "Cache", cols);
+}
+
+bool WakeChamber::cacheServe_(const TickContext& ctx) {
+    for (double v : cache_key_) {
+        if (!std::isfinite(v)) return false;
+    }
+    if (!cache_key_changed_) return cache_serving_;
+
+    cache_key_changed_ = false;
+    cache_stored_ = false;
+    cache_key_steps_ = static_cast<double>(cum_steps_);
+
+    WakeResponseCache::Response r;
+    const WakeResponseCache::Lookup res = cache_->lookup(cache_key_, r);
+    cache_serving_ = (res != WakeResponseCache::Lookup::Miss);
+    if (cache_serving_) {
+        cache_served_ = r;
+        cache_stored_ = true;
+    }
+    logCache_(ctx, static_cast<double>(res));
+    return cache_serving_;
+}
+
+void WakeChamber::cacheStore_(const TickContext& ctx, double window_steps) {
+    if (cache_stored_ || adaptive_hist_.empty()) return;
+    for (double v : cache_key_) {
+        if (!std::isfinite(v)) return;
+    }
+
+    WakeResponseCache::Response r;
+    for (const auto& row : adaptive_hist_) {
+        r.temp_K     += row[0];
+        r.density_m3 += row[1];
+    }
+    r.temp_K     /= static_cast<double>(adaptive_hist_.size());
+    r.density_m3 /= static_cast<double>(adaptive_hist_.size());
+    r.cum_steps   = window_steps;
+
+    cache_->store(cache_key_, r);
+    cache_stored_ = true;
+    cache_served_ = r;
+    logCache_(ctx, 3.0);
+}
+
+/*
+    One <label>Cache row: result 0 = miss, 1 = hit, 2 = interpolated,
+    3 = stored.
+*/
+void WakeChamber::logCache_(const TickContext& ctx, double result) {
+    const WakeResponseCache::Stats& st = cache_->stats();
+    std::vector<double> row = {result};
+    row.insert(row.end(), cache_key_.begin(), cache_key_.end());
+    const bool served = cache_serving_ || result == 3.0;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    row.push_back(served ? cache_served_.temp_K : nan);
+    row.push_back(served ? cache_served_.density_m3 : nan);
+    for (long v : {st.hits, st.interpolated, st.misses, st.stale, st.stored}) {
+        row.push_back(static_cast<double>(v));
+    }
+    cacheLog_.write(ctx.tick_index, ctx.time, row.data(), row.size());
+}
+
 /*
     Tear down the SPARTA bridge and reset internal state.
 */
 void WakeChamber::shutdown() {
+    stopPipeline();
+
     logEvent_(/*status*/0.0,
               /*ran_steps*/0.0,
               /*cum_steps*/static_cast<double>(cum_steps_),
@@ -380,12 +1268,194 @@ void WakeChamber::shutdown() {
               /*mark_reload*/0.0);
 
     sp_.reset();
+    wafer_flux_on_ = false;
     initialized_ = false;
+    snapshot_ready_ = false;
     dirtyReload_ = false;
     deck_.clear();
     input_subdir_.clear();
 }
 
+/*
+    Write the harness checkpoint's wake part (collective).
+
+    The SPARTA restart file holds particles and the developed flow; the
+    "wake." entries hold what the harness tracks around it. Followers fill
+    ckpt too, but only the leader's copy is written to disk.
+*/
+bool WakeChamber::writeCheckpoint(CheckpointWriter& ckpt, const std::string& restart_path) {
+    if (!initialized_) {
+        throw std::runtime_error("WakeChamber::init() not called");
+    }
+
+    bool restart_written = false;
+    if (sp_ && sp_->acceptsCommands()) {
+        int rank = 0;
+        MPI_Comm_rank(comm_, &rank);
+        if (rank == 0) {
+            std::error_code ec;
+            const fs::path dir = fs::path(restart_path).parent_path();
+            if (!dir.empty()) fs::create_directories(dir, ec);
+        }
+        {
+            SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Barrier(wake.checkpoint)");
+            FlightScope flight("MPI_Barrier(wake.checkpoint)");
+            MPI_Barrier(comm_);
+        }
+        SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::writeCheckpoint");
+        sp_->command(("write_restart " + restart_path).c_str());
+        restart_written = true;
+    }
+
+    ckpt.setInts("wake.counters", std::vector<std::int64_t>{
+        cum_steps_.load(), last_run_steps_.load(), event_id_, reload_count_.load(),
+        block_steps_, last_logged_tick_, timed_steps_});
+    ckpt.setBool("wake.dirty_reload", dirtyReload_);
+    ckpt.setBool("wake.snapshot_ready", snapshot_ready_);
+    ckpt.setDoubles("wake.hot_pending", hot_pending_);
+    ckpt.setDouble("wake.n_inf", n_inf_);
+    ckpt.setDouble("wake.timed_block_s", timed_block_s_);
+    ckpt.setDoubles("wake.file_probes", {file_temp_K_, file_density_m3_});
+    {
+        std::lock_guard<std::mutex> lk(sample_mtx_);
+        ckpt.setBool("wake.sample_valid", sample_.valid);
+        ckpt.setDoubles("wake.sample", {sample_.temp_K, sample_.density_m3,
+                                        sample_.shield_hits, sample_.shield_reemit});
+    }
+
+    std::vector<double> hist;
+    for (const auto& row : adaptive_hist_) hist.insert(hist.end(), row.begin(), row.end());
+    ckpt.setDoubles("wake.adaptive_hist", hist);
+    ckpt.setInts("wake.adaptive", std::vector<std::int64_t>{
+        adaptive_stride_, adaptive_since_, adaptive_stats_.advanced,
+        adaptive_stats_.skipped, adaptive_stats_.skipped_steps});
+    ckpt.setDouble("wake.adaptive_saved_s", adaptive_stats_.saved_s_est);
+
+    ckpt.setDoubles("wake.cache_key", cache_key_);
+    ckpt.setInts("wake.cache_flags", std::vector<int>{
+        cache_key_changed_ ? 1 : 0, cache_serving_ ? 1 : 0, cache_stored_ ? 1 : 0});
+    ckpt.setDoubles("wake.cache_served", {cache_key_steps_, cache_served_.temp_K,
+                                          cache_served_.density_m3, cache_served_.cum_steps});
+    return restart_written;
+}
+
+/*
+    Restore the wake part of a harness checkpoint (collective, after init()).
+
+    restore_source 3 in the event row marks a rebuild from the checkpoint's
+    restart file.
+*/
+bool WakeChamber::resumeFromCheckpoint(const CheckpointReader& ckpt,
+                                       const std::string& restart_path) {
+    if (!initialized_) {
+        throw std::runtime_error("WakeChamber::init() not called");
+    }
+
+    const std::vector<std::int64_t> counters = ckpt.getInts("wake.counters");
+    if (counters.size() != 7) {
+        throw std::runtime_error("WakeChamber: malformed checkpoint entry 'wake.counters'");
+    }
+    cum_steps_             = static_cast<int>(counters[0]);
+    last_run_steps_        = static_cast<int>(counters[1]);
+    event_id_              = counters[2];
+    reload_count_          = static_cast<int>(counters[3]);
+    block_steps_           = static_cast<int>(counters[4]);
+    last_logged_tick_      = static_cast<int>(counters[5]);
+    timed_steps_           = counters[6];
+    dirtyReload_           = ckpt.getBool("wake.dirty_reload");
+    n_inf_                 = ckpt.getDouble("wake.n_inf");
+    timed_block_s_         = ckpt.getDouble("wake.timed_block_s");
+
+    const std::vector<double> hot = ckpt.getDoubles("wake.hot_pending");
+    if (hot.size() == hot_pending_.size()) hot_pending_ = hot;
+
+    const std::vector<double> file_probes = ckpt.getDoubles("wake.file_probes");
+    if (file_probes.size() == 2) {
+        file_temp_K_     = file_probes[0];
+        file_density_m3_ = file_probes[1];
+    }
+    {
+        const std::vector<double> v = ckpt.getDoubles("wake.sample");
+        std::lock_guard<std::mutex> lk(sample_mtx_);
+        sample_.valid = ckpt.getBool("wake.sample_valid");
+        if (v.size() == 4) {
+            sample_.temp_K        = v[0];
+            sample_.density_m3    = v[1];
+            sample_.shield_hits   = v[2];
+            sample_.shield_reemit = v[3];
+        }
+    }
+
+    const std::vector<double> hist = ckpt.getDoubles("wake.adaptive_hist");
+    adaptive_hist_.clear();
+    for (std::size_t k = 0; k + 3 <= hist.size(); k += 3) {
+        adaptive_hist_.push_back({hist[k], hist[k + 1], hist[k + 2]});
+    }
+    const std::vector<std::int64_t> ad = ckpt.getInts("wake.adaptive");
+    if (ad.size() == 5) {
+        adaptive_stride_              = static_cast<int>(ad[0]);
+        adaptive_since_               = static_cast<int>(ad[1]);
+        adaptive_stats_.advanced      = static_cast<long>(ad[2]);
+        adaptive_stats_.skipped       = static_cast<long>(ad[3]);
+        adaptive_stats_.skipped_steps = static_cast<long>(ad[4]);
+    }
+    adaptive_stats_.saved_s_est = ckpt.getDouble("wake.adaptive_saved_s");
+
+    const std::vector<double> key = ckpt.getDoubles("wake.cache_key");
+    if (key.size() == cache_key_.size()) cache_key_ = key;
+    const std::vector<std::int64_t> flags = ckpt.getInts("wake.cache_flags");
+    if (flags.size() == 3) {
+        cache_key_changed_ = flags[0] != 0;
+        cache_serving_     = flags[1] != 0;
+        cache_stored_      = flags[2] != 0;
+    }
+    const std::vector<double> served = ckpt.getDoubles("wake.cache_served");
+    if (served.size() == 4) {
+        cache_key_steps_          = served[0];
+        cache_served_.temp_K      = served[1];
+        cache_served_.density_m3  = served[2];
+        cache_served_.cum_steps   = served[3];
+    }
+
+    // Every rank must agree on whether SPARTA is rebuilt and whether the
+    // in-run snapshot (written by the interrupted run) is still there.
+    int rank = 0;
+    MPI_Comm_rank(comm_, &rank);
+    int have[2] = {0, 0};
+    if (rank == 0) {
+        std::error_code ec;
+        have[0] = fs::exists(restart_path, ec) ? 1 : 0;
+        fs::path snap(snapshot_path_);
+        if (snap.is_relative()) snap = fs::path(input_subdir_) / snap;
+        have[1] = (!snapshot_path_.empty() && fs::exists(snap, ec)) ? 1 : 0;
+    }
+    {
+        FlightScope flight("MPI_Bcast(wake.resume)");
+        MPI_Bcast(have, 2, MPI_INT, 0, comm_);
+    }
+    snapshot_ready_ = ckpt.getBool("wake.snapshot_ready") && have[1] != 0;
+
+    if (!have[0] || resume_deck_.empty() || !sp_ || !sp_->acceptsCommands()) {
+        return false;
+    }
+
+    const double t0 = MPI_Wtime();
+    sp_->command("clear");
+    sp_->command(("variable wake_snapshot string " + restart_path).c_str());
+    sp_->runDeck(resume_deck_, input_subdir_);
+    const double reload_ms = (MPI_Wtime() - t0) * 1.0e3;
+
+    logEvent_(/*status*/1.0,
+              /*ran_steps*/0.0,
+              /*cum_steps*/static_cast<double>(cum_steps_),
+              /*reload*/1.0,
+              /*mark_reload*/0.0,
+              /*hot_update*/0.0,
+              reload_ms,
+              /*restore_source*/3.0);
+    return true;
+}
+
 /*
     Rewrite params.inc with the latest parameter values.
 
@@ -404,15 +1474,14 @@ void WakeChamber::setParameter(const std::string& name, double value) {
         return;
     }
 
-    auto& state = param_state_ref();
-    state[name] = value;
+    param_state_[name] = value;
 
     std::ofstream out(params);
     if (!out) {
         throw std::runtime_error("WakeChamber::setParameter: cannot open params.inc");
     }
 
-    for (const auto& kv : state) {
+    for (const auto& kv : param_state_) {
         out << "variable " << kv.first << " equal " << kv.second << "\n";
     }
     out.flush();
@@ -431,7 +1500,9 @@ void WakeChamber::setParameter(const std::string& name, double value) {
 /*
     Per-tick logging hook for wake diagnostics.
 
-    Reads:
+    Reads, when SPARTA is embedded:
+    - the probes_ variables, sampled from the running instance after each block
+    Otherwise (external-process shim):
     - wake_diag.csv for temperature and density
     - shield_collide.csv for shield hit counters if available
 
@@ -446,44 +1517,41 @@ void WakeChamber::setParameter(const std::string& name, double value) {
     This method does not perform SPARTA advancement.
 */
 void WakeChamber::tick(const TickContext& ctx) {
-    int& last_tick = last_logged_tick_ref();
-    if (last_tick == ctx.tick_index) {
+    if (last_logged_tick_ == ctx.tick_index) {
         last_run_steps_ = 0;
         return;
     }
-    last_tick = ctx.tick_index;
+    last_logged_tick_ = ctx.tick_index;
+    const int ran_steps = last_run_steps_.exchange(0);
 
-    double temp_K = std::numeric_limits<double>::quiet_NaN();
-    double density_m3 = std::numeric_limits<double>::quiet_NaN();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double temp_K = nan;
+    double density_m3 = nan;
+    double shield_hits = 0.0;
+    double reemit_total = 0.0;
 
-    if (auto diag = read_sparta_diag_csv(diag_path_)) {
-        if (std::isfinite(diag->temp_K)) {
-            temp_K = diag->temp_K;
-        }
-        if (std::isfinite(diag->density_m3)) {
-            density_m3 = diag->density_m3;
+    if (sp_ && sp_->inProcess()) {
+        // Sampled after the latest completed block (see sampleProbes_); with
+        // pipelined coupling that is one or more blocks behind the leader.
+        std::lock_guard<std::mutex> lk(sample_mtx_);
+        if (sample_.valid) {
+            temp_K       = sample_.temp_K;
+            density_m3   = sample_.density_m3;
+            shield_hits  = sample_.shield_hits;
+            reemit_total = sample_.shield_reemit;
         }
-    }
-
-    // Carry forward the last valid readings to reduce log discontinuities.
-    double& lastT = last_tempK_ref();
-    double& lastN = last_nrho_ref();
-
-    if (!std::isfinite(temp_K)) {
-        temp_K = lastT;
     } else {
-        lastT = temp_K;
+        readDiagFiles_(temp_K, density_m3, shield_hits, reemit_total);
     }
 
-    if (!std::isfinite(density_m3)) {
-        density_m3 = lastN;
-    } else {
-        lastN = density_m3;
+    if (cache_serving_) {
+        // SPARTA is parked; this key's converged response comes from the cache.
+        temp_K     = cache_served_.temp_K;
+        density_m3 = cache_served_.density_m3;
     }
 
-    double& n_inf = n_inf_ref();
-    if (n_inf <= 0.0 && density_m3 > 0.0) {
-        n_inf = density_m3;
+    if (n_inf_ <= 0.0 && density_m3 > 0.0) {
+        n_inf_ = density_m3;
     }
 
     const double pressure_Pa =
@@ -492,40 +1560,27 @@ void WakeChamber::tick(const TickContext& ctx) {
             : 0.0;
 
     const double n_ratio =
-        (n_inf > 0.0 && density_m3 >= 0.0)
-            ? (density_m3 / n_inf)
+        (n_inf_ > 0.0 && density_m3 >= 0.0)
+            ? (density_m3 / n_inf_)
             : 0.0;
 
-    const fs::path surf_csv = fs::path(input_subdir_) / "data" / "tmp" / "shield_collide.csv";
-
-    double shield_hits = 0.0;
-    double reemit_total = 0.0;
-
-    if (auto sd = read_shield_collide_csv(surf_csv)) {
-        shield_hits = sd->shield_hits;
-        reemit_total = sd->reemit_total;
+    // One steady-state sample per completed block; no data yet (NaN or
+    // the zero placeholders) never counts towards steady state.
+    if (gatesAdvance() && ran_steps > 0 && temp_K > 0.0 && density_m3 > 0.0) {
+        adaptive_hist_.push_back({temp_K, density_m3, pressure_Pa});
+        while (adaptive_hist_.size() > static_cast<std::size_t>(adaptive_cfg_.window)) {
+            adaptive_hist_.pop_front();
+        }
     }
 
-    Logger::instance().log_wide(
-        "WakeChamber",
+    last_probes_ = {temp_K, density_m3, n_ratio, pressure_Pa, shield_hits, reemit_total};
+
+    tickLog_.write(
         ctx.tick_index,
         ctx.time,
-        {
-            "status",
-            "ran_steps",
-            "cum_steps",
-            "reload",
-            "mark_reload",
-            "temp_K",
-            "density_m3",
-            "n_ratio",
-            "pressure_Pa",
-            "shield_hits",
-            "shield_reemit"
-        },
         {
             1.0,
-            static_cast<double>(last_run_steps_),
+            static_cast<double>(ran_steps),
             static_cast<double>(cum_steps_),
             0.0,
             0.0,
@@ -537,8 +1592,34 @@ void WakeChamber::tick(const TickContext& ctx) {
             reemit_total
         }
     );
+}
 
-    last_run_steps_ = 0;
+/*
+    Read the deck's CSV diagnostics (external-process builds).
+
+    The files are appended by SPARTA once per block and can lag behind the
+    harness. Each tick reads only the rows appended since the last one (a
+    deck reload that truncates a file is detected and restarts it), and the last valid temperature and density are carried forward
+    instead of logging NaN.
+*/
+void WakeChamber::readDiagFiles_(double& temp_K, double& density_m3,
+                                 double& shield_hits, double& reemit_total) {
+    SF_PROFILE_SCOPE(ProfileCat::Sparta, "WakeChamber::readDiag");
+    if (auto diag = read_sparta_diag_csv(diag_tail_)) {
+        if (std::isfinite(diag->temp_K)) {
+            file_temp_K_ = diag->temp_K;
+        }
+        if (std::isfinite(diag->density_m3)) {
+            file_density_m3_ = diag->density_m3;
+        }
+    }
+    temp_K = file_temp_K_;
+    density_m3 = file_density_m3_;
+
+    if (auto sd = read_shield_collide_csv(shield_tail_)) {
+        shield_hits = sd->shield_hits;
+        reemit_total = sd->reemit_total;
+    }
 }
 
 /*
@@ -551,32 +1632,30 @@ void WakeChamber::logEvent_(double status,
                             double ran_steps,
                             double cum_steps,
                             double reload,
-                            double mark_reload) {
+                            double mark_reload,
+                            double hot_update,
+                            double reload_ms,
+                            double restore_source,
+                            double snapshot_written) {
     int rank = 0;
     MPI_Comm_rank(comm_, &rank);
     if (rank != 0) return;
 
-    static const std::vector<std::string> COLS = {
-        "status",
-        "ran_steps",
-        "cum_steps",
-        "reload",
-        "mark_reload"
-    };
-
-    const std::vector<double> vals = {
-        status,
-        ran_steps,
-        cum_steps,
-        reload,
-        mark_reload
-    };
-
-    Logger::instance().log_wide(
-        label_ + "Events",
-        /*tick*/++event_id_,
+    std::lock_guard<std::mutex> lk(event_mtx_);
+    eventLog_.write(
+        /*tick*/static_cast<int>(++event_id_),
         /*time*/0.0,
-        COLS,
-        vals
+        {
+            status,
+            ran_steps,
+            cum_steps,
+            reload,
+            mark_reload,
+            hot_update,
+            static_cast<double>(reload_count_),
+            reload_ms,
+            restore_source,
+            snapshot_written
+        }
     );
 }
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "WakeResponseCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr std::uint64_t kFnvPrime  = 1099511628211ull;
+
+void fnv1a(std::uint64_t& h, const char* p, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= kFnvPrime;
+    }
+}
+
+bool same_value(double a, double b) {
+    return a == b || std::fabs(a - b) <= 1e-9 * std::max(std::fabs(a), std::fabs(b));
+}
+
+bool same_key(const std::vector<double>& a, const std::vector<double>& b,
+              std::size_t skip = static_cast<std::size_t>(-1)) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (i != skip && !same_value(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+std::vector<std::string> split_row(const std::string& line) {
+    std::vector<std::string> out;
+    std::stringstream ss(line);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) out.push_back(tok);
+    return out;
+}
+
+std::string hex64(std::uint64_t v) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(v));
+    return buf;
+}
+
+} // namespace
+
+WakeResponseCache::WakeResponseCache(std::string path, std::vector<std::string> key_names,
+                                     std::uint64_t deck_hash, double interp_rel)
+    : path_(std::move(path)),
+      key_names_(std::move(key_names)),
+      deck_hash_(deck_hash),
+      interp_rel_(interp_rel > 0.0 ? interp_rel : 0.0) {
+    if (key_names_.empty()) {
+        throw std::runtime_error("WakeResponseCache: no key variables");
+    }
+}
+
+std::uint64_t WakeResponseCache::hashFiles(const std::vector<std::string>& paths) {
+    std::uint64_t h = kFnvOffset;
+    for (const std::string& p : paths) {
+        fnv1a(h, p.data(), p.size());
+        std::ifstream in(p, std::ios::binary);
+        if (!in) continue;
+        char buf[4096];
+        while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+            fnv1a(h, buf, static_cast<std::size_t>(in.gcount()));
+        }
+    }
+    return h;
+}
+
+void WakeResponseCache::writeHeader_(std::ostream& out) const {
+    out << "deck_hash";
+    for (const std::string& k : key_names_) out << ',' << k;
+    out << ",temp_K,density_m3,cum_steps\n";
+}
+
+void WakeResponseCache::load() {
+    entries_.clear();
+    header_ok_ = false;
+
+    std::ifstream in(path_);
+    if (!in) return;  // first run: nothing cached yet
+
+    std::string line;
+    if (!std::getline(in, line)) return;
+    std::ostringstream want;
+    writeHeader_(want);
+    std::string expected = want.str();
+    expected.pop_back();
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line != expected) {
+        std::cerr << "[WakeResponseCache] " << path_
+                  << ": header does not match the key variables; not using it\n";
+        return;
+    }
+    header_ok_ = true;
+
+    const std::size_t nk = key_names_.size();
+    while (std::getline(in, line)) {
+        const std::vector<std::string> tok = split_row(line);
+        if (tok.size() != nk + 4) continue;  // blank or torn row
+
+        Entry e;
+        try {
+            e.deck_hash = std::stoull(tok[0], nullptr, 16);
+            for (std::size_t i = 0; i < nk; ++i) e.key.push_back(std::stod(tok[1 + i]));
+            e.r.temp_K     = std::stod(tok[nk + 1]);
+            e.r.density_m3 = std::stod(tok[nk + 2]);
+            e.r.cum_steps  = std::stod(tok[nk + 3]);
+        } catch (...) {
+            continue;
+        }
+
+        if (e.deck_hash == deck_hash_) ++stats_.loaded;
+        else ++stats_.loaded_stale;
+
+        const long at = find_(e.key, e.deck_hash);
+        if (at >= 0) entries_[static_cast<std::size_t>(at)] = std::move(e);
+        else entries_.push_back(std::move(e));
+    }
+}
+
+long WakeResponseCache::find_(const std::vector<double>& key, std::uint64_t hash) const {
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].deck_hash == hash && same_key(entries_[i].key, key)) {
+            return static_cast<long>(i);
+        }
+    }
+    return -1;
+}
+
+bool WakeResponseCache::contains(const std::vector<double>& key) const {
+    return find_(key, deck_hash_) >= 0;
+}
+
+WakeResponseCache::Lookup WakeResponseCache::lookup(const std::vector<double>& key,
+                                                    Response& out) {
+    const long at = find_(key, deck_hash_);
+    if (at >= 0) {
+        out = entries_[static_cast<std::size_t>(at)].r;
+        ++stats_.hits;
+        return Lookup::Hit;
+    }
+
+    if (interp_rel_ > 0.0 && !key.empty()) {
+        const Entry* lo = nullptr;
+        const Entry* hi = nullptr;
+        for (const Entry& e : entries_) {
+            if (e.deck_hash != deck_hash_ || !same_key(e.key, key, 0)) continue;
+            if (e.key[0] < key[0] && (!lo || e.key[0] > lo->key[0])) lo = &e;
+            if (e.key[0] > key[0] && (!hi || e.key[0] < hi->key[0])) hi = &e;
+        }
+        if (lo && hi) {
+            const double span = hi->key[0] - lo->key[0];
+            const double scale = std::max(std::fabs(lo->key[0]), std::fabs(hi->key[0]));
+            if (span <= interp_rel_ * scale) {
+                const double w = (key[0] - lo->key[0]) / span;
+                out.temp_K     = lo->r.temp_K     + w * (hi->r.temp_K     - lo->r.temp_K);
+                out.density_m3 = lo->r.density_m3 + w * (hi->r.density_m3 - lo->r.density_m3);
+                out.cum_steps  = std::max(lo->r.cum_steps, hi->r.cum_steps);
+                ++stats_.interpolated;
+                return Lookup::Interpolated;
+            }
+        }
+    }
+
+    ++stats_.misses;
+    for (const Entry& e : entries_) {
+        if (e.deck_hash != deck_hash_ && same_key(e.key, key)) {
+            ++stats_.stale;
+            break;
+        }
+    }
+    return Lookup::Miss;
+}
+
+void WakeResponseCache::store(const std::vector<double>& key, const Response& r) {
+    if (key.size() != key_names_.size()) {
+        throw std::runtime_error("WakeResponseCache::store: key size mismatch");
+    }
+
+    Entry e;
+    e.deck_hash = deck_hash_;
+    e.key = key;
+    e.r = r;
+    const long at = find_(key, deck_hash_);
+    if (at >= 0) entries_[static_cast<std::size_t>(at)] = e;
+    else entries_.push_back(e);
+    ++stats_.stored;
+
+    // Append to a matching file; otherwise (new file, or one written for
+    // other key variables) start it over from the entries held here.
+    std::ofstream out(path_, header_ok_ ? std::ios::app : std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("WakeResponseCache: cannot write " + path_);
+    }
+    out.precision(17);
+    if (header_ok_) {
+        writeRow_(out, e);
+        return;
+    }
+    writeHeader_(out);
+    for (const Entry& x : entries_) writeRow_(out, x);
+    header_ok_ = true;
+}
+
+void WakeResponseCache::writeRow_(std::ostream& out, const Entry& e) const {
+    out << hex64(e.deck_hash);
+    for (double v : e.key) out << ',' << v;
+    out << ',' << e.r.temp_K << ',' << e.r.density_m3 << ',' << e.r.cum_steps << '\n';
+}
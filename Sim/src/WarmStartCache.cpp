@@ -0,0 +1,156 @@
+#include "WarmStartCache.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr std::uint64_t kFnvPrime  = 1099511628211ull;
+
+void fnv1a(std::uint64_t& h, const char* p, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= kFnvPrime;
+    }
+}
+
+void fnv1a(std::uint64_t& h, const std::string& s) {
+    fnv1a(h, s.data(), s.size() + 1);   // with the terminator, so fields don't run together
+}
+
+// Position of the file argument for SPARTA commands that read one, or 0.
+std::size_t file_arg(const std::string& cmd) {
+    if (cmd == "include" || cmd == "read_surf" || cmd == "species" || cmd == "read_grid") return 1;
+    if (cmd == "react") return 2;                       // react tce file
+    if (cmd == "collide" || cmd == "surf_react") return 3;  // collide vss mix file
+    return 0;
+}
+
+void collect(const fs::path& input, const std::string& file, std::set<std::string>& seen,
+             std::vector<std::string>& out) {
+    if (!seen.insert(file).second) return;
+    out.push_back(file);
+
+    std::ifstream in(input / file);
+    if (!in) return;   // hashed as a name only
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream ss(line);
+        std::vector<std::string> tok;
+        for (std::string t; ss >> t;) tok.push_back(t);
+        if (tok.empty()) continue;
+
+        const std::size_t k = file_arg(tok[0]);
+        if (k == 0 || k >= tok.size()) continue;
+        const std::string& arg = tok[k];
+        if (arg.find('$') != std::string::npos) continue;
+        if (tok[0] == "include") {
+            collect(input, arg, seen, out);
+        } else if (seen.insert(arg).second) {
+            out.push_back(arg);
+        }
+    }
+}
+
+} // namespace
+
+WarmStartCache::WarmStartCache(std::string dir) {
+    if (dir.empty()) {
+        throw std::runtime_error("WarmStartCache: no cache directory");
+    }
+    // Absolute now: embedded SPARTA later moves the process into the input
+    // directory.
+    dir_ = fs::absolute(dir).string();
+}
+
+std::vector<std::string> WarmStartCache::deckFiles(const std::string& input_dir,
+                                                   const std::string& deck) {
+    std::set<std::string> seen;
+    std::vector<std::string> out;
+    collect(fs::path(input_dir), deck, seen, out);
+    return out;
+}
+
+std::uint64_t WarmStartCache::makeKey(const std::string& input_dir,
+                                      const std::vector<std::string>& files,
+                                      const std::string& sparta_tag, int ranks, long steps) {
+    std::uint64_t h = kFnvOffset;
+    for (const std::string& f : files) {
+        fnv1a(h, f);
+        std::ifstream in(fs::path(input_dir) / f, std::ios::binary);
+        if (!in) continue;
+        char buf[4096];
+        while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+            fnv1a(h, buf, static_cast<std::size_t>(in.gcount()));
+        }
+    }
+    fnv1a(h, sparta_tag);
+    fnv1a(h, std::to_string(ranks));
+    fnv1a(h, std::to_string(steps));
+    return h;
+}
+
+std::string WarmStartCache::keyHex(std::uint64_t key) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(key));
+    return buf;
+}
+
+void WarmStartCache::scan() {
+    stats_.entries = 0;
+    stats_.bytes   = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind("warm_", 0) != 0 || it->path().extension() != ".restart") continue;
+        ++stats_.entries;
+        std::error_code sec;
+        const auto size = fs::file_size(it->path(), sec);
+        if (!sec) stats_.bytes += static_cast<std::uint64_t>(size);
+    }
+}
+
+bool WarmStartCache::lookup(std::uint64_t key) {
+    std::error_code ec;
+    const bool hit = fs::exists(entryPath(key), ec);
+    if (hit) ++stats_.hits;
+    else     ++stats_.misses;
+    return hit;
+}
+
+std::string WarmStartCache::entryPath(std::uint64_t key) const {
+    return (fs::path(dir_) / ("warm_" + keyHex(key) + ".restart")).string();
+}
+
+std::string WarmStartCache::tempPath(std::uint64_t key, long token) const {
+    return entryPath(key) + ".tmp." + std::to_string(token);
+}
+
+bool WarmStartCache::commit(std::uint64_t key, long token, const std::string& description) {
+    const std::string tmp = tempPath(key, token);
+    std::error_code ec;
+    if (!fs::exists(tmp, ec)) return false;
+
+    const fs::path entry = entryPath(key);
+    fs::rename(tmp, entry, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    std::ofstream meta(fs::path(entry).replace_extension(".txt"), std::ios::trunc);
+    meta << description;
+    ++stats_.stored;
+    ++stats_.entries;
+    const auto size = fs::file_size(entry, ec);
+    if (!ec) stats_.bytes += static_cast<std::uint64_t>(size);
+    return true;
+}
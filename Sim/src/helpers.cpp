@@ -1,4 +1,5 @@
 #include "helpers.hpp"
+#include "Profiler.hpp"
 
 #include <mpi.h>
 #include <algorithm>
@@ -49,6 +50,60 @@ Args parse_args(int argc, char** argv) {
     else if (arg_eq(argv[i], "--sparta-block") && i + 1 < argc) a.spartaBlock = std::atoi(argv[++i]);
     else if (arg_eq(argv[i], "--nticks") && i + 1 < argc)       a.nticks = std::atoi(argv[++i]);
     else if (arg_eq(argv[i], "--dt") && i + 1 < argc)           a.dt = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--tick-threads") && i + 1 < argc) a.tickThreads = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--power-alloc") && i + 1 < argc)  a.powerAlloc = argv[++i];
+    else if (arg_eq(argv[i], "--engine") && i + 1 < argc)       a.engine = argv[++i];
+    else if (arg_eq(argv[i], "--ensemble-spec") && i + 1 < argc)      a.ensembleSpec = argv[++i];
+    else if (arg_eq(argv[i], "--ensemble-members") && i + 1 < argc)   a.ensembleMembers = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--ensemble-log-every") && i + 1 < argc) a.ensembleLogEvery = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--mission-base-load-W") && i + 1 < argc) a.missionBaseLoadW = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--mission-payload-W") && i + 1 < argc)  a.missionPayloadW = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--mission-orbits-per-row") && i + 1 < argc) a.missionOrbitsPerRow = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--mission-validate") && i + 1 < argc)   a.missionValidate = std::atol(argv[++i]);
+    else if (arg_eq(argv[i], "--wake-hot-include") && i + 1 < argc)   a.wakeHotInclude = argv[++i];
+    else if (arg_eq(argv[i], "--wake-resume-deck") && i + 1 < argc)   a.wakeResumeDeck = argv[++i];
+    else if (arg_eq(argv[i], "--wafer-flux") && i + 1 < argc)         a.waferFluxFix = argv[++i];
+    else if (arg_eq(argv[i], "--deck-grid") && i + 1 < argc)          a.deckGrid = argv[++i];
+    else if (arg_eq(argv[i], "--deck-refine") && i + 1 < argc)        a.deckRefine = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--deck-csv-every") && i + 1 < argc)     a.deckCsvEvery = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--wake-pipeline") && i + 1 < argc)      a.wakePipelineLag = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--sparta-devices") && i + 1 < argc)     a.spartaDevices = argv[++i];
+    else if (arg_eq(argv[i], "--wake-adaptive") && i + 1 < argc)      a.wakeAdaptiveTol = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--wake-adaptive-window") && i + 1 < argc)     a.wakeAdaptiveWindow = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--wake-adaptive-max-stride") && i + 1 < argc) a.wakeAdaptiveMaxStride = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--wake-cache") && i + 1 < argc)         a.wakeCache = argv[++i];
+    else if (arg_eq(argv[i], "--wake-cache-interp") && i + 1 < argc)  a.wakeCacheInterp = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--warm-cache") && i + 1 < argc)         a.warmCache = argv[++i];
+    else if (arg_eq(argv[i], "--warm-cache-blocks") && i + 1 < argc)  a.warmCacheBlocks = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--fast-forward"))                       a.fastForward = true;
+    else if (arg_eq(argv[i], "--fast-forward-tol") && i + 1 < argc)   a.fastForwardTolK = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--fast-forward-min") && i + 1 < argc)   a.fastForwardMinTicks = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--fast-forward-decimate") && i + 1 < argc) a.fastForwardDecimate = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--telemetry") && i + 1 < argc)          a.telemetry = argv[++i];
+    else if (arg_eq(argv[i], "--telemetry-slots") && i + 1 < argc)    a.telemetrySlots = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--telemetry-control"))                  a.telemetryControl = true;
+    else if (arg_eq(argv[i], "--dataset") && i + 1 < argc)            a.dataset = argv[++i];
+    else if (arg_eq(argv[i], "--orbit-ephemeris") && i + 1 < argc)    a.orbitEphemeris = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--thermal-integrator") && i + 1 < argc) a.thermalIntegrator = argv[++i];
+    else if (arg_eq(argv[i], "--thermal-tol") && i + 1 < argc)        a.thermalTolK = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--thermal-max-substeps") && i + 1 < argc) a.thermalMaxSubsteps = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--sweep-spec") && i + 1 < argc)         a.sweepSpec = argv[++i];
+    else if (arg_eq(argv[i], "--sweep-threads") && i + 1 < argc)      a.sweepThreads = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--sweep-jobs-dir") && i + 1 < argc)     a.sweepJobsDir = argv[++i];
+    else if (arg_eq(argv[i], "--branch-spec") && i + 1 < argc)        a.branchSpec = argv[++i];
+    else if (arg_eq(argv[i], "--branch-at") && i + 1 < argc)          a.branchAt = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--farm-jobs") && i + 1 < argc)          a.farmJobs = argv[++i];
+    else if (arg_eq(argv[i], "--farm-group-size") && i + 1 < argc)    a.farmGroupSize = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--schedule-cache") && i + 1 < argc)     a.scheduleCache = argv[++i];
+    else if (arg_eq(argv[i], "--checkpoint-every") && i + 1 < argc) a.checkpointEvery = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--checkpoint-dir") && i + 1 < argc)   a.checkpointDir = argv[++i];
+    else if (arg_eq(argv[i], "--resume"))                           a.resume = true;
+    else if (arg_eq(argv[i], "--profile"))                            a.profile = true;
+    else if (arg_eq(argv[i], "--alloc-report"))                       a.allocReport = true;
+    else if (arg_eq(argv[i], "--alloc-warmup") && i + 1 < argc)       a.allocWarmup = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--flight-events") && i + 1 < argc)      a.flightEvents = std::atoi(argv[++i]);
+    else if (arg_eq(argv[i], "--watchdog") && i + 1 < argc)           a.watchdogSeconds = std::atof(argv[++i]);
+    else if (arg_eq(argv[i], "--verbose"))                            a.verbose = true;
     else if (arg_eq(argv[i], "--help"))                         a.showHelp = true;
   }
   return a;
@@ -56,19 +111,120 @@ Args parse_args(int argc, char** argv) {
 
 void print_usage() {
   std::cout
-    << "Usage: sim [--mode dual|legacy|wake|power]\n"
-    << "           [--wake-deck in.wake_harness]\n"
+    << "Usage: sim [--mode dual|legacy|wake|power|ensemble|mission|sweep|branch|farm]\n"
+    << "           [--wake-deck in.wake_harness|generate]\n"
+    << "           [--deck-grid NX,NY,NZ] [--deck-refine N] [--deck-csv-every K]\n"
     << "           [--input-subdir input]\n"
     << "           [--couple-every T] [--sparta-block N]\n"
     << "           [--nticks N] [--dt seconds]\n"
+    << "           [--tick-threads N] [--engine dynamic|static]\n"
+    << "           [--power-alloc inline|batched]\n"
+    << "           [--ensemble-spec members.csv] [--ensemble-members N]\n"
+    << "           [--ensemble-log-every K]\n"
+    << "           [--mission-base-load-W W] [--mission-payload-W W]\n"
+    << "           [--mission-orbits-per-row N] [--mission-validate N]\n"
+    << "           [--wake-hot-include wake_hot.inc|none]\n"
+    << "           [--wake-resume-deck auto|in.wake_resume|none]\n"
+    << "           [--wafer-flux waferFluxAve|none]\n"
+    << "           [--wake-pipeline LAG]\n"
+    << "           [--sparta-devices default|rr[:N|:d0,d1,..]|map:d0,d1,..|cpu]\n"
+    << "           [--wake-adaptive TOL] [--wake-adaptive-window N]\n"
+    << "           [--wake-adaptive-max-stride K]\n"
+    << "           [--wake-cache cache.csv] [--wake-cache-interp REL]\n"
+    << "           [--warm-cache DIR] [--warm-cache-blocks K]\n"
+    << "           [--fast-forward] [--fast-forward-tol K] [--fast-forward-min N]\n"
+    << "           [--fast-forward-decimate N] [--orbit-ephemeris N]\n"
+    << "           [--telemetry NAME|auto] [--telemetry-slots N] [--telemetry-control]\n"
+    << "           [--dataset DIR|auto]\n"
+    << "           [--thermal-integrator euler|stable] [--thermal-tol K]\n"
+    << "           [--thermal-max-substeps N]\n"
+    << "           [--sweep-spec sweep.txt] [--sweep-threads N]\n"
+    << "           [--sweep-jobs-dir active_jobs]\n"
+    << "           [--branch-spec branches.txt] [--branch-at TICK]\n"
+    << "           [--farm-jobs 'V4_job*.txt'] [--farm-group-size N]\n"
+    << "           [--schedule-cache auto|off|rebuild]\n"
+    << "           [--checkpoint-every N] [--checkpoint-dir DIR] [--resume]\n"
+    << "           [--profile] [--watchdog S] [--flight-events N]\n"
+    << "           [--alloc-report] [--alloc-warmup N]\n"
+    << "           [--verbose]\n"
     << "\n"
     << "Modes:\n"
     << "  legacy  - single SPARTA instance on MPI_COMM_WORLD\n"
     << "  wake    - wake-only with in.wake_harness\n"
     << "  dual    - currently an alias of wake\n"
     << "  power   - C++ power and thermal harness only\n"
+    << "  ensemble - many power harness variants in lockstep (members split across ranks)\n"
+    << "  mission - fused power kernel over an orbit ephemeris, per-orbit statistics only\n"
+    << "  sweep   - parameter sweep, one power harness per member over ranks x threads\n"
+    << "  branch  - one power harness prefix, then what-if branches restored from it\n"
+    << "  farm    - many job files, one wake harness per rank group, handed out by rank 0\n"
     << "\n"
-    << "Coupling advances SPARTA by N steps every T engine ticks.\n";
+    << "Coupling advances SPARTA by N steps every T engine ticks.\n"
+    << "--tick-threads runs independent subsystem ticks on N worker threads.\n"
+    << "--engine static runs power mode on a compile-time subsystem pipeline.\n"
+    << "--power-alloc batched collects the tick's power requests and allocates them\n"
+    << "  once before the loads run (same grants as inline drawPower calls).\n"
+    << "--wake-hot-include updates beam parameters on a live SPARTA instance\n"
+    << "  instead of reloading the deck; 'none' always reloads.\n"
+    << "--wake-resume-deck restores full reloads from an in-run restart snapshot.\n"
+    << "--wake-deck generate writes in.wake_gen (+ _runtime.inc, _resume) from the\n"
+    << "  DeckBuilder config: a coarse --deck-grid refined N-fold around the beam,\n"
+    << "  probes averaged over each --sparta-block, and the probe CSVs only every\n"
+    << "  K blocks with --deck-csv-every (default off).\n"
+    << "--wafer-flux shapes the wafer dose with the per-element flux SPARTA\n"
+    << "  averages on waferGrp (this fix) each block, read in-process and mapped\n"
+    << "  onto the GrowthMonitor grid; embedded SPARTA only, 'none' = uniform.\n"
+    << "--wake-pipeline overlaps SPARTA blocks with the leader's ticks, LAG blocks deep.\n"
+    << "--sparta-devices picks each SPARTA rank's GPU by node-local rank\n"
+    << "  (round-robin, explicit map, or CPU only); default keeps GPU 0.\n"
+    << "--wake-adaptive skips SPARTA blocks once the wake probes vary by less than\n"
+    << "  TOL (relative) over N blocks, coupling at most every K-th point.\n"
+    << "--wake-cache serves converged wake responses per (Fwafer_cm2s, mbe_active,\n"
+    << "  deck hash) from a file and stores new ones; --wake-cache-interp bridges\n"
+    << "  flux gaps up to REL (relative) by interpolation.\n"
+    << "--warm-cache starts SPARTA from a cached restart file of the flow after\n"
+    << "  the first K blocks (default 5), keyed by the deck and the files it reads,\n"
+    << "  params.inc, the SPARTA build and the rank count; misses store one.\n"
+    << "--fast-forward jumps over idle gaps of at least N ticks before the next job\n"
+    << "  release once both thermal nodes are within K kelvin of their idle bands;\n"
+    << "  one FastForward row per gap, plus a sample every N ticks with -decimate.\n"
+    << "--orbit-ephemeris serves the orbit from a table of N samples per period.\n"
+    << "--thermal-integrator stable steps the thermal nodes exactly (RC) or with\n"
+    << "  adaptive substeps to within K kelvin (radiative), for large --dt.\n"
+    << "--telemetry publishes each wake-mode tick (scheduler state, thermal, bus and\n"
+    << "  battery, wake probes) into the POSIX shared-memory ring NAME ('auto' =\n"
+    << "  sf_telemetry_<RUN_ID or pid>) of --telemetry-slots records (default 4096);\n"
+    << "  --telemetry-control lets a reader override the controlling job's targets.\n"
+    << "  sftelemetry reads the ring and sends control messages.\n"
+    << "--dataset writes the same per-tick columns, keyed by tick and job, plus the\n"
+    << "  [n_jobs, N, N] wafer dose maps as .npy arrays with a schema.json into DIR\n"
+    << "  ('auto' = <log dir>/dataset), ready for np.load(mmap_mode='r').\n"
+    << "--mission-* set the constant loads of mission mode and how many orbits each\n"
+    << "  MissionOrbits row covers; --mission-validate N first replays N ticks (-1 =\n"
+    << "  one ephemeris period, 0 = skip) on SimulationEngine and stops on a mismatch.\n"
+    << "--sweep-spec expands axes (job_file, solar_efficiency, solar_base_input_W,\n"
+    << "  battery_capacity_Wh, heater_max_draw_W, dt) into members that each run\n"
+    << "  --nticks x --dt seconds; logs go to member_k/ plus a Sweep.csv summary.\n"
+    << "--branch-spec runs a shared prefix for --branch-at ticks, then each branch\n"
+    << "  (other job file or parameters) from its saved state; logs go to prefix/,\n"
+    << "  branch_<name>/ plus a Branch.csv summary. Uses --sweep-threads.\n"
+    << "--farm-jobs lists job files in --sweep-jobs-dir (names, '*'/'?' globs,\n"
+    << "  comma separated); rank 0 hands them to groups of --farm-group-size ranks,\n"
+    << "  each running the wake harness in its own input mirror with logs in\n"
+    << "  <job stem>/, plus a Farm.csv summary. No checkpointing.\n"
+    << "--schedule-cache keeps a compiled <jobs file>.sfsched next to the job file\n"
+    << "  and reuses it while the text is unchanged; --verbose lists every job row.\n"
+    << "--checkpoint-every saves the wake harness (subsystems, scheduler, orbit, log\n"
+    << "  offsets, SPARTA restart file) every N ticks to DIR (default <log dir>/\n"
+    << "  checkpoint); --resume continues an interrupted run from the last one.\n"
+    << "--profile records per-phase timings into trace_r<rank>.json (Chrome/Perfetto)\n"
+    << "  and Profile.csv in the log directory.\n"
+    << "--alloc-report writes heap allocations per tick to Allocs.csv and reports\n"
+    << "  the worst tick after the first --alloc-warmup N (default 10); needs a\n"
+    << "  -DSIM_COUNT_ALLOCS=ON build.\n"
+    << "--watchdog dumps each rank's last --flight-events phase events to\n"
+    << "  flight_r<rank>.txt when a tick runs longer than S seconds (default 600,\n"
+    << "  0 = off), and on SIGABRT/SIGSEGV/SIGTERM/SIGINT and similar signals.\n";
 }
 
 // -----------------------------------------------------------------------------
@@ -633,11 +789,7 @@ int deriveLiveDepositionTicks(const Job& job) {
 // -----------------------------------------------------------------------------
 // params.inc writer
 // -----------------------------------------------------------------------------
-void write_params_inc(double Fwafer_cm2s,
-                      double mbe_active,
-                      int rank,
-                      const std::string& inputDir,
-                      LogFn log_fn) {
+void sanitize_params_inc(double& Fwafer_cm2s, double& mbe_active) {
   if (!std::isfinite(Fwafer_cm2s) || Fwafer_cm2s <= 0.0) {
     Fwafer_cm2s = FWAFFER_FLOOR_CM2S;
   }
@@ -646,6 +798,15 @@ void write_params_inc(double Fwafer_cm2s,
     mbe_active = 0.0;
   }
   mbe_active = (mbe_active > 0.5) ? 1.0 : 0.0;
+}
+
+void write_params_inc(double Fwafer_cm2s,
+                      double mbe_active,
+                      int rank,
+                      const std::string& inputDir,
+                      LogFn log_fn) {
+  SF_PROFILE_SCOPE(ProfileCat::Params, "write_params_inc");
+  sanitize_params_inc(Fwafer_cm2s, mbe_active);
 
   if (rank != 0) {
     return;
@@ -21,6 +21,7 @@ Run (from build/, headless):
 */
 
 #include <mpi.h>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
@@ -31,19 +32,44 @@ Run (from build/, headless):
 #include <limits>
 #include <cmath>
 #include <algorithm>  // for std::clamp
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include <unistd.h>   // getpid
 
 #include "SimulationEngine.hpp"
+#include "StaticEngine.hpp"
 #include "Battery.hpp"
 #include "SolarArray.hpp"
 #include "PowerBus.hpp"
 #include "HeaterBank.hpp"
 #include "WakeChamber.hpp"
+#include "WakeResponseCache.hpp"
 #include "EffusionCell.hpp"
 #include "orbit.hpp"         // simple circular orbit model
 #include "Logger.hpp"        // for Orbit.csv logging
+#include "TickControl.hpp"
 #include "GrowthMonitor.hpp" // wafer dose / heatmap tracker
 #include "helpers.hpp"       // new helpers split from main
 #include "SubstrateHeater.hpp"
+#include "PowerEnsemble.hpp"
+#include "MissionProfile.hpp"
+#include "TelemetryRing.hpp"
+#include "DatasetExport.hpp"
+#include "ParameterSweep.hpp"
+#include "Branching.hpp"
+#include "JobFarm.hpp"
+#include "AllocCounter.hpp"
+#include "LineBuffer.hpp"
+#include "ScheduleCompiler.hpp"
+#include "Scheduler.hpp"
+#include "FastForward.hpp"
+#include "ThermalIntegrator.hpp"
+#include "Checkpoint.hpp"
+#include "DeckBuilder.hpp"
+#include "Profiler.hpp"
+#include "FlightRecorder.hpp"
 
 
 // Bring helper types/functions into local scope
@@ -53,6 +79,7 @@ using SimHelpers::parse_args;
 using SimHelpers::print_usage;
 using SimHelpers::fluxToHeaterPower;
 using SimHelpers::write_params_inc;
+using SimHelpers::sanitize_params_inc;
 using SimHelpers::FWAFFER_FLOOR_CM2S;
 using SimHelpers::LogFn;
 using SimHelpers::PhaseCode;
@@ -155,6 +182,33 @@ static PhaseControlIntent derivePhaseIntent(double raw_job_flux_cm2s,
   return out;
 }
 
+// ---------------------------------------------------------------------------
+// External policy overrides (--telemetry-control, see TelemetryRing.hpp).
+//
+// Applied on top of the recipe intent of the controlling job, so the normal
+// readiness gating, beam semantics and job accounting still apply:
+// - targets replace the recipe targets
+// - control flags switch source / substrate heating on or off
+// - beam permission only matters in growth-like phases with positive flux
+// ---------------------------------------------------------------------------
+static void applyTelemetryControl(PhaseControlIntent& intent, const TelemetryControl& c) {
+  if (c.has(TelemetryControl::SourceControl)) {
+    intent.source_control_on = c.source_control;
+  }
+  if (c.has(TelemetryControl::EffusionTargetK) && std::isfinite(c.effusion_target_K)) {
+    intent.effusion_target_K = c.effusion_target_K;
+  }
+  if (c.has(TelemetryControl::SubstrateControl)) {
+    intent.substrate_control_on = c.substrate_control;
+  }
+  if (c.has(TelemetryControl::SubstrateTargetK) && std::isfinite(c.substrate_target_K)) {
+    intent.substrate_target_K = c.substrate_target_K;
+  }
+  if (c.has(TelemetryControl::BeamAllowed)) {
+    intent.beam_allowed = c.beam_allowed;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Estimate a notional warm-up time for a job based on its requested flux.
 //
@@ -175,6 +229,21 @@ static PhaseControlIntent derivePhaseIntent(double raw_job_flux_cm2s,
 // not for scheduling or deposition-duration accounting.
 // ---------------------------------------------------------------------------
 
+// Settings a checkpoint is only valid for; --resume refuses anything else.
+static std::string checkpointFingerprint(const Args& args, int njobs, std::uint64_t jobsHash) {
+  std::ostringstream oss;
+  oss.precision(17);
+  oss << "mode=" << args.mode
+      << " dt=" << args.dt
+      << " couple_every=" << args.coupleEvery
+      << " sparta_block=" << args.spartaBlock
+      << " thermal=" << args.thermalIntegrator
+      << " ephemeris=" << args.orbitEphemeris
+      << " njobs=" << njobs
+      << " jobs_hash=" << jobsHash;
+  return oss.str();
+}
+
 static int estimateWarmupTicksForFlux(double Fwafer_cm2s, double dt_s) {
   // Same RC constants as in the temp_proxy_K update below.
   const double C_J_PER_K = 800.0; // Was 1000.0
@@ -243,56 +312,12 @@ static int estimateWarmupTicksForFlux(double Fwafer_cm2s, double dt_s) {
 }
 
 // ---------------------------------------------------------------------------
-// Runtime scheduler model
-//
-// Important semantic shift:
-// - jobs.txt start_tick now means "release / eligibility time"
-// - requested beam-on duration is derived from (end_tick - start_tick)
-// - actual prep start / actual deposition start / actual deposition end are
-//   realized at runtime by the scheduler
-//
-// State-code mapping for TrainingState.csv:
-//   0 = pending
-//   1 = queued
-//   2 = warming
-//   3 = cooling
-//   4 = thermal_prep
-//   5 = live_deposition
-//   6 = done
-//   7 = aborted
-//
-// Prep-mode mapping for TrainingState.csv:
+// Prep-mode mapping for TrainingState.csv (job states: see Scheduler.hpp):
 //   0 = none
 //   1 = warmup
 //   2 = cooldown
 //   3 = thermal_prep_mixed
 // ---------------------------------------------------------------------------
-enum class JobRunState {
-  Pending = 0,
-  Queued = 1,
-  Warming = 2,
-  Cooling = 3,
-  ThermalPrep = 4,
-  LiveDeposition = 5,
-  Done = 6,
-  Aborted = 7
-};
-
-static const char* jobRunStateName(JobRunState s) {
-  switch (s) {
-    case JobRunState::Pending:        return "pending";
-    case JobRunState::Queued:         return "queued";
-    case JobRunState::Warming:        return "warming";
-    case JobRunState::Cooling:        return "cooling";
-    case JobRunState::ThermalPrep:    return "thermal_prep";
-    case JobRunState::LiveDeposition: return "live_deposition";
-    case JobRunState::Done:           return "done";
-    case JobRunState::Aborted:        return "aborted";
-    default:                          return "unknown";
-  }
-}
-
-// readable prep labels in the schedule CSV
 static const char* prepModeName(double prep_mode_code) {
   switch (static_cast<int>(prep_mode_code)) {
     case 0: return "none";
@@ -303,110 +328,47 @@ static const char* prepModeName(double prep_mode_code) {
   }
 }
 
-static double jobRunStateCode(JobRunState s) {
-  return static_cast<double>(static_cast<int>(s));
-}
-
-
-struct RuntimeJobState {
-  // Immutable requested plan
-  int    requested_start_tick = 0;
-  int    requested_end_tick = -1;
-
-  // Total scheduled recipe time represented by the row.
-  int    requested_phase_duration_ticks = 0;
-
-  // Beam-on deposition time owed by growth-like rows only.
-  int    requested_live_duration_ticks = 0;
-
-  double requested_flux_cm2s = 0.0;
-  double requested_heater_cap_W = 0.0;
-
-  int    requested_mbe_on = 0;
-  int    requested_substrate_on = 0;
-  PhaseCode requested_phase_code = PhaseCode::IDLE;
-  double requested_substrate_target_K = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
-
-  // Runtime execution state
-  JobRunState state = JobRunState::Pending;
-  bool released_to_queue = false;
-  bool done = false;
-  bool aborted = false;
-
-  // Latched execution semantics for growth-like phases.
-  bool has_started_live_execution = false;
-
-  // Latched when a growth job loses required hold after live execution started.
-  bool live_execution_hold_faulted = false;
-
-  // Realized timeline
-  int actual_queue_enter_tick = -1;
-  int actual_thermal_prep_start_tick = -1;
-  int actual_warmup_start_tick = -1;
-  int actual_cooldown_start_tick = -1;
-
-  // Realized start and end of the recipe phase once thermally executable.
-  int actual_phase_start_tick = -1;
-  int actual_phase_end_tick = -1;
-
-  // Realized beam-on deposition interval for growth-like rows.
-  int actual_deposition_start_tick = -1;
-  int actual_deposition_end_tick = -1;
-
-  // Total recipe phase accounting
-  int phase_ticks_completed = 0;
-  int remaining_phase_ticks = 0;
-
-  // Guaranteed beam-on accounting
-  int live_ticks_completed = 0;
-  int remaining_live_ticks = 0;
-};
 
+// earlier there was a deriveRequestedDurationTicks function but it was deleted because it collapses zero-flux rows to duration 0.
 // ---------------------------------------------------------------------------
-// Find the next positive growth-like flux after the currently controlling row.
-//
-// This gives beam-off pre-growth phases such as SOURCE_DEGAS and SOAK a
-// physically motivated anchor for source thermal conditioning when the current
-// row itself does not carry a meaningful growth flux.
-//
-// If no future growth-like row exists, this returns 0.0 and the helper-side
-// source policy will fall back to its built-in default anchors.
+// One harness run (see runHarness in main): the communicator it runs on, the
+// job file, the log subdirectory its streams go to ("" = the log directory
+// itself) and the progress log, which prints on the run's rank 0.
 // ---------------------------------------------------------------------------
-static double findNextGrowthFluxCm2s(const std::vector<RuntimeJobState>& runtimeJobs,
-                                     int currentIndex) {
-  if (currentIndex < 0) {
-    return 0.0;
-  }
-
-  for (std::size_t idx = static_cast<std::size_t>(currentIndex + 1);
-       idx < runtimeJobs.size();
-       ++idx) {
-    const RuntimeJobState& candidate = runtimeJobs[idx];
-
-    const bool growth_like = isGrowthPhase(candidate.requested_phase_code);
-    const bool beam_enabled = (candidate.requested_mbe_on != 0);
-    const bool flux_valid =
-        std::isfinite(candidate.requested_flux_cm2s) &&
-        candidate.requested_flux_cm2s > 0.0;
-
-    if (growth_like && beam_enabled && flux_valid) {
-      return candidate.requested_flux_cm2s;
-    }
-  }
-
-  return 0.0;
-}
+struct HarnessRun {
+  MPI_Comm    comm = MPI_COMM_WORLD;
+  std::string jobsPath;
+  std::string subdir;
+  LogFn       log;
+};
 
-// earlier there was a deriveRequestedDurationTicks function but it was deleted because it collapses zero-flux rows to duration 0.
 // --------------------------------------------------------- main loop ---------------------------------------------------------
 int main(int argc, char** argv) {
-  MPI_Init(&argc, &argv);
+  Args args = parse_args(argc, argv);
+
+  // Pipelined wake coupling runs SPARTA on worker threads alongside the
+  // main thread's MPI calls, which needs full thread support.
+  // Sweep workers on ranks other than 0 take turns requesting members over
+  // MPI, which needs serialized calls from multiple threads.
+  int mpiThreadProvided = MPI_THREAD_SINGLE;
+  if (args.wakePipelineLag > 0) {
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpiThreadProvided);
+  } else if ((args.mode == "sweep" || args.mode == "branch") && args.sweepThreads > 1) {
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &mpiThreadProvided);
+  } else {
+    MPI_Init(&argc, &argv);
+  }
 
   int rank = 0, size = 1;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
+  Logger::instance().attachComm(MPI_COMM_WORLD);
 
-  Args args = parse_args(argc, argv);
+  // Common epoch across ranks so the per-rank traces line up.
+  if (args.profile) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    Profiler::instance().enable();
+  }
 
   // ------------------------------------------------------------------------
   // Debug logger: mirrors messages to stderr and a per-run file on rank 0.
@@ -423,39 +385,45 @@ int main(int argc, char** argv) {
     }
   };
 
-    // ------------------------------------------------------------------------
-  // Per-rank progress logger for MPI debugging.
-  // Writes one file per rank so we can see where each rank stops.
   // ------------------------------------------------------------------------
-  std::ofstream rankProgressLog;
-  {
-    const char* env_run_id = std::getenv("RUN_ID");
-    std::string run_id     = env_run_id ? env_run_id : "norunid";
-    std::string mode_tag   = args.mode.empty() ? "nomode" : args.mode;
+  // Per-rank flight recorder for MPI debugging (see FlightRecorder.hpp).
+  // Phase marks stay in memory; the watchdog or a fatal signal dumps them to
+  // flight_r<rank>.txt so we can see where each rank stopped.
+  // ------------------------------------------------------------------------
+  FlightRecorder& flight = FlightRecorder::instance();
+  flight.init(rank, static_cast<std::size_t>(std::max(16, args.flightEvents)),
+              Logger::directory());
+  flight.installSignalHandlers();
+  flight.startWatchdog(args.watchdogSeconds);
+
+  auto log_rank_progress = [&](int tick, const char* phase) {
+    flight.mark(tick, phase);
+  };
 
-    std::string rank_filename =
-        "sim_rank_progress_r" + std::to_string(rank) +
-        "_" + run_id + "_" + mode_tag + ".log";
 
-    rankProgressLog.open(rank_filename, std::ios::out | std::ios::app);
-    if (!rankProgressLog) {
-      std::cerr << "[warn] rank " << rank
-                << " failed to open " << rank_filename << " for writing.\n";
-      std::cerr.flush();
+  // Drain the Logger (async writer ring, bin chunks) before MPI goes away and
+  // report writer back-pressure so ring sizing can be tuned.
+  auto flush_logger = [&]() {
+    Logger& lg = Logger::instance();
+    flight.stopWatchdog();
+    if (Profiler::enabled()) {
+      Profiler::instance().write(MPI_COMM_WORLD);
+      log_msg("[profile] wrote trace_r<rank>.json and Profile.csv to " +
+              Logger::directory() + "\n");
     }
-  }
-
-  auto log_rank_progress = [&](int tick, const std::string& phase) {
-    std::ostringstream oss;
-    oss << "[rank " << rank << "] tick=" << tick
-        << " phase=" << phase << "\n";
-
-    std::cerr << oss.str();
-    std::cerr.flush();
-
-    if (rankProgressLog.is_open()) {
-      rankProgressLog << oss.str();
-      rankProgressLog.flush();
+    lg.finishShared();
+    lg.flush();
+    if (lg.asyncEnabled()) {
+      const Logger::Stats st = lg.stats();
+      std::ostringstream oss;
+      oss << "[logger] async rows=" << st.rows_written << "/" << st.rows_pushed
+          << " ring=" << st.ring_capacity
+          << " max_depth=" << st.max_depth
+          << " full_stalls=" << st.ring_full_stalls
+          << " stall_spins=" << st.stall_spins
+          << " sync_fallbacks=" << st.sync_fallbacks
+          << " flushes=" << st.flushes << "\n";
+      log_msg(oss.str());
     }
   };
 
@@ -497,6 +465,16 @@ int main(int argc, char** argv) {
     args.dt = 0.1;
   }
 
+  if (args.tickThreads < 0) {
+    if (rank == 0) log_msg("[warn] tick-threads < 0; running the engine serially.\n");
+    args.tickThreads = 0;
+  }
+
+  if (args.powerAlloc != "inline" && args.powerAlloc != "batched") {
+    if (rank == 0) log_msg("[warn] unknown power-alloc '" + args.powerAlloc + "'; using inline.\n");
+    args.powerAlloc = "inline";
+  }
+
   if (args.coupleEvery <= 0) {
     if (rank == 0) log_msg("[warn] couple-every <= 0; defaulting to 10.\n");
     args.coupleEvery = 10;
@@ -537,569 +515,896 @@ int main(int argc, char** argv) {
       log_msg(oss.str());
     }
 
-// --------------------------------------------------------------------
-    // Load jobs.txt (only rank 0 actually uses it; others just follow MPI)
-    // --------------------------------------------------------------------
-    std::vector<Job> jobs;
-    if (args.mode == "wake" || args.mode == "dual" || args.mode == "legacy") {
-      if (rank == 0) {
-        // 1. Look for the --job-file argument passed from the bash script
-        std::string jobFileName = "V4_job1.txt"; // Fallback default
-        for (int i = 1; i < argc; ++i) {
-            if (std::string(argv[i]) == "--job-file" && i + 1 < argc) {
-                jobFileName = argv[i + 1];
-                break;
-            }
-        }
-
-        // 2. Combine the input directory and the target filename
-        const std::string jobsPath = args.inputDir + "/" + jobFileName;
-        std::ifstream jf(jobsPath);
-        if (!jf) {
-          std::ostringstream oss;
-          oss << "[info] No jobs.txt found at " << jobsPath
-              << " — running with default heater/flux.\n";
-          log_msg(oss.str());
-        } else {
-          std::string line;
-          int lineno = 0;
-          while (std::getline(jf, line)) {
-            ++lineno;
-            if (line.empty()) continue;
-            if (line[0] == '#') continue;
-
-            Job j{};
-            std::string parseErr;
-            if (!parseJobLine(line, j, parseErr)) {
-              std::ostringstream oss;
-              oss << "[warn] jobs.txt line " << lineno
-                  << " malformed, skipping: " << line
-                  << " | reason: " << parseErr << "\n";
-              log_msg(oss.str());
-              continue;
-            }
-            jobs.push_back(j);
-          }
-
-          std::ostringstream oss;
-          oss << "[info] Loaded " << jobs.size() << " job(s) from " << jobsPath << "\n";
-          log_msg(oss.str());
-          for (std::size_t i = 0; i < jobs.size(); ++i) {
-            const Job& j = jobs[i];
-            std::ostringstream joss;
-
-            joss << "  [job " << i
-                << "] ticks " << j.start_tick << "-" << j.end_tick
-                << ", Fwafer=" << j.Fwafer_cm2s
-                << " cm^-2 s^-1, heater_cap=" << j.heater_W
-                << " W, mbe_on=" << j.mbe_on
-                << ", substrate_on=" << j.substrate_on
-                << ", phase=" << phaseCodeName(j.phase_code)
-                << ", substrate_target_K=" << j.substrate_target_K
-                << "\n";
-            log_msg(joss.str());
-          }
-        }
+    // ======================================================================
+    // MODE: ensemble (N power-harness variants, SoA, no SPARTA)
+    // ======================================================================
+    if (args.mode == "ensemble") {
+      std::vector<EnsembleMemberParams> members;
+      if (!args.ensembleSpec.empty()) {
+        members = PowerEnsemble::loadSpec(args.ensembleSpec);
+      } else {
+        members.assign(static_cast<std::size_t>(std::max(1, args.ensembleMembers)),
+                       EnsembleMemberParams{});
       }
-    }
 
-    // Broadcast number of jobs to all ranks (so everyone can make decisions
-    // consistently if needed later).
-    int njobs = static_cast<int>(jobs.size());
-    MPI_Bcast(&njobs, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-    // Per-job dynamic warm-up ticks (leader only actually uses values).
-    std::vector<int> jobWarmupTicks;
-    if (rank == 0 && njobs > 0 &&
-        (args.mode == "wake" || args.mode == "dual" || args.mode == "legacy")) {
-      jobWarmupTicks.resize(jobs.size(), 0);
-      for (std::size_t i = 0; i < jobs.size(); ++i) {
-        const Job& j = jobs[i];
-        int W = estimateWarmupTicksForFlux(j.Fwafer_cm2s, args.dt);
-        jobWarmupTicks[i] = W;
+      // Contiguous slice per rank; member ids stay global.
+      const std::size_t total = members.size();
+      const std::size_t lo = total * static_cast<std::size_t>(rank) / size;
+      const std::size_t hi = total * static_cast<std::size_t>(rank + 1) / size;
+
+      PowerEnsemble ensemble;
+      ensemble.addMembers(std::vector<EnsembleMemberParams>(members.begin() + lo,
+                                                            members.begin() + hi), lo);
+      ensemble.setTickStep(args.dt);
+      ensemble.setLogEvery(args.ensembleLogEvery);
+      ensemble.setSolarScale(1.0);
 
+      if (rank == 0) {
         std::ostringstream oss;
-        oss << "[info] Job " << i
-            << " dynamic warm-up estimate: " << W
-            << " tick(s) at dt=" << args.dt
-            << " s (Fwafer_cm2s=" << j.Fwafer_cm2s << ")\n";
+        oss << "[info] Ensemble: " << total << " member(s) over " << size
+            << " rank(s), nticks=" << args.nticks << " dt=" << args.dt
+            << " log-every=" << std::max(1, args.ensembleLogEvery) << "\n";
         log_msg(oss.str());
       }
-    }
 
-    // Electrical/power subsystems (independent of SPARTA)
-    PowerBus bus;
-    const double SOLAR_EFFICIENCY   = 0.25;
-    const double SOLAR_BASE_INPUT_W = 30000.0; // example boost
+      // The Ensemble* streams are shared: one file per stream under
+      // SF_LOG_BACKEND=mpiio, written every sharedWindow() ticks, otherwise
+      // <stream>_r<rank>.csv per rank.
+      Logger& lg = Logger::instance();
+      ensemble.initialize();
+      for (int i = 0; i < args.nticks; ++i) {
+        ensemble.tick();
+        if (lg.mpiioEnabled() && (i + 1) % lg.sharedWindow() == 0) lg.flushShared();
+      }
 
-    SolarArray solar(SOLAR_EFFICIENCY, SOLAR_BASE_INPUT_W);
-    Battery battery;
+      if (rank == 0) {
+        log_msg("[info] ensemble loop completed.\n");
+      }
 
-    bus.setBattery(&battery);
-    // Bigger heater: can draw up to 2 kW from the bus.
-    HeaterBank    heater(/*maxDraw=*/5000.0);
-    EffusionCell  effCell;
-    GrowthMonitor growth(/*gridN=*/32);
-    SubstrateHeater substrateHeater(/*maxPowerW=*/3000.0, /*wafer_radius_m=*/0.15);
+      flush_logger();
+      MPI_Barrier(MPI_COMM_WORLD);
+      MPI_Finalize();
+      return EXIT_SUCCESS;
+    }
 
-  
-    solar.setPowerBus(&bus);
-    battery.setPowerBus(&bus);
-    heater.setPowerBus(&bus);
-    heater.setEffusionCell(&effCell);     // Heater warms the effusion cell
-    heater.setSubstrateHeater(&substrateHeater); // heater warms up the substrate as well
-    growth.setPowerBus(&bus);             // Film/growth monitor draws instrument power
+    // ======================================================================
+    // MODE: mission (fused power kernel over the orbit, rank 0, no SPARTA)
+    // ======================================================================
+    if (args.mode == "mission") {
+      if (rank == 0) {
+        // Same array, battery and orbit as the wake harness.
+        SolarArray solar(0.25, 30000.0);
+        Battery    battery;
+        OrbitModel orbit(/*altitude_m=*/300e3, /*dt_s=*/args.dt,
+                         /*inclination_rad=*/0.0, /*sun_theta_rad=*/0.0);
+        if (args.orbitEphemeris > 0) {
+          orbit.enableEphemeris(args.orbitEphemeris);
+        }
 
-    // GrowthMonitor should only log + write CSV on leader, but engine tick
-    // will be called on all ranks.
-    growth.setIsLeader(rank == 0);
-    substrateHeater.setIsLeader(rank == 0);
-    growth.setNumJobs(njobs);
+        MissionConfig cfg;
+        cfg.base_load_W    = args.missionBaseLoadW;
+        cfg.payload_W      = args.missionPayloadW;
+        cfg.orbits_per_row = args.missionOrbitsPerRow;
+        MissionProfile mission(solar, battery, orbit, args.dt, cfg);
 
-    /**
-     * old order 
-        engine.addSubsystem(&solar);      // 1) power source
-        engine.addSubsystem(&battery);    // 2) storage update
-        engine.addSubsystem(&heater);     // 3) power load
-        engine.addSubsystem(&substrateHeater);
-        engine.addSubsystem(&effCell);    // 4) heat response (after heater!)
-        engine.addSubsystem(&bus);        // 5) bookkeeping on power totals
-        engine.addSubsystem(&growth);     // 6) sensors/aux
-     * 
-     */
+        {
+          std::ostringstream oss;
+          oss << "[info] Mission: nticks=" << args.nticks << " dt=" << args.dt
+              << " base=" << cfg.base_load_W << " W payload=" << cfg.payload_W
+              << " W, ephemeris " << mission.ephemerisTicks() << " tick(s) over "
+              << mission.ephemerisOrbits() << " orbit(s)\n";
+          log_msg(oss.str());
+        }
 
-    SimulationEngine engine;
+        if (args.missionValidate != 0) {
+          const long n = args.missionValidate < 0
+                             ? static_cast<long>(mission.ephemerisTicks())
+                             : args.missionValidate;
+          const MissionProfile::Check c = mission.validate(n);
+          std::ostringstream oss;
+          oss.precision(17);
+          oss << "[mission] validation: " << c.ticks << " of " << c.requested
+              << " requested tick(s) against SimulationEngine, "
+              << "max |charge diff| = " << c.max_charge_diff_Wh << " Wh, max |solar diff| = "
+              << c.max_solar_diff_W << " W\n";
+          log_msg(oss.str());
+          if (c.max_charge_diff_Wh > 1e-9 * battery.getCapacityWh() ||
+              c.max_solar_diff_W > 1e-9 * solar.getBaseInputW()) {
+            throw std::runtime_error("mission kernel disagrees with SimulationEngine");
+          }
+        }
 
-    // 1) Solar generates power and adds it to the bus early in the tick
-    engine.addSubsystem(&solar);
+        mission.enableLog();
+        const double t0 = MPI_Wtime();
+        mission.run(args.nticks);
+        const double sec = MPI_Wtime() - t0;
 
-    // 2) Loads draw power during the tick
-    engine.addSubsystem(&heater);
+        const MissionSummary m = mission.summary();
+        std::ostringstream oss;
+        oss << "[mission] " << args.nticks << " tick(s) in " << sec << " s ("
+            << (sec > 0.0 ? args.nticks / sec : 0.0) << " ticks/s), " << m.orbits
+            << " orbit(s); min SoC " << m.soc_min << " at tick " << m.soc_min_tick
+            << ", generated " << m.generated_Wh << " Wh, served " << m.served_Wh
+            << " Wh, deficit " << m.deficit_Wh << " Wh over " << m.deficit_ticks
+            << " tick(s) in " << m.deficit_orbits << " orbit(s); final charge "
+            << mission.chargeWh() << " Wh\n";
+        log_msg(oss.str());
+      }
 
-    // 3) These must tick AFTER heater because heater.applyHeat() happens inside HeaterBank::tick()
-    engine.addSubsystem(&substrateHeater);
-    engine.addSubsystem(&effCell);
+      flush_logger();
+      MPI_Barrier(MPI_COMM_WORLD);
+      MPI_Finalize();
+      return EXIT_SUCCESS;
+    }
 
-    // 4) GrowthMonitor draws instrument power (so it MUST be before bus bookkeeping)
-    engine.addSubsystem(&growth);
+    // ======================================================================
+    // MODE: sweep (parameter sweep, one power harness per member)
+    // ======================================================================
+    if (args.mode == "sweep") {
+      std::vector<SweepMemberParams> members;
+      if (!args.sweepSpec.empty()) {
+        members = ParameterSweep::loadSpec(args.sweepSpec, args.sweepJobsDir, args.dt);
+      } else {
+        SweepMemberParams p;
+        p.dt = args.dt;
+        members.push_back(p);
+      }
 
-    // 5) Bus bookkeeping MUST be after all producers/consumers have run
-    engine.addSubsystem(&bus);
+      SweepOptions opt;
+      opt.span_s   = args.nticks * args.dt;
+      opt.jobs_dir = args.sweepJobsDir;
+      opt.threads  = std::max(1, args.sweepThreads);
+      opt.thermal.kind         = parseThermalIntegratorKind(args.thermalIntegrator);
+      opt.thermal.tol_K        = args.thermalTolK;
+      opt.thermal.max_substeps = std::max(1, args.thermalMaxSubsteps);
+      if (size > 1 && opt.threads > 1 && mpiThreadProvided < MPI_THREAD_SERIALIZED) {
+        log_msg("[warn] --sweep-threads needs MPI_THREAD_SERIALIZED; using 1 thread per rank.\n");
+        opt.threads = 1;
+      }
 
-    // 6) Battery logs LAST so it reflects the post-bus charge/discharge state for the tick
-    engine.addSubsystem(&battery);
+      // Members never touch the orbit; same fixed sunlight as power mode.
+      g_orbit_solar_scale = 1.0;
 
+      if (rank == 0) {
+        std::ostringstream oss;
+        oss << "[info] Sweep: " << members.size() << " member(s) over " << size
+            << " rank(s) x " << opt.threads << " thread(s), span=" << opt.span_s << " s\n";
+        log_msg(oss.str());
+      }
 
-    const double dt = args.dt;
-    engine.setTickStep(dt);
-    engine.initialize();
+      const double t0 = MPI_Wtime();
+      const auto results = ParameterSweep::run(MPI_COMM_WORLD, members, opt);
+      if (rank == 0) {
+        ParameterSweep::writeTable(members, results, opt.span_s);
+        std::ostringstream oss;
+        oss << "[sweep] " << results.size() << " member(s) over " << size << " rank(s) x "
+            << opt.threads << " thread(s) in " << (MPI_Wtime() - t0) << " s\n";
+        log_msg(oss.str());
+      }
 
-    if (rank == 0) {
-      std::ostringstream oss;
-      oss << "[info] Simulation starting on " << size << " MPI task(s)\n";
-      oss << "[info] Mode = "          << args.mode        << "\n";
-      oss << "[info] nticks = "        << args.nticks      << "\n";
-      oss << "[info] dt = "            << dt               << " s\n";
-      oss << "[info] couple-every = "  << args.coupleEvery << "\n";
-      oss << "[info] sparta-block = "  << args.spartaBlock << "\n";
-      log_msg(oss.str());
+      flush_logger();
+      MPI_Barrier(MPI_COMM_WORLD);
+      MPI_Finalize();
+      return EXIT_SUCCESS;
     }
 
     // ======================================================================
-    // MODE: power (C++ harness only, no SPARTA / no WakeChamber)
+    // MODE: branch (shared prefix, what-if continuations restored from it)
     // ======================================================================
-    if (args.mode == "power") {
-      
-      if (rank == 0) {
-        log_msg("[info] Entering power-only mode (no SPARTA / no WakeChamber).\n");
+    if (args.mode == "branch") {
+      if (args.branchSpec.empty()) {
+        throw std::runtime_error("--mode branch needs --branch-spec");
+      }
+      SweepMemberParams prefix;
+      const auto branches = BranchRunner::loadSpec(args.branchSpec, args.dt, prefix);
+
+      BranchOptions opt;
+      opt.span_s    = args.nticks * args.dt;
+      opt.fork_tick = args.branchAt;
+      opt.jobs_dir  = args.sweepJobsDir;
+      opt.threads   = std::max(1, args.sweepThreads);
+      opt.thermal.kind         = parseThermalIntegratorKind(args.thermalIntegrator);
+      opt.thermal.tol_K        = args.thermalTolK;
+      opt.thermal.max_substeps = std::max(1, args.thermalMaxSubsteps);
+      if (size > 1 && opt.threads > 1 && mpiThreadProvided < MPI_THREAD_SERIALIZED) {
+        log_msg("[warn] --sweep-threads needs MPI_THREAD_SERIALIZED; using 1 thread per rank.\n");
+        opt.threads = 1;
       }
 
-      // Always treat as sunlit in power-only tests.
       g_orbit_solar_scale = 1.0;
 
-      const int NTICKS = args.nticks;
-      for (int i = 0; i < NTICKS; ++i) {
-        const int tickIndex = i + 1;
-        const double t_phys = tickIndex * dt;
-
-        if (rank == 0) {
-          std::ostringstream oss;
-          oss << "[power] tick=" << tickIndex
-              << " t=" << t_phys << " s : calling engine.tick()\n";
-          log_msg(oss.str());
-        }
-
-        
-        heater.setEffusionDemand(1500.0);
-        heater.setSubstrateDemand(0.0);
-        heater.setPrioritySubstrate(false);
-        // No jobs in power-only mode -> growth monitor gets jobIndex=-1, mbeOff.
-        growth.setBeamState(-1, false, 0.0);
-        engine.tick();
-        MPI_Barrier(MPI_COMM_WORLD);
+      if (rank == 0) {
+        std::ostringstream oss;
+        oss << "[info] Branch: " << branches.size() << " branch(es) from a " << opt.fork_tick
+            << "-tick prefix over " << size << " rank(s) x " << opt.threads
+            << " thread(s), span=" << opt.span_s << " s\n";
+        log_msg(oss.str());
       }
 
+      const double t0 = MPI_Wtime();
+      double prefixWall = 0.0;
+      const auto results = BranchRunner::run(MPI_COMM_WORLD, prefix, branches, opt, prefixWall);
       if (rank == 0) {
-        log_msg("[info] power-only loop completed; shutting down engine.\n");
+        BranchRunner::writeTable(branches, results, opt);
+        std::ostringstream oss;
+        oss << "[branch] prefix " << opt.fork_tick << " tick(s) in " << prefixWall << " s; "
+            << results.size() << " branch(es) in " << (MPI_Wtime() - t0) << " s; "
+            << (static_cast<long>(results.size()) - 1) * opt.fork_tick
+            << " prefix tick(s) not re-run\n";
+        log_msg(oss.str());
       }
 
-      engine.shutdown();
+      flush_logger();
       MPI_Barrier(MPI_COMM_WORLD);
       MPI_Finalize();
       return EXIT_SUCCESS;
     }
 
     // ======================================================================
-    // MODE: legacy / wake / dual (all are wake-only now, harness-driven)
+    // One harness run (power / wake / dual / legacy) on run.comm: schedule,
+    // subsystems, engine and, in the wake modes, the WakeChamber and tick
+    // loop. The plain modes run it once on MPI_COMM_WORLD; --mode farm runs
+    // it once per job file on every rank group. Everything it builds is
+    // local to the call, so one process can run several jobs back to back.
     // ======================================================================
-    if (args.mode == "legacy" || args.mode == "wake" || args.mode == "dual") {
-      if (rank == 0 && args.mode == "dual") {
-        log_msg("[info] dual mode selected; using wake-only path (no effusion deck).\n");
-      }
+    auto runHarness = [&](const HarnessRun& run, Args args) {
+      int rank = 0, size = 1;
+      MPI_Comm_rank(run.comm, &rank);
+      MPI_Comm_size(run.comm, &size);
+      const LogFn& log_msg = run.log;
+
+      // This run's streams (and GrowthMonitor files) go to run.subdir/.
+      std::optional<Logger::ScopedPrefix> logScope;
+      if (!run.subdir.empty()) logScope.emplace(run.subdir + "/");
+      g_underflux_streak_for_log = 0;
+      g_temp_miss_streak_for_log = 0;
+
+      // --------------------------------------------------------------------
+      // Load jobs.txt on rank 0 (through the compiled schedule cache), then
+      // broadcast the rows so every rank holds the same schedule.
+      // --------------------------------------------------------------------
+      std::vector<Job> jobs;
+      std::uint64_t jobsHash = 0;   // rank 0: source text hash, for --resume
+      if (args.mode == "wake" || args.mode == "dual" || args.mode == "legacy") {
+        if (rank == 0) {
+          const std::string& jobsPath = run.jobsPath;
+          const CompiledSchedule sched = ScheduleCompiler::load(
+              jobsPath, parseScheduleCacheMode(args.scheduleCache), log_msg);
+          if (!sched.found) {
+            std::ostringstream oss;
+            oss << "[info] No jobs.txt found at " << jobsPath
+                << " — running with default heater/flux.\n";
+            log_msg(oss.str());
+          } else {
+            jobs = sched.jobs;
+            jobsHash = sched.source_hash;
 
-      // Seed params.inc BEFORE the first SPARTA deck load.
-      double initial_Fwafer = FWAFFER_FLOOR_CM2S;
-      if (rank == 0 && !jobs.empty()) {
-        // Seed SPARTA with a legal positive mixture flux.
-        // This is NOT a statement that physical deposition is active.
-        double first_raw_flux = jobs.front().Fwafer_cm2s;
-        if (std::isfinite(first_raw_flux) && first_raw_flux > 0.0) {
-          initial_Fwafer = first_raw_flux;
-        } else {
-          initial_Fwafer = FWAFFER_FLOOR_CM2S;
+            std::ostringstream oss;
+            oss << "[info] Loaded " << jobs.size() << " job(s) from " << jobsPath
+                << (sched.from_cache ? " (compiled cache)" : "")
+                << ", rows=" << sched.rows_read << " skipped=" << sched.rows_skipped;
+            if (!jobs.empty()) {
+              oss << ", ticks " << jobs.front().start_tick << "-" << jobs.back().end_tick;
+            }
+            oss << "\n";
+            log_msg(oss.str());
+
+            if (args.verbose) {
+              for (std::size_t i = 0; i < jobs.size(); ++i) {
+                const Job& j = jobs[i];
+                std::ostringstream joss;
+
+                joss << "  [job " << i
+                    << "] ticks " << j.start_tick << "-" << j.end_tick
+                    << ", Fwafer=" << j.Fwafer_cm2s
+                    << " cm^-2 s^-1, heater_cap=" << j.heater_W
+                    << " W, mbe_on=" << j.mbe_on
+                    << ", substrate_on=" << j.substrate_on
+                    << ", phase=" << phaseCodeName(j.phase_code)
+                    << ", substrate_target_K=" << j.substrate_target_K
+                    << "\n";
+                log_msg(joss.str());
+              }
+            }
+          }
         }
       }
 
-      // Broadcast initial flux to all ranks so they agree
-      MPI_Bcast(&initial_Fwafer, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-      // Beam off initially (mbe_active = 0), but flux positive so mixture is legal
-      double last_Fwafer_sent = std::numeric_limits<double>::quiet_NaN();
-      double last_mbe_sent    = std::numeric_limits<double>::quiet_NaN(); 
-      
-      log_rank_progress(0, "before-initial-write_params_inc");
-      write_params_inc(initial_Fwafer, 0.0, rank, args.inputDir, log_msg);
-      log_rank_progress(0, "after-initial-write_params_inc");
+      // Every rank gets the full schedule so decisions can be made consistently.
+      ScheduleCompiler::broadcast(jobs, 0, run.comm);
+      const int njobs = static_cast<int>(jobs.size());
 
-      last_Fwafer_sent = initial_Fwafer;
-      last_mbe_sent    = 0.0;
+      // Per-job dynamic warm-up ticks (leader only actually uses values).
+      std::vector<int> jobWarmupTicks;
+      if (rank == 0 && njobs > 0 &&
+          (args.mode == "wake" || args.mode == "dual" || args.mode == "legacy")) {
+        jobWarmupTicks.resize(jobs.size(), 0);
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+          const Job& j = jobs[i];
+          int W = estimateWarmupTicksForFlux(j.Fwafer_cm2s, args.dt);
+          jobWarmupTicks[i] = W;
 
-      if (rank == 0) {
-        log_msg("[info] Constructing WakeChamber and calling wake.init(...)\n");
+          std::ostringstream oss;
+          oss << "[info] Job " << i
+              << " dynamic warm-up estimate: " << W
+              << " tick(s) at dt=" << args.dt
+              << " s (Fwafer_cm2s=" << j.Fwafer_cm2s << ")\n";
+          log_msg(oss.str());
+        }
       }
 
-      WakeChamber wake(MPI_COMM_WORLD, "WakeChamber");
-      log_rank_progress(0, "before-wake-init");
-      wake.init(args.wakeDeck.c_str(), args.inputDir.c_str());
-      log_rank_progress(0, "after-wake-init");
+      // Electrical/power subsystems (independent of SPARTA)
+      PowerBus bus;
+      const double SOLAR_EFFICIENCY   = 0.25;
+      const double SOLAR_BASE_INPUT_W = 30000.0; // example boost
 
+      SolarArray solar(SOLAR_EFFICIENCY, SOLAR_BASE_INPUT_W);
+      Battery battery;
 
-      if (rank == 0) {
-        log_msg("[info] wake.init() returned; entering main wake loop.\n");
+      bus.setBattery(&battery);
+      // Bigger heater: can draw up to 2 kW from the bus.
+      HeaterBank    heater(/*maxDraw=*/5000.0);
+      EffusionCell  effCell;
+      GrowthMonitor growth(/*gridN=*/32);
+      SubstrateHeater substrateHeater(/*maxPowerW=*/3000.0, /*wafer_radius_m=*/0.15);
+
+  
+      solar.setPowerBus(&bus);
+      battery.setPowerBus(&bus);
+      heater.setPowerBus(&bus);
+      heater.setEffusionCell(&effCell);     // Heater warms the effusion cell
+      heater.setSubstrateHeater(&substrateHeater); // heater warms up the substrate as well
+      growth.setPowerBus(&bus);             // Film/growth monitor draws instrument power
+
+      // GrowthMonitor should only log + write CSV on leader, but engine tick
+      // will be called on all ranks.
+      growth.setIsLeader(rank == 0);
+      substrateHeater.setIsLeader(rank == 0);
+      growth.setNumJobs(njobs);
+      growth.setOutputSubdir(run.subdir);
+
+      ThermalIntegratorConfig thermalCfg;
+      thermalCfg.kind         = parseThermalIntegratorKind(args.thermalIntegrator);
+      thermalCfg.tol_K        = args.thermalTolK;
+      thermalCfg.max_substeps = std::max(1, args.thermalMaxSubsteps);
+      effCell.setThermalIntegrator(thermalCfg);
+      substrateHeater.setThermalIntegrator(thermalCfg);
+
+      /**
+       * old order 
+          engine.addSubsystem(&solar);      // 1) power source
+          engine.addSubsystem(&battery);    // 2) storage update
+          engine.addSubsystem(&heater);     // 3) power load
+          engine.addSubsystem(&substrateHeater);
+          engine.addSubsystem(&effCell);    // 4) heat response (after heater!)
+          engine.addSubsystem(&bus);        // 5) bookkeeping on power totals
+          engine.addSubsystem(&growth);     // 6) sensors/aux
+       * 
+       */
+
+      SimulationEngine engine;
+
+      // 1) Solar generates power and adds it to the bus early in the tick
+      engine.addSubsystem(&solar);
+
+      // 2) Loads draw power during the tick
+      engine.addSubsystem(&heater);
+
+      // 3) These must tick AFTER heater because heater.applyHeat() happens inside HeaterBank::tick()
+      engine.addSubsystem(&substrateHeater);
+      engine.addSubsystem(&effCell);
+
+      // 4) GrowthMonitor draws instrument power (so it MUST be before bus bookkeeping)
+      engine.addSubsystem(&growth);
+
+      // 5) Bus bookkeeping MUST be after all producers/consumers have run
+      engine.addSubsystem(&bus);
+
+      // 6) Battery logs LAST so it reflects the post-bus charge/discharge state for the tick
+      engine.addSubsystem(&battery);
+
+
+      const double dt = args.dt;
+      engine.setTickStep(dt);
+      engine.setTickThreads(args.tickThreads);
+      engine.setPowerAllocation(args.powerAlloc == "batched"
+                                    ? SimulationEngine::PowerAllocation::Batched
+                                    : SimulationEngine::PowerAllocation::Inline);
+
+      // Power mode can run the same subsystems through StaticEngine instead.
+      const bool useStaticEngine = (args.mode == "power" && args.engine == "static");
+
+      // ---------------- checkpoint / restart (wake modes) ----------------
+      // Every rank reads the checkpoint (the run directory is shared, like
+      // the input directory). Rank 0 checks it belongs to this configuration
+      // and rolls the log files back to the checkpoint before anything is
+      // logged; the rebuilt subsystems' start-up rows are dropped.
+      const bool wakeModeRun = (args.mode == "wake" || args.mode == "dual" || args.mode == "legacy");
+      const std::string ckptDir = std::filesystem::absolute(
+          args.checkpointDir.empty()
+              ? std::filesystem::path(Logger::directory()) / "checkpoint"
+              : std::filesystem::path(args.checkpointDir)).string();
+      const std::string ckptFile = ckptDir + "/harness.ckpt";
+      const std::string runFingerprint = checkpointFingerprint(args, njobs, jobsHash);
+
+      CheckpointReader resumeCkpt;
+      bool resuming = false;
+      if ((args.resume || args.checkpointEvery > 0) && !wakeModeRun && rank == 0) {
+        log_msg("[warn] --checkpoint-every / --resume only apply to wake modes; ignoring.\n");
       }
+      if (args.resume && wakeModeRun) {
+        resumeCkpt.open(ckptFile);
+        if (rank == 0) {
+          if (resumeCkpt.getText("resume.fingerprint") != runFingerprint) {
+            throw std::runtime_error("--resume: " + ckptFile + " was written by another configuration (" +
+                                     resumeCkpt.getText("resume.fingerprint") + " vs " + runFingerprint + ")");
+          }
+          std::map<std::string, std::uint64_t> offsets;
+          for (const std::string& key : resumeCkpt.keys("log.")) {
+            offsets[key.substr(4)] = static_cast<std::uint64_t>(resumeCkpt.getInt(key));
+          }
+          Logger::instance().resumeAppend(offsets);
 
-      int worldrank = 0;
-      MPI_Comm_rank(MPI_COMM_WORLD, &worldrank);
-      const bool isLeader = (worldrank == 0);
+          std::ostringstream oss;
+          oss << "[ckpt] resuming from " << ckptFile << " after tick "
+              << resumeCkpt.getInt("resume.next_i") << " (" << offsets.size() << " log file(s) rolled back)\n";
+          log_msg(oss.str());
+        }
+        resuming = true;
+      }
 
-      // ---------------- Orbit model (leader drives logging + SolarArray) ---
-      // Simple circular LEO at 300 km altitude, time step = dt (engine tick).
-      OrbitModel orbit(/*altitude_m=*/300e3,
-                       /*dt_s=*/dt,
-                       /*inclination_rad=*/0.0,
-                       /*sun_theta_rad=*/0.0);
+      if (!useStaticEngine) {
+        std::optional<Logger::ScopedDiscard> quiet;
+        if (resuming) quiet.emplace();
+        engine.initialize();
+      }
 
-      if (isLeader) {
+      if (rank == 0) {
         std::ostringstream oss;
-        oss << "[orbit] altitude_m=300000, period_s=" << orbit.period_s()
-            << " (~" << orbit.period_s() / 60.0 << " min)\n";
+        oss << "[info] Simulation starting on " << size << " MPI task(s)\n";
+        oss << "[info] Mode = "          << args.mode        << "\n";
+        oss << "[info] nticks = "        << args.nticks      << "\n";
+        oss << "[info] dt = "            << dt               << " s\n";
+        oss << "[info] couple-every = "  << args.coupleEvery << "\n";
+        oss << "[info] sparta-block = "  << args.spartaBlock << "\n";
+        oss << "[info] tick-threads = "  << args.tickThreads << "\n";
+        oss << "[info] power-alloc = "   << (useStaticEngine ? "inline (static engine)" : args.powerAlloc) << "\n";
+        if (args.mode == "power") {
+          oss << "[info] engine = "      << (useStaticEngine ? "static" : "dynamic") << "\n";
+        }
         log_msg(oss.str());
       }
 
-      // Track which job and parameters are currently active (leader only).
-      // -------------------------------------------------------------------
-      // Single-owner runtime scheduler state (leader only)
-      //
-      // Important:
-      // - jobs.txt controls only release/eligibility time
-      // - exactly one controlling job may own the effusion/substrate targets
-      //   and SPARTA beam semantics at a time
-      // - later released jobs wait in queue until the current controller is
-      //   done or aborted
-      // -------------------------------------------------------------------
-      std::vector<RuntimeJobState> runtimeJobs;
-      runtimeJobs.reserve(jobs.size());
-
-      for (std::size_t i = 0; i < jobs.size(); ++i) {
-        const Job& j = jobs[i];
-
-        RuntimeJobState rj;
-
-        // Copy the immutable schedule request into runtime state.
-        rj.requested_start_tick         = j.start_tick;
-        rj.requested_end_tick           = j.end_tick;
-        rj.requested_phase_duration_ticks = derivePhaseDurationTicks(j);
-        rj.requested_live_duration_ticks  = deriveLiveDepositionTicks(j);
-
-        rj.requested_flux_cm2s          = j.Fwafer_cm2s;
-        rj.requested_heater_cap_W       = j.heater_W;
-        rj.requested_mbe_on             = j.mbe_on;
-        rj.requested_substrate_on       = j.substrate_on;
-        rj.requested_phase_code         = j.phase_code;
-        rj.requested_substrate_target_K = j.substrate_target_K;
-
-        // Phase time and live deposition time are tracked separately.
-        // Non-growth timed phases can now persist even when live deposition owed is zero.
-        rj.remaining_phase_ticks = rj.requested_phase_duration_ticks;
-        rj.remaining_live_ticks  = rj.requested_live_duration_ticks;
-
-        runtimeJobs.push_back(rj);
+      // Heap allocations per tick (--alloc-report, rank 0's process).
+      std::optional<AllocTickMeter> allocMeter;
+      if (args.allocReport) {
+        if (!AllocCounter::compiled() && rank == 0) {
+          log_msg("[warn] --alloc-report: this build does not count allocations (-DSIM_COUNT_ALLOCS=ON); Allocs.csv reads zero.\n");
+        }
+        allocMeter.emplace(args.allocWarmup);
       }
+      auto reportAllocs = [&]() {
+        if (!allocMeter || rank != 0) return;
+        std::ostringstream oss;
+        oss << "[alloc] steady-state ticks=" << allocMeter->steadyTicks()
+            << " allocating=" << allocMeter->steadyAllocTicks()
+            << " max_per_tick=" << allocMeter->steadyMax();
+        if (allocMeter->steadyMaxTick() >= 0) oss << " (tick " << allocMeter->steadyMaxTick() << ")";
+        oss << "\n";
+        log_msg(oss.str());
+      };
 
-      // Which job currently owns the thermal targets / beam state?
-      int controllingJobIndex = -1;
-
-      // Cached logging values
-      double last_heater_set    = std::numeric_limits<double>::quiet_NaN();
-      double last_effusion_set  = std::numeric_limits<double>::quiet_NaN();
-      double last_substrate_set = std::numeric_limits<double>::quiet_NaN();
-
-      // Health tracking for the CURRENT controlling deposition job only.
-      int   underflux_streak           = 0;
-      int   temp_miss_streak           = 0;
-      const int    UNDERFLUX_LIMIT_TICKS   = 20;
-      const double MIN_FLUX_FRACTION       = 0.90;
-      const int    TEMP_FAIL_LIMIT_TICKS   = 20;
-      const double TEMP_TOLERANCE_FRACTION = 0.85;
-
-      // RC temp proxy (mirrors EffusionCell RC constants) used for a
-      // conservative temperature-health gate.
-      double temp_proxy_K = 300.0;
-
-            auto emitPostAccountingLogs =
-          [&](int tickIndex,
-              double t_phys,
-              int controllingJobIndex_snapshot,
-              double raw_job_flux_cm2s_snapshot,
-              double sparta_flux_cm2s_snapshot,
-              bool deposition_requested_snapshot,
-              double effusionDemand_W_snapshot,
-              double substrateDemand_W_snapshot,
-              double target_T_K_snapshot,
-              double scheduler_substrate_target_K_log_snapshot,
-              double phase_ready_for_execution_log_snapshot,
-              double mbe_flag_snapshot,
-              bool effusion_ready_snapshot,
-              bool wafer_ready_snapshot) {
-
-        int log_job_index = controllingJobIndex_snapshot;
-
-        double scheduler_state_code_log = jobRunStateCode(JobRunState::Pending);
-        double prep_mode_code = 0.0;
-
-        double requested_start_tick_log           = -1.0;
-        double requested_end_tick_log             = -1.0;
-        double requested_phase_duration_ticks_log = 0.0;
-        double requested_live_duration_ticks_log  = 0.0;
-
-        double actual_queue_enter_tick_log        = -1.0;
-        double actual_thermal_prep_start_log      = -1.0;
-        double actual_warmup_start_tick_log       = -1.0;
-        double actual_cooldown_start_tick_log     = -1.0;
-        double actual_phase_start_tick_log        = -1.0;
-        double actual_phase_end_tick_log          = -1.0;
-        double actual_deposition_start_tick_log   = -1.0;
-        double actual_deposition_end_tick_log     = -1.0;
-
-        double phase_ticks_completed_log          = 0.0;
-        double remaining_phase_ticks_log          = 0.0;
-        double live_ticks_completed_log           = 0.0;
-        double remaining_live_ticks_log           = 0.0;
-        double delay_from_requested_start_log     = 0.0;
-
-        double phase_code_log                     = static_cast<double>(static_cast<int>(PhaseCode::IDLE));
-        double mbe_on_log                         = 0.0;
-        double substrate_on_log                   = 0.0;
-
-        double queued_active       = 0.0;
-        double warmup_active       = 0.0;
-        double cooldown_active     = 0.0;
-        double thermal_prep_active = 0.0;
-        double live_active         = 0.0;
-        double done_active         = 0.0;
-        double aborted_active      = 0.0;
-
-        std::string phase_name_log = "NONE";
-
-        if (log_job_index >= 0 &&
-            log_job_index < static_cast<int>(runtimeJobs.size())) {
-          const RuntimeJobState& rj = runtimeJobs[log_job_index];
-
-          scheduler_state_code_log = jobRunStateCode(rj.state);
-
-          requested_start_tick_log           = static_cast<double>(rj.requested_start_tick);
-          requested_end_tick_log             = static_cast<double>(rj.requested_end_tick);
-          requested_phase_duration_ticks_log = static_cast<double>(rj.requested_phase_duration_ticks);
-          requested_live_duration_ticks_log  = static_cast<double>(rj.requested_live_duration_ticks);
-
-          actual_queue_enter_tick_log        = static_cast<double>(rj.actual_queue_enter_tick);
-          actual_thermal_prep_start_log      = static_cast<double>(rj.actual_thermal_prep_start_tick);
-          actual_warmup_start_tick_log       = static_cast<double>(rj.actual_warmup_start_tick);
-          actual_cooldown_start_tick_log     = static_cast<double>(rj.actual_cooldown_start_tick);
-          actual_phase_start_tick_log        = static_cast<double>(rj.actual_phase_start_tick);
-          actual_phase_end_tick_log          = static_cast<double>(rj.actual_phase_end_tick);
-          actual_deposition_start_tick_log   = static_cast<double>(rj.actual_deposition_start_tick);
-          actual_deposition_end_tick_log     = static_cast<double>(rj.actual_deposition_end_tick);
-
-          phase_ticks_completed_log          = static_cast<double>(rj.phase_ticks_completed);
-          remaining_phase_ticks_log          = static_cast<double>(rj.remaining_phase_ticks);
-          live_ticks_completed_log           = static_cast<double>(rj.live_ticks_completed);
-          remaining_live_ticks_log           = static_cast<double>(rj.remaining_live_ticks);
-
-          phase_code_log                     = static_cast<double>(static_cast<int>(rj.requested_phase_code));
-          mbe_on_log                         = static_cast<double>(rj.requested_mbe_on);
-          substrate_on_log                   = static_cast<double>(rj.requested_substrate_on);
-          phase_name_log                     = phaseCodeName(rj.requested_phase_code);
-
-          if (rj.actual_phase_start_tick >= 0) {
-            delay_from_requested_start_log =
-                static_cast<double>(rj.actual_phase_start_tick - rj.requested_start_tick);
-          } else if (rj.actual_deposition_start_tick >= 0) {
-            delay_from_requested_start_log =
-                static_cast<double>(rj.actual_deposition_start_tick - rj.requested_start_tick);
-          } else {
-            delay_from_requested_start_log =
-                static_cast<double>(tickIndex - rj.requested_start_tick);
+      // ======================================================================
+      // MODE: power (C++ harness only, no SPARTA / no WakeChamber)
+      // ======================================================================
+      if (args.mode == "power") {
+      
+        if (rank == 0) {
+          log_msg("[info] Entering power-only mode (no SPARTA / no WakeChamber).\n");
+        }
+
+        // Always treat as sunlit in power-only tests.
+        g_orbit_solar_scale = 1.0;
+
+        // Same subsystems and per-phase order as the addSubsystem() calls above.
+        StaticEngine<SolarArray, HeaterBank, SubstrateHeater, EffusionCell,
+                     GrowthMonitor, PowerBus, Battery>
+            staticEngine(solar, heater, substrateHeater, effCell, growth, bus, battery);
+        if (useStaticEngine) {
+          staticEngine.setTickStep(dt);
+          staticEngine.initialize();
+        }
+
+        const int NTICKS = args.nticks;
+        LineBuffer line;
+        for (int i = 0; i < NTICKS; ++i) {
+          const int tickIndex = i + 1;
+          const double t_phys = tickIndex * dt;
+          AllocTickMeter::Scope allocScope(allocMeter ? &*allocMeter : nullptr, tickIndex, t_phys);
+
+          log_rank_progress(tickIndex, "power-tick");
+
+          if (rank == 0) {
+            LineBuffer& oss = line.clear();
+            oss << "[power] tick=" << tickIndex
+                << " t=" << t_phys << " s : calling engine.tick()\n";
+            log_msg(oss.str());
           }
 
-          queued_active       = (rj.state == JobRunState::Queued) ? 1.0 : 0.0;
-          warmup_active       = (rj.state == JobRunState::Warming) ? 1.0 : 0.0;
-          cooldown_active     = (rj.state == JobRunState::Cooling) ? 1.0 : 0.0;
-          thermal_prep_active = (rj.state == JobRunState::ThermalPrep) ? 1.0 : 0.0;
-          live_active         = (rj.state == JobRunState::LiveDeposition) ? 1.0 : 0.0;
-          done_active         = (rj.state == JobRunState::Done) ? 1.0 : 0.0;
-          aborted_active      = (rj.state == JobRunState::Aborted) ? 1.0 : 0.0;
-
-          if (rj.state == JobRunState::Warming) {
-            prep_mode_code = 1.0;
-          } else if (rj.state == JobRunState::Cooling) {
-            prep_mode_code = 2.0;
-          } else if (rj.state == JobRunState::ThermalPrep &&
-                     phase_ready_for_execution_log_snapshot <= 0.5) {
-            prep_mode_code = 3.0;
+        
+          heater.setEffusionDemand(1500.0);
+          heater.setSubstrateDemand(0.0);
+          heater.setPrioritySubstrate(false);
+          // No jobs in power-only mode -> growth monitor gets jobIndex=-1, mbeOff.
+          growth.setBeamState(-1, false, 0.0);
+          if (useStaticEngine) {
+            staticEngine.tick();
           } else {
-            prep_mode_code = 0.0;
+            engine.tick();
           }
-        }
-
-        Logger::instance().log_wide(
-          "ScheduleState",
-          tickIndex,
-          t_phys,
           {
-            "controlling_job_index",
-            "scheduler_state_code",
-            "prep_mode_code",
+            SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Barrier(power.tick)");
+            FlightScope flightBarrier("MPI_Barrier(power.tick)");
+            MPI_Barrier(run.comm);
+          }
+        }
 
-            "requested_start_tick",
-            "requested_end_tick",
-            "requested_phase_duration_ticks",
-            "requested_live_duration_ticks",
+        reportAllocs();
+        if (rank == 0) {
+          log_msg("[info] power-only loop completed; shutting down engine.\n");
+        }
 
-            "actual_queue_enter_tick",
-            "actual_thermal_prep_start_tick",
-            "actual_warmup_start_tick",
-            "actual_cooldown_start_tick",
-            "actual_phase_start_tick",
-            "actual_phase_end_tick",
-            "actual_deposition_start_tick",
-            "actual_deposition_end_tick",
+        if (useStaticEngine) {
+          staticEngine.shutdown();
+        } else {
+          engine.shutdown();
+        }
+        return;
+      }
 
-            "phase_ticks_completed",
-            "remaining_phase_ticks",
-            "live_ticks_completed",
-            "remaining_live_ticks",
-            "delay_from_requested_start",
+      // ======================================================================
+      // MODE: legacy / wake / dual (all are wake-only now, harness-driven)
+      // ======================================================================
+      if (args.mode == "legacy" || args.mode == "wake" || args.mode == "dual") {
+        if (rank == 0 && args.mode == "dual") {
+          log_msg("[info] dual mode selected; using wake-only path (no effusion deck).\n");
+        }
 
-            "phase_code",
-            "mbe_on",
-            "substrate_on",
-            "phase_ready_for_execution",
+        // Seed params.inc BEFORE the first SPARTA deck load.
+        double initial_Fwafer = FWAFFER_FLOOR_CM2S;
+        if (rank == 0 && !jobs.empty()) {
+          // Seed SPARTA with a legal positive mixture flux.
+          // This is NOT a statement that physical deposition is active.
+          double first_raw_flux = jobs.front().Fwafer_cm2s;
+          if (std::isfinite(first_raw_flux) && first_raw_flux > 0.0) {
+            initial_Fwafer = first_raw_flux;
+          } else {
+            initial_Fwafer = FWAFFER_FLOOR_CM2S;
+          }
+        }
 
-            "queued_active",
-            "warmup_active",
-            "cooldown_active",
-            "thermal_prep_active",
-            "live_active",
-            "done_active",
-            "aborted_active",
+        // Broadcast initial flux to all ranks so they agree
+        MPI_Bcast(&initial_Fwafer, 1, MPI_DOUBLE, 0, run.comm);
 
-            "deposition_requested",
-            "mbe_flag"
-          },
-          {
-            static_cast<double>(log_job_index),
-            scheduler_state_code_log,
-            prep_mode_code,
-
-            requested_start_tick_log,
-            requested_end_tick_log,
-            requested_phase_duration_ticks_log,
-            requested_live_duration_ticks_log,
-
-            actual_queue_enter_tick_log,
-            actual_thermal_prep_start_log,
-            actual_warmup_start_tick_log,
-            actual_cooldown_start_tick_log,
-            actual_phase_start_tick_log,
-            actual_phase_end_tick_log,
-            actual_deposition_start_tick_log,
-            actual_deposition_end_tick_log,
-
-            phase_ticks_completed_log,
-            remaining_phase_ticks_log,
-            live_ticks_completed_log,
-            remaining_live_ticks_log,
-            delay_from_requested_start_log,
-
-            phase_code_log,
-            mbe_on_log,
-            substrate_on_log,
-            phase_ready_for_execution_log_snapshot,
-
-            queued_active,
-            warmup_active,
-            cooldown_active,
-            thermal_prep_active,
-            live_active,
-            done_active,
-            aborted_active,
-
-            deposition_requested_snapshot ? 1.0 : 0.0,
-            mbe_flag_snapshot
+        // Beam off initially (mbe_active = 0), but flux positive so mixture is legal
+        double last_Fwafer_sent = std::numeric_limits<double>::quiet_NaN();
+        double last_mbe_sent    = std::numeric_limits<double>::quiet_NaN(); 
+      
+        double initial_mbe = 0.0;
+        if (resuming) {
+          // The deck (and the restart file) load with the beam the
+          // interrupted run last sent.
+          const std::vector<double> sent = resumeCkpt.getDoubles("loop.params_sent");
+          if (sent.size() == 2) {
+            initial_Fwafer = sent[0];
+            initial_mbe    = sent[1];
           }
-        );
+        }
 
-        Logger::instance().log_wide(
-          "ScheduleStateText",
-          tickIndex,
-          t_phys,
-          std::vector<std::string>{
-            "scheduler_state_name",
-            "prep_mode_name",
-            "phase_name"
-          },
-          std::vector<std::string>{
-            jobRunStateName(static_cast<JobRunState>(static_cast<int>(scheduler_state_code_log))),
-            prepModeName(prep_mode_code),
-            phase_name_log
+        log_rank_progress(0, "before-initial-write_params_inc");
+        write_params_inc(initial_Fwafer, initial_mbe, rank, args.inputDir, log_msg);
+        log_rank_progress(0, "after-initial-write_params_inc");
+
+        last_Fwafer_sent = initial_Fwafer;
+        last_mbe_sent    = initial_mbe;
+
+        // --wake-deck generate: rank 0 writes the deck for this run's grid and
+        // coupling cadence before any rank loads it.
+        std::string wakeRuntimeInclude = "wake_runtime.inc";
+        std::string generatedResumeDeck;
+        if (args.wakeDeck == "generate") {
+          WakeDeckConfig deckCfg = WakeDeckConfig::harnessDefaults();
+          deckCfg.block_steps      = args.spartaBlock;
+          deckCfg.ticks_per_block  = args.coupleEvery;
+          deckCfg.dt_tick_s        = args.dt;
+          deckCfg.csv_every_blocks = args.deckCsvEvery;
+          deckCfg.refine.front().cells = args.deckRefine;
+          if (!args.deckGrid.empty()) {
+            char tail = 0;
+            if (std::sscanf(args.deckGrid.c_str(), "%d,%d,%d%c", &deckCfg.grid[0], &deckCfg.grid[1],
+                            &deckCfg.grid[2], &tail) != 3) {
+              throw std::runtime_error("--deck-grid expects NX,NY,NZ, got '" + args.deckGrid + "'");
+            }
           }
-        );
+          const DeckBuilder builder(deckCfg);
+          if (rank == 0) {
+            const std::vector<std::string> written = builder.write(args.inputDir);
+            std::ostringstream oss;
+            oss << "[deck] " << deckCfg.deck << ": grid " << deckCfg.grid[0] << "x" << deckCfg.grid[1]
+                << "x" << deckCfg.grid[2] << ", ~" << builder.estimatedCells() << " cells (uniform equivalent "
+                << builder.uniformEquivalentCells() << "), block " << deckCfg.block_steps << " steps, probe CSV "
+                << (deckCfg.csv_every_blocks > 0 ? "every " + std::to_string(deckCfg.csv_every_blocks) + " block(s)"
+                                                 : std::string("off"))
+                << (written.empty() ? ", unchanged" : ", rewritten") << "\n";
+            log_msg(oss.str());
+          }
+          MPI_Barrier(run.comm);
+          args.wakeDeck       = deckCfg.deck;
+          wakeRuntimeInclude  = deckCfg.runtimeInclude();
+          generatedResumeDeck = deckCfg.resumeDeck();
+        }
+
+        if (rank == 0) {
+          log_msg("[info] Constructing WakeChamber and calling wake.init(...)\n");
+        }
+
+        // Pipelined coupling gives SPARTA its own communicator so its
+        // collectives never interleave with the loop's world collectives.
+        bool wakePipelined = args.wakePipelineLag > 0;
+        if (wakePipelined && mpiThreadProvided < MPI_THREAD_MULTIPLE) {
+          if (rank == 0) {
+            log_msg("[warn] --wake-pipeline needs MPI_THREAD_MULTIPLE; using serial coupling.\n");
+          }
+          wakePipelined = false;
+        }
+        if (wakePipelined && (args.checkpointEvery > 0 || resuming)) {
+          // A checkpoint needs SPARTA quiescent at a tick boundary.
+          if (rank == 0) {
+            log_msg("[warn] --wake-pipeline is not checkpointable; using serial coupling.\n");
+          }
+          wakePipelined = false;
+        }
+        MPI_Comm wakeComm = run.comm;
+        if (wakePipelined) {
+          MPI_Comm_dup(run.comm, &wakeComm);
+        }
+
+        WakeChamber wake(wakeComm, "WakeChamber");
+        if (args.wakeHotInclude != "none") {
+          wake.setHotParameters({"Fwafer_cm2s", "mbe_active"}, args.wakeHotInclude);
+        }
+        {
+          std::string resumeDeck = args.wakeResumeDeck;
+          if (resumeDeck == "auto") {
+            if (!generatedResumeDeck.empty()) resumeDeck = generatedResumeDeck;
+            else resumeDeck = (args.wakeDeck == "in.wake_harness") ? "in.wake_resume" : "none";
+          }
+          if (resumeDeck != "none") {
+            wake.enableRestartSnapshot(resumeDeck, "data/tmp/wake_snapshot.restart");
+          }
+        }
+        if (!args.warmCache.empty()) {
+          if (resuming) {
+            if (rank == 0) {
+              log_msg("[warn] --warm-cache is ignored with --resume; the checkpoint restores the flow.\n");
+            }
+          } else {
+            wake.enableWarmStart({args.warmCache,
+                                  static_cast<long>(std::max(1, args.warmCacheBlocks)) * args.spartaBlock});
+          }
+        }
+        wake.setDevicePolicy(SpartaDevicePolicy::parse(args.spartaDevices));
+        log_rank_progress(0, "before-wake-init");
+        {
+          std::optional<Logger::ScopedDiscard> quiet;
+          if (resuming) quiet.emplace();
+          wake.init(args.wakeDeck.c_str(), args.inputDir.c_str());
+        }
+        log_rank_progress(0, "after-wake-init");
+        if (rank == 0) {
+          log_msg("[gpu] " + wake.deviceMap());
+        }
+        if (wake.warmStartCache() && rank == 0) {
+          log_msg("[cpl] warm-start cache " + wake.warmStartSummary() + "\n");
+        }
+
+
+        // Spatial wafer flux from the live instance; stays uniform otherwise.
+        bool waferFluxOn = false;
+        std::vector<double> waferFluxBuf;
+        if (args.waferFluxFix != "none") {
+          WakeChamber::WaferFlux wf;
+          wf.fix = args.waferFluxFix;
+          wf.grid.gridN = growth.gridN();
+          wf.grid.cells = growth.waferCells();
+          waferFluxOn = wake.enableWaferFlux(std::move(wf));
+          if (rank == 0) {
+            log_msg("[wafer] flux map " + wake.waferFluxSummary() + "\n");
+          }
+        }
+
+        if (wakePipelined) {
+          wake.startPipeline(args.wakePipelineLag);
+          if (rank == 0) {
+            std::ostringstream oss;
+            oss << "[cpl] pipelined coupling on, lag=" << args.wakePipelineLag
+                << " block(s); leader ticks use diagnostics from earlier blocks.\n";
+            log_msg(oss.str());
+          }
+        }
+
+        if (args.wakeAdaptiveTol > 0.0) {
+          WakeChamber::AdaptiveCadence cad;
+          cad.rel_tol    = args.wakeAdaptiveTol;
+          cad.window     = args.wakeAdaptiveWindow;
+          cad.max_stride = args.wakeAdaptiveMaxStride;
+          wake.enableAdaptiveCadence(cad);
+          if (rank == 0) {
+            std::ostringstream oss;
+            oss << "[cpl] adaptive cadence on, tol=" << cad.rel_tol
+                << " window=" << cad.window << " max_stride=" << cad.max_stride << "\n";
+            log_msg(oss.str());
+          }
+        }
+
+        if (!args.wakeCache.empty()) {
+          // Deck hash: everything that shapes the wake except params.inc,
+          // whose values are the cache key.
+          const std::filesystem::path in(args.inputDir);
+          std::vector<std::string> deckFiles = {(in / args.wakeDeck).string(),
+                                                (in / wakeRuntimeInclude).string()};
+          if (args.wakeHotInclude != "none") {
+            deckFiles.push_back((in / args.wakeHotInclude).string());
+          }
+          auto cache = std::make_unique<WakeResponseCache>(
+              args.wakeCache, std::vector<std::string>{"Fwafer_cm2s", "mbe_active"},
+              WakeResponseCache::hashFiles(deckFiles), args.wakeCacheInterp);
+          if (args.wakeAdaptiveTol <= 0.0) {
+            // Converged = the adaptive steady test, even without skipping.
+            wake.setSteadyCriterion(WakeChamber::AdaptiveCadence{}.rel_tol,
+                                    args.wakeAdaptiveWindow);
+          }
+          double key_F = last_Fwafer_sent;
+          double key_mbe = last_mbe_sent;
+          sanitize_params_inc(key_F, key_mbe);
+          wake.enableResponseCache(std::move(cache),
+                                   {{"Fwafer_cm2s", key_F}, {"mbe_active", key_mbe}});
+          if (rank == 0) {
+            const WakeResponseCache::Stats& st = wake.responseCache()->stats();
+            std::ostringstream oss;
+            oss << "[cpl] wake-response cache " << args.wakeCache
+                << ": " << st.loaded << " entries for this deck, "
+                << st.loaded_stale << " stale\n";
+            log_msg(oss.str());
+          }
+        }
+
+        if (resuming) {
+          const bool rebuilt = wake.resumeFromCheckpoint(resumeCkpt, resumeCkpt.getText("resume.restart"));
+          if (rank == 0 && !rebuilt) {
+            log_msg("[warn] --resume: no SPARTA restart file to rebuild from; the wake flow restarts from the deck.\n");
+          }
+        }
+
+        if (rank == 0) {
+          log_msg("[info] wake.init() returned; entering main wake loop.\n");
+        }
+
+        const bool isLeader = (rank == 0);
+
+        // ---------------- Orbit model (leader drives logging + SolarArray) ---
+        // Simple circular LEO at 300 km altitude, time step = dt (engine tick).
+        OrbitModel orbit(/*altitude_m=*/300e3,
+                         /*dt_s=*/dt,
+                         /*inclination_rad=*/0.0,
+                         /*sun_theta_rad=*/0.0);
+        if (args.orbitEphemeris > 0) {
+          orbit.enableEphemeris(args.orbitEphemeris);
+        }
+
+        FastForward fastForward(orbit, engine, solar, bus, battery, effCell, substrateHeater);
+        if (isLeader) {
+          FastForwardConfig ffCfg;
+          ffCfg.enabled       = args.fastForward;
+          ffCfg.thermal_tol_K = args.fastForwardTolK;
+          ffCfg.min_ticks     = std::max(1, args.fastForwardMinTicks);
+          ffCfg.decimate      = std::max(0, args.fastForwardDecimate);
+          fastForward.configure(ffCfg);
+        }
+
+        if (isLeader) {
+          std::ostringstream oss;
+          oss << "[orbit] altitude_m=300000, period_s=" << orbit.period_s()
+              << " (~" << orbit.period_s() / 60.0 << " min)"
+              << ", first eclipse entry t=" << orbit.nextEclipseEntry(orbit.orbit_time_s())
+              << " s, exit t=" << orbit.nextEclipseExit(orbit.orbit_time_s()) << " s";
+          if (orbit.ephemerisEnabled()) {
+            oss << ", ephemeris samples=" << orbit.ephemerisSamples();
+          }
+          oss << "\n";
+          log_msg(oss.str());
+        }
+
+        // Track which job and parameters are currently active (leader only).
+        // -------------------------------------------------------------------
+        // Single-owner runtime scheduler state (leader only)
+        //
+        // Important:
+        // - jobs.txt controls only release/eligibility time
+        // - exactly one controlling job may own the effusion/substrate targets
+        //   and SPARTA beam semantics at a time
+        // - later released jobs wait in queue until the current controller is
+        //   done or aborted
+        // -------------------------------------------------------------------
+        Scheduler scheduler(jobs);
+
+        // Which job currently owns the thermal targets / beam state?
+        int controllingJobIndex = -1;
+
+        // Cached logging values
+        double last_heater_set    = std::numeric_limits<double>::quiet_NaN();
+        double last_effusion_set  = std::numeric_limits<double>::quiet_NaN();
+        double last_substrate_set = std::numeric_limits<double>::quiet_NaN();
+
+        // Health tracking for the CURRENT controlling deposition job only.
+        int   underflux_streak           = 0;
+        int   temp_miss_streak           = 0;
+        const int    UNDERFLUX_LIMIT_TICKS   = 20;
+        const double MIN_FLUX_FRACTION       = 0.90;
+        const int    TEMP_FAIL_LIMIT_TICKS   = 20;
+        const double TEMP_TOLERANCE_FRACTION = 0.85;
+
+        // RC temp proxy (mirrors EffusionCell RC constants) used for a
+        // conservative temperature-health gate.
+        double temp_proxy_K = 300.0;
+
+        // Pre-registered leader log schemas for the per-tick scheduler rows.
+        LogHandle scheduleStateLog = Logger::instance().registerSchema(
+          "ScheduleState",
+          {
+            "controlling_job_index",
+            "scheduler_state_code",
+            "prep_mode_code",
+
+            "requested_start_tick",
+            "requested_end_tick",
+            "requested_phase_duration_ticks",
+            "requested_live_duration_ticks",
+
+            "actual_queue_enter_tick",
+            "actual_thermal_prep_start_tick",
+            "actual_warmup_start_tick",
+            "actual_cooldown_start_tick",
+            "actual_phase_start_tick",
+            "actual_phase_end_tick",
+            "actual_deposition_start_tick",
+            "actual_deposition_end_tick",
+
+            "phase_ticks_completed",
+            "remaining_phase_ticks",
+            "live_ticks_completed",
+            "remaining_live_ticks",
+            "delay_from_requested_start",
+
+            "phase_code",
+            "mbe_on",
+            "substrate_on",
+            "phase_ready_for_execution",
+
+            "queued_active",
+            "warmup_active",
+            "cooldown_active",
+            "thermal_prep_active",
+            "live_active",
+            "done_active",
+            "aborted_active",
 
-        Logger::instance().log_wide(
+            "deposition_requested",
+            "mbe_flag"
+          }
+        );
+        LogHandle processStateLog = Logger::instance().registerSchema(
           "ProcessState",
-          tickIndex,
-          t_phys,
           {
             "controlling_job_index",
             "phase_code",
@@ -1135,117 +1440,487 @@ int main(int argc, char** argv) {
 
             "underflux_streak",
             "temp_miss_streak"
-          },
-          {
-            static_cast<double>(log_job_index),
-            phase_code_log,
-            mbe_on_log,
-            substrate_on_log,
-
-            raw_job_flux_cm2s_snapshot,
-            sparta_flux_cm2s_snapshot,
-            deposition_requested_snapshot ? 1.0 : 0.0,
-            phase_ready_for_execution_log_snapshot,
-
-            effusionDemand_W_snapshot,
-            substrateDemand_W_snapshot,
-
-            effCell.getTemperatureK(),
-            target_T_K_snapshot,
-            effCell.getAmbientTempK(),
-            effCell.getSolarScale(),
-            effCell.getSolarAbsorbedPowerW(),
-
-            substrateHeater.substrateTempK(),
-            scheduler_substrate_target_K_log_snapshot,
-            substrateHeater.ambientTempK(),
-            substrateHeater.solarScale(),
-            substrateHeater.solarAbsorbedPowerW(),
-
-            effusion_ready_snapshot ? 1.0 : 0.0,
-            wafer_ready_snapshot ? 1.0 : 0.0,
-            mbe_flag_snapshot,
-
-            effCell.getLastHeatInputW(),
-            substrateHeater.deliveredPowerW(),
-
-            static_cast<double>(underflux_streak),
-            static_cast<double>(temp_miss_streak)
           }
         );
+        LogHandle orbitLog = Logger::instance().registerSchema(
+          "Orbit",
+          {"t_orbit_s","t_orbit_min","theta_rad","theta_deg","in_sun","solar_scale"}
+        );
+        TextLogHandle scheduleTextLog = Logger::instance().registerTextSchema(
+          "ScheduleStateText",
+          {"scheduler_state_name", "prep_mode_name", "phase_name"}
+        );
+
+        // Per-tick feature row (leader), built once after the post-accounting
+        // rows for the live telemetry ring and the dataset export.
+        const std::vector<std::string> featureColumns = {
+          "controlling_job_index",
+          "scheduler_state_code",
+          "prep_mode_code",
+          "phase_code",
+          "mbe_flag",
+          "deposition_requested",
+          "phase_ready_for_execution",
+          "remaining_phase_ticks",
+          "remaining_live_ticks",
+          "sparta_flux_cm2s",
+
+          "effusion_temp_K",
+          "effusion_target_K",
+          "effusion_demand_W",
+          "effusion_delivered_W",
+          "substrate_temp_K",
+          "substrate_target_K",
+          "substrate_demand_W",
+          "substrate_delivered_W",
+
+          "solar_scale",
+          "solar_output_W",
+          "battery_charge_Wh",
+          "bus_requested_W",
+          "bus_granted_W",
+          "bus_remaining_W",
+
+          "wake_temp_K",
+          "wake_density_m3",
+          "wake_pressure_Pa",
+          "shield_hits",
+          "shield_reemit",
+
+          "control_generation"
+        };
+        std::vector<double> featureRow(featureColumns.size(), 0.0);
+
+        TelemetryPublisher telemetry;
+        TelemetryControl   telemetryPolicy;
+        if (isLeader && !args.telemetry.empty()) {
+          std::string shm = args.telemetry;
+          if (shm == "auto") {
+            const char* run_id = std::getenv("RUN_ID");
+            shm = std::string("sf_telemetry_") +
+                  (run_id && *run_id ? std::string(run_id) : std::to_string(getpid()));
+          }
+          telemetry.open(shm, featureColumns,
+                         static_cast<std::size_t>(std::max(2, args.telemetrySlots)));
+
+          LineBuffer msg;
+          msg << "[telemetry] publishing " << static_cast<unsigned long>(telemetry.width())
+              << " column(s) per tick to shm " << telemetry.name()
+              << (args.telemetryControl ? " with the control channel\n" : "\n");
+          log_msg(msg.str());
+        }
+
+        DatasetExport dataset;
+        if (isLeader && !args.dataset.empty()) {
+          std::filesystem::path dir = args.dataset == "auto"
+              ? std::filesystem::path(Logger::directory()) / "dataset"
+              : std::filesystem::path(args.dataset);
+          if (!run.subdir.empty()) dir /= run.subdir;
+          dataset.open(dir.string(), featureColumns, jobs.size(), dt);
 
-        {
           std::ostringstream oss;
-          oss << "[sched-state] tick=" << tickIndex
-              << " job=" << log_job_index
-              << " state=" << jobRunStateName(static_cast<JobRunState>(static_cast<int>(scheduler_state_code_log)))
-              << " prep=" << prepModeName(prep_mode_code)
-              << " remaining_live=" << remaining_live_ticks_log
-              << " mbe=" << mbe_flag_snapshot << "\n";
+          oss << "[dataset] writing " << dataset.width() << " column(s) per tick to "
+              << dataset.directory() << (resuming ? " (from the resume tick)\n" : "\n");
           log_msg(oss.str());
         }
-      };
 
-      int fullyIdleStreak = 0;
-      const int graceTicks = 10;
-      bool dynamicStopTriggered = false;
-      int dynamicStopTick = -1;
-      const int NTICKS = args.nticks;
-      constexpr double PI_MAIN = 3.141592653589793;
+        // Progress messages of the wake loop, one at a time (see LineBuffer).
+        LineBuffer line;
+        // Per-tick hot values (NaN = unchanged); hoisted so steady ticks reuse them.
+        std::vector<double> hotNow;
+        std::vector<double> hotPending;
+
+              auto emitPostAccountingLogs =
+            [&](int tickIndex,
+                double t_phys,
+                int controllingJobIndex_snapshot,
+                double raw_job_flux_cm2s_snapshot,
+                double sparta_flux_cm2s_snapshot,
+                bool deposition_requested_snapshot,
+                double effusionDemand_W_snapshot,
+                double substrateDemand_W_snapshot,
+                double target_T_K_snapshot,
+                double scheduler_substrate_target_K_log_snapshot,
+                double phase_ready_for_execution_log_snapshot,
+                double mbe_flag_snapshot,
+                bool effusion_ready_snapshot,
+                bool wafer_ready_snapshot) {
+
+          int log_job_index = controllingJobIndex_snapshot;
+
+          double scheduler_state_code_log = jobRunStateCode(JobRunState::Pending);
+          double prep_mode_code = 0.0;
+
+          double requested_start_tick_log           = -1.0;
+          double requested_end_tick_log             = -1.0;
+          double requested_phase_duration_ticks_log = 0.0;
+          double requested_live_duration_ticks_log  = 0.0;
+
+          double actual_queue_enter_tick_log        = -1.0;
+          double actual_thermal_prep_start_log      = -1.0;
+          double actual_warmup_start_tick_log       = -1.0;
+          double actual_cooldown_start_tick_log     = -1.0;
+          double actual_phase_start_tick_log        = -1.0;
+          double actual_phase_end_tick_log          = -1.0;
+          double actual_deposition_start_tick_log   = -1.0;
+          double actual_deposition_end_tick_log     = -1.0;
+
+          double phase_ticks_completed_log          = 0.0;
+          double remaining_phase_ticks_log          = 0.0;
+          double live_ticks_completed_log           = 0.0;
+          double remaining_live_ticks_log           = 0.0;
+          double delay_from_requested_start_log     = 0.0;
+
+          double phase_code_log                     = static_cast<double>(static_cast<int>(PhaseCode::IDLE));
+          double mbe_on_log                         = 0.0;
+          double substrate_on_log                   = 0.0;
+
+          double queued_active       = 0.0;
+          double warmup_active       = 0.0;
+          double cooldown_active     = 0.0;
+          double thermal_prep_active = 0.0;
+          double live_active         = 0.0;
+          double done_active         = 0.0;
+          double aborted_active      = 0.0;
+
+          const char* phase_name_log = "NONE";
+
+          if (log_job_index >= 0 &&
+              log_job_index < static_cast<int>(scheduler.size())) {
+            const RuntimeJobState& rj = scheduler.job(log_job_index);
+
+            scheduler_state_code_log = jobRunStateCode(rj.state);
+
+            requested_start_tick_log           = static_cast<double>(rj.requested_start_tick);
+            requested_end_tick_log             = static_cast<double>(rj.requested_end_tick);
+            requested_phase_duration_ticks_log = static_cast<double>(rj.requested_phase_duration_ticks);
+            requested_live_duration_ticks_log  = static_cast<double>(rj.requested_live_duration_ticks);
+
+            actual_queue_enter_tick_log        = static_cast<double>(rj.actual_queue_enter_tick);
+            actual_thermal_prep_start_log      = static_cast<double>(rj.actual_thermal_prep_start_tick);
+            actual_warmup_start_tick_log       = static_cast<double>(rj.actual_warmup_start_tick);
+            actual_cooldown_start_tick_log     = static_cast<double>(rj.actual_cooldown_start_tick);
+            actual_phase_start_tick_log        = static_cast<double>(rj.actual_phase_start_tick);
+            actual_phase_end_tick_log          = static_cast<double>(rj.actual_phase_end_tick);
+            actual_deposition_start_tick_log   = static_cast<double>(rj.actual_deposition_start_tick);
+            actual_deposition_end_tick_log     = static_cast<double>(rj.actual_deposition_end_tick);
+
+            phase_ticks_completed_log          = static_cast<double>(rj.phase_ticks_completed);
+            remaining_phase_ticks_log          = static_cast<double>(rj.remaining_phase_ticks);
+            live_ticks_completed_log           = static_cast<double>(rj.live_ticks_completed);
+            remaining_live_ticks_log           = static_cast<double>(rj.remaining_live_ticks);
+
+            phase_code_log                     = static_cast<double>(static_cast<int>(rj.requested_phase_code));
+            mbe_on_log                         = static_cast<double>(rj.requested_mbe_on);
+            substrate_on_log                   = static_cast<double>(rj.requested_substrate_on);
+            phase_name_log                     = phaseCodeName(rj.requested_phase_code);
+
+            if (rj.actual_phase_start_tick >= 0) {
+              delay_from_requested_start_log =
+                  static_cast<double>(rj.actual_phase_start_tick - rj.requested_start_tick);
+            } else if (rj.actual_deposition_start_tick >= 0) {
+              delay_from_requested_start_log =
+                  static_cast<double>(rj.actual_deposition_start_tick - rj.requested_start_tick);
+            } else {
+              delay_from_requested_start_log =
+                  static_cast<double>(tickIndex - rj.requested_start_tick);
+            }
 
-      for (int i = 0; i < NTICKS; ++i) {
-        const int tickIndex = i + 1;
-        const double t_phys = tickIndex * dt;
+            queued_active       = (rj.state == JobRunState::Queued) ? 1.0 : 0.0;
+            warmup_active       = (rj.state == JobRunState::Warming) ? 1.0 : 0.0;
+            cooldown_active     = (rj.state == JobRunState::Cooling) ? 1.0 : 0.0;
+            thermal_prep_active = (rj.state == JobRunState::ThermalPrep) ? 1.0 : 0.0;
+            live_active         = (rj.state == JobRunState::LiveDeposition) ? 1.0 : 0.0;
+            done_active         = (rj.state == JobRunState::Done) ? 1.0 : 0.0;
+            aborted_active      = (rj.state == JobRunState::Aborted) ? 1.0 : 0.0;
+
+            if (rj.state == JobRunState::Warming) {
+              prep_mode_code = 1.0;
+            } else if (rj.state == JobRunState::Cooling) {
+              prep_mode_code = 2.0;
+            } else if (rj.state == JobRunState::ThermalPrep &&
+                       phase_ready_for_execution_log_snapshot <= 0.5) {
+              prep_mode_code = 3.0;
+            } else {
+              prep_mode_code = 0.0;
+            }
+          }
 
-        log_rank_progress(tickIndex, "loop-top");
+          scheduleStateLog.write(
+            tickIndex,
+            t_phys,
+            {
+              static_cast<double>(log_job_index),
+              scheduler_state_code_log,
+              prep_mode_code,
+
+              requested_start_tick_log,
+              requested_end_tick_log,
+              requested_phase_duration_ticks_log,
+              requested_live_duration_ticks_log,
+
+              actual_queue_enter_tick_log,
+              actual_thermal_prep_start_log,
+              actual_warmup_start_tick_log,
+              actual_cooldown_start_tick_log,
+              actual_phase_start_tick_log,
+              actual_phase_end_tick_log,
+              actual_deposition_start_tick_log,
+              actual_deposition_end_tick_log,
+
+              phase_ticks_completed_log,
+              remaining_phase_ticks_log,
+              live_ticks_completed_log,
+              remaining_live_ticks_log,
+              delay_from_requested_start_log,
+
+              phase_code_log,
+              mbe_on_log,
+              substrate_on_log,
+              phase_ready_for_execution_log_snapshot,
+
+              queued_active,
+              warmup_active,
+              cooldown_active,
+              thermal_prep_active,
+              live_active,
+              done_active,
+              aborted_active,
+
+              deposition_requested_snapshot ? 1.0 : 0.0,
+              mbe_flag_snapshot
+            }
+          );
 
-        double thermalSolarScale = 1.0;
+          scheduleTextLog.write(
+            tickIndex,
+            t_phys,
+            {
+              jobRunStateName(static_cast<JobRunState>(static_cast<int>(scheduler_state_code_log))),
+              prepModeName(prep_mode_code),
+              phase_name_log
+            }
+          );
 
-        // ---------------- leader: orbit update ----------------
-        if (isLeader) {
-          orbit.step();
-          const OrbitState &orb = orbit.state();
-
-          double t_min     = orb.t_orbit_s / 60.0;
-          double theta_deg = orb.theta_rad * (180.0 / PI_MAIN);
-
-          // Update global sunlight scale for SolarArray and thermal models.
-          g_orbit_solar_scale = orb.solar_scale;
-          thermalSolarScale   = g_orbit_solar_scale;
-
-          Logger::instance().log_wide(
-              "Orbit",
-              tickIndex,
-              t_phys,
-              {"t_orbit_s","t_orbit_min","theta_rad","theta_deg","in_sun","solar_scale"},
-              {orb.t_orbit_s, t_min, orb.theta_rad, theta_deg,
-              orb.in_sun ? 1.0 : 0.0, orb.solar_scale}
+          processStateLog.write(
+            tickIndex,
+            t_phys,
+            {
+              static_cast<double>(log_job_index),
+              phase_code_log,
+              mbe_on_log,
+              substrate_on_log,
+
+              raw_job_flux_cm2s_snapshot,
+              sparta_flux_cm2s_snapshot,
+              deposition_requested_snapshot ? 1.0 : 0.0,
+              phase_ready_for_execution_log_snapshot,
+
+              effusionDemand_W_snapshot,
+              substrateDemand_W_snapshot,
+
+              effCell.getTemperatureK(),
+              target_T_K_snapshot,
+              effCell.getAmbientTempK(),
+              effCell.getSolarScale(),
+              effCell.getSolarAbsorbedPowerW(),
+
+              substrateHeater.substrateTempK(),
+              scheduler_substrate_target_K_log_snapshot,
+              substrateHeater.ambientTempK(),
+              substrateHeater.solarScale(),
+              substrateHeater.solarAbsorbedPowerW(),
+
+              effusion_ready_snapshot ? 1.0 : 0.0,
+              wafer_ready_snapshot ? 1.0 : 0.0,
+              mbe_flag_snapshot,
+
+              effCell.getLastHeatInputW(),
+              substrateHeater.deliveredPowerW(),
+
+              static_cast<double>(underflux_streak),
+              static_cast<double>(temp_miss_streak)
+            }
           );
+
+          if (telemetry.isOpen() || dataset.isOpen()) {
+            const SimulationEngine::Snapshot bus_now = engine.snapshot();
+            const WakeChamber::ProbeValues& probe = wake.lastProbes();
+            featureRow.assign(
+              {
+                static_cast<double>(log_job_index),
+                scheduler_state_code_log,
+                prep_mode_code,
+                phase_code_log,
+                mbe_flag_snapshot,
+                deposition_requested_snapshot ? 1.0 : 0.0,
+                phase_ready_for_execution_log_snapshot,
+                remaining_phase_ticks_log,
+                remaining_live_ticks_log,
+                sparta_flux_cm2s_snapshot,
+
+                effCell.getTemperatureK(),
+                target_T_K_snapshot,
+                effusionDemand_W_snapshot,
+                effCell.getLastHeatInputW(),
+                substrateHeater.substrateTempK(),
+                scheduler_substrate_target_K_log_snapshot,
+                substrateDemand_W_snapshot,
+                substrateHeater.deliveredPowerW(),
+
+                g_orbit_solar_scale,
+                solar.getLastOutput(),
+                battery.getCharge(),
+                bus_now.total_requested_W,
+                bus_now.total_granted_W,
+                bus_now.bus_remaining_W,
+
+                probe.temp_K,
+                probe.density_m3,
+                probe.pressure_Pa,
+                probe.shield_hits,
+                probe.shield_reemit,
+
+                static_cast<double>(telemetry.controlGeneration())
+              });
+            telemetry.publish(tickIndex, t_phys, featureRow.data(), featureRow.size());
+            dataset.append(tickIndex, t_phys, log_job_index, featureRow.data(), featureRow.size());
+          }
+
+          {
+            LineBuffer& oss = line.clear();
+            oss << "[sched-state] tick=" << tickIndex
+                << " job=" << log_job_index
+                << " state=" << jobRunStateName(static_cast<JobRunState>(static_cast<int>(scheduler_state_code_log)))
+                << " prep=" << prepModeName(prep_mode_code)
+                << " remaining_live=" << remaining_live_ticks_log
+                << " mbe=" << mbe_flag_snapshot << "\n";
+            log_msg(oss.str());
+          }
+        };
+
+        int fullyIdleStreak = 0;
+        const int graceTicks = 10;
+        bool dynamicStopTriggered = false;
+        int dynamicStopTick = -1;
+        const int NTICKS = args.nticks;
+        constexpr double PI_MAIN = 3.141592653589793;
+
+        // Harness half of the checkpoint; the wake adds its own entries.
+        auto saveHarnessState = [&](CheckpointWriter& ckpt) {
+          engine.saveState(ckpt);
+          scheduler.saveState(ckpt);
+          ckpt.setDoubles("orbit.state", {orbit.orbit_time_s(), orbit.orbit_phase_rad()});
+          ckpt.setInts("ff.counters", std::vector<std::int64_t>{fastForward.spans(), fastForward.ticksSkipped()});
+          ckpt.setDoubles("loop.params_sent", {last_Fwafer_sent, last_mbe_sent});
+          ckpt.setDoubles("loop.last_set", {last_heater_set, last_effusion_set, last_substrate_set,
+                                            temp_proxy_K, g_orbit_solar_scale});
+          ckpt.setInts("loop.counters", std::vector<int>{
+              controllingJobIndex, underflux_streak, temp_miss_streak, fullyIdleStreak,
+              g_underflux_streak_for_log, g_temp_miss_streak_for_log});
+        };
+        auto loadHarnessState = [&](const CheckpointReader& ckpt) {
+          engine.loadState(ckpt);
+          scheduler.loadState(ckpt);
+          const std::vector<double> orb = ckpt.getDoubles("orbit.state");
+          const std::vector<std::int64_t> ff = ckpt.getInts("ff.counters");
+          const std::vector<double> sets = ckpt.getDoubles("loop.last_set");
+          const std::vector<std::int64_t> cnt = ckpt.getInts("loop.counters");
+          if (orb.size() != 2 || ff.size() != 2 || sets.size() != 5 || cnt.size() != 6) {
+            throw std::runtime_error("--resume: malformed loop state in " + ckptFile);
+          }
+          orbit.reset(orb[0], orb[1]);
+          fastForward.restoreCounters(static_cast<int>(ff[0]), static_cast<long>(ff[1]));
+          last_heater_set            = sets[0];
+          last_effusion_set          = sets[1];
+          last_substrate_set         = sets[2];
+          temp_proxy_K               = sets[3];
+          g_orbit_solar_scale        = sets[4];
+          controllingJobIndex        = static_cast<int>(cnt[0]);
+          underflux_streak           = static_cast<int>(cnt[1]);
+          temp_miss_streak           = static_cast<int>(cnt[2]);
+          fullyIdleStreak            = static_cast<int>(cnt[3]);
+          g_underflux_streak_for_log = static_cast<int>(cnt[4]);
+          g_temp_miss_streak_for_log = static_cast<int>(cnt[5]);
+        };
+
+        int firstI = 0;
+        if (resuming) {
+          if (isLeader) loadHarnessState(resumeCkpt);
+          firstI = static_cast<int>(resumeCkpt.getInt("resume.next_i"));
         }
 
-          // Broadcast the current orbit-aware solar scale so every rank uses the
-          // same thermal environment this tick.
-          MPI_Bcast(&thermalSolarScale, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-          g_orbit_solar_scale = thermalSolarScale;
+        const int ckptEvery = args.checkpointEvery;
+        int nextCkptTick = (ckptEvery > 0) ? (firstI / ckptEvery + 1) * ckptEvery : 0;
+        std::string lastRestart = resuming ? resumeCkpt.getText("resume.restart") : std::string();
+        int         ckptCount = 0;
+        std::uint64_t ckptBytes = 0;
+        double      ckptSeconds = 0.0;
+        const double loopStart = MPI_Wtime();
+
+        for (int i = firstI; i < NTICKS; ++i) {
+          SF_PROFILE_SCOPE(ProfileCat::Loop, "wake.tick_loop");
+          const int tickIndex = i + 1;
+          const double t_phys = tickIndex * dt;
+          AllocTickMeter::Scope allocScope(allocMeter ? &*allocMeter : nullptr, tickIndex, t_phys);
+
+          log_rank_progress(tickIndex, "loop-top");
+
+          double thermalSolarScale = 1.0;
+          int    fastForwardTicks  = 0;
+
+          // One packed control message per tick (see TickControl.hpp).
+          // Followers post the receive now and only wait for it below.
+          TickControl tickCtl;
+          MPI_Request tickCtlReq = MPI_REQUEST_NULL;
+          if (!isLeader) {
+            tickCtlReq = postTickControl(tickCtl, 0, run.comm);
+          }
 
-          // Push the orbit-aware thermal environment into the thermal subsystems
-          // before scheduler demand is computed.
-          substrateHeater.setOrbitThermalEnvironment(thermalSolarScale);
-          effCell.setOrbitThermalEnvironment(thermalSolarScale);
+          // ---------------- leader: orbit update ----------------
+          if (isLeader) {
+            orbit.step();
+            const OrbitState &orb = orbit.state();
 
-        // ---------------- leader: orbit, job schedule, per-tick harness -----
-        if (isLeader) {
-          int logJobIndexAfterAccounting = controllingJobIndex;
-          // ---- 1) Release newly eligible jobs into the queue ----
-          for (std::size_t idx = 0; idx < runtimeJobs.size(); ++idx) {
-            RuntimeJobState& rj = runtimeJobs[idx];
+            double t_min     = orb.t_orbit_s / 60.0;
+            double theta_deg = orb.theta_rad * (180.0 / PI_MAIN);
+
+            // Update global sunlight scale for SolarArray and thermal models.
+            g_orbit_solar_scale = orb.solar_scale;
+            thermalSolarScale   = g_orbit_solar_scale;
+
+            orbitLog.write(
+                tickIndex,
+                t_phys,
+                {orb.t_orbit_s, t_min, orb.theta_rad, theta_deg,
+                orb.in_sun ? 1.0 : 0.0, orb.solar_scale}
+            );
+          }
+
+          // ---------------- leader: orbit, job schedule, per-tick harness -----
+          if (isLeader) {
+            // Push the orbit-aware thermal environment into the thermal subsystems
+            // before scheduler demand is computed. Followers get the same
+            // scale from this tick's TickControl.
+            substrateHeater.setOrbitThermalEnvironment(thermalSolarScale);
+            effCell.setOrbitThermalEnvironment(thermalSolarScale);
+
+            int logJobIndexAfterAccounting = controllingJobIndex;
+
+            // ---- 0) External policy input (--telemetry-control) ----
+            if (args.telemetryControl && telemetry.pollControl(telemetryPolicy, tickIndex)) {
+              LineBuffer& oss = line.clear();
+              oss << "[telemetry] tick=" << tickIndex
+                  << " control generation " << static_cast<unsigned long>(telemetry.controlGeneration())
+                  << " mask=" << static_cast<unsigned>(telemetryPolicy.mask) << "\n";
+              log_msg(oss.str());
+            }
 
-            if (rj.state == JobRunState::Pending && tickIndex >= rj.requested_start_tick) {
-              rj.state = JobRunState::Queued;
-              rj.released_to_queue = true;
-              rj.actual_queue_enter_tick = tickIndex;
+            // ---- 1) Release newly eligible jobs into the queue ----
+            for (const int idx : scheduler.releaseDue(tickIndex)) {
+              const RuntimeJobState& rj = scheduler.job(idx);
 
-              std::ostringstream oss;
+              LineBuffer& oss = line.clear();
               oss << "[sched] tick=" << tickIndex
                   << " released job " << idx
                   << " into queue"
@@ -1256,14 +1931,13 @@ int main(int argc, char** argv) {
                   << ")\n";
               log_msg(oss.str());
             }
-          }
 
-          // ---- 2) If nobody owns control, promote the earliest queued job ----
-          if (controllingJobIndex < 0) {
-            for (std::size_t idx = 0; idx < runtimeJobs.size(); ++idx) {
-              RuntimeJobState& rj = runtimeJobs[idx];
-              if (rj.state == JobRunState::Queued && !rj.done && !rj.aborted) {
-                controllingJobIndex = static_cast<int>(idx);
+            // ---- 2) If nobody owns control, promote the earliest queued job ----
+            if (controllingJobIndex < 0) {
+              const int idx = scheduler.promote();
+              if (idx >= 0) {
+                RuntimeJobState& rj = scheduler.job(idx);
+                controllingJobIndex = idx;
 
                 // Reset controller-local failure tracking on ownership transfer.
                 underflux_streak = 0;
@@ -1276,7 +1950,7 @@ int main(int argc, char** argv) {
                 rj.has_started_live_execution = false;
                 rj.live_execution_hold_faulted = false;
 
-                std::ostringstream oss;
+                LineBuffer& oss = line.clear();
                 oss << "[sched] tick=" << tickIndex
                     << " job " << idx << " took control"
                     << " (requested_start=" << rj.requested_start_tick
@@ -1286,814 +1960,877 @@ int main(int argc, char** argv) {
                     << ", remaining_live_ticks=" << rj.remaining_live_ticks
                     << ")\n";
                 log_msg(oss.str());
-                break;
               }
             }
-          }
-
-          // ---- 3) Decide scheduler state, heater demand, flux, and mbe flag ----
-          double target_T_K           = DEFAULT_IDLE_EFFUSION_TARGET_K;
-          double scheduler_substrate_target_K_log = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
-
-          double raw_job_flux_cm2s    = 0.0;
-          double sparta_flux_cm2s     = FWAFFER_FLOOR_CM2S;
-          bool   deposition_requested = false;
-
-          double effusionDemand_W     = 0.0;
-          double substrateDemand_W    = 0.0;
-
-          double mbe_flag             = 0.0;
-
-          bool   wafer_ready          = true;
-          bool   effusion_ready       = true;
-
-          int    jobIndexForGrowth    = -1;
-          double growth_flux_cm2s     = 0.0;
-
-          double queued_active        = 0.0;
-          double warmup_active        = 0.0;
-          double cooldown_active      = 0.0;
-          double thermal_prep_active  = 0.0;
-          double live_active          = 0.0;
-          double done_active          = 0.0;
-          double aborted_active       = 0.0;
-          double prep_mode_code       = 0.0;
-
-          double requested_start_tick_log            = -1.0;
-          double requested_end_tick_log              = -1.0;
-          double requested_phase_duration_ticks_log  = 0.0;
-          double requested_live_duration_ticks_log   = 0.0;
-
-          double actual_queue_enter_tick_log         = -1.0;
-          double actual_thermal_prep_start_log       = -1.0;
-          double actual_warmup_start_tick_log        = -1.0;
-          double actual_cooldown_start_tick_log      = -1.0;
-          double actual_phase_start_tick_log         = -1.0;
-          double actual_phase_end_tick_log           = -1.0;
-          double actual_deposition_start_tick_log    = -1.0;
-          double actual_deposition_end_tick_log      = -1.0;
-
-          double phase_ticks_completed_log           = 0.0;
-          double remaining_phase_ticks_log           = 0.0;
-          double live_ticks_completed_log            = 0.0;
-          double remaining_live_ticks_log            = 0.0;
-
-          double delay_from_requested_start_log      = 0.0;
-          double scheduler_state_code_log            = jobRunStateCode(JobRunState::Pending);
-
-          double phase_code_log                      = static_cast<double>(static_cast<int>(PhaseCode::IDLE));
-          double mbe_on_log                          = 0.0;
-          double substrate_on_log                    = 0.0;
-          double phase_ready_for_execution_log       = 0.0;
-
-          if (controllingJobIndex >= 0) {
-            RuntimeJobState& rj = runtimeJobs[controllingJobIndex];
-            jobIndexForGrowth = controllingJobIndex;
-
-            requested_start_tick_log          = static_cast<double>(rj.requested_start_tick);
-            requested_end_tick_log            = static_cast<double>(rj.requested_end_tick);
-            requested_phase_duration_ticks_log = static_cast<double>(rj.requested_phase_duration_ticks);
-            requested_live_duration_ticks_log  = static_cast<double>(rj.requested_live_duration_ticks);
 
-            actual_queue_enter_tick_log       = static_cast<double>(rj.actual_queue_enter_tick);
-            actual_thermal_prep_start_log     = static_cast<double>(rj.actual_thermal_prep_start_tick);
-            actual_warmup_start_tick_log      = static_cast<double>(rj.actual_warmup_start_tick);
-            actual_cooldown_start_tick_log    = static_cast<double>(rj.actual_cooldown_start_tick);
-            actual_phase_start_tick_log       = static_cast<double>(rj.actual_phase_start_tick);
-            actual_phase_end_tick_log         = static_cast<double>(rj.actual_phase_end_tick);
-            actual_deposition_start_tick_log  = static_cast<double>(rj.actual_deposition_start_tick);
-            actual_deposition_end_tick_log    = static_cast<double>(rj.actual_deposition_end_tick);
-
-            phase_ticks_completed_log         = static_cast<double>(rj.phase_ticks_completed);
-            remaining_phase_ticks_log         = static_cast<double>(rj.remaining_phase_ticks);
-            live_ticks_completed_log          = static_cast<double>(rj.live_ticks_completed);
-            remaining_live_ticks_log          = static_cast<double>(rj.remaining_live_ticks);
-
-            phase_code_log                    = static_cast<double>(static_cast<int>(rj.requested_phase_code));
-            mbe_on_log                        = static_cast<double>(rj.requested_mbe_on);
-            substrate_on_log                  = static_cast<double>(rj.requested_substrate_on);
-
-            raw_job_flux_cm2s = rj.requested_flux_cm2s;
-            if (!std::isfinite(raw_job_flux_cm2s) || raw_job_flux_cm2s < 0.0) {
-              raw_job_flux_cm2s = 0.0;
-            }
+            // ---- 3) Decide scheduler state, heater demand, flux, and mbe flag ----
+            double target_T_K           = DEFAULT_IDLE_EFFUSION_TARGET_K;
+            double scheduler_substrate_target_K_log = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
+
+            double raw_job_flux_cm2s    = 0.0;
+            double sparta_flux_cm2s     = FWAFFER_FLOOR_CM2S;
+            bool   deposition_requested = false;
+
+            double effusionDemand_W     = 0.0;
+            double substrateDemand_W    = 0.0;
+
+            double mbe_flag             = 0.0;
+
+            bool   wafer_ready          = true;
+            bool   effusion_ready       = true;
+
+            int    jobIndexForGrowth    = -1;
+            double growth_flux_cm2s     = 0.0;
+
+            double queued_active        = 0.0;
+            double warmup_active        = 0.0;
+            double cooldown_active      = 0.0;
+            double thermal_prep_active  = 0.0;
+            double live_active          = 0.0;
+            double done_active          = 0.0;
+            double aborted_active       = 0.0;
+            double prep_mode_code       = 0.0;
+
+            double requested_start_tick_log            = -1.0;
+            double requested_end_tick_log              = -1.0;
+            double requested_phase_duration_ticks_log  = 0.0;
+            double requested_live_duration_ticks_log   = 0.0;
+
+            double actual_queue_enter_tick_log         = -1.0;
+            double actual_thermal_prep_start_log       = -1.0;
+            double actual_warmup_start_tick_log        = -1.0;
+            double actual_cooldown_start_tick_log      = -1.0;
+            double actual_phase_start_tick_log         = -1.0;
+            double actual_phase_end_tick_log           = -1.0;
+            double actual_deposition_start_tick_log    = -1.0;
+            double actual_deposition_end_tick_log      = -1.0;
+
+            double phase_ticks_completed_log           = 0.0;
+            double remaining_phase_ticks_log           = 0.0;
+            double live_ticks_completed_log            = 0.0;
+            double remaining_live_ticks_log            = 0.0;
+
+            double delay_from_requested_start_log      = 0.0;
+            double scheduler_state_code_log            = jobRunStateCode(JobRunState::Pending);
+
+            double phase_code_log                      = static_cast<double>(static_cast<int>(PhaseCode::IDLE));
+            double mbe_on_log                          = 0.0;
+            double substrate_on_log                    = 0.0;
+            double phase_ready_for_execution_log       = 0.0;
+
+            if (controllingJobIndex >= 0) {
+              RuntimeJobState& rj = scheduler.job(controllingJobIndex);
+              jobIndexForGrowth = controllingJobIndex;
+
+              requested_start_tick_log          = static_cast<double>(rj.requested_start_tick);
+              requested_end_tick_log            = static_cast<double>(rj.requested_end_tick);
+              requested_phase_duration_ticks_log = static_cast<double>(rj.requested_phase_duration_ticks);
+              requested_live_duration_ticks_log  = static_cast<double>(rj.requested_live_duration_ticks);
+
+              actual_queue_enter_tick_log       = static_cast<double>(rj.actual_queue_enter_tick);
+              actual_thermal_prep_start_log     = static_cast<double>(rj.actual_thermal_prep_start_tick);
+              actual_warmup_start_tick_log      = static_cast<double>(rj.actual_warmup_start_tick);
+              actual_cooldown_start_tick_log    = static_cast<double>(rj.actual_cooldown_start_tick);
+              actual_phase_start_tick_log       = static_cast<double>(rj.actual_phase_start_tick);
+              actual_phase_end_tick_log         = static_cast<double>(rj.actual_phase_end_tick);
+              actual_deposition_start_tick_log  = static_cast<double>(rj.actual_deposition_start_tick);
+              actual_deposition_end_tick_log    = static_cast<double>(rj.actual_deposition_end_tick);
+
+              phase_ticks_completed_log         = static_cast<double>(rj.phase_ticks_completed);
+              remaining_phase_ticks_log         = static_cast<double>(rj.remaining_phase_ticks);
+              live_ticks_completed_log          = static_cast<double>(rj.live_ticks_completed);
+              remaining_live_ticks_log          = static_cast<double>(rj.remaining_live_ticks);
+
+              phase_code_log                    = static_cast<double>(static_cast<int>(rj.requested_phase_code));
+              mbe_on_log                        = static_cast<double>(rj.requested_mbe_on);
+              substrate_on_log                  = static_cast<double>(rj.requested_substrate_on);
+
+              raw_job_flux_cm2s = rj.requested_flux_cm2s;
+              if (!std::isfinite(raw_job_flux_cm2s) || raw_job_flux_cm2s < 0.0) {
+                raw_job_flux_cm2s = 0.0;
+              }
 
-            // Determine the next growth-like flux anchor so beam-off source
-            // conditioning phases can still choose a physically motivated source
-            // target even when they are not themselves depositing material.
-            //
-            // Examples:
-            // - SOURCE_DEGAS can heat the source above ambient with mbe_flag = 0
-            // - SOAK can hold near the upcoming growth condition without beam-on
-            const double next_growth_flux_cm2s =
-                findNextGrowthFluxCm2s(runtimeJobs, controllingJobIndex);
-
-            // Build explicit scheduler intent from the active recipe row.
-            //
-            // Important semantic separation:
-            // - beam permission controls whether deposition may occur
-            // - source control controls whether the source should thermally
-            //   condition or hold at an elevated target
-            // - substrate control controls whether the wafer heater should aim
-            //   for the row's substrate target
-            const PhaseControlIntent phaseIntent = derivePhaseIntent(
-                raw_job_flux_cm2s,
-                rj.requested_mbe_on,
-                rj.requested_substrate_on,
-                rj.requested_phase_code,
-                rj.requested_substrate_target_K,
-                next_growth_flux_cm2s
-            );
+              // Determine the next growth-like flux anchor so beam-off source
+              // conditioning phases can still choose a physically motivated source
+              // target even when they are not themselves depositing material.
+              //
+              // Examples:
+              // - SOURCE_DEGAS can heat the source above ambient with mbe_flag = 0
+              // - SOAK can hold near the upcoming growth condition without beam-on
+              const double next_growth_flux_cm2s =
+                  scheduler.nextGrowthFluxCm2s(controllingJobIndex);
 
-            scheduler_substrate_target_K_log = phaseIntent.substrate_target_K;
-
-            // Physical deposition is only requested for beam-enabled growth-like
-            // phases with positive row flux. Beam-off thermal phases may still
-            // actively heat the source, but they must not open the beam.
-            deposition_requested =
-                phaseIntent.beam_allowed &&
-                phaseIntent.growth_like_phase &&
-                raw_job_flux_cm2s > 0.0;
-
-            // SPARTA still needs a legal positive mixture value even when the
-            // physical beam is off. The scheduler keeps those semantics intact:
-            // - sparta_flux_cm2s stays legally positive for mixture stability
-            // - actual deposition remains controlled strictly by mbe_flag
-            sparta_flux_cm2s =
-                deposition_requested ? raw_job_flux_cm2s : FWAFFER_FLOOR_CM2S;
-
-            // Apply the phase-aware source target before computing heater demand.
-            //
-            // This is the key fix for SOURCE_DEGAS and other beam-off source
-            // conditioning phases. A phase can now request active source heating
-            // without implying beam-on deposition.
-
-            target_T_K = phaseIntent.effusion_target_K;
-            effCell.setTargetTempK(target_T_K);
-            substrateHeater.setJobState(
-                controllingJobIndex,
-                /*job_active=*/true,
-                raw_job_flux_cm2s,
-                phaseIntent.substrate_control_on,
-                phaseIntent.substrate_target_K
-            );
+              // Build explicit scheduler intent from the active recipe row.
+              //
+              // Important semantic separation:
+              // - beam permission controls whether deposition may occur
+              // - source control controls whether the source should thermally
+              //   condition or hold at an elevated target
+              // - substrate control controls whether the wafer heater should aim
+              //   for the row's substrate target
+              PhaseControlIntent phaseIntent = derivePhaseIntent(
+                  raw_job_flux_cm2s,
+                  rj.requested_mbe_on,
+                  rj.requested_substrate_on,
+                  rj.requested_phase_code,
+                  rj.requested_substrate_target_K,
+                  next_growth_flux_cm2s
+              );
+              if (telemetryPolicy.mask != 0) {
+                applyTelemetryControl(phaseIntent, telemetryPolicy);
+              }
 
-            {
-              std::ostringstream oss;
-              oss << "[phase-intent] tick=" << tickIndex
-                  << " job=" << controllingJobIndex
-                  << " phase=" << phaseCodeName(rj.requested_phase_code)
-                  << " source_control_on=" << (phaseIntent.source_control_on ? 1 : 0)
-                  << " source_ready_required=" << (phaseIntent.source_ready_required ? 1 : 0)
-                  << " beam_allowed=" << (phaseIntent.beam_allowed ? 1 : 0)
-                  << " growth_like_phase=" << (phaseIntent.growth_like_phase ? 1 : 0)
-                  << " raw_flux_cm2s=" << raw_job_flux_cm2s
-                  << " next_growth_flux_cm2s=" << next_growth_flux_cm2s
-                  << " effusion_target_K=" << target_T_K
-                  << " substrate_target_K=" << scheduler_substrate_target_K_log
-                  << "\n";
-              log_msg(oss.str());
-            }
+              scheduler_substrate_target_K_log = phaseIntent.substrate_target_K;
 
-            // A row is complete only when its total scheduled phase time is done.
-            // This prevents zero-flux thermal phases from collapsing immediately.
-            if (rj.remaining_phase_ticks <= 0) {
-              rj.done = true;
-              rj.state = JobRunState::Done;
-              rj.actual_phase_end_tick = tickIndex;
+              // Physical deposition is only requested for beam-enabled growth-like
+              // phases with positive row flux. Beam-off thermal phases may still
+              // actively heat the source, but they must not open the beam.
+              deposition_requested =
+                  phaseIntent.beam_allowed &&
+                  phaseIntent.growth_like_phase &&
+                  raw_job_flux_cm2s > 0.0;
 
-              if (rj.actual_deposition_start_tick >= 0 && rj.actual_deposition_end_tick < 0) {
-                rj.actual_deposition_end_tick = tickIndex;
-              }
+              // SPARTA still needs a legal positive mixture value even when the
+              // physical beam is off. The scheduler keeps those semantics intact:
+              // - sparta_flux_cm2s stays legally positive for mixture stability
+              // - actual deposition remains controlled strictly by mbe_flag
+              sparta_flux_cm2s =
+                  deposition_requested ? raw_job_flux_cm2s : FWAFFER_FLOOR_CM2S;
 
-              std::ostringstream oss;
-              oss << "[sched] tick=" << tickIndex
-                  << " job " << controllingJobIndex
-                  << " completed because remaining_phase_ticks=0\n";
-              log_msg(oss.str());
+              // Apply the phase-aware source target before computing heater demand.
+              //
+              // This is the key fix for SOURCE_DEGAS and other beam-off source
+              // conditioning phases. A phase can now request active source heating
+              // without implying beam-on deposition.
 
-              logJobIndexAfterAccounting = controllingJobIndex;
-              
-              controllingJobIndex = -1;
+              target_T_K = phaseIntent.effusion_target_K;
+              effCell.setTargetTempK(target_T_K);
               substrateHeater.setJobState(
-                  -1,
-                  /*job_active=*/false,
-                  0.0,
-                  false,
-                  DEFAULT_IDLE_SUBSTRATE_TARGET_K
+                  controllingJobIndex,
+                  /*job_active=*/true,
+                  raw_job_flux_cm2s,
+                  phaseIntent.substrate_control_on,
+                  phaseIntent.substrate_target_K
               );
 
-              raw_job_flux_cm2s = 0.0;
-              deposition_requested = false;
-              sparta_flux_cm2s = (std::isnan(last_Fwafer_sent) || last_Fwafer_sent <= 0.0)
-                                   ? FWAFFER_FLOOR_CM2S
-                                   : last_Fwafer_sent;
-              target_T_K = DEFAULT_IDLE_EFFUSION_TARGET_K;
-              effCell.setTargetTempK(target_T_K);
-              effusionDemand_W = 0.0;
-              substrateDemand_W = substrateHeater.computePowerRequestW();
-              wafer_ready = true;
-              effusion_ready = true;
-              mbe_flag = 0.0;
-              done_active = 1.0;
-              scheduler_state_code_log = jobRunStateCode(JobRunState::Done);
-            } else {
-              // const double EFF_T_ENV_K       = DEFAULT_IDLE_EFFUSION_TARGET_K;
-              // const double EFF_H_W_PER_K     = 0.8;
-              // const double EFF_KP_W_PER_K    = 8.0;
-              // const double EFF_DEFAULT_MAX_W = 2000.0;
-              const double EFF_H_W_PER_K     = 0.8;
-              const double EFF_KP_W_PER_K    = 8.0;
-              const double EFF_DEFAULT_MAX_W = 2000.0;
-
-              const double eff_temp_K = effCell.getTemperatureK();
-              const double eff_temp_error_K = target_T_K - eff_temp_K;
-
-              double effusionMaxPower_W = EFF_DEFAULT_MAX_W;
-              if (std::isfinite(rj.requested_heater_cap_W) &&
-                  rj.requested_heater_cap_W > 0.0) {
-                effusionMaxPower_W = rj.requested_heater_cap_W;
+              {
+                LineBuffer& oss = line.clear();
+                oss << "[phase-intent] tick=" << tickIndex
+                    << " job=" << controllingJobIndex
+                    << " phase=" << phaseCodeName(rj.requested_phase_code)
+                    << " source_control_on=" << (phaseIntent.source_control_on ? 1 : 0)
+                    << " source_ready_required=" << (phaseIntent.source_ready_required ? 1 : 0)
+                    << " beam_allowed=" << (phaseIntent.beam_allowed ? 1 : 0)
+                    << " growth_like_phase=" << (phaseIntent.growth_like_phase ? 1 : 0)
+                    << " raw_flux_cm2s=" << raw_job_flux_cm2s
+                    << " next_growth_flux_cm2s=" << next_growth_flux_cm2s
+                    << " effusion_target_K=" << target_T_K
+                    << " substrate_target_K=" << scheduler_substrate_target_K_log
+                    << "\n";
+                log_msg(oss.str());
               }
 
-              // Source demand is phase-aware.
-              //
-              // Old behavior:
-              // - only beam-enabled growth rows got a meaningful source target
-              // - all beam-off phases effectively idled the source
-              //
-              // New behavior:
-              // - any phase with source_control_on may request positive heating
-              // - SOURCE_DEGAS and SOAK can therefore heat and hold the source
-              //   with mbe_flag still forced off
-              // - heater_W remains a cap, not a setpoint
-              if (!phaseIntent.source_control_on ||
-                  target_T_K <= (DEFAULT_IDLE_EFFUSION_TARGET_K + 10.0)) {
-                effusionDemand_W = 0.0;
-              } else {
-                const double eff_env_K = effCell.getAmbientTempK();
-                const double eff_solar_abs_W = effCell.getSolarAbsorbedPowerW();
+              // A row is complete only when its total scheduled phase time is done.
+              // This prevents zero-flux thermal phases from collapsing immediately.
+              if (rj.remaining_phase_ticks <= 0) {
+                scheduler.complete(controllingJobIndex);
+                rj.actual_phase_end_tick = tickIndex;
 
-                const double p_ff_W =
-                    std::max(0.0,
-                             EFF_H_W_PER_K * std::max(0.0, target_T_K - eff_env_K)
-                             - eff_solar_abs_W);
+                if (rj.actual_deposition_start_tick >= 0 && rj.actual_deposition_end_tick < 0) {
+                  rj.actual_deposition_end_tick = tickIndex;
+                }
 
-                const double p_p_W =
-                    (eff_temp_error_K > 0.0)
-                        ? (EFF_KP_W_PER_K * eff_temp_error_K)
-                        : 0.0;
+                LineBuffer& oss = line.clear();
+                oss << "[sched] tick=" << tickIndex
+                    << " job " << controllingJobIndex
+                    << " completed because remaining_phase_ticks=0\n";
+                log_msg(oss.str());
 
-                effusionDemand_W =
-                    std::clamp(p_ff_W + p_p_W, 0.0, effusionMaxPower_W);
-              }
+                logJobIndexAfterAccounting = controllingJobIndex;
+                growth.finishJob(controllingJobIndex);
 
-              if (!std::isfinite(effusionDemand_W) || effusionDemand_W < 0.0) {
+                controllingJobIndex = -1;
+                substrateHeater.setJobState(
+                    -1,
+                    /*job_active=*/false,
+                    0.0,
+                    false,
+                    DEFAULT_IDLE_SUBSTRATE_TARGET_K
+                );
+
+                raw_job_flux_cm2s = 0.0;
+                deposition_requested = false;
+                sparta_flux_cm2s = (std::isnan(last_Fwafer_sent) || last_Fwafer_sent <= 0.0)
+                                     ? FWAFFER_FLOOR_CM2S
+                                     : last_Fwafer_sent;
+                target_T_K = DEFAULT_IDLE_EFFUSION_TARGET_K;
+                effCell.setTargetTempK(target_T_K);
                 effusionDemand_W = 0.0;
-              }
-              
-              substrateDemand_W = substrateHeater.computePowerRequestW();
-
-              const auto effBand   = effCell.getThermalBandState(0.90, 1.05);
-              const auto waferBand = substrateHeater.getThermalBandState();
-
-              const bool effBelow    = (effBand == EffusionCell::ThermalBandState::BelowTargetBand);
-              const bool effWithin   = (effBand == EffusionCell::ThermalBandState::WithinTargetBand ||
-                                        effBand == EffusionCell::ThermalBandState::Idle);
-              const bool effAbove    = (effBand == EffusionCell::ThermalBandState::AboveTargetBand);
-
-              const bool waferBelow  = (waferBand == SubstrateHeater::ThermalBandState::BelowTargetBand);
-              const bool waferWithin = (waferBand == SubstrateHeater::ThermalBandState::WithinTargetBand ||
-                                        waferBand == SubstrateHeater::ThermalBandState::Idle);
-              const bool waferAbove  = (waferBand == SubstrateHeater::ThermalBandState::AboveTargetBand);
-
-              wafer_ready = waferWithin;
-              effusion_ready = effWithin;
-
-              const JobRunState oldState = rj.state;
-
-              // A phase becomes executable only when the subsystems that matter
-              // for that phase are in-band.
-              //
-              // Important:
-              // - substrate readiness only matters when substrate control is on
-              // - source readiness matters for phases that actively depend on
-              //   source conditioning, including SOURCE_DEGAS and SOAK
-              // - beam permission is still separate from source readiness
-              const bool substrate_ready_for_phase =
-                  phaseIntent.substrate_control_on ? waferWithin : true;
-
-              const bool effusion_ready_for_phase =
-                  phaseIntent.source_ready_required ? effWithin : true;
-
-              const bool phase_ready_for_execution =
-                  substrate_ready_for_phase && effusion_ready_for_phase;
-
-              phase_ready_for_execution_log =
-                  phase_ready_for_execution ? 1.0 : 0.0;
-
-              const bool growth_execution_row =
-                  deposition_requested && phaseIntent.growth_like_phase;
-
-              const bool execution_hold_lost_after_live_start =
-                  growth_execution_row &&
-                  rj.has_started_live_execution &&
-                  !phase_ready_for_execution;
-
-              if (execution_hold_lost_after_live_start) {
-                const bool first_hold_fault = !rj.live_execution_hold_faulted;
-                // Important semantic rule:
-                // once live growth execution has begun, loss of required thermal hold
-                // is no longer treated as harmless prep. Stay in live-execution semantics
-                // so failure accounting can continue toward abort.
-                rj.state = JobRunState::LiveDeposition;
-                rj.live_execution_hold_faulted = true;
-
-                  if (first_hold_fault) {
-                    log_msg("[sched] first hold fault detected...\n");
-                  }
+                substrateDemand_W = substrateHeater.computePowerRequestW();
+                wafer_ready = true;
+                effusion_ready = true;
+                mbe_flag = 0.0;
+                done_active = 1.0;
+                scheduler_state_code_log = jobRunStateCode(JobRunState::Done);
+              } else {
+                // const double EFF_T_ENV_K       = DEFAULT_IDLE_EFFUSION_TARGET_K;
+                // const double EFF_H_W_PER_K     = 0.8;
+                // const double EFF_KP_W_PER_K    = 8.0;
+                // const double EFF_DEFAULT_MAX_W = 2000.0;
+                const double EFF_H_W_PER_K     = 0.8;
+                const double EFF_KP_W_PER_K    = 8.0;
+                const double EFF_DEFAULT_MAX_W = 2000.0;
+
+                const double eff_temp_K = effCell.getTemperatureK();
+                const double eff_temp_error_K = target_T_K - eff_temp_K;
+
+                double effusionMaxPower_W = EFF_DEFAULT_MAX_W;
+                if (std::isfinite(rj.requested_heater_cap_W) &&
+                    rj.requested_heater_cap_W > 0.0) {
+                  effusionMaxPower_W = rj.requested_heater_cap_W;
+                }
 
-                live_active = 1.0;
-                prep_mode_code = 0.0;
+                // Source demand is phase-aware.
+                //
+                // Old behavior:
+                // - only beam-enabled growth rows got a meaningful source target
+                // - all beam-off phases effectively idled the source
+                //
+                // New behavior:
+                // - any phase with source_control_on may request positive heating
+                // - SOURCE_DEGAS and SOAK can therefore heat and hold the source
+                //   with mbe_flag still forced off
+                // - heater_W remains a cap, not a setpoint
+                if (!phaseIntent.source_control_on ||
+                    target_T_K <= (DEFAULT_IDLE_EFFUSION_TARGET_K + 10.0)) {
+                  effusionDemand_W = 0.0;
+                } else {
+                  const double eff_env_K = effCell.getAmbientTempK();
+                  const double eff_solar_abs_W = effCell.getSolarAbsorbedPowerW();
 
-              } else if ((phaseIntent.substrate_control_on && waferBelow) ||
-                        (phaseIntent.source_ready_required && effBelow)) {
+                  const double p_ff_W =
+                      std::max(0.0,
+                               EFF_H_W_PER_K * std::max(0.0, target_T_K - eff_env_K)
+                               - eff_solar_abs_W);
 
-                rj.state = JobRunState::Warming;
-                warmup_active = 1.0;
-                prep_mode_code = 1.0;
+                  const double p_p_W =
+                      (eff_temp_error_K > 0.0)
+                          ? (EFF_KP_W_PER_K * eff_temp_error_K)
+                          : 0.0;
 
-                if (rj.actual_thermal_prep_start_tick < 0) {
-                  rj.actual_thermal_prep_start_tick = tickIndex;
-                }
-                if (rj.actual_warmup_start_tick < 0) {
-                  rj.actual_warmup_start_tick = tickIndex;
+                  effusionDemand_W =
+                      std::clamp(p_ff_W + p_p_W, 0.0, effusionMaxPower_W);
                 }
 
-              } else if ((phaseIntent.substrate_control_on && waferAbove) ||
-                        (phaseIntent.source_ready_required && effAbove)) {
-
-                rj.state = JobRunState::Cooling;
-                cooldown_active = 1.0;
-                prep_mode_code = 2.0;
-
-                if (rj.actual_thermal_prep_start_tick < 0) {
-                  rj.actual_thermal_prep_start_tick = tickIndex;
+                if (!std::isfinite(effusionDemand_W) || effusionDemand_W < 0.0) {
+                  effusionDemand_W = 0.0;
                 }
-                if (rj.actual_cooldown_start_tick < 0) {
-                  rj.actual_cooldown_start_tick = tickIndex;
-                }
-
-              } else if (!phase_ready_for_execution) {
-                rj.state = JobRunState::ThermalPrep;
-                thermal_prep_active = 1.0;
-                prep_mode_code = 3.0;
+              
+                substrateDemand_W = substrateHeater.computePowerRequestW();
+
+                const auto effBand   = effCell.getThermalBandState(0.90, 1.05);
+                const auto waferBand = substrateHeater.getThermalBandState();
+
+                const bool effBelow    = (effBand == EffusionCell::ThermalBandState::BelowTargetBand);
+                const bool effWithin   = (effBand == EffusionCell::ThermalBandState::WithinTargetBand ||
+                                          effBand == EffusionCell::ThermalBandState::Idle);
+                const bool effAbove    = (effBand == EffusionCell::ThermalBandState::AboveTargetBand);
+
+                const bool waferBelow  = (waferBand == SubstrateHeater::ThermalBandState::BelowTargetBand);
+                const bool waferWithin = (waferBand == SubstrateHeater::ThermalBandState::WithinTargetBand ||
+                                          waferBand == SubstrateHeater::ThermalBandState::Idle);
+                const bool waferAbove  = (waferBand == SubstrateHeater::ThermalBandState::AboveTargetBand);
+
+                wafer_ready = waferWithin;
+                effusion_ready = effWithin;
+
+                const JobRunState oldState = rj.state;
+
+                // A phase becomes executable only when the subsystems that matter
+                // for that phase are in-band.
+                //
+                // Important:
+                // - substrate readiness only matters when substrate control is on
+                // - source readiness matters for phases that actively depend on
+                //   source conditioning, including SOURCE_DEGAS and SOAK
+                // - beam permission is still separate from source readiness
+                const bool substrate_ready_for_phase =
+                    phaseIntent.substrate_control_on ? waferWithin : true;
+
+                const bool effusion_ready_for_phase =
+                    phaseIntent.source_ready_required ? effWithin : true;
+
+                const bool phase_ready_for_execution =
+                    substrate_ready_for_phase && effusion_ready_for_phase;
+
+                phase_ready_for_execution_log =
+                    phase_ready_for_execution ? 1.0 : 0.0;
+
+                const bool growth_execution_row =
+                    deposition_requested && phaseIntent.growth_like_phase;
+
+                const bool execution_hold_lost_after_live_start =
+                    growth_execution_row &&
+                    rj.has_started_live_execution &&
+                    !phase_ready_for_execution;
+
+                if (execution_hold_lost_after_live_start) {
+                  const bool first_hold_fault = !rj.live_execution_hold_faulted;
+                  // Important semantic rule:
+                  // once live growth execution has begun, loss of required thermal hold
+                  // is no longer treated as harmless prep. Stay in live-execution semantics
+                  // so failure accounting can continue toward abort.
+                  rj.state = JobRunState::LiveDeposition;
+                  rj.live_execution_hold_faulted = true;
 
-                if (rj.actual_thermal_prep_start_tick < 0) {
-                  rj.actual_thermal_prep_start_tick = tickIndex;
-                }
+                    if (first_hold_fault) {
+                      log_msg("[sched] first hold fault detected...\n");
+                    }
 
-              } else {
-                // Ready beam-off timed phases execute in ThermalPrep.
-                // Ready growth-like phases execute in LiveDeposition.
-                if (deposition_requested) {
-                  rj.state = JobRunState::LiveDeposition;
                   live_active = 1.0;
                   prep_mode_code = 0.0;
 
-                  if (rj.actual_phase_start_tick < 0) {
-                    rj.actual_phase_start_tick = tickIndex;
+                } else if ((phaseIntent.substrate_control_on && waferBelow) ||
+                          (phaseIntent.source_ready_required && effBelow)) {
+
+                  rj.state = JobRunState::Warming;
+                  warmup_active = 1.0;
+                  prep_mode_code = 1.0;
+
+                  if (rj.actual_thermal_prep_start_tick < 0) {
+                    rj.actual_thermal_prep_start_tick = tickIndex;
                   }
-                  if (rj.actual_deposition_start_tick < 0) {
-                    rj.actual_deposition_start_tick = tickIndex;
+                  if (rj.actual_warmup_start_tick < 0) {
+                    rj.actual_warmup_start_tick = tickIndex;
                   }
 
-                  rj.has_started_live_execution = true;
-                  rj.live_execution_hold_faulted = false;
+                } else if ((phaseIntent.substrate_control_on && waferAbove) ||
+                          (phaseIntent.source_ready_required && effAbove)) {
 
-                } else {
+                  rj.state = JobRunState::Cooling;
+                  cooldown_active = 1.0;
+                  prep_mode_code = 2.0;
+
+                  if (rj.actual_thermal_prep_start_tick < 0) {
+                    rj.actual_thermal_prep_start_tick = tickIndex;
+                  }
+                  if (rj.actual_cooldown_start_tick < 0) {
+                    rj.actual_cooldown_start_tick = tickIndex;
+                  }
+
+                } else if (!phase_ready_for_execution) {
                   rj.state = JobRunState::ThermalPrep;
                   thermal_prep_active = 1.0;
-                  prep_mode_code = 0.0;
+                  prep_mode_code = 3.0;
 
-                  if (rj.actual_phase_start_tick < 0) {
-                    rj.actual_phase_start_tick = tickIndex;
+                  if (rj.actual_thermal_prep_start_tick < 0) {
+                    rj.actual_thermal_prep_start_tick = tickIndex;
                   }
+
+                } else {
+                  // Ready beam-off timed phases execute in ThermalPrep.
+                  // Ready growth-like phases execute in LiveDeposition.
+                  if (deposition_requested) {
+                    rj.state = JobRunState::LiveDeposition;
+                    live_active = 1.0;
+                    prep_mode_code = 0.0;
+
+                    if (rj.actual_phase_start_tick < 0) {
+                      rj.actual_phase_start_tick = tickIndex;
+                    }
+                    if (rj.actual_deposition_start_tick < 0) {
+                      rj.actual_deposition_start_tick = tickIndex;
+                    }
+
+                    rj.has_started_live_execution = true;
+                    rj.live_execution_hold_faulted = false;
+
+                  } else {
+                    rj.state = JobRunState::ThermalPrep;
+                    thermal_prep_active = 1.0;
+                    prep_mode_code = 0.0;
+
+                    if (rj.actual_phase_start_tick < 0) {
+                      rj.actual_phase_start_tick = tickIndex;
+                    }
+                  }
+                }
+
+                const bool substrate_execution_monitor_active =
+                    (rj.state == JobRunState::LiveDeposition) ||
+                    (rj.state == JobRunState::ThermalPrep && !deposition_requested && phase_ready_for_execution);
+
+                substrateHeater.setFailureMonitorArmed(
+                    substrate_execution_monitor_active);
+
+                if (rj.state != oldState) {
+                  LineBuffer& oss = line.clear();
+                  oss << "[sched] tick=" << tickIndex
+                      << " job " << controllingJobIndex
+                      << " state " << jobRunStateName(oldState)
+                      << " -> " << jobRunStateName(rj.state)
+                      << " (remaining_phase_ticks=" << rj.remaining_phase_ticks
+                      << ", remaining_live_ticks=" << rj.remaining_live_ticks
+                      << ", eff_T=" << effCell.getTemperatureK()
+                      << ", eff_target=" << effCell.getTargetTempK()
+                      << ", sub_T=" << substrateHeater.substrateTempK()
+                      << ", sub_target=" << substrateHeater.targetTempK()
+                      << ")\n";
+                  log_msg(oss.str());
+                }
+
+                // The physical beam is only active during true live deposition.
+                //
+                // This preserves the key scheduler invariant:
+                // - source heating may be active in beam-off phases
+                // - substrate heating may be active in beam-off phases
+                // - actual deposition still occurs only in LiveDeposition
+                // - SPARTA still sees a legal floor flux when the beam is off
+                  const bool beam_may_fire_now =
+                      (rj.state == JobRunState::LiveDeposition) &&
+                      deposition_requested &&
+                      !rj.live_execution_hold_faulted &&
+                      phase_ready_for_execution;
+
+                  mbe_flag = beam_may_fire_now ? 1.0 : 0.0;
+                  growth_flux_cm2s = (mbe_flag > 0.5) ? raw_job_flux_cm2s : 0.0;
+
+                // Delay is measured to the realized start of execution for the row.
+                // For growth-like phases this is usually the actual deposition start.
+                // For beam-off timed phases this is the actual phase start.
+                if (rj.actual_phase_start_tick >= 0) {
+                  delay_from_requested_start_log =
+                      static_cast<double>(rj.actual_phase_start_tick - rj.requested_start_tick);
+                } else if (rj.actual_deposition_start_tick >= 0) {
+                  delay_from_requested_start_log =
+                      static_cast<double>(rj.actual_deposition_start_tick - rj.requested_start_tick);
+                } else {
+                  delay_from_requested_start_log =
+                      static_cast<double>(tickIndex - rj.requested_start_tick);
                 }
+
+                queued_active       = (rj.state == JobRunState::Queued) ? 1.0 : 0.0;
+                warmup_active       = (rj.state == JobRunState::Warming) ? 1.0 : warmup_active;
+                cooldown_active     = (rj.state == JobRunState::Cooling) ? 1.0 : cooldown_active;
+                thermal_prep_active = (rj.state == JobRunState::ThermalPrep) ? 1.0 : thermal_prep_active;
+                live_active         = (rj.state == JobRunState::LiveDeposition) ? 1.0 : live_active;
+                done_active         = (rj.state == JobRunState::Done) ? 1.0 : done_active;
+                aborted_active      = (rj.state == JobRunState::Aborted) ? 1.0 : aborted_active;
+
+                scheduler_state_code_log = jobRunStateCode(rj.state);
               }
 
-              const bool substrate_execution_monitor_active =
-                  (rj.state == JobRunState::LiveDeposition) ||
-                  (rj.state == JobRunState::ThermalPrep && !deposition_requested && phase_ready_for_execution);
 
-              substrateHeater.setFailureMonitorArmed(
-                  substrate_execution_monitor_active);
+            } else if (!jobs.empty()) {
+              raw_job_flux_cm2s    = 0.0;
+              deposition_requested = false;
 
-              if (rj.state != oldState) {
-                std::ostringstream oss;
-                oss << "[sched] tick=" << tickIndex
-                    << " job " << controllingJobIndex
-                    << " state " << jobRunStateName(oldState)
-                    << " -> " << jobRunStateName(rj.state)
-                    << " (remaining_phase_ticks=" << rj.remaining_phase_ticks
-                    << ", remaining_live_ticks=" << rj.remaining_live_ticks
-                    << ", eff_T=" << effCell.getTemperatureK()
-                    << ", eff_target=" << effCell.getTargetTempK()
-                    << ", sub_T=" << substrateHeater.substrateTempK()
-                    << ", sub_target=" << substrateHeater.targetTempK()
-                    << ")\n";
-                log_msg(oss.str());
-              }
-
-              // The physical beam is only active during true live deposition.
-              //
-              // This preserves the key scheduler invariant:
-              // - source heating may be active in beam-off phases
-              // - substrate heating may be active in beam-off phases
-              // - actual deposition still occurs only in LiveDeposition
-              // - SPARTA still sees a legal floor flux when the beam is off
-                const bool beam_may_fire_now =
-                    (rj.state == JobRunState::LiveDeposition) &&
-                    deposition_requested &&
-                    !rj.live_execution_hold_faulted &&
-                    phase_ready_for_execution;
-
-                mbe_flag = beam_may_fire_now ? 1.0 : 0.0;
-                growth_flux_cm2s = (mbe_flag > 0.5) ? raw_job_flux_cm2s : 0.0;
-
-              // Delay is measured to the realized start of execution for the row.
-              // For growth-like phases this is usually the actual deposition start.
-              // For beam-off timed phases this is the actual phase start.
-              if (rj.actual_phase_start_tick >= 0) {
-                delay_from_requested_start_log =
-                    static_cast<double>(rj.actual_phase_start_tick - rj.requested_start_tick);
-              } else if (rj.actual_deposition_start_tick >= 0) {
-                delay_from_requested_start_log =
-                    static_cast<double>(rj.actual_deposition_start_tick - rj.requested_start_tick);
+              if (std::isnan(last_Fwafer_sent) || last_Fwafer_sent <= 0.0) {
+                sparta_flux_cm2s = FWAFFER_FLOOR_CM2S;
               } else {
-                delay_from_requested_start_log =
-                    static_cast<double>(tickIndex - rj.requested_start_tick);
+                sparta_flux_cm2s = last_Fwafer_sent;
               }
 
-              queued_active       = (rj.state == JobRunState::Queued) ? 1.0 : 0.0;
-              warmup_active       = (rj.state == JobRunState::Warming) ? 1.0 : warmup_active;
-              cooldown_active     = (rj.state == JobRunState::Cooling) ? 1.0 : cooldown_active;
-              thermal_prep_active = (rj.state == JobRunState::ThermalPrep) ? 1.0 : thermal_prep_active;
-              live_active         = (rj.state == JobRunState::LiveDeposition) ? 1.0 : live_active;
-              done_active         = (rj.state == JobRunState::Done) ? 1.0 : done_active;
-              aborted_active      = (rj.state == JobRunState::Aborted) ? 1.0 : aborted_active;
+              mbe_flag   = 0.0;
+              target_T_K = DEFAULT_IDLE_EFFUSION_TARGET_K;
 
-              scheduler_state_code_log = jobRunStateCode(rj.state);
-            }
+              scheduler_substrate_target_K_log = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
+              effCell.setTargetTempK(target_T_K);
 
+              effusionDemand_W = 0.0;
+              // No row currently owns thermal control.
+              // Until SubstrateHeater is refactored for explicit recipe targets,
+              // this falls back to the legacy idle behavior.
+              substrateHeater.setJobState(
+                  -1,
+                  /*job_active=*/false,
+                  0.0,
+                  false,
+                  DEFAULT_IDLE_SUBSTRATE_TARGET_K
+              );
 
-          } else if (!jobs.empty()) {
-            raw_job_flux_cm2s    = 0.0;
-            deposition_requested = false;
+              substrateDemand_W = substrateHeater.computePowerRequestW();
+              wafer_ready = true;
+              effusion_ready = true;
 
-            if (std::isnan(last_Fwafer_sent) || last_Fwafer_sent <= 0.0) {
-              sparta_flux_cm2s = FWAFFER_FLOOR_CM2S;
+              scheduler_state_code_log = jobRunStateCode(JobRunState::Pending);
             } else {
-              sparta_flux_cm2s = last_Fwafer_sent;
-            }
+              raw_job_flux_cm2s    = 0.0;
+              deposition_requested = false;
 
-            mbe_flag   = 0.0;
-            target_T_K = DEFAULT_IDLE_EFFUSION_TARGET_K;
-
-            scheduler_substrate_target_K_log = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
-            effCell.setTargetTempK(target_T_K);
-
-            effusionDemand_W = 0.0;
-            // No row currently owns thermal control.
-            // Until SubstrateHeater is refactored for explicit recipe targets,
-            // this falls back to the legacy idle behavior.
-            substrateHeater.setJobState(
-                -1,
-                /*job_active=*/false,
-                0.0,
-                false,
-                DEFAULT_IDLE_SUBSTRATE_TARGET_K
-            );
+              if (std::isnan(last_Fwafer_sent) || last_Fwafer_sent <= 0.0) {
+                sparta_flux_cm2s = FWAFFER_FLOOR_CM2S;
+              } else {
+                sparta_flux_cm2s = last_Fwafer_sent;
+              }
 
-            substrateDemand_W = substrateHeater.computePowerRequestW();
-            wafer_ready = true;
-            effusion_ready = true;
+              mbe_flag   = 0.0;
+              target_T_K = DEFAULT_IDLE_EFFUSION_TARGET_K;
+              scheduler_substrate_target_K_log = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
+              effCell.setTargetTempK(target_T_K);
 
-            scheduler_state_code_log = jobRunStateCode(JobRunState::Pending);
-          } else {
-            raw_job_flux_cm2s    = 0.0;
-            deposition_requested = false;
+              // changed so that 
+              effusionDemand_W = 0.0;
 
-            if (std::isnan(last_Fwafer_sent) || last_Fwafer_sent <= 0.0) {
-              sparta_flux_cm2s = FWAFFER_FLOOR_CM2S;
-            } else {
-              sparta_flux_cm2s = last_Fwafer_sent;
-            }
+              substrateHeater.setJobState(
+                  -1,
+                  /*job_active=*/false,
+                  0.0,
+                  false,
+                  DEFAULT_IDLE_SUBSTRATE_TARGET_K
+              );
 
-            mbe_flag   = 0.0;
-            target_T_K = DEFAULT_IDLE_EFFUSION_TARGET_K;
-            scheduler_substrate_target_K_log = DEFAULT_IDLE_SUBSTRATE_TARGET_K;
-            effCell.setTargetTempK(target_T_K);
+              substrateDemand_W = substrateHeater.computePowerRequestW();
+              wafer_ready = true;
+              effusion_ready = true;
 
-            // changed so that 
-            effusionDemand_W = 0.0;
+              scheduler_state_code_log = jobRunStateCode(JobRunState::Pending);
+            }
 
-            substrateHeater.setJobState(
-                -1,
-                /*job_active=*/false,
-                0.0,
-                false,
-                DEFAULT_IDLE_SUBSTRATE_TARGET_K
-            );
+            if (waferFluxOn && rank == 0 && wake.takeWaferFlux(waferFluxBuf)) {
+              growth.updateFluxProfile(waferFluxBuf.data(), waferFluxBuf.size());
+            }
+            growth.setBeamState(jobIndexForGrowth,
+                                mbe_flag > 0.5,
+                                growth_flux_cm2s);
 
-            substrateDemand_W = substrateHeater.computePowerRequestW();
-            wafer_ready = true;
-            effusion_ready = true;
+                                // earlier logging was here, but moved after decision logic for cleaner logs and to capture the effect of decisions on SPARTA state in the same tick
 
-            scheduler_state_code_log = jobRunStateCode(JobRunState::Pending);
-          }
+            // ---- 3) Push Fwafer + mbe_active into params.inc when needed ----
+            if (std::isfinite(sparta_flux_cm2s) && sparta_flux_cm2s > 0.0) {
+              bool need_update = false;
 
-          growth.setBeamState(jobIndexForGrowth,
-                              mbe_flag > 0.5,
-                              growth_flux_cm2s);
+              if (std::isnan(last_Fwafer_sent) ||
+                  sparta_flux_cm2s != last_Fwafer_sent) {
+                need_update = true;
+              }
+              if (std::isnan(last_mbe_sent) ||
+                  mbe_flag != last_mbe_sent) {
+                need_update = true;
+              }
 
-                              // earlier logging was here, but moved after decision logic for cleaner logs and to capture the effect of decisions on SPARTA state in the same tick
+              if (need_update) {
+                LineBuffer& oss = line.clear();
+                oss << "[job] tick=" << tickIndex
+                    << " update params.inc: raw_job_flux_cm2s=" << raw_job_flux_cm2s
+                    << ", sparta_flux_cm2s=" << sparta_flux_cm2s
+                    << ", deposition_requested=" << (deposition_requested ? 1 : 0)
+                    << ", mbe_active=" << mbe_flag << "\n";
+                log_msg(oss.str());
 
-          // ---- 3) Push Fwafer + mbe_active into params.inc when needed ----
-          if (std::isfinite(sparta_flux_cm2s) && sparta_flux_cm2s > 0.0) {
-            bool need_update = false;
+                log_rank_progress(tickIndex, "before-write_params_inc");
+                write_params_inc(sparta_flux_cm2s, mbe_flag, rank, args.inputDir, log_msg);
+                log_rank_progress(tickIndex, "after-write_params_inc");
 
-            if (std::isnan(last_Fwafer_sent) ||
-                sparta_flux_cm2s != last_Fwafer_sent) {
-              need_update = true;
-            }
-            if (std::isnan(last_mbe_sent) ||
-                mbe_flag != last_mbe_sent) {
-              need_update = true;
+                // Hot-updated on an embedded instance, otherwise a deck reload.
+                double hot_F = sparta_flux_cm2s;
+                double hot_mbe = mbe_flag;
+                sanitize_params_inc(hot_F, hot_mbe);
+                log_rank_progress(tickIndex, "before-updateParameters");
+                wake.updateParameters({{"Fwafer_cm2s", hot_F}, {"mbe_active", hot_mbe}});
+                log_rank_progress(tickIndex, "after-updateParameters");
+
+                last_Fwafer_sent = sparta_flux_cm2s;
+                last_mbe_sent    = mbe_flag;
+              }
             }
 
-            if (need_update) {
-              std::ostringstream oss;
+            // ---- 4) Set heater demand (only log when it changes) ----
+            double totalHeaterDemand_W = effusionDemand_W + substrateDemand_W;
+
+            if (std::isnan(last_heater_set) || totalHeaterDemand_W != last_heater_set) {
+              LineBuffer& oss = line.clear();
               oss << "[job] tick=" << tickIndex
-                  << " update params.inc: raw_job_flux_cm2s=" << raw_job_flux_cm2s
+                  << " control_state:"
+                  << " raw_job_flux_cm2s=" << raw_job_flux_cm2s
                   << ", sparta_flux_cm2s=" << sparta_flux_cm2s
                   << ", deposition_requested=" << (deposition_requested ? 1 : 0)
-                  << ", mbe_active=" << mbe_flag << "\n";
+                  << ", effusionDemand_W=" << effusionDemand_W
+                  << ", substrateDemand_W=" << substrateDemand_W
+                  << ", totalHeaterDemand_W=" << totalHeaterDemand_W
+                  << ", wafer_ready=" << (wafer_ready ? 1 : 0)
+                  << ", effusion_ready=" << (effusion_ready ? 1 : 0)
+                  << ", mbe_flag=" << mbe_flag
+                  << "\n";
               log_msg(oss.str());
-
-              log_rank_progress(tickIndex, "before-write_params_inc");
-              write_params_inc(sparta_flux_cm2s, mbe_flag, rank, args.inputDir, log_msg);
-              log_rank_progress(tickIndex, "after-write_params_inc");
-
-              log_rank_progress(tickIndex, "before-markDirtyReload");
-              wake.markDirtyReload();
-              log_rank_progress(tickIndex, "after-markDirtyReload");
-
-              last_Fwafer_sent = sparta_flux_cm2s;
-              last_mbe_sent    = mbe_flag;
+              last_heater_set = totalHeaterDemand_W;
             }
-          }
-
-          // ---- 4) Set heater demand (only log when it changes) ----
-          double totalHeaterDemand_W = effusionDemand_W + substrateDemand_W;
-
-          if (std::isnan(last_heater_set) || totalHeaterDemand_W != last_heater_set) {
-            std::ostringstream oss;
-            oss << "[job] tick=" << tickIndex
-                << " control_state:"
-                << " raw_job_flux_cm2s=" << raw_job_flux_cm2s
-                << ", sparta_flux_cm2s=" << sparta_flux_cm2s
-                << ", deposition_requested=" << (deposition_requested ? 1 : 0)
-                << ", effusionDemand_W=" << effusionDemand_W
-                << ", substrateDemand_W=" << substrateDemand_W
-                << ", totalHeaterDemand_W=" << totalHeaterDemand_W
-                << ", wafer_ready=" << (wafer_ready ? 1 : 0)
-                << ", effusion_ready=" << (effusion_ready ? 1 : 0)
-                << ", mbe_flag=" << mbe_flag
-                << "\n";
-            log_msg(oss.str());
-            last_heater_set = totalHeaterDemand_W;
-          }
-
-          heater.setEffusionDemand(effusionDemand_W);
-          heater.setSubstrateDemand(substrateDemand_W);
-
-          // While wafer is not ready, prioritize wafer heating.
-          // (Once ready, HeaterBank can share or go proportional.)
-          heater.setPrioritySubstrate(!wafer_ready);
-
-
-          // ---- 5) Tick harness + WakeChamber ----
-          std::ostringstream oss;
-          oss << "[wake] tick=" << tickIndex
-              << " t=" << t_phys
-              << " s : BEFORE engine.tick() + wake.tick()\n";
-          log_msg(oss.str());
-
-          // C++ harness first, then SPARTA
-          log_rank_progress(tickIndex, "before-engine-tick");
-          engine.tick();
-          log_rank_progress(tickIndex, "after-engine-tick");
-
-          TickContext ctx{ tickIndex, t_phys, dt };
-          log_rank_progress(tickIndex, "before-wake-tick");
-          wake.tick(ctx);
-          log_rank_progress(tickIndex, "after-wake-tick");
-
-          std::ostringstream oss2;
-          oss2 << "[wake] tick=" << tickIndex
-               << " t=" << t_phys
-               << " s : AFTER engine.tick() + wake.tick()\n";
-          log_msg(oss2.str());
-
-          // ---- 6) After ticking, evaluate job health and consume execution time
-          if (controllingJobIndex >= 0) {
-            RuntimeJobState& rj = runtimeJobs[controllingJobIndex];
-
-            const bool live_execution_active =
-              (rj.state == JobRunState::LiveDeposition &&
-              deposition_requested &&
-              rj.has_started_live_execution);
 
-            const bool nongrowth_execution_active =
-                (rj.state == JobRunState::ThermalPrep &&
-                 !deposition_requested &&
-                 phase_ready_for_execution_log > 0.5);
+            heater.setEffusionDemand(effusionDemand_W);
+            heater.setSubstrateDemand(substrateDemand_W);
 
-            bool wafer_gate_fail = substrateHeater.jobFailed();
+            // While wafer is not ready, prioritize wafer heating.
+            // (Once ready, HeaterBank can share or go proportional.)
+            heater.setPrioritySubstrate(!wafer_ready);
 
 
-            if (live_execution_active) {
-              const bool execution_hold_fault_active = rj.live_execution_hold_faulted;
-              if (execution_hold_fault_active) {
-                std::ostringstream oss;
-                oss << "[sched] tick=" << tickIndex
-                    << " job " << controllingJobIndex
-                    << " execution-time thermal hold lost"
-                    << " (eff_ready=" << (effusion_ready ? 1 : 0)
-                    << ", wafer_ready=" << (wafer_ready ? 1 : 0)
-                    << ", mbe_flag=" << mbe_flag
-                    << ")\n";
-                log_msg(oss.str());
-              }
-              double P_actual = effCell.getLastHeatInputW();
-
-              // Update RC temp proxy for the active live-deposition interval.
-              {
-                const double C_J_PER_K = 800.0;
-                const double H_W_PER_K = 0.8;
-                const double T_ENV_K   = effCell.getAmbientTempK();
-                const double P_SOLAR_W = effCell.getSolarAbsorbedPowerW();
-
-                double net_W =
-                    P_actual + P_SOLAR_W
-                    - H_W_PER_K * std::max(0.0, temp_proxy_K - T_ENV_K);
-
-                double dT = (net_W / C_J_PER_K) * dt;
-                temp_proxy_K += dT;
-
-                if (!std::isfinite(temp_proxy_K)) temp_proxy_K = T_ENV_K;
-                if (temp_proxy_K < 0.0)           temp_proxy_K = 0.0;
-              }
+            // ---- 5) Tick harness + WakeChamber ----
+            LineBuffer& oss = line.clear();
+            oss << "[wake] tick=" << tickIndex
+                << " t=" << t_phys
+                << " s : BEFORE engine.tick() + wake.tick()\n";
+            log_msg(oss.str());
 
-              // Under-flux gate while live
-              double flux_ratio = 1.0;
-              if (effusionDemand_W > 0.0) {
-                flux_ratio = P_actual / effusionDemand_W;
-              }
-              if (!std::isfinite(flux_ratio)) {
-                flux_ratio = 0.0;
-              }
+            // C++ harness first, then SPARTA
+            log_rank_progress(tickIndex, "before-engine-tick");
+            {
+              SF_PROFILE_SCOPE(ProfileCat::Loop, "wake.engine_tick");
+              engine.tick();
+            }
+            log_rank_progress(tickIndex, "after-engine-tick");
 
-              if (flux_ratio < MIN_FLUX_FRACTION) {
-                underflux_streak += 1;
-              } else {
-                underflux_streak = 0;
-              }
+            TickContext ctx{ tickIndex, t_phys, dt };
+            log_rank_progress(tickIndex, "before-wake-tick");
+            {
+              SF_PROFILE_SCOPE(ProfileCat::Loop, "WakeChamber::tick");
+              wake.tick(ctx);
+            }
+            log_rank_progress(tickIndex, "after-wake-tick");
+
+            LineBuffer& oss2 = line.clear();
+            oss2 << "[wake] tick=" << tickIndex
+                 << " t=" << t_phys
+                 << " s : AFTER engine.tick() + wake.tick()\n";
+            log_msg(oss2.str());
+
+            // ---- 6) After ticking, evaluate job health and consume execution time
+            if (controllingJobIndex >= 0) {
+              RuntimeJobState& rj = scheduler.job(controllingJobIndex);
+
+              const bool live_execution_active =
+                (rj.state == JobRunState::LiveDeposition &&
+                deposition_requested &&
+                rj.has_started_live_execution);
+
+              const bool nongrowth_execution_active =
+                  (rj.state == JobRunState::ThermalPrep &&
+                   !deposition_requested &&
+                   phase_ready_for_execution_log > 0.5);
+
+              bool wafer_gate_fail = substrateHeater.jobFailed();
+
+
+              if (live_execution_active) {
+                const bool execution_hold_fault_active = rj.live_execution_hold_faulted;
+                if (execution_hold_fault_active) {
+                  LineBuffer& oss = line.clear();
+                  oss << "[sched] tick=" << tickIndex
+                      << " job " << controllingJobIndex
+                      << " execution-time thermal hold lost"
+                      << " (eff_ready=" << (effusion_ready ? 1 : 0)
+                      << ", wafer_ready=" << (wafer_ready ? 1 : 0)
+                      << ", mbe_flag=" << mbe_flag
+                      << ")\n";
+                  log_msg(oss.str());
+                }
+                double P_actual = effCell.getLastHeatInputW();
 
-              bool flux_gate_fail = (underflux_streak >= UNDERFLUX_LIMIT_TICKS);
+                // Update RC temp proxy for the active live-deposition interval.
+                {
+                  const double C_J_PER_K = 800.0;
+                  const double H_W_PER_K = 0.8;
+                  const double T_ENV_K   = effCell.getAmbientTempK();
+                  const double P_SOLAR_W = effCell.getSolarAbsorbedPowerW();
 
-              // Temperature gate while live
-              bool temp_gate_fail = false;
+                  double net_W =
+                      P_actual + P_SOLAR_W
+                      - H_W_PER_K * std::max(0.0, temp_proxy_K - T_ENV_K);
 
-              double actual_effusion_temp_K = effCell.getTemperatureK();
-              double temp_ratio = (target_T_K > 0.0) ? (actual_effusion_temp_K / target_T_K) : 0.0;
+                  double dT = (net_W / C_J_PER_K) * dt;
+                  temp_proxy_K += dT;
 
-              if (!std::isfinite(temp_ratio)) {
-                temp_ratio = 0.0;
-              }
+                  if (!std::isfinite(temp_proxy_K)) temp_proxy_K = T_ENV_K;
+                  if (temp_proxy_K < 0.0)           temp_proxy_K = 0.0;
+                }
 
-              if (temp_ratio < TEMP_TOLERANCE_FRACTION) {
-                temp_miss_streak += 1;
-              } else {
-                temp_miss_streak = 0;
-              }
+                // Under-flux gate while live
+                double flux_ratio = 1.0;
+                if (effusionDemand_W > 0.0) {
+                  flux_ratio = P_actual / effusionDemand_W;
+                }
+                if (!std::isfinite(flux_ratio)) {
+                  flux_ratio = 0.0;
+                }
 
-              if (temp_miss_streak >= TEMP_FAIL_LIMIT_TICKS) {
-                temp_gate_fail = true;
-              }
+                if (flux_ratio < MIN_FLUX_FRACTION) {
+                  underflux_streak += 1;
+                } else {
+                  underflux_streak = 0;
+                }
 
-              g_underflux_streak_for_log = underflux_streak;
-              g_temp_miss_streak_for_log = temp_miss_streak;
+                bool flux_gate_fail = (underflux_streak >= UNDERFLUX_LIMIT_TICKS);
 
-              // Abort only during true live deposition
-              if (flux_gate_fail || temp_gate_fail || wafer_gate_fail) {
-                rj.aborted = true;
-                rj.state   = JobRunState::Aborted;
+                // Temperature gate while live
+                bool temp_gate_fail = false;
 
-                std::ostringstream joss;
-                joss << "[job] tick=" << tickIndex
-                     << " ABORTING job index " << controllingJobIndex
-                     << " due to ";
-
-                bool any = false;
-                if (flux_gate_fail)  { joss << (any ? " + " : "") << "under-flux";       any = true; }
-                if (temp_gate_fail)  { joss << (any ? " + " : "") << "temperature-miss"; any = true; }
-                if (wafer_gate_fail) { joss << (any ? " + " : "") << "wafer-temp-miss";  any = true; }
-
-                joss << " (underflux_streak=" << underflux_streak
-                     << ", temp_miss_streak=" << temp_miss_streak
-                     << ", eff_temp_K=" << effCell.getTemperatureK()
-                     << ", target_T_K=" << target_T_K
-                     << ", flux_ratio=" << flux_ratio
-                     << ", T_sub_K=" << substrateHeater.substrateTempK()
-                     << ", T_sub_target_K=" << substrateHeater.targetTempK()
-                     << ", sub_temp_miss_streak=" << substrateHeater.tempMissStreak()
-                     << ")\n";
-                log_msg(joss.str());
+                double actual_effusion_temp_K = effCell.getTemperatureK();
+                double temp_ratio = (target_T_K > 0.0) ? (actual_effusion_temp_K / target_T_K) : 0.0;
 
-                growth.markJobAborted(controllingJobIndex);
-                engine.markJobFailedThisTick();
+                if (!std::isfinite(temp_ratio)) {
+                  temp_ratio = 0.0;
+                }
 
-                double F_for_abort = last_Fwafer_sent;
-                if (!std::isfinite(F_for_abort) || F_for_abort <= 0.0) {
-                  F_for_abort = FWAFFER_FLOOR_CM2S;
+                if (temp_ratio < TEMP_TOLERANCE_FRACTION) {
+                  temp_miss_streak += 1;
+                } else {
+                  temp_miss_streak = 0;
                 }
 
-                log_rank_progress(tickIndex, "before-abort-write_params_inc");
-                write_params_inc(F_for_abort, 0.0, rank, args.inputDir, log_msg);
-                log_rank_progress(tickIndex, "after-abort-write_params_inc");
+                if (temp_miss_streak >= TEMP_FAIL_LIMIT_TICKS) {
+                  temp_gate_fail = true;
+                }
 
-                log_rank_progress(tickIndex, "before-abort-markDirtyReload");
-                wake.markDirtyReload();
-                log_rank_progress(tickIndex, "after-abort-markDirtyReload");
+                g_underflux_streak_for_log = underflux_streak;
+                g_temp_miss_streak_for_log = temp_miss_streak;
+
+                // Abort only during true live deposition
+                if (flux_gate_fail || temp_gate_fail || wafer_gate_fail) {
+                  scheduler.abort(controllingJobIndex);
+
+                  LineBuffer& joss = line.clear();
+                  joss << "[job] tick=" << tickIndex
+                       << " ABORTING job index " << controllingJobIndex
+                       << " due to ";
+
+                  bool any = false;
+                  if (flux_gate_fail)  { joss << (any ? " + " : "") << "under-flux";       any = true; }
+                  if (temp_gate_fail)  { joss << (any ? " + " : "") << "temperature-miss"; any = true; }
+                  if (wafer_gate_fail) { joss << (any ? " + " : "") << "wafer-temp-miss";  any = true; }
+
+                  joss << " (underflux_streak=" << underflux_streak
+                       << ", temp_miss_streak=" << temp_miss_streak
+                       << ", eff_temp_K=" << effCell.getTemperatureK()
+                       << ", target_T_K=" << target_T_K
+                       << ", flux_ratio=" << flux_ratio
+                       << ", T_sub_K=" << substrateHeater.substrateTempK()
+                       << ", T_sub_target_K=" << substrateHeater.targetTempK()
+                       << ", sub_temp_miss_streak=" << substrateHeater.tempMissStreak()
+                       << ")\n";
+                  log_msg(joss.str());
+
+                  growth.markJobAborted(controllingJobIndex);
+                  growth.finishJob(controllingJobIndex);
+                  engine.markJobFailedThisTick();
+
+                  double F_for_abort = last_Fwafer_sent;
+                  if (!std::isfinite(F_for_abort) || F_for_abort <= 0.0) {
+                    F_for_abort = FWAFFER_FLOOR_CM2S;
+                  }
 
-                last_Fwafer_sent = F_for_abort;
-                last_mbe_sent    = 0.0;
-                logJobIndexAfterAccounting = controllingJobIndex;
-                rj.has_started_live_execution = false;
-                rj.live_execution_hold_faulted = false;
+                  log_rank_progress(tickIndex, "before-abort-write_params_inc");
+                  write_params_inc(F_for_abort, 0.0, rank, args.inputDir, log_msg);
+                  log_rank_progress(tickIndex, "after-abort-write_params_inc");
 
-                controllingJobIndex = -1;
+                  log_rank_progress(tickIndex, "before-abort-updateParameters");
+                  wake.updateParameters({{"Fwafer_cm2s", F_for_abort}, {"mbe_active", 0.0}});
+                  log_rank_progress(tickIndex, "after-abort-updateParameters");
 
-                underflux_streak = 0;
-                temp_miss_streak = 0;
-                g_underflux_streak_for_log = 0;
-                g_temp_miss_streak_for_log = 0;
-                temp_proxy_K = 300.0;
+                  last_Fwafer_sent = F_for_abort;
+                  last_mbe_sent    = 0.0;
+                  logJobIndexAfterAccounting = controllingJobIndex;
+                  rj.has_started_live_execution = false;
+                  rj.live_execution_hold_faulted = false;
 
+                  controllingJobIndex = -1;
 
-                last_heater_set = std::numeric_limits<double>::quiet_NaN();
-                last_effusion_set = std::numeric_limits<double>::quiet_NaN();
-                last_substrate_set = std::numeric_limits<double>::quiet_NaN();
-              } else {
-                // Growth-like phases consume both phase time and live deposition time.
-                rj.phase_ticks_completed += 1;
-                rj.remaining_phase_ticks -= 1;
+                  underflux_streak = 0;
+                  temp_miss_streak = 0;
+                  g_underflux_streak_for_log = 0;
+                  g_temp_miss_streak_for_log = 0;
+                  temp_proxy_K = 300.0;
 
-                rj.live_ticks_completed += 1;
-                rj.remaining_live_ticks -= 1;
 
-                std::ostringstream oss;
-                oss << "[sched] tick=" << tickIndex
-                    << " job " << controllingJobIndex
-                    << " completed one live deposition tick"
-                    << " (phase_completed=" << rj.phase_ticks_completed
-                    << ", phase_remaining=" << rj.remaining_phase_ticks
-                    << ", live_completed=" << rj.live_ticks_completed
-                    << ", live_remaining=" << rj.remaining_live_ticks
-                    << ")\n";
-                log_msg(oss.str());
+                  last_heater_set = std::numeric_limits<double>::quiet_NaN();
+                  last_effusion_set = std::numeric_limits<double>::quiet_NaN();
+                  last_substrate_set = std::numeric_limits<double>::quiet_NaN();
+                } else {
+                  // Growth-like phases consume both phase time and live deposition time.
+                  rj.phase_ticks_completed += 1;
+                  rj.remaining_phase_ticks -= 1;
+
+                  rj.live_ticks_completed += 1;
+                  rj.remaining_live_ticks -= 1;
+
+                  LineBuffer& oss = line.clear();
+                  oss << "[sched] tick=" << tickIndex
+                      << " job " << controllingJobIndex
+                      << " completed one live deposition tick"
+                      << " (phase_completed=" << rj.phase_ticks_completed
+                      << ", phase_remaining=" << rj.remaining_phase_ticks
+                      << ", live_completed=" << rj.live_ticks_completed
+                      << ", live_remaining=" << rj.remaining_live_ticks
+                      << ")\n";
+                  log_msg(oss.str());
+
+                  if (rj.remaining_phase_ticks <= 0) {
+                    scheduler.complete(controllingJobIndex);
+                    rj.actual_phase_end_tick = tickIndex;
+
+                    if (rj.actual_deposition_start_tick >= 0 && rj.actual_deposition_end_tick < 0) {
+                      rj.actual_deposition_end_tick = tickIndex;
+                    }
+
+                    LineBuffer& done_oss = line.clear();
+                    done_oss << "[sched] tick=" << tickIndex
+                             << " job " << controllingJobIndex
+                             << " DONE"
+                             << " (requested_start=" << rj.requested_start_tick
+                             << ", actual_phase_start=" << rj.actual_phase_start_tick
+                             << ", actual_phase_end=" << rj.actual_phase_end_tick
+                             << ", phase_ticks_completed=" << rj.phase_ticks_completed
+                             << ", live_ticks_completed=" << rj.live_ticks_completed
+                             << ")\n";
+                    log_msg(done_oss.str());
+                    logJobIndexAfterAccounting = controllingJobIndex;
+                    growth.finishJob(controllingJobIndex);
+
+                    rj.has_started_live_execution = false;
+                    rj.live_execution_hold_faulted = false;
+
+                    controllingJobIndex = -1;
+                    underflux_streak = 0;
+                    temp_miss_streak = 0;
+                    g_underflux_streak_for_log = 0;
+                    g_temp_miss_streak_for_log = 0;
+                    temp_proxy_K = 300.0;
+                    last_heater_set = std::numeric_limits<double>::quiet_NaN();
+                    last_effusion_set = std::numeric_limits<double>::quiet_NaN();
+                    last_substrate_set = std::numeric_limits<double>::quiet_NaN();
+                  }
+                }
+              } else if (nongrowth_execution_active) {
+                if (wafer_gate_fail) {
+                  scheduler.abort(controllingJobIndex);
+
+                  LineBuffer& joss = line.clear();
+                  joss << "[job] tick=" << tickIndex
+                       << " ABORTING non-growth job index " << controllingJobIndex
+                       << " due to wafer-temp-miss"
+                       << " (T_sub_K=" << substrateHeater.substrateTempK()
+                       << ", T_sub_target_K=" << substrateHeater.targetTempK()
+                       << ", sub_temp_miss_streak=" << substrateHeater.tempMissStreak()
+                       << ")\n";
+                  log_msg(joss.str());
+
+                  growth.markJobAborted(controllingJobIndex);
+                  growth.finishJob(controllingJobIndex);
+                  engine.markJobFailedThisTick();
+
+                  double F_for_abort = last_Fwafer_sent;
+                  if (!std::isfinite(F_for_abort) || F_for_abort <= 0.0) {
+                    F_for_abort = FWAFFER_FLOOR_CM2S;
+                  }
 
-                if (rj.remaining_phase_ticks <= 0) {
-                  rj.done = true;
-                  rj.state = JobRunState::Done;
-                  rj.actual_phase_end_tick = tickIndex;
+                  log_rank_progress(tickIndex, "before-abort-write_params_inc");
+                  write_params_inc(F_for_abort, 0.0, rank, args.inputDir, log_msg);
+                  log_rank_progress(tickIndex, "after-abort-write_params_inc");
 
-                  if (rj.actual_deposition_start_tick >= 0 && rj.actual_deposition_end_tick < 0) {
-                    rj.actual_deposition_end_tick = tickIndex;
-                  }
+                  log_rank_progress(tickIndex, "before-abort-updateParameters");
+                  wake.updateParameters({{"Fwafer_cm2s", F_for_abort}, {"mbe_active", 0.0}});
+                  log_rank_progress(tickIndex, "after-abort-updateParameters");
 
-                  std::ostringstream done_oss;
-                  done_oss << "[sched] tick=" << tickIndex
-                           << " job " << controllingJobIndex
-                           << " DONE"
-                           << " (requested_start=" << rj.requested_start_tick
-                           << ", actual_phase_start=" << rj.actual_phase_start_tick
-                           << ", actual_phase_end=" << rj.actual_phase_end_tick
-                           << ", phase_ticks_completed=" << rj.phase_ticks_completed
-                           << ", live_ticks_completed=" << rj.live_ticks_completed
-                           << ")\n";
-                  log_msg(done_oss.str());
+                  last_Fwafer_sent = F_for_abort;
+                  last_mbe_sent    = 0.0;
                   logJobIndexAfterAccounting = controllingJobIndex;
 
                   rj.has_started_live_execution = false;
@@ -2108,226 +2845,489 @@ int main(int argc, char** argv) {
                   last_heater_set = std::numeric_limits<double>::quiet_NaN();
                   last_effusion_set = std::numeric_limits<double>::quiet_NaN();
                   last_substrate_set = std::numeric_limits<double>::quiet_NaN();
-                }
-              }
-            } else if (nongrowth_execution_active) {
-              if (wafer_gate_fail) {
-                rj.aborted = true;
-                rj.state   = JobRunState::Aborted;
 
-                std::ostringstream joss;
-                joss << "[job] tick=" << tickIndex
-                     << " ABORTING non-growth job index " << controllingJobIndex
-                     << " due to wafer-temp-miss"
-                     << " (T_sub_K=" << substrateHeater.substrateTempK()
-                     << ", T_sub_target_K=" << substrateHeater.targetTempK()
-                     << ", sub_temp_miss_streak=" << substrateHeater.tempMissStreak()
-                     << ")\n";
-                log_msg(joss.str());
-
-                growth.markJobAborted(controllingJobIndex);
-                engine.markJobFailedThisTick();
+                } else {
+                  // Beam-off timed phases consume phase time only.
+                  underflux_streak = 0;
+                  temp_miss_streak = 0;
+                  g_underflux_streak_for_log = 0;
+                  g_temp_miss_streak_for_log = 0;
 
-                double F_for_abort = last_Fwafer_sent;
-                if (!std::isfinite(F_for_abort) || F_for_abort <= 0.0) {
-                  F_for_abort = FWAFFER_FLOOR_CM2S;
+                  rj.phase_ticks_completed += 1;
+                  rj.remaining_phase_ticks -= 1;
+
+                  LineBuffer& oss = line.clear();
+                  oss << "[sched] tick=" << tickIndex
+                      << " job " << controllingJobIndex
+                      << " completed one non-growth phase tick"
+                      << " (phase_completed=" << rj.phase_ticks_completed
+                      << ", phase_remaining=" << rj.remaining_phase_ticks
+                      << ")\n";
+                  log_msg(oss.str());
+
+                  if (rj.remaining_phase_ticks <= 0) {
+                    scheduler.complete(controllingJobIndex);
+                    rj.actual_phase_end_tick = tickIndex;
+
+                    LineBuffer& done_oss = line.clear();
+                    done_oss << "[sched] tick=" << tickIndex
+                             << " job " << controllingJobIndex
+                             << " DONE"
+                             << " (requested_start=" << rj.requested_start_tick
+                             << ", actual_phase_start=" << rj.actual_phase_start_tick
+                             << ", actual_phase_end=" << rj.actual_phase_end_tick
+                             << ", phase_ticks_completed=" << rj.phase_ticks_completed
+                             << ", live_ticks_completed=" << rj.live_ticks_completed
+                             << ")\n";
+                    log_msg(done_oss.str());
+
+                    logJobIndexAfterAccounting = controllingJobIndex;
+                    growth.finishJob(controllingJobIndex);
+                    controllingJobIndex = -1;
+                    last_heater_set = std::numeric_limits<double>::quiet_NaN();
+                    last_effusion_set = std::numeric_limits<double>::quiet_NaN();
+                    last_substrate_set = std::numeric_limits<double>::quiet_NaN();
+                  }
                 }
 
-                log_rank_progress(tickIndex, "before-abort-write_params_inc");
-                write_params_inc(F_for_abort, 0.0, rank, args.inputDir, log_msg);
-                log_rank_progress(tickIndex, "after-abort-write_params_inc");
-
-                log_rank_progress(tickIndex, "before-abort-markDirtyReload");
-                wake.markDirtyReload();
-                log_rank_progress(tickIndex, "after-abort-markDirtyReload");
-
-                last_Fwafer_sent = F_for_abort;
-                last_mbe_sent    = 0.0;
-                logJobIndexAfterAccounting = controllingJobIndex;
-
-                rj.has_started_live_execution = false;
-                rj.live_execution_hold_faulted = false;
-
-                controllingJobIndex = -1;
-                underflux_streak = 0;
-                temp_miss_streak = 0;
-                g_underflux_streak_for_log = 0;
-                g_temp_miss_streak_for_log = 0;
-                temp_proxy_K = 300.0;
-                last_heater_set = std::numeric_limits<double>::quiet_NaN();
-                last_effusion_set = std::numeric_limits<double>::quiet_NaN();
-                last_substrate_set = std::numeric_limits<double>::quiet_NaN();
-
               } else {
-                // Beam-off timed phases consume phase time only.
+                // Queue, warmup, cooldown, and not-yet-ready thermal-prep ticks
+                // do not consume execution time and do not accumulate live streaks.
                 underflux_streak = 0;
                 temp_miss_streak = 0;
                 g_underflux_streak_for_log = 0;
                 g_temp_miss_streak_for_log = 0;
-
-                rj.phase_ticks_completed += 1;
-                rj.remaining_phase_ticks -= 1;
-
-                std::ostringstream oss;
-                oss << "[sched] tick=" << tickIndex
-                    << " job " << controllingJobIndex
-                    << " completed one non-growth phase tick"
-                    << " (phase_completed=" << rj.phase_ticks_completed
-                    << ", phase_remaining=" << rj.remaining_phase_ticks
-                    << ")\n";
-                log_msg(oss.str());
-
-                if (rj.remaining_phase_ticks <= 0) {
-                  rj.done = true;
-                  rj.state = JobRunState::Done;
-                  rj.actual_phase_end_tick = tickIndex;
-
-                  std::ostringstream done_oss;
-                  done_oss << "[sched] tick=" << tickIndex
-                           << " job " << controllingJobIndex
-                           << " DONE"
-                           << " (requested_start=" << rj.requested_start_tick
-                           << ", actual_phase_start=" << rj.actual_phase_start_tick
-                           << ", actual_phase_end=" << rj.actual_phase_end_tick
-                           << ", phase_ticks_completed=" << rj.phase_ticks_completed
-                           << ", live_ticks_completed=" << rj.live_ticks_completed
-                           << ")\n";
-                  log_msg(done_oss.str());
-
-                  logJobIndexAfterAccounting = controllingJobIndex;
-                  controllingJobIndex = -1;
-                  last_heater_set = std::numeric_limits<double>::quiet_NaN();
-                  last_effusion_set = std::numeric_limits<double>::quiet_NaN();
-                  last_substrate_set = std::numeric_limits<double>::quiet_NaN();
-                }
               }
 
             } else {
-              // Queue, warmup, cooldown, and not-yet-ready thermal-prep ticks
-              // do not consume execution time and do not accumulate live streaks.
+              // No controller -> clear streaks in logs.
               underflux_streak = 0;
               temp_miss_streak = 0;
               g_underflux_streak_for_log = 0;
               g_temp_miss_streak_for_log = 0;
             }
 
-          } else {
-            // No controller -> clear streaks in logs.
-            underflux_streak = 0;
-            temp_miss_streak = 0;
-            g_underflux_streak_for_log = 0;
-            g_temp_miss_streak_for_log = 0;
+            // ---- 7) Emit post-accounting logs for the same tick ----
+            emitPostAccountingLogs(
+                tickIndex,
+                t_phys,
+                logJobIndexAfterAccounting,
+                raw_job_flux_cm2s,
+                sparta_flux_cm2s,
+                deposition_requested,
+                effusionDemand_W,
+                substrateDemand_W,
+                target_T_K,
+                scheduler_substrate_target_K_log,
+                phase_ready_for_execution_log,
+                mbe_flag,
+                effusion_ready,
+                wafer_ready);
+          
+            // ---- 8) Dynamic stop detection: require true full-idle for 10 consecutive ticks
+            const bool anyUnfinishedJobsRemain = scheduler.anyUnfinished();
+
+            const bool noController        = (controllingJobIndex == -1);
+            const bool noEffusionDemand    = (effusionDemand_W <= 1e-9);
+            const bool noSubstrateDemand   = (substrateDemand_W <= 1e-9);
+            const bool beamOff             = (mbe_flag <= 0.5);
+            const bool workloadFullyIdle   =
+                noController &&
+                !anyUnfinishedJobsRemain &&
+                noEffusionDemand &&
+                noSubstrateDemand &&
+                beamOff;
+
+            if (workloadFullyIdle) {
+              fullyIdleStreak += 1;
+            } else {
+              fullyIdleStreak = 0;
+            }
+
+            if (!dynamicStopTriggered && fullyIdleStreak >= graceTicks) {
+              dynamicStopTriggered = true;
+              dynamicStopTick = tickIndex;
+
+              LineBuffer& oss = line.clear();
+              oss << "[sched] dynamic stop triggered at tick=" << tickIndex
+                  << " after " << graceTicks
+                  << " consecutive fully-idle ticks.\n";
+              log_msg(oss.str());
+            }
+
+            // ---- 9) Fast-forward to just before the next release when idle ----
+            if (fastForward.config().enabled && !dynamicStopTriggered &&
+                noController && !scheduler.hasQueued() &&
+                noEffusionDemand && noSubstrateDemand && beamOff &&
+                last_mbe_sent <= 0.5 &&
+                scheduler.nextReleaseTick() != std::numeric_limits<int>::max()) {
+              const int lastSkipped = std::min(scheduler.nextReleaseTick() - 1, NTICKS);
+              const int n = lastSkipped - tickIndex;
+              if (n >= fastForward.config().min_ticks && fastForward.thermallyIdle()) {
+                const FastForwardSpan span = fastForward.advance(tickIndex + 1, n, dt);
+                fastForwardTicks = n;
+
+                LineBuffer& oss = line.clear();
+                oss << "[ff] tick=" << tickIndex
+                    << " fast-forwarded ticks " << span.first_tick << ".." << span.last_tick
+                    << " (" << n << " ticks, sun=" << span.sun_ticks
+                    << " eclipse=" << span.eclipse_ticks
+                    << ", battery " << span.battery_start_Wh << " -> " << span.battery_end_Wh
+                    << " Wh)\n";
+                log_msg(oss.str());
+              }
+            }
+
+          } // end if (isLeader)
+
+          // ---------------- control plane: one packed Ibcast per tick ----------
+          // Leader: stop flag, orbit solar scale, current beam parameters and,
+          // at coupling points, the advance / reload / hot-update decision.
+          // Pipelined coupling keeps its own reconcile path on the wake
+          // communicator and only needs the Reconcile bit.
+          const bool couplePoint = (i % args.coupleEvery == 0);
+          hotNow.assign(wake.hotNames().size(), std::numeric_limits<double>::quiet_NaN());
+          if (isLeader) {
+            tickCtl.tick        = tickIndex;
+            tickCtl.skip_ticks  = fastForwardTicks;
+            tickCtl.solar_scale = thermalSolarScale;
+            tickCtl.Fwafer_cm2s = last_Fwafer_sent;
+            tickCtl.mbe_active  = last_mbe_sent;
+            tickCtl.set(TickControl::Stop, dynamicStopTriggered);
+            tickCtl.set(TickControl::Reconcile, wakePipelined && wake.paramsPending());
+
+            bool advance = true;
+            if (!dynamicStopTriggered && couplePoint && wake.gatesAdvance()) {
+              advance = wake.shouldAdvance(TickContext{tickIndex, t_phys, dt}, args.spartaBlock);
+            }
+            tickCtl.set(TickControl::Advance, advance);
+
+            if (!wakePipelined && !dynamicStopTriggered && couplePoint && advance) {
+              bool reload = false;
+              std::vector<double>& hot = hotPending;
+              wake.takePending(reload, hot);
+              for (std::size_t k = 0; k < hot.size() && !reload; ++k) {
+                if (!std::isfinite(hot[k])) continue;
+                const std::string& name = wake.hotNames()[k];
+                if (name == "Fwafer_cm2s") {
+                  tickCtl.Fwafer_cm2s = hot[k];
+                  tickCtl.set(TickControl::HotFwafer);
+                } else if (name == "mbe_active") {
+                  tickCtl.mbe_active = hot[k];
+                  tickCtl.set(TickControl::HotMbe);
+                } else {
+                  reload = true;  // not representable in TickControl
+                }
+              }
+              tickCtl.set(TickControl::Reload, reload);
+            }
+            tickCtlReq = postTickControl(tickCtl, 0, run.comm);
+          }
+          {
+            SF_PROFILE_SCOPE(ProfileCat::Mpi, "MPI_Wait(tick_control)");
+            FlightScope flightWait("MPI_Wait(tick_control)");
+            MPI_Wait(&tickCtlReq, MPI_STATUS_IGNORE);
           }
 
-          // ---- 7) Emit post-accounting logs for the same tick ----
-          emitPostAccountingLogs(
-              tickIndex,
-              t_phys,
-              logJobIndexAfterAccounting,
-              raw_job_flux_cm2s,
-              sparta_flux_cm2s,
-              deposition_requested,
-              effusionDemand_W,
-              substrateDemand_W,
-              target_T_K,
-              scheduler_substrate_target_K_log,
-              phase_ready_for_execution_log,
-              mbe_flag,
-              effusion_ready,
-              wafer_ready);
-          
-          // ---- 8) Dynamic stop detection: require true full-idle for 10 consecutive ticks
-          bool anyUnfinishedJobsRemain = false;
-          for (const auto& rj : runtimeJobs) {
-            if (!rj.done && !rj.aborted) {
-              anyUnfinishedJobsRemain = true;
-              break;
+          if (!isLeader) {
+            thermalSolarScale   = tickCtl.solar_scale;
+            g_orbit_solar_scale = thermalSolarScale;
+            substrateHeater.setOrbitThermalEnvironment(thermalSolarScale);
+            effCell.setOrbitThermalEnvironment(thermalSolarScale);
+          }
+
+          const int stopNow      = tickCtl.has(TickControl::Stop) ? 1 : 0;
+          const int reconcileNow = tickCtl.has(TickControl::Reconcile) ? 1 : 0;
+          const int advanceNow   = tickCtl.has(TickControl::Advance) ? 1 : 0;
+          if (!tickCtl.has(TickControl::Reload)) {
+            for (std::size_t k = 0; k < hotNow.size(); ++k) {
+              const std::string& name = wake.hotNames()[k];
+              if (name == "Fwafer_cm2s" && tickCtl.has(TickControl::HotFwafer)) hotNow[k] = tickCtl.Fwafer_cm2s;
+              if (name == "mbe_active" && tickCtl.has(TickControl::HotMbe)) hotNow[k] = tickCtl.mbe_active;
             }
           }
 
-          const bool noController        = (controllingJobIndex == -1);
-          const bool noEffusionDemand    = (effusionDemand_W <= 1e-9);
-          const bool noSubstrateDemand   = (substrateDemand_W <= 1e-9);
-          const bool beamOff             = (mbe_flag <= 0.5);
-          const bool workloadFullyIdle   =
-              noController &&
-              !anyUnfinishedJobsRemain &&
-              noEffusionDemand &&
-              noSubstrateDemand &&
-              beamOff;
-
-          if (workloadFullyIdle) {
-            fullyIdleStreak += 1;
-          } else {
-            fullyIdleStreak = 0;
+          if (stopNow) {
+            if (isLeader) {
+              LineBuffer& oss = line.clear();
+              oss << "[info] Breaking main wake loop at tick=" << dynamicStopTick
+                  << " due to dynamic stop.\n";
+              log_msg(oss.str());
+            }
+            break;
           }
 
-          if (!dynamicStopTriggered && fullyIdleStreak >= graceTicks) {
-            dynamicStopTriggered = true;
-            dynamicStopTick = tickIndex;
+          // ---------------- SPARTA coupling block ----------------
+          if (couplePoint && !advanceNow) {
+            if (isLeader) {
+              LineBuffer& oss = line.clear();
+              oss << "[cpl] tick=" << tickIndex
+                  << " skipping SPARTA block (steady wake or cached response)\n";
+              log_msg(oss.str());
+            }
+          } else if (couplePoint) {
+            log_rank_progress(tickIndex, "before-couple");
+
+            if (isLeader) {
+              LineBuffer& oss = line.clear();
+              oss << "[cpl] tick=" << tickIndex
+                  << " ENTER SPARTA block (spartaBlock="
+                  << args.spartaBlock << ")\n";
+              log_msg(oss.str());
+            }
 
-            std::ostringstream oss;
-            oss << "[sched] dynamic stop triggered at tick=" << tickIndex
-                << " after " << graceTicks
-                << " consecutive fully-idle ticks.\n";
-            log_msg(oss.str());
+            {
+              SF_PROFILE_SCOPE(ProfileCat::Loop, "wake.couple");
+              if (wakePipelined) {
+                wake.advancePipelined(args.spartaBlock, reconcileNow != 0);
+              } else {
+                wake.runDecided(args.spartaBlock, tickCtl.has(TickControl::Reload), hotNow);
+              }
+            }
+
+            if (isLeader) {
+              LineBuffer& oss = line.clear();
+              oss << "[cpl] tick=" << tickIndex
+                  << " EXIT  SPARTA block\n";
+              log_msg(oss.str());
+            }
+
+            log_rank_progress(tickIndex, "after-couple");
           }
+          // No end-of-tick barrier: the next TickControl already orders ranks.
 
-        } // end if (isLeader)
+          // Resume past any fast-forwarded ticks.
+          i += tickCtl.skip_ticks;
 
-        // rank 0 needs all other ranks to catch up in case of dynamic end
-        // makes sure all recieve the stop condition
-        int stopNow = 0;
-        if (isLeader && dynamicStopTriggered) {
-          stopNow = 1;
-        }
+          // ---------------- checkpoint (all ranks, after tick i + 1) ----------
+          if (ckptEvery > 0 && i + 1 >= nextCkptTick) {
+            const double c0 = MPI_Wtime();
+            const int doneTick = i + 1;
+            nextCkptTick = (doneTick / ckptEvery + 1) * ckptEvery;
 
-        MPI_Bcast(&stopNow, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            const std::string restart = ckptDir + "/wake_" + std::to_string(doneTick) + ".restart";
+            CheckpointWriter ckpt;
+            const bool restartWritten = wake.writeCheckpoint(ckpt, restart);
 
-        if (stopNow) {
-          if (isLeader) {
-            std::ostringstream oss;
-            oss << "[info] Breaking main wake loop at tick=" << dynamicStopTick
-                << " due to dynamic stop.\n";
-            log_msg(oss.str());
+            if (isLeader) {
+              saveHarnessState(ckpt);
+              for (const auto& kv : Logger::instance().fileOffsets()) {
+                ckpt.setInt("log." + kv.first, static_cast<std::int64_t>(kv.second));
+              }
+              ckpt.setText("resume.fingerprint", runFingerprint);
+              ckpt.setText("resume.restart", restartWritten ? restart : std::string());
+              ckpt.setInt("resume.next_i", doneTick);
+
+              std::error_code ec;
+              std::filesystem::create_directories(ckptDir, ec);
+              std::uint64_t bytes = ckpt.writeFile(ckptFile);
+
+              // The new checkpoint is in place; the previous restart file is
+              // no longer referenced.
+              if (restartWritten) {
+                const auto rbytes = std::filesystem::file_size(restart, ec);
+                if (!ec) bytes += static_cast<std::uint64_t>(rbytes);
+              }
+              if (!lastRestart.empty() && lastRestart != restart) {
+                std::filesystem::remove(lastRestart, ec);
+              }
+              lastRestart = restartWritten ? restart : std::string();
+
+              const double ms = (MPI_Wtime() - c0) * 1.0e3;
+              ++ckptCount;
+              ckptBytes   += bytes;
+              ckptSeconds += ms * 1.0e-3;
+
+              LineBuffer& oss = line.clear();
+              oss << "[ckpt] tick=" << doneTick
+                  << " bytes=" << bytes
+                  << " restart=" << (restartWritten ? restart : std::string("none"))
+                  << " ms=" << ms << "\n";
+              log_msg(oss.str());
+            }
           }
-          break;
         }
 
-        // ---------------- SPARTA coupling block ----------------
-        if (i % args.coupleEvery == 0) {
-          log_rank_progress(tickIndex, "before-runIfDirtyOrAdvanceCollective");
+        if (rank == 0) {
+          log_msg("[info] wake main loop completed; shutting down.\n");
+        }
 
-          if (isLeader) {
-            std::ostringstream oss;
-            oss << "[cpl] tick=" << tickIndex
-                << " ENTER wake.runIfDirtyOrAdvanceCollective(spartaBlock="
-                << args.spartaBlock << ")\n";
-            log_msg(oss.str());
-          }
+        if (wakePipelined && rank == 0) {
+          const WakeChamber::PipelineStats st = wake.pipelineStats();
+          std::ostringstream oss;
+          oss << "[cpl] pipeline: blocks=" << st.blocks
+              << " sparta_s=" << st.sparta_s
+              << " leader_wait_s=" << st.leader_wait_s
+              << " overlap=" << st.overlap() << "\n";
+          log_msg(oss.str());
+        }
 
-          wake.runIfDirtyOrAdvanceCollective(args.spartaBlock);
+        if (ckptEvery > 0 && rank == 0) {
+          const double loop_s = MPI_Wtime() - loopStart;
+          std::ostringstream oss;
+          oss << "[ckpt] checkpoints: every=" << ckptEvery
+              << " count=" << ckptCount
+              << " bytes=" << ckptBytes
+              << " seconds=" << ckptSeconds
+              << " overhead=" << (loop_s > 0.0 ? 100.0 * ckptSeconds / loop_s : 0.0) << "%\n";
+          log_msg(oss.str());
+        }
 
-          if (isLeader) {
-            std::ostringstream oss;
-            oss << "[cpl] tick=" << tickIndex
-                << " EXIT  wake.runIfDirtyOrAdvanceCollective(...)\n";
-            log_msg(oss.str());
-          }
+        if (fastForward.config().enabled && rank == 0) {
+          std::ostringstream oss;
+          oss << "[ff] fast-forward: spans=" << fastForward.spans()
+              << " ticks_skipped=" << fastForward.ticksSkipped() << "\n";
+          log_msg(oss.str());
+        }
 
-          log_rank_progress(tickIndex, "after-runIfDirtyOrAdvanceCollective");
+        if (wake.gatesAdvance() && rank == 0) {
+          const WakeChamber::AdaptiveStats st = wake.adaptiveStats();
+          std::ostringstream oss;
+          oss << "[cpl] adaptive: advanced=" << st.advanced
+              << " skipped=" << st.skipped
+              << " skipped_steps=" << st.skipped_steps
+              << " saved_s_est=" << st.saved_s_est << "\n";
+          log_msg(oss.str());
         }
+        if (wake.responseCache() && rank == 0) {
+          const WakeResponseCache::Stats& st = wake.responseCache()->stats();
+          std::ostringstream oss;
+          oss << "[cpl] wake-response cache: hits=" << st.hits
+              << " interpolated=" << st.interpolated
+              << " misses=" << st.misses
+              << " stale=" << st.stale
+              << " stored=" << st.stored << "\n";
+          log_msg(oss.str());
+        }
+        reportAllocs();
+        if (wake.warmStartCache() && rank == 0) {
+          const WarmStartCache::Stats& st = wake.warmStartCache()->stats();
+          std::ostringstream oss;
+          oss << "[cpl] warm-start cache: hits=" << st.hits
+              << " misses=" << st.misses
+              << " stored=" << st.stored
+              << " abandoned=" << st.abandoned << "\n";
+          log_msg(oss.str());
+        }
+
+        wake.shutdown();
+        if (wakeComm != run.comm) {
+          MPI_Comm_free(&wakeComm);
+        }
+        engine.shutdown();
+
+        // GrowthMonitor has archived every job now.
+        if (dataset.isOpen()) {
+          try {
+            dataset.writeWaferMaps(growth.archivePath());
+          } catch (const std::exception& e) {
+            log_msg(std::string("[dataset] no wafer maps: ") + e.what() + "\n");
+          }
+          const std::uint64_t rows = dataset.rows();
+          dataset.close();
+          std::ostringstream oss;
+          oss << "[dataset] " << rows << " row(s) in " << dataset.directory() << "\n";
+          log_msg(oss.str());
+        }
+        return;
+      }
+    };
 
-        // Ensure all ranks stay roughly in sync
-        MPI_Barrier(MPI_COMM_WORLD);
+    // ======================================================================
+    // MODE: farm (many job files, one wake harness per rank group)
+    // ======================================================================
+    if (args.mode == "farm") {
+      if (args.checkpointEvery > 0 || args.resume) {
+        log_msg("[warn] --checkpoint-every / --resume do not apply to farm mode; ignoring.\n");
+        args.checkpointEvery = 0;
+        args.resume = false;
+      }
+      const std::vector<FarmJob> farmJobs = JobFarm::loadJobs(args.farmJobs, args.sweepJobsDir);
+
+      FarmOptions opt;
+      opt.group_size = std::max(1, args.farmGroupSize);
+      opt.input_dir  = args.inputDir;
+      opt.work_dir   = Logger::directory() + "/farm";
+      const int groups = JobFarm::groupCount(size, opt.group_size);
+
+      if (rank == 0) {
+        // Job files can come from several directories (paths and dir/globs).
+        std::vector<std::string> jobDirs;
+        for (const FarmJob& j : farmJobs) {
+          const std::string d = std::filesystem::path(j.path).parent_path().string();
+          if (std::find(jobDirs.begin(), jobDirs.end(), d) == jobDirs.end()) jobDirs.push_back(d);
+        }
+        std::ostringstream oss;
+        oss << "[info] Farm: " << farmJobs.size() << " job file(s) from ";
+        for (std::size_t i = 0; i < jobDirs.size(); ++i) {
+          oss << (i ? ", " : "") << (jobDirs[i].empty() ? std::string(".") : jobDirs[i]);
+        }
+        oss
+            << " over " << groups << " group(s) of " << (size > 1 ? opt.group_size : 1) << " rank(s)";
+        if (size > 1) {
+          const int idle = size - 1 - groups * opt.group_size;
+          oss << ", rank 0 dispatching";
+          if (idle > 0) oss << ", " << idle << " rank(s) idle";
+        }
+        oss << "\n";
+        log_msg(oss.str());
       }
 
+      Args jobArgs = args;
+      jobArgs.mode = "wake";
+      const double t0 = MPI_Wtime();
+      const auto results = JobFarm::run(
+          MPI_COMM_WORLD, farmJobs, opt,
+          [&](MPI_Comm group, int g, const FarmJob& job, const std::string& groupInput) {
+            int grank = 0;
+            MPI_Comm_rank(group, &grank);
+            const std::string tag = "[g" + std::to_string(g) + " " + job.run_id + "] ";
+
+            HarnessRun run;
+            run.comm     = group;
+            run.jobsPath = job.path;
+            run.subdir   = job.run_id;
+            run.log      = [grank, tag](const std::string& s) {
+              if (grank == 0) std::cerr << tag << s;
+            };
+            Args a = jobArgs;
+            a.inputDir = groupInput;
+            runHarness(run, a);
+            Logger::instance().closeStreams(run.subdir + "/");
+          });
+
       if (rank == 0) {
-        log_msg("[info] wake main loop completed; shutting down.\n");
+        JobFarm::writeTable(farmJobs, results);
+        double busy = 0.0;
+        for (const auto& r : results) busy += r.wall_s;
+        std::ostringstream oss;
+        oss << "[farm] " << results.size() << " job(s) over " << groups << " group(s) in "
+            << (MPI_Wtime() - t0) << " s (" << busy << " s of job time)\n";
+        log_msg(oss.str());
+      }
+
+      flush_logger();
+      MPI_Barrier(MPI_COMM_WORLD);
+      MPI_Finalize();
+      return EXIT_SUCCESS;
+    }
+
+    if (args.mode == "power" || args.mode == "legacy" || args.mode == "wake" || args.mode == "dual") {
+      // Look for the --job-file argument passed from the bash script.
+      std::string jobFileName = "V4_job1.txt"; // Fallback default
+      for (int i = 1; i < argc; ++i) {
+          if (std::string(argv[i]) == "--job-file" && i + 1 < argc) {
+              jobFileName = argv[i + 1];
+              break;
+          }
       }
 
-      wake.shutdown();
-      engine.shutdown();
+      HarnessRun run;
+      run.jobsPath = args.inputDir + "/" + jobFileName;
+      run.log      = log_msg;
+      runHarness(run, args);
+
+      flush_logger();
       MPI_Barrier(MPI_COMM_WORLD);
       MPI_Finalize();
       return EXIT_SUCCESS;
@@ -2339,7 +3339,7 @@ int main(int argc, char** argv) {
     if (rank == 0) {
       std::ostringstream oss;
       oss << "[fatal] Unknown mode '" << args.mode
-          << "'. Expected 'dual', 'legacy', 'wake', or 'power'.\n";
+          << "'. Expected one of dual, legacy, wake, power, ensemble, mission, sweep, branch, farm.\n";
       log_msg(oss.str());
       print_usage();
     }
@@ -2350,6 +3350,7 @@ int main(int argc, char** argv) {
     std::ostringstream oss;
     oss << "[fatal] std::exception on rank " << rank << ": " << e.what() << "\n";
     log_msg(oss.str());
+    try { Logger::instance().flush(); } catch (...) {}
     MPI_Abort(MPI_COMM_WORLD, 1);
     return EXIT_FAILURE;
   }
@@ -2357,6 +3358,7 @@ int main(int argc, char** argv) {
     std::ostringstream oss;
     oss << "[fatal] Unknown non-std exception on rank " << rank << "\n";
     log_msg(oss.str());
+    try { Logger::instance().flush(); } catch (...) {}
     MPI_Abort(MPI_COMM_WORLD, 1);
     return EXIT_FAILURE;
   }
@@ -1,12 +1,24 @@
 #include "orbit.hpp"
 
 #include <cmath>
+#include <limits>
 
 // Simple local constant for pi so we do not rely on M_PI.
 static constexpr double ORBIT_PI       = 3.141592653589793;
 // Forced orbital period: 94 minutes (in seconds).
 static constexpr double ORBIT_PERIOD_S = 94.0 * 60.0;
 
+// Wrap an angle into [0, 2*pi).
+static double wrap_two_pi(double a)
+{
+    double two_pi = 2.0 * ORBIT_PI;
+    a = std::fmod(a, two_pi);
+    if (a < 0.0) {
+        a += two_pi;
+    }
+    return a;
+}
+
 // Constructor
 OrbitModel::OrbitModel(double altitude_m,
                        double dt_s,
@@ -28,6 +40,7 @@ OrbitModel::OrbitModel(double altitude_m,
 
     // Compute n_rad_s_ and period_s_ (will be forced to 94 min).
     update_orbit_parameters();
+    update_eclipse_geometry();
 
     // Start at t = 0, theta = 0 by default
     state_.t_orbit_s = 0.0;
@@ -70,10 +83,47 @@ void OrbitModel::step()
 // Recompute position, velocity, and sunlight based on theta_rad and t_orbit_s.
 void OrbitModel::recompute_state()
 {
+    state_ = compute_state(state_.t_orbit_s, state_.theta_rad);
+}
+
+// Advance by several dt_s steps in closed form.
+void OrbitModel::advance(long steps)
+{
+    if (steps <= 0) {
+        return;
+    }
+    state_ = stateAfter(steps);
+}
+
+// State after several dt_s steps, without touching the model.
+OrbitState OrbitModel::stateAfter(long steps) const
+{
+    const double span_s = static_cast<double>(steps) * dt_s_;
+
+    double two_pi = 2.0 * ORBIT_PI;
+    double theta = std::fmod(state_.theta_rad + n_rad_s_ * span_s, two_pi);
+    if (theta < 0.0) {
+        theta += two_pi;
+    }
+
+    return compute_state(state_.t_orbit_s + span_s, theta);
+}
+
+// Position, velocity, and sunlight for a given orbit time and angle.
+OrbitState OrbitModel::compute_state(double t_orbit_s, double theta_rad) const
+{
+    if (ephemerisEnabled()) {
+        return compute_state_table(t_orbit_s, theta_rad);
+    }
+
+    OrbitState out;
+    out.t_orbit_s = t_orbit_s;
+    out.theta_rad = theta_rad;
+
     // 1) Position in orbital plane (circular orbit: r = a_m_)
     double r  = a_m_;
-    double ct = std::cos(state_.theta_rad);
-    double st = std::sin(state_.theta_rad);
+    double ct = std::cos(out.theta_rad);
+    double st = std::sin(out.theta_rad);
 
     double x_orb = r * ct;
     double y_orb = r * st;
@@ -87,9 +137,9 @@ void OrbitModel::recompute_state()
     double y_eci = y_orb * ci;
     double z_eci = y_orb * si;
 
-    state_.x_m = x_eci;
-    state_.y_m = y_eci;
-    state_.z_m = z_eci;
+    out.x_m = x_eci;
+    out.y_m = y_eci;
+    out.z_m = z_eci;
 
     // 3) Velocity in orbital plane
     // v magnitude = r * n for circular orbit
@@ -101,9 +151,9 @@ void OrbitModel::recompute_state()
     double vy_eci = vy_orb * ci;
     double vz_eci = vy_orb * si;
 
-    state_.vx_mps = vx_eci;
-    state_.vy_mps = vy_eci;
-    state_.vz_mps = vz_eci;
+    out.vx_mps = vx_eci;
+    out.vy_mps = vy_eci;
+    out.vz_mps = vz_eci;
 
     // 4) Simple sunlight / eclipse geometry.
 
@@ -127,7 +177,7 @@ void OrbitModel::recompute_state()
 
     // "In sun" if the sub-solar point is on the same side of Earth as the spacecraft.
     bool in_sun = (cos_alpha > 0.0);
-    state_.in_sun = in_sun;
+    out.in_sun = in_sun;
 
     // 5) Time-based sinusoidal solar scale, locked to the 94-min period.
     //
@@ -146,7 +196,7 @@ void OrbitModel::recompute_state()
     //   - if in_sun is false, we force s = 0
     double s_phase = 0.0;
     if (period_s_ > 0.0) {
-        double t_mod = std::fmod(state_.t_orbit_s, period_s_);
+        double t_mod = std::fmod(out.t_orbit_s, period_s_);
         if (t_mod < 0.0) {
             t_mod += period_s_;
         }
@@ -160,19 +210,143 @@ void OrbitModel::recompute_state()
     if (s < 0.0) s = 0.0;
     if (s > 1.0) s = 1.0;
 
-    state_.solar_scale = s;
+    out.solar_scale = s;
 
     // NOTE:
-    //  - state_.in_sun tells you the geometry (eclipse or not).
-    //  - state_.solar_scale is a smooth sinusoid locked to the 94-min period,
+    //  - in_sun tells you the geometry (eclipse or not).
+    //  - solar_scale is a smooth sinusoid locked to the 94-min period,
     //    starting at 1 for t=0, and zeroed in eclipse. SPARTA's CUP_SCALE can
     //    replicate this exactly from (t, period_s_) without needing the full geometry.
+
+    return out;
+}
+
+// Same quantities as compute_state(), from the ephemeris table.
+OrbitState OrbitModel::compute_state_table(double t_orbit_s, double theta_rad) const
+{
+    OrbitState out;
+    out.t_orbit_s = t_orbit_s;
+    out.theta_rad = theta_rad;
+
+    // theta_rad arrives in [0, 2*pi) from step / reset / stateAfter.
+    double ct = 0.0, st = 0.0;
+    table_cos_sin(theta_rad, ct, st);
+
+    double r = a_m_;
+    out.x_m = r * ct;
+    out.y_m = r * st * cos_incl_;
+    out.z_m = r * st * sin_incl_;
+
+    double v = r * n_rad_s_;
+    out.vx_mps = -v * st;
+    out.vy_mps =  v * ct * cos_incl_;
+    out.vz_mps =  v * ct * sin_incl_;
+
+    // Lit arc test instead of the dot product: exact, and free of trig.
+    // sun_phase_rad_ is in (-pi, pi], so one correction wraps d.
+    double two_pi = 2.0 * ORBIT_PI;
+    double d = theta_rad - sun_phase_rad_;
+    if (d < 0.0) d += two_pi;
+    if (d >= two_pi) d -= two_pi;
+    out.in_sun = (sun_amp_ > 0.0) &&
+                 (d < 0.5 * ORBIT_PI || d > 1.5 * ORBIT_PI);
+
+    double s_phase = 0.0;
+    if (period_s_ > 0.0) {
+        double u = t_orbit_s / period_s_;
+        u -= std::floor(u);
+        double c_phi = 0.0, s_phi = 0.0;
+        table_cos_sin(two_pi * u, c_phi, s_phi);
+        s_phase = 0.5 * (1.0 + c_phi);
+    }
+
+    double s = (out.in_sun ? s_phase : 0.0);
+    if (s < 0.0) s = 0.0;
+    if (s > 1.0) s = 1.0;
+    out.solar_scale = s;
+
+    return out;
+}
+
+// Linear interpolation between the two table points around angle_rad.
+void OrbitModel::table_cos_sin(double angle_rad, double &c, double &s) const
+{
+    const std::size_t m = cos_table_.size() - 1;
+    double u = angle_rad * (static_cast<double>(m) / (2.0 * ORBIT_PI));
+    if (u < 0.0) {
+        u = 0.0;
+    }
+    std::size_t k = static_cast<std::size_t>(u);
+    if (k >= m) {
+        k = m - 1;
+    }
+    double f = u - static_cast<double>(k);
+
+    c = cos_table_[k] + f * (cos_table_[k + 1] - cos_table_[k]);
+    s = sin_table_[k] + f * (sin_table_[k + 1] - sin_table_[k]);
+}
+
+// Build (or drop) the one-period ephemeris table.
+void OrbitModel::enableEphemeris(int samples_per_period)
+{
+    cos_table_.clear();
+    sin_table_.clear();
+
+    if (samples_per_period > 0) {
+        const std::size_t m = static_cast<std::size_t>(samples_per_period);
+        cos_table_.resize(m + 1);
+        sin_table_.resize(m + 1);
+        for (std::size_t k = 0; k < m; ++k) {
+            double a = 2.0 * ORBIT_PI * static_cast<double>(k) / static_cast<double>(m);
+            cos_table_[k] = std::cos(a);
+            sin_table_[k] = std::sin(a);
+        }
+        // Closing point equals the first, so interpolation wraps cleanly.
+        cos_table_[m] = cos_table_[0];
+        sin_table_[m] = sin_table_[0];
+    }
+
+    recompute_state();
+}
+
+int OrbitModel::ephemerisSamples() const
+{
+    return cos_table_.empty() ? 0 : static_cast<int>(cos_table_.size() - 1);
+}
+
+// Time at which theta next reaches target_rad, after t_s.
+double OrbitModel::next_time_at_angle(double t_s, double target_rad) const
+{
+    if (sun_amp_ <= 0.0 || n_rad_s_ <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // theta(t) = theta_rad + n * (t - t_orbit_s) for the circular orbit.
+    double theta_t = state_.theta_rad + n_rad_s_ * (t_s - state_.t_orbit_s);
+    double d = wrap_two_pi(target_rad - theta_t);
+    if (d <= 0.0) {
+        d = 2.0 * ORBIT_PI;
+    }
+    return t_s + d / n_rad_s_;
+}
+
+// Eclipse starts where the lit arc ends: theta = sun_phase + pi/2.
+double OrbitModel::nextEclipseEntry(double t_s) const
+{
+    return next_time_at_angle(t_s, sun_phase_rad_ + 0.5 * ORBIT_PI);
+}
+
+// Eclipse ends where the lit arc begins: theta = sun_phase - pi/2.
+double OrbitModel::nextEclipseExit(double t_s) const
+{
+    return next_time_at_angle(t_s, sun_phase_rad_ - 0.5 * ORBIT_PI);
 }
 
 // Change the Sun direction angle used for eclipse checks.
 void OrbitModel::set_sun_theta(double sun_theta_rad)
 {
     sun_theta_rad_ = sun_theta_rad;
+    update_eclipse_geometry();
     recompute_state();
 }
 
@@ -180,9 +354,23 @@ void OrbitModel::set_sun_theta(double sun_theta_rad)
 void OrbitModel::set_inclination(double inclination_rad)
 {
     inclination_rad_ = inclination_rad;
+    update_eclipse_geometry();
     recompute_state();
 }
 
+// With r = a (cos t, sin t cos i, sin t sin i) and Sun = (cos s, sin s, 0):
+//   r.Sun / a = cos t cos s + sin t cos i sin s = A cos(t - phase).
+void OrbitModel::update_eclipse_geometry()
+{
+    cos_incl_ = std::cos(inclination_rad_);
+    sin_incl_ = std::sin(inclination_rad_);
+
+    double bx = std::cos(sun_theta_rad_);
+    double by = cos_incl_ * std::sin(sun_theta_rad_);
+    sun_amp_       = std::sqrt(bx * bx + by * by);
+    sun_phase_rad_ = (sun_amp_ > 0.0) ? std::atan2(by, bx) : 0.0;
+}
+
 // Change the time step used by step().
 void OrbitModel::set_dt(double dt_s)
 {
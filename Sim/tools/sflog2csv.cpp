@@ -0,0 +1,203 @@
+// Sim/tools/sflog2csv.cpp
+//
+// Convert binary columnar logs (SF_LOG_FORMAT=bin, *.sfb) back into the CSV
+// layout the default Logger sink writes. Wafer archives (GrowthMonitor_*.sfw)
+// convert to the GrowthMonitor CSV layout. Compressed logs (SF_LOG_COMPRESS,
+// *.csv.gz / *.sfb.gz) are decompressed, and string columns written with
+// SF_LOG_DICT=1 are decoded through the <name>.dict.csv next to them.
+//
+//   sflog2csv data/raw/<RUN_ID>/Battery.sfb            -> Battery.csv next to it
+//   sflog2csv data/raw/<RUN_ID>/Battery.sfb out.csv
+//   sflog2csv data/raw/<RUN_ID>/Battery.sfb -          -> stdout
+//   sflog2csv data/raw/<RUN_ID>/Scheduler.csv.gz       -> Scheduler.csv
+//   sflog2csv data/raw/<RUN_ID>/Scheduler.csv          -> Scheduler.decoded.csv (dict-coded)
+//   sflog2csv data/raw/<RUN_ID>/GrowthMonitor_<RUN_ID>.sfw
+//   sflog2csv data/raw/<RUN_ID>                        -> every convertible file in the dir
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BinaryLog.hpp"
+#include "LogFile.hpp"
+#include "WaferArchive.hpp"
+
+namespace fs = std::filesystem;
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Same quoting rules as the CSV sink in Logger.cpp.
+static std::string escape_csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n\r") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char ch : s) {
+        if (ch == '"') out.push_back('"');
+        out.push_back(ch);
+    }
+    out.push_back('"');
+    return out;
+}
+
+// Row CSV (plain or compressed), with dict-coded columns decoded when the
+// stream has a dictionary.
+class CsvLogReader {
+public:
+    void open(const std::string& path) {
+        in_.open(path);
+        std::string base = path;
+        if (ends_with(base, ".gz")) base.resize(base.size() - 3);
+        base.resize(base.size() - 4);   // ".csv"
+        const std::string dict = base + ".dict.csv";
+        if (!fs::exists(dict)) return;
+
+        LogFileIn din;
+        din.open(dict);
+        std::string text;
+        char buf[65536];
+        for (std::size_t n; (n = din.read(buf, sizeof(buf))) > 0;) text.append(buf, n);
+        const auto rows = parseCsvRecords(text);
+        for (std::size_t r = 1; r < rows.size(); ++r) {
+            if (rows[r].size() != 3) continue;
+            dict_[std::stoul(rows[r][0])][std::stol(rows[r][1])] = rows[r][2];
+        }
+    }
+
+    std::size_t writeCsv(std::ostream& out) {
+        std::string line;
+        std::size_t rows = 0;
+        bool header = true;
+        while (getline_(line)) {
+            if (header || dict_.empty()) {
+                out << line << '\n';
+            } else {
+                // Coded rows are plain integers: tick,time_s,code,code,...
+                std::size_t pos = 0, field = 0;
+                while (pos <= line.size()) {
+                    std::size_t end = line.find(',', pos);
+                    if (end == std::string::npos) end = line.size();
+                    const std::string tok = line.substr(pos, end - pos);
+                    const std::string* decoded = nullptr;
+                    auto col = field >= 2 ? dict_.find(field - 2) : dict_.end();
+                    if (col != dict_.end() && !tok.empty()) {
+                        auto v = col->second.find(std::stol(tok));
+                        if (v != col->second.end()) decoded = &v->second;
+                    }
+                    if (field) out << ',';
+                    out << (decoded ? escape_csv_field(*decoded) : tok);
+                    pos = end + 1;
+                    ++field;
+                }
+                out << '\n';
+            }
+            if (!header) ++rows;
+            header = false;
+        }
+        return rows;
+    }
+
+private:
+    bool getline_(std::string& line) {
+        line.clear();
+        for (;;) {
+            if (pos_ == len_) {
+                len_ = in_.read(buf_, sizeof(buf_));
+                pos_ = 0;
+                if (len_ == 0) return !line.empty();
+            }
+            const char c = buf_[pos_++];
+            if (c == '\n') return true;
+            line.push_back(c);
+        }
+    }
+
+    LogFileIn   in_;
+    char        buf_[65536];
+    std::size_t pos_ = 0, len_ = 0;
+    std::map<std::size_t, std::map<long, std::string>> dict_;
+};
+
+template <typename Reader>
+static int convert_with(const fs::path& in, const std::string& out_arg, const fs::path& def_out) {
+    Reader reader;
+    reader.open(in.string());
+
+    if (out_arg == "-") {
+        reader.writeCsv(std::cout);
+        return 0;
+    }
+
+    fs::path out = out_arg.empty() ? def_out : fs::path(out_arg);
+    std::ofstream os(out, std::ios::out | std::ios::trunc);
+    if (!os) {
+        throw std::runtime_error("failed to open " + out.string());
+    }
+    const std::size_t rows = reader.writeCsv(os);
+    std::cerr << "[sflog2csv] " << in.string() << " -> " << out.string()
+              << " (" << rows << " rows)\n";
+    return 0;
+}
+
+// <dir>/<stem> for a log file, without the .gz and format suffixes.
+static fs::path log_stem(const fs::path& in) {
+    std::string s = in.string();
+    if (ends_with(s, ".gz")) s.resize(s.size() - 3);
+    return fs::path(s).replace_extension();
+}
+
+static bool convertible(const fs::path& p) {
+    const std::string s = p.filename().string();
+    if (ends_with(s, ".dict.csv")) return false;
+    if (ends_with(s, ".sfb") || ends_with(s, ".sfb.gz") || ends_with(s, ".sfw") ||
+        ends_with(s, ".csv.gz")) {
+        return true;
+    }
+    // Uncompressed CSV only needs converting when it is dict-coded.
+    return ends_with(s, ".csv") && fs::exists(log_stem(p).string() + ".dict.csv");
+}
+
+static int convert_one(const fs::path& in, const std::string& out_arg) {
+    const std::string s = in.string();
+    const fs::path stem = log_stem(in);
+    if (in.extension() == ".sfw") {
+        return convert_with<WaferArchiveReader>(in, out_arg, fs::path(in).replace_extension(".csv"));
+    }
+    if (ends_with(s, ".csv") || ends_with(s, ".csv.gz")) {
+        // Never write over the input.
+        const fs::path def = ends_with(s, ".gz") ? stem.string() + ".csv"
+                                                 : stem.string() + ".decoded.csv";
+        return convert_with<CsvLogReader>(in, out_arg, def);
+    }
+    return convert_with<BinaryLogReader>(in, out_arg, stem.string() + ".csv");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+        std::cout << "Usage: sflog2csv <file.sfb[.gz]|file.sfw|file.csv[.gz]|dir> [out.csv|-]\n";
+        return argc < 2 ? 1 : 0;
+    }
+
+    try {
+        const fs::path in(argv[1]);
+        if (fs::is_directory(in)) {
+            std::vector<fs::path> files;
+            for (const auto& e : fs::directory_iterator(in)) {
+                if (e.is_regular_file() && convertible(e.path())) {
+                    files.push_back(e.path());
+                }
+            }
+            for (const auto& f : files) convert_one(f, "");
+            return 0;
+        }
+        return convert_one(in, argc > 2 ? argv[2] : "");
+    } catch (const std::exception& e) {
+        std::cerr << "[sflog2csv] " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,355 @@
+// Sim/tools/sfquery.cpp
+//
+// Range and predicate queries over the CSV logs of one or many runs,
+// through a sidecar index per file (LogIndex.hpp: <file>.csv.sfidx, built
+// on first use and extended as runs append) so only blocks whose tick and
+// column bounds can match are read. Files are queried in parallel; matching
+// rows are printed as CSV led by run and stream columns.
+//
+//   sfquery data/raw --stream SimulationEngine --where job_failed=1
+//   sfquery data/raw/<RUN_ID> --ticks 100:200                  -> every stream
+//   sfquery data/raw --stream ProcessState --where 'temp_miss_streak>0'
+//           --columns tick,effusion_temp_K,effusion_target_K
+//   sfquery data/raw --stream ScheduleStateText --where scheduler_state_name=aborted --count
+//   sfquery data/raw --index-only                              -> build the indexes
+//
+// A PATH is a .csv file or a directory searched recursively; the run of a
+// file is its directory relative to PATH (PATH's own name for files right
+// in it). Terms of --where are ANDed (repeat --where to add more); a file
+// without one of the terms' columns has no matches. Only plain CSV logs
+// are indexed: convert .sfb / .csv.gz logs with sflog2csv first.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogIndex.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void usage() {
+    std::cout << "Usage: sfquery PATH... [--stream NAME[,NAME...]] [--where col<op>value[,...]]\n"
+              << "               [--ticks FIRST:LAST] [--columns a,b,...] [--count]\n"
+              << "               [--threads N] [--block-rows N] [--reindex] [--index-only] [--stats]\n"
+              << "Operators: = != < <= > >= (numeric when both sides are numbers, else text).\n";
+}
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    std::size_t pos = 0;
+    while (pos <= s.size()) {
+        std::size_t comma = s.find(',', pos);
+        if (comma == std::string::npos) comma = s.size();
+        if (comma > pos) out.push_back(s.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return out;
+}
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Same quoting rules as the CSV sink in Logger.cpp.
+std::string escape_csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n\r") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char ch : s) {
+        if (ch == '"') out.push_back('"');
+        out.push_back(ch);
+    }
+    out.push_back('"');
+    return out;
+}
+
+struct LogFileRef {
+    std::string path;
+    std::string run;
+    std::string stream;
+};
+
+// Plain CSV logs under path (SF_LOG_DICT dictionaries excluded).
+void collect(const fs::path& root, const std::vector<std::string>& streams,
+             std::vector<LogFileRef>& out) {
+    auto consider = [&](const fs::path& p, const std::string& run) {
+        const std::string name = p.filename().string();
+        if (!ends_with(name, ".csv") || ends_with(name, ".dict.csv")) return;
+        const std::string stream = name.substr(0, name.size() - 4);
+        if (!streams.empty() && std::find(streams.begin(), streams.end(), stream) == streams.end()) return;
+        out.push_back({p.string(), run, stream});
+    };
+
+    std::error_code ec;
+    if (fs::is_regular_file(root, ec)) {
+        consider(root, fs::absolute(root).lexically_normal().parent_path().filename().string());
+        return;
+    }
+    if (!fs::is_directory(root, ec)) {
+        throw std::runtime_error("no such file or directory: " + root.string());
+    }
+    const std::string root_name = fs::absolute(root).lexically_normal().filename().string();
+    for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+         it != end; it.increment(ec)) {
+        if (ec || !it->is_regular_file(ec)) continue;
+        const fs::path rel = it->path().parent_path().lexically_relative(root);
+        const std::string run = (rel.empty() || rel == ".") ? root_name : rel.generic_string();
+        consider(it->path(), run);
+    }
+}
+
+struct Options {
+    std::vector<std::string> paths;
+    std::vector<std::string> streams;
+    std::vector<std::string> columns;
+    LogQuery    query;
+    bool        count = false, reindex = false, index_only = false, stats = false;
+    int         threads = 0;
+    std::size_t block_rows = kLogIndexBlockRows;
+};
+
+struct Result {
+    std::string   out;           // CSV rows (or the count row)
+    std::string   header;        // column part of the header, "" = no rows
+    std::string   error;
+    std::uint64_t blocks = 0, blocks_read = 0;
+    std::uint64_t bytes = 0, bytes_read = 0;
+    std::uint64_t rows = 0;
+    bool          schema_match = false;
+    bool          built = false, extended = false;
+    bool          done = false;
+};
+
+void run_one(const LogFileRef& f, const Options& opt, Result& r) {
+    LogIndex::LoadInfo info;
+    const LogIndex idx = LogIndex::load(f.path, opt.block_rows, opt.reindex, &info);
+    r.built    = info.built;
+    r.extended = info.extended;
+    r.blocks   = idx.blocks().size();
+    r.bytes    = idx.indexedBytes();
+    if (opt.index_only) return;
+
+    std::vector<int> cols;
+    if (!idx.resolve(opt.query, cols)) return;
+    r.schema_match = true;
+
+    // Output projection: -1 = column missing in this file (empty cell).
+    std::vector<int> proj;
+    if (!opt.columns.empty()) {
+        for (const std::string& c : opt.columns) proj.push_back(idx.column(c));
+        for (std::size_t i = 0; i < opt.columns.size(); ++i) {
+            r.header += (i ? "," : "") + escape_csv_field(opt.columns[i]);
+        }
+    } else {
+        for (std::size_t i = 0; i < idx.columns().size(); ++i) {
+            r.header += (i ? "," : "") + escape_csv_field(idx.columns()[i]);
+        }
+    }
+
+    std::FILE* fp = std::fopen(f.path.c_str(), "rb");
+    if (!fp) throw std::runtime_error("cannot open " + f.path);
+
+    const std::string prefix = escape_csv_field(f.run) + "," + escape_csv_field(f.stream) + ",";
+    std::string block, line;
+    std::vector<std::string> fields;
+    try {
+        for (std::size_t b = 0; b < idx.blocks().size(); ++b) {
+            if (!idx.mayMatch(b, opt.query, cols)) continue;
+            idx.readBlock(fp, b, block);
+            ++r.blocks_read;
+            r.bytes_read += block.size();
+
+            std::size_t pos = 0;
+            while (LogIndex::nextRecord(block, pos, line)) {
+                LogIndex::splitRecord(line, fields);
+                if (!LogIndex::rowMatches(fields, opt.query, cols)) continue;
+                ++r.rows;
+                if (opt.count) continue;
+                r.out += prefix;
+                if (proj.empty()) {
+                    r.out += line;
+                } else {
+                    for (std::size_t i = 0; i < proj.size(); ++i) {
+                        if (i) r.out += ',';
+                        const int c = proj[i];
+                        if (c >= 0 && static_cast<std::size_t>(c) < fields.size()) {
+                            r.out += escape_csv_field(fields[static_cast<std::size_t>(c)]);
+                        }
+                    }
+                }
+                r.out += '\n';
+            }
+        }
+    } catch (...) {
+        std::fclose(fp);
+        throw;
+    }
+    std::fclose(fp);
+
+    if (opt.count) {
+        r.out = prefix + std::to_string(r.rows) + "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+        usage();
+        return argc < 2 ? 1 : 0;
+    }
+
+    Options opt;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (a == "--stream" && i + 1 < argc) {
+                for (const std::string& s : split_list(argv[++i])) opt.streams.push_back(s);
+            } else if (a == "--where" && i + 1 < argc) {
+                opt.query.addTerms(argv[++i]);
+            } else if (a == "--ticks" && i + 1 < argc) {
+                const std::string r = argv[++i];
+                const std::size_t colon = r.find(':');
+                if (colon == std::string::npos) throw std::runtime_error("--ticks wants FIRST:LAST");
+                const std::string lo = r.substr(0, colon), hi = r.substr(colon + 1);
+                opt.query.addTickRange(lo.empty() ? 0L : std::atol(lo.c_str()),
+                                       hi.empty() ? 2147483647L : std::atol(hi.c_str()));
+            } else if (a == "--columns" && i + 1 < argc) {
+                opt.columns = split_list(argv[++i]);
+            } else if (a == "--threads" && i + 1 < argc) {
+                opt.threads = std::atoi(argv[++i]);
+            } else if (a == "--block-rows" && i + 1 < argc) {
+                opt.block_rows = static_cast<std::size_t>(std::max(1L, std::atol(argv[++i])));
+            } else if (a == "--count")      opt.count = true;
+            else if (a == "--reindex")      opt.reindex = true;
+            else if (a == "--index-only")   opt.index_only = true;
+            else if (a == "--stats")        opt.stats = true;
+            else if (!a.empty() && a[0] == '-') {
+                usage();
+                return 1;
+            } else {
+                opt.paths.push_back(a);
+            }
+        }
+        if (opt.paths.empty()) {
+            usage();
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[sfquery] " << e.what() << "\n";
+        return 1;
+    }
+
+    std::vector<LogFileRef> files;
+    try {
+        for (const std::string& p : opt.paths) {
+            const std::size_t first = files.size();
+            collect(p, opt.streams, files);
+            std::sort(files.begin() + static_cast<std::ptrdiff_t>(first), files.end(),
+                      [](const LogFileRef& a, const LogFileRef& b) { return a.path < b.path; });
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[sfquery] " << e.what() << "\n";
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t nthreads = std::min<std::size_t>(
+        files.size(), opt.threads > 0 ? static_cast<std::size_t>(opt.threads) : hw);
+
+    // Workers take files in order; the main thread prints them in order as
+    // they finish, so output does not wait for the slowest file.
+    std::vector<Result> results(files.size());
+    std::atomic<std::size_t> next{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < nthreads; ++t) {
+        pool.emplace_back([&] {
+            for (;;) {
+                const std::size_t i = next.fetch_add(1);
+                if (i >= files.size()) return;
+                Result r;
+                try {
+                    run_one(files[i], opt, r);
+                } catch (const std::exception& e) {
+                    r.error = e.what();
+                }
+                std::lock_guard<std::mutex> lk(mtx);
+                r.done = true;
+                results[i] = std::move(r);
+                cv.notify_all();
+            }
+        });
+    }
+
+    Result total;
+    std::size_t built = 0, extended = 0, matched_files = 0, errors = 0;
+    std::string last_header;
+    bool any_header = false;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        Result r;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cv.wait(lk, [&] { return results[i].done; });
+            r = std::move(results[i]);
+            results[i] = Result{};
+        }
+        if (!r.error.empty()) {
+            std::cerr << "[sfquery] " << files[i].path << ": " << r.error << "\n";
+            ++errors;
+            continue;
+        }
+        built    += r.built ? 1 : 0;
+        extended += r.extended ? 1 : 0;
+        total.blocks      += r.blocks;
+        total.blocks_read += r.blocks_read;
+        total.bytes       += r.bytes;
+        total.bytes_read  += r.bytes_read;
+        total.rows        += r.rows;
+        if (opt.index_only || !r.schema_match) continue;
+        ++matched_files;
+
+        if (opt.count) {
+            if (!any_header) std::cout << "run,stream,rows\n";
+            any_header = true;
+            std::cout << r.out;
+        } else if (r.rows > 0) {
+            // A new header whenever the column set changes between files.
+            if (!any_header || r.header != last_header) {
+                std::cout << "run,stream," << r.header << '\n';
+                last_header = r.header;
+                any_header = true;
+            }
+            std::cout << r.out;
+        }
+    }
+    for (std::thread& t : pool) t.join();
+    std::cout.flush();
+
+    if (opt.stats || opt.index_only) {
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cerr << "[sfquery] files=" << files.size()
+                  << " with_columns=" << matched_files
+                  << " indexed=" << built << " extended=" << extended
+                  << " blocks_read=" << total.blocks_read << "/" << total.blocks
+                  << " bytes_read=" << total.bytes_read << "/" << total.bytes
+                  << " rows=" << total.rows
+                  << " threads=" << nthreads
+                  << " seconds=" << secs << "\n";
+    }
+    return errors ? 1 : 0;
+}
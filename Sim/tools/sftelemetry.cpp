@@ -0,0 +1,167 @@
+// Sim/tools/sftelemetry.cpp
+//
+// Reader for the live telemetry ring (sim --telemetry NAME, see
+// TelemetryRing.hpp): follows the records as CSV, shows the schema, or posts
+// control messages when the sim runs with --telemetry-control.
+//
+//   sftelemetry NAME                         -> CSV rows from the next record until the sim ends
+//   sftelemetry NAME --from-start            -> from the oldest record still in the ring
+//   sftelemetry NAME --count N               -> stop after N rows
+//   sftelemetry NAME --wait S                -> wait up to S seconds for the segment to appear
+//   sftelemetry NAME --info                  -> schema, ring size and position
+//   sftelemetry NAME --set substrate_target_K=900,beam_allowed=0
+//   sftelemetry NAME --release               -> hand control back to the recipe
+//
+// Rows a slow reader lost to the ring wrapping are reported on stderr.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TelemetryRing.hpp"
+
+namespace {
+
+void usage() {
+    std::cout << "Usage: sftelemetry NAME [--from-start] [--count N] [--wait S]\n"
+              << "       sftelemetry NAME --info\n"
+              << "       sftelemetry NAME --set key=value[,key=value...] | --release\n"
+              << "Control keys: effusion_target_K, substrate_target_K, substrate_control,\n"
+              << "              source_control, beam_allowed\n";
+}
+
+void open_with_wait(TelemetryReader& r, const std::string& name, double wait_s) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration<double>(wait_s);
+    for (;;) {
+        try {
+            r.open(name);
+            return;
+        } catch (const std::runtime_error&) {
+            if (std::chrono::steady_clock::now() >= deadline) throw;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+int follow(TelemetryReader& r, bool from_start, long count) {
+    std::cout << "tick,time_s";
+    for (const std::string& c : r.columns()) std::cout << ',' << c;
+    std::cout << '\n';
+
+    const std::size_t n = r.width();
+    std::vector<double> row(n);
+    std::uint64_t next = from_start ? r.oldest() : r.head();
+    long written = 0;
+    int idle_ms = 0;
+
+    while (count < 0 || written < count) {
+        const std::uint64_t head = r.head();
+        if (next >= head) {
+            if (r.closed() && r.head() == head) break;
+            // Back off gently while the sim is between ticks.
+            idle_ms = std::min(idle_ms + 1, 20);
+            std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+            continue;
+        }
+        idle_ms = 0;
+
+        const std::uint64_t oldest = r.oldest();
+        if (next < oldest) {
+            std::cerr << "[sftelemetry] skipped " << (oldest - next) << " overwritten record(s)\n";
+            next = oldest;
+        }
+
+        long tick = 0;
+        double time = 0.0;
+        const bool ok = r.visit(next, [&](long t, double s, const double* v) {
+            tick = t;
+            time = s;
+            std::copy(v, v + n, row.begin());
+        });
+        if (!ok) continue;   // overwritten while copying; the skip above catches up
+
+        std::cout << tick << ',' << time;
+        for (double v : row) std::cout << ',' << v;
+        std::cout << '\n';
+        ++next;
+        ++written;
+    }
+    std::cout.flush();
+    return 0;
+}
+
+int send(TelemetryReader& r, const TelemetryControl& c) {
+    const std::uint64_t before = r.controlApplied();
+    r.sendControl(c);
+    // The sim picks the message up at its next tick.
+    for (int i = 0; i < 200; ++i) {
+        if (r.controlApplied() > before) {
+            std::cout << "applied as generation " << r.controlApplied()
+                      << " at tick " << r.controlAppliedTick() << '\n';
+            return 0;
+        }
+        if (r.closed()) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    std::cerr << "[sftelemetry] control message posted but not applied yet "
+                 "(is the sim running with --telemetry-control?)\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+        usage();
+        return argc < 2 ? 1 : 0;
+    }
+
+    try {
+        const std::string name = argv[1];
+        bool   from_start = false, info = false, release = false;
+        long   count = -1;
+        double wait_s = 0.0;
+        std::string set;
+        for (int i = 2; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (a == "--from-start")                       from_start = true;
+            else if (a == "--info")                        info = true;
+            else if (a == "--release")                     release = true;
+            else if (a == "--count" && i + 1 < argc)       count = std::atol(argv[++i]);
+            else if (a == "--wait" && i + 1 < argc)        wait_s = std::atof(argv[++i]);
+            else if (a == "--set" && i + 1 < argc)         set = argv[++i];
+            else {
+                usage();
+                return 1;
+            }
+        }
+
+        TelemetryReader r;
+        open_with_wait(r, name, wait_s);
+
+        if (info) {
+            std::cout << "producer_pid " << r.producerPid() << (r.closed() ? " (closed)" : "") << '\n'
+                      << "schema_hash 0x" << std::hex << r.schemaHash() << std::dec << '\n'
+                      << "slots " << r.slots() << '\n'
+                      << "published " << r.head() << " (oldest kept " << r.oldest() << ")\n"
+                      << "control_applied " << r.controlApplied() << " at tick "
+                      << r.controlAppliedTick() << '\n'
+                      << "columns " << r.width() << '\n';
+            for (const std::string& c : r.columns()) std::cout << "  " << c << '\n';
+            return 0;
+        }
+        if (release) return send(r, TelemetryControl{});
+        if (!set.empty()) return send(r, TelemetryControl::parse(set));
+        return follow(r, from_start, count);
+    } catch (const std::exception& e) {
+        std::cerr << "[sftelemetry] " << e.what() << "\n";
+        return 1;
+    }
+}
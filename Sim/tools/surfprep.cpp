@@ -0,0 +1,213 @@
+// Sim/tools/surfprep.cpp
+//
+// Clean up and coarsen a SPARTA surface file before it goes into a deck:
+// weld duplicated corners, drop degenerate and duplicate triangles, make the
+// normals consistent (outward by default), close holes, and optionally
+// decimate to a triangle budget with a bounded geometric error. Regions near
+// the orifice or the wafer can be kept at full resolution with --fine.
+//
+//   surfprep input/surf/cupola.surf -o cupola_prep.surf
+//   surfprep wsf.surf --target 2000 --max-error 0.002 --fine 1.6122 0 0 0.05
+//   surfprep wafer.surf --report surfprep_report.csv   -> wafer_prep.surf
+//
+// The output keeps the input layout (Points section or per-triangle
+// coordinates) unless --format is given. --report appends one CSV row of
+// counts per run, with a header when the file is new.
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SurfMesh.hpp"
+
+namespace fs = std::filesystem;
+
+static void usage(std::ostream& os) {
+    os << "Usage: surfprep <in.surf> [-o out.surf] [options]\n"
+          "  --weld-tol T          merge vertices closer than T (default 1e-6 x extent)\n"
+          "  --normals outward|inward|keep   closed-body normal direction (default outward)\n"
+          "  --keep-holes          do not close boundary loops\n"
+          "  --target N            decimate to at most N triangles\n"
+          "  --max-error E         decimation error bound (default 1e-3 x extent)\n"
+          "  --fine X Y Z R        keep triangles within R of (X,Y,Z) (repeatable)\n"
+          "  --fine-box XLO XHI YLO YHI ZLO ZHI   keep triangles in a box (repeatable)\n"
+          "  --format points|inline  output layout (default: same as input)\n"
+          "  --report FILE         append a CSV row of triangle counts\n";
+}
+
+static double num_arg(int& i, int argc, char** argv) {
+    if (i + 1 >= argc) throw std::runtime_error(std::string("missing value for ") + argv[i]);
+    const std::string s = argv[++i];
+    char* end = nullptr;
+    const double v = std::strtod(s.c_str(), &end);
+    if (!end || *end != '\0') throw std::runtime_error("bad number '" + s + "'");
+    return v;
+}
+
+static std::string str_arg(int& i, int argc, char** argv) {
+    if (i + 1 >= argc) throw std::runtime_error(std::string("missing value for ") + argv[i]);
+    return argv[++i];
+}
+
+static std::string stats_line(const SurfEdgeStats& st) {
+    return std::to_string(st.edges) + " edges, " + std::to_string(st.boundary) + " boundary, " +
+        std::to_string(st.nonmanifold) + " non-manifold, " + std::to_string(st.misoriented) +
+        " misoriented";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+        usage(std::cout);
+        return argc < 2 ? 1 : 0;
+    }
+
+    try {
+        std::string in_path, out_path, report_path, format_arg;
+        double weld_tol = -1.0, max_error = -1.0;
+        long target = -1;
+        bool fill = true;
+        SurfNormals normals = SurfNormals::Outward;
+        std::vector<SurfRegion> fine;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (a == "-o" || a == "--out") out_path = str_arg(i, argc, argv);
+            else if (a == "--weld-tol") weld_tol = num_arg(i, argc, argv);
+            else if (a == "--max-error") max_error = num_arg(i, argc, argv);
+            else if (a == "--target") target = static_cast<long>(num_arg(i, argc, argv));
+            else if (a == "--keep-holes") fill = false;
+            else if (a == "--report") report_path = str_arg(i, argc, argv);
+            else if (a == "--format") format_arg = str_arg(i, argc, argv);
+            else if (a == "--normals") {
+                const std::string n = str_arg(i, argc, argv);
+                if (n == "outward") normals = SurfNormals::Outward;
+                else if (n == "inward") normals = SurfNormals::Inward;
+                else if (n == "keep") normals = SurfNormals::Keep;
+                else throw std::runtime_error("--normals must be outward, inward or keep");
+            } else if (a == "--fine") {
+                SurfRegion r;
+                r.sphere = true;
+                for (int k = 0; k < 3; ++k) r.lo[k] = num_arg(i, argc, argv);
+                r.hi[0] = num_arg(i, argc, argv);
+                fine.push_back(r);
+            } else if (a == "--fine-box") {
+                SurfRegion r;
+                r.sphere = false;
+                for (int k = 0; k < 3; ++k) {
+                    r.lo[k] = num_arg(i, argc, argv);
+                    r.hi[k] = num_arg(i, argc, argv);
+                }
+                fine.push_back(r);
+            } else if (!a.empty() && a[0] == '-') {
+                throw std::runtime_error("unknown option " + a);
+            } else if (in_path.empty()) {
+                in_path = a;
+            } else {
+                throw std::runtime_error("more than one input file (" + in_path + ", " + a + ")");
+            }
+        }
+        if (in_path.empty()) throw std::runtime_error("no input file");
+        if (out_path.empty()) {
+            fs::path p(in_path);
+            out_path = (p.parent_path() / (p.stem().string() + "_prep.surf")).string();
+        }
+
+        SurfMesh mesh = SurfMesh::read(in_path);
+        const std::size_t tris_in = mesh.triangles().size();
+        const std::size_t points_in = mesh.points().size();
+        const SurfEdgeStats stats_in = [&] {
+            // Stats on the welded mesh: per-triangle files would otherwise
+            // report every edge as boundary.
+            SurfMesh welded = mesh;
+            welded.weld(1e-6 * welded.extent());
+            return welded.edgeStats();
+        }();
+        const double extent = mesh.extent();
+        const double area_in = mesh.area();
+        if (weld_tol < 0.0) weld_tol = 1e-6 * extent;
+        if (max_error < 0.0) max_error = 1e-3 * extent;
+
+        SurfFileFormat format = mesh.sourceFormat();
+        if (format_arg == "points") format = SurfFileFormat::Points;
+        else if (format_arg == "inline") format = SurfFileFormat::Inline;
+        else if (!format_arg.empty()) throw std::runtime_error("--format must be points or inline");
+
+        std::cerr << "[surfprep] " << in_path << ": " << tris_in << " triangles, " << points_in
+                  << " points, extent " << extent << "\n";
+        std::cerr << "[surfprep]   input: " << stats_line(stats_in) << "\n";
+
+        const std::size_t welded = mesh.weld(weld_tol);
+        const std::size_t degenerate = mesh.removeDegenerate(1e-12 * extent * extent);
+        const std::size_t duplicate = mesh.removeDuplicates();
+        std::size_t flipped = mesh.orient(normals);
+        std::size_t holes = 0;
+        if (fill) {
+            const SurfMesh open = mesh;
+            holes = mesh.fillHoles();
+            if (holes && std::fabs(mesh.volume()) < 1e-9 * extent * extent * extent) {
+                // A flat sheet (deposition target, shield plate) would only
+                // get a coincident back face.
+                std::cerr << "[surfprep]   left " << holes
+                          << " hole(s) open: the surface is a zero-thickness sheet\n";
+                mesh = open;
+                holes = 0;
+            }
+            // Fill faces follow their loop; a closed body can only be
+            // pointed outward once its holes are gone.
+            if (holes) flipped += mesh.orient(normals);
+        }
+        std::cerr << "[surfprep]   repair: welded " << welded << " points, removed " << degenerate
+                  << " degenerate + " << duplicate << " duplicate triangles, flipped " << flipped
+                  << ", filled " << holes << " holes\n";
+
+        SurfDecimateResult dec;
+        if (target >= 0) {
+            dec = mesh.decimate(static_cast<std::size_t>(target), max_error, fine);
+            std::cerr << "[surfprep]   decimate: " << dec.collapses << " collapses, "
+                      << dec.protected_tris << " protected triangles, max error " << dec.max_error
+                      << " (bound " << max_error << ")"
+                      << (dec.reached_target ? "" : ", budget not reached within the error bound")
+                      << "\n";
+        }
+
+        const SurfEdgeStats stats_out = mesh.edgeStats();
+        const std::size_t comps = mesh.components();
+        std::cerr << "[surfprep]   output: " << mesh.triangles().size() << " triangles, "
+                  << mesh.points().size() << " points, " << comps << " component(s), "
+                  << stats_line(stats_out) << (stats_out.watertight() ? " (watertight)" : "")
+                  << "\n";
+
+        mesh.write(out_path, format, "surfprep " + fs::path(in_path).filename().string());
+        std::cerr << "[surfprep] " << in_path << " -> " << out_path << "\n";
+
+        if (!report_path.empty()) {
+            const bool fresh = !fs::exists(report_path) || fs::file_size(report_path) == 0;
+            std::ofstream rep(report_path, std::ios::out | std::ios::app);
+            if (!rep) throw std::runtime_error("failed to open " + report_path);
+            if (fresh) {
+                rep << "input,output,tris_in,points_in,boundary_in,nonmanifold_in,misoriented_in,"
+                       "welded,degenerate,duplicate,flipped,holes_filled,collapses,protected_tris,"
+                       "max_error,error_bound,target,reached_target,tris_out,points_out,"
+                       "components,watertight,area_in,area_out,volume_out\n";
+            }
+            rep << in_path << ',' << out_path << ',' << tris_in << ',' << points_in << ','
+                << stats_in.boundary << ',' << stats_in.nonmanifold << ',' << stats_in.misoriented
+                << ',' << welded << ',' << degenerate << ',' << duplicate << ',' << flipped << ','
+                << holes << ',' << dec.collapses << ',' << dec.protected_tris << ','
+                << dec.max_error << ',' << max_error << ',' << target << ','
+                << (target < 0 || dec.reached_target ? 1 : 0) << ',' << mesh.triangles().size()
+                << ',' << mesh.points().size() << ',' << comps << ','
+                << (stats_out.watertight() ? 1 : 0) << ',' << area_in << ',' << mesh.area() << ','
+                << mesh.volume() << '\n';
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "[surfprep] " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,217 @@
+#include "Checkpoint.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path& scratch_dir() {
+    static const fs::path dir = [] {
+        fs::path d = fs::temp_directory_path() / "sim_test_checkpoint";
+        fs::create_directories(d);
+        return d;
+    }();
+    return dir;
+}
+
+std::string slurp(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+void spit(const fs::path& p, const std::string& bytes) {
+    std::ofstream out(p, std::ios::binary | std::ios::trunc);
+    out << bytes;
+}
+
+// Rewrites the FNV-1a trailer so a deliberately edited body still checksums,
+// which lets the tests reach the parser's own checks.
+void reseal(std::string& buf) {
+    std::uint64_t h = 1469598103934665603ull;
+    const std::size_t body = buf.size() - sizeof(h);
+    for (std::size_t i = 0; i < body; ++i) {
+        h ^= static_cast<unsigned char>(buf[i]);
+        h *= 1099511628211ull;
+    }
+    std::memcpy(&buf[body], &h, sizeof(h));
+}
+
+template <typename T>
+void poke(std::string& buf, std::size_t at, T v) {
+    std::memcpy(&buf[at], &v, sizeof(v));
+}
+
+bool open_throws(const fs::path& p) {
+    try {
+        CheckpointReader r;
+        r.open(p.string());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// One Int64 entry "a" = {1, 2}: type at 16, key_len at 17, key at 19,
+// count at 20, payload at 28, trailer at 44.
+std::string single_entry_file() {
+    const fs::path p = scratch_dir() / "single.sfckpt";
+    CheckpointWriter w;
+    w.setInts("a", std::vector<std::int64_t>{1, 2});
+    assert(w.writeFile(p.string()) == 52);
+    return slurp(p);
+}
+
+} // namespace
+
+void test_round_trip() {
+    const fs::path p = scratch_dir() / "round_trip.sfckpt";
+    CheckpointWriter w;
+    w.setInt("Battery.cycles", -7);
+    w.setBool("wake.active", true);
+    w.setDouble("Battery.charge_Wh", 0.1 + 0.2);
+    w.setDoubles("Battery.hist", {-0.0, std::numeric_limits<double>::denorm_min(), 1e308});
+    w.setInts("scheduler.state", std::vector<int>{0, 3, 2});
+    w.setText("run.tag", std::string("a\0b", 3));
+    w.setInts("empty", std::vector<std::int64_t>{});
+    w.setInt("Battery.cycles", 9);               // last set wins
+    assert(w.entries() == 7);
+    w.writeFile(p.string());
+
+    bool stray_tmp = false;
+    for (const auto& e : fs::directory_iterator(scratch_dir())) {
+        if (e.path().string().find(".tmp.") != std::string::npos) stray_tmp = true;
+    }
+    assert(!stray_tmp);
+
+    CheckpointReader r;
+    r.open(p.string());
+    assert(r.getInt("Battery.cycles") == 9);
+    assert(r.getBool("wake.active"));
+    assert(r.getDouble("Battery.charge_Wh") == 0.1 + 0.2);
+    const std::vector<double> hist = r.getDoubles("Battery.hist");
+    assert(hist.size() == 3 && std::signbit(hist[0]));
+    assert(hist[1] == std::numeric_limits<double>::denorm_min() && hist[2] == 1e308);
+    assert((r.getInts("scheduler.state") == std::vector<std::int64_t>{0, 3, 2}));
+    assert(r.getText("run.tag") == std::string("a\0b", 3));
+    assert(r.getInts("empty").empty());
+    assert((r.keys("Battery.") ==
+            std::vector<std::string>{"Battery.charge_Wh", "Battery.cycles", "Battery.hist"}));
+    assert(r.keys("nothing").empty());
+    std::cout << "[PASS] Checkpoint round-trips every value type bit for bit.\n";
+}
+
+void test_getter_errors() {
+    const fs::path p = scratch_dir() / "getters.sfckpt";
+    CheckpointWriter w;
+    w.setInt("i", 1);
+    w.setInts("v", std::vector<std::int64_t>{1, 2});
+    w.setText("t", "x");
+    w.writeFile(p.string());
+    CheckpointReader r;
+    r.open(p.string());
+
+    int threw = 0;
+    for (auto get : {+[](const CheckpointReader& c) { c.getInt("missing"); },
+                     +[](const CheckpointReader& c) { c.getDouble("i"); },   // wrong type
+                     +[](const CheckpointReader& c) { c.getText("i"); },
+                     +[](const CheckpointReader& c) { c.getInt("v"); },      // not a scalar
+                     +[](const CheckpointReader& c) { c.getInts("t"); }}) {
+        try {
+            get(r);
+        } catch (const std::runtime_error&) {
+            ++threw;
+        }
+    }
+    assert(threw == 5);
+    std::cout << "[PASS] Checkpoint getters reject missing keys and wrong types.\n";
+}
+
+void test_corruption() {
+    const fs::path p = scratch_dir() / "corrupt.sfckpt";
+    const std::string good = single_entry_file();
+
+    assert(open_throws(scratch_dir() / "does_not_exist.sfckpt"));
+
+    spit(p, "");
+    assert(open_throws(p));
+
+    std::string bad = good;                      // bad magic
+    bad[0] = 'X';
+    reseal(bad);
+    spit(p, bad);
+    assert(open_throws(p));
+
+    bad = good;                                  // unsupported version
+    poke<std::uint32_t>(bad, 8, kCheckpointVersion + 1);
+    reseal(bad);
+    spit(p, bad);
+    assert(open_throws(p));
+
+    bad = good;                                  // one flipped payload bit
+    bad[30] ^= 0x01;
+    spit(p, bad);
+    assert(open_throws(p));
+
+    spit(p, good.substr(0, good.size() - 5));    // cut short
+    assert(open_throws(p));
+
+    bad = good;                                  // more entries than present
+    poke<std::uint32_t>(bad, 12, 2);
+    reseal(bad);
+    spit(p, bad);
+    assert(open_throws(p));
+
+    bad = good;                                  // unknown value type
+    poke<std::uint8_t>(bad, 16, 9);
+    reseal(bad);
+    spit(p, bad);
+    assert(open_throws(p));
+
+    bad = good;                                  // key longer than the file
+    poke<std::uint16_t>(bad, 17, 0xFFFF);
+    reseal(bad);
+    spit(p, bad);
+    assert(open_throws(p));
+
+    // Counts whose byte size would wrap or exhaust memory.
+    for (std::uint64_t count : {std::uint64_t(3), std::uint64_t(1) << 61,
+                                std::numeric_limits<std::uint64_t>::max()}) {
+        bad = good;
+        poke<std::uint64_t>(bad, 20, count);
+        reseal(bad);
+        spit(p, bad);
+        assert(open_throws(p));
+    }
+
+    bad = good;                                  // fewer values than bytes
+    poke<std::uint64_t>(bad, 20, 1);
+    reseal(bad);
+    spit(p, bad);
+    assert(open_throws(p));
+
+    spit(p, good);                               // the unedited copy still loads
+    CheckpointReader r;
+    r.open(p.string());
+    assert((r.getInts("a") == std::vector<std::int64_t>{1, 2}));
+    std::cout << "[PASS] Checkpoint reader rejects corrupt files.\n";
+}
+
+int main() {
+    test_round_trip();
+    test_getter_errors();
+    test_corruption();
+    fs::remove_all(scratch_dir());
+    std::cout << "All Checkpoint tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "CsvTailReader.hpp"
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path scratch_file(const std::string& name) {
+    const fs::path dir = fs::temp_directory_path() / "sim_test_csv_tail";
+    fs::create_directories(dir);
+    fs::path p = dir / name;
+    fs::remove(p);
+    return p;
+}
+
+void append(const fs::path& p, const std::string& text) {
+    std::ofstream out(p, std::ios::app | std::ios::binary);
+    out << text;
+}
+
+// Rewrites the file from the start without truncating first, the way a
+// writer that reopens in place without O_TRUNC would.
+void overwrite_in_place(const fs::path& p, const std::string& text) {
+    std::fstream out(p, std::ios::in | std::ios::out | std::ios::binary);
+    out.seekp(0);
+    out << text;
+}
+
+} // namespace
+
+// Header skipped, only complete lines consumed, blank rows ignored.
+void test_appends_and_partial_lines() {
+    const fs::path p = scratch_file("append.csv");
+    CsvTailReader r(p);
+    assert(!r.poll());   // missing file behaves like an empty one
+
+    append(p, "step,time,temp_K\n");
+    assert(!r.poll());
+    assert(r.lastRow().empty());
+
+    append(p, "1,0.5,300\n  \n2,1.0,3");
+    assert(r.poll());
+    assert(r.lastRow() == "1,0.5,300");   // "2,1.0,3" is still being written
+
+    append(p, "10\n");
+    assert(r.poll());
+    assert(r.lastRow() == "2,1.0,310");
+    assert(r.offset() == fs::file_size(p));
+
+    assert(r.poll());    // nothing new: cached row stays
+    assert(r.lastRow() == "2,1.0,310");
+    std::cout << "[PASS] CsvTailReader follows appended rows.\n";
+}
+
+// A file that shrinks or is replaced starts over from its header.
+void test_truncate_and_replace() {
+    const fs::path p = scratch_file("replace.csv");
+    append(p, "a,b\n1,10\n2,20\n");
+    CsvTailReader r(p);
+    assert(r.poll() && r.lastRow() == "2,20");
+
+    { std::ofstream out(p, std::ios::trunc); out << "a,b\n"; }
+    assert(!r.poll());
+    assert(r.lastRow().empty());
+
+    const fs::path tmp = scratch_file("replace.csv.tmp");
+    append(tmp, "a,b\n7,70\n");
+    fs::rename(tmp, p);
+    assert(r.poll() && r.lastRow() == "7,70");
+    std::cout << "[PASS] CsvTailReader restarts on truncation and replacement.\n";
+}
+
+// Rewritten in place and grown past the old offset between two polls: the
+// stale offset must not be trusted.
+void test_in_place_regrow() {
+    const fs::path p = scratch_file("regrow.csv");
+    append(p, "step,v\n1,10\n2,20\n3,30\n");
+    CsvTailReader r(p);
+    assert(r.poll() && r.lastRow() == "3,30");
+    const std::uint64_t old_offset = r.offset();
+
+    // One byte longer, so the old offset lands on the final line end.
+    overwrite_in_place(p, "step,v\n7,70\n8,80\n9,9000\n");
+    assert(fs::file_size(p) > old_offset);
+    assert(r.poll());
+    assert(r.lastRow() == "9,9000");
+    assert(r.offset() == fs::file_size(p));
+
+    append(p, "11,110\n");
+    assert(r.poll() && r.lastRow() == "11,110");
+    std::cout << "[PASS] CsvTailReader detects an in-place rewrite that regrows.\n";
+}
+
+void test_fields() {
+    double v = 0.0;
+    assert(CsvTailReader::fieldDouble("1,2.5,-3e2", 1, v) && v == 2.5);
+    assert(CsvTailReader::fieldDouble("1,2.5,-3e2", 2, v) && v == -300.0);
+    assert(!CsvTailReader::fieldDouble("1,abc,3", 1, v));
+    assert(!CsvTailReader::hasField("1,2", 2));
+    assert(CsvTailReader::hasField("1,,3", 1));
+    assert(!CsvTailReader::hasField("1,2,", 2));   // trailing comma: no field
+    std::cout << "[PASS] CsvTailReader parses fields in place.\n";
+}
+
+int main() {
+    test_appends_and_partial_lines();
+    test_truncate_and_replace();
+    test_in_place_regrow();
+    test_fields();
+    fs::remove_all(fs::temp_directory_path() / "sim_test_csv_tail");
+    std::cout << "All CsvTailReader tests passed.\n";
+    return 0;
+}
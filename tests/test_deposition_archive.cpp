@@ -0,0 +1,202 @@
+#include "DepositionArchive.hpp"
+#include "DepositionMap.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path& scratch_dir() {
+    static const fs::path dir = [] {
+        fs::path d = fs::temp_directory_path() / "sim_test_deposition_archive";
+        fs::create_directories(d);
+        return d;
+    }();
+    return dir;
+}
+
+std::string slurp(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+void spit(const fs::path& p, const std::string& bytes) {
+    std::ofstream out(p, std::ios::binary | std::ios::trunc);
+    out << bytes;
+}
+
+DepositionMap sample_map(int N, double radius, unsigned seed) {
+    DepositionMap m(N, radius);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0e6);
+    for (double& b : m.bins) b = u(rng);
+    return m;
+}
+
+bool open_throws(const fs::path& p) {
+    try {
+        DepositionArchiveReader r;
+        r.open(p.string());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Job 1 / wafer 0 at t = 10, 20, 30 in the three encodings (Deflate only
+// with zlib), plus job 2 / wafer 1 at t = 15.
+fs::path write_sample(const std::string& name) {
+    const fs::path p = scratch_dir() / name;
+    DepositionArchiveWriter w;
+    w.open(p.string());
+    w.add(1, 0, 10.0, sample_map(8, 0.05, 1), DepositionEncoding::Float64);
+    w.add(1, 0, 20.0, sample_map(8, 0.05, 2), DepositionEncoding::Float32);
+    if (depositionArchiveHasDeflate()) {
+        w.add(1, 0, 30.0, sample_map(8, 0.05, 3), DepositionEncoding::Deflate);
+    } else {
+        bool threw = false;
+        try {
+            w.add(1, 0, 30.0, sample_map(8, 0.05, 3), DepositionEncoding::Deflate);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+        w.add(1, 0, 30.0, sample_map(8, 0.05, 3), DepositionEncoding::Float64);
+    }
+    w.add(2, 1, 15.0, sample_map(5, 0.1, 4));
+    w.close();
+    return p;
+}
+
+} // namespace
+
+void test_round_trip() {
+    const fs::path p = write_sample("round_trip.sda");
+    DepositionArchiveReader r;
+    r.open(p.string());
+    assert(r.size() == 4);
+    for (std::size_t i = 0; i < r.size(); ++i) {
+        assert(r.entry(i).offset % 8 == 0);
+        assert(r.verify(i));
+    }
+
+    DepositionMap m(1, 1.0);
+    r.load(0, m);
+    const DepositionMap f64 = sample_map(8, 0.05, 1);
+    assert(m.N == 8 && m.radius == 0.05 && m.bins == f64.bins);   // bit for bit
+
+    r.load(1, m);
+    const DepositionMap f32 = sample_map(8, 0.05, 2);
+    assert(r.entry(1).stored_bytes == 64 * sizeof(float));
+    for (std::size_t k = 0; k < m.bins.size(); ++k) {
+        assert(m.bins[k] == static_cast<double>(static_cast<float>(f32.bins[k])));
+        assert(std::fabs(m.bins[k] - f32.bins[k]) <= 1e-6 * f32.bins[k] + 1e-30);
+    }
+
+    r.load(2, m);
+    assert(m.bins == sample_map(8, 0.05, 3).bins);                 // lossless
+    if (depositionArchiveHasDeflate()) {
+        assert(r.entry(2).encoding == static_cast<std::uint8_t>(DepositionEncoding::Deflate));
+    }
+
+    r.load(3, m);
+    assert(m.N == 5 && m.radius == 0.1 && m.bins == sample_map(5, 0.1, 4).bins);
+    std::cout << "[PASS] DepositionArchive round-trips every encoding.\n";
+}
+
+void test_find_and_view() {
+    const fs::path p = write_sample("find.sda");
+    DepositionArchiveReader r;
+    r.open(p.string());
+
+    assert(r.find(1, 0) == 2);                  // latest
+    assert(r.find(1, 0, 25.0) == 1);
+    assert(r.find(1, 0, 20.0) == 1);            // bound is inclusive
+    assert(r.find(1, 0, 9.0) == -1);
+    assert(r.find(2, 1) == 3 && r.find(2, 0) == -1 && r.find(3, 1) == -1);
+
+    const double* v = r.view(0);
+    assert(v != nullptr);
+    const DepositionMap ref = sample_map(8, 0.05, 1);
+    assert(std::memcmp(v, ref.bins.data(), ref.bins.size() * sizeof(double)) == 0);
+    assert(r.view(1) == nullptr);               // Float32
+    assert((r.view(2) == nullptr) == depositionArchiveHasDeflate());
+    assert(r.view(3) != nullptr);
+    assert(r.view(99) == nullptr);
+    std::cout << "[PASS] DepositionArchive finds by time and views Float64 in place.\n";
+}
+
+void test_corruption() {
+    const fs::path src = write_sample("corrupt_src.sda");
+    const std::string good = slurp(src);
+    std::size_t toc_offset = 0;
+    std::memcpy(&toc_offset, good.data() + 16, sizeof(std::uint64_t));
+
+    // A flipped payload byte fails verify() and load() for that entry only.
+    const fs::path p = scratch_dir() / "corrupt.sda";
+    {
+        DepositionArchiveReader r;
+        r.open(src.string());
+        std::string bad = good;
+        bad[r.entry(1).offset + 5] ^= 0x10;
+        spit(p, bad);
+    }
+    {
+        DepositionArchiveReader r;
+        r.open(p.string());
+        assert(!r.verify(1) && r.verify(0) && r.verify(2) && r.verify(3));
+        DepositionMap m(1, 1.0);
+        bool threw = false;
+        try {
+            r.load(1, m);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+        r.load(0, m);
+        assert(m.bins == sample_map(8, 0.05, 1).bins);
+    }
+
+    // Header as open() leaves it until close(): no TOC.
+    std::string no_toc = good.substr(0, toc_offset);
+    std::memset(&no_toc[12], 0, 4 + 8);         // count, toc_offset
+    spit(p, no_toc);
+    assert(open_throws(p));
+
+    spit(p, good.substr(0, good.size() - 8));   // TOC cut short
+    assert(open_throws(p));
+
+    std::string bad = good;                      // bad magic
+    bad[0] = 'X';
+    spit(p, bad);
+    assert(open_throws(p));
+
+    spit(p, good.substr(0, 16));                 // shorter than the header
+    assert(open_throws(p));
+    assert(open_throws(scratch_dir() / "does_not_exist.sda"));
+
+    spit(p, good);                               // the intact copy still opens
+    DepositionArchiveReader r;
+    r.open(p.string());
+    assert(r.size() == 4);
+    std::cout << "[PASS] DepositionArchive rejects corrupt payloads and missing TOCs.\n";
+}
+
+int main() {
+    test_round_trip();
+    test_find_and_view();
+    test_corruption();
+    fs::remove_all(scratch_dir());
+    std::cout << "All DepositionArchive tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "JobFarm.hpp"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool load_throws(const std::string& spec, const std::string& dir) {
+    try {
+        JobFarm::loadJobs(spec, dir);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::string> paths(const std::vector<FarmJob>& jobs) {
+    std::vector<std::string> out;
+    for (const FarmJob& j : jobs) out.push_back(j.path);
+    return out;
+}
+
+} // namespace
+
+// Bare names and globs resolve in the jobs directory; "dir/glob" in dir.
+void test_load_jobs() {
+    const fs::path root = fs::temp_directory_path() / "sim_test_job_farm";
+    fs::remove_all(root);
+    fs::create_directories(root / "jobs");
+    fs::create_directories(root / "other");
+    for (const char* f : {"jobs/V4_job1.txt", "jobs/V4_job2.txt", "jobs/notes.md", "other/V4_job9.txt"}) {
+        std::ofstream(root / f) << "# job\n";
+    }
+    const std::string jobs  = (root / "jobs").string();
+    const std::string other = (root / "other").string();
+
+    std::vector<FarmJob> j = JobFarm::loadJobs("V4_job*", jobs);
+    assert((paths(j) == std::vector<std::string>{jobs + "/V4_job1.txt", jobs + "/V4_job2.txt"}));
+    assert(j[0].run_id == "V4_job1" && j[0].file == "V4_job1.txt");
+
+    j = JobFarm::loadJobs(other + "/V4_*.txt, V4_job2.txt", jobs);
+    assert((paths(j) == std::vector<std::string>{other + "/V4_job9.txt", jobs + "/V4_job2.txt"}));
+    assert(j[0].run_id == "V4_job9");
+
+    j = JobFarm::loadJobs("V4_job1.txt " + jobs + "/V4_job1.txt", jobs);
+    assert(j.size() == 2 && j[0].path == j[1].path);
+    assert(j[0].run_id == "V4_job1" && j[1].run_id == "V4_job1_1");   // repeats get the list position
+
+    assert(load_throws("missing.txt", jobs));
+    assert(load_throws(other + "/V4_job1.txt", jobs));   // a path is checked too
+    assert(load_throws(jobs + "/nope*.txt", other));
+    assert(load_throws("*.md", jobs));                   // globs only see .txt
+    assert(load_throws(" , ", jobs));
+
+    fs::remove_all(root);
+    std::cout << "[PASS] JobFarm::loadJobs expands globs per directory and checks files.\n";
+}
+
+int main() {
+    test_load_jobs();
+    std::cout << "All JobFarm tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,262 @@
+#include "LogIndex.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path& scratch_dir() {
+    static const fs::path dir = [] {
+        fs::path d = fs::temp_directory_path() / "sim_test_log_index";
+        fs::create_directories(d);
+        return d;
+    }();
+    return dir;
+}
+
+// Each write moves the mtime on explicitly, so tests do not depend on the
+// filesystem's timestamp resolution.
+void stamp(const fs::path& p) {
+    static auto t = fs::file_time_type::clock::now();
+    t += std::chrono::seconds(1);
+    fs::last_write_time(p, t);
+}
+
+void write_file(const fs::path& p, const std::string& text) {
+    { std::ofstream out(p, std::ios::binary | std::ios::trunc); out << text; }
+    stamp(p);
+}
+
+void append(const fs::path& p, const std::string& text) {
+    { std::ofstream out(p, std::ios::binary | std::ios::app); out << text; }
+    stamp(p);
+}
+
+void overwrite_in_place(const fs::path& p, const std::string& text) {
+    { std::fstream out(p, std::ios::in | std::ios::out | std::ios::binary); out << text; }
+    stamp(p);
+}
+
+std::string rows(long first, long last) {
+    std::string s;
+    for (long t = first; t <= last; ++t) {
+        s += std::to_string(t) + "," + std::to_string(0.5 * t) + "," +
+             (t % 3 == 0 ? "growth" : "soak") + "\n";
+    }
+    return s;
+}
+
+const std::string kHeader = "tick,temp_K,phase\n";
+
+// Blocks carry the same offsets, sizes and bounds.
+bool same_blocks(const LogIndex& a, const LogIndex& b) {
+    if (a.blocks().size() != b.blocks().size() || a.columns() != b.columns()) return false;
+    for (std::size_t i = 0; i < a.blocks().size(); ++i) {
+        const LogIndex::Block& x = a.blocks()[i];
+        const LogIndex::Block& y = b.blocks()[i];
+        if (x.offset != y.offset || x.bytes != y.bytes || x.rows != y.rows) return false;
+        for (std::size_t c = 0; c < x.min.size(); ++c) {
+            const bool nan_x = std::isnan(x.min[c]), nan_y = std::isnan(y.min[c]);
+            if (nan_x != nan_y) return false;
+            if (!nan_x && (x.min[c] != y.min[c] || x.max[c] != y.max[c])) return false;
+        }
+    }
+    return true;
+}
+
+// Ticks of the matching rows, and how many blocks had to be read.
+std::vector<long> query(const LogIndex& idx, const LogQuery& q, std::size_t& read) {
+    std::vector<long> out;
+    std::vector<int> cols;
+    read = 0;
+    if (!idx.resolve(q, cols)) return out;
+    std::FILE* fp = std::fopen(idx.path().c_str(), "rb");
+    assert(fp);
+    std::string data, line;
+    std::vector<std::string> fields;
+    for (std::size_t b = 0; b < idx.blocks().size(); ++b) {
+        if (!idx.mayMatch(b, q, cols)) continue;
+        ++read;
+        idx.readBlock(fp, b, data);
+        std::size_t pos = 0;
+        while (LogIndex::nextRecord(data, pos, line)) {
+            LogIndex::splitRecord(line, fields);
+            if (LogIndex::rowMatches(fields, q, cols)) out.push_back(std::stol(fields[0]));
+        }
+    }
+    std::fclose(fp);
+    return out;
+}
+
+} // namespace
+
+// An unchanged file reuses its sidecar; appended rows extend it.
+void test_reuse_and_extend() {
+    const fs::path p = scratch_dir() / "reuse.csv";
+    write_file(p, kHeader + rows(0, 4));
+
+    LogIndex::LoadInfo info;
+    LogIndex a = LogIndex::load(p.string(), 2, false, &info);
+    assert(info.built && !info.extended && info.written);
+    assert(fs::exists(LogIndex::indexPath(p.string())));
+    assert(a.rows() == 5 && a.blocks().size() == 3);
+    assert(a.indexedBytes() == fs::file_size(p));
+    assert(a.column("temp_K") == 1 && a.column("missing") == -1);
+    assert(std::isnan(a.blocks()[0].min[2]));       // text column has no bounds
+    assert(a.blocks()[1].min[0] == 2.0 && a.blocks()[1].max[0] == 3.0);
+
+    LogIndex b = LogIndex::load(p.string(), 2, false, &info);
+    assert(!info.built && !info.extended && !info.written);
+    assert(same_blocks(a, b));
+
+    // A partial last line is left for the next load.
+    append(p, rows(5, 7) + "8,4.0,so");
+    LogIndex c = LogIndex::load(p.string(), 2, false, &info);
+    assert(!info.built && info.extended && info.written);
+    assert(c.rows() == 8 && c.indexedBytes() == fs::file_size(p) - 8);
+
+    append(p, "ak\n");
+    LogIndex d = LogIndex::load(p.string(), 2, false, &info);
+    assert(info.extended && d.rows() == 9);
+    assert(same_blocks(d, LogIndex::load(p.string(), 2, true, &info)));
+    assert(info.built);                             // rebuild ignores the sidecar
+    std::cout << "[PASS] LogIndex reuses and extends its sidecar.\n";
+}
+
+// Anything but an append makes the sidecar stale.
+void test_stale_sidecar() {
+    const fs::path p = scratch_dir() / "stale.csv";
+    write_file(p, kHeader + rows(0, 5));
+    LogIndex::LoadInfo info;
+    LogIndex::load(p.string(), 2, false, &info);
+    assert(info.built);
+
+    // Same size, new mtime: rewritten in place.
+    overwrite_in_place(p, kHeader + "9");
+    LogIndex a = LogIndex::load(p.string(), 2, false, &info);
+    assert(info.built && info.written);
+    assert(a.blocks()[0].min[0] == 1.0 && a.blocks()[0].max[0] == 9.0);
+
+    // Longer, but the bytes at the old end changed: not an append.
+    const std::uint64_t old_size = fs::file_size(p);
+    overwrite_in_place(p, kHeader + rows(10, 15) + rows(16, 17));
+    assert(fs::file_size(p) > old_size);
+    LogIndex b = LogIndex::load(p.string(), 2, false, &info);
+    assert(info.built && !info.extended);
+    assert(b.rows() == 8 && b.blocks()[0].min[0] == 10.0);
+
+    // Shorter: truncated and rewritten.
+    write_file(p, kHeader + rows(0, 1));
+    LogIndex c = LogIndex::load(p.string(), 2, false, &info);
+    assert(info.built && c.rows() == 2);
+
+    // Another block size.
+    LogIndex d = LogIndex::load(p.string(), 1, false, &info);
+    assert(info.built && d.blocks().size() == 2);
+    std::cout << "[PASS] LogIndex rebuilds stale sidecars.\n";
+}
+
+// Corrupt or foreign sidecars are rebuilt, never trusted or thrown on.
+void test_corrupt_sidecar() {
+    const fs::path p = scratch_dir() / "corrupt.csv";
+    write_file(p, kHeader + rows(0, 9));
+    const std::string side = LogIndex::indexPath(p.string());
+    LogIndex::LoadInfo info;
+    const LogIndex good = LogIndex::load(p.string(), 4, false, &info);
+
+    std::string bytes;
+    {
+        std::ifstream in(side, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto corrupt = [&](const std::string& with) {
+        { std::ofstream out(side, std::ios::binary | std::ios::trunc); out << with; }
+        LogIndex::LoadInfo li;
+        const LogIndex idx = LogIndex::load(p.string(), 4, false, &li);
+        assert(li.built && same_blocks(idx, good));
+    };
+
+    corrupt("");
+    corrupt("not an index at all");
+    corrupt(bytes.substr(0, bytes.size() - 3));     // truncated blocks
+    std::string bad = bytes;
+    bad[8] ^= 0x7f;                                 // version
+    corrupt(bad);
+    bad = bytes;
+    const std::uint32_t huge = 0xFFFFFFFFu;         // ncols
+    std::memcpy(&bad[12], &huge, sizeof(huge));
+    corrupt(bad);
+    bad = bytes;
+    const std::uint32_t one_more = 4;               // ncols, header says 3
+    std::memcpy(&bad[12], &one_more, sizeof(one_more));
+    corrupt(bad);
+
+    bool threw = false;
+    try {
+        LogIndex::load((scratch_dir() / "absent.csv").string());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "[PASS] LogIndex rebuilds corrupt sidecars.\n";
+}
+
+// Block bounds skip what a numeric term rules out; rows match exactly.
+void test_query() {
+    const fs::path p = scratch_dir() / "query.csv";
+    write_file(p, kHeader + rows(0, 99));
+    const LogIndex idx = LogIndex::load(p.string(), 10);
+
+    std::size_t read = 0;
+    LogQuery q;
+    q.addTickRange(25, 34);
+    assert((query(idx, q, read) ==
+            std::vector<long>{25, 26, 27, 28, 29, 30, 31, 32, 33, 34}));
+    assert(read == 2);
+
+    LogQuery text;
+    text.addTerms("phase=growth,temp_K>=45");
+    const std::vector<long> hits = query(idx, text, read);
+    assert((hits == std::vector<long>{90, 93, 96, 99}));
+    assert(read == 1);                              // the numeric term prunes the rest
+
+    LogQuery text_only;
+    text_only.addTerms("phase=soak");
+    assert(query(idx, text_only, read).size() == 66);
+    assert(read == 10);                             // text has no bounds to skip by
+
+    LogQuery absent;
+    absent.addTerms("no_such_column=1");
+    assert(query(idx, absent, read).empty() && read == 0);
+
+    bool threw = false;
+    try {
+        LogQuery bad;
+        bad.addTerms("tick");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "[PASS] LogIndex queries skip blocks by their bounds.\n";
+}
+
+int main() {
+    test_reuse_and_extend();
+    test_stale_sidecar();
+    test_corrupt_sidecar();
+    test_query();
+    fs::remove_all(scratch_dir());
+    std::cout << "All LogIndex tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "DatasetExport.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path& scratch_dir() {
+    static const fs::path dir = [] {
+        fs::path d = fs::temp_directory_path() / "sim_test_npy";
+        fs::create_directories(d);
+        return d;
+    }();
+    return dir;
+}
+
+std::string slurp(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// Checks the format 1.0 preamble and returns the header dict, trailing
+// padding and newline stripped.
+std::string header_dict(const std::string& file) {
+    assert(file.size() >= 10);
+    assert(static_cast<unsigned char>(file[0]) == 0x93 && file.compare(1, 5, "NUMPY") == 0);
+    assert(file[6] == 1 && file[7] == 0);
+    const std::size_t len = static_cast<unsigned char>(file[8]) |
+                            (static_cast<std::size_t>(static_cast<unsigned char>(file[9])) << 8);
+    assert((10 + len) % 64 == 0);                // data starts 64-byte aligned
+    assert(file.size() >= 10 + len && file[10 + len - 1] == '\n');
+    std::string dict = file.substr(10, len - 1);
+    dict.erase(dict.find_last_not_of(' ') + 1);
+    return dict;
+}
+
+std::string expected_dict(const std::string& dtype, const std::string& shape) {
+    return "{'descr': '" + dtype + "', 'fortran_order': False, 'shape': " + shape + ", }";
+}
+
+std::string native(const char* descr) {
+    const std::uint16_t probe = 1;
+    unsigned char first = 0;
+    std::memcpy(&first, &probe, 1);
+    return std::string(first == 1 ? "<" : ">") + descr;
+}
+
+} // namespace
+
+// The header tracks the leading dimension through sync() and close().
+void test_row_file_header() {
+    const fs::path p = scratch_dir() / "features.npy";
+    NpyFile f;
+    f.open(p.string(), "f8", sizeof(double), {3});
+    assert(f.is_open() && f.rows() == 0);
+    assert(f.dtype() == native("f8"));
+    assert((f.shape() == std::vector<std::size_t>{0, 3}));
+
+    const double rows[6] = {1, 2, 3, 4, 5, 6};
+    f.append(rows, 6);
+    assert(f.rows() == 2);
+    f.sync();
+    std::string file = slurp(p);
+    assert(header_dict(file) == expected_dict(native("f8"), "(2, 3)"));
+    assert(file.size() == 128 + sizeof(rows));
+    assert(std::memcmp(file.data() + 128, rows, sizeof(rows)) == 0);
+
+    bool threw = false;
+    try {
+        f.append(rows, 4);                       // not a whole row
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && f.rows() == 2);
+
+    f.append(rows, 3);
+    f.close();
+    assert(!f.is_open());
+    file = slurp(p);
+    assert(header_dict(file) == expected_dict(native("f8"), "(3, 3)"));
+    assert(file.size() == 128 + 9 * sizeof(double));
+    std::cout << "[PASS] NpyFile patches the row count into its header.\n";
+}
+
+// One-dimensional arrays keep the tuple comma; single bytes have no order.
+void test_dtypes_and_shapes() {
+    const fs::path p = scratch_dir() / "tick.npy";
+    {
+        NpyFile f;
+        f.open(p.string(), "i8", sizeof(std::int64_t), {});
+        const std::int64_t t[5] = {0, 1, 2, 3, 4};
+        f.append(t, 5);
+    }                                            // destructor closes
+    assert(header_dict(slurp(p)) == expected_dict(native("i8"), "(5,)"));
+
+    NpyFile mask;
+    mask.open(p.string(), "u1", 1, {4, 4});      // reopening truncates
+    assert(mask.dtype() == "|u1");
+    mask.sync();
+    assert(header_dict(slurp(p)) == expected_dict("|u1", "(0, 4, 4)"));
+    std::vector<unsigned char> cells(32, 1);
+    mask.append(cells.data(), cells.size());
+    mask.close();
+    const std::string file = slurp(p);
+    assert(header_dict(file) == expected_dict("|u1", "(2, 4, 4)"));
+    assert(file.size() == 128 + 32);
+    std::cout << "[PASS] NpyFile writes numpy dtypes and shapes.\n";
+}
+
+void test_open_errors() {
+    bool threw = false;
+    try {
+        NpyFile f;
+        f.open((scratch_dir() / "missing_dir" / "x.npy").string(), "f8", 8, {});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // A shape that cannot fit the fixed header is refused, and the file
+    // is left closed rather than failing again on destruction.
+    threw = false;
+    const fs::path p = scratch_dir() / "wide.npy";
+    {
+        NpyFile f;
+        try {
+            f.open(p.string(), "f8", 8, std::vector<std::size_t>(8, 1000000000000ull));
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(!f.is_open());
+    }
+    assert(threw);
+    std::cout << "[PASS] NpyFile reports unwritable files and oversized shapes.\n";
+}
+
+int main() {
+    test_row_file_header();
+    test_dtypes_and_shapes();
+    test_open_errors();
+    fs::remove_all(scratch_dir());
+    std::cout << "All NpyFile tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include "Scheduler.hpp"
+#include "Checkpoint.hpp"
+#include <cassert>
+#include <climits>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+using SimHelpers::Job;
+using SimHelpers::PhaseCode;
+
+namespace {
+
+Job make_job(int start, int end, PhaseCode phase = PhaseCode::SOAK,
+             double flux = 0.0, int mbe_on = 0) {
+    Job j;
+    j.start_tick  = start;
+    j.end_tick    = end;
+    j.phase_code  = phase;
+    j.Fwafer_cm2s = flux;
+    j.mbe_on      = mbe_on;
+    return j;
+}
+
+// Rows deliberately out of start order, with a tie at tick 10.
+std::vector<Job> sample_schedule() {
+    return {
+        make_job(50, 60),
+        make_job(10, 20, PhaseCode::GROWTH, 2.0e14, 1),
+        make_job(10, 25),
+        make_job(30, 40, PhaseCode::NUCLEATE, 5.0e13, 1),
+        make_job(0, 5),
+    };
+}
+
+} // namespace
+
+// Jobs are released once their start tick is due, reported in row order,
+// and promoted lowest row index first.
+void test_release_and_promote_order() {
+    Scheduler s(sample_schedule());
+    assert(s.size() == 5 && s.unfinishedCount() == 5);
+    assert(s.nextReleaseTick() == 0);
+    assert(s.promote() == -1);
+
+    assert((s.releaseDue(0) == std::vector<int>{4}));
+    assert(s.job(4).state == JobRunState::Queued);
+    assert(s.job(4).actual_queue_enter_tick == 0);
+    assert(s.releaseDue(9).empty());
+    assert(s.nextReleaseTick() == 10);
+
+    // A late call releases every due row at once, stamped with that tick.
+    assert((s.releaseDue(40) == std::vector<int>{1, 2, 3}));
+    for (int i : {1, 2, 3}) {
+        assert(s.job(i).state == JobRunState::Queued);
+        assert(s.job(i).released_to_queue);
+        assert(s.job(i).actual_queue_enter_tick == 40);
+    }
+    assert(s.job(0).state == JobRunState::Pending);
+    assert(s.nextReleaseTick() == 50);
+
+    assert(s.promote() == 1);
+    assert(s.promote() == 2);
+    s.abort(3);                     // aborted while queued: skipped
+    assert(s.promote() == 4);
+    assert(s.promote() == -1);
+    assert(!s.hasQueued());
+
+    assert((s.releaseDue(50) == std::vector<int>{0}));
+    assert(s.nextReleaseTick() == INT_MAX);
+    std::cout << "[PASS] Scheduler releases by start tick and promotes by row.\n";
+}
+
+void test_terminal_transitions() {
+    Scheduler s(sample_schedule());
+    s.complete(1);
+    s.complete(1);                  // already terminal: no effect
+    s.abort(1);
+    assert(s.job(1).done && !s.job(1).aborted);
+    assert(s.job(1).state == JobRunState::Done);
+    s.abort(2);
+    assert(s.job(2).aborted && s.job(2).state == JobRunState::Aborted);
+    assert(s.unfinishedCount() == 3 && s.anyUnfinished());
+    for (int i : {0, 3, 4}) s.complete(i);
+    assert(!s.anyUnfinished());
+    std::cout << "[PASS] Scheduler terminal transitions are idempotent.\n";
+}
+
+void test_next_growth_flux() {
+    Scheduler s(sample_schedule());
+    assert(s.nextGrowthFluxCm2s(0) == 2.0e14);   // row 1 is the next growth row
+    assert(s.nextGrowthFluxCm2s(1) == 5.0e13);
+    assert(s.nextGrowthFluxCm2s(3) == 0.0);
+    assert(s.nextGrowthFluxCm2s(4) == 0.0);
+    assert(s.nextGrowthFluxCm2s(-1) == 0.0 && s.nextGrowthFluxCm2s(99) == 0.0);
+    std::cout << "[PASS] Scheduler precomputes the next growth flux.\n";
+}
+
+// A scheduler restored mid-run continues exactly like the original.
+void test_checkpoint_round_trip() {
+    const fs::path path = fs::temp_directory_path() / "sim_test_scheduler.sfckpt";
+
+    Scheduler a(sample_schedule());
+    a.releaseDue(3);
+    assert(a.promote() == 4);
+    a.job(4).phase_ticks_completed = 3;
+    a.job(4).actual_phase_start_tick = 2;
+    a.complete(4);
+    a.releaseDue(10);               // rows 1 and 2 queued at the checkpoint
+
+    CheckpointWriter w;
+    a.saveState(w);
+    w.writeFile(path.string());
+
+    CheckpointReader r;
+    r.open(path.string());
+    Scheduler b(sample_schedule());
+    b.loadState(r);
+
+    assert(b.unfinishedCount() == a.unfinishedCount());
+    assert(b.nextReleaseTick() == a.nextReleaseTick());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        assert(b.job(i).state == a.job(i).state);
+        assert(b.job(i).actual_queue_enter_tick == a.job(i).actual_queue_enter_tick);
+        assert(b.job(i).phase_ticks_completed == a.job(i).phase_ticks_completed);
+        assert(b.job(i).actual_phase_start_tick == a.job(i).actual_phase_start_tick);
+        assert(b.job(i).remaining_phase_ticks == a.job(i).remaining_phase_ticks);
+    }
+    for (int tick : {20, 35, 55}) {
+        assert(a.releaseDue(tick) == b.releaseDue(tick));
+        for (;;) {
+            const int pa = a.promote();
+            assert(pa == b.promote());
+            if (pa < 0) break;
+        }
+    }
+
+    // The restored table must be the same schedule.
+    std::vector<Job> shorter = sample_schedule();
+    shorter.pop_back();
+    Scheduler c(shorter);
+    bool threw = false;
+    try {
+        c.loadState(r);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    fs::remove(path);
+    std::cout << "[PASS] Scheduler state survives a checkpoint round trip.\n";
+}
+
+int main() {
+    test_release_and_promote_order();
+    test_terminal_transitions();
+    test_next_growth_flux();
+    test_checkpoint_round_trip();
+    std::cout << "All Scheduler tests passed.\n";
+    return 0;
+}
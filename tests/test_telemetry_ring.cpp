@@ -0,0 +1,185 @@
+#include "TelemetryRing.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+const std::vector<std::string> kColumns = {"T_cell_K", "T_sub_K", "flux"};
+
+std::string segment_name(const char* what) {
+    return "/sim_test_telemetry_" + std::to_string(::getpid()) + "_" + what;
+}
+
+bool reader_open_throws(const std::string& name, std::uint64_t hash = 0) {
+    try {
+        TelemetryReader r;
+        r.open(name, hash);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void test_open_and_schema() {
+    const std::string name = segment_name("schema");
+    assert(reader_open_throws(name));            // nothing published yet
+
+    TelemetryPublisher pub;
+    pub.open(name, kColumns, 5);
+    assert(pub.isOpen() && pub.width() == 3);
+
+    TelemetryReader r;
+    r.open(name, telemetrySchemaHash(kColumns));
+    assert(r.slots() == 8);                      // rounded up to a power of two
+    assert(r.columns() == kColumns && r.width() == 3);
+    assert(r.producerPid() == ::getpid() && !r.closed());
+    assert(r.head() == 0 && r.oldest() == 0);
+
+    std::vector<std::string> other = kColumns;
+    other.push_back("extra");
+    assert(telemetrySchemaHash(other) != telemetrySchemaHash(kColumns));
+    assert(reader_open_throws(name, telemetrySchemaHash(other)));
+
+    bool threw = false;
+    try {
+        pub.publish(0, 0.0, {1.0, 2.0});         // wrong width
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && pub.published() == 0);
+
+    pub.close();
+    assert(r.closed());                          // the mapping outlives the unlink
+    assert(reader_open_throws(name));
+    std::cout << "[PASS] TelemetryRing checks schema, width and lifetime.\n";
+}
+
+// visit() succeeds only for the record a slot currently holds, complete.
+void test_visit_and_overwrite() {
+    const std::string name = segment_name("visit");
+    TelemetryPublisher pub;
+    pub.open(name, kColumns, 4);
+    TelemetryReader r;
+    r.open(name);
+
+    auto read = [&r](std::uint64_t k, long& tick, double& v0) {
+        return r.visit(k, [&](long t, double, const double* v) { tick = t; v0 = v[0]; });
+    };
+    long tick = -1;
+    double v0 = 0.0;
+    assert(!read(0, tick, v0));                  // not published yet
+
+    for (long k = 0; k < 6; ++k) pub.publish(k, 0.5 * k, {100.0 + k, 0.0, 0.0});
+    assert(r.head() == 6 && r.oldest() == 2);
+    assert(!read(1, tick, v0));                  // overwritten by record 5
+    assert(read(2, tick, v0) && tick == 2 && v0 == 102.0);
+    assert(read(5, tick, v0) && tick == 5 && v0 == 105.0);
+    assert(!read(6, tick, v0));
+
+    // The producer laps the slot while the reader is inside f: the seqlock
+    // must report the read as torn.
+    const bool intact = r.visit(3, [&](long, double, const double*) {
+        for (long k = 6; k < 8; ++k) pub.publish(k, 0.0, {0.0, 0.0, 0.0});
+    });
+    assert(!intact);
+    std::cout << "[PASS] TelemetryRing visit() rejects unpublished and overwritten slots.\n";
+}
+
+// A producer thread racing a reader: every record visit() accepts is whole.
+void test_concurrent_reader() {
+    const std::string name = segment_name("race");
+    TelemetryPublisher pub;
+    pub.open(name, kColumns, 4);
+    TelemetryReader r;
+    r.open(name);
+
+    constexpr long kRecords = 200000;
+    std::thread producer([&pub] {
+        for (long k = 0; k < kRecords; ++k) {
+            const double v = static_cast<double>(k);
+            pub.publish(k, v, {v, v, v});
+        }
+    });
+
+    bool consistent = true;
+    while (r.head() < static_cast<std::uint64_t>(kRecords)) {
+        const std::uint64_t k = r.head() > 0 ? r.head() - 1 : 0;
+        long tick = 0;
+        double time = 0.0, a = 0.0, b = 0.0, c = 0.0;
+        const bool ok = r.visit(k, [&](long t, double tm, const double* v) {
+            tick = t;
+            time = tm;
+            a = v[0];
+            b = v[1];
+            c = v[2];
+        });
+        if (!ok) continue;
+        const double want = static_cast<double>(k);
+        if (tick != static_cast<long>(k) || time != want || a != want || b != want || c != want) {
+            consistent = false;
+        }
+    }
+    producer.join();
+    assert(consistent);
+    long last = -1;
+    assert(r.visit(kRecords - 1, [&](long t, double, const double*) { last = t; }));
+    assert(last == kRecords - 1);
+    std::cout << "[PASS] TelemetryRing readers never accept a torn record.\n";
+}
+
+void test_control_channel() {
+    TelemetryControl c = TelemetryControl::parse("effusion_target_K=1100,beam_allowed=1,");
+    assert(c.has(TelemetryControl::EffusionTargetK) && c.has(TelemetryControl::BeamAllowed));
+    assert(!c.has(TelemetryControl::SubstrateTargetK));
+    assert(c.effusion_target_K == 1100.0 && c.beam_allowed);
+    assert(TelemetryControl::parse("").mask == 0);
+    int threw = 0;
+    for (const char* bad : {"bogus=1", "effusion_target_K", "substrate_target_K=abc",
+                            "source_control=inf"}) {
+        try {
+            TelemetryControl::parse(bad);
+        } catch (const std::runtime_error&) {
+            ++threw;
+        }
+    }
+    assert(threw == 4);
+
+    const std::string name = segment_name("control");
+    TelemetryPublisher pub;
+    pub.open(name, kColumns, 4);
+    TelemetryReader r;
+    r.open(name);
+
+    TelemetryControl got;
+    assert(!pub.pollControl(got, 0) && pub.controlGeneration() == 0);
+    r.sendControl(c);
+    assert(pub.pollControl(got, 42));
+    assert(got.mask == c.mask && got.effusion_target_K == 1100.0 && got.beam_allowed);
+    assert(pub.controlGeneration() == 1);
+    assert(r.controlApplied() == 1 && r.controlAppliedTick() == 42);
+    assert(!pub.pollControl(got, 43));           // already taken
+
+    r.sendControl(TelemetryControl{});           // hand control back
+    assert(pub.pollControl(got, 44) && got.mask == 0);
+    assert(r.controlApplied() == 2 && r.controlAppliedTick() == 44);
+    std::cout << "[PASS] TelemetryRing control messages are taken once.\n";
+}
+
+int main() {
+    test_open_and_schema();
+    test_visit_and_overwrite();
+    test_concurrent_reader();
+    test_control_channel();
+    std::cout << "All TelemetryRing tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "ThermalIntegrator.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+bool near(double a, double b, double tol) { return std::fabs(a - b) <= tol; }
+
+// Classic RK4 with many small steps, as the reference for radiative nodes.
+double reference(const ThermalNode& node, double T, double dt, int steps) {
+    const double h = dt / steps;
+    auto f = [&](double x) { return node.netW(x) / node.C_J_per_K; };
+    for (int i = 0; i < steps; ++i) {
+        const double k1 = f(T);
+        const double k2 = f(T + 0.5 * h * k1);
+        const double k3 = f(T + 0.5 * h * k2);
+        const double k4 = f(T + h * k3);
+        T += h * (k1 + 2.0 * k2 + 2.0 * k3 + k4) / 6.0;
+    }
+    return T;
+}
+
+ThermalIntegratorConfig stable_config() {
+    ThermalIntegratorConfig cfg;
+    cfg.kind = ThermalIntegratorKind::Stable;
+    return cfg;
+}
+
+} // namespace
+
+void test_parse_kind() {
+    assert(parseThermalIntegratorKind("euler") == ThermalIntegratorKind::Euler);
+    assert(parseThermalIntegratorKind("stable") == ThermalIntegratorKind::Stable);
+    for (const char* bad : {"", "Euler", "rk4"}) {
+        bool threw = false;
+        try {
+            parseThermalIntegratorKind(bad);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    assert(std::string(thermalIntegratorKindName(ThermalIntegratorKind::Stable)) == "stable");
+    std::cout << "[PASS] ThermalIntegrator kinds parse and reject bad names.\n";
+}
+
+// Euler is the single historical step; it overshoots once dt exceeds C/h.
+void test_euler_step() {
+    ThermalNode node;
+    node.C_J_per_K = 2.0;
+    node.h_W_per_K = 1.0;
+    node.T_env_K   = 300.0;
+    node.P_in_W    = 10.0;
+
+    ThermalIntegrator euler;
+    assert(euler.kind() == ThermalIntegratorKind::Euler);
+    assert(euler.advance(node, 310.0, 0.5) == 310.0);          // at equilibrium
+    assert(euler.advance(node, 400.0, 0.5) == 400.0 + (-90.0 / 2.0) * 0.5);
+    assert(euler.lastSubsteps() == 1);
+
+    node.P_in_W = 0.0;
+    assert(euler.advance(node, 400.0, 10.0) == 0.0);   // clamped, not negative
+    assert(euler.advance(node, 400.0, 0.0) == 400.0);
+    assert(euler.advance(node, 400.0, -1.0) == 400.0);
+    std::cout << "[PASS] ThermalIntegrator euler matches the explicit update.\n";
+}
+
+// Linear nodes use the exact RC solution, so any dt is fine.
+void test_stable_linear_exact() {
+    ThermalNode node;
+    node.C_J_per_K = 2.0;
+    node.h_W_per_K = 1.0;
+    node.T_env_K   = 300.0;
+    node.P_in_W    = 50.0;
+    ThermalIntegrator stable(stable_config());
+
+    const double T_eq = 350.0;
+    for (double dt : {0.1, 1.0, 10.0, 1000.0}) {
+        const double T = stable.advance(node, 400.0, dt);
+        assert(near(T, T_eq + 50.0 * std::exp(-dt / 2.0), 1e-9));
+        assert(T >= T_eq);                              // no overshoot
+        assert(stable.lastSubsteps() == 1);
+    }
+
+    // Two half ticks compose to one full tick.
+    const double half = stable.advance(node, stable.advance(node, 400.0, 3.0), 3.0);
+    assert(near(half, stable.advance(node, 400.0, 6.0), 1e-9));
+
+    node.h_W_per_K = 0.0;                               // pure heating ramp
+    assert(near(stable.advance(node, 300.0, 4.0), 400.0, 1e-12));
+    std::cout << "[PASS] ThermalIntegrator stable is exact for linear nodes.\n";
+}
+
+// Radiative nodes substep until within tol_K, capped at max_substeps.
+void test_stable_radiative() {
+    ThermalNode node;
+    node.C_J_per_K  = 100.0;
+    node.h_W_per_K  = 0.1;
+    node.k_rad_W_K4 = 1.0e-9;
+    node.T_env_K    = 300.0;
+    node.P_in_W     = 20.0;
+
+    ThermalIntegratorConfig cfg = stable_config();
+    cfg.tol_K = 0.01;
+    ThermalIntegrator stable(cfg);
+    const double T = stable.advance(node, 1000.0, 60.0);
+    const double ref = reference(node, 1000.0, 60.0, 200000);
+    assert(near(T, ref, 0.05));
+    assert(stable.lastSubsteps() > 1 && stable.lastSubsteps() <= cfg.max_substeps);
+
+    // A looser tolerance needs no more substeps than a tighter one.
+    cfg.tol_K = 1.0;
+    ThermalIntegrator loose(cfg);
+    loose.advance(node, 1000.0, 60.0);
+    assert(loose.lastSubsteps() <= stable.lastSubsteps());
+
+    cfg.tol_K = 1e-12;
+    cfg.max_substeps = 8;
+    ThermalIntegrator capped(cfg);
+    capped.advance(node, 1000.0, 60.0);
+    assert(capped.lastSubsteps() == 8);
+
+    // Huge ticks settle towards equilibrium instead of blowing up.
+    const double settled = stable.advance(node, 1000.0, 1.0e6);
+    assert(std::isfinite(settled) && settled >= node.T_env_K && settled < 1000.0);
+    assert(near(node.netW(settled), 0.0, 0.05));
+    std::cout << "[PASS] ThermalIntegrator stable tracks radiative nodes.\n";
+}
+
+int main() {
+    test_parse_kind();
+    test_euler_step();
+    test_stable_linear_exact();
+    test_stable_radiative();
+    std::cout << "All ThermalIntegrator tests passed.\n";
+    return 0;
+}
@@ -6,6 +6,9 @@
 #include <cassert>
 #include <iostream>
 
+// Sunlight scale read by SolarArray; main.cpp owns it in the sim executable.
+double g_orbit_solar_scale = 1.0;
+
 // ✅ Helper: run a short simulation
 void run_basic_simulation(int ticks, double step) {
     PowerBus bus;
@@ -27,7 +30,7 @@ void run_basic_simulation(int ticks, double step) {
     engine.setTickStep(step);
 
     for (int i = 0; i < ticks; i++) {
-        heater.setDemand(150.0);
+        heater.setEffusionDemand(150.0);
         engine.tick();
     }
 
@@ -62,10 +65,10 @@ void test_battery_bounds() {
     engine.setTickStep(0.1);
 
     for (int i = 0; i < 100; i++) {
-        heater.setDemand(150.0);
+        heater.setEffusionDemand(150.0);
         engine.tick();
         double c = battery.getCharge();
-        assert(c >= 0.0 && c <= 1000.0); // ✅ stays within bounds
+        assert(c >= 0.0 && c <= battery.getCapacityWh()); // ✅ stays within bounds
     }
 
     engine.shutdown();